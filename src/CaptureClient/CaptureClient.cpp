@@ -20,6 +20,7 @@
 #include "CaptureClient/CaptureListener.h"
 #include "ClientData/FunctionInfo.h"
 #include "ClientData/ModuleData.h"
+#include "GrpcProtos/ColumnarCaptureEvents.h"
 #include "GrpcProtos/tracepoint.pb.h"
 #include "Introspection/Introspection.h"
 #include "ModuleUtils/VirtualAndAbsoluteAddresses.h"
@@ -169,6 +170,9 @@ std::vector<ApiFunction> FindApiFunctions(const orbit_client_data::ModuleManager
   auto api_functions = FindApiFunctions(module_manager, process_data);
   *(capture_options.mutable_api_functions()) = {api_functions.begin(), api_functions.end()};
 
+  // ProcessEvents expands CaptureResponse::columnar_capture_events.
+  capture_options.set_enable_columnar_capture_events(true);
+
   return capture_options;
 }
 
@@ -240,7 +244,7 @@ ErrorMessageOr<CaptureListener::CaptureOutcome> CaptureClient::CaptureSync(
       read_succeeded = reader_writer_->Read(&response);
     }
     if (read_succeeded) {
-      ProcessEvents(capture_event_processor, response.capture_events());
+      ProcessEvents(capture_event_processor, response);
     } else {
       break;
     }
@@ -359,16 +363,19 @@ ErrorMessageOr<void> CaptureClient::FinishCapture() {
   return outcome::success();
 }
 
-void CaptureClient::ProcessEvents(
-    CaptureEventProcessor* capture_event_processor,
-    const google::protobuf::RepeatedPtrField<ClientCaptureEvent>& events) {
-  for (const auto& event : events) {
-    capture_event_processor->ProcessEvent(event);
-    if (event.event_case() == ClientCaptureEvent::kCaptureStarted) {
-      absl::MutexLock lock{&state_mutex_};
-      state_ = State::kStarted;
-      ORBIT_LOG("State is now kStarted");
-    }
+void CaptureClient::ProcessEvents(CaptureEventProcessor* capture_event_processor,
+                                  const CaptureResponse& capture_response) {
+  bool all_events_consistent = orbit_grpc_protos::ForEachClientCaptureEvent(
+      capture_response, [this, capture_event_processor](const ClientCaptureEvent& event) {
+        capture_event_processor->ProcessEvent(event);
+        if (event.event_case() == ClientCaptureEvent::kCaptureStarted) {
+          absl::MutexLock lock{&state_mutex_};
+          state_ = State::kStarted;
+          ORBIT_LOG("State is now kStarted");
+        }
+      });
+  if (!all_events_consistent) {
+    ORBIT_ERROR("Skipped inconsistent ColumnarCaptureEvents in CaptureResponse");
   }
 }
 
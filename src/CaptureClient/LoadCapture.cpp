@@ -4,14 +4,215 @@
 
 #include "CaptureClient/LoadCapture.h"
 
+#include <absl/synchronization/mutex.h>
+#include <google/protobuf/io/coded_stream.h>
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
 #include "CaptureClient/CaptureEventProcessor.h"
 #include "ClientProtos/user_defined_capture_info.pb.h"
+#include "Introspection/Introspection.h"
+#include "OrbitBase/Future.h"
+#include "OrbitBase/Logging.h"
+#include "OrbitBase/ThreadUtils.h"
 
 namespace orbit_capture_client {
 
+using orbit_grpc_protos::ClientCaptureEvent;
+
+namespace {
+
+// A run of consecutive events of the capture section, which is parsed as a whole on one thread.
+struct CaptureSectionChunk {
+  std::vector<std::string> serialized_events;
+  std::vector<ClientCaptureEvent> events;
+  // Reading or parsing the event following `events` failed.
+  std::optional<ErrorMessage> error;
+};
+
+[[nodiscard]] bool IsCaptureFinished(const std::string& serialized_event) {
+  // ClientCaptureEvent only consists of a oneof, so the tag of the first field tells the type of
+  // the event without parsing it.
+  constexpr int kTagTypeBits = 3;
+  google::protobuf::io::CodedInputStream input_stream{
+      reinterpret_cast<const uint8_t*>(serialized_event.data()),
+      static_cast<int>(serialized_event.size())};
+  return (input_stream.ReadTag() >> kTagTypeBits) ==
+         ClientCaptureEvent::kCaptureFinishedFieldNumber;
+}
+
+void ParseChunk(CaptureSectionChunk* chunk) {
+  ORBIT_SCOPE_FUNCTION;
+  chunk->events.resize(chunk->serialized_events.size());
+  for (size_t i = 0; i < chunk->serialized_events.size(); ++i) {
+    const std::string& serialized_event = chunk->serialized_events[i];
+    ClientCaptureEvent& event = chunk->events[i];
+    event.ParseFromString(serialized_event);
+    if (event.ByteSizeLong() != serialized_event.size()) {
+      chunk->error = ErrorMessage{absl::StrFormat(
+          "The message size %d of the parsed message is different from the parsed size %d",
+          event.ByteSizeLong(), serialized_event.size())};
+      chunk->events.resize(i);
+      break;
+    }
+  }
+  chunk->serialized_events.clear();
+  chunk->serialized_events.shrink_to_fit();
+}
+
+// Reads the capture section on a separate thread, splitting it into CaptureSectionChunks that are
+// parsed on a thread pool, and returns the parsed chunks in order.
+class ParallelCaptureSectionReader {
+ public:
+  ParallelCaptureSectionReader(orbit_capture_file::ProtoSectionInputStream* input_stream,
+                               orbit_base::ThreadPool* thread_pool)
+      : input_stream_{input_stream}, thread_pool_{thread_pool} {
+    reader_thread_ = std::thread{[this] { ReadChunks(); }};
+  }
+
+  ParallelCaptureSectionReader(const ParallelCaptureSectionReader&) = delete;
+  ParallelCaptureSectionReader& operator=(const ParallelCaptureSectionReader&) = delete;
+
+  ~ParallelCaptureSectionReader() {
+    {
+      absl::MutexLock lock{&mutex_};
+      stop_requested_ = true;
+    }
+    reader_thread_.join();
+    // The chunks are still referenced by the parsing tasks until those complete.
+    for (const ChunkInFlight& chunk_in_flight : chunks_in_flight_) {
+      chunk_in_flight.parsed.Wait();
+    }
+  }
+
+  // Returns nullptr when all chunks have been returned.
+  [[nodiscard]] std::unique_ptr<CaptureSectionChunk> GetNextChunk() {
+    ChunkInFlight chunk_in_flight;
+    {
+      absl::MutexLock lock{&mutex_};
+      mutex_.Await(absl::Condition(
+          +[](ParallelCaptureSectionReader* self) ABSL_EXCLUSIVE_LOCKS_REQUIRED(self->mutex_) {
+            return !self->chunks_in_flight_.empty() || self->reading_finished_;
+          },
+          this));
+      if (chunks_in_flight_.empty()) return nullptr;
+      chunk_in_flight = std::move(chunks_in_flight_.front());
+      chunks_in_flight_.pop_front();
+    }
+    chunk_in_flight.parsed.Wait();
+    return std::move(chunk_in_flight.chunk);
+  }
+
+ private:
+  static constexpr size_t kEventsPerChunk = 1024;
+  // Bounds the memory used by chunks that were read but not processed yet.
+  static constexpr size_t kMaxChunksInFlight = 256;
+
+  struct ChunkInFlight {
+    std::unique_ptr<CaptureSectionChunk> chunk;
+    orbit_base::Future<void> parsed;
+  };
+
+  void ReadChunks() {
+    orbit_base::SetCurrentThreadName("CaptureReader");
+    bool reached_end = false;
+    while (!reached_end) {
+      auto chunk = std::make_unique<CaptureSectionChunk>();
+      chunk->serialized_events.reserve(kEventsPerChunk);
+      while (chunk->serialized_events.size() < kEventsPerChunk) {
+        std::string serialized_event;
+        ErrorMessageOr<void> read_result = input_stream_->ReadSerializedMessage(&serialized_event);
+        if (read_result.has_error()) {
+          chunk->error = read_result.error();
+          reached_end = true;
+          break;
+        }
+        const bool is_capture_finished = IsCaptureFinished(serialized_event);
+        chunk->serialized_events.push_back(std::move(serialized_event));
+        // Reading past CaptureFinished would read the padding of the section as empty events.
+        if (is_capture_finished) {
+          reached_end = true;
+          break;
+        }
+      }
+
+      orbit_base::Future<void> parsed =
+          thread_pool_->Schedule([chunk = chunk.get()] { ParseChunk(chunk); });
+
+      absl::MutexLock lock{&mutex_};
+      mutex_.Await(absl::Condition(
+          +[](ParallelCaptureSectionReader* self) ABSL_EXCLUSIVE_LOCKS_REQUIRED(self->mutex_) {
+            return self->chunks_in_flight_.size() < kMaxChunksInFlight || self->stop_requested_;
+          },
+          this));
+      chunks_in_flight_.push_back({std::move(chunk), std::move(parsed)});
+      if (stop_requested_) break;
+    }
+
+    absl::MutexLock lock{&mutex_};
+    reading_finished_ = true;
+  }
+
+  orbit_capture_file::ProtoSectionInputStream* input_stream_;
+  orbit_base::ThreadPool* thread_pool_;
+
+  absl::Mutex mutex_;
+  std::deque<ChunkInFlight> chunks_in_flight_ ABSL_GUARDED_BY(mutex_);
+  bool reading_finished_ ABSL_GUARDED_BY(mutex_) = false;
+  bool stop_requested_ ABSL_GUARDED_BY(mutex_) = false;
+
+  std::thread reader_thread_;
+};
+
+}  // namespace
+
+[[nodiscard]] ErrorMessageOr<CaptureListener::CaptureOutcome> ReadCaptureSection(
+    orbit_capture_file::ProtoSectionInputStream* input_stream,
+    const std::function<void(const ClientCaptureEvent&)>& consumer,
+    std::atomic<bool>* cancellation_requested) {
+  while (true) {
+    if (*cancellation_requested) {
+      return CaptureListener::CaptureOutcome::kCancelled;
+    }
+    ClientCaptureEvent event;
+    OUTCOME_TRY(input_stream->ReadMessage(&event));
+    consumer(event);
+    if (event.event_case() == ClientCaptureEvent::kCaptureFinished) {
+      return CaptureListener::CaptureOutcome::kComplete;
+    }
+  }
+}
+
+[[nodiscard]] ErrorMessageOr<CaptureListener::CaptureOutcome> ReadCaptureSectionInParallel(
+    orbit_capture_file::ProtoSectionInputStream* input_stream, orbit_base::ThreadPool* thread_pool,
+    const std::function<void(const ClientCaptureEvent&)>& consumer,
+    std::atomic<bool>* cancellation_requested) {
+  ParallelCaptureSectionReader reader{input_stream, thread_pool};
+  while (std::unique_ptr<CaptureSectionChunk> chunk = reader.GetNextChunk()) {
+    for (const ClientCaptureEvent& event : chunk->events) {
+      if (*cancellation_requested) {
+        return CaptureListener::CaptureOutcome::kCancelled;
+      }
+      consumer(event);
+      if (event.event_case() == ClientCaptureEvent::kCaptureFinished) {
+        return CaptureListener::CaptureOutcome::kComplete;
+      }
+    }
+    if (chunk->error.has_value()) return chunk->error.value();
+  }
+  ORBIT_UNREACHABLE();
+}
+
 [[nodiscard]] ErrorMessageOr<CaptureListener::CaptureOutcome> LoadCapture(
     CaptureListener* listener, orbit_capture_file::CaptureFile* capture_file,
-    std::atomic<bool>* capture_loading_cancellation_requested) {
+    std::atomic<bool>* capture_loading_cancellation_requested,
+    std::optional<uint64_t> start_timestamp_ns) {
   {
     ORBIT_SCOPED_TIMED_LOG("Loading capture from \"%s\"", capture_file->GetFilePath().string());
     absl::flat_hash_set<uint64_t> frame_track_function_ids;
@@ -32,19 +233,36 @@ namespace orbit_capture_client {
         CaptureEventProcessor::CreateForCaptureListener(listener, capture_file->GetFilePath(),
                                                         frame_track_function_ids);
 
-    auto capture_section_input_stream = capture_file->CreateCaptureSectionInputStream();
-    while (true) {
-      if (*capture_loading_cancellation_requested) {
-        return CaptureListener::CaptureOutcome::kCancelled;
-      }
-      orbit_grpc_protos::ClientCaptureEvent event;
-      OUTCOME_TRY(capture_section_input_stream->ReadMessage(&event));
+    std::unique_ptr<orbit_capture_file::ProtoSectionInputStream> capture_section_input_stream;
+    if (start_timestamp_ns.has_value()) {
+      OUTCOME_TRY(capture_section_input_stream,
+                  capture_file->CreateCaptureSectionInputStreamFromTimestamp(
+                      start_timestamp_ns.value()));
+    } else {
+      capture_section_input_stream = capture_file->CreateCaptureSectionInputStream();
+    }
+    const auto process_event = [&capture_event_processor](const ClientCaptureEvent& event) {
       capture_event_processor->ProcessEvent(event);
-      if (event.event_case() == orbit_grpc_protos::ClientCaptureEvent::kCaptureFinished) {
-        return CaptureListener::CaptureOutcome::kComplete;
-      }
+    };
+
+    // One thread is left for reading the file and one for processing the events. With fewer than
+    // two threads left for parsing, the pipeline is not worth its overhead.
+    constexpr size_t kMinParsingThreadCount = 2;
+    const size_t hardware_thread_count = std::thread::hardware_concurrency();
+    if (hardware_thread_count < kMinParsingThreadCount + 2) {
+      return ReadCaptureSection(capture_section_input_stream.get(), process_event,
+                                capture_loading_cancellation_requested);
     }
+
+    const size_t parsing_thread_count = hardware_thread_count - 2;
+    std::shared_ptr<orbit_base::ThreadPool> parsing_thread_pool = orbit_base::ThreadPool::Create(
+        parsing_thread_count, parsing_thread_count, absl::Seconds(1));
+    ErrorMessageOr<CaptureListener::CaptureOutcome> outcome =
+        ReadCaptureSectionInParallel(capture_section_input_stream.get(), parsing_thread_pool.get(),
+                                     process_event, capture_loading_cancellation_requested);
+    parsing_thread_pool->ShutdownAndWait();
+    return outcome;
   }
 }
 
-}  // namespace orbit_capture_client
\ No newline at end of file
+}  // namespace orbit_capture_client
@@ -0,0 +1,199 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <absl/time/time.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "CaptureClient/CaptureListener.h"
+#include "CaptureClient/LoadCapture.h"
+#include "CaptureFile/CaptureFile.h"
+#include "CaptureFile/CaptureFileOutputStream.h"
+#include "GrpcProtos/capture.pb.h"
+#include "OrbitBase/Logging.h"
+#include "OrbitBase/TemporaryFile.h"
+#include "OrbitBase/ThreadPool.h"
+#include "TestUtils/TestUtils.h"
+
+namespace orbit_capture_client {
+
+using orbit_capture_file::CaptureFile;
+using orbit_capture_file::CaptureFileOutputStream;
+using orbit_grpc_protos::ClientCaptureEvent;
+using orbit_test_utils::HasNoError;
+using orbit_test_utils::HasValue;
+
+namespace {
+
+class LoadCaptureTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    auto temporary_file_or_error = orbit_base::TemporaryFile::Create();
+    ASSERT_THAT(temporary_file_or_error, HasValue());
+    temporary_file_.emplace(std::move(temporary_file_or_error.value()));
+    temporary_file_->CloseAndRemove();
+  }
+
+  void TearDown() override { thread_pool_->ShutdownAndWait(); }
+
+  void WriteCapture(uint64_t event_count, bool with_capture_finished) {
+    auto output_stream_or_error =
+        CaptureFileOutputStream::Create(temporary_file_->file_path().string());
+    ASSERT_THAT(output_stream_or_error, HasValue());
+    std::unique_ptr<CaptureFileOutputStream> output_stream =
+        std::move(output_stream_or_error.value());
+
+    ClientCaptureEvent event;
+    event.mutable_capture_started()->set_process_id(42);
+    ASSERT_THAT(output_stream->WriteCaptureEvent(event), HasNoError());
+
+    for (uint64_t i = 0; i < event_count; ++i) {
+      ClientCaptureEvent function_call_event;
+      orbit_grpc_protos::FunctionCall* function_call =
+          function_call_event.mutable_function_call();
+      function_call->set_pid(42);
+      function_call->set_tid(43 + i % 8);
+      function_call->set_function_id(i % 100);
+      function_call->set_duration_ns(100 + i % 1000);
+      function_call->set_end_timestamp_ns(1'000'000 + i * 1'000);
+      function_call->set_depth(static_cast<int32_t>(i % 4));
+      function_call->set_return_value(i);
+      function_call->add_registers(i);
+      ASSERT_THAT(output_stream->WriteCaptureEvent(function_call_event), HasNoError());
+    }
+
+    if (with_capture_finished) {
+      ClientCaptureEvent capture_finished_event;
+      capture_finished_event.mutable_capture_finished()->set_status(
+          orbit_grpc_protos::CaptureFinished::kSuccessful);
+      ASSERT_THAT(output_stream->WriteCaptureEvent(capture_finished_event), HasNoError());
+    }
+    ASSERT_THAT(output_stream->Close(), HasNoError());
+  }
+
+  [[nodiscard]] std::unique_ptr<CaptureFile> OpenCapture() {
+    auto capture_file_or_error = CaptureFile::OpenForReadWrite(temporary_file_->file_path());
+    ORBIT_CHECK(capture_file_or_error.has_value());
+    return std::move(capture_file_or_error.value());
+  }
+
+  std::optional<orbit_base::TemporaryFile> temporary_file_;
+  std::shared_ptr<orbit_base::ThreadPool> thread_pool_ =
+      orbit_base::ThreadPool::Create(4, 4, absl::Seconds(1));
+  std::atomic<bool> cancellation_requested_ = false;
+};
+
+}  // namespace
+
+TEST_F(LoadCaptureTest, ParallelReadMatchesSequentialRead) {
+  WriteCapture(10'000, /*with_capture_finished=*/true);
+
+  std::vector<std::string> sequential_events;
+  std::unique_ptr<CaptureFile> capture_file = OpenCapture();
+  ErrorMessageOr<CaptureListener::CaptureOutcome> sequential_outcome = ReadCaptureSection(
+      capture_file->CreateCaptureSectionInputStream().get(),
+      [&](const ClientCaptureEvent& event) {
+        sequential_events.push_back(event.SerializeAsString());
+      },
+      &cancellation_requested_);
+  ASSERT_THAT(sequential_outcome, HasValue());
+  EXPECT_EQ(sequential_outcome.value(), CaptureListener::CaptureOutcome::kComplete);
+  EXPECT_EQ(sequential_events.size(), 10'002);
+
+  std::vector<std::string> parallel_events;
+  ErrorMessageOr<CaptureListener::CaptureOutcome> parallel_outcome = ReadCaptureSectionInParallel(
+      capture_file->CreateCaptureSectionInputStream().get(), thread_pool_.get(),
+      [&](const ClientCaptureEvent& event) {
+        parallel_events.push_back(event.SerializeAsString());
+      },
+      &cancellation_requested_);
+  ASSERT_THAT(parallel_outcome, HasValue());
+  EXPECT_EQ(parallel_outcome.value(), CaptureListener::CaptureOutcome::kComplete);
+  EXPECT_EQ(parallel_events, sequential_events);
+}
+
+TEST_F(LoadCaptureTest, ParallelReadFailsAfterTheSameEventsAsSequentialRead) {
+  WriteCapture(3'000, /*with_capture_finished=*/false);
+
+  std::unique_ptr<CaptureFile> capture_file = OpenCapture();
+  uint64_t sequential_event_count = 0;
+  ErrorMessageOr<CaptureListener::CaptureOutcome> sequential_outcome = ReadCaptureSection(
+      capture_file->CreateCaptureSectionInputStream().get(),
+      [&](const ClientCaptureEvent& /*event*/) { ++sequential_event_count; },
+      &cancellation_requested_);
+  ASSERT_TRUE(sequential_outcome.has_error());
+
+  uint64_t parallel_event_count = 0;
+  ErrorMessageOr<CaptureListener::CaptureOutcome> parallel_outcome = ReadCaptureSectionInParallel(
+      capture_file->CreateCaptureSectionInputStream().get(), thread_pool_.get(),
+      [&](const ClientCaptureEvent& /*event*/) { ++parallel_event_count; },
+      &cancellation_requested_);
+  ASSERT_TRUE(parallel_outcome.has_error());
+  EXPECT_EQ(parallel_outcome.error().message(), sequential_outcome.error().message());
+  EXPECT_EQ(parallel_event_count, sequential_event_count);
+}
+
+TEST_F(LoadCaptureTest, ParallelReadCanBeCancelled) {
+  WriteCapture(10'000, /*with_capture_finished=*/true);
+
+  std::unique_ptr<CaptureFile> capture_file = OpenCapture();
+  uint64_t event_count = 0;
+  ErrorMessageOr<CaptureListener::CaptureOutcome> outcome = ReadCaptureSectionInParallel(
+      capture_file->CreateCaptureSectionInputStream().get(), thread_pool_.get(),
+      [&](const ClientCaptureEvent& /*event*/) {
+        if (++event_count == 100) cancellation_requested_ = true;
+      },
+      &cancellation_requested_);
+  ASSERT_THAT(outcome, HasValue());
+  EXPECT_EQ(outcome.value(), CaptureListener::CaptureOutcome::kCancelled);
+  EXPECT_EQ(event_count, 100);
+}
+
+// Logs how long reading a large synthetic capture takes, sequentially and in parallel. Too slow to
+// run with the other tests, use --gtest_also_run_disabled_tests to run it.
+TEST_F(LoadCaptureTest, DISABLED_BenchmarkReadLargeCapture) {
+  constexpr uint64_t kEventCount = 2'000'000;
+  WriteCapture(kEventCount, /*with_capture_finished=*/true);
+  std::unique_ptr<CaptureFile> capture_file = OpenCapture();
+
+  uint64_t checksum = 0;
+  const auto consumer = [&checksum](const ClientCaptureEvent& event) {
+    checksum += event.function_call().return_value();
+  };
+
+  const auto sequential_start = std::chrono::steady_clock::now();
+  ASSERT_THAT(ReadCaptureSection(capture_file->CreateCaptureSectionInputStream().get(), consumer,
+                                 &cancellation_requested_),
+              HasValue());
+  const std::chrono::duration<double> sequential_duration =
+      std::chrono::steady_clock::now() - sequential_start;
+  const uint64_t sequential_checksum = std::exchange(checksum, 0);
+
+  const size_t thread_count = std::max<size_t>(1, std::thread::hardware_concurrency());
+  std::shared_ptr<orbit_base::ThreadPool> thread_pool =
+      orbit_base::ThreadPool::Create(thread_count, thread_count, absl::Seconds(1));
+  const auto parallel_start = std::chrono::steady_clock::now();
+  ASSERT_THAT(ReadCaptureSectionInParallel(capture_file->CreateCaptureSectionInputStream().get(),
+                                           thread_pool.get(), consumer, &cancellation_requested_),
+              HasValue());
+  const std::chrono::duration<double> parallel_duration =
+      std::chrono::steady_clock::now() - parallel_start;
+  thread_pool->ShutdownAndWait();
+
+  EXPECT_EQ(checksum, sequential_checksum);
+  ORBIT_LOG("%u events: sequential %.3f ms, parallel with %u threads %.3f ms", kEventCount,
+            sequential_duration.count() * 1e3, thread_count, parallel_duration.count() * 1e3);
+}
+
+}  // namespace orbit_capture_client
@@ -20,9 +20,11 @@ namespace {
 class SaveToFileEventProcessor : public CaptureEventProcessor {
  public:
   explicit SaveToFileEventProcessor(std::filesystem::path file_path,
-                                    std::function<void(const ErrorMessage&)> error_handler)
+                                    std::function<void(const ErrorMessage&)> error_handler,
+                                    bool compress_capture_section)
       : file_path_{std::move(file_path)},
         error_handler_{std::move(error_handler)},
+        compress_capture_section_{compress_capture_section},
         state_{State::kProcessing} {}
   ~SaveToFileEventProcessor() override = default;
 
@@ -40,12 +42,16 @@ class SaveToFileEventProcessor : public CaptureEventProcessor {
 
   std::filesystem::path file_path_;
   std::function<void(const ErrorMessage&)> error_handler_;
+  bool compress_capture_section_;
   std::unique_ptr<CaptureFileOutputStream> output_stream_;
   State state_;
 };
 
 ErrorMessageOr<void> SaveToFileEventProcessor::Initialize() {
-  auto stream_or_error = CaptureFileOutputStream::Create(file_path_);
+  CaptureFileOutputStream::Options options;
+  options.time_index_block_size = CaptureFileOutputStream::kDefaultTimeIndexBlockSize;
+  options.compress_capture_section = compress_capture_section_;
+  auto stream_or_error = CaptureFileOutputStream::Create(file_path_, options);
   if (stream_or_error.has_error()) {
     return ErrorMessage{absl::StrFormat("Failed to initialize CaptureSaveToFileProcessor: %s",
                                         stream_or_error.error().message())};
@@ -96,8 +102,9 @@ void SaveToFileEventProcessor::ProcessEvent(const ClientCaptureEvent& event) {
 ErrorMessageOr<std::unique_ptr<CaptureEventProcessor>>
 CaptureEventProcessor::CreateSaveToFileProcessor(
     const std::filesystem::path& file_path,
-    std::function<void(const ErrorMessage&)> error_handler) {
-  auto processor = std::make_unique<SaveToFileEventProcessor>(file_path, std::move(error_handler));
+    std::function<void(const ErrorMessage&)> error_handler, bool compress_capture_section) {
+  auto processor = std::make_unique<SaveToFileEventProcessor>(file_path, std::move(error_handler),
+                                                              compress_capture_section);
   auto init_or_error = processor->Initialize();
   if (init_or_error.has_error()) {
     return init_or_error.error();
@@ -99,7 +99,11 @@ TEST(SaveToFileEventProcessor, SaveAndLoadSimpleCapture) {
   }
 
   const auto& sections = capture_file->GetSectionList();
-  EXPECT_EQ(sections.size(), 0);
+  EXPECT_EQ(sections.size(), 1);
+
+  std::optional<size_t> time_index_section =
+      capture_file->FindSectionByType(orbit_capture_file::kSectionTypeTimeIndex);
+  EXPECT_TRUE(time_index_section.has_value());
 
   std::optional<size_t> user_data_section =
       capture_file->FindSectionByType(orbit_capture_file::kSectionTypeUserData);
@@ -72,9 +72,8 @@ class CaptureClient {
       orbit_grpc_protos::CaptureOptions capture_options,
       CaptureEventProcessor* capture_event_processor);
 
-  void ProcessEvents(
-      CaptureEventProcessor* capture_event_processor,
-      const google::protobuf::RepeatedPtrField<orbit_grpc_protos::ClientCaptureEvent>& events);
+  void ProcessEvents(CaptureEventProcessor* capture_event_processor,
+                     const orbit_grpc_protos::CaptureResponse& capture_response);
 
   [[nodiscard]] ErrorMessageOr<void> FinishCapture();
 
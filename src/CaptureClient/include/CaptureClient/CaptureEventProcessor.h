@@ -29,7 +29,8 @@ class CaptureEventProcessor {
 
   static ErrorMessageOr<std::unique_ptr<CaptureEventProcessor>> CreateSaveToFileProcessor(
       const std::filesystem::path& file_path,
-      std::function<void(const ErrorMessage&)> error_handler);
+      std::function<void(const ErrorMessage&)> error_handler,
+      bool compress_capture_section = false);
 
   static std::unique_ptr<CaptureEventProcessor> CreateCompositeProcessor(
       std::vector<std::unique_ptr<CaptureEventProcessor>> event_processors);
@@ -5,15 +5,43 @@
 #ifndef CAPTURE_CLIENT_LOAD_CAPTURE_H_
 #define CAPTURE_CLIENT_LOAD_CAPTURE_H_
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <optional>
+
 #include "CaptureClient/CaptureListener.h"
 #include "CaptureFile/CaptureFile.h"
+#include "CaptureFile/ProtoSectionInputStream.h"
+#include "GrpcProtos/capture.pb.h"
+#include "OrbitBase/Result.h"
+#include "OrbitBase/ThreadPool.h"
 
 namespace orbit_capture_client {
 
+// Reads the ClientCaptureEvents of a capture section from `input_stream`, up to and including
+// CaptureFinished, and passes them to `consumer` in order.
+[[nodiscard]] ErrorMessageOr<CaptureListener::CaptureOutcome> ReadCaptureSection(
+    orbit_capture_file::ProtoSectionInputStream* input_stream,
+    const std::function<void(const orbit_grpc_protos::ClientCaptureEvent&)>& consumer,
+    std::atomic<bool>* cancellation_requested);
+
+// Same as ReadCaptureSection, but pipelined: a reader thread splits the section into chunks of
+// serialized events, the chunks are parsed in parallel on `thread_pool`, and the parsed events are
+// passed to `consumer` in order on the calling thread.
+[[nodiscard]] ErrorMessageOr<CaptureListener::CaptureOutcome> ReadCaptureSectionInParallel(
+    orbit_capture_file::ProtoSectionInputStream* input_stream, orbit_base::ThreadPool* thread_pool,
+    const std::function<void(const orbit_grpc_protos::ClientCaptureEvent&)>& consumer,
+    std::atomic<bool>* cancellation_requested);
+
+// Loads the capture from `capture_file` into `listener`. If `start_timestamp_ns` is set, the events
+// ending before it are skipped as far as the TIME_INDEX section of the file allows (see
+// CaptureFile::CreateCaptureSectionInputStreamFromTimestamp).
 // TODO(b/234110675) Add a smoke test
 [[nodiscard]] ErrorMessageOr<CaptureListener::CaptureOutcome> LoadCapture(
     CaptureListener* listener, orbit_capture_file::CaptureFile* capture_file,
-    std::atomic<bool>* capture_loading_cancellation_requested);
+    std::atomic<bool>* capture_loading_cancellation_requested,
+    std::optional<uint64_t> start_timestamp_ns = std::nullopt);
 
 }  // namespace orbit_capture_client
 #endif  // CAPTURE_CLIENT_LOAD_CAPTURE_H_
@@ -21,6 +21,8 @@
 #include "CaptureEventProducer/LockFreeBufferCaptureEventProducer.h"
 #include "FakeProducerSideService/FakeProducerSideService.h"
 #include "GrpcProtos/capture.pb.h"
+#include "OrbitBase/Logging.h"
+#include "OrbitBase/PerThreadSpscQueues.h"
 
 namespace orbit_capture_event_producer {
 
@@ -405,4 +407,82 @@ TEST_F(LockFreeBufferCaptureEventProducerTest, DisconnectAndReconnect) {
   EXPECT_FALSE(buffer_producer_->IsCapturing());
 }
 
+namespace {
+
+// The size of the intermediate events of user space instrumentation.
+struct BenchmarkIntermediateEvent {
+  uint64_t values[6];
+};
+
+template <typename BufferT>
+class BenchmarkCaptureEventProducer
+    : public LockFreeBufferCaptureEventProducer<BenchmarkIntermediateEvent, BufferT> {
+ protected:
+  orbit_grpc_protos::ProducerCaptureEvent* TranslateIntermediateEvent(
+      BenchmarkIntermediateEvent&& /*intermediate_event*/,
+      google::protobuf::Arena* arena) override {
+    return google::protobuf::Arena::CreateMessage<orbit_grpc_protos::ProducerCaptureEvent>(arena);
+  }
+};
+
+// Returns the average time in nanoseconds that each of `thread_count` threads spends in
+// EnqueueIntermediateEvent while capturing.
+template <typename BufferT>
+double MeasureEnqueueIntermediateEventNs(size_t thread_count) {
+  constexpr uint64_t kEventsPerThread = 500'000;
+
+  orbit_fake_producer_side_service::FakeProducerSideService fake_service;
+  grpc::ServerBuilder builder;
+  builder.RegisterService(&fake_service);
+  std::unique_ptr<grpc::Server> fake_server = builder.BuildAndStart();
+  EXPECT_NE(fake_server, nullptr);
+
+  BenchmarkCaptureEventProducer<BufferT> producer;
+  producer.BuildAndStart(fake_server->InProcessChannel(grpc::ChannelArguments{}));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  fake_service.SendStartCaptureCommand(orbit_grpc_protos::CaptureOptions{});
+  std::this_thread::sleep_for(kWaitMessagesSentDuration);
+  EXPECT_TRUE(producer.IsCapturing());
+
+  std::atomic<uint64_t> total_duration_ns = 0;
+  std::vector<std::thread> threads;
+  for (size_t thread_index = 0; thread_index < thread_count; ++thread_index) {
+    threads.emplace_back([&producer, &total_duration_ns] {
+      const auto start = std::chrono::steady_clock::now();
+      for (uint64_t i = 0; i < kEventsPerThread; ++i) {
+        producer.EnqueueIntermediateEvent(BenchmarkIntermediateEvent{{i, i, i, i, i, i}});
+      }
+      total_duration_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  fake_service.SendStopCaptureCommand();
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  producer.ShutdownAndWait();
+  fake_service.FinishAndDisallowRpc();
+  fake_server->Shutdown();
+  fake_server->Wait();
+
+  return static_cast<double>(total_duration_ns) / (thread_count * kEventsPerThread);
+}
+
+}  // namespace
+
+// Logs the cost of enqueuing an event in each buffer type. Disabled by default.
+TEST(LockFreeBufferCaptureEventProducer, DISABLED_BenchmarkEnqueueIntermediateEvent) {
+  for (size_t thread_count : {1, 4}) {
+    ORBIT_LOG("%d threads: ConcurrentQueueBuffer %.1f ns/event, PerThreadSpscQueues %.1f ns/event",
+              thread_count,
+              MeasureEnqueueIntermediateEventNs<ConcurrentQueueBuffer<BenchmarkIntermediateEvent>>(
+                  thread_count),
+              MeasureEnqueueIntermediateEventNs<
+                  orbit_base::PerThreadSpscQueues<BenchmarkIntermediateEvent>>(thread_count));
+  }
+}
+
 }  // namespace orbit_capture_event_producer
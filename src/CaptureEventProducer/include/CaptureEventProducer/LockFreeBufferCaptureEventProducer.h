@@ -15,6 +15,25 @@
 
 namespace orbit_capture_event_producer {
 
+// The default buffer of LockFreeBufferCaptureEventProducer: one lock-free queue shared by all the
+// threads that enqueue events.
+template <typename IntermediateEventT>
+class ConcurrentQueueBuffer {
+ public:
+  void Enqueue(const IntermediateEventT& event) { queue_.enqueue(event); }
+  void Enqueue(IntermediateEventT&& event) { queue_.enqueue(std::move(event)); }
+
+  [[nodiscard]] size_t DequeueBulk(IntermediateEventT* events, size_t max_event_count) {
+    return queue_.try_dequeue_bulk(events, max_event_count);
+  }
+
+  // moodycamel::ConcurrentQueue keeps the blocks it allocated for reuse.
+  void ReleaseUnusedMemory() {}
+
+ private:
+  moodycamel::ConcurrentQueue<IntermediateEventT> queue_;
+};
+
 // This still abstract implementation of CaptureEventProducer provides a lock-free queue where to
 // write events with low overhead from the fast path where they are produced.
 // Events are enqueued using the methods EnqueueIntermediateEvent(IfCapturing).
@@ -31,7 +50,12 @@ namespace orbit_capture_event_producer {
 // In particular, when hundreds of thousands of events are produced per second, it is recommended
 // that IntermediateEventT not be a protobuf or another type that involves heap allocations, as the
 // cost of dynamic allocations and de-allocations can add up quickly.
-template <typename IntermediateEventT>
+//
+// The lock-free buffer is of type BufferT, which needs to provide the same methods as
+// ConcurrentQueueBuffer. When the events are produced at a very high rate from many threads,
+// orbit_base::PerThreadSpscQueues avoids the contention of a single shared queue.
+template <typename IntermediateEventT,
+          typename BufferT = ConcurrentQueueBuffer<IntermediateEventT>>
 class LockFreeBufferCaptureEventProducer : public CaptureEventProducer {
  public:
   void BuildAndStart(const std::shared_ptr<grpc::Channel>& channel) final {
@@ -50,17 +74,17 @@ class LockFreeBufferCaptureEventProducer : public CaptureEventProducer {
   }
 
   void EnqueueIntermediateEvent(const IntermediateEventT& event) {
-    lock_free_queue_.enqueue(event);
+    lock_free_queue_.Enqueue(event);
   }
 
   void EnqueueIntermediateEvent(IntermediateEventT&& event) {
-    lock_free_queue_.enqueue(std::move(event));
+    lock_free_queue_.Enqueue(std::move(event));
   }
 
   bool EnqueueIntermediateEventIfCapturing(
       const std::function<IntermediateEventT()>& event_builder_if_capturing) {
     if (IsCapturing()) {
-      lock_free_queue_.enqueue(event_builder_if_capturing());
+      lock_free_queue_.Enqueue(event_builder_if_capturing());
       return true;
     }
     return false;
@@ -118,7 +142,7 @@ class LockFreeBufferCaptureEventProducer : public CaptureEventProducer {
     while (!shutdown_requested_) {
       while (true) {
         size_t dequeued_event_count =
-            lock_free_queue_.try_dequeue_bulk(dequeued_events.begin(), kMaxEventsPerRequest);
+            lock_free_queue_.DequeueBulk(dequeued_events.data(), kMaxEventsPerRequest);
         bool queue_was_emptied = dequeued_event_count < kMaxEventsPerRequest;
 
         ProducerStatus current_status;
@@ -158,6 +182,8 @@ class LockFreeBufferCaptureEventProducer : public CaptureEventProducer {
           if (!NotifyAllEventsSent()) {
             ORBIT_ERROR("Notifying that all CaptureEvents have been sent");
           }
+          // The capture is over, don't hold on to the memory that buffered its peaks.
+          lock_free_queue_.ReleaseUnusedMemory();
           break;
         }
 
@@ -176,7 +202,7 @@ class LockFreeBufferCaptureEventProducer : public CaptureEventProducer {
   }
 
  private:
-  moodycamel::ConcurrentQueue<IntermediateEventT> lock_free_queue_;
+  BufferT lock_free_queue_;
 
   std::thread forwarder_thread_;
   std::atomic<bool> shutdown_requested_ = false;
@@ -5,15 +5,19 @@
 #include "CaptureFile/CaptureFile.h"
 
 #include "CaptureFileConstants.h"
+#include "CaptureTimeIndex.h"
+#include "CompressedCaptureSection.h"
 #include "OrbitBase/Align.h"
 #include "OrbitBase/File.h"
 #include "ProtoSectionInputStreamImpl.h"
+#include "SeekingCaptureSectionInputStream.h"
 
 namespace orbit_capture_file {
 
 namespace {
 
 using orbit_base::unique_fd;
+using orbit_capture_file_internal::CaptureSectionBlock;
 
 constexpr uint64_t kMaxNumberOfSections = std::numeric_limits<uint16_t>::max();
 
@@ -49,6 +53,9 @@ class CaptureFileImpl : public CaptureFile {
 
   std::unique_ptr<ProtoSectionInputStream> CreateCaptureSectionInputStream() override;
 
+  ErrorMessageOr<std::unique_ptr<ProtoSectionInputStream>>
+  CreateCaptureSectionInputStreamFromTimestamp(uint64_t timestamp_ns) override;
+
   [[nodiscard]] const std::filesystem::path& GetFilePath() const override;
 
   std::unique_ptr<ProtoSectionInputStream> CreateProtoSectionInputStream(
@@ -59,6 +66,10 @@ class CaptureFileImpl : public CaptureFile {
   ErrorMessageOr<void> ReadHeader();
   ErrorMessageOr<void> ReadSectionList();
   ErrorMessageOr<void> CalculateCaptureSectionSize();
+  ErrorMessageOr<void> ReadCaptureSectionBlocks();
+  [[nodiscard]] bool IsCaptureSectionCompressed() const {
+    return header_.version == kCompressedFileVersion;
+  }
   ErrorMessageOr<void> WriteSectionList(const std::vector<CaptureFileSection>& section_list,
                                         uint64_t offset);
   [[nodiscard]] bool IsThereSectionWithOffsetAfterSectionList() const;
@@ -75,6 +86,9 @@ class CaptureFileImpl : public CaptureFile {
   uint64_t capture_section_size_ = 0;
 
   std::vector<CaptureFileSection> section_list_;
+
+  // The blocks of a compressed capture section, empty if the capture section is not compressed.
+  std::vector<CaptureSectionBlock> capture_section_blocks_;
 };
 
 ErrorMessageOr<uint64_t> GetEndOfFileOffset(const unique_fd& fd) {
@@ -101,10 +115,50 @@ ErrorMessageOr<void> CaptureFileImpl::Initialize() {
   OUTCOME_TRY(ReadHeader());
   OUTCOME_TRY(ReadSectionList());
   OUTCOME_TRY(CalculateCaptureSectionSize());
+  if (IsCaptureSectionCompressed()) {
+    OUTCOME_TRY(ReadCaptureSectionBlocks());
+  }
 
   return outcome::success();
 }
 
+ErrorMessageOr<void> CaptureFileImpl::ReadCaptureSectionBlocks() {
+  std::optional<uint64_t> section_number = FindSectionByType(kSectionTypeCaptureSectionBlocks);
+  if (!section_number.has_value()) {
+    return ErrorMessage{"The capture section is compressed but its list of blocks is missing"};
+  }
+
+  const CaptureFileSection& section = section_list_[section_number.value()];
+  uint64_t number_of_blocks = 0;
+  if (section.size < sizeof(number_of_blocks)) {
+    return ErrorMessage{"The list of blocks of the capture section is too small"};
+  }
+  OUTCOME_TRY(ReadFromSection(section_number.value(), 0, &number_of_blocks,
+                              sizeof(number_of_blocks)));
+  if (number_of_blocks > (section.size - sizeof(number_of_blocks)) / sizeof(CaptureSectionBlock)) {
+    return ErrorMessage{absl::StrFormat(
+        "The list of blocks of the capture section is too large: %d blocks in %d bytes",
+        number_of_blocks, section.size)};
+  }
+
+  std::vector<CaptureSectionBlock> blocks(number_of_blocks);
+  OUTCOME_TRY(ReadFromSection(section_number.value(), sizeof(number_of_blocks), blocks.data(),
+                              number_of_blocks * sizeof(CaptureSectionBlock)));
+
+  const uint64_t capture_section_end = header_.capture_section_offset + capture_section_size_;
+  for (const CaptureSectionBlock& block : blocks) {
+    if (block.offset < header_.capture_section_offset || block.offset > capture_section_end ||
+        block.compressed_size > capture_section_end - block.offset) {
+      return ErrorMessage{absl::StrFormat(
+          "The capture section block at offset %d with size %d is outside of the capture section",
+          block.offset, block.compressed_size)};
+    }
+  }
+
+  capture_section_blocks_ = std::move(blocks);
+  return outcome::success();
+}
+
 ErrorMessageOr<void> CaptureFileImpl::CalculateCaptureSectionSize() {
   // If there are no additional sections the capture section ends at the EOF
   if (header_.section_list_offset == 0) {
@@ -172,7 +226,7 @@ ErrorMessageOr<void> CaptureFileImpl::ReadHeader() {
     return ErrorMessage{"Invalid file signature"};
   }
 
-  if (header_.version != kFileVersion) {
+  if (header_.version != kFileVersion && header_.version != kCompressedFileVersion) {
     return ErrorMessage{
         absl::StrFormat("Incompatible version %d, expected %d", header_.version, kFileVersion)};
   }
@@ -281,10 +335,44 @@ ErrorMessageOr<void> CaptureFileImpl::ReadFromSection(uint64_t section_number,
 }
 
 std::unique_ptr<ProtoSectionInputStream> CaptureFileImpl::CreateCaptureSectionInputStream() {
+  if (IsCaptureSectionCompressed()) {
+    return std::make_unique<orbit_capture_file_internal::ProtoSectionInputStreamImpl>(
+        std::make_unique<orbit_capture_file_internal::CompressedCaptureSectionInputStream>(
+            fd_, capture_section_blocks_));
+  }
+
   return std::make_unique<orbit_capture_file_internal::ProtoSectionInputStreamImpl>(
       fd_, header_.capture_section_offset, capture_section_size_);
 }
 
+ErrorMessageOr<std::unique_ptr<ProtoSectionInputStream>>
+CaptureFileImpl::CreateCaptureSectionInputStreamFromTimestamp(uint64_t timestamp_ns) {
+  std::optional<uint64_t> time_index_section_number = FindSectionByType(kSectionTypeTimeIndex);
+  if (!time_index_section_number.has_value()) return CreateCaptureSectionInputStream();
+
+  // The offsets in the time index refer to the uncompressed capture section.
+  uint64_t uncompressed_capture_section_size = capture_section_size_;
+  if (IsCaptureSectionCompressed()) {
+    uncompressed_capture_section_size = 0;
+    for (const CaptureSectionBlock& block : capture_section_blocks_) {
+      uncompressed_capture_section_size += block.uncompressed_size;
+    }
+  }
+
+  std::unique_ptr<ProtoSectionInputStream> time_index_stream =
+      CreateProtoSectionInputStream(time_index_section_number.value());
+  OUTCOME_TRY(auto&& seek_position,
+              orbit_capture_file_internal::FindCaptureSectionSeekPosition(
+                  time_index_stream.get(), uncompressed_capture_section_size, timestamp_ns));
+
+  if (IsCaptureSectionCompressed()) {
+    return std::make_unique<orbit_capture_file_internal::SeekingCaptureSectionInputStream>(
+        fd_, capture_section_blocks_, std::move(seek_position));
+  }
+  return std::make_unique<orbit_capture_file_internal::SeekingCaptureSectionInputStream>(
+      fd_, header_.capture_section_offset, capture_section_size_, std::move(seek_position));
+}
+
 std::unique_ptr<ProtoSectionInputStream> CaptureFileImpl::CreateProtoSectionInputStream(
     uint64_t section_number) {
   ORBIT_CHECK(section_number < section_list_.size());
@@ -17,5 +17,8 @@ constexpr std::string_view kFileSignature = "ORBT";
 static_assert(kFileSignature.size() == 4);
 
 constexpr uint32_t kFileVersion = 1;
+// Version 2 only differs in that the capture section is compressed. Files with uncompressed capture
+// section keep using version 1 so that older readers can still open them.
+constexpr uint32_t kCompressedFileVersion = 2;
 
 #endif  // CAPTURE_FILE_CONSTANTS_H_
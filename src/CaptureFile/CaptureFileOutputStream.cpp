@@ -11,9 +11,15 @@
 
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "CaptureFile/BufferOutputStream.h"
+#include "CaptureFile/CaptureFileSection.h"
 #include "CaptureFileConstants.h"
+#include "CaptureTimeIndex.h"
+#include "ClientProtos/capture_time_index.pb.h"
+#include "CompressedCaptureSection.h"
+#include "OrbitBase/Align.h"
 #include "OrbitBase/File.h"
 #include "OrbitBase/Logging.h"
 #include "OrbitBase/SafeStrerror.h"
@@ -22,10 +28,26 @@ namespace orbit_capture_file {
 
 namespace {
 
+using orbit_capture_file_internal::CaptureSectionBlock;
+using orbit_capture_file_internal::CaptureTimeIndexBuilder;
+
+// signature - 4bytes, version - 4bytes
+// capture section offset - 8 bytes
+// additional section offset - 8 bytes
+constexpr uint64_t kSectionListOffsetFieldOffset =
+    kFileSignature.size() + sizeof(kFileVersion) + sizeof(uint64_t);
+constexpr uint64_t kCaptureSectionOffset = kSectionListOffsetFieldOffset + sizeof(uint64_t);
+
 class CaptureFileOutputStreamImpl final : public CaptureFileOutputStream {
  public:
-  explicit CaptureFileOutputStreamImpl(std::filesystem::path path)
-      : output_type_(OutputType::kFile), path_{std::move(path)} {}
+  explicit CaptureFileOutputStreamImpl(std::filesystem::path path, const Options& options)
+      : output_type_(OutputType::kFile),
+        path_{std::move(path)},
+        compress_capture_section_{options.compress_capture_section} {
+    if (options.time_index_block_size.has_value()) {
+      time_index_builder_.emplace(options.time_index_block_size.value());
+    }
+  }
   explicit CaptureFileOutputStreamImpl(BufferOutputStream* output_buffer)
       : output_type_(OutputType::kBuffer), output_buffer_(output_buffer) {}
   ~CaptureFileOutputStreamImpl() override;
@@ -39,6 +61,17 @@ class CaptureFileOutputStreamImpl final : public CaptureFileOutputStream {
  private:
   void Reset();
   [[nodiscard]] ErrorMessageOr<void> WriteHeader();
+  // Compresses the events collected in `uncompressed_block_` and writes them as one block.
+  [[nodiscard]] ErrorMessageOr<void> WriteCompressedBlock();
+  // Writes the additional sections and the section list after the capture section and returns the
+  // offset of the section list.
+  [[nodiscard]] ErrorMessageOr<uint64_t> WriteAdditionalSectionsAndSectionList();
+  [[nodiscard]] ErrorMessageOr<CaptureFileSection> WriteTimeIndexSection();
+  [[nodiscard]] ErrorMessageOr<CaptureFileSection> WriteCaptureSectionBlocksSection();
+  [[nodiscard]] ErrorMessageOr<void> WriteSectionListOffsetToHeader(uint64_t section_list_offset);
+  void WritePaddingTo(uint64_t file_offset);
+  // Writes a Varint32-prefixed message and returns the number of bytes written.
+  uint64_t WriteMessage(const google::protobuf::Message& message);
   [[nodiscard]] std::string_view GetErrorFromOutputStream() const;
   // Handles write error by cleaning up the file and generating error message.
   [[nodiscard]] ErrorMessage HandleWriteError(const char* section_name,
@@ -54,6 +87,16 @@ class CaptureFileOutputStreamImpl final : public CaptureFileOutputStream {
   BufferOutputStream* output_buffer_ = nullptr;
   std::unique_ptr<google::protobuf::io::ZeroCopyOutputStream> zero_copy_output_stream_;
   std::optional<google::protobuf::io::CodedOutputStream> coded_output_;
+
+  // The number of bytes written to the file so far.
+  uint64_t file_size_ = 0;
+  // The number of bytes of the events written so far, before compression.
+  uint64_t capture_section_size_ = 0;
+  std::optional<CaptureTimeIndexBuilder> time_index_builder_;
+
+  bool compress_capture_section_ = false;
+  std::string uncompressed_block_;
+  std::vector<CaptureSectionBlock> capture_section_blocks_;
 };
 
 CaptureFileOutputStreamImpl::~CaptureFileOutputStreamImpl() {
@@ -94,10 +137,23 @@ ErrorMessageOr<void> CaptureFileOutputStreamImpl::Initialize() {
 }
 
 ErrorMessageOr<void> CaptureFileOutputStreamImpl::Close() {
+  if (compress_capture_section_) {
+    OUTCOME_TRY(WriteCompressedBlock());
+  }
+
+  std::optional<uint64_t> section_list_offset;
+  if (time_index_builder_.has_value() || compress_capture_section_) {
+    OUTCOME_TRY(section_list_offset, WriteAdditionalSectionsAndSectionList());
+  }
+
   coded_output_->Trim();
   if (coded_output_->HadError()) {
     return HandleWriteError("Unknown", GetErrorFromOutputStream());
   }
+
+  if (section_list_offset.has_value()) {
+    OUTCOME_TRY(WriteSectionListOffsetToHeader(section_list_offset.value()));
+  }
   Reset();
 
   return outcome::success();
@@ -155,11 +211,32 @@ ErrorMessageOr<void> CaptureFileOutputStreamImpl::WriteCaptureEvent(
   ORBIT_CHECK(coded_output_.has_value());
   ORBIT_CHECK(zero_copy_output_stream_ != nullptr);
 
+  if (time_index_builder_.has_value()) {
+    time_index_builder_->AddEvent(event, capture_section_size_);
+  }
+
   uint32_t event_size = event.ByteSizeLong();
+  const uint64_t serialized_event_size =
+      google::protobuf::io::CodedOutputStream::VarintSize32(event_size) + event_size;
+  capture_section_size_ += serialized_event_size;
+
+  if (compress_capture_section_) {
+    const size_t offset_in_block = uncompressed_block_.size();
+    uncompressed_block_.resize(offset_in_block + serialized_event_size);
+    uint8_t* target = reinterpret_cast<uint8_t*>(uncompressed_block_.data() + offset_in_block);
+    target = google::protobuf::io::CodedOutputStream::WriteVarint32ToArray(event_size, target);
+    event.SerializeWithCachedSizesToArray(target);
+    if (uncompressed_block_.size() >= orbit_capture_file_internal::kCaptureSectionBlockSize) {
+      OUTCOME_TRY(WriteCompressedBlock());
+    }
+    return outcome::success();
+  }
+
   coded_output_->WriteVarint32(event_size);
   if (!event.SerializeToCodedStream(&coded_output_.value()) || coded_output_->HadError()) {
     return HandleWriteError("Capture", GetErrorFromOutputStream());
   }
+  file_size_ += serialized_event_size;
 
   return outcome::success();
 }
@@ -168,16 +245,14 @@ ErrorMessageOr<void> CaptureFileOutputStreamImpl::WriteHeader() {
   ORBIT_CHECK(coded_output_.has_value());
 
   std::string header{kFileSignature};
-  header.append(std::string_view(absl::bit_cast<char*>(&kFileVersion), sizeof(kFileVersion)));
-  // signature - 4bytes, version - 4bytes
-  // capture section offset - 8 bytes
-  // additional section offset - 8 bytes
-  uint64_t capture_section_offset =
-      kFileSignature.size() + sizeof(kFileVersion) + 2 * sizeof(uint64_t);
+  const uint32_t version = compress_capture_section_ ? kCompressedFileVersion : kFileVersion;
+  header.append(std::string_view(absl::bit_cast<const char*>(&version), sizeof(version)));
+  uint64_t capture_section_offset = kCaptureSectionOffset;
   header.append(std::string_view(absl::bit_cast<char*>(&capture_section_offset),
                                  sizeof(capture_section_offset)));
-  uint64_t additional_section_list_offset =
-      0;  // For the streaming format we have no additional sections
+  // For the streaming format we have no additional sections. With a time index, the offset is
+  // updated when the stream is closed.
+  uint64_t additional_section_list_offset = 0;
   header.append(std::string_view(absl::bit_cast<char*>(&additional_section_list_offset),
                                  sizeof(additional_section_list_offset)));
 
@@ -187,6 +262,135 @@ ErrorMessageOr<void> CaptureFileOutputStreamImpl::WriteHeader() {
   if (coded_output_->HadError()) {
     return HandleWriteError("Header", GetErrorFromOutputStream());
   }
+  file_size_ = header.size();
+
+  return outcome::success();
+}
+
+ErrorMessageOr<void> CaptureFileOutputStreamImpl::WriteCompressedBlock() {
+  if (uncompressed_block_.empty()) return outcome::success();
+
+  ErrorMessageOr<std::string> compressed_block_or_error =
+      orbit_capture_file_internal::CompressCaptureSectionBlock(uncompressed_block_);
+  if (compressed_block_or_error.has_error()) {
+    return HandleWriteError("Capture", compressed_block_or_error.error().message());
+  }
+  const std::string& compressed_block = compressed_block_or_error.value();
+
+  coded_output_->WriteRaw(compressed_block.data(), static_cast<int>(compressed_block.size()));
+  if (coded_output_->HadError()) {
+    return HandleWriteError("Capture", GetErrorFromOutputStream());
+  }
+
+  capture_section_blocks_.push_back(
+      CaptureSectionBlock{/*.offset = */ file_size_,
+                          /*.compressed_size = */ compressed_block.size(),
+                          /*.uncompressed_size = */ uncompressed_block_.size()});
+  file_size_ += compressed_block.size();
+  uncompressed_block_.clear();
+  return outcome::success();
+}
+
+void CaptureFileOutputStreamImpl::WritePaddingTo(uint64_t file_offset) {
+  ORBIT_CHECK(file_offset >= file_size_);
+  coded_output_->WriteString(std::string(file_offset - file_size_, '\0'));
+  file_size_ = file_offset;
+}
+
+uint64_t CaptureFileOutputStreamImpl::WriteMessage(const google::protobuf::Message& message) {
+  const uint32_t message_size = message.ByteSizeLong();
+  coded_output_->WriteVarint32(message_size);
+  message.SerializeToCodedStream(&coded_output_.value());
+  const uint64_t bytes_written =
+      google::protobuf::io::CodedOutputStream::VarintSize32(message_size) + message_size;
+  file_size_ += bytes_written;
+  return bytes_written;
+}
+
+ErrorMessageOr<CaptureFileSection> CaptureFileOutputStreamImpl::WriteTimeIndexSection() {
+  ORBIT_CHECK(time_index_builder_.has_value());
+
+  const uint64_t section_offset = orbit_base::AlignUp<8>(file_size_);
+  WritePaddingTo(section_offset);
+
+  orbit_client_protos::CaptureTimeIndex time_index;
+  time_index.set_block_size(time_index_builder_->GetBlockSize());
+  time_index.set_block_count(time_index_builder_->GetBlocks().size());
+  uint64_t section_size = WriteMessage(time_index);
+  for (const orbit_client_protos::CaptureTimeIndexBlock& block : time_index_builder_->GetBlocks()) {
+    section_size += WriteMessage(block);
+  }
+  if (coded_output_->HadError()) {
+    return HandleWriteError("TimeIndex", GetErrorFromOutputStream());
+  }
+
+  return CaptureFileSection{/*.type = */ kSectionTypeTimeIndex, /*.offset = */ section_offset,
+                            /*.size = */ section_size};
+}
+
+ErrorMessageOr<CaptureFileSection> CaptureFileOutputStreamImpl::WriteCaptureSectionBlocksSection() {
+  const uint64_t section_offset = orbit_base::AlignUp<8>(file_size_);
+  WritePaddingTo(section_offset);
+
+  const uint64_t number_of_blocks = capture_section_blocks_.size();
+  const uint64_t section_size =
+      sizeof(number_of_blocks) + number_of_blocks * sizeof(CaptureSectionBlock);
+  coded_output_->WriteRaw(&number_of_blocks, sizeof(number_of_blocks));
+  coded_output_->WriteRaw(capture_section_blocks_.data(),
+                          static_cast<int>(number_of_blocks * sizeof(CaptureSectionBlock)));
+  if (coded_output_->HadError()) {
+    return HandleWriteError("CaptureSectionBlocks", GetErrorFromOutputStream());
+  }
+  file_size_ += section_size;
+
+  return CaptureFileSection{/*.type = */ kSectionTypeCaptureSectionBlocks,
+                            /*.offset = */ section_offset, /*.size = */ section_size};
+}
+
+ErrorMessageOr<uint64_t> CaptureFileOutputStreamImpl::WriteAdditionalSectionsAndSectionList() {
+  ORBIT_CHECK(coded_output_.has_value());
+
+  std::vector<CaptureFileSection> section_list;
+  if (time_index_builder_.has_value()) {
+    OUTCOME_TRY(auto&& time_index_section, WriteTimeIndexSection());
+    section_list.push_back(time_index_section);
+  }
+  if (compress_capture_section_) {
+    OUTCOME_TRY(auto&& capture_section_blocks_section, WriteCaptureSectionBlocksSection());
+    section_list.push_back(capture_section_blocks_section);
+  }
+
+  const uint64_t section_list_offset = orbit_base::AlignUp<8>(file_size_);
+  WritePaddingTo(section_list_offset);
+
+  const uint64_t number_of_sections = section_list.size();
+  coded_output_->WriteRaw(&number_of_sections, sizeof(number_of_sections));
+  coded_output_->WriteRaw(section_list.data(),
+                          static_cast<int>(number_of_sections * sizeof(CaptureFileSection)));
+  if (coded_output_->HadError()) {
+    return HandleWriteError("SectionList", GetErrorFromOutputStream());
+  }
+  file_size_ += sizeof(number_of_sections) + number_of_sections * sizeof(CaptureFileSection);
+
+  return section_list_offset;
+}
+
+ErrorMessageOr<void> CaptureFileOutputStreamImpl::WriteSectionListOffsetToHeader(
+    uint64_t section_list_offset) {
+  ORBIT_CHECK(output_type_ == OutputType::kFile);
+  // Everything written so far needs to be in the file before the header points to the section
+  // list.
+  coded_output_.reset();
+  if (!static_cast<google::protobuf::io::FileOutputStream*>(zero_copy_output_stream_.get())
+           ->Flush()) {
+    return HandleWriteError("SectionList", GetErrorFromOutputStream());
+  }
+
+  auto write_result = orbit_base::WriteFullyAtOffset(
+      fd_, &section_list_offset, sizeof(section_list_offset), kSectionListOffsetFieldOffset);
+  if (write_result.has_error()) {
+    return HandleWriteError("Header", write_result.error().message());
+  }
 
   return outcome::success();
 }
@@ -195,7 +399,12 @@ ErrorMessageOr<void> CaptureFileOutputStreamImpl::WriteHeader() {
 
 ErrorMessageOr<std::unique_ptr<CaptureFileOutputStream>> CaptureFileOutputStream::Create(
     std::filesystem::path path) {
-  auto implementation = std::make_unique<CaptureFileOutputStreamImpl>(std::move(path));
+  return Create(std::move(path), Options{});
+}
+
+ErrorMessageOr<std::unique_ptr<CaptureFileOutputStream>> CaptureFileOutputStream::Create(
+    std::filesystem::path path, const Options& options) {
+  auto implementation = std::make_unique<CaptureFileOutputStreamImpl>(std::move(path), options);
   auto init_result = implementation->Initialize();
   if (init_result.has_error()) {
     return init_result.error();
@@ -3,14 +3,24 @@
 // found in the LICENSE file.
 
 #include <absl/base/casts.h>
+#include <absl/strings/str_format.h>
 #include <gmock/gmock.h>
 #include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 #include <gtest/gtest.h>
 #include <stdint.h>
 
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
 #include "CaptureFile/CaptureFile.h"
 #include "CaptureFile/CaptureFileOutputStream.h"
 #include "CaptureFileConstants.h"
+#include "OrbitBase/File.h"
+#include "OrbitBase/Logging.h"
 #include "OrbitBase/TemporaryFile.h"
 #include "TestUtils/TestUtils.h"
 
@@ -29,6 +39,14 @@ static constexpr uint64_t kNotAnAnswerKey = 43;
 using orbit_grpc_protos::ClientCaptureEvent;
 using testing::HasSubstr;
 
+static ClientCaptureEvent CreateFunctionCallCaptureEvent(uint64_t end_timestamp_ns) {
+  ClientCaptureEvent event;
+  orbit_grpc_protos::FunctionCall* function_call = event.mutable_function_call();
+  function_call->set_end_timestamp_ns(end_timestamp_ns);
+  function_call->set_duration_ns(10);
+  return event;
+}
+
 static ClientCaptureEvent CreateInternedStringCaptureEvent(uint64_t key, const std::string& str) {
   ClientCaptureEvent event;
   orbit_grpc_protos::InternedString* interned_string = event.mutable_interned_string();
@@ -88,6 +106,44 @@ TEST(CaptureFile, CreateCaptureFileAndReadMainSection) {
   }
 }
 
+TEST(CaptureFile, CreateCaptureFileAndReadSerializedMessagesOfMainSection) {
+  auto temporary_file_or_error = orbit_base::TemporaryFile::Create();
+  ASSERT_TRUE(temporary_file_or_error.has_value()) << temporary_file_or_error.error().message();
+  orbit_base::TemporaryFile temporary_file = std::move(temporary_file_or_error.value());
+
+  std::string temp_file_name = temporary_file.file_path().string();
+  temporary_file.CloseAndRemove();
+
+  auto output_stream_or_error = CaptureFileOutputStream::Create(temp_file_name);
+  ASSERT_TRUE(output_stream_or_error.has_value()) << output_stream_or_error.error().message();
+  std::unique_ptr<CaptureFileOutputStream> output_stream =
+      std::move(output_stream_or_error.value());
+
+  orbit_grpc_protos::ClientCaptureEvent event1 =
+      CreateInternedStringCaptureEvent(kAnswerKey, kAnswerString);
+  orbit_grpc_protos::ClientCaptureEvent event2 =
+      CreateInternedStringCaptureEvent(kNotAnAnswerKey, kNotAnAnswerString);
+  ASSERT_THAT(output_stream->WriteCaptureEvent(event1), HasNoError());
+  ASSERT_THAT(output_stream->WriteCaptureEvent(event2), HasNoError());
+  ASSERT_THAT(output_stream->Close(), HasNoError());
+
+  auto capture_file_or_error = CaptureFile::OpenForReadWrite(temporary_file.file_path());
+  ASSERT_TRUE(capture_file_or_error.has_value()) << capture_file_or_error.error().message();
+  std::unique_ptr<CaptureFile> capture_file = std::move(capture_file_or_error.value());
+
+  auto capture_section = capture_file->CreateCaptureSectionInputStream();
+
+  std::string serialized_event;
+  ASSERT_THAT(capture_section->ReadSerializedMessage(&serialized_event), HasNoError());
+  EXPECT_EQ(serialized_event, event1.SerializeAsString());
+
+  // Reading serialized and parsed messages can be mixed.
+  ClientCaptureEvent event;
+  ASSERT_THAT(capture_section->ReadMessage(&event), HasNoError());
+  EXPECT_EQ(event.interned_string().key(), kNotAnAnswerKey);
+  EXPECT_EQ(event.interned_string().intern(), kNotAnAnswerString);
+}
+
 TEST(CaptureFile, CreateCaptureFileWriteAdditionalSectionAndReadMainSection) {
   auto temporary_file_or_error = orbit_base::TemporaryFile::Create();
   ASSERT_TRUE(temporary_file_or_error.has_value()) << temporary_file_or_error.error().message();
@@ -358,4 +414,398 @@ TEST(CaptureFile, OpenCaptureFileInvalidSectionListSizeTooLarge) {
   EXPECT_THAT(capture_file_or_error, HasError("The section list is too large"));
 }
 
+// Writes 100 function calls ending at 1000, 2000, ..., 100000 with an interned string before
+// every tenth of them, followed by CaptureFinished.
+static void WriteCaptureWithTimeIndex(const std::filesystem::path& file_path,
+                                      bool compress_capture_section = false) {
+  CaptureFileOutputStream::Options options;
+  options.time_index_block_size = 64;
+  options.compress_capture_section = compress_capture_section;
+  auto output_stream_or_error = CaptureFileOutputStream::Create(file_path, options);
+  ASSERT_TRUE(output_stream_or_error.has_value()) << output_stream_or_error.error().message();
+  std::unique_ptr<CaptureFileOutputStream> output_stream =
+      std::move(output_stream_or_error.value());
+
+  for (uint64_t i = 1; i <= 100; ++i) {
+    if (i % 10 == 1) {
+      ASSERT_THAT(output_stream->WriteCaptureEvent(
+                      CreateInternedStringCaptureEvent(i, absl::StrFormat("string %d", i))),
+                  HasNoError());
+    }
+    ASSERT_THAT(output_stream->WriteCaptureEvent(CreateFunctionCallCaptureEvent(i * 1000)),
+                HasNoError());
+  }
+  ClientCaptureEvent capture_finished;
+  capture_finished.mutable_capture_finished();
+  ASSERT_THAT(output_stream->WriteCaptureEvent(capture_finished), HasNoError());
+  ASSERT_THAT(output_stream->Close(), HasNoError());
+}
+
+static std::vector<ClientCaptureEvent> ReadEventsUpToCaptureFinished(
+    ProtoSectionInputStream* input_stream) {
+  std::vector<ClientCaptureEvent> events;
+  do {
+    ClientCaptureEvent& event = events.emplace_back();
+    ErrorMessageOr<void> result = input_stream->ReadMessage(&event);
+    EXPECT_THAT(result, HasNoError());
+    if (result.has_error()) break;
+  } while (events.back().event_case() != ClientCaptureEvent::kCaptureFinished);
+  return events;
+}
+
+TEST(CaptureFile, CreateCaptureFileWithTimeIndexAndReadFromTimestamp) {
+  auto temporary_file_or_error = orbit_base::TemporaryFile::Create();
+  ASSERT_TRUE(temporary_file_or_error.has_value()) << temporary_file_or_error.error().message();
+  orbit_base::TemporaryFile temporary_file = std::move(temporary_file_or_error.value());
+  temporary_file.CloseAndRemove();
+  WriteCaptureWithTimeIndex(temporary_file.file_path());
+
+  auto capture_file_or_error = CaptureFile::OpenForReadWrite(temporary_file.file_path());
+  ASSERT_TRUE(capture_file_or_error.has_value()) << capture_file_or_error.error().message();
+  std::unique_ptr<CaptureFile> capture_file = std::move(capture_file_or_error.value());
+
+  ASSERT_EQ(capture_file->GetSectionList().size(), 1);
+  EXPECT_EQ(capture_file->FindSectionByType(kSectionTypeTimeIndex), 0);
+
+  std::vector<ClientCaptureEvent> all_events =
+      ReadEventsUpToCaptureFinished(capture_file->CreateCaptureSectionInputStream().get());
+  ASSERT_EQ(all_events.size(), 111);
+
+  {
+    auto input_stream_or_error = capture_file->CreateCaptureSectionInputStreamFromTimestamp(0);
+    ASSERT_THAT(input_stream_or_error, HasValue());
+    std::vector<ClientCaptureEvent> events =
+        ReadEventsUpToCaptureFinished(input_stream_or_error.value().get());
+    ASSERT_EQ(events.size(), all_events.size());
+    for (size_t i = 0; i < events.size(); ++i) {
+      EXPECT_EQ(events[i].SerializeAsString(), all_events[i].SerializeAsString());
+    }
+  }
+
+  {
+    constexpr uint64_t kTimestampNs = 50'500;
+    auto input_stream_or_error =
+        capture_file->CreateCaptureSectionInputStreamFromTimestamp(kTimestampNs);
+    ASSERT_THAT(input_stream_or_error, HasValue());
+    std::vector<ClientCaptureEvent> events =
+        ReadEventsUpToCaptureFinished(input_stream_or_error.value().get());
+
+    // All interned strings are there, in order, but not all the function calls before the
+    // timestamp.
+    std::vector<uint64_t> interned_string_keys;
+    std::vector<uint64_t> function_call_end_timestamps;
+    for (const ClientCaptureEvent& event : events) {
+      if (event.event_case() == ClientCaptureEvent::kInternedString) {
+        EXPECT_TRUE(function_call_end_timestamps.empty() ||
+                    function_call_end_timestamps.back() < event.interned_string().key() * 1000);
+        interned_string_keys.push_back(event.interned_string().key());
+      } else if (event.event_case() == ClientCaptureEvent::kFunctionCall) {
+        function_call_end_timestamps.push_back(event.function_call().end_timestamp_ns());
+      }
+    }
+    EXPECT_THAT(interned_string_keys, testing::ElementsAre(1, 11, 21, 31, 41, 51, 61, 71, 81, 91));
+    ASSERT_FALSE(function_call_end_timestamps.empty());
+    EXPECT_LT(function_call_end_timestamps.front(), kTimestampNs);
+    EXPECT_GT(function_call_end_timestamps.front(), 40'000);
+    EXPECT_EQ(function_call_end_timestamps.back(), 100'000);
+    EXPECT_TRUE(std::is_sorted(function_call_end_timestamps.begin(),
+                               function_call_end_timestamps.end()));
+    EXPECT_EQ(function_call_end_timestamps.size(),
+              1 + (100'000 - function_call_end_timestamps.front()) / 1000);
+  }
+
+  {
+    auto input_stream_or_error =
+        capture_file->CreateCaptureSectionInputStreamFromTimestamp(1'000'000);
+    ASSERT_THAT(input_stream_or_error, HasValue());
+    std::vector<ClientCaptureEvent> events =
+        ReadEventsUpToCaptureFinished(input_stream_or_error.value().get());
+    EXPECT_EQ(events.size(), 11);
+    EXPECT_TRUE(std::none_of(events.begin(), events.end(), [](const ClientCaptureEvent& event) {
+      return event.event_case() == ClientCaptureEvent::kFunctionCall;
+    }));
+  }
+}
+
+TEST(CaptureFile, AddUserDataSectionToCaptureFileWithTimeIndex) {
+  auto temporary_file_or_error = orbit_base::TemporaryFile::Create();
+  ASSERT_TRUE(temporary_file_or_error.has_value()) << temporary_file_or_error.error().message();
+  orbit_base::TemporaryFile temporary_file = std::move(temporary_file_or_error.value());
+  temporary_file.CloseAndRemove();
+  WriteCaptureWithTimeIndex(temporary_file.file_path());
+
+  {
+    auto capture_file_or_error = CaptureFile::OpenForReadWrite(temporary_file.file_path());
+    ASSERT_TRUE(capture_file_or_error.has_value()) << capture_file_or_error.error().message();
+    ASSERT_THAT(capture_file_or_error.value()->AddUserDataSection(16), HasValue());
+  }
+
+  auto capture_file_or_error = CaptureFile::OpenForReadWrite(temporary_file.file_path());
+  ASSERT_TRUE(capture_file_or_error.has_value()) << capture_file_or_error.error().message();
+  std::unique_ptr<CaptureFile> capture_file = std::move(capture_file_or_error.value());
+  EXPECT_EQ(capture_file->FindSectionByType(kSectionTypeTimeIndex), 0);
+  EXPECT_EQ(capture_file->FindSectionByType(kSectionTypeUserData), 1);
+
+  auto input_stream_or_error =
+      capture_file->CreateCaptureSectionInputStreamFromTimestamp(1'000'000);
+  ASSERT_THAT(input_stream_or_error, HasValue());
+  EXPECT_EQ(ReadEventsUpToCaptureFinished(input_stream_or_error.value().get()).size(), 11);
+}
+
+static std::string SerializeEvents(const std::vector<ClientCaptureEvent>& events) {
+  std::string serialized_events;
+  for (const ClientCaptureEvent& event : events) {
+    serialized_events.append(event.SerializeAsString());
+  }
+  return serialized_events;
+}
+
+TEST(CaptureFile, CreateCompressedCaptureFileAndReadFromTimestamp) {
+  auto uncompressed_file_or_error = orbit_base::TemporaryFile::Create();
+  ASSERT_TRUE(uncompressed_file_or_error.has_value())
+      << uncompressed_file_or_error.error().message();
+  orbit_base::TemporaryFile uncompressed_file = std::move(uncompressed_file_or_error.value());
+  uncompressed_file.CloseAndRemove();
+  WriteCaptureWithTimeIndex(uncompressed_file.file_path());
+
+  auto compressed_file_or_error = orbit_base::TemporaryFile::Create();
+  ASSERT_TRUE(compressed_file_or_error.has_value()) << compressed_file_or_error.error().message();
+  orbit_base::TemporaryFile compressed_file = std::move(compressed_file_or_error.value());
+  compressed_file.CloseAndRemove();
+  WriteCaptureWithTimeIndex(compressed_file.file_path(), /*compress_capture_section=*/true);
+
+  auto uncompressed_capture_file_or_error =
+      CaptureFile::OpenForReadWrite(uncompressed_file.file_path());
+  ASSERT_TRUE(uncompressed_capture_file_or_error.has_value())
+      << uncompressed_capture_file_or_error.error().message();
+  std::unique_ptr<CaptureFile> uncompressed_capture_file =
+      std::move(uncompressed_capture_file_or_error.value());
+
+  auto compressed_capture_file_or_error = CaptureFile::OpenForReadWrite(compressed_file.file_path());
+  ASSERT_TRUE(compressed_capture_file_or_error.has_value())
+      << compressed_capture_file_or_error.error().message();
+  std::unique_ptr<CaptureFile> compressed_capture_file =
+      std::move(compressed_capture_file_or_error.value());
+
+  ASSERT_EQ(compressed_capture_file->GetSectionList().size(), 2);
+  EXPECT_EQ(compressed_capture_file->FindSectionByType(kSectionTypeTimeIndex), 0);
+  EXPECT_EQ(compressed_capture_file->FindSectionByType(kSectionTypeCaptureSectionBlocks), 1);
+
+  std::vector<ClientCaptureEvent> all_events = ReadEventsUpToCaptureFinished(
+      compressed_capture_file->CreateCaptureSectionInputStream().get());
+  EXPECT_EQ(all_events.size(), 111);
+  EXPECT_EQ(SerializeEvents(all_events),
+            SerializeEvents(ReadEventsUpToCaptureFinished(
+                uncompressed_capture_file->CreateCaptureSectionInputStream().get())));
+
+  for (uint64_t timestamp_ns : {0, 50'500, 1'000'000}) {
+    auto compressed_stream_or_error =
+        compressed_capture_file->CreateCaptureSectionInputStreamFromTimestamp(timestamp_ns);
+    ASSERT_THAT(compressed_stream_or_error, HasValue());
+    auto uncompressed_stream_or_error =
+        uncompressed_capture_file->CreateCaptureSectionInputStreamFromTimestamp(timestamp_ns);
+    ASSERT_THAT(uncompressed_stream_or_error, HasValue());
+    EXPECT_EQ(
+        SerializeEvents(ReadEventsUpToCaptureFinished(compressed_stream_or_error.value().get())),
+        SerializeEvents(ReadEventsUpToCaptureFinished(uncompressed_stream_or_error.value().get())));
+  }
+}
+
+TEST(CaptureFile, ReadCompressedCaptureFileWithMultipleBlocks) {
+  auto temporary_file_or_error = orbit_base::TemporaryFile::Create();
+  ASSERT_TRUE(temporary_file_or_error.has_value()) << temporary_file_or_error.error().message();
+  orbit_base::TemporaryFile temporary_file = std::move(temporary_file_or_error.value());
+  temporary_file.CloseAndRemove();
+
+  // About 4 MiB of events, that is several blocks of the compressed capture section.
+  constexpr uint64_t kFunctionCallCount = 400'000;
+  constexpr uint64_t kInternedStringInterval = 10'000;
+  {
+    CaptureFileOutputStream::Options options;
+    options.time_index_block_size = CaptureFileOutputStream::kDefaultTimeIndexBlockSize;
+    options.compress_capture_section = true;
+    auto output_stream_or_error =
+        CaptureFileOutputStream::Create(temporary_file.file_path(), options);
+    ASSERT_THAT(output_stream_or_error, HasValue());
+    std::unique_ptr<CaptureFileOutputStream> output_stream =
+        std::move(output_stream_or_error.value());
+    for (uint64_t i = 1; i <= kFunctionCallCount; ++i) {
+      if (i % kInternedStringInterval == 1) {
+        ASSERT_THAT(output_stream->WriteCaptureEvent(
+                        CreateInternedStringCaptureEvent(i, absl::StrFormat("string %d", i))),
+                    HasNoError());
+      }
+      ASSERT_THAT(output_stream->WriteCaptureEvent(CreateFunctionCallCaptureEvent(i * 1000)),
+                  HasNoError());
+    }
+    ClientCaptureEvent capture_finished;
+    capture_finished.mutable_capture_finished();
+    ASSERT_THAT(output_stream->WriteCaptureEvent(capture_finished), HasNoError());
+    ASSERT_THAT(output_stream->Close(), HasNoError());
+  }
+
+  auto capture_file_or_error = CaptureFile::OpenForReadWrite(temporary_file.file_path());
+  ASSERT_TRUE(capture_file_or_error.has_value()) << capture_file_or_error.error().message();
+  std::unique_ptr<CaptureFile> capture_file = std::move(capture_file_or_error.value());
+
+  std::optional<uint64_t> blocks_section_number =
+      capture_file->FindSectionByType(kSectionTypeCaptureSectionBlocks);
+  ASSERT_TRUE(blocks_section_number.has_value());
+  uint64_t number_of_blocks = 0;
+  ASSERT_THAT(capture_file->ReadFromSection(blocks_section_number.value(), 0, &number_of_blocks,
+                                            sizeof(number_of_blocks)),
+              HasNoError());
+  EXPECT_GT(number_of_blocks, 2);
+
+  std::vector<ClientCaptureEvent> all_events =
+      ReadEventsUpToCaptureFinished(capture_file->CreateCaptureSectionInputStream().get());
+  ASSERT_EQ(all_events.size(),
+            kFunctionCallCount + kFunctionCallCount / kInternedStringInterval + 1);
+  uint64_t expected_end_timestamp_ns = 1000;
+  for (const ClientCaptureEvent& event : all_events) {
+    if (event.event_case() != ClientCaptureEvent::kFunctionCall) continue;
+    EXPECT_EQ(event.function_call().end_timestamp_ns(), expected_end_timestamp_ns);
+    expected_end_timestamp_ns += 1000;
+  }
+
+  constexpr uint64_t kTimestampNs = kFunctionCallCount / 2 * 1000 + 500;
+  auto input_stream_or_error =
+      capture_file->CreateCaptureSectionInputStreamFromTimestamp(kTimestampNs);
+  ASSERT_THAT(input_stream_or_error, HasValue());
+  std::vector<ClientCaptureEvent> events =
+      ReadEventsUpToCaptureFinished(input_stream_or_error.value().get());
+  uint64_t interned_string_count = 0;
+  std::vector<uint64_t> function_call_end_timestamps;
+  for (const ClientCaptureEvent& event : events) {
+    if (event.event_case() == ClientCaptureEvent::kInternedString) {
+      ++interned_string_count;
+    } else if (event.event_case() == ClientCaptureEvent::kFunctionCall) {
+      function_call_end_timestamps.push_back(event.function_call().end_timestamp_ns());
+    }
+  }
+  EXPECT_EQ(interned_string_count, kFunctionCallCount / kInternedStringInterval);
+  ASSERT_FALSE(function_call_end_timestamps.empty());
+  EXPECT_LT(function_call_end_timestamps.front(), kTimestampNs);
+  EXPECT_GT(function_call_end_timestamps.front(), kTimestampNs / 2);
+  EXPECT_EQ(function_call_end_timestamps.back(), kFunctionCallCount * 1000);
+  EXPECT_EQ(function_call_end_timestamps.size(),
+            1 + (kFunctionCallCount * 1000 - function_call_end_timestamps.front()) / 1000);
+}
+
+TEST(CaptureFile, ReadCorruptedCompressedCaptureSection) {
+  auto temporary_file_or_error = orbit_base::TemporaryFile::Create();
+  ASSERT_TRUE(temporary_file_or_error.has_value()) << temporary_file_or_error.error().message();
+  orbit_base::TemporaryFile temporary_file = std::move(temporary_file_or_error.value());
+  temporary_file.CloseAndRemove();
+  WriteCaptureWithTimeIndex(temporary_file.file_path(), /*compress_capture_section=*/true);
+
+  {
+    auto fd_or_error = orbit_base::OpenExistingFileForReadWrite(temporary_file.file_path());
+    ASSERT_THAT(fd_or_error, HasValue());
+    // Overwrite the middle of the only compressed block.
+    const std::string garbage(16, '\xff');
+    ASSERT_THAT(orbit_base::WriteFullyAtOffset(fd_or_error.value(), garbage.data(), garbage.size(),
+                                               /*offset=*/64),
+                HasNoError());
+  }
+
+  auto capture_file_or_error = CaptureFile::OpenForReadWrite(temporary_file.file_path());
+  ASSERT_TRUE(capture_file_or_error.has_value()) << capture_file_or_error.error().message();
+  std::unique_ptr<CaptureFile> capture_file = std::move(capture_file_or_error.value());
+
+  ClientCaptureEvent event;
+  EXPECT_THAT(capture_file->CreateCaptureSectionInputStream()->ReadMessage(&event),
+              HasError("Unable to decompress the capture section block"));
+}
+
+// Writes a synthetic capture of function calls, callstack samples and scheduling slices on a few
+// threads, with increasing timestamps, and returns the number of events written.
+static uint64_t WriteSyntheticCapture(const std::filesystem::path& file_path,
+                                      const CaptureFileOutputStream::Options& options) {
+  constexpr uint64_t kEventsPerKind = 200'000;
+  constexpr uint32_t kPid = 42;
+  constexpr uint32_t kThreadCount = 16;
+
+  auto output_stream_or_error = CaptureFileOutputStream::Create(file_path, options);
+  EXPECT_THAT(output_stream_or_error, HasValue());
+  std::unique_ptr<CaptureFileOutputStream> output_stream =
+      std::move(output_stream_or_error.value());
+
+  uint64_t timestamp_ns = 1'000'000'000;
+  for (uint64_t i = 0; i < kEventsPerKind; ++i) {
+    const uint32_t tid = kPid + i % kThreadCount;
+    timestamp_ns += 1000 + i % 37;
+
+    ClientCaptureEvent function_call_event;
+    orbit_grpc_protos::FunctionCall* function_call = function_call_event.mutable_function_call();
+    function_call->set_pid(kPid);
+    function_call->set_tid(tid);
+    function_call->set_function_id(i % 100);
+    function_call->set_duration_ns(500 + i % 300);
+    function_call->set_end_timestamp_ns(timestamp_ns);
+    function_call->set_depth(i % 5);
+    EXPECT_THAT(output_stream->WriteCaptureEvent(function_call_event), HasNoError());
+
+    ClientCaptureEvent sample_event;
+    orbit_grpc_protos::CallstackSample* sample = sample_event.mutable_callstack_sample();
+    sample->set_pid(kPid);
+    sample->set_tid(tid);
+    sample->set_callstack_id(i % 1000);
+    sample->set_timestamp_ns(timestamp_ns + 100);
+    EXPECT_THAT(output_stream->WriteCaptureEvent(sample_event), HasNoError());
+
+    ClientCaptureEvent scheduling_slice_event;
+    orbit_grpc_protos::SchedulingSlice* scheduling_slice =
+        scheduling_slice_event.mutable_scheduling_slice();
+    scheduling_slice->set_pid(kPid);
+    scheduling_slice->set_tid(tid);
+    scheduling_slice->set_core(i % 8);
+    scheduling_slice->set_duration_ns(2000 + i % 1000);
+    scheduling_slice->set_out_timestamp_ns(timestamp_ns + 200);
+    EXPECT_THAT(output_stream->WriteCaptureEvent(scheduling_slice_event), HasNoError());
+  }
+  ClientCaptureEvent capture_finished;
+  capture_finished.mutable_capture_finished();
+  EXPECT_THAT(output_stream->WriteCaptureEvent(capture_finished), HasNoError());
+  EXPECT_THAT(output_stream->Close(), HasNoError());
+  return 3 * kEventsPerKind + 1;
+}
+
+// Compares the file size and the write and read throughput of a capture section with and without
+// compression. Disabled by default.
+TEST(CaptureFile, DISABLED_BenchmarkCompressedCaptureSection) {
+  for (bool compress_capture_section : {false, true}) {
+    auto temporary_file_or_error = orbit_base::TemporaryFile::Create();
+    ASSERT_TRUE(temporary_file_or_error.has_value()) << temporary_file_or_error.error().message();
+    orbit_base::TemporaryFile temporary_file = std::move(temporary_file_or_error.value());
+    temporary_file.CloseAndRemove();
+
+    CaptureFileOutputStream::Options options;
+    options.time_index_block_size = CaptureFileOutputStream::kDefaultTimeIndexBlockSize;
+    options.compress_capture_section = compress_capture_section;
+    const auto write_start = std::chrono::steady_clock::now();
+    const uint64_t event_count = WriteSyntheticCapture(temporary_file.file_path(), options);
+    const std::chrono::duration<double> write_duration =
+        std::chrono::steady_clock::now() - write_start;
+
+    const auto read_start = std::chrono::steady_clock::now();
+    auto capture_file_or_error = CaptureFile::OpenForReadWrite(temporary_file.file_path());
+    ASSERT_TRUE(capture_file_or_error.has_value()) << capture_file_or_error.error().message();
+    std::unique_ptr<ProtoSectionInputStream> input_stream =
+        capture_file_or_error.value()->CreateCaptureSectionInputStream();
+    ClientCaptureEvent event;
+    for (uint64_t i = 0; i < event_count; ++i) {
+      ASSERT_THAT(input_stream->ReadMessage(&event), HasNoError());
+    }
+    const std::chrono::duration<double> read_duration =
+        std::chrono::steady_clock::now() - read_start;
+
+    ORBIT_LOG("%s capture section: %d bytes, writing %.2f M events/s, reading %.2f M events/s",
+              compress_capture_section ? "Compressed" : "Uncompressed",
+              std::filesystem::file_size(temporary_file.file_path()),
+              event_count / write_duration.count() / 1e6,
+              event_count / read_duration.count() / 1e6);
+  }
+}
+
 }  // namespace orbit_capture_file
\ No newline at end of file
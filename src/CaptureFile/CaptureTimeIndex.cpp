@@ -0,0 +1,174 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "CaptureTimeIndex.h"
+
+#include <absl/strings/str_format.h>
+
+#include <algorithm>
+
+#include "OrbitBase/Logging.h"
+
+using orbit_client_protos::CaptureTimeIndex;
+using orbit_client_protos::CaptureTimeIndexBlock;
+using orbit_grpc_protos::ClientCaptureEvent;
+
+namespace orbit_capture_file_internal {
+
+namespace {
+
+// A TIME_INDEX section comes from an untrusted file, limit its size to something that a real
+// capture could produce.
+constexpr uint64_t kMaxBlockCount = 1 << 24;
+
+[[nodiscard]] EventTimeRange MakeTimeRangeFromEnd(uint64_t end_timestamp_ns, uint64_t duration_ns) {
+  return {end_timestamp_ns - std::min(end_timestamp_ns, duration_ns), end_timestamp_ns};
+}
+
+[[nodiscard]] EventTimeRange MakeTimeRangeFromTimestamp(uint64_t timestamp_ns) {
+  return {timestamp_ns, timestamp_ns};
+}
+
+}  // namespace
+
+std::optional<EventTimeRange> GetEventTimeRange(const ClientCaptureEvent& event) {
+  switch (event.event_case()) {
+    case ClientCaptureEvent::kApiEvent:
+      return MakeTimeRangeFromTimestamp(event.api_event().timestamp_ns());
+    case ClientCaptureEvent::kApiScopeStart:
+      return MakeTimeRangeFromTimestamp(event.api_scope_start().timestamp_ns());
+    case ClientCaptureEvent::kApiScopeStartAsync:
+      return MakeTimeRangeFromTimestamp(event.api_scope_start_async().timestamp_ns());
+    case ClientCaptureEvent::kApiScopeStop:
+      return MakeTimeRangeFromTimestamp(event.api_scope_stop().timestamp_ns());
+    case ClientCaptureEvent::kApiScopeStopAsync:
+      return MakeTimeRangeFromTimestamp(event.api_scope_stop_async().timestamp_ns());
+    case ClientCaptureEvent::kApiTrackDouble:
+      return MakeTimeRangeFromTimestamp(event.api_track_double().timestamp_ns());
+    case ClientCaptureEvent::kApiTrackFloat:
+      return MakeTimeRangeFromTimestamp(event.api_track_float().timestamp_ns());
+    case ClientCaptureEvent::kApiTrackInt:
+      return MakeTimeRangeFromTimestamp(event.api_track_int().timestamp_ns());
+    case ClientCaptureEvent::kApiTrackInt64:
+      return MakeTimeRangeFromTimestamp(event.api_track_int64().timestamp_ns());
+    case ClientCaptureEvent::kApiTrackUint:
+      return MakeTimeRangeFromTimestamp(event.api_track_uint().timestamp_ns());
+    case ClientCaptureEvent::kApiTrackUint64:
+      return MakeTimeRangeFromTimestamp(event.api_track_uint64().timestamp_ns());
+    case ClientCaptureEvent::kCallstackSample:
+      return MakeTimeRangeFromTimestamp(event.callstack_sample().timestamp_ns());
+    case ClientCaptureEvent::kFunctionCall:
+      return MakeTimeRangeFromEnd(event.function_call().end_timestamp_ns(),
+                                  event.function_call().duration_ns());
+    case ClientCaptureEvent::kGpuJob:
+      return EventTimeRange{event.gpu_job().amdgpu_cs_ioctl_time_ns(),
+                            event.gpu_job().dma_fence_signaled_time_ns()};
+    case ClientCaptureEvent::kGpuQueueSubmission:
+      return EventTimeRange{
+          event.gpu_queue_submission().meta_info().pre_submission_cpu_timestamp(),
+          event.gpu_queue_submission().meta_info().post_submission_cpu_timestamp()};
+    case ClientCaptureEvent::kLostPerfRecordsEvent:
+      return MakeTimeRangeFromEnd(event.lost_perf_records_event().end_timestamp_ns(),
+                                  event.lost_perf_records_event().duration_ns());
+    case ClientCaptureEvent::kMemoryUsageEvent:
+      return MakeTimeRangeFromTimestamp(event.memory_usage_event().timestamp_ns());
+    case ClientCaptureEvent::kOutOfOrderEventsDiscardedEvent:
+      return MakeTimeRangeFromEnd(event.out_of_order_events_discarded_event().end_timestamp_ns(),
+                                  event.out_of_order_events_discarded_event().duration_ns());
+    case ClientCaptureEvent::kPresentEvent:
+      return EventTimeRange{
+          event.present_event().begin_timestamp_ns(),
+          event.present_event().begin_timestamp_ns() + event.present_event().duration_ns()};
+    case ClientCaptureEvent::kSchedulingSlice:
+      return MakeTimeRangeFromEnd(event.scheduling_slice().out_timestamp_ns(),
+                                  event.scheduling_slice().duration_ns());
+    case ClientCaptureEvent::kThreadStateSlice:
+      return MakeTimeRangeFromEnd(event.thread_state_slice().end_timestamp_ns(),
+                                  event.thread_state_slice().duration_ns());
+    case ClientCaptureEvent::kTracepointEvent:
+      return MakeTimeRangeFromTimestamp(event.tracepoint_event().timestamp_ns());
+    case ClientCaptureEvent::kAddressInfo:
+    case ClientCaptureEvent::kApiStringEvent:
+    case ClientCaptureEvent::kCaptureFinished:
+    case ClientCaptureEvent::kCaptureStarted:
+    case ClientCaptureEvent::kClockResolutionEvent:
+    case ClientCaptureEvent::kErrorEnablingOrbitApiEvent:
+    case ClientCaptureEvent::kErrorEnablingUserSpaceInstrumentationEvent:
+    case ClientCaptureEvent::kErrorsWithPerfEventOpenEvent:
+    case ClientCaptureEvent::kInternedCallstack:
+    case ClientCaptureEvent::kInternedString:
+    case ClientCaptureEvent::kInternedTracepointInfo:
+    case ClientCaptureEvent::kModulesSnapshot:
+    case ClientCaptureEvent::kModuleUpdateEvent:
+    case ClientCaptureEvent::kThreadName:
+    case ClientCaptureEvent::kThreadNamesSnapshot:
+    case ClientCaptureEvent::kWarningEvent:
+    case ClientCaptureEvent::kWarningInstrumentingWithUprobesEvent:
+    case ClientCaptureEvent::kWarningInstrumentingWithUserSpaceInstrumentationEvent:
+    case ClientCaptureEvent::EVENT_NOT_SET:
+      return std::nullopt;
+  }
+
+  ORBIT_UNREACHABLE();
+}
+
+void CaptureTimeIndexBuilder::AddEvent(const ClientCaptureEvent& event, uint64_t offset) {
+  if (blocks_.empty() || offset - blocks_.back().offset() >= block_size_) {
+    blocks_.emplace_back().set_offset(offset);
+  }
+  CaptureTimeIndexBlock& block = blocks_.back();
+
+  std::optional<EventTimeRange> time_range = GetEventTimeRange(event);
+  if (!time_range.has_value()) {
+    block.add_state_event_offsets(offset - block.offset());
+    return;
+  }
+
+  const bool has_timeline_events = block.max_timestamp_ns() != 0;
+  block.set_min_timestamp_ns(has_timeline_events ? std::min(block.min_timestamp_ns(),
+                                                            time_range->min_timestamp_ns)
+                                                 : time_range->min_timestamp_ns);
+  block.set_max_timestamp_ns(std::max(block.max_timestamp_ns(), time_range->max_timestamp_ns));
+}
+
+ErrorMessageOr<CaptureSectionSeekPosition> FindCaptureSectionSeekPosition(
+    orbit_capture_file::ProtoSectionInputStream* time_index_stream, uint64_t capture_section_size,
+    uint64_t timestamp_ns) {
+  CaptureTimeIndex time_index;
+  OUTCOME_TRY(time_index_stream->ReadMessage(&time_index));
+  if (time_index.block_count() > kMaxBlockCount) {
+    return ErrorMessage{absl::StrFormat("The time index has too many blocks: %d (must be <= %d)",
+                                        time_index.block_count(), kMaxBlockCount)};
+  }
+
+  CaptureSectionSeekPosition seek_position;
+  seek_position.offset = capture_section_size;
+  uint64_t previous_block_offset = 0;
+  for (uint64_t i = 0; i < time_index.block_count(); ++i) {
+    CaptureTimeIndexBlock block;
+    OUTCOME_TRY(time_index_stream->ReadMessage(&block));
+    if (block.offset() < previous_block_offset || block.offset() >= capture_section_size) {
+      return ErrorMessage{absl::StrFormat("Invalid offset %d of time index block %d",
+                                          block.offset(), i)};
+    }
+    previous_block_offset = block.offset();
+
+    if (block.max_timestamp_ns() >= timestamp_ns) {
+      seek_position.offset = block.offset();
+      return seek_position;
+    }
+
+    for (uint64_t state_event_offset : block.state_event_offsets()) {
+      if (state_event_offset >= capture_section_size - block.offset()) {
+        return ErrorMessage{absl::StrFormat("Invalid state event offset %d in time index block %d",
+                                            state_event_offset, i)};
+      }
+      seek_position.state_event_offsets.push_back(block.offset() + state_event_offset);
+    }
+  }
+
+  return seek_position;
+}
+
+}  // namespace orbit_capture_file_internal
@@ -0,0 +1,68 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CAPTURE_FILE_CAPTURE_TIME_INDEX_H_
+#define CAPTURE_FILE_CAPTURE_TIME_INDEX_H_
+
+#include <stdint.h>
+
+#include <optional>
+#include <vector>
+
+#include "CaptureFile/ProtoSectionInputStream.h"
+#include "ClientProtos/capture_time_index.pb.h"
+#include "GrpcProtos/capture.pb.h"
+#include "OrbitBase/Result.h"
+
+namespace orbit_capture_file_internal {
+
+struct EventTimeRange {
+  uint64_t min_timestamp_ns;
+  uint64_t max_timestamp_ns;
+};
+
+// Returns the time range of timeline events (function calls, samples, scheduling slices, ...), and
+// std::nullopt for all other events, which later events might depend on (interned strings and
+// callstacks, module and thread name updates, ...).
+[[nodiscard]] std::optional<EventTimeRange> GetEventTimeRange(
+    const orbit_grpc_protos::ClientCaptureEvent& event);
+
+// Collects the blocks of the TIME_INDEX section while the capture section is written. A new block
+// is started with the first event written at least `block_size` bytes after the start of the
+// current block.
+class CaptureTimeIndexBuilder {
+ public:
+  explicit CaptureTimeIndexBuilder(uint64_t block_size) : block_size_{block_size} {}
+
+  void AddEvent(const orbit_grpc_protos::ClientCaptureEvent& event, uint64_t offset);
+
+  [[nodiscard]] uint64_t GetBlockSize() const { return block_size_; }
+  [[nodiscard]] const std::vector<orbit_client_protos::CaptureTimeIndexBlock>& GetBlocks() const {
+    return blocks_;
+  }
+
+ private:
+  uint64_t block_size_;
+  std::vector<orbit_client_protos::CaptureTimeIndexBlock> blocks_;
+};
+
+// Where to start reading the capture section in order to get all the timeline events that end at
+// or after a given timestamp.
+struct CaptureSectionSeekPosition {
+  // Offsets, relative to the start of the capture section, of the state events of all the skipped
+  // blocks. They need to be read before continuing at `offset`.
+  std::vector<uint64_t> state_event_offsets;
+  uint64_t offset = 0;
+};
+
+// Reads a TIME_INDEX section and finds the first block that has timeline events ending at or after
+// `timestamp_ns`. If there is no such block, all blocks are skipped and `offset` is
+// `capture_section_size`.
+[[nodiscard]] ErrorMessageOr<CaptureSectionSeekPosition> FindCaptureSectionSeekPosition(
+    orbit_capture_file::ProtoSectionInputStream* time_index_stream, uint64_t capture_section_size,
+    uint64_t timestamp_ns);
+
+}  // namespace orbit_capture_file_internal
+
+#endif  // CAPTURE_FILE_CAPTURE_TIME_INDEX_H_
@@ -0,0 +1,168 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "CompressedCaptureSection.h"
+
+#include <absl/strings/str_format.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <thread>
+
+#include "OrbitBase/Logging.h"
+
+namespace orbit_capture_file_internal {
+
+// Capture sections are mostly small integers that repeat a lot, even the fastest compression level
+// gets most of the size reduction while keeping up with live captures.
+constexpr int kCompressionLevel = Z_BEST_SPEED;
+
+ErrorMessageOr<std::string> CompressCaptureSectionBlock(std::string_view uncompressed_block) {
+  std::string compressed_block(compressBound(uncompressed_block.size()), '\0');
+  uLongf compressed_size = compressed_block.size();
+  const int result =
+      compress2(reinterpret_cast<Bytef*>(compressed_block.data()), &compressed_size,
+                reinterpret_cast<const Bytef*>(uncompressed_block.data()),
+                uncompressed_block.size(), kCompressionLevel);
+  if (result != Z_OK) {
+    return ErrorMessage{absl::StrFormat("Unable to compress capture section block: %s",
+                                        zError(result))};
+  }
+
+  compressed_block.resize(compressed_size);
+  return compressed_block;
+}
+
+ErrorMessageOr<std::string> ReadCaptureSectionBlock(const orbit_base::unique_fd& fd,
+                                                    const CaptureSectionBlock& block) {
+  if (block.uncompressed_size > kMaxCaptureSectionBlockSize ||
+      block.compressed_size > compressBound(block.uncompressed_size)) {
+    return ErrorMessage{absl::StrFormat(
+        "The capture section block at offset %d is too big (compressed size %d, uncompressed size "
+        "%d)",
+        block.offset, block.compressed_size, block.uncompressed_size)};
+  }
+
+  std::string compressed_block(block.compressed_size, '\0');
+  OUTCOME_TRY(auto&& bytes_read, orbit_base::ReadFullyAtOffset(fd, compressed_block.data(),
+                                                               compressed_block.size(),
+                                                               block.offset));
+  if (bytes_read < compressed_block.size()) {
+    return ErrorMessage{absl::StrFormat(
+        "Unexpected EOF while reading the capture section block at offset %d", block.offset)};
+  }
+
+  std::string uncompressed_block(block.uncompressed_size, '\0');
+  uLongf uncompressed_size = uncompressed_block.size();
+  const int result = uncompress(reinterpret_cast<Bytef*>(uncompressed_block.data()),
+                                &uncompressed_size,
+                                reinterpret_cast<const Bytef*>(compressed_block.data()),
+                                compressed_block.size());
+  if (result != Z_OK || uncompressed_size != block.uncompressed_size) {
+    return ErrorMessage{absl::StrFormat(
+        "Unable to decompress the capture section block at offset %d: %s", block.offset,
+        result != Z_OK ? zError(result) : "Unexpected size")};
+  }
+
+  return uncompressed_block;
+}
+
+CompressedCaptureSectionInputStream::CompressedCaptureSectionInputStream(
+    const orbit_base::unique_fd& fd, absl::Span<const CaptureSectionBlock> blocks,
+    uint64_t offset_in_first_block)
+    : fd_{fd},
+      blocks_{blocks.begin(), blocks.end()},
+      offset_in_first_block_{offset_in_first_block} {
+  const size_t thread_count = std::clamp<size_t>(std::thread::hardware_concurrency(), 1,
+                                                 kMaxDecompressionThreadCount);
+  thread_pool_ = orbit_base::ThreadPool::Create(thread_count, thread_count, absl::Seconds(1));
+}
+
+CompressedCaptureSectionInputStream::~CompressedCaptureSectionInputStream() {
+  // The blocks are still referenced by the decompression tasks until those complete.
+  for (const BlockInFlight& block_in_flight : blocks_in_flight_) {
+    block_in_flight.decompressed.Wait();
+  }
+  thread_pool_->ShutdownAndWait();
+}
+
+void CompressedCaptureSectionInputStream::ScheduleDecompressions() {
+  while (next_block_to_schedule_ < blocks_.size() &&
+         blocks_in_flight_.size() < kMaxBlocksInFlight) {
+    auto block = std::make_unique<ErrorMessageOr<std::string>>(outcome::success());
+    orbit_base::Future<void> decompressed = thread_pool_->Schedule(
+        [&fd = fd_, block = block.get(), &block_to_read = blocks_[next_block_to_schedule_]] {
+          *block = ReadCaptureSectionBlock(fd, block_to_read);
+        });
+    blocks_in_flight_.push_back({std::move(block), std::move(decompressed)});
+    ++next_block_to_schedule_;
+  }
+}
+
+bool CompressedCaptureSectionInputStream::LoadNextBlock() {
+  ScheduleDecompressions();
+  if (blocks_in_flight_.empty()) return false;
+
+  BlockInFlight block_in_flight = std::move(blocks_in_flight_.front());
+  blocks_in_flight_.pop_front();
+  ScheduleDecompressions();
+
+  block_in_flight.decompressed.Wait();
+  if (block_in_flight.block->has_error()) {
+    last_error_ = block_in_flight.block->error();
+    return false;
+  }
+
+  current_block_ = std::move(block_in_flight.block->value());
+  position_in_current_block_ = 0;
+  if (offset_in_first_block_.has_value()) {
+    position_in_current_block_ = std::min<uint64_t>(offset_in_first_block_.value(),
+                                                    current_block_.size());
+    offset_in_first_block_.reset();
+  }
+  return true;
+}
+
+bool CompressedCaptureSectionInputStream::Next(const void** data, int* size) {
+  ORBIT_CHECK(data != nullptr);
+  ORBIT_CHECK(size != nullptr);
+
+  if (last_error_.has_value()) return false;
+
+  while (position_in_current_block_ == current_block_.size()) {
+    if (!LoadNextBlock()) return false;
+  }
+
+  *data = current_block_.data() + position_in_current_block_;
+  *size = static_cast<int>(current_block_.size() - position_in_current_block_);
+  byte_count_ += *size;
+  position_in_current_block_ = current_block_.size();
+  return true;
+}
+
+void CompressedCaptureSectionInputStream::BackUp(int count) {
+  ORBIT_CHECK(count >= 0);
+  ORBIT_CHECK(static_cast<size_t>(count) <= position_in_current_block_);
+  position_in_current_block_ -= count;
+  byte_count_ -= count;
+}
+
+bool CompressedCaptureSectionInputStream::Skip(int count) {
+  ORBIT_CHECK(count >= 0);
+
+  uint64_t bytes_to_skip = count;
+  while (bytes_to_skip > 0) {
+    if (last_error_.has_value()) return false;
+    if (position_in_current_block_ == current_block_.size() && !LoadNextBlock()) return false;
+
+    const uint64_t skipped =
+        std::min<uint64_t>(bytes_to_skip, current_block_.size() - position_in_current_block_);
+    position_in_current_block_ += skipped;
+    byte_count_ += skipped;
+    bytes_to_skip -= skipped;
+  }
+  return true;
+}
+
+}  // namespace orbit_capture_file_internal
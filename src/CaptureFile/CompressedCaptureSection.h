@@ -0,0 +1,98 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CAPTURE_FILE_COMPRESSED_CAPTURE_SECTION_H_
+#define CAPTURE_FILE_COMPRESSED_CAPTURE_SECTION_H_
+
+#include <absl/types/span.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "OrbitBase/File.h"
+#include "OrbitBase/Future.h"
+#include "OrbitBase/Result.h"
+#include "OrbitBase/ThreadPool.h"
+#include "ZeroCopyInputStreamWithLastError.h"
+
+namespace orbit_capture_file_internal {
+
+// An entry of the CAPTURE_SECTION_BLOCKS section, see FORMAT.md.
+struct CaptureSectionBlock {
+  // Offset of the compressed block from the start of the file.
+  uint64_t offset;
+  uint64_t compressed_size;
+  uint64_t uncompressed_size;
+};
+
+// The uncompressed size above which the writer starts a new block. Events are never split between
+// blocks, so blocks can be slightly larger.
+constexpr uint64_t kCaptureSectionBlockSize = 1024 * 1024;
+// Blocks come from an untrusted file, limit the memory needed to decompress them.
+constexpr uint64_t kMaxCaptureSectionBlockSize = 64 * 1024 * 1024;
+
+[[nodiscard]] ErrorMessageOr<std::string> CompressCaptureSectionBlock(
+    std::string_view uncompressed_block);
+
+// Reads the block from `fd` and decompresses it.
+[[nodiscard]] ErrorMessageOr<std::string> ReadCaptureSectionBlock(const orbit_base::unique_fd& fd,
+                                                                  const CaptureSectionBlock& block);
+
+// ZeroCopyInputStream over the uncompressed content of a compressed capture section, starting
+// `offset_in_first_block` bytes into the first of `blocks`. The following blocks are read and
+// decompressed in parallel, ahead of the reader.
+class CompressedCaptureSectionInputStream : public ZeroCopyInputStreamWithLastError {
+ public:
+  explicit CompressedCaptureSectionInputStream(const orbit_base::unique_fd& fd,
+                                               absl::Span<const CaptureSectionBlock> blocks,
+                                               uint64_t offset_in_first_block = 0);
+  ~CompressedCaptureSectionInputStream() override;
+
+  CompressedCaptureSectionInputStream(const CompressedCaptureSectionInputStream&) = delete;
+  CompressedCaptureSectionInputStream& operator=(const CompressedCaptureSectionInputStream&) =
+      delete;
+
+  bool Next(const void** data, int* size) override;
+  void BackUp(int count) override;
+  bool Skip(int count) override;
+  [[nodiscard]] int64_t ByteCount() const override { return byte_count_; }
+
+  [[nodiscard]] std::optional<ErrorMessage> GetLastError() const override { return last_error_; }
+
+ private:
+  // Bounds the memory used by blocks that were decompressed but not read yet.
+  static constexpr size_t kMaxBlocksInFlight = 16;
+  static constexpr size_t kMaxDecompressionThreadCount = 8;
+
+  struct BlockInFlight {
+    std::unique_ptr<ErrorMessageOr<std::string>> block;
+    orbit_base::Future<void> decompressed;
+  };
+
+  void ScheduleDecompressions();
+  // Makes the next block the current one, returns false at the end of the section or on error.
+  [[nodiscard]] bool LoadNextBlock();
+
+  const orbit_base::unique_fd& fd_;
+  std::vector<CaptureSectionBlock> blocks_;
+  std::optional<uint64_t> offset_in_first_block_;
+  std::shared_ptr<orbit_base::ThreadPool> thread_pool_;
+  size_t next_block_to_schedule_ = 0;
+  std::deque<BlockInFlight> blocks_in_flight_;
+
+  std::string current_block_;
+  size_t position_in_current_block_ = 0;
+  int64_t byte_count_ = 0;
+  std::optional<ErrorMessage> last_error_;
+};
+
+}  // namespace orbit_capture_file_internal
+
+#endif  // CAPTURE_FILE_COMPRESSED_CAPTURE_SECTION_H_
@@ -0,0 +1,135 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "CompressedCaptureSection.h"
+#include "OrbitBase/File.h"
+#include "OrbitBase/TemporaryFile.h"
+#include "TestUtils/TestUtils.h"
+
+namespace orbit_capture_file_internal {
+
+using orbit_test_utils::HasError;
+using orbit_test_utils::HasNoError;
+using orbit_test_utils::HasValue;
+
+// Compresses each of `uncompressed_blocks` and writes them one after the other to `fd`.
+static std::vector<CaptureSectionBlock> WriteCompressedBlocks(
+    const orbit_base::unique_fd& fd, const std::vector<std::string>& uncompressed_blocks) {
+  std::vector<CaptureSectionBlock> blocks;
+  uint64_t offset = 0;
+  for (const std::string& uncompressed_block : uncompressed_blocks) {
+    ErrorMessageOr<std::string> compressed_block_or_error =
+        CompressCaptureSectionBlock(uncompressed_block);
+    EXPECT_THAT(compressed_block_or_error, HasValue());
+    const std::string& compressed_block = compressed_block_or_error.value();
+    EXPECT_THAT(orbit_base::WriteFully(fd, compressed_block), HasNoError());
+    blocks.push_back(CaptureSectionBlock{/*.offset = */ offset,
+                                         /*.compressed_size = */ compressed_block.size(),
+                                         /*.uncompressed_size = */ uncompressed_block.size()});
+    offset += compressed_block.size();
+  }
+  return blocks;
+}
+
+static std::string_view ToStringView(const void* bytes, int size) {
+  return std::string_view{static_cast<const char*>(bytes), static_cast<size_t>(size)};
+}
+
+TEST(CompressedCaptureSectionInputStream, ReadAcrossBlocks) {
+  auto temporary_file_or_error = orbit_base::TemporaryFile::Create();
+  ASSERT_TRUE(temporary_file_or_error.has_value()) << temporary_file_or_error.error().message();
+  orbit_base::TemporaryFile temporary_file = std::move(temporary_file_or_error.value());
+
+  std::vector<CaptureSectionBlock> blocks = WriteCompressedBlocks(
+      temporary_file.fd(), {"Vestibulum euismod ", "sapien eget ", "urna molestie euismod."});
+
+  CompressedCaptureSectionInputStream input_stream{temporary_file.fd(), blocks};
+  EXPECT_EQ(input_stream.ByteCount(), 0);
+
+  const void* bytes = nullptr;
+  int size = 0;
+  ASSERT_TRUE(input_stream.Next(&bytes, &size));
+  EXPECT_EQ(ToStringView(bytes, size), "Vestibulum euismod ");
+  EXPECT_EQ(input_stream.ByteCount(), 19);
+
+  input_stream.BackUp(8);
+  EXPECT_EQ(input_stream.ByteCount(), 11);
+  ASSERT_TRUE(input_stream.Next(&bytes, &size));
+  EXPECT_EQ(ToStringView(bytes, size), "euismod ");
+
+  // Skip across the second block.
+  ASSERT_TRUE(input_stream.Skip(13));
+  EXPECT_EQ(input_stream.ByteCount(), 32);
+  ASSERT_TRUE(input_stream.Next(&bytes, &size));
+  EXPECT_EQ(ToStringView(bytes, size), "rna molestie euismod.");
+  EXPECT_EQ(input_stream.ByteCount(), 53);
+
+  EXPECT_FALSE(input_stream.Next(&bytes, &size));
+  EXPECT_FALSE(input_stream.Skip(1));
+  EXPECT_FALSE(input_stream.GetLastError().has_value());
+}
+
+TEST(CompressedCaptureSectionInputStream, StartInTheMiddleOfTheFirstBlock) {
+  auto temporary_file_or_error = orbit_base::TemporaryFile::Create();
+  ASSERT_TRUE(temporary_file_or_error.has_value()) << temporary_file_or_error.error().message();
+  orbit_base::TemporaryFile temporary_file = std::move(temporary_file_or_error.value());
+
+  std::vector<CaptureSectionBlock> blocks =
+      WriteCompressedBlocks(temporary_file.fd(), {"Vestibulum euismod ", "sapien eget "});
+
+  CompressedCaptureSectionInputStream input_stream{temporary_file.fd(), blocks, 11};
+
+  const void* bytes = nullptr;
+  int size = 0;
+  ASSERT_TRUE(input_stream.Next(&bytes, &size));
+  EXPECT_EQ(ToStringView(bytes, size), "euismod ");
+  ASSERT_TRUE(input_stream.Next(&bytes, &size));
+  EXPECT_EQ(ToStringView(bytes, size), "sapien eget ");
+  EXPECT_EQ(input_stream.ByteCount(), 20);
+  EXPECT_FALSE(input_stream.Next(&bytes, &size));
+}
+
+TEST(CompressedCaptureSectionInputStream, ReportsCorruptedBlock) {
+  auto temporary_file_or_error = orbit_base::TemporaryFile::Create();
+  ASSERT_TRUE(temporary_file_or_error.has_value()) << temporary_file_or_error.error().message();
+  orbit_base::TemporaryFile temporary_file = std::move(temporary_file_or_error.value());
+
+  std::vector<CaptureSectionBlock> blocks =
+      WriteCompressedBlocks(temporary_file.fd(), {"Vestibulum euismod ", "sapien eget "});
+  // The second block claims to be larger than it actually is.
+  ++blocks[1].uncompressed_size;
+
+  CompressedCaptureSectionInputStream input_stream{temporary_file.fd(), blocks};
+
+  const void* bytes = nullptr;
+  int size = 0;
+  ASSERT_TRUE(input_stream.Next(&bytes, &size));
+  EXPECT_EQ(ToStringView(bytes, size), "Vestibulum euismod ");
+  EXPECT_FALSE(input_stream.Next(&bytes, &size));
+  ASSERT_TRUE(input_stream.GetLastError().has_value());
+  EXPECT_THAT(input_stream.GetLastError()->message(),
+              testing::HasSubstr("Unable to decompress the capture section block"));
+}
+
+TEST(ReadCaptureSectionBlock, RejectsTooLargeBlocks) {
+  auto temporary_file_or_error = orbit_base::TemporaryFile::Create();
+  ASSERT_TRUE(temporary_file_or_error.has_value()) << temporary_file_or_error.error().message();
+  orbit_base::TemporaryFile temporary_file = std::move(temporary_file_or_error.value());
+
+  EXPECT_THAT(ReadCaptureSectionBlock(temporary_file.fd(),
+                                      CaptureSectionBlock{/*.offset = */ 0,
+                                                          /*.compressed_size = */ 16,
+                                                          /*.uncompressed_size = */
+                                                          kMaxCaptureSectionBlockSize + 1}),
+              HasError("is too big"));
+}
+
+}  // namespace orbit_capture_file_internal
@@ -11,6 +11,7 @@
 #include <optional>
 
 #include "OrbitBase/File.h"
+#include "ZeroCopyInputStreamWithLastError.h"
 
 namespace orbit_capture_file_internal {
 
@@ -18,7 +19,7 @@ namespace orbit_capture_file_internal {
 // This class is used to read protos from capture file sections and makes sure
 // we do not overread into other sections of the file.
 // https://developers.google.com/protocol-buffers/docs/reference/cpp/google.protobuf.io.zero_copy_stream
-class FileFragmentInputStream : public google::protobuf::io::ZeroCopyInputStream {
+class FileFragmentInputStream : public ZeroCopyInputStreamWithLastError {
  public:
   explicit FileFragmentInputStream(const orbit_base::unique_fd& fd, uint64_t file_offset,
                                    uint64_t size, size_t block_size = 1 << 16)
@@ -42,7 +43,7 @@ class FileFragmentInputStream : public google::protobuf::io::ZeroCopyInputStream
   bool Skip(int count) override;
   int64_t ByteCount() const override;
 
-  [[nodiscard]] std::optional<ErrorMessage> GetLastError() const { return last_error_; }
+  [[nodiscard]] std::optional<ErrorMessage> GetLastError() const override { return last_error_; }
 
  private:
   const orbit_base::unique_fd& fd_;
@@ -4,31 +4,46 @@
 
 #include "ProtoSectionInputStreamImpl.h"
 
+#include <string>
+
 #include "OrbitBase/Logging.h"
-#include "OrbitBase/MakeUniqueForOverwrite.h"
 
 namespace orbit_capture_file_internal {
 
-constexpr uint64_t kMaximumMessageSize = 1024 * 1024;  // 1Mb
-
 ErrorMessageOr<void> ProtoSectionInputStreamImpl::ReadMessage(google::protobuf::Message* message) {
+  std::string serialized_message;
+  OUTCOME_TRY(ReadSerializedMessage(&serialized_message));
+
+  message->ParseFromString(serialized_message);
+
+  if (message->ByteSizeLong() != serialized_message.size()) {
+    return ErrorMessage{absl::StrFormat(
+        "The message size %d of the parsed message is different from the parsed size %d",
+        message->ByteSizeLong(), serialized_message.size())};
+  }
+
+  return outcome::success();
+}
+
+ErrorMessageOr<void> ProtoSectionInputStreamImpl::ReadSerializedMessage(
+    std::string* serialized_message) {
   // CodedInputStream imposes a hard limit on the total number of bytes it will read. It's INT_MAX
   // by default and it cannot be increased past that. To work around the limitation, reinitialize
-  // the CodedInputStream, as the actual current position is kept by the FileFragmentInputStream
+  // the CodedInputStream, as the actual current position is kept by the underlying input stream
   // instead. Note that this makes CodedInputStream::CurrentPosition not always reflect the actual
   // position in the stream.
   if (coded_input_stream_->CurrentPosition() >= kCodedInputStreamReinitializationThreshold) {
-    coded_input_stream_.emplace(&file_fragment_input_stream_);
+    coded_input_stream_.emplace(input_stream_.get());
     coded_input_stream_->SetTotalBytesLimit(kCodedInputStreamTotalBytesLimit);
   }
 
   uint32_t message_size = 0;
 
   // Note that in case there was an error CodedInputStream does not provide error messages/codes.
-  // We need to go to underlying stream (file_fragment_input_stream_ in this case) to get the error
+  // We need to go to underlying stream (input_stream_ in this case) to get the error
   // message in case of a failure.
   if (!coded_input_stream_->ReadVarint32(&message_size)) {
-    return file_fragment_input_stream_.GetLastError().value_or(
+    return input_stream_->GetLastError().value_or(
         ErrorMessage{"Unexpected end of section while reading message size"});
   }
 
@@ -40,20 +55,11 @@ ErrorMessageOr<void> ProtoSectionInputStreamImpl::ReadMessage(google::protobuf::
                         message_size, kMaximumMessageSize)};
   }
 
-  auto buf = make_unique_for_overwrite<uint8_t[]>(message_size);
-  if (!coded_input_stream_->ReadRaw(buf.get(), message_size)) {
-    return file_fragment_input_stream_.GetLastError().value_or(
+  if (!coded_input_stream_->ReadString(serialized_message, static_cast<int>(message_size))) {
+    return input_stream_->GetLastError().value_or(
         ErrorMessage{"Unexpected end of section while reading the message"});
   }
 
-  message->ParseFromArray(buf.get(), message_size);
-
-  if (message->ByteSizeLong() != message_size) {
-    return ErrorMessage{absl::StrFormat(
-        "The message size %d of the parsed message is different from the parsed size %d",
-        message->ByteSizeLong(), message_size)};
-  }
-
   return outcome::success();
 }
 
@@ -6,34 +6,44 @@
 #define PROTO_SECTION_INPUT_STREAM_IMPL_H_
 
 #include <limits>
+#include <memory>
 #include <optional>
+#include <string>
 
 #include "CaptureFile/ProtoSectionInputStream.h"
 #include "FileFragmentInputStream.h"
 #include "OrbitBase/File.h"
+#include "ZeroCopyInputStreamWithLastError.h"
 
 namespace orbit_capture_file_internal {
 
+constexpr uint64_t kMaximumMessageSize = 1024 * 1024;  // 1Mb
+
 // This class is used to read proto messages from a section of capture file.
 class ProtoSectionInputStreamImpl : public orbit_capture_file::ProtoSectionInputStream {
  public:
   explicit ProtoSectionInputStreamImpl(orbit_base::unique_fd& fd, uint64_t capture_section_offset,
                                        uint64_t capture_section_size)
-      : fd_{fd},
-        file_fragment_input_stream_{fd_, capture_section_offset, capture_section_size},
-        coded_input_stream_{std::in_place, &file_fragment_input_stream_} {
+      : ProtoSectionInputStreamImpl{std::make_unique<FileFragmentInputStream>(
+            fd, capture_section_offset, capture_section_size)} {}
+
+  // Reads the messages from `input_stream`, for example a CompressedCaptureSectionInputStream.
+  explicit ProtoSectionInputStreamImpl(
+      std::unique_ptr<ZeroCopyInputStreamWithLastError> input_stream)
+      : input_stream_{std::move(input_stream)},
+        coded_input_stream_{std::in_place, input_stream_.get()} {
     coded_input_stream_->SetTotalBytesLimit(kCodedInputStreamTotalBytesLimit);
   }
 
   ErrorMessageOr<void> ReadMessage(google::protobuf::Message* message) override;
+  ErrorMessageOr<void> ReadSerializedMessage(std::string* serialized_message) override;
 
  private:
   static constexpr int kCodedInputStreamTotalBytesLimit = std::numeric_limits<int>::max();
   static constexpr int kCodedInputStreamReinitializationThreshold =
       kCodedInputStreamTotalBytesLimit / 2;
 
-  orbit_base::unique_fd& fd_;
-  FileFragmentInputStream file_fragment_input_stream_;
+  std::unique_ptr<ZeroCopyInputStreamWithLastError> input_stream_;
   std::optional<google::protobuf::io::CodedInputStream> coded_input_stream_;
 };
 
@@ -0,0 +1,130 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "SeekingCaptureSectionInputStream.h"
+
+#include <absl/strings/str_format.h>
+#include <google/protobuf/io/coded_stream.h>
+
+#include <algorithm>
+
+namespace orbit_capture_file_internal {
+
+constexpr size_t kMaxVarint32Size = 5;
+
+SeekingCaptureSectionInputStream::SeekingCaptureSectionInputStream(
+    orbit_base::unique_fd& fd, uint64_t capture_section_offset, uint64_t capture_section_size,
+    CaptureSectionSeekPosition seek_position)
+    : fd_{fd},
+      capture_section_offset_{capture_section_offset},
+      capture_section_size_{capture_section_size},
+      state_event_offsets_{std::move(seek_position.state_event_offsets)} {
+  if (seek_position.offset < capture_section_size) {
+    remaining_events_stream_.emplace(fd, capture_section_offset + seek_position.offset,
+                                     capture_section_size - seek_position.offset);
+  }
+}
+
+SeekingCaptureSectionInputStream::SeekingCaptureSectionInputStream(
+    orbit_base::unique_fd& fd, absl::Span<const CaptureSectionBlock> blocks,
+    CaptureSectionSeekPosition seek_position)
+    : fd_{fd},
+      blocks_{blocks.begin(), blocks.end()},
+      state_event_offsets_{std::move(seek_position.state_event_offsets)} {
+  block_offsets_.reserve(blocks_.size());
+  for (const CaptureSectionBlock& block : blocks_) {
+    block_offsets_.push_back(capture_section_size_);
+    capture_section_size_ += block.uncompressed_size;
+  }
+
+  if (seek_position.offset < capture_section_size_) {
+    const size_t first_block_index =
+        std::upper_bound(block_offsets_.begin(), block_offsets_.end(), seek_position.offset) -
+        block_offsets_.begin() - 1;
+    remaining_events_stream_.emplace(std::make_unique<CompressedCaptureSectionInputStream>(
+        fd, absl::MakeConstSpan(blocks_).subspan(first_block_index),
+        seek_position.offset - block_offsets_[first_block_index]));
+  }
+}
+
+ErrorMessageOr<void> SeekingCaptureSectionInputStream::ReadMessage(
+    google::protobuf::Message* message) {
+  std::string serialized_message;
+  OUTCOME_TRY(ReadSerializedMessage(&serialized_message));
+
+  message->ParseFromString(serialized_message);
+
+  if (message->ByteSizeLong() != serialized_message.size()) {
+    return ErrorMessage{absl::StrFormat(
+        "The message size %d of the parsed message is different from the parsed size %d",
+        message->ByteSizeLong(), serialized_message.size())};
+  }
+
+  return outcome::success();
+}
+
+ErrorMessageOr<void> SeekingCaptureSectionInputStream::ReadSerializedMessage(
+    std::string* serialized_message) {
+  if (next_state_event_index_ == state_event_offsets_.size()) {
+    if (!remaining_events_stream_.has_value()) {
+      return ErrorMessage{"Unexpected end of section while reading message size"};
+    }
+    return remaining_events_stream_->ReadSerializedMessage(serialized_message);
+  }
+
+  const uint64_t offset = state_event_offsets_[next_state_event_index_++];
+  OUTCOME_TRY(auto&& message_size_bytes, ReadFromCaptureSection(offset, kMaxVarint32Size));
+  google::protobuf::io::CodedInputStream message_size_stream{
+      reinterpret_cast<const uint8_t*>(message_size_bytes.data()),
+      static_cast<int>(message_size_bytes.size())};
+  uint32_t message_size = 0;
+  if (!message_size_stream.ReadVarint32(&message_size)) {
+    return ErrorMessage{absl::StrFormat(
+        "Unable to read the message size at offset %d of the capture section", offset)};
+  }
+
+  if (message_size > kMaximumMessageSize) {
+    return ErrorMessage{
+        absl::StrFormat("The message size %d is too big (maximum allowed message size is %d)",
+                        message_size, kMaximumMessageSize)};
+  }
+
+  OUTCOME_TRY(auto&& message_bytes,
+              ReadFromCaptureSection(offset + message_size_stream.CurrentPosition(), message_size));
+  if (message_bytes.size() < message_size) {
+    return ErrorMessage{"Unexpected end of section while reading the message"};
+  }
+
+  serialized_message->assign(message_bytes);
+  return outcome::success();
+}
+
+ErrorMessageOr<std::string_view> SeekingCaptureSectionInputStream::ReadFromCaptureSection(
+    uint64_t offset, size_t size) {
+  if (offset >= capture_section_size_) return std::string_view{};
+  size = std::min<uint64_t>(size, capture_section_size_ - offset);
+
+  if (offset < buffer_offset_ || offset + size > buffer_offset_ + buffer_.size()) {
+    if (blocks_.empty()) {
+      buffer_.resize(
+          std::min<uint64_t>(std::max(size, kBufferSize), capture_section_size_ - offset));
+      OUTCOME_TRY(auto&& bytes_read,
+                  orbit_base::ReadFullyAtOffset(fd_, buffer_.data(), buffer_.size(),
+                                                capture_section_offset_ + offset));
+      buffer_.resize(bytes_read);
+      buffer_offset_ = offset;
+    } else {
+      const size_t block_index =
+          std::upper_bound(block_offsets_.begin(), block_offsets_.end(), offset) -
+          block_offsets_.begin() - 1;
+      OUTCOME_TRY(buffer_, ReadCaptureSectionBlock(fd_, blocks_[block_index]));
+      buffer_offset_ = block_offsets_[block_index];
+    }
+  }
+
+  const std::string_view buffered = std::string_view{buffer_}.substr(offset - buffer_offset_);
+  return buffered.substr(0, size);
+}
+
+}  // namespace orbit_capture_file_internal
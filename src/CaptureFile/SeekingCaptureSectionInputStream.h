@@ -0,0 +1,70 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CAPTURE_FILE_SEEKING_CAPTURE_SECTION_INPUT_STREAM_H_
+#define CAPTURE_FILE_SEEKING_CAPTURE_SECTION_INPUT_STREAM_H_
+
+#include <absl/types/span.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "CaptureFile/ProtoSectionInputStream.h"
+#include "CompressedCaptureSection.h"
+#include "CaptureTimeIndex.h"
+#include "OrbitBase/File.h"
+#include "ProtoSectionInputStreamImpl.h"
+
+namespace orbit_capture_file_internal {
+
+// This class is used to read the capture section from a position found in the TIME_INDEX section.
+// It first returns the state events at `seek_position.state_event_offsets`, and then all the events
+// starting at `seek_position.offset`. For compressed capture sections, the offsets refer to the
+// uncompressed content.
+class SeekingCaptureSectionInputStream : public orbit_capture_file::ProtoSectionInputStream {
+ public:
+  // Reads an uncompressed capture section.
+  explicit SeekingCaptureSectionInputStream(orbit_base::unique_fd& fd,
+                                            uint64_t capture_section_offset,
+                                            uint64_t capture_section_size,
+                                            CaptureSectionSeekPosition seek_position);
+  // Reads a compressed capture section made of `blocks`.
+  explicit SeekingCaptureSectionInputStream(orbit_base::unique_fd& fd,
+                                            absl::Span<const CaptureSectionBlock> blocks,
+                                            CaptureSectionSeekPosition seek_position);
+
+  ErrorMessageOr<void> ReadMessage(google::protobuf::Message* message) override;
+  ErrorMessageOr<void> ReadSerializedMessage(std::string* serialized_message) override;
+
+ private:
+  // Returns up to `size` bytes at `offset` in the capture section. State events tend to be close to
+  // each other, so reads go through a buffer instead of reading each event separately. For
+  // compressed capture sections, the buffer holds the decompressed block containing `offset`.
+  [[nodiscard]] ErrorMessageOr<std::string_view> ReadFromCaptureSection(uint64_t offset,
+                                                                        size_t size);
+
+  static constexpr size_t kBufferSize = 64 * 1024;
+
+  orbit_base::unique_fd& fd_;
+  uint64_t capture_section_offset_ = 0;
+  uint64_t capture_section_size_ = 0;
+  // Empty for uncompressed capture sections.
+  std::vector<CaptureSectionBlock> blocks_;
+  // The offsets of the uncompressed blocks in the capture section.
+  std::vector<uint64_t> block_offsets_;
+  std::vector<uint64_t> state_event_offsets_;
+  size_t next_state_event_index_ = 0;
+  std::string buffer_;
+  uint64_t buffer_offset_ = 0;
+  // Not set if all the events of the capture section were skipped.
+  std::optional<ProtoSectionInputStreamImpl> remaining_events_stream_;
+};
+
+}  // namespace orbit_capture_file_internal
+
+#endif  // CAPTURE_FILE_SEEKING_CAPTURE_SECTION_INPUT_STREAM_H_
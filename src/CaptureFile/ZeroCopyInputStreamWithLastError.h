@@ -0,0 +1,25 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CAPTURE_FILE_ZERO_COPY_INPUT_STREAM_WITH_LAST_ERROR_H_
+#define CAPTURE_FILE_ZERO_COPY_INPUT_STREAM_WITH_LAST_ERROR_H_
+
+#include <google/protobuf/io/zero_copy_stream.h>
+
+#include <optional>
+
+#include "OrbitBase/Result.h"
+
+namespace orbit_capture_file_internal {
+
+// ZeroCopyInputStream that keeps the error that made Next() fail, as CodedInputStream does not
+// report errors of the underlying stream.
+class ZeroCopyInputStreamWithLastError : public google::protobuf::io::ZeroCopyInputStream {
+ public:
+  [[nodiscard]] virtual std::optional<ErrorMessage> GetLastError() const = 0;
+};
+
+}  // namespace orbit_capture_file_internal
+
+#endif  // CAPTURE_FILE_ZERO_COPY_INPUT_STREAM_WITH_LAST_ERROR_H_
@@ -65,6 +65,16 @@ class CaptureFile {
 
   virtual std::unique_ptr<ProtoSectionInputStream> CreateCaptureSectionInputStream() = 0;
 
+  // Creates a stream over the capture section that skips, as far as the TIME_INDEX section allows,
+  // the events that end before `timestamp_ns`. The events of the skipped part that later events
+  // depend on (interned strings and callstacks, module and thread name updates, ...) are still
+  // returned first. As the index has a granularity of blocks of events, some events ending before
+  // `timestamp_ns` are returned as well. Also note that events that come in pairs, like the start
+  // and stop of a manual instrumentation scope, might be split. Without a TIME_INDEX section, this
+  // is the same as CreateCaptureSectionInputStream.
+  virtual ErrorMessageOr<std::unique_ptr<ProtoSectionInputStream>>
+  CreateCaptureSectionInputStreamFromTimestamp(uint64_t timestamp_ns) = 0;
+
   static ErrorMessageOr<std::unique_ptr<CaptureFile>> OpenForReadWrite(
       const std::filesystem::path& file_path);
 };
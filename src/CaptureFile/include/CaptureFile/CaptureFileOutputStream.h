@@ -7,8 +7,10 @@
 
 #include <google/protobuf/message.h>
 
+#include <cstdint>
 #include <filesystem>
 #include <memory>
+#include <optional>
 
 #include "CaptureFile/BufferOutputStream.h"
 #include "GrpcProtos/capture.pb.h"
@@ -44,6 +46,20 @@ namespace orbit_capture_file {
 // Note: Write after close or error will result in CHECK failure.
 class CaptureFileOutputStream {
  public:
+  static constexpr uint64_t kDefaultTimeIndexBlockSize = 1024 * 1024;
+
+  struct Options {
+    // If set, a TIME_INDEX section with one block for about every `time_index_block_size` bytes of
+    // the capture section is written when the stream is closed. It allows reading the capture
+    // section starting from a timestamp (see
+    // CaptureFile::CreateCaptureSectionInputStreamFromTimestamp).
+    std::optional<uint64_t> time_index_block_size;
+    // If true, the capture section is written as blocks of events that are compressed
+    // independently, and that can be decompressed in parallel when reading the file. Such files
+    // cannot be opened by versions of Orbit that predate the compressed format.
+    bool compress_capture_section = false;
+  };
+
   virtual ~CaptureFileOutputStream() = default;
   [[nodiscard]] virtual ErrorMessageOr<void> WriteCaptureEvent(
       const orbit_grpc_protos::ClientCaptureEvent& event) = 0;
@@ -55,6 +71,8 @@ class CaptureFileOutputStream {
   // overwritten.
   [[nodiscard]] static ErrorMessageOr<std::unique_ptr<CaptureFileOutputStream>> Create(
       std::filesystem::path path);
+  [[nodiscard]] static ErrorMessageOr<std::unique_ptr<CaptureFileOutputStream>> Create(
+      std::filesystem::path path, const Options& options);
   [[nodiscard]] static std::unique_ptr<CaptureFileOutputStream> Create(
       BufferOutputStream* output_buffer);
 };
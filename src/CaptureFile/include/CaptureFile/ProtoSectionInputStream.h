@@ -7,6 +7,8 @@
 
 #include <google/protobuf/message.h>
 
+#include <string>
+
 #include "OrbitBase/Result.h"
 
 namespace orbit_capture_file {
@@ -25,6 +27,11 @@ class ProtoSectionInputStream {
   // aligned to 8bytes. Reading beyond the CaptureFinished message will incorrectly
   // read padded zeros as empty messages until finally causing an end of section error.
   virtual ErrorMessageOr<void> ReadMessage(google::protobuf::Message* message) = 0;
+
+  // Reads the next message from the stream like ReadMessage, but without parsing it. This allows
+  // parsing messages on other threads. The same restriction about reading past CaptureFinished
+  // applies.
+  virtual ErrorMessageOr<void> ReadSerializedMessage(std::string* serialized_message) = 0;
 };
 
 }  // namespace orbit_capture_file
@@ -22,8 +22,13 @@ void CallstackData::AddCallstackEvent(CallstackEvent callstack_event) {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   ORBIT_CHECK(unique_callstacks_.contains(callstack_event.callstack_id()));
   RegisterTime(callstack_event.timestamp_ns());
-  callstack_events_by_tid_[callstack_event.thread_id()].emplace(callstack_event.timestamp_ns(),
-                                                                callstack_event);
+  EmplaceCallstackEvent(callstack_event);
+}
+
+void CallstackData::EmplaceCallstackEvent(const CallstackEvent& callstack_event) {
+  CallstackEventsOfTid& events_of_tid = callstack_events_by_tid_[callstack_event.thread_id()];
+  absl::MutexLock lock{&events_of_tid.mutex};
+  events_of_tid.events.emplace(callstack_event.timestamp_ns(), callstack_event);
 }
 
 void CallstackData::RegisterTime(uint64_t time) {
@@ -40,7 +45,7 @@ uint32_t CallstackData::GetCallstackEventsCount() const {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   uint32_t count = 0;
   for (const auto& tid_and_events : callstack_events_by_tid_) {
-    count += tid_and_events.second.size();
+    count += tid_and_events.second.events.size();
   }
   return count;
 }
@@ -50,7 +55,7 @@ std::vector<orbit_client_data::CallstackEvent> CallstackData::GetCallstackEvents
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   std::vector<CallstackEvent> callstack_events;
   for (const auto& tid_and_events : callstack_events_by_tid_) {
-    const absl::btree_map<uint64_t, CallstackEvent>& events = tid_and_events.second;
+    const absl::btree_map<uint64_t, CallstackEvent>& events = tid_and_events.second.events;
     for (auto event_it = events.lower_bound(time_begin); event_it != events.end(); ++event_it) {
       uint64_t time = event_it->first;
       if (time < time_end) {
@@ -69,7 +74,7 @@ uint32_t CallstackData::GetCallstackEventsOfTidCount(uint32_t thread_id) const {
   if (tid_and_events_it == callstack_events_by_tid_.end()) {
     return 0;
   }
-  return tid_and_events_it->second.size();
+  return tid_and_events_it->second.events.size();
 }
 
 std::vector<CallstackEvent> CallstackData::GetCallstackEventsOfTidInTimeRange(
@@ -82,7 +87,7 @@ std::vector<CallstackEvent> CallstackData::GetCallstackEventsOfTidInTimeRange(
     return callstack_events;
   }
 
-  const absl::btree_map<uint64_t, CallstackEvent>& events = tid_and_events_it->second;
+  const absl::btree_map<uint64_t, CallstackEvent>& events = tid_and_events_it->second.events;
   for (auto event_it = events.lower_bound(time_begin); event_it != events.end(); ++event_it) {
     uint64_t time = event_it->first;
     if (time < time_end) {
@@ -106,7 +111,7 @@ void CallstackData::AddCallstackFromKnownCallstackData(const CallstackEvent& eve
 
   // The insertion only happens if the hash isn't already present.
   unique_callstacks_.emplace(callstack_id, std::move(unique_callstack));
-  callstack_events_by_tid_[event.thread_id()].emplace(event.timestamp_ns(), event);
+  EmplaceCallstackEvent(event);
 }
 
 const CallstackInfo* CallstackData::GetCallstack(uint64_t callstack_id) const {
@@ -154,12 +159,12 @@ void CallstackData::UpdateCallstackTypeBasedOnMajorityStart(
 
   absl::flat_hash_set<uint64_t> callstack_ids_to_filter;
 
-  for (auto& [tid, timestamps_and_callstack_events] : callstack_events_by_tid_) {
+  for (auto& [tid, events_of_tid] : callstack_events_by_tid_) {
     uint64_t count_for_this_thread = 0;
 
     // Count the number of occurrences of each outer frame for this thread.
     absl::flat_hash_map<uint64_t, uint64_t> count_by_outer_frame;
-    for (const auto& [unused_timestamp_ns, event] : timestamps_and_callstack_events) {
+    for (const auto& [unused_timestamp_ns, event] : events_of_tid.events) {
       const CallstackInfo& callstack = *unique_callstacks_.at(event.callstack_id());
       ORBIT_CHECK(callstack.type() != CallstackType::kFilteredByMajorityOutermostFrame);
       if (callstack.type() != CallstackType::kComplete) {
@@ -205,7 +210,7 @@ void CallstackData::UpdateCallstackTypeBasedOnMajorityStart(
     // doesn't match the (super)majority outer frame.
     // Note that if a CallstackEvent from another thread references a filtered CallstackInfo, that
     // CallstackEvent will also be affected.
-    for (const auto& [unused_timestamp_ns, event] : timestamps_and_callstack_events) {
+    for (const auto& [unused_timestamp_ns, event] : events_of_tid.events) {
       const CallstackInfo& callstack = *unique_callstacks_.at(event.callstack_id());
       ORBIT_CHECK(callstack.type() != CallstackType::kFilteredByMajorityOutermostFrame);
       if (callstack.type() != CallstackType::kComplete) {
@@ -232,8 +237,8 @@ void CallstackData::UpdateCallstackTypeBasedOnMajorityStart(
 
   // Count how many CallstackEvents had their CallstackInfo affected by the type change.
   uint64_t affected_event_count = 0;
-  for (auto& [tid, timestamps_and_callstack_events] : callstack_events_by_tid_) {
-    for (const auto& [unused_timestamp_ns, event] : timestamps_and_callstack_events) {
+  for (auto& [unused_tid, events_of_tid] : callstack_events_by_tid_) {
+    for (const auto& [unused_timestamp_ns, event] : events_of_tid.events) {
       if (unique_callstacks_.at(event.callstack_id())->type() ==
           CallstackType::kFilteredByMajorityOutermostFrame) {
         ++affected_event_count;
@@ -2,18 +2,25 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <absl/synchronization/mutex.h>
+#include <absl/synchronization/notification.h>
+#include <absl/time/time.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 #include <cstdint>
 #include <limits>
+#include <memory>
+#include <thread>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include "ClientData/CallstackData.h"
 #include "ClientData/CallstackEvent.h"
 #include "ClientData/CallstackInfo.h"
 #include "ClientData/CallstackType.h"
+#include "OrbitBase/ThreadPool.h"
 
 using orbit_client_data::CallstackEvent;
 using orbit_client_data::CallstackInfo;
@@ -200,4 +207,58 @@ TEST(CallstackData, FilterCallstackEventsBasedOnMajorityStartExcludesFunctionToS
                                                                          event4, event5, event6}));
 }
 
+TEST(CallstackData, ForEachCallstackEventOfTidsInParallelDoesNotVisitLaterEvents) {
+  CallstackData callstack_data;
+  constexpr uint64_t kCallstackId = 12;
+  callstack_data.AddUniqueCallstack(kCallstackId, CallstackInfo{{0x11, 0x10},
+                                                                CallstackType::kComplete});
+
+  constexpr uint32_t kBlockingTid = 42;
+  constexpr uint32_t kOtherTid = 43;
+  constexpr uint32_t kMissingTid = 44;
+  const CallstackEvent blocking_event1{100, kCallstackId, kBlockingTid};
+  const CallstackEvent blocking_event2{200, kCallstackId, kBlockingTid};
+  const CallstackEvent other_event1{150, kCallstackId, kOtherTid};
+  const CallstackEvent other_event2{250, kCallstackId, kOtherTid};
+  const CallstackEvent other_event3{350, kCallstackId, kOtherTid};
+  const CallstackEvent late_other_event{400, kCallstackId, kOtherTid};
+  for (const CallstackEvent& event :
+       {blocking_event1, blocking_event2, other_event1, other_event2, other_event3}) {
+    callstack_data.AddCallstackEvent(event);
+  }
+
+  // With a single thread in the pool, the task of kOtherTid only starts after the one of
+  // kBlockingTid has finished.
+  std::shared_ptr<orbit_base::ThreadPool> thread_pool =
+      orbit_base::ThreadPool::Create(1, 1, absl::Seconds(1));
+  absl::Notification task_of_blocking_tid_started;
+  absl::Notification late_event_added;
+  const std::vector<std::pair<uint32_t, uint64_t>> tids_and_min_timestamps{
+      {kBlockingTid, 0}, {kOtherTid, 200}, {kMissingTid, 0}};
+  std::vector<std::vector<CallstackEvent>> visited_events(tids_and_min_timestamps.size());
+  std::thread visiting_thread{[&] {
+    callstack_data.ForEachCallstackEventOfTidsInParallel(
+        thread_pool.get(), tids_and_min_timestamps, [&](size_t i, const CallstackEvent& event) {
+          if (i == 0 && !task_of_blocking_tid_started.HasBeenNotified()) {
+            task_of_blocking_tid_started.Notify();
+            late_event_added.WaitForNotification();
+          }
+          visited_events[i].push_back(event);
+        });
+  }};
+
+  task_of_blocking_tid_started.WaitForNotification();
+  // This doesn't wait for the task that is visiting the events of kBlockingTid.
+  callstack_data.AddCallstackEvent(late_other_event);
+  late_event_added.Notify();
+  visiting_thread.join();
+  thread_pool->ShutdownAndWait();
+
+  EXPECT_THAT(visited_events[0], testing::Pointwise(CallstackEventEq(),
+                                                    {blocking_event1, blocking_event2}));
+  EXPECT_THAT(visited_events[1],
+              testing::Pointwise(CallstackEventEq(), {other_event2, other_event3}));
+  EXPECT_TRUE(visited_events[2].empty());
+}
+
 }  // namespace orbit_client_data
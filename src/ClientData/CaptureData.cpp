@@ -17,6 +17,7 @@
 #include "ClientData/ModuleData.h"
 #include "ClientData/ScopeId.h"
 #include "ClientData/ScopeInfo.h"
+#include "ClientData/TimerInfo.h"
 #include "ModuleUtils/VirtualAndAbsoluteAddresses.h"
 #include "OrbitBase/Result.h"
 
@@ -93,6 +94,9 @@ void CaptureData::UpdateScopeStats(const TimerInfo& timer_info) {
   ScopeStats& stats = scope_stats_[scope_id.value()];
   const uint64_t elapsed_nanos = timer_info.end() - timer_info.start();
   stats.UpdateStats(elapsed_nanos);
+
+  absl::MutexLock lock{&duration_sketches_mutex_};
+  scope_id_to_duration_sketch_[scope_id.value()].Add(elapsed_nanos);
 }
 
 void CaptureData::AddScopeStats(ScopeId scope_id, ScopeStats stats) {
@@ -101,7 +105,6 @@ void CaptureData::AddScopeStats(ScopeId scope_id, ScopeStats stats) {
 
 void CaptureData::OnCaptureComplete() {
   thread_track_data_provider_->OnCaptureComplete();
-  UpdateTimerDurations();
 }
 
 void CaptureData::FilterBrokenCallstacks() {
@@ -200,7 +203,7 @@ bool CaptureData::IsFrameTrackEnabled(uint64_t instrumented_function_id) const {
 }
 
 std::optional<ScopeId> CaptureData::ProvideScopeId(
-    const orbit_client_protos::TimerInfo& timer_info) const {
+    const TimerInfo& timer_info) const {
   ORBIT_CHECK(scope_id_provider_);
   return scope_id_provider_->ProvideId(timer_info);
 }
@@ -224,11 +227,12 @@ uint64_t CaptureData::ScopeIdToFunctionId(ScopeId scope_id) const {
   return scope_id_provider_->ScopeIdToFunctionId(scope_id);
 }
 
-const std::vector<uint64_t>* CaptureData::GetSortedTimerDurationsForScopeId(
+std::optional<orbit_statistics::QuantileSketch> CaptureData::GetDurationSketchForScopeId(
     ScopeId scope_id) const {
-  const auto it = scope_id_to_timer_durations_.find(scope_id);
-  if (it == scope_id_to_timer_durations_.end()) return nullptr;
-  return &it->second;
+  absl::MutexLock lock{&duration_sketches_mutex_};
+  const auto it = scope_id_to_duration_sketch_.find(scope_id);
+  if (it == scope_id_to_duration_sketch_.end()) return std::nullopt;
+  return it->second;
 }
 
 [[nodiscard]] std::vector<const TimerInfo*> CaptureData::GetAllScopeTimers(
@@ -252,7 +256,7 @@ const std::vector<uint64_t>* CaptureData::GetSortedTimerDurationsForScopeId(
 
   if (types.contains(ScopeType::kApiScopeAsync)) {
     std::vector<const TimerInfo*> async_timer_infos = timer_data_manager_.GetTimers(
-        orbit_client_protos::TimerInfo::kApiScopeAsync, min_tick, max_tick);
+        TimerInfo::kApiScopeAsync, min_tick, max_tick);
 
     result.insert(std::end(result), std::begin(async_timer_infos), std::end(async_timer_infos));
   }
@@ -260,23 +264,6 @@ const std::vector<uint64_t>* CaptureData::GetSortedTimerDurationsForScopeId(
   return result;
 }
 
-void CaptureData::UpdateTimerDurations() {
-  ORBIT_SCOPE_FUNCTION;
-  scope_id_to_timer_durations_.clear();
-
-  for (const TimerInfo* timer : GetAllScopeTimers(kAllValidScopeTypes)) {
-    const std::optional<ScopeId> scope_id = ProvideScopeId(*timer);
-
-    if (scope_id.has_value()) {
-      scope_id_to_timer_durations_[scope_id.value()].push_back(timer->end() - timer->start());
-    }
-  }
-
-  for (auto& [id, timer_durations] : scope_id_to_timer_durations_) {
-    std::sort(timer_durations.begin(), timer_durations.end());
-  }
-}
-
 [[nodiscard]] std::vector<const TimerInfo*> CaptureData::GetTimersForScope(
     ScopeId scope_id, uint64_t min_tick, uint64_t max_tick) const {
   const std::vector<const TimerInfo*> all_timers =
@@ -24,6 +24,7 @@
 #include "OrbitBase/Logging.h"
 #include "OrbitBase/ReadFileToString.h"
 #include "OrbitBase/ThreadConstants.h"
+#include "Statistics/QuantileSketch.h"
 #include "Test/Path.h"
 
 using testing::Optional;
@@ -87,8 +88,8 @@ static const std::array<uint64_t, kTimerCount> kDurations = [] {
             std::begin(result) + kTimersForFirstId);
   return result;
 }();
-static const std::array<TimerInfo, kTimerCount> kTimerInfos = [] {
-  std::array<TimerInfo, kTimerCount> result;
+static const std::array<orbit_client_protos::TimerInfo, kTimerCount> kTimerInfos = [] {
+  std::array<orbit_client_protos::TimerInfo, kTimerCount> result;
   for (size_t i = 0; i < kTimerCount; ++i) {
     result[i].set_function_id(*kTimerIds[i]);
     result[i].set_start(kStarts[i]);
@@ -116,8 +117,8 @@ template <std::size_t Size>
   return stats;
 }
 
-const TimerInfo kTimerInfoWithInvalidScopeId = []() {
-  TimerInfo timer;
+const orbit_client_protos::TimerInfo kTimerInfoWithInvalidScopeId = []() {
+  orbit_client_protos::TimerInfo timer;
   timer.set_start(0);
   timer.set_end(std::numeric_limits<uint64_t>::max());
   timer.set_function_id(0);
@@ -160,7 +161,7 @@ class CaptureDataTest : public testing::Test {
 }  // namespace
 
 TEST_F(CaptureDataTest, UpdateScopeStatsIsCorrect) {
-  for (const TimerInfo& timer : kTimerInfos) {
+  for (const orbit_client_protos::TimerInfo& timer : kTimerInfos) {
     capture_data_.UpdateScopeStats(timer);
   }
   capture_data_.UpdateScopeStats(kTimerInfoWithInvalidScopeId);
@@ -172,7 +173,7 @@ TEST_F(CaptureDataTest, UpdateScopeStatsIsCorrect) {
 }
 
 TEST_F(CaptureDataTest, VarianceIsCorrectForLongDurations) {
-  for (TimerInfo timer : kTimerInfos) {
+  for (orbit_client_protos::TimerInfo timer : kTimerInfos) {
     timer.set_end(timer.end() + kLargeInteger);
     capture_data_.UpdateScopeStats(timer);
   }
@@ -196,11 +197,11 @@ const auto [kScimitarVariance, kScimitarTimers] = [] {
   double expected_variance;
   EXPECT_TRUE(absl::SimpleAtod(*tokens.begin(), &expected_variance));
 
-  std::vector<TimerInfo> timers;
+  std::vector<orbit_client_protos::TimerInfo> timers;
   std::transform(std::begin(tokens) + 1, std::end(tokens) - 1, std::back_inserter(timers),
                  [](const std::string_view line) {
                    const uint64_t duration = std::stoull(std::string(line));
-                   TimerInfo timer;
+                   orbit_client_protos::TimerInfo timer;
                    timer.set_function_id(*kFirstId);
                    timer.set_start(0);
                    timer.set_end(duration);
@@ -210,7 +211,7 @@ const auto [kScimitarVariance, kScimitarTimers] = [] {
 }();
 
 TEST_F(CaptureDataTest, VarianceIsCorrectOnScimitarDataset) {
-  for (const TimerInfo& timer : kScimitarTimers) {
+  for (const orbit_client_protos::TimerInfo& timer : kScimitarTimers) {
     capture_data_.UpdateScopeStats(timer);
   }
 
@@ -223,7 +224,7 @@ constexpr size_t kNumberOfTimesWeRepeatScimitarDataset = 100;
 // Here we simulate a dataset of 20'891'600 acquired in the course of 36 minutes
 TEST_F(CaptureDataTest, VarianceIsCorrectOnRepeatedScimitarDataset) {
   for (size_t i = 0; i < kNumberOfTimesWeRepeatScimitarDataset; ++i) {
-    for (const TimerInfo& timer : kScimitarTimers) {
+    for (const orbit_client_protos::TimerInfo& timer : kScimitarTimers) {
       capture_data_.UpdateScopeStats(timer);
     }
   }
@@ -232,24 +233,24 @@ TEST_F(CaptureDataTest, VarianceIsCorrectOnRepeatedScimitarDataset) {
   EXPECT_LE(abs(actual_variance / kScimitarVariance - 1.0), 1e-5);
 }
 
-TEST_F(CaptureDataTest, UpdateTimerDurationsIsCorrect) {
-  for (const TimerInfo& timer : kTimerInfos) {
-    capture_data_.GetThreadTrackDataProvider()->AddTimer(timer);
+TEST_F(CaptureDataTest, UpdateScopeStatsUpdatesDurationSketches) {
+  for (const orbit_client_protos::TimerInfo& timer : kTimerInfos) {
+    capture_data_.UpdateScopeStats(timer);
   }
 
-  capture_data_.OnCaptureComplete();
-
-  const std::vector<uint64_t>* durations_first =
-      capture_data_.GetSortedTimerDurationsForScopeId(kFirstId);
-  EXPECT_EQ(*durations_first, std::vector(std::begin(kSortedDurationsForFirstId),
-                                          std::end(kSortedDurationsForFirstId)));
+  const std::optional<orbit_statistics::QuantileSketch> durations_first =
+      capture_data_.GetDurationSketchForScopeId(kFirstId);
+  ASSERT_TRUE(durations_first.has_value());
+  EXPECT_THAT(durations_first->GetExactValues(),
+              testing::ElementsAreArray(kSortedDurationsForFirstId));
 
-  const std::vector<uint64_t>* durations_second =
-      capture_data_.GetSortedTimerDurationsForScopeId(kSecondId);
-  EXPECT_EQ(*durations_second, std::vector(std::begin(kSortedDurationsForSecondId),
-                                           std::end(kSortedDurationsForSecondId)));
+  const std::optional<orbit_statistics::QuantileSketch> durations_second =
+      capture_data_.GetDurationSketchForScopeId(kSecondId);
+  ASSERT_TRUE(durations_second.has_value());
+  EXPECT_THAT(durations_second->GetExactValues(),
+              testing::ElementsAreArray(kSortedDurationsForSecondId));
 
-  EXPECT_THAT(capture_data_.GetSortedTimerDurationsForScopeId(kNotIssuedId), testing::IsNull());
+  EXPECT_FALSE(capture_data_.GetDurationSketchForScopeId(kNotIssuedId).has_value());
 }
 
 TEST_F(CaptureDataTest, FindThreadStateSliceInfoFromTimestamp) {
@@ -8,6 +8,7 @@
 
 #include <utility>
 
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "OrbitBase/Logging.h"
 #include "OrbitBase/ThreadUtils.h"
@@ -37,38 +38,45 @@ void DataManager::ClearSelectedFunctions() {
 void DataManager::set_visible_scope_ids(absl::flat_hash_set<ScopeId> visible_scope_ids) {
   ORBIT_CHECK(std::this_thread::get_id() == main_thread_id_);
   visible_scope_ids_ = std::move(visible_scope_ids);
+  ++selection_generation_;
 }
 
 void DataManager::set_highlighted_scope_id(std::optional<ScopeId> highlighted_scope_id) {
   ORBIT_CHECK(std::this_thread::get_id() == main_thread_id_);
   highlighted_scope_id_ = highlighted_scope_id;
+  ++selection_generation_;
 }
 
 void DataManager::set_highlighted_group_id(uint64_t highlighted_group_id) {
   ORBIT_CHECK(std::this_thread::get_id() == main_thread_id_);
   highlighted_group_id_ = highlighted_group_id;
+  ++selection_generation_;
 }
 
 void DataManager::set_selected_thread_id(uint32_t thread_id) {
   ORBIT_CHECK(std::this_thread::get_id() == main_thread_id_);
   selected_thread_id_ = thread_id;
+  ++selection_generation_;
 }
 
 void DataManager::set_selected_thread_state_slice(
     std::optional<ThreadStateSliceInfo> selected_thread_state_slice) {
   ORBIT_CHECK(std::this_thread::get_id() == main_thread_id_);
   selected_thread_state_slice_ = selected_thread_state_slice;
+  ++selection_generation_;
 }
 
 void DataManager::set_hovered_thread_state_slice(
     std::optional<ThreadStateSliceInfo> hovered_thread_state_slice) {
   ORBIT_CHECK(std::this_thread::get_id() == main_thread_id_);
   hovered_thread_state_slice_ = hovered_thread_state_slice;
+  ++selection_generation_;
 }
 
-void DataManager::set_selected_timer(const orbit_client_protos::TimerInfo* timer_info) {
+void DataManager::set_selected_timer(const TimerInfo* timer_info) {
   ORBIT_CHECK(std::this_thread::get_id() == main_thread_id_);
   selected_timer_ = timer_info;
+  ++selection_generation_;
 }
 
 bool DataManager::IsFunctionSelected(const FunctionInfo& function) const {
@@ -111,11 +119,16 @@ std::optional<ThreadStateSliceInfo> DataManager::hovered_thread_state_slice() co
   return hovered_thread_state_slice_;
 }
 
-const orbit_client_protos::TimerInfo* DataManager::selected_timer() const {
+const TimerInfo* DataManager::selected_timer() const {
   ORBIT_CHECK(std::this_thread::get_id() == main_thread_id_);
   return selected_timer_;
 }
 
+uint64_t DataManager::selection_generation() const {
+  ORBIT_CHECK(std::this_thread::get_id() == main_thread_id_);
+  return selection_generation_;
+}
+
 void DataManager::SelectTracepoint(const TracepointInfo& info) {
   ORBIT_CHECK(std::this_thread::get_id() == main_thread_id_);
   if (!IsTracepointSelected(info)) {
@@ -40,6 +40,7 @@ TEST(DataManager, CanOnlyBeUsedFromTheMainThread) {
       data_manager, &DataManager::set_hovered_thread_state_slice, std::nullopt);
   CallMethodOnDifferentThreadAndExpectDeath(data_manager, &DataManager::set_selected_timer,
                                             nullptr);
+  CallMethodOnDifferentThreadAndExpectDeath(data_manager, &DataManager::selection_generation);
   CallMethodOnDifferentThreadAndExpectDeath(data_manager, &DataManager::SelectTracepoint,
                                             orbit_grpc_protos::TracepointInfo{});
   CallMethodOnDifferentThreadAndExpectDeath(data_manager, &DataManager::DeselectTracepoint,
@@ -104,4 +105,31 @@ TEST(DataManager, CanOnlyBeUsedFromTheMainThread) {
                                             &DataManager::wine_syscall_handling_method);
 }
 
+TEST(DataManager, SelectionGenerationChangesWithSelection) {
+  DataManager data_manager;
+  uint64_t generation = data_manager.selection_generation();
+  auto expect_generation_changed = [&]() {
+    EXPECT_NE(data_manager.selection_generation(), generation);
+    generation = data_manager.selection_generation();
+  };
+
+  data_manager.set_visible_scope_ids({ScopeId(1)});
+  expect_generation_changed();
+  data_manager.set_highlighted_scope_id(ScopeId(1));
+  expect_generation_changed();
+  data_manager.set_highlighted_group_id(1);
+  expect_generation_changed();
+  data_manager.set_selected_thread_id(1);
+  expect_generation_changed();
+  data_manager.set_selected_thread_state_slice(std::nullopt);
+  expect_generation_changed();
+  data_manager.set_hovered_thread_state_slice(std::nullopt);
+  expect_generation_changed();
+  data_manager.set_selected_timer(nullptr);
+  expect_generation_changed();
+
+  data_manager.set_collect_thread_states(true);
+  EXPECT_EQ(data_manager.selection_generation(), generation);
+}
+
 }  // namespace orbit_client_data
@@ -16,6 +16,7 @@
 
 #include "ClientData/ScopeId.h"
 #include "ClientData/ScopeInfo.h"
+#include "ClientData/TimerInfo.h"
 #include "GrpcProtos/Constants.h"
 #include "OrbitBase/Logging.h"
 
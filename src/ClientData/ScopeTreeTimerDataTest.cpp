@@ -6,8 +6,6 @@
 
 #include "ClientData/ScopeTreeTimerData.h"
 
-using orbit_client_protos::TimerInfo;
-
 namespace orbit_client_data {
 
 namespace {
@@ -32,7 +30,7 @@ static constexpr uint64_t kMaxTimestamp = 11;
 
 TimersInTest AddTimersInScopeTreeTimerDataTest(ScopeTreeTimerData& scope_tree_timer_data) {
   TimersInTest inserted_timers;
-  TimerInfo timer_info;
+  orbit_client_protos::TimerInfo timer_info;
   timer_info.set_process_id(kProcessId);
 
   // left
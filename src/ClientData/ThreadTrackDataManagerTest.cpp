@@ -8,8 +8,6 @@
 
 namespace orbit_client_data {
 
-using orbit_client_protos::TimerInfo;
-
 constexpr uint32_t kThreadId1 = 1;
 constexpr uint32_t kThreadId2 = 2;
 constexpr uint32_t kNotUsedThreadId = 3;
@@ -33,7 +31,7 @@ TEST(ThreadTrackDataManager, AddTimer) {
   ThreadTrackDataManager thread_track_data_manager;
 
   // Add 2 timers for kThreadId1 and 1 timer for kThreadId2
-  TimerInfo timer_info;
+  orbit_client_protos::TimerInfo timer_info;
   timer_info.set_thread_id(kThreadId1);
   thread_track_data_manager.CreateScopeTreeTimerData(kThreadId1);
   thread_track_data_manager.AddTimer(timer_info);
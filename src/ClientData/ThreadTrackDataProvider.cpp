@@ -6,9 +6,9 @@
 
 #include <cstdint>
 
-namespace orbit_client_data {
+#include "ClientData/TimerInfo.h"
 
-using orbit_client_protos::TimerInfo;
+namespace orbit_client_data {
 
 std::vector<uint32_t> ThreadTrackDataProvider::GetAllThreadIds() const {
   std::vector<uint32_t> all_thread_id;
@@ -15,7 +15,6 @@
 
 namespace orbit_client_data {
 
-using orbit_client_protos::TimerInfo;
 using ::testing::UnorderedElementsAre;
 
 namespace {
@@ -76,7 +75,7 @@ TEST(ThreadTrackDataProvider, InsertAndGetTimer) {
   const uint64_t kTimerEnd = 5;
   ThreadTrackDataProvider thread_track_data_provider;
 
-  TimerInfo timer_info;
+  orbit_client_protos::TimerInfo timer_info;
   timer_info.set_thread_id(kThreadId1);
   timer_info.set_start(kTimerStart);
   timer_info.set_end(kTimerEnd);
@@ -87,7 +86,7 @@ TEST(ThreadTrackDataProvider, InsertAndGetTimer) {
   std::vector<const TimerInfo*> all_timers = thread_track_data_provider.GetTimers(kThreadId1);
   EXPECT_EQ(all_timers.size(), 1);
 
-  const orbit_client_protos::TimerInfo* inserted_timer_info = all_timers[0];
+  const TimerInfo* inserted_timer_info = all_timers[0];
   EXPECT_EQ(inserted_timer_info->thread_id(), kThreadId1);
   EXPECT_EQ(inserted_timer_info->start(), kTimerStart);
   EXPECT_EQ(inserted_timer_info->end(), kTimerEnd);
@@ -99,7 +98,7 @@ TEST(ThreadTrackDataProvider, OnCaptureComplete) {
   // ScopeTree: Need OnCaptureComplete to process the data when loading a capture.
   ThreadTrackDataProvider thread_track_data_provider(true);
 
-  TimerInfo timer_info;
+  orbit_client_protos::TimerInfo timer_info;
   timer_info.set_thread_id(kThreadId1);
   timer_info.set_start(kTimerStart);
   timer_info.set_end(kTimerEnd);
@@ -111,7 +110,7 @@ TEST(ThreadTrackDataProvider, OnCaptureComplete) {
 
   std::vector<const TimerInfo*> all_timers = thread_track_data_provider.GetTimers(kThreadId1);
   EXPECT_EQ(all_timers.size(), 1);
-  const orbit_client_protos::TimerInfo* inserted_timer_info = all_timers[0];
+  const TimerInfo* inserted_timer_info = all_timers[0];
   EXPECT_EQ(inserted_timer_info->thread_id(), 1);
   EXPECT_EQ(inserted_timer_info->start(), kTimerStart);
   EXPECT_EQ(inserted_timer_info->end(), kTimerEnd);
@@ -120,7 +119,7 @@ TEST(ThreadTrackDataProvider, OnCaptureComplete) {
 // Insert 4 timers with the same thread_id and an extra with a different one.
 TimersInTest InsertTimersForTesting(ThreadTrackDataProvider& thread_track_data_provider) {
   TimersInTest inserted_timers_ptr;
-  TimerInfo timer_info;
+  orbit_client_protos::TimerInfo timer_info;
 
   // left
   timer_info.set_process_id(kProcessId);
@@ -6,10 +6,9 @@
 
 #include <algorithm>
 
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 
-using orbit_client_protos::TimerInfo;
-
 namespace orbit_client_data {
 
 bool TimerBlock::Intersects(uint64_t min, uint64_t max) const {
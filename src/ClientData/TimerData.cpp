@@ -4,10 +4,9 @@
 
 #include <ClientData/TimerData.h>
 
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 
-using orbit_client_protos::TimerInfo;
-
 namespace orbit_client_data {
 
 const TimerInfo& TimerData::AddTimer(TimerInfo timer_info, uint32_t depth) {
@@ -51,7 +50,7 @@ const TimerInfo* TimerData::GetFirstAfterStartTime(uint64_t time, uint32_t depth
   // TODO(b/201044462): do better than linear search...
   for (const auto& it : *chain) {
     for (size_t k = 0; k < it.size(); ++k) {
-      const orbit_client_protos::TimerInfo& timer_info = it[k];
+      const TimerInfo& timer_info = it[k];
       if (timer_info.start() > time) {
         return &timer_info;
       }
@@ -64,12 +63,12 @@ const TimerInfo* TimerData::GetFirstBeforeStartTime(uint64_t time, uint32_t dept
   const orbit_client_data::TimerChain* chain = GetChain(depth);
   if (chain == nullptr) return nullptr;
 
-  const orbit_client_protos::TimerInfo* first_timer_before_time = nullptr;
+  const TimerInfo* first_timer_before_time = nullptr;
 
   // TODO(b/201044462): do better than linear search...
   for (const auto& it : *chain) {
     for (size_t k = 0; k < it.size(); ++k) {
-      const orbit_client_protos::TimerInfo* timer_info = &it[k];
+      const TimerInfo* timer_info = &it[k];
       if (timer_info->start() >= time) {
         return first_timer_before_time;
       }
@@ -99,7 +98,9 @@ TimerChain* TimerData::GetOrCreateTimerChain(uint64_t depth) {
     return it->second.get();
   }
 
-  auto [inserted_it, inserted] = timers_.insert_or_assign(depth, std::make_unique<TimerChain>());
+  auto [inserted_it, inserted] = timers_.insert_or_assign(
+      depth, std::make_unique<TimerChain>(/*keep_timer_pyramid=*/timer_pyramid_update_type_ ==
+                                          TimerPyramidUpdateType::kAlways));
   ORBIT_CHECK(inserted);
   return inserted_it->second.get();
 }
@@ -8,8 +8,6 @@
 
 namespace orbit_client_data {
 
-using orbit_client_protos::TimerInfo;
-
 TEST(TimerData, IsEmpty) {
   TimerData timer_data;
   EXPECT_TRUE(timer_data.GetChains().empty());
@@ -23,7 +21,7 @@ TEST(TimerData, IsEmpty) {
 
 TEST(TimerData, AddTimers) {
   TimerData timer_data;
-  TimerInfo timer_info;
+  orbit_client_protos::TimerInfo timer_info;
   timer_info.set_start(2);
   timer_info.set_end(5);
 
@@ -73,7 +71,7 @@ TEST(TimerData, FindTimers) {
   TimerData timer_data;
 
   {
-    TimerInfo timer_info;
+    orbit_client_protos::TimerInfo timer_info;
     timer_info.set_start(2);
     timer_info.set_end(5);
     timer_data.AddTimer(timer_info, 0);
@@ -0,0 +1,111 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ClientData/TimerInfo.h"
+
+namespace orbit_client_data {
+
+TimerInfo::TimerInfo(const orbit_client_protos::TimerInfo& timer_info)
+    : start_{timer_info.start()},
+      end_{timer_info.end()},
+      function_id_{timer_info.function_id()},
+      user_data_key_{timer_info.user_data_key()},
+      process_id_{timer_info.process_id()},
+      thread_id_{timer_info.thread_id()},
+      depth_{timer_info.depth()},
+      processor_{timer_info.processor()},
+      type_{static_cast<uint8_t>(timer_info.type())} {
+  if (timer_info.callstack_id() == 0 && timer_info.timeline_hash() == 0 &&
+      timer_info.group_id() == 0 && timer_info.api_async_scope_id() == 0 &&
+      timer_info.address_in_function() == 0 && timer_info.registers_size() == 0 &&
+      !timer_info.has_color() && timer_info.api_scope_name().empty()) {
+    return;
+  }
+
+  rare_fields_ = std::make_unique<RareFields>();
+  rare_fields_->callstack_id = timer_info.callstack_id();
+  rare_fields_->timeline_hash = timer_info.timeline_hash();
+  rare_fields_->group_id = timer_info.group_id();
+  rare_fields_->api_async_scope_id = timer_info.api_async_scope_id();
+  rare_fields_->address_in_function = timer_info.address_in_function();
+  rare_fields_->registers.assign(timer_info.registers().begin(), timer_info.registers().end());
+  if (timer_info.has_color()) {
+    rare_fields_->color = timer_info.color();
+  }
+  rare_fields_->api_scope_name = timer_info.api_scope_name();
+}
+
+TimerInfo::TimerInfo(const TimerInfo& other)
+    : start_{other.start_},
+      end_{other.end_},
+      function_id_{other.function_id_},
+      user_data_key_{other.user_data_key_},
+      process_id_{other.process_id_},
+      thread_id_{other.thread_id_},
+      depth_{other.depth_},
+      processor_{other.processor_},
+      rare_fields_{other.rare_fields_ != nullptr ? std::make_unique<RareFields>(*other.rare_fields_)
+                                                 : nullptr},
+      type_{other.type_} {}
+
+TimerInfo& TimerInfo::operator=(const TimerInfo& other) {
+  if (this != &other) {
+    *this = TimerInfo{other};
+  }
+  return *this;
+}
+
+orbit_client_protos::TimerInfo TimerInfo::ToProto() const {
+  orbit_client_protos::TimerInfo timer_info;
+  timer_info.set_start(start_);
+  timer_info.set_end(end_);
+  timer_info.set_process_id(process_id_);
+  timer_info.set_thread_id(thread_id_);
+  timer_info.set_depth(depth_);
+  timer_info.set_type(type());
+  timer_info.set_processor(processor_);
+  timer_info.set_function_id(function_id_);
+  timer_info.set_user_data_key(user_data_key_);
+  if (rare_fields_ == nullptr) return timer_info;
+
+  timer_info.set_callstack_id(rare_fields_->callstack_id);
+  timer_info.set_timeline_hash(rare_fields_->timeline_hash);
+  *timer_info.mutable_registers() = {rare_fields_->registers.begin(),
+                                     rare_fields_->registers.end()};
+  if (rare_fields_->color.has_value()) {
+    *timer_info.mutable_color() = rare_fields_->color.value();
+  }
+  timer_info.set_group_id(rare_fields_->group_id);
+  timer_info.set_api_async_scope_id(rare_fields_->api_async_scope_id);
+  timer_info.set_address_in_function(rare_fields_->address_in_function);
+  timer_info.set_api_scope_name(rare_fields_->api_scope_name);
+  return timer_info;
+}
+
+const std::vector<uint64_t>& TimerInfo::registers() const {
+  static const std::vector<uint64_t> kNoRegisters;
+  return rare_fields_ != nullptr ? rare_fields_->registers : kNoRegisters;
+}
+
+const orbit_client_protos::Color& TimerInfo::color() const {
+  return has_color() ? rare_fields_->color.value()
+                     : orbit_client_protos::Color::default_instance();
+}
+
+const std::string& TimerInfo::api_scope_name() const {
+  static const std::string kNoApiScopeName;
+  return rare_fields_ != nullptr ? rare_fields_->api_scope_name : kNoApiScopeName;
+}
+
+size_t TimerInfo::GetMemoryUsageBytes() const {
+  size_t memory_usage_bytes = sizeof(TimerInfo);
+  if (rare_fields_ != nullptr) {
+    memory_usage_bytes += sizeof(RareFields) +
+                          rare_fields_->registers.capacity() * sizeof(uint64_t) +
+                          rare_fields_->api_scope_name.capacity();
+  }
+  return memory_usage_bytes;
+}
+
+}  // namespace orbit_client_data
@@ -0,0 +1,120 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <google/protobuf/util/message_differencer.h>
+#include <gtest/gtest.h>
+
+#include "ClientData/TimerInfo.h"
+#include "ClientProtos/capture_data.pb.h"
+#include "OrbitBase/Logging.h"
+
+namespace orbit_client_data {
+
+namespace {
+
+orbit_client_protos::TimerInfo MakeFunctionCallTimerProto() {
+  orbit_client_protos::TimerInfo timer_info;
+  timer_info.set_start(100);
+  timer_info.set_end(200);
+  timer_info.set_process_id(42);
+  timer_info.set_thread_id(43);
+  timer_info.set_depth(3);
+  timer_info.set_type(orbit_client_protos::TimerInfo::kNone);
+  timer_info.set_processor(-1);
+  timer_info.set_function_id(7);
+  timer_info.set_user_data_key(8);
+  return timer_info;
+}
+
+}  // namespace
+
+TEST(TimerInfo, DefaultConstructed) {
+  TimerInfo timer_info;
+  EXPECT_EQ(timer_info.start(), 0);
+  EXPECT_EQ(timer_info.end(), 0);
+  EXPECT_EQ(timer_info.type(), TimerInfo::kNone);
+  EXPECT_EQ(timer_info.registers_size(), 0);
+  EXPECT_FALSE(timer_info.has_color());
+  EXPECT_TRUE(timer_info.api_scope_name().empty());
+  EXPECT_EQ(timer_info.GetMemoryUsageBytes(), sizeof(TimerInfo));
+}
+
+TEST(TimerInfo, FunctionCallHasNoSeparateAllocation) {
+  const orbit_client_protos::TimerInfo timer_info_proto = MakeFunctionCallTimerProto();
+  const TimerInfo timer_info{timer_info_proto};
+
+  EXPECT_EQ(timer_info.start(), 100);
+  EXPECT_EQ(timer_info.end(), 200);
+  EXPECT_EQ(timer_info.process_id(), 42);
+  EXPECT_EQ(timer_info.thread_id(), 43);
+  EXPECT_EQ(timer_info.depth(), 3);
+  EXPECT_EQ(timer_info.type(), TimerInfo::kNone);
+  EXPECT_EQ(timer_info.processor(), -1);
+  EXPECT_EQ(timer_info.function_id(), 7);
+  EXPECT_EQ(timer_info.user_data_key(), 8);
+  EXPECT_EQ(timer_info.callstack_id(), 0);
+  EXPECT_EQ(timer_info.GetMemoryUsageBytes(), sizeof(TimerInfo));
+
+  EXPECT_TRUE(google::protobuf::util::MessageDifferencer::Equals(timer_info.ToProto(),
+                                                                 timer_info_proto));
+}
+
+TEST(TimerInfo, ApiScopeRoundTrip) {
+  orbit_client_protos::TimerInfo timer_info_proto = MakeFunctionCallTimerProto();
+  timer_info_proto.set_type(orbit_client_protos::TimerInfo::kApiScope);
+  timer_info_proto.set_callstack_id(11);
+  timer_info_proto.set_timeline_hash(12);
+  timer_info_proto.set_group_id(13);
+  timer_info_proto.set_api_async_scope_id(14);
+  timer_info_proto.set_address_in_function(15);
+  timer_info_proto.add_registers(16);
+  timer_info_proto.add_registers(17);
+  timer_info_proto.mutable_color()->set_red(1);
+  timer_info_proto.mutable_color()->set_alpha(255);
+  timer_info_proto.set_api_scope_name("scope");
+
+  const TimerInfo timer_info{timer_info_proto};
+  EXPECT_EQ(timer_info.type(), TimerInfo::kApiScope);
+  EXPECT_EQ(timer_info.callstack_id(), 11);
+  EXPECT_EQ(timer_info.timeline_hash(), 12);
+  EXPECT_EQ(timer_info.group_id(), 13);
+  EXPECT_EQ(timer_info.api_async_scope_id(), 14);
+  EXPECT_EQ(timer_info.address_in_function(), 15);
+  ASSERT_EQ(timer_info.registers_size(), 2);
+  EXPECT_EQ(timer_info.registers(1), 17);
+  ASSERT_TRUE(timer_info.has_color());
+  EXPECT_EQ(timer_info.color().red(), 1);
+  EXPECT_EQ(timer_info.color().alpha(), 255);
+  EXPECT_EQ(timer_info.api_scope_name(), "scope");
+  EXPECT_GT(timer_info.GetMemoryUsageBytes(), sizeof(TimerInfo));
+
+  EXPECT_TRUE(google::protobuf::util::MessageDifferencer::Equals(timer_info.ToProto(),
+                                                                 timer_info_proto));
+}
+
+TEST(TimerInfo, CopyIsDeep) {
+  orbit_client_protos::TimerInfo timer_info_proto = MakeFunctionCallTimerProto();
+  timer_info_proto.set_api_scope_name("scope");
+  TimerInfo timer_info{timer_info_proto};
+
+  TimerInfo copy{timer_info};
+  timer_info = TimerInfo{MakeFunctionCallTimerProto()};
+  EXPECT_EQ(copy.api_scope_name(), "scope");
+  EXPECT_TRUE(timer_info.api_scope_name().empty());
+
+  timer_info = copy;
+  copy.set_depth(5);
+  EXPECT_EQ(timer_info.api_scope_name(), "scope");
+  EXPECT_EQ(timer_info.depth(), 3);
+}
+
+TEST(TimerInfo, IsSmallerThanProto) {
+  const orbit_client_protos::TimerInfo timer_info_proto = MakeFunctionCallTimerProto();
+  const TimerInfo timer_info{timer_info_proto};
+  ORBIT_LOG("Bytes per function call timer: %u as TimerInfo proto, %u as compact TimerInfo",
+            sizeof(orbit_client_protos::TimerInfo), timer_info.GetMemoryUsageBytes());
+  EXPECT_LT(timer_info.GetMemoryUsageBytes(), sizeof(orbit_client_protos::TimerInfo));
+}
+
+}  // namespace orbit_client_data
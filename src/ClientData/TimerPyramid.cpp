@@ -0,0 +1,113 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ClientData/TimerPyramid.h"
+
+#include <algorithm>
+
+#include "ClientData/TimerChain.h"
+#include "OrbitBase/Logging.h"
+
+namespace orbit_client_data {
+
+bool TimerPyramid::AddTimerToLevel(const TimerInfo& timer_info, uint64_t resolution_ns,
+                                   Level* level) {
+  const uint64_t start = timer_info.start();
+  const uint64_t end = std::max(timer_info.start(), timer_info.end());
+  ++level->timer_count;
+  if (!level->spans.empty()) {
+    TimerSpan& last_span = level->spans.back();
+    if (start < last_span.start) return false;
+
+    if (last_span.end - last_span.start < resolution_ns && end - last_span.start < resolution_ns) {
+      last_span.end = std::max(last_span.end, end);
+      ++last_span.timer_count;
+      level->max_ends.back() = std::max(level->max_ends.back(), end);
+      return true;
+    }
+  }
+
+  const uint64_t previous_max_end = level->max_ends.empty() ? 0 : level->max_ends.back();
+  level->spans.push_back(
+      TimerSpan{.start = start, .end = end, .first_timer = &timer_info, .timer_count = 1});
+  level->max_ends.push_back(std::max(previous_max_end, end));
+  return true;
+}
+
+void TimerPyramid::UpdateLevel(size_t level_index) const {
+  Level& level = levels_[level_index];
+  if (level.is_discarded) return;
+  if (level.next_block == nullptr) level.next_block = first_block_;
+
+  const uint64_t resolution_ns = GetLevelResolutionNs(level_index);
+  while (true) {
+    const TimerBlock& block = *level.next_block;
+    const size_t block_size = block.size();
+    for (; level.next_index_in_block < block_size; ++level.next_index_in_block) {
+      if (!AddTimerToLevel(block[level.next_index_in_block], resolution_ns, &level)) {
+        ORBIT_LOG("Timers are not ordered by start timestamp, not keeping a TimerPyramid");
+        timers_are_ordered_ = false;
+        levels_ = {};
+        return;
+      }
+    }
+
+    // Checking after every block keeps the memory of a level that is about to be discarded bounded
+    // by the size of a block.
+    if (level.timer_count >= kMinTimerCountToDiscardLevel &&
+        level.spans.size() * kMinTimersPerSpan > level.timer_count) {
+      level = Level{};
+      level.is_discarded = true;
+      return;
+    }
+
+    if (!block.at_capacity() || block.next_ == nullptr) return;
+    level.next_block = block.next_;
+    level.next_index_in_block = 0;
+  }
+}
+
+std::optional<std::vector<TimerSpan>> TimerPyramid::GetSpans(uint64_t min_tick, uint64_t max_tick,
+                                                             uint64_t max_resolution_ns) const {
+  absl::MutexLock lock(&mutex_);
+  if (!timers_are_ordered_) return std::nullopt;
+
+  std::optional<size_t> level_index;
+  for (size_t index = 0; index < kLevelCount; ++index) {
+    if (GetLevelResolutionNs(index) > max_resolution_ns) break;
+    level_index = index;
+  }
+  if (!level_index.has_value()) return std::nullopt;
+
+  UpdateLevel(level_index.value());
+  const Level& level = levels_[level_index.value()];
+  if (!timers_are_ordered_ || level.is_discarded) return std::nullopt;
+
+  std::vector<TimerSpan> spans;
+  auto max_end_it = std::lower_bound(level.max_ends.begin(), level.max_ends.end(), min_tick);
+  for (size_t index = max_end_it - level.max_ends.begin();
+       index < level.spans.size() && level.spans[index].start <= max_tick; ++index) {
+    const TimerSpan& span = level.spans[index];
+    if (span.end >= min_tick) spans.push_back(span);
+  }
+  return spans;
+}
+
+size_t TimerPyramid::GetSpanCount(size_t level_index) const {
+  ORBIT_CHECK(level_index < kLevelCount);
+  absl::MutexLock lock(&mutex_);
+  return levels_[level_index].spans.size();
+}
+
+uint64_t TimerPyramid::GetMemoryUsageBytes() const {
+  absl::MutexLock lock(&mutex_);
+  uint64_t memory_usage_bytes = sizeof(*this);
+  for (const Level& level : levels_) {
+    memory_usage_bytes += level.spans.capacity() * sizeof(TimerSpan) +
+                          level.max_ends.capacity() * sizeof(uint64_t);
+  }
+  return memory_usage_bytes;
+}
+
+}  // namespace orbit_client_data
@@ -0,0 +1,248 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <absl/strings/str_format.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "ClientData/TimerChain.h"
+#include "ClientData/TimerInfo.h"
+#include "ClientData/TimerPyramid.h"
+#include "ClientProtos/capture_data.pb.h"
+#include "OrbitBase/Logging.h"
+
+namespace orbit_client_data {
+
+namespace {
+
+void AddTimer(TimerChain* chain, uint64_t start, uint64_t end) {
+  orbit_client_protos::TimerInfo timer_info;
+  timer_info.set_start(start);
+  timer_info.set_end(end);
+  chain->emplace_back(timer_info);
+}
+
+constexpr uint64_t kFinestResolutionNs = TimerPyramid::kFinestResolutionNs;
+
+}  // namespace
+
+TEST(TimerPyramid, ChainOnlyKeepsPyramidIfRequested) {
+  EXPECT_EQ(TimerChain{}.GetTimerPyramid(), nullptr);
+  EXPECT_NE(TimerChain{/*keep_timer_pyramid=*/true}.GetTimerPyramid(), nullptr);
+}
+
+TEST(TimerPyramid, NoSpansBelowFinestResolution) {
+  TimerChain chain{/*keep_timer_pyramid=*/true};
+  AddTimer(&chain, 0, 10);
+  EXPECT_FALSE(chain.GetTimerPyramid()->GetSpans(0, 100, kFinestResolutionNs - 1).has_value());
+  EXPECT_TRUE(chain.GetTimerPyramid()->GetSpans(0, 100, kFinestResolutionNs).has_value());
+}
+
+TEST(TimerPyramid, MergesShortTimers) {
+  TimerChain chain{/*keep_timer_pyramid=*/true};
+  // 100 timers of 10ns every 100ns all fit into one span of the finest level.
+  for (uint64_t i = 0; i < 100; ++i) {
+    AddTimer(&chain, i * 100, i * 100 + 10);
+  }
+  const TimerPyramid* pyramid = chain.GetTimerPyramid();
+  std::optional<std::vector<TimerSpan>> spans =
+      pyramid->GetSpans(0, std::numeric_limits<uint64_t>::max(), kFinestResolutionNs);
+  ASSERT_TRUE(spans.has_value());
+  EXPECT_EQ(pyramid->GetSpanCount(0), 1);
+  ASSERT_EQ(spans->size(), 1);
+  EXPECT_EQ(spans->at(0).start, 0);
+  EXPECT_EQ(spans->at(0).end, 9910);
+  EXPECT_EQ(spans->at(0).timer_count, 100);
+  EXPECT_EQ(spans->at(0).first_timer, &(*chain.begin())[0]);
+}
+
+TEST(TimerPyramid, LongTimersGetTheirOwnSpan) {
+  TimerChain chain{/*keep_timer_pyramid=*/true};
+  AddTimer(&chain, 0, 10);
+  AddTimer(&chain, 20, 20 + 2 * kFinestResolutionNs);
+  AddTimer(&chain, 3 * kFinestResolutionNs, 3 * kFinestResolutionNs + 10);
+  AddTimer(&chain, 3 * kFinestResolutionNs + 20, 3 * kFinestResolutionNs + 30);
+
+  const TimerPyramid* pyramid = chain.GetTimerPyramid();
+  std::optional<std::vector<TimerSpan>> spans =
+      pyramid->GetSpans(0, std::numeric_limits<uint64_t>::max(), kFinestResolutionNs);
+  ASSERT_TRUE(spans.has_value());
+  ASSERT_EQ(spans->size(), 3);
+  EXPECT_EQ(spans->at(0).timer_count, 1);
+  EXPECT_EQ(spans->at(1).timer_count, 1);
+  EXPECT_EQ(spans->at(1).end, 20 + 2 * kFinestResolutionNs);
+  EXPECT_EQ(spans->at(2).timer_count, 2);
+
+  // At the next level, all four timers fit into one span.
+  spans = pyramid->GetSpans(0, std::numeric_limits<uint64_t>::max(),
+                            TimerPyramid::GetLevelResolutionNs(1));
+  ASSERT_TRUE(spans.has_value());
+  ASSERT_EQ(spans->size(), 1);
+  EXPECT_EQ(spans->at(0).timer_count, 4);
+}
+
+TEST(TimerPyramid, GetSpansOnlyReturnsIntersectingSpans) {
+  TimerChain chain{/*keep_timer_pyramid=*/true};
+  // A long timer followed by many short ones: the long timer still intersects ranges that start
+  // after many of the short timers.
+  AddTimer(&chain, 0, 100 * kFinestResolutionNs);
+  for (uint64_t i = 1; i < 100; ++i) {
+    AddTimer(&chain, i * kFinestResolutionNs, i * kFinestResolutionNs + 10);
+  }
+
+  std::optional<std::vector<TimerSpan>> spans = chain.GetTimerPyramid()->GetSpans(
+      50 * kFinestResolutionNs + 100, 52 * kFinestResolutionNs + 5, kFinestResolutionNs);
+  ASSERT_TRUE(spans.has_value());
+  ASSERT_EQ(spans->size(), 3);
+  EXPECT_EQ(spans->at(0).start, 0);
+  EXPECT_EQ(spans->at(1).start, 51 * kFinestResolutionNs);
+  EXPECT_EQ(spans->at(2).start, 52 * kFinestResolutionNs);
+}
+
+TEST(TimerPyramid, UnorderedTimersDisableThePyramid) {
+  TimerChain chain{/*keep_timer_pyramid=*/true};
+  AddTimer(&chain, 100, 110);
+  AddTimer(&chain, 50, 60);
+  EXPECT_FALSE(chain.GetTimerPyramid()
+                   ->GetSpans(0, std::numeric_limits<uint64_t>::max(), kFinestResolutionNs)
+                   .has_value());
+}
+
+TEST(TimerPyramid, OnlyBuildsRequestedLevels) {
+  TimerChain chain{/*keep_timer_pyramid=*/true};
+  for (uint64_t i = 0; i < 100; ++i) {
+    AddTimer(&chain, i * kFinestResolutionNs, i * kFinestResolutionNs + 10);
+  }
+
+  const TimerPyramid* pyramid = chain.GetTimerPyramid();
+  for (size_t level_index = 0; level_index < TimerPyramid::kLevelCount; ++level_index) {
+    EXPECT_EQ(pyramid->GetSpanCount(level_index), 0);
+  }
+
+  EXPECT_TRUE(pyramid
+                  ->GetSpans(0, std::numeric_limits<uint64_t>::max(),
+                             TimerPyramid::GetLevelResolutionNs(2))
+                  .has_value());
+  for (size_t level_index = 0; level_index < TimerPyramid::kLevelCount; ++level_index) {
+    EXPECT_EQ(pyramid->GetSpanCount(level_index), level_index == 2 ? 7 : 0);
+  }
+}
+
+TEST(TimerPyramid, IncludesTimersAddedAfterThePreviousRequest) {
+  TimerChain chain{/*keep_timer_pyramid=*/true};
+  const TimerPyramid* pyramid = chain.GetTimerPyramid();
+  // Spread the timers over several blocks of the chain and request spans in between.
+  constexpr uint64_t kTimerCount = 5000;
+  for (uint64_t i = 0; i < kTimerCount; ++i) {
+    AddTimer(&chain, i * 100, i * 100 + 10);
+    if (i % 777 != 0) continue;
+
+    std::optional<std::vector<TimerSpan>> spans =
+        pyramid->GetSpans(0, std::numeric_limits<uint64_t>::max(), kFinestResolutionNs);
+    ASSERT_TRUE(spans.has_value());
+    uint64_t timer_count = 0;
+    for (const TimerSpan& span : spans.value()) timer_count += span.timer_count;
+    EXPECT_EQ(timer_count, i + 1);
+  }
+
+  std::optional<std::vector<TimerSpan>> spans =
+      pyramid->GetSpans(0, std::numeric_limits<uint64_t>::max(), kFinestResolutionNs);
+  ASSERT_TRUE(spans.has_value());
+  // 656 timers every 100ns fit into a span shorter than 65536ns.
+  ASSERT_EQ(spans->size(), 8);
+  uint64_t timer_count = 0;
+  for (const TimerSpan& span : spans.value()) timer_count += span.timer_count;
+  EXPECT_EQ(timer_count, kTimerCount);
+  EXPECT_EQ(spans->back().end, (kTimerCount - 1) * 100 + 10);
+}
+
+TEST(TimerPyramid, DiscardsLevelsThatMergeFewTimers) {
+  TimerChain chain{/*keep_timer_pyramid=*/true};
+  // Each timer is as long as the finest resolution, so the finest level has a span per timer.
+  for (uint64_t i = 0; i < TimerPyramid::kMinTimerCountToDiscardLevel; ++i) {
+    AddTimer(&chain, i * kFinestResolutionNs, (i + 1) * kFinestResolutionNs);
+  }
+
+  const TimerPyramid* pyramid = chain.GetTimerPyramid();
+  EXPECT_FALSE(pyramid->GetSpans(0, std::numeric_limits<uint64_t>::max(), kFinestResolutionNs)
+                   .has_value());
+  EXPECT_EQ(pyramid->GetSpanCount(0), 0);
+
+  // At the next level, only three timers fit into a span. The level after merges 15 timers.
+  EXPECT_FALSE(pyramid
+                   ->GetSpans(0, std::numeric_limits<uint64_t>::max(),
+                              TimerPyramid::GetLevelResolutionNs(1))
+                   .has_value());
+  std::optional<std::vector<TimerSpan>> spans = pyramid->GetSpans(
+      0, std::numeric_limits<uint64_t>::max(), TimerPyramid::GetLevelResolutionNs(2));
+  ASSERT_TRUE(spans.has_value());
+  EXPECT_LE(spans->size(), TimerPyramid::kMinTimerCountToDiscardLevel / 8);
+}
+
+// Measures collecting the timers to draw for a fully zoomed-out frame, by visiting every timer and
+// by querying the pyramid, and the memory the pyramid takes compared to the timers. Only logs the
+// results, hence disabled by default.
+TEST(TimerPyramid, DISABLED_BenchmarkZoomedOutFrame) {
+  constexpr uint64_t kCaptureDurationNs = 60'000'000'000;
+  constexpr uint64_t kWidthInPixels = 2'000;
+  constexpr uint64_t kNsPerPixel = kCaptureDurationNs / kWidthInPixels;
+  for (uint64_t timer_count : {10'000, 100'000, 1'000'000, 10'000'000}) {
+    TimerChain chain{/*keep_timer_pyramid=*/true};
+    const uint64_t period_ns = kCaptureDurationNs / timer_count;
+    for (uint64_t i = 0; i < timer_count; ++i) {
+      AddTimer(&chain, i * period_ns, i * period_ns + period_ns / 2);
+    }
+
+    const auto chain_start = std::chrono::steady_clock::now();
+    uint64_t visited_timer_count = 0;
+    for (const TimerBlock& block : chain) {
+      if (!block.Intersects(0, kCaptureDurationNs)) continue;
+      for (size_t k = 0; k < block.size(); ++k) {
+        if (block[k].start() <= kCaptureDurationNs) ++visited_timer_count;
+      }
+    }
+    const std::chrono::duration<double> chain_duration =
+        std::chrono::steady_clock::now() - chain_start;
+
+    // The first request builds the level, later ones only catch up with new timers.
+    const TimerPyramid* pyramid = chain.GetTimerPyramid();
+    const auto build_start = std::chrono::steady_clock::now();
+    std::optional<std::vector<TimerSpan>> spans =
+        pyramid->GetSpans(0, kCaptureDurationNs, kNsPerPixel);
+    const std::chrono::duration<double> build_duration =
+        std::chrono::steady_clock::now() - build_start;
+    const auto pyramid_start = std::chrono::steady_clock::now();
+    spans = pyramid->GetSpans(0, kCaptureDurationNs, kNsPerPixel);
+    const std::chrono::duration<double> pyramid_duration =
+        std::chrono::steady_clock::now() - pyramid_start;
+    const uint64_t zoomed_out_memory_usage_bytes = pyramid->GetMemoryUsageBytes();
+
+    // Zooming through every level builds all of them, except for those that get discarded.
+    for (size_t level_index = 0; level_index < TimerPyramid::kLevelCount; ++level_index) {
+      (void)pyramid->GetSpans(0, kCaptureDurationNs,
+                              TimerPyramid::GetLevelResolutionNs(level_index));
+    }
+    const uint64_t all_levels_memory_usage_bytes = pyramid->GetMemoryUsageBytes();
+
+    EXPECT_EQ(visited_timer_count, timer_count);
+    if (spans.has_value()) EXPECT_LE(spans->size(), std::min(timer_count, 4 * kWidthInPixels));
+    ORBIT_LOG(
+        "%u timers: TimerChain %.3f ms (%u timers, %u bytes per timer), TimerPyramid %.3f ms to "
+        "build, %.3f ms to query (%s), %.2f bytes per timer zoomed out, %.2f bytes per timer with "
+        "all levels",
+        timer_count, chain_duration.count() * 1e3, visited_timer_count, sizeof(TimerInfo),
+        build_duration.count() * 1e3, pyramid_duration.count() * 1e3,
+        spans.has_value() ? absl::StrFormat("%u spans", spans->size()) : "level discarded",
+        static_cast<double>(zoomed_out_memory_usage_bytes) / timer_count,
+        static_cast<double>(all_levels_memory_usage_bytes) / timer_count);
+  }
+}
+
+}  // namespace orbit_client_data
@@ -4,10 +4,9 @@
 
 #include "ClientData/TimerTrackDataIdManager.h"
 
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 
-using orbit_client_protos::TimerInfo;
-
 namespace orbit_client_data {
 
 TimerTrackDataIdManager::TimerTrackDataIdManager() {
@@ -63,7 +63,7 @@ TEST(ThreadTrackDataProvider, GetTrackIdFromTimerInfo) {
   constexpr uint64_t kAnotherId = 43;
 
   std::set<uint32_t> used_tracks_ids;
-  TimerInfo timer_info;
+  orbit_client_protos::TimerInfo timer_info;
 
   // GetTrackId for different types of Timer Tracks.
   timer_info.set_function_id(kSharedId);
@@ -7,12 +7,16 @@
 
 #include <absl/container/btree_map.h>
 #include <absl/container/flat_hash_map.h>
+#include <absl/container/node_hash_map.h>
+#include <absl/synchronization/mutex.h>
+#include <absl/types/span.h>
 #include <stdint.h>
 
 #include <limits>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <utility>
 #include <vector>
 
 #include "CallstackType.h"
@@ -20,7 +24,9 @@
 #include "ClientData/CallstackInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "ModuleManager.h"
+#include "OrbitBase/Executor.h"
 #include "OrbitBase/Logging.h"
+#include "OrbitBase/TaskGroup.h"
 
 namespace orbit_client_data {
 
@@ -55,8 +61,8 @@ class CallstackData {
   template <typename Action>
   void ForEachCallstackEvent(Action&& action) const {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
-    for (const auto& [unused_tid, events] : callstack_events_by_tid_) {
-      for (const auto& [unused_timestamp, event] : events) {
+    for (const auto& [unused_tid, events_of_tid] : callstack_events_by_tid_) {
+      for (const auto& [unused_timestamp, event] : events_of_tid.events) {
         std::invoke(std::forward<Action>(action), event);
       }
     }
@@ -67,7 +73,8 @@ class CallstackData {
                                         Action&& action) const {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
     ORBIT_CHECK(min_timestamp <= max_timestamp);
-    for (const auto& [unused_tid, events] : callstack_events_by_tid_) {
+    for (const auto& [unused_tid, events_of_tid] : callstack_events_by_tid_) {
+      const auto& events = events_of_tid.events;
       for (auto event_it = events.lower_bound(min_timestamp);
            event_it != events.upper_bound(max_timestamp); ++event_it) {
         std::invoke(std::forward<Action>(action), event_it->second);
@@ -75,6 +82,14 @@ class CallstackData {
     }
   }
 
+  template <typename Action>
+  void ForEachThreadIdWithCallstackEvents(Action&& action) const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    for (const auto& [tid, unused_events] : callstack_events_by_tid_) {
+      std::invoke(std::forward<Action>(action), tid);
+    }
+  }
+
   template <typename Action>
   void ForEachCallstackEventOfTidInTimeRange(uint32_t tid, uint64_t min_timestamp,
                                              uint64_t max_timestamp, Action&& action) const {
@@ -84,13 +99,75 @@ class CallstackData {
     if (tid_and_events_it == callstack_events_by_tid_.end()) {
       return;
     }
-    const auto& events = tid_and_events_it->second;
+    const auto& events = tid_and_events_it->second.events;
     for (auto event_it = events.lower_bound(min_timestamp);
          event_it != events.upper_bound(max_timestamp); ++event_it) {
       std::invoke(std::forward<Action>(action), event_it->second);
     }
   }
 
+  // For each i, calls `action(i, event)` for the CallstackEvents of thread
+  // `tids_and_min_timestamps[i].first` with a timestamp of at least
+  // `tids_and_min_timestamps[i].second`, in order of timestamp. Each thread is processed by a
+  // separate task on `executor`, so `action` is called concurrently for different threads. Events
+  // added during the call that are newer than the last event of their thread at the time of the
+  // call are not visited. The tasks don't hold `mutex_`, only the lock of the events of their
+  // thread, which they release every `kMaxCallstackEventsPerLockHold` events, so that neither
+  // waiting for the tasks nor the tasks themselves block other threads that access this
+  // CallstackData for long. `action` must not call into this CallstackData.
+  template <typename Action>
+  void ForEachCallstackEventOfTidsInParallel(
+      orbit_base::Executor* executor,
+      absl::Span<const std::pair<uint32_t, uint64_t>> tids_and_min_timestamps,
+      Action&& action) const {
+    // For each i, the events of the thread and the timestamp of its last event at the time of the
+    // call, so that the range visited by each task doesn't grow with events added later.
+    std::vector<std::pair<const CallstackEventsOfTid*, uint64_t>> events_and_max_timestamps(
+        tids_and_min_timestamps.size(), {nullptr, 0});
+    {
+      std::lock_guard<std::recursive_mutex> lock(mutex_);
+      for (size_t i = 0; i < tids_and_min_timestamps.size(); ++i) {
+        const auto& tid_and_events_it =
+            callstack_events_by_tid_.find(tids_and_min_timestamps[i].first);
+        if (tid_and_events_it == callstack_events_by_tid_.end()) {
+          continue;
+        }
+        const CallstackEventsOfTid& events_of_tid = tid_and_events_it->second;
+        // `mutex_` is held, so `events` can't be modified concurrently.
+        if (events_of_tid.events.empty()) continue;
+        events_and_max_timestamps[i] = {&events_of_tid, events_of_tid.events.rbegin()->first};
+      }
+    }
+
+    orbit_base::TaskGroup task_group{executor};
+    for (size_t i = 0; i < events_and_max_timestamps.size(); ++i) {
+      const auto& [events_of_tid, max_timestamp] = events_and_max_timestamps[i];
+      if (events_of_tid == nullptr) continue;
+      task_group.AddTask([&action, events_of_tid = events_of_tid, max_timestamp = max_timestamp,
+                          min_timestamp = tids_and_min_timestamps[i].second, i] {
+        uint64_t next_timestamp = min_timestamp;
+        bool done = false;
+        while (!done) {
+          absl::ReaderMutexLock lock{&events_of_tid->mutex};
+          const auto& events = events_of_tid->events;
+          auto event_it = events.lower_bound(next_timestamp);
+          for (size_t count = 0;; ++count, ++event_it) {
+            if (event_it == events.end() || event_it->first > max_timestamp) {
+              done = true;
+              break;
+            }
+            if (count == kMaxCallstackEventsPerLockHold) {
+              next_timestamp = event_it->first;
+              break;
+            }
+            std::invoke(action, i, event_it->second);
+          }
+        }
+      });
+    }
+    task_group.Wait();
+  }
+
   [[nodiscard]] uint64_t max_time() const {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
     return max_time_;
@@ -126,11 +203,25 @@ class CallstackData {
 
   void RegisterTime(uint64_t time);
 
+  // The CallstackEvents of one thread, by timestamp. `events` is only modified while holding both
+  // `mutex_` and `mutex`, so it can be read while holding either.
+  struct CallstackEventsOfTid {
+    mutable absl::Mutex mutex;
+    absl::btree_map<uint64_t, CallstackEvent> events;
+  };
+
+  // Requires `mutex_` to be held.
+  void EmplaceCallstackEvent(const CallstackEvent& callstack_event);
+
+  static constexpr size_t kMaxCallstackEventsPerLockHold = 1024;
+
   // Use a reentrant mutex so that calls to the ForEach... methods can be nested.
   // E.g., one might want to nest ForEachCallstackEvent and ForEachFrameInCallstack.
   mutable std::recursive_mutex mutex_;
   absl::flat_hash_map<uint64_t, std::shared_ptr<CallstackInfo>> unique_callstacks_;
-  absl::flat_hash_map<uint32_t, absl::btree_map<uint64_t, CallstackEvent>> callstack_events_by_tid_;
+  // A node_hash_map, as ForEachCallstackEventOfTidsInParallel keeps pointers to its values after
+  // releasing `mutex_`, and absl::Mutex is not movable.
+  absl::node_hash_map<uint32_t, CallstackEventsOfTid> callstack_events_by_tid_;
 
   uint64_t max_time_ = 0;
   uint64_t min_time_ = std::numeric_limits<uint64_t>::max();
@@ -37,6 +37,7 @@
 #include "ClientData/TimerChain.h"
 #include "ClientData/TimerData.h"
 #include "ClientData/TimerDataManager.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientData/TimestampIntervalSet.h"
 #include "ClientData/TracepointCustom.h"
 #include "ClientData/TracepointData.h"
@@ -45,6 +46,7 @@
 #include "GrpcProtos/process.pb.h"
 #include "GrpcProtos/tracepoint.pb.h"
 #include "OrbitBase/Logging.h"
+#include "Statistics/QuantileSketch.h"
 
 namespace orbit_client_data {
 
@@ -233,8 +235,10 @@ class CaptureData {
     return frame_track_function_ids_;
   }
 
-  [[nodiscard]] std::pair<uint64_t, TimerData*> CreateTimerData() {
-    return timer_data_manager_.CreateTimerData();
+  [[nodiscard]] std::pair<uint64_t, TimerData*> CreateTimerData(
+      TimerData::TimerPyramidUpdateType timer_pyramid_update_type =
+          TimerData::TimerPyramidUpdateType::kAlways) {
+    return timer_data_manager_.CreateTimerData(timer_pyramid_update_type);
   }
 
   [[nodiscard]] ThreadTrackDataProvider* GetThreadTrackDataProvider() const {
@@ -242,13 +246,15 @@ class CaptureData {
   }
 
   [[nodiscard]] std::optional<ScopeId> ProvideScopeId(
-      const orbit_client_protos::TimerInfo& timer_info) const;
+      const TimerInfo& timer_info) const;
   [[nodiscard]] std::vector<ScopeId> GetAllProvidedScopeIds() const;
   [[nodiscard]] const ScopeInfo& GetScopeInfo(ScopeId scope_id) const;
   [[nodiscard]] std::optional<ScopeId> FunctionIdToScopeId(uint64_t function_id) const;
   [[nodiscard]] uint64_t ScopeIdToFunctionId(ScopeId scope_id) const;
 
-  [[nodiscard]] const std::vector<uint64_t>* GetSortedTimerDurationsForScopeId(
+  // Returns a copy of the sketch of the durations of the timers of `scope_id` added so far with
+  // `UpdateScopeStats`, as timers keep being added from the capture thread.
+  [[nodiscard]] std::optional<orbit_statistics::QuantileSketch> GetDurationSketchForScopeId(
       ScopeId scope_id) const;
 
   // Returns all the timers corresponding to scopes with non-invalid ids
@@ -269,8 +275,6 @@ class CaptureData {
       int64_t thread_id, uint64_t timestamp) const;
 
  private:
-  void UpdateTimerDurations();
-
   orbit_grpc_protos::CaptureStarted capture_started_;
 
   orbit_client_data::ProcessData process_;
@@ -312,7 +316,9 @@ class CaptureData {
   TimerDataManager timer_data_manager_;
   std::unique_ptr<ThreadTrackDataProvider> thread_track_data_provider_;
 
-  absl::flat_hash_map<ScopeId, std::vector<uint64_t>> scope_id_to_timer_durations_;
+  absl::flat_hash_map<ScopeId, orbit_statistics::QuantileSketch> scope_id_to_duration_sketch_
+      GUARDED_BY(duration_sketches_mutex_);
+  mutable absl::Mutex duration_sketches_mutex_;
 };
 
 }  // namespace orbit_client_data
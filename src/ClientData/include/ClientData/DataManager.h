@@ -17,6 +17,7 @@
 #include "ClientData/FunctionInfo.h"
 #include "ClientData/ScopeId.h"
 #include "ClientData/ThreadStateSliceInfo.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientData/TracepointCustom.h"
 #include "ClientData/UserDefinedCaptureData.h"
 #include "ClientData/WineSyscallHandlingMethod.h"
@@ -45,7 +46,7 @@ class DataManager final {
       std::optional<ThreadStateSliceInfo> selected_thread_state_slice);
   void set_hovered_thread_state_slice(
       std::optional<ThreadStateSliceInfo> hovered_thread_state_slice);
-  void set_selected_timer(const orbit_client_protos::TimerInfo* timer_info);
+  void set_selected_timer(const TimerInfo* timer_info);
 
   [[nodiscard]] bool IsFunctionSelected(const FunctionInfo& function) const;
   [[nodiscard]] std::vector<FunctionInfo> GetSelectedFunctions() const;
@@ -55,7 +56,10 @@ class DataManager final {
   [[nodiscard]] uint32_t selected_thread_id() const;
   [[nodiscard]] std::optional<ThreadStateSliceInfo> selected_thread_state_slice() const;
   [[nodiscard]] std::optional<ThreadStateSliceInfo> hovered_thread_state_slice() const;
-  [[nodiscard]] const orbit_client_protos::TimerInfo* selected_timer() const;
+  [[nodiscard]] const TimerInfo* selected_timer() const;
+  // Incremented whenever any of the visible or highlighted scopes, the selected or hovered thread,
+  // thread state slice or timer changes, i.e. whenever the timeline may need to be drawn differently.
+  [[nodiscard]] uint64_t selection_generation() const;
 
   void SelectTracepoint(const orbit_grpc_protos::TracepointInfo& info);
   void DeselectTracepoint(const orbit_grpc_protos::TracepointInfo& info);
@@ -128,9 +132,10 @@ class DataManager final {
   TracepointInfoSet selected_tracepoints_;
 
   uint32_t selected_thread_id_ = orbit_base::kInvalidThreadId;
-  const orbit_client_protos::TimerInfo* selected_timer_ = nullptr;
+  const TimerInfo* selected_timer_ = nullptr;
   std::optional<orbit_client_data::ThreadStateSliceInfo> selected_thread_state_slice_;
   std::optional<orbit_client_data::ThreadStateSliceInfo> hovered_thread_state_slice_;
+  uint64_t selection_generation_ = 0;
 
   // DataManager needs a copy of this so that we can persist user choices like frame tracks between
   // captures.
@@ -21,6 +21,10 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 
+namespace orbit_client_model {
+class SamplingDataPostProcessor;
+}  // namespace orbit_client_model
+
 namespace orbit_client_data {
 
 struct SampledFunction {
@@ -105,6 +109,9 @@ class PostProcessedSamplingData {
   [[nodiscard]] uint32_t GetCountOfFunction(uint64_t function_address) const;
 
  private:
+  // Updates the fields in place as new samples come in.
+  friend class orbit_client_model::SamplingDataPostProcessor;
+
   [[nodiscard]] std::multimap<int, uint64_t> GetCallstacksFromFunctionAddresses(
       const std::vector<uint64_t>& function_addresses, uint32_t thread_id) const;
 
@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "ClientData/TimerData.h"
+#include "ClientData/TimerInfo.h"
 #include "OrbitBase/Append.h"
 #include "ScopeTreeTimerData.h"
 #include "TimerDataManager.h"
@@ -25,7 +26,7 @@ class ThreadTrackDataManager final {
                                     ? ScopeTreeTimerData::ScopeTreeUpdateType::kOnCaptureComplete
                                     : ScopeTreeTimerData::ScopeTreeUpdateType::kAlways){};
 
-  const orbit_client_protos::TimerInfo& AddTimer(orbit_client_protos::TimerInfo timer_info) {
+  const TimerInfo& AddTimer(TimerInfo timer_info) {
     absl::MutexLock lock(&mutex_);
     uint32_t thread_id = timer_info.thread_id();
     // Get or create ScopeTreeTimerData optimized to only make one query to the map, as AddTimer
@@ -10,7 +10,10 @@
 #include <cstdint>
 #include <iosfwd>
 #include <limits>
+#include <memory>
 
+#include "ClientData/TimerInfo.h"
+#include "ClientData/TimerPyramid.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "OrbitBase/Logging.h"
 
@@ -24,6 +27,7 @@ namespace orbit_client_data {
 class TimerBlock {
   friend class TimerChain;
   friend class TimerChainIterator;
+  friend class TimerPyramid;
 
  public:
   explicit TimerBlock(TimerBlock* prev)
@@ -36,10 +40,9 @@ class TimerBlock {
 
   // Append a new element to the end of the block using placement-new.
   template <class... Args>
-  const orbit_client_protos::TimerInfo& emplace_back(Args&&... args) {
+  const TimerInfo& emplace_back(Args&&... args) {
     ORBIT_CHECK(size() < kBlockSize);
-    const orbit_client_protos::TimerInfo& timer_info =
-        data_.emplace_back(std::forward<Args>(args)...);
+    const TimerInfo& timer_info = data_.emplace_back(std::forward<Args>(args)...);
     min_timestamp_ = std::min(timer_info.start(), min_timestamp_);
     max_timestamp_ = std::max(timer_info.end(), max_timestamp_);
     return timer_info;
@@ -53,7 +56,7 @@ class TimerBlock {
   [[nodiscard]] size_t size() const { return data_.size(); }
   [[nodiscard]] bool at_capacity() const { return size() == kBlockSize; }
 
-  [[nodiscard]] const orbit_client_protos::TimerInfo& operator[](std::size_t idx) const {
+  [[nodiscard]] const TimerInfo& operator[](std::size_t idx) const {
     return data_[idx];
   }
 
@@ -62,7 +65,7 @@ class TimerBlock {
 
   TimerBlock* prev_;
   TimerBlock* next_;
-  std::vector<orbit_client_protos::TimerInfo> data_;
+  std::vector<TimerInfo> data_;
 
   uint64_t min_timestamp_;
   uint64_t max_timestamp_;
@@ -98,17 +101,22 @@ class TimerChainIterator {
 // is a difference compared with BlockChain in how the iterators work: Here,
 // the iterator runs over blocks, in BlockChain the iterator runs over the
 // individually stored elements.
+//
+// If `keep_timer_pyramid` is true, the chain also keeps a TimerPyramid over its timers, which
+// allows drawing a zoomed-out view without visiting every timer. The pyramid is built lazily when
+// its spans are requested, so appending timers doesn't update it.
 class TimerChain {
  public:
+  explicit TimerChain(bool keep_timer_pyramid = false)
+      : timer_pyramid_(keep_timer_pyramid ? std::make_unique<TimerPyramid>(root_) : nullptr) {}
   ~TimerChain();
 
   // Append an item to the end of the current block. If capacity of the current block is reached, a
   // new blocked is allocated and the item is added to the new block.
   template <class... Args>
-  const orbit_client_protos::TimerInfo& emplace_back(Args&&... args) {
+  const TimerInfo& emplace_back(Args&&... args) {
     if (current_->at_capacity()) AllocateNewBlock();
-    const orbit_client_protos::TimerInfo& timer_info =
-        current_->emplace_back(std::forward<Args>(args)...);
+    const TimerInfo& timer_info = current_->emplace_back(std::forward<Args>(args)...);
     ++num_items_;
     return timer_info;
   }
@@ -117,18 +125,19 @@ class TimerChain {
   [[nodiscard]] uint64_t size() const { return num_items_; }
 
   [[nodiscard]] const TimerBlock* GetBlockContaining(
-      const orbit_client_protos::TimerInfo& element) const;
+      const TimerInfo& element) const;
 
-  [[nodiscard]] const orbit_client_protos::TimerInfo* GetElementAfter(
-      const orbit_client_protos::TimerInfo& element) const;
+  [[nodiscard]] const TimerInfo* GetElementAfter(const TimerInfo& element) const;
 
-  [[nodiscard]] const orbit_client_protos::TimerInfo* GetElementBefore(
-      const orbit_client_protos::TimerInfo& element) const;
+  [[nodiscard]] const TimerInfo* GetElementBefore(const TimerInfo& element) const;
 
   [[nodiscard]] TimerChainIterator begin() const { return TimerChainIterator(root_); }
 
   [[nodiscard]] TimerChainIterator end() const { return TimerChainIterator(nullptr); }
 
+  // Returns nullptr if the chain doesn't keep a TimerPyramid.
+  [[nodiscard]] const TimerPyramid* GetTimerPyramid() const { return timer_pyramid_.get(); }
+
  private:
   void AllocateNewBlock() {
     ORBIT_CHECK(current_->next_ == nullptr);
@@ -141,6 +150,7 @@ class TimerChain {
   TimerBlock* current_ = root_;
   uint64_t num_blocks_ = 1;
   uint64_t num_items_ = 0;
+  std::unique_ptr<TimerPyramid> timer_pyramid_;
 };
 }  // namespace orbit_client_data
 
@@ -8,6 +8,7 @@
 #include <absl/base/thread_annotations.h>
 #include <absl/synchronization/mutex.h>
 
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "OrbitBase/ThreadConstants.h"
 #include "TimerChain.h"
@@ -17,8 +18,13 @@ namespace orbit_client_data {
 
 class TimerData final : public TimerDataInterface {
  public:
-  const orbit_client_protos::TimerInfo& AddTimer(orbit_client_protos::TimerInfo timer_info,
-                                                 uint32_t depth = 0) override;
+  // Whether the chains keep a TimerPyramid (see TimerChain) for drawing zoomed-out views.
+  enum class TimerPyramidUpdateType { kAlways, kNever };
+  explicit TimerData(
+      TimerPyramidUpdateType timer_pyramid_update_type = TimerPyramidUpdateType::kAlways)
+      : timer_pyramid_update_type_(timer_pyramid_update_type) {}
+
+  const TimerInfo& AddTimer(TimerInfo timer_info, uint32_t depth = 0) override;
 
   // Timers queries
   [[nodiscard]] std::vector<const TimerChain*> GetChains() const override;
@@ -26,18 +32,18 @@ class TimerData final : public TimerDataInterface {
 
   // The method is not optimized. The complexity is linear in the total number of timer_infos,
   // sortedness is not made use of.
-  [[nodiscard]] virtual std::vector<const orbit_client_protos::TimerInfo*> GetTimers(
+  [[nodiscard]] virtual std::vector<const TimerInfo*> GetTimers(
       uint64_t min_tick = std::numeric_limits<uint64_t>::min(),
       uint64_t max_tick = std::numeric_limits<uint64_t>::max()) const override {
     // TODO(b/204173236): use it in TimerTracks.
     absl::MutexLock lock(&mutex_);
-    std::vector<const orbit_client_protos::TimerInfo*> timers;
+    std::vector<const TimerInfo*> timers;
     for (const auto& [depth, chain] : timers_) {
       ORBIT_CHECK(chain != nullptr);
       for (const auto& block : *chain) {
         if (!block.Intersects(min_tick, max_tick)) continue;
         for (uint64_t i = 0; i < block.size(); i++) {
-          const orbit_client_protos::TimerInfo* timer = &block[i];
+          const TimerInfo* timer = &block[i];
           if (min_tick <= timer->start() && timer->end() <= max_tick) timers.push_back(timer);
         }
       }
@@ -56,28 +62,22 @@ class TimerData final : public TimerDataInterface {
   [[nodiscard]] uint32_t GetProcessId() const override { return process_id_; }
 
   // Relative timers queries
-  [[nodiscard]] const orbit_client_protos::TimerInfo* GetFirstAfterStartTime(uint64_t time,
-                                                                             uint32_t depth) const;
-  [[nodiscard]] const orbit_client_protos::TimerInfo* GetFirstBeforeStartTime(uint64_t time,
-                                                                              uint32_t depth) const;
+  [[nodiscard]] const TimerInfo* GetFirstAfterStartTime(uint64_t time, uint32_t depth) const;
+  [[nodiscard]] const TimerInfo* GetFirstBeforeStartTime(uint64_t time, uint32_t depth) const;
 
-  const orbit_client_protos::TimerInfo* GetLeft(
-      const orbit_client_protos::TimerInfo& timer_info) const override {
+  const TimerInfo* GetLeft(const TimerInfo& timer_info) const override {
     return GetFirstBeforeStartTime(timer_info.start(), timer_info.depth());
   }
 
-  const orbit_client_protos::TimerInfo* GetRight(
-      const orbit_client_protos::TimerInfo& timer_info) const override {
+  const TimerInfo* GetRight(const TimerInfo& timer_info) const override {
     return GetFirstAfterStartTime(timer_info.start(), timer_info.depth());
   }
 
-  const orbit_client_protos::TimerInfo* GetUp(
-      const orbit_client_protos::TimerInfo& timer_info) const override {
+  const TimerInfo* GetUp(const TimerInfo& timer_info) const override {
     return GetFirstBeforeStartTime(timer_info.start(), timer_info.depth() - 1);
   }
 
-  const orbit_client_protos::TimerInfo* GetDown(
-      const orbit_client_protos::TimerInfo& timer_info) const override {
+  const TimerInfo* GetDown(const TimerInfo& timer_info) const override {
     return GetFirstAfterStartTime(timer_info.start(), timer_info.depth() + 1);
   }
 
@@ -99,6 +99,7 @@ class TimerData final : public TimerDataInterface {
   std::atomic<uint64_t> max_time_{std::numeric_limits<uint64_t>::min()};
 
   uint32_t process_id_ = orbit_base::kInvalidProcessId;
+  const TimerPyramidUpdateType timer_pyramid_update_type_;
 };
 
 }  // namespace orbit_client_data
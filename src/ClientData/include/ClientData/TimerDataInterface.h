@@ -5,6 +5,7 @@
 #ifndef CLIENT_DATA_TIMER_DATA_INTERFACE_H_
 #define CLIENT_DATA_TIMER_DATA_INTERFACE_H_
 
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "TimerChain.h"
 
@@ -24,12 +25,11 @@ class TimerDataInterface {
  public:
   virtual ~TimerDataInterface() = default;
 
-  virtual const orbit_client_protos::TimerInfo& AddTimer(orbit_client_protos::TimerInfo timer_info,
-                                                         uint32_t depth) = 0;
+  virtual const TimerInfo& AddTimer(TimerInfo timer_info, uint32_t depth) = 0;
 
   // Timers queries
   [[nodiscard]] virtual std::vector<const TimerChain*> GetChains() const = 0;
-  [[nodiscard]] virtual std::vector<const orbit_client_protos::TimerInfo*> GetTimers(
+  [[nodiscard]] virtual std::vector<const TimerInfo*> GetTimers(
       uint64_t min_tick, uint64_t max_tick) const = 0;
 
   // Metadata queries
@@ -41,14 +41,10 @@ class TimerDataInterface {
   [[nodiscard]] virtual uint32_t GetProcessId() const = 0;
 
   // Relative timers queries
-  [[nodiscard]] virtual const orbit_client_protos::TimerInfo* GetLeft(
-      const orbit_client_protos::TimerInfo& timer) const = 0;
-  [[nodiscard]] virtual const orbit_client_protos::TimerInfo* GetRight(
-      const orbit_client_protos::TimerInfo& timer) const = 0;
-  [[nodiscard]] virtual const orbit_client_protos::TimerInfo* GetUp(
-      const orbit_client_protos::TimerInfo& timer) const = 0;
-  [[nodiscard]] virtual const orbit_client_protos::TimerInfo* GetDown(
-      const orbit_client_protos::TimerInfo& timer) const = 0;
+  [[nodiscard]] virtual const TimerInfo* GetLeft(const TimerInfo& timer) const = 0;
+  [[nodiscard]] virtual const TimerInfo* GetRight(const TimerInfo& timer) const = 0;
+  [[nodiscard]] virtual const TimerInfo* GetUp(const TimerInfo& timer) const = 0;
+  [[nodiscard]] virtual const TimerInfo* GetDown(const TimerInfo& timer) const = 0;
 
   // Only used in ScopeTreeTimerData
   [[nodiscard]] virtual int64_t GetThreadId() const = 0;
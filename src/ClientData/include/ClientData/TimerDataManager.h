@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "ClientData/TimerData.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 
 namespace orbit_client_data {
@@ -20,22 +21,23 @@ class TimerDataManager final {
  public:
   TimerDataManager() = default;
 
-  [[nodiscard]] std::pair<uint64_t, TimerData*> CreateTimerData() {
+  [[nodiscard]] std::pair<uint64_t, TimerData*> CreateTimerData(
+      TimerData::TimerPyramidUpdateType timer_pyramid_update_type =
+          TimerData::TimerPyramidUpdateType::kAlways) {
     absl::MutexLock lock(&mutex_);
     uint64_t id = timer_data_.size();
-    timer_data_.emplace_back(std::make_unique<TimerData>());
+    timer_data_.emplace_back(std::make_unique<TimerData>(timer_pyramid_update_type));
     return std::make_pair(id, timer_data_.at(id).get());
   }
 
-  [[nodiscard]] std::vector<const orbit_client_protos::TimerInfo*> GetTimers(
+  [[nodiscard]] std::vector<const TimerInfo*> GetTimers(
       orbit_client_protos::TimerInfo_Type type,
       uint64_t min_tick = std::numeric_limits<uint64_t>::min(),
       uint64_t max_tick = std::numeric_limits<uint64_t>::max()) const {
-    std::vector<const orbit_client_protos::TimerInfo*> timers;
+    std::vector<const TimerInfo*> timers;
     absl::MutexLock lock(&mutex_);
     for (const std::unique_ptr<TimerData>& timer_datum : timer_data_) {
-      for (const orbit_client_protos::TimerInfo* timer :
-           timer_datum->GetTimers(min_tick, max_tick)) {
+      for (const TimerInfo* timer : timer_datum->GetTimers(min_tick, max_tick)) {
         if (timer->type() == type) timers.push_back(timer);
       }
     }
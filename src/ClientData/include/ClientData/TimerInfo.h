@@ -0,0 +1,117 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CLIENT_DATA_TIMER_INFO_H_
+#define CLIENT_DATA_TIMER_INFO_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "ClientProtos/capture_data.pb.h"
+
+namespace orbit_client_data {
+
+// Compact representation of the timers kept by the client for the whole duration of a capture, which
+// can be hundreds of millions. It has the same accessors as `orbit_client_protos::TimerInfo`, but
+// only the fields that most timers have are stored inline. The rest of the fields (registers, color,
+// the name and group of manual instrumentation scopes, ...) are stored in a separate allocation that
+// only exists for the timers that have a non-default value for any of them.
+class TimerInfo {
+ public:
+  using Type = orbit_client_protos::TimerInfo::Type;
+  static constexpr Type kNone = orbit_client_protos::TimerInfo::kNone;
+  static constexpr Type kCoreActivity = orbit_client_protos::TimerInfo::kCoreActivity;
+  static constexpr Type kGpuActivity = orbit_client_protos::TimerInfo::kGpuActivity;
+  static constexpr Type kFrame = orbit_client_protos::TimerInfo::kFrame;
+  static constexpr Type kGpuCommandBuffer = orbit_client_protos::TimerInfo::kGpuCommandBuffer;
+  static constexpr Type kGpuDebugMarker = orbit_client_protos::TimerInfo::kGpuDebugMarker;
+  static constexpr Type kApiEvent = orbit_client_protos::TimerInfo::kApiEvent;
+  static constexpr Type kSystemMemoryUsage = orbit_client_protos::TimerInfo::kSystemMemoryUsage;
+  static constexpr Type kCGroupAndProcessMemoryUsage =
+      orbit_client_protos::TimerInfo::kCGroupAndProcessMemoryUsage;
+  static constexpr Type kPageFaults = orbit_client_protos::TimerInfo::kPageFaults;
+  static constexpr Type kApiScope = orbit_client_protos::TimerInfo::kApiScope;
+  static constexpr Type kApiScopeAsync = orbit_client_protos::TimerInfo::kApiScopeAsync;
+
+  TimerInfo() = default;
+  // NOLINTNEXTLINE(google-explicit-constructor): Non-explicit constructor for conversions.
+  TimerInfo(const orbit_client_protos::TimerInfo& timer_info);
+  TimerInfo(const TimerInfo& other);
+  TimerInfo& operator=(const TimerInfo& other);
+  TimerInfo(TimerInfo&&) = default;
+  TimerInfo& operator=(TimerInfo&&) = default;
+  ~TimerInfo() = default;
+
+  // Converts back to the protobuf message, e.g., for serialization.
+  [[nodiscard]] orbit_client_protos::TimerInfo ToProto() const;
+
+  [[nodiscard]] uint64_t start() const { return start_; }
+  [[nodiscard]] uint64_t end() const { return end_; }
+  [[nodiscard]] uint32_t process_id() const { return process_id_; }
+  [[nodiscard]] uint32_t thread_id() const { return thread_id_; }
+  [[nodiscard]] uint32_t depth() const { return depth_; }
+  void set_depth(uint32_t depth) { depth_ = depth; }
+  [[nodiscard]] Type type() const { return static_cast<Type>(type_); }
+  [[nodiscard]] int32_t processor() const { return processor_; }
+  [[nodiscard]] uint64_t function_id() const { return function_id_; }
+  [[nodiscard]] uint64_t user_data_key() const { return user_data_key_; }
+
+  [[nodiscard]] uint64_t callstack_id() const {
+    return rare_fields_ != nullptr ? rare_fields_->callstack_id : 0;
+  }
+  [[nodiscard]] uint64_t timeline_hash() const {
+    return rare_fields_ != nullptr ? rare_fields_->timeline_hash : 0;
+  }
+  [[nodiscard]] const std::vector<uint64_t>& registers() const;
+  [[nodiscard]] int registers_size() const { return static_cast<int>(registers().size()); }
+  [[nodiscard]] uint64_t registers(size_t index) const { return registers().at(index); }
+  [[nodiscard]] bool has_color() const {
+    return rare_fields_ != nullptr && rare_fields_->color.has_value();
+  }
+  [[nodiscard]] const orbit_client_protos::Color& color() const;
+  [[nodiscard]] uint64_t group_id() const {
+    return rare_fields_ != nullptr ? rare_fields_->group_id : 0;
+  }
+  [[nodiscard]] uint64_t api_async_scope_id() const {
+    return rare_fields_ != nullptr ? rare_fields_->api_async_scope_id : 0;
+  }
+  [[nodiscard]] uint64_t address_in_function() const {
+    return rare_fields_ != nullptr ? rare_fields_->address_in_function : 0;
+  }
+  [[nodiscard]] const std::string& api_scope_name() const;
+
+  // The number of bytes used by this timer, including the separate allocations.
+  [[nodiscard]] size_t GetMemoryUsageBytes() const;
+
+ private:
+  struct RareFields {
+    uint64_t callstack_id = 0;
+    uint64_t timeline_hash = 0;
+    uint64_t group_id = 0;
+    uint64_t api_async_scope_id = 0;
+    uint64_t address_in_function = 0;
+    std::vector<uint64_t> registers;
+    std::optional<orbit_client_protos::Color> color;
+    std::string api_scope_name;
+  };
+
+  uint64_t start_ = 0;
+  uint64_t end_ = 0;
+  uint64_t function_id_ = 0;
+  uint64_t user_data_key_ = 0;
+  uint32_t process_id_ = 0;
+  uint32_t thread_id_ = 0;
+  uint32_t depth_ = 0;
+  int32_t processor_ = 0;
+  std::unique_ptr<RareFields> rare_fields_;
+  uint8_t type_ = kNone;
+};
+
+}  // namespace orbit_client_data
+
+#endif  // CLIENT_DATA_TIMER_INFO_H_
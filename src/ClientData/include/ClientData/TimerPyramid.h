@@ -0,0 +1,115 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CLIENT_DATA_TIMER_PYRAMID_H_
+#define CLIENT_DATA_TIMER_PYRAMID_H_
+
+#include <absl/base/thread_annotations.h>
+#include <absl/synchronization/mutex.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "ClientData/TimerInfo.h"
+
+namespace orbit_client_data {
+
+class TimerBlock;
+
+// A range of time covered by one or more consecutive timers of the same depth.
+struct TimerSpan {
+  uint64_t start;
+  uint64_t end;
+  // The first timer of the span, which represents the span when drawing and picking.
+  const TimerInfo* first_timer;
+  uint32_t timer_count;
+};
+
+// Multi-resolution summary of the timers of a TimerChain, which allows drawing a zoomed-out view of
+// a large capture without visiting every timer.
+//
+// Each level has a resolution, and consecutive timers are merged into a single TimerSpan as long as
+// the span stays shorter than the resolution. Timers that are at least as long as the resolution
+// get a span of their own. So, when the resolution of a level is not larger than the duration
+// of a pixel, each span is either a single timer or a group of timers that fits into one or two
+// pixels, and the number of spans in the visible range is bounded by the number of pixels rather
+// than by the number of timers.
+//
+// Adding timers to the chain doesn't touch the pyramid. Instead, GetSpans builds a level the first
+// time it is requested, and catches it up with the timers added to the chain since the previous
+// request, so only the levels of zoom levels that were actually drawn take memory. A level that
+// summarizes at least kMinTimerCountToDiscardLevel timers with fewer than kMinTimersPerSpan timers
+// per span is discarded: at its resolution only a few timers fall into each pixel, so visiting the
+// timers is about as cheap as visiting the spans. This keeps each level below a quarter of the
+// timer count in spans.
+//
+// Timers are expected to be added in order of start timestamp; if they are not, the summary is
+// discarded and GetSpans always returns std::nullopt, so that the caller falls back to visiting all
+// timers. Like the drawing code that visits a TimerChain directly, GetSpans reads the chain while
+// timers may be appended to it.
+class TimerPyramid {
+ public:
+  // The resolution of the finest level. When zoomed in further, visiting the timers that intersect
+  // the visible range directly is cheap enough.
+  static constexpr uint64_t kFinestResolutionNs = uint64_t{1} << 16;
+  // Each level has a resolution 2^kResolutionFactorLog2 times the one of the previous level.
+  static constexpr uint32_t kResolutionFactorLog2 = 2;
+  static constexpr size_t kLevelCount = 8;
+  static constexpr uint64_t kMinTimersPerSpan = 4;
+  static constexpr uint64_t kMinTimerCountToDiscardLevel = 4096;
+
+  // `first_block` is the first block of the TimerChain to summarize, which needs to outlive this
+  // object.
+  explicit TimerPyramid(const TimerBlock* first_block) : first_block_(first_block) {}
+
+  [[nodiscard]] static uint64_t GetLevelResolutionNs(size_t level_index) {
+    return kFinestResolutionNs << (kResolutionFactorLog2 * level_index);
+  }
+
+  // Returns the spans that intersect [min_tick, max_tick] at the coarsest level whose resolution is
+  // not larger than `max_resolution_ns`, ordered by start timestamp. Returns std::nullopt if there
+  // is no such level or if that level was discarded.
+  [[nodiscard]] std::optional<std::vector<TimerSpan>> GetSpans(uint64_t min_tick,
+                                                               uint64_t max_tick,
+                                                               uint64_t max_resolution_ns) const;
+
+  // Returns the number of spans of a level as of the last GetSpans on it, 0 if it was never
+  // requested or was discarded.
+  [[nodiscard]] size_t GetSpanCount(size_t level_index) const;
+
+  [[nodiscard]] uint64_t GetMemoryUsageBytes() const;
+
+ private:
+  struct Level {
+    std::vector<TimerSpan> spans;
+    // max_ends[i] is the maximum end timestamp of spans[0..i]. This is non-decreasing, which allows
+    // finding the first span that ends after a given timestamp with a binary search, even if some
+    // spans are much longer than others.
+    std::vector<uint64_t> max_ends;
+    uint64_t timer_count = 0;
+    // The next timer of the chain to add to this level. `next_block` is nullptr until the level is
+    // first built.
+    const TimerBlock* next_block = nullptr;
+    size_t next_index_in_block = 0;
+    bool is_discarded = false;
+  };
+
+  // Adds the timers appended to the chain since the last update to the level.
+  void UpdateLevel(size_t level_index) const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Returns false if `timer_info` starts before the last span of the level.
+  [[nodiscard]] static bool AddTimerToLevel(const TimerInfo& timer_info, uint64_t resolution_ns,
+                                            Level* level);
+
+  const TimerBlock* const first_block_;
+  mutable absl::Mutex mutex_;
+  mutable std::array<Level, kLevelCount> levels_ ABSL_GUARDED_BY(mutex_);
+  mutable bool timers_are_ordered_ ABSL_GUARDED_BY(mutex_) = true;
+};
+
+}  // namespace orbit_client_data
+
+#endif  // CLIENT_DATA_TIMER_PYRAMID_H_
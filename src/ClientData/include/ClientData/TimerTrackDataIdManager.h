@@ -10,9 +10,10 @@
 
 #include <mutex>
 
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 
-using orbit_client_protos::TimerInfo;
+using orbit_client_data::TimerInfo;
 
 namespace orbit_client_data {
 
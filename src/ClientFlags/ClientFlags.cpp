@@ -46,6 +46,11 @@ ABSL_FLAG(std::string, instance_symbols_folder, "",
 ABSL_FLAG(bool, enforce_full_redraw, false,
           "Enforce full redraw every frame (used for performance measurements)");
 
+ABSL_FLAG(bool, parallel_update_primitives, false,
+          "Update the primitives of the visible tracks in parallel on the default thread pool");
+ABSL_FLAG(bool, cache_track_primitives, false,
+          "Reuse the primitives of tracks whose data, layout and visible time range didn't change");
+
 // VSI
 ABSL_FLAG(std::string, target_process, "",
           "Process name or path. Specify this together with --target_instance to skip the "
@@ -87,3 +92,7 @@ ABSL_FLAG(
 ABSL_FLAG(bool, auto_frame_track, true, "Automatically add the default Frame Track.");
 
 ABSL_FLAG(bool, time_range_selection, false, "Enable time range selection feature.");
+
+ABSL_FLAG(bool, compress_capture_files, false,
+          "Compress the capture section of the capture files saved while capturing. Such files "
+          "can't be opened by earlier versions of Orbit.");
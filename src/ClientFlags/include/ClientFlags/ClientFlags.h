@@ -47,6 +47,9 @@ ABSL_DECLARE_FLAG(std::string, instance_symbols_folder);
 
 ABSL_DECLARE_FLAG(bool, enforce_full_redraw);
 
+ABSL_DECLARE_FLAG(bool, parallel_update_primitives);
+ABSL_DECLARE_FLAG(bool, cache_track_primitives);
+
 // VSI
 ABSL_DECLARE_FLAG(std::string, target_process);
 ABSL_DECLARE_FLAG(std::string, target_instance);
@@ -73,4 +76,7 @@ ABSL_DECLARE_FLAG(bool, auto_frame_track);
 // Enables time range selection feature.
 ABSL_DECLARE_FLAG(bool, time_range_selection);
 
+// Compresses the capture section of capture files saved while capturing.
+ABSL_DECLARE_FLAG(bool, compress_capture_files);
+
 #endif  // CLIENT_FLAGS_CLIENT_FLAGS_H_
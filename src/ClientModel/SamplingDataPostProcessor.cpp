@@ -4,10 +4,9 @@
 
 #include "ClientModel/SamplingDataPostProcessor.h"
 
-#include <absl/hash/hash.h>
-
 #include <algorithm>
 #include <cstdint>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <string>
@@ -20,7 +19,9 @@
 #include "ClientData/ModuleAndFunctionLookup.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "OrbitBase/Logging.h"
+#include "OrbitBase/TaskGroup.h"
 #include "OrbitBase/ThreadConstants.h"
+#include "OrbitBase/ThreadPool.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 
@@ -37,74 +38,43 @@ using orbit_client_data::ThreadSampleData;
 
 namespace orbit_client_model {
 
-namespace {
-
-using CallstackInfoAsPairWithLvalueRefToFrames =
-    std::pair<const std::vector<uint64_t>&, CallstackType>;
+using orbit_client_model_internal::CallstackInfoAsPairWithLvalueRefToFrames;
 
-// CallstackInfoHash and CallstackInfoEq allow heterogeneous lookup in
-// SamplingDataPostProcessor::resolved_callstack_to_id_;
-struct CallstackInfoHash {
-  using is_transparent = void;  // Makes this functor transparent, enabling heterogeneous lookup.
-
-  size_t operator()(const CallstackInfo& o) const { return absl::Hash<CallstackInfo>{}(o); }
+namespace {
 
-  size_t operator()(const CallstackInfoAsPairWithLvalueRefToFrames& p) const {
-    return absl::Hash<CallstackInfoAsPairWithLvalueRefToFrames>{}(p);
+// Calls `task(i)` for each i in [0, task_count), as separate tasks on `thread_pool` unless it is
+// nullptr.
+template <typename Task>
+void RunTasks(orbit_base::ThreadPool* thread_pool, size_t task_count, Task&& task) {
+  if (thread_pool == nullptr) {
+    for (size_t i = 0; i < task_count; ++i) {
+      task(i);
+    }
+    return;
   }
-};
-
-struct CallstackInfoEq {
-  using is_transparent = void;  // Makes this functor transparent, enabling heterogeneous lookup.
-
-  bool operator()(const CallstackInfo& lhs, const CallstackInfo& rhs) const {
-    return std::equal(lhs.frames().begin(), lhs.frames().end(), rhs.frames().begin(),
-                      rhs.frames().end()) &&
-           lhs.type() == rhs.type();
+  orbit_base::TaskGroup task_group{thread_pool};
+  for (size_t i = 0; i < task_count; ++i) {
+    task_group.AddTask([&task, i] { task(i); });
   }
+  task_group.Wait();
+}
 
-  bool operator()(const CallstackInfo& lhs,
-                  const CallstackInfoAsPairWithLvalueRefToFrames& rhs) const {
-    return std::equal(lhs.frames().begin(), lhs.frames().end(), rhs.first.begin(),
-                      rhs.first.end()) &&
-           lhs.type() == rhs.second;
-  }
-};
+uint64_t FindFunctionAddress(uint64_t absolute_address, const CaptureData& capture_data,
+                             const ModuleManager& module_manager) {
+  std::optional<uint64_t> absolute_function_address_option =
+      orbit_client_data::FindFunctionAbsoluteAddressByInstructionAbsoluteAddress(
+          module_manager, capture_data, absolute_address);
+  return absolute_function_address_option.value_or(absolute_address);
+}
 
-class SamplingDataPostProcessor {
- public:
-  explicit SamplingDataPostProcessor() = default;
-  SamplingDataPostProcessor& operator=(const SamplingDataPostProcessor& other) = default;
-  SamplingDataPostProcessor(const SamplingDataPostProcessor& other) = default;
-
-  SamplingDataPostProcessor(SamplingDataPostProcessor&& other) = default;
-  SamplingDataPostProcessor& operator=(SamplingDataPostProcessor&& other) = default;
-
-  PostProcessedSamplingData ProcessSamples(const CallstackData& callstack_data,
-                                           const CaptureData& capture_data,
-                                           const ModuleManager& module_manager,
-                                           bool generate_summary);
-
- private:
-  void ResolveCallstacks(const CallstackData& callstack_data, const CaptureData& capture_data,
-                         const ModuleManager& module_manager);
-
-  void MapAddressToFunctionAddress(uint64_t absolute_address, const CaptureData& capture_data,
-                                   const ModuleManager& module_manager);
-
-  void FillThreadSampleDataSampleReports(const CaptureData& capture_data,
-                                         const ModuleManager& module_manager);
-
-  // Filled by ProcessSamples.
-  absl::flat_hash_map<ThreadID, ThreadSampleData> thread_id_to_sample_data_;
-  absl::flat_hash_map<uint64_t, CallstackInfo> id_to_resolved_callstack_;
-  absl::flat_hash_map<orbit_client_data::CallstackInfo, uint64_t, CallstackInfoHash,
-                      CallstackInfoEq>
-      resolved_callstack_to_id_;
-  absl::flat_hash_map<uint64_t, uint64_t> original_id_to_resolved_callstack_id_;
-  absl::flat_hash_map<uint64_t, absl::flat_hash_set<uint64_t>>
-      function_address_to_sampled_callstack_ids_;
-  absl::flat_hash_map<uint64_t, uint64_t> exact_address_to_function_address_;
+// The new CallstackEvents of a thread. The statistics only depend on how many times each
+// callstack was sampled, so the CallstackEvents are counted by callstack first.
+struct NewSamplesOfThread {
+  uint32_t thread_id;
+  ThreadSampleData* thread_sample_data;
+  uint64_t min_unprocessed_timestamp;
+  uint32_t new_samples_count = 0;
+  absl::flat_hash_map<uint64_t, uint32_t> new_callstack_id_to_count;
 };
 
 }  // namespace
@@ -112,236 +82,340 @@ class SamplingDataPostProcessor {
 PostProcessedSamplingData CreatePostProcessedSamplingData(const CallstackData& callstack_data,
                                                           const CaptureData& capture_data,
                                                           const ModuleManager& module_manager,
-                                                          bool generate_summary) {
+                                                          bool generate_summary,
+                                                          orbit_base::ThreadPool* thread_pool) {
   ORBIT_SCOPED_TIMED_LOG("CreatePostProcessedSamplingData");
-  return SamplingDataPostProcessor{}.ProcessSamples(callstack_data, capture_data, module_manager,
-                                                    generate_summary);
+  SamplingDataPostProcessor processor{generate_summary, thread_pool};
+  processor.ProcessNewSamples(callstack_data, capture_data, module_manager);
+  return std::move(processor).TakePostProcessedSamplingData();
 }
 
-namespace {
-PostProcessedSamplingData SamplingDataPostProcessor::ProcessSamples(
+const PostProcessedSamplingData& SamplingDataPostProcessor::ProcessNewSamples(
     const CallstackData& callstack_data, const CaptureData& capture_data,
-    const ModuleManager& module_manager, bool generate_summary) {
-  // Unique call stacks and per thread data
-  callstack_data.ForEachCallstackEvent([this, &callstack_data,
-                                        generate_summary](const CallstackEvent& event) {
-    const CallstackInfo* callstack_info = callstack_data.GetCallstack(event.callstack_id());
-    ORBIT_CHECK(callstack_info != nullptr);
-
-    std::vector<uint64_t> sorted_frames;
-    ORBIT_CHECK(!callstack_info->frames().empty());
-    if (callstack_info->type() == CallstackType::kComplete) {
-      for (uint64_t frame : callstack_info->frames()) {
-        sorted_frames.push_back(frame);
-      }
-    } else {
-      // For non-kComplete callstacks, only use the innermost frame for statistics, as it's the only
-      // one known to be correct. Note that, in the vast majority of cases, the innermost frame is
-      // also the only one available.
-      sorted_frames.push_back(callstack_info->frames()[0]);
-    }
-
-    // We need to consider duplicated frames (because of recursion) only once. We should use a set
-    // for better time complexity but sorting and comparing adjacent elements is faster in practice
-    // for a number of elements in the order of the number of frames in a callstack.
-    std::sort(sorted_frames.begin(), sorted_frames.end());
+    const ModuleManager& module_manager) {
+  absl::flat_hash_map<ThreadID, ThreadSampleData>& thread_id_to_sample_data =
+      post_processed_sampling_data_.thread_id_to_sample_data_;
+
+  // Threads are always visited in the order in which CallstackData stores them, so that the
+  // CallstackEvents of the summary end up in the same order whether this runs in parallel or not.
+  std::vector<NewSamplesOfThread> new_samples_of_threads;
+  callstack_data.ForEachThreadIdWithCallstackEvents([this,
+                                                     &new_samples_of_threads](uint32_t thread_id) {
+    new_samples_of_threads.push_back(
+        {thread_id, nullptr, thread_id_to_min_unprocessed_timestamp_[thread_id]});
+  });
+  // Each thread stored in CallstackData has at least one CallstackEvent, so this doesn't create
+  // ThreadSampleData without samples. All entries are created before taking pointers to them, as
+  // they can move on insertion.
+  const bool has_summary = generate_summary_ && !new_samples_of_threads.empty();
+  for (const NewSamplesOfThread& new_samples : new_samples_of_threads) {
+    thread_id_to_sample_data[new_samples.thread_id].thread_id = new_samples.thread_id;
+  }
+  if (has_summary) {
+    thread_id_to_sample_data[orbit_base::kAllProcessThreadsTid].thread_id =
+        orbit_base::kAllProcessThreadsTid;
+  }
+  for (NewSamplesOfThread& new_samples : new_samples_of_threads) {
+    new_samples.thread_sample_data = &thread_id_to_sample_data.at(new_samples.thread_id);
+  }
 
-    ThreadSampleData* thread_sample_data = &thread_id_to_sample_data_[event.thread_id()];
-    thread_sample_data->thread_id = event.thread_id();
+  auto add_callstack_event = [](NewSamplesOfThread* new_samples, const CallstackEvent& event) {
+    ThreadSampleData* thread_sample_data = new_samples->thread_sample_data;
     thread_sample_data->samples_count++;
     thread_sample_data->sampled_callstack_id_to_events[event.callstack_id()].emplace_back(event);
-    for (size_t i = 0; i < sorted_frames.size(); ++i) {
-      if (i != 0 && sorted_frames[i] == sorted_frames[i - 1]) {
-        continue;
-      }
-      thread_sample_data->sampled_address_to_count[sorted_frames[i]]++;
+    new_samples->new_samples_count++;
+    new_samples->new_callstack_id_to_count[event.callstack_id()]++;
+    new_samples->min_unprocessed_timestamp = event.timestamp_ns() + 1;
+  };
+  if (thread_pool_ == nullptr) {
+    for (NewSamplesOfThread& new_samples : new_samples_of_threads) {
+      callstack_data.ForEachCallstackEventOfTidInTimeRange(
+          new_samples.thread_id, new_samples.min_unprocessed_timestamp,
+          std::numeric_limits<uint64_t>::max(),
+          [&add_callstack_event, &new_samples](const CallstackEvent& event) {
+            add_callstack_event(&new_samples, event);
+          });
     }
-
-    if (!generate_summary) {
-      return;
+  } else {
+    std::vector<std::pair<uint32_t, uint64_t>> tids_and_min_timestamps;
+    tids_and_min_timestamps.reserve(new_samples_of_threads.size());
+    for (const NewSamplesOfThread& new_samples : new_samples_of_threads) {
+      tids_and_min_timestamps.emplace_back(new_samples.thread_id,
+                                           new_samples.min_unprocessed_timestamp);
     }
-    ThreadSampleData* all_thread_sample_data =
-        &thread_id_to_sample_data_[orbit_base::kAllProcessThreadsTid];
-    all_thread_sample_data->thread_id = orbit_base::kAllProcessThreadsTid;
-    all_thread_sample_data->samples_count++;
-    all_thread_sample_data->sampled_callstack_id_to_events[event.callstack_id()].emplace_back(
-        event);
-    for (size_t i = 0; i < sorted_frames.size(); ++i) {
-      if (i != 0 && sorted_frames[i] == sorted_frames[i - 1]) {
-        continue;
-      }
-      all_thread_sample_data->sampled_address_to_count[sorted_frames[i]]++;
-    }
-  });
-
-  ResolveCallstacks(callstack_data, capture_data, module_manager);
-
-  for (auto& sample_data_it : thread_id_to_sample_data_) {
-    ThreadSampleData* thread_sample_data = &sample_data_it.second;
-
-    // Address count per sample per thread
-    for (const auto& [sampled_callstack_id, callstack_events] :
-         thread_sample_data->sampled_callstack_id_to_events) {
-      uint64_t callstack_count = callstack_events.size();
-      uint64_t resolved_callstack_id = original_id_to_resolved_callstack_id_[sampled_callstack_id];
-      const CallstackInfo& resolved_callstack = id_to_resolved_callstack_.at(resolved_callstack_id);
-
-      // "Exclusive" stat.
-      ORBIT_CHECK(!resolved_callstack.frames().empty());
-      thread_sample_data->resolved_address_to_exclusive_count[resolved_callstack.frames()[0]] +=
-          callstack_count;
+    callstack_data.ForEachCallstackEventOfTidsInParallel(
+        thread_pool_, tids_and_min_timestamps,
+        [&add_callstack_event, &new_samples_of_threads](size_t i, const CallstackEvent& event) {
+          add_callstack_event(&new_samples_of_threads[i], event);
+        });
+  }
+  for (const NewSamplesOfThread& new_samples : new_samples_of_threads) {
+    thread_id_to_min_unprocessed_timestamp_[new_samples.thread_id] =
+        new_samples.min_unprocessed_timestamp;
+  }
 
-      absl::flat_hash_set<uint64_t> unique_resolved_addresses;
-      if (resolved_callstack.type() == CallstackType::kComplete) {
-        for (uint64_t resolved_address : resolved_callstack.frames()) {
-          unique_resolved_addresses.insert(resolved_address);
-        }
-      } else {
-        // For non-kComplete callstacks, only use the innermost frame for statistics.
-        unique_resolved_addresses.insert(resolved_callstack.frames()[0]);
+  if (has_summary) {
+    // The new CallstackEvents of each thread, for a given callstack, are the last ones in the
+    // corresponding vector of that thread.
+    NewSamplesOfThread summary_new_samples{
+        orbit_base::kAllProcessThreadsTid,
+        &thread_id_to_sample_data.at(orbit_base::kAllProcessThreadsTid), 0};
+    ThreadSampleData* all_thread_sample_data = summary_new_samples.thread_sample_data;
+    for (const NewSamplesOfThread& new_samples : new_samples_of_threads) {
+      all_thread_sample_data->samples_count += new_samples.new_samples_count;
+      summary_new_samples.new_samples_count += new_samples.new_samples_count;
+      for (const auto& [callstack_id, count] : new_samples.new_callstack_id_to_count) {
+        const std::vector<CallstackEvent>& callstack_events =
+            new_samples.thread_sample_data->sampled_callstack_id_to_events.at(callstack_id);
+        std::vector<CallstackEvent>& all_thread_callstack_events =
+            all_thread_sample_data->sampled_callstack_id_to_events[callstack_id];
+        all_thread_callstack_events.insert(all_thread_callstack_events.end(),
+                                           callstack_events.end() - count, callstack_events.end());
+        summary_new_samples.new_callstack_id_to_count[callstack_id] += count;
       }
+    }
+    // The summary has the most work to do, so start with it.
+    new_samples_of_threads.insert(new_samples_of_threads.begin(), std::move(summary_new_samples));
+  }
 
-      // "Inclusive" stat.
-      for (uint64_t resolved_address : unique_resolved_addresses) {
-        thread_sample_data->resolved_address_to_count[resolved_address] += callstack_count;
-      }
+  ResolveNewCallstacks(callstack_data, capture_data, module_manager);
 
-      // "Unwind errors" stat.
-      if (resolved_callstack.type() != CallstackType::kComplete) {
-        thread_sample_data->resolved_address_to_error_count[resolved_callstack.frames()[0]] +=
-            callstack_count;
-      }
+  // Only the threads with new samples need their statistics and reports to be updated.
+  RunTasks(thread_pool_, new_samples_of_threads.size(), [&](size_t i) {
+    const NewSamplesOfThread& new_samples = new_samples_of_threads[i];
+    if (new_samples.new_samples_count == 0) {
+      return;
+    }
+    ThreadSampleData* thread_sample_data = new_samples.thread_sample_data;
+    for (const auto& [sampled_callstack_id, callstack_count] :
+         new_samples.new_callstack_id_to_count) {
+      AddCallstackCountToStatistics(thread_sample_data, sampled_callstack_id, callstack_count,
+                                    callstack_data);
     }
 
     // For each thread, sort resolved (function) addresses by inclusive count.
+    thread_sample_data->sorted_count_to_resolved_address.clear();
     for (const auto& address_count_it : thread_sample_data->resolved_address_to_count) {
       const uint64_t address = address_count_it.first;
       const uint32_t count = address_count_it.second;
       thread_sample_data->sorted_count_to_resolved_address.insert(std::make_pair(count, address));
     }
-  }
 
-  FillThreadSampleDataSampleReports(capture_data, module_manager);
+    FillThreadSampleDataSampleReport(thread_sample_data, capture_data, module_manager);
+  });
 
-  return {std::move(thread_id_to_sample_data_), std::move(id_to_resolved_callstack_),
-          std::move(original_id_to_resolved_callstack_id_),
-          std::move(function_address_to_sampled_callstack_ids_)};
+  return post_processed_sampling_data_;
 }
 
-void SamplingDataPostProcessor::ResolveCallstacks(const CallstackData& callstack_data,
-                                                  const CaptureData& capture_data,
-                                                  const ModuleManager& module_manager) {
-  callstack_data.ForEachUniqueCallstack([this, &capture_data, &module_manager](
-                                            uint64_t callstack_id, const CallstackInfo& callstack) {
-    // A "resolved callstack" is a callstack where every address is replaced by the start address of
-    // the function (if known).
-    std::vector<uint64_t> resolved_callstack_frames;
-
-    for (uint64_t address : callstack.frames()) {
-      if (!exact_address_to_function_address_.contains(address)) {
-        MapAddressToFunctionAddress(address, capture_data, module_manager);
-      }
-      auto function_address_it = exact_address_to_function_address_.find(address);
-      ORBIT_CHECK(function_address_it != exact_address_to_function_address_.end());
-      resolved_callstack_frames.push_back(function_address_it->second);
+void SamplingDataPostProcessor::AddCallstackCountToStatistics(
+    ThreadSampleData* thread_sample_data, uint64_t sampled_callstack_id, uint32_t callstack_count,
+    const CallstackData& callstack_data) const {
+  const CallstackInfo* callstack_info = callstack_data.GetCallstack(sampled_callstack_id);
+  ORBIT_CHECK(callstack_info != nullptr);
+
+  std::vector<uint64_t> sorted_frames;
+  ORBIT_CHECK(!callstack_info->frames().empty());
+  if (callstack_info->type() == CallstackType::kComplete) {
+    for (uint64_t frame : callstack_info->frames()) {
+      sorted_frames.push_back(frame);
     }
+  } else {
+    // For non-kComplete callstacks, only use the innermost frame for statistics, as it's the only
+    // one known to be correct. Note that, in the vast majority of cases, the innermost frame is
+    // also the only one available.
+    sorted_frames.push_back(callstack_info->frames()[0]);
+  }
 
-    if (callstack.type() == CallstackType::kComplete) {
-      for (uint64_t function_address : resolved_callstack_frames) {
-        // Create a new entry if it doesn't exist.
-        auto it = function_address_to_sampled_callstack_ids_.try_emplace(function_address).first;
-        it->second.insert(callstack_id);
-      }
-    } else {
-      // For non-kComplete callstacks, only use the innermost frame for statistics.
-      auto it = function_address_to_sampled_callstack_ids_.try_emplace(resolved_callstack_frames[0])
-                    .first;
-      it->second.insert(callstack_id);
+  // We need to consider duplicated frames (because of recursion) only once. We should use a set
+  // for better time complexity but sorting and comparing adjacent elements is faster in practice
+  // for a number of elements in the order of the number of frames in a callstack.
+  std::sort(sorted_frames.begin(), sorted_frames.end());
+  for (size_t i = 0; i < sorted_frames.size(); ++i) {
+    if (i != 0 && sorted_frames[i] == sorted_frames[i - 1]) {
+      continue;
     }
+    thread_sample_data->sampled_address_to_count[sorted_frames[i]] += callstack_count;
+  }
 
-    CallstackType resolved_callstack_type = callstack.type();
-
-    // Check if we already have this resolved callstack, and if not, create one.
-    uint64_t resolved_callstack_id;
-    auto it = resolved_callstack_to_id_.find(CallstackInfoAsPairWithLvalueRefToFrames{
-        resolved_callstack_frames, resolved_callstack_type});
-    if (it == resolved_callstack_to_id_.end()) {
-      resolved_callstack_id = callstack_id;
-      ORBIT_CHECK(!id_to_resolved_callstack_.contains(resolved_callstack_id));
+  uint64_t resolved_callstack_id =
+      post_processed_sampling_data_.original_id_to_resolved_callstack_id_.at(sampled_callstack_id);
+  const CallstackInfo& resolved_callstack =
+      post_processed_sampling_data_.id_to_resolved_callstack_.at(resolved_callstack_id);
 
-      id_to_resolved_callstack_.emplace(
-          resolved_callstack_id, CallstackInfo{resolved_callstack_frames, resolved_callstack_type});
+  // "Exclusive" stat.
+  ORBIT_CHECK(!resolved_callstack.frames().empty());
+  thread_sample_data->resolved_address_to_exclusive_count[resolved_callstack.frames()[0]] +=
+      callstack_count;
 
-      resolved_callstack_to_id_.emplace(
-          CallstackInfo{resolved_callstack_frames, resolved_callstack_type}, resolved_callstack_id);
-    } else {
-      resolved_callstack_id = it->second;
+  absl::flat_hash_set<uint64_t> unique_resolved_addresses;
+  if (resolved_callstack.type() == CallstackType::kComplete) {
+    for (uint64_t resolved_address : resolved_callstack.frames()) {
+      unique_resolved_addresses.insert(resolved_address);
     }
+  } else {
+    // For non-kComplete callstacks, only use the innermost frame for statistics.
+    unique_resolved_addresses.insert(resolved_callstack.frames()[0]);
+  }
 
-    original_id_to_resolved_callstack_id_[callstack_id] = resolved_callstack_id;
-  });
+  // "Inclusive" stat.
+  for (uint64_t resolved_address : unique_resolved_addresses) {
+    thread_sample_data->resolved_address_to_count[resolved_address] += callstack_count;
+  }
+
+  // "Unwind errors" stat.
+  if (resolved_callstack.type() != CallstackType::kComplete) {
+    thread_sample_data->resolved_address_to_error_count[resolved_callstack.frames()[0]] +=
+        callstack_count;
+  }
 }
 
-void SamplingDataPostProcessor::MapAddressToFunctionAddress(uint64_t absolute_address,
-                                                            const CaptureData& capture_data,
-                                                            const ModuleManager& module_manager) {
-  // SamplingDataPostProcessor relies heavily on the association between address and function
-  // address held by exact_address_to_function_address_, otherwise each address is considered a
-  // different function. We are storing this mapping for faster lookup.
-  std::optional<uint64_t> absolute_function_address_option =
-      orbit_client_data::FindFunctionAbsoluteAddressByInstructionAbsoluteAddress(
-          module_manager, capture_data, absolute_address);
-  uint64_t absolute_function_address = absolute_function_address_option.value_or(absolute_address);
+void SamplingDataPostProcessor::ResolveNewCallstacks(const CallstackData& callstack_data,
+                                                     const CaptureData& capture_data,
+                                                     const ModuleManager& module_manager) {
+  // The callstacks are copied, as they could be replaced once the lock is released.
+  std::vector<std::pair<uint64_t, CallstackInfo>> new_callstacks;
+  callstack_data.ForEachUniqueCallstack(
+      [this, &new_callstacks](uint64_t callstack_id, const CallstackInfo& callstack) {
+        if (!post_processed_sampling_data_.original_id_to_resolved_callstack_id_.contains(
+                callstack_id)) {
+          new_callstacks.emplace_back(callstack_id, callstack);
+        }
+      });
+
+  // A "resolved callstack" is a callstack where every address is replaced by the start address of
+  // the function (if known). Resolving the frames is independent for each callstack, so it is done
+  // by chunks of callstacks in parallel. Each chunk only reads the addresses already mapped to
+  // their function addresses, and maps the others separately.
+  constexpr size_t kCallstacksPerTask = 1024;
+  const size_t task_count = (new_callstacks.size() + kCallstacksPerTask - 1) / kCallstacksPerTask;
+  std::vector<std::vector<uint64_t>> resolved_callstack_frames(new_callstacks.size());
+  std::vector<absl::flat_hash_map<uint64_t, uint64_t>> new_address_to_function_address(task_count);
+  RunTasks(thread_pool_, task_count, [&](size_t task_index) {
+    absl::flat_hash_map<uint64_t, uint64_t>& new_address_to_function_address_of_task =
+        new_address_to_function_address[task_index];
+    const size_t end = std::min(new_callstacks.size(), (task_index + 1) * kCallstacksPerTask);
+    for (size_t i = task_index * kCallstacksPerTask; i < end; ++i) {
+      for (uint64_t address : new_callstacks[i].second.frames()) {
+        // SamplingDataPostProcessor relies heavily on the association between address and
+        // function address, otherwise each address is considered a different function. We are
+        // storing this mapping for faster lookup.
+        if (auto it = exact_address_to_function_address_.find(address);
+            it != exact_address_to_function_address_.end()) {
+          resolved_callstack_frames[i].push_back(it->second);
+          continue;
+        }
+        auto [it, inserted] = new_address_to_function_address_of_task.try_emplace(address);
+        if (inserted) {
+          it->second = FindFunctionAddress(address, capture_data, module_manager);
+        }
+        resolved_callstack_frames[i].push_back(it->second);
+      }
+    }
+  });
+  for (const absl::flat_hash_map<uint64_t, uint64_t>& new_address_to_function_address_of_task :
+       new_address_to_function_address) {
+    exact_address_to_function_address_.insert(new_address_to_function_address_of_task.begin(),
+                                               new_address_to_function_address_of_task.end());
+  }
 
-  exact_address_to_function_address_[absolute_address] = absolute_function_address;
+  // The id of a resolved callstack is the id of the first callstack that resolves to it, so these
+  // are added in order.
+  for (size_t i = 0; i < new_callstacks.size(); ++i) {
+    AddResolvedCallstack(new_callstacks[i].first, new_callstacks[i].second,
+                         std::move(resolved_callstack_frames[i]));
+  }
 }
 
-void SamplingDataPostProcessor::FillThreadSampleDataSampleReports(
-    const CaptureData& capture_data, const ModuleManager& module_manager) {
-  for (auto& data : thread_id_to_sample_data_) {
-    ThreadSampleData* thread_sample_data = &data.second;
-    std::vector<SampledFunction>* sampled_functions = &thread_sample_data->sampled_functions;
+void SamplingDataPostProcessor::AddResolvedCallstack(
+    uint64_t callstack_id, const CallstackInfo& callstack,
+    std::vector<uint64_t> resolved_callstack_frames) {
+  absl::flat_hash_map<uint64_t, CallstackInfo>& id_to_resolved_callstack =
+      post_processed_sampling_data_.id_to_resolved_callstack_;
+  absl::flat_hash_map<uint64_t, absl::flat_hash_set<uint64_t>>&
+      function_address_to_sampled_callstack_ids =
+          post_processed_sampling_data_.function_address_to_sampled_callstack_ids_;
+
+  if (callstack.type() == CallstackType::kComplete) {
+    for (uint64_t function_address : resolved_callstack_frames) {
+      // Create a new entry if it doesn't exist.
+      auto it = function_address_to_sampled_callstack_ids.try_emplace(function_address).first;
+      it->second.insert(callstack_id);
+    }
+  } else {
+    // For non-kComplete callstacks, only use the innermost frame for statistics.
+    auto it = function_address_to_sampled_callstack_ids.try_emplace(resolved_callstack_frames[0])
+                  .first;
+    it->second.insert(callstack_id);
+  }
 
-    for (auto sorted_it = thread_sample_data->sorted_count_to_resolved_address.rbegin();
-         sorted_it != thread_sample_data->sorted_count_to_resolved_address.rend(); ++sorted_it) {
-      uint32_t num_occurrences = sorted_it->first;
-      uint64_t absolute_address = sorted_it->second;
+  CallstackType resolved_callstack_type = callstack.type();
 
-      SampledFunction function;
-      function.name = orbit_client_data::GetFunctionNameByAddress(module_manager, capture_data,
-                                                                  absolute_address);
+  // Check if we already have this resolved callstack, and if not, create one.
+  uint64_t resolved_callstack_id;
+  auto it = resolved_callstack_to_id_.find(CallstackInfoAsPairWithLvalueRefToFrames{
+      resolved_callstack_frames, resolved_callstack_type});
+  if (it == resolved_callstack_to_id_.end()) {
+    resolved_callstack_id = callstack_id;
+    ORBIT_CHECK(!id_to_resolved_callstack.contains(resolved_callstack_id));
 
-      function.inclusive = num_occurrences;
-      function.inclusive_percent = 100.f * num_occurrences / thread_sample_data->samples_count;
+    id_to_resolved_callstack.emplace(
+        resolved_callstack_id, CallstackInfo{resolved_callstack_frames, resolved_callstack_type});
 
-      function.exclusive = 0;
-      function.exclusive_percent = 0.f;
+    resolved_callstack_to_id_.emplace(
+        CallstackInfo{std::move(resolved_callstack_frames), resolved_callstack_type},
+        resolved_callstack_id);
+  } else {
+    resolved_callstack_id = it->second;
+  }
 
-      if (auto it = thread_sample_data->resolved_address_to_exclusive_count.find(absolute_address);
-          it != thread_sample_data->resolved_address_to_exclusive_count.end()) {
-        function.exclusive = it->second;
-        function.exclusive_percent = 100.f * it->second / thread_sample_data->samples_count;
-      }
+  post_processed_sampling_data_.original_id_to_resolved_callstack_id_[callstack_id] =
+      resolved_callstack_id;
+}
 
-      function.unwind_errors = 0;
-      function.unwind_errors_percent = 0.f;
-      if (auto it = thread_sample_data->resolved_address_to_error_count.find(absolute_address);
-          it != thread_sample_data->resolved_address_to_error_count.end()) {
-        function.unwind_errors = it->second;
-        // We only write the innermost frame into "resolved_address_to_error_count", so we get the
-        // sum of all samples with unwinding errors by computing the sum of errors per function.
-        thread_sample_data->unwinding_errors_count += function.unwind_errors;
-        function.unwind_errors_percent = 100.f * it->second / thread_sample_data->samples_count;
-      }
-      function.absolute_address = absolute_address;
-      function.module_path =
-          orbit_client_data::GetModulePathByAddress(module_manager, capture_data, absolute_address);
+void SamplingDataPostProcessor::FillThreadSampleDataSampleReport(
+    ThreadSampleData* thread_sample_data, const CaptureData& capture_data,
+    const ModuleManager& module_manager) {
+  std::vector<SampledFunction>* sampled_functions = &thread_sample_data->sampled_functions;
+  sampled_functions->clear();
+  thread_sample_data->unwinding_errors_count = 0;
+
+  for (auto sorted_it = thread_sample_data->sorted_count_to_resolved_address.rbegin();
+       sorted_it != thread_sample_data->sorted_count_to_resolved_address.rend(); ++sorted_it) {
+    uint32_t num_occurrences = sorted_it->first;
+    uint64_t absolute_address = sorted_it->second;
+
+    SampledFunction function;
+    function.name = orbit_client_data::GetFunctionNameByAddress(module_manager, capture_data,
+                                                                absolute_address);
+
+    function.inclusive = num_occurrences;
+    function.inclusive_percent = 100.f * num_occurrences / thread_sample_data->samples_count;
+
+    function.exclusive = 0;
+    function.exclusive_percent = 0.f;
 
-      sampled_functions->push_back(function);
+    if (auto it = thread_sample_data->resolved_address_to_exclusive_count.find(absolute_address);
+        it != thread_sample_data->resolved_address_to_exclusive_count.end()) {
+      function.exclusive = it->second;
+      function.exclusive_percent = 100.f * it->second / thread_sample_data->samples_count;
     }
+
+    function.unwind_errors = 0;
+    function.unwind_errors_percent = 0.f;
+    if (auto it = thread_sample_data->resolved_address_to_error_count.find(absolute_address);
+        it != thread_sample_data->resolved_address_to_error_count.end()) {
+      function.unwind_errors = it->second;
+      // We only write the innermost frame into "resolved_address_to_error_count", so we get the
+      // sum of all samples with unwinding errors by computing the sum of errors per function.
+      thread_sample_data->unwinding_errors_count += function.unwind_errors;
+      function.unwind_errors_percent = 100.f * it->second / thread_sample_data->samples_count;
+    }
+    function.absolute_address = absolute_address;
+    function.module_path =
+        orbit_client_data::GetModulePathByAddress(module_manager, capture_data, absolute_address);
+
+    sampled_functions->push_back(function);
   }
 }
 
-}  // namespace
-
 }  // namespace orbit_client_model
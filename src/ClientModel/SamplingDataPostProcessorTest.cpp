@@ -3,9 +3,17 @@
 // found in the LICENSE file.
 
 #include <absl/container/flat_hash_set.h>
+#include <absl/strings/str_format.h>
+#include <absl/time/clock.h>
+#include <absl/time/time.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #include "ClientData/CallstackEvent.h"
@@ -16,8 +24,10 @@
 #include "ClientData/ModuleManager.h"
 #include "ClientModel/SamplingDataPostProcessor.h"
 #include "ClientProtos/capture_data.pb.h"
+#include "OrbitBase/Logging.h"
 #include "OrbitBase/Sort.h"
 #include "OrbitBase/ThreadConstants.h"
+#include "OrbitBase/ThreadPool.h"
 
 using orbit_client_data::CallstackCount;
 using orbit_client_data::CallstackEvent;
@@ -1848,4 +1858,307 @@ TEST_F(SamplingDataPostProcessorTest, TwoThreadsWithSummaryWithMixedCallstackTyp
   VerifyEmptySortedCallstackReport(kThreadIdNotSampled);
 }
 
+TEST_F(SamplingDataPostProcessorTest, OneThreadWithSummaryProcessedIncrementally) {
+  AddAllCallstackInfos(CallstackType::kComplete);
+  AddAllAddressInfos();
+
+  ModuleManager module_manager{};
+  SamplingDataPostProcessor processor{/*generate_summary=*/true};
+  EXPECT_EQ(processor
+                .ProcessNewSamples(capture_data_.GetCallstackData(), capture_data_, module_manager)
+                .GetSummary(),
+            nullptr);
+
+  // Same CallstackEvents as AddCallstackEventsAllInThreadId1, split in two batches.
+  AddCallstackEvent(kCallstack1Id, kThreadId1);
+  AddCallstackEvent(kCallstack1Id, kThreadId1);
+  AddCallstackEvent(kCallstack2Id, kThreadId1);
+  const ThreadSampleData* partial_thread_sample_data =
+      processor.ProcessNewSamples(capture_data_.GetCallstackData(), capture_data_, module_manager)
+          .GetThreadSampleDataByThreadId(kThreadId1);
+  ASSERT_NE(partial_thread_sample_data, nullptr);
+  EXPECT_EQ(partial_thread_sample_data->samples_count, 3);
+
+  AddCallstackEvent(kCallstack3Id, kThreadId1);
+  AddCallstackEvent(kCallstack4Id, kThreadId1);
+  processor.ProcessNewSamples(capture_data_.GetCallstackData(), capture_data_, module_manager);
+  // Without new CallstackEvents, nothing must be counted twice.
+  processor.ProcessNewSamples(capture_data_.GetCallstackData(), capture_data_, module_manager);
+  ppsd_ = std::move(processor).TakePostProcessedSamplingData();
+
+  VerifyAllCallstackInfos(CallstackType::kComplete);
+
+  EXPECT_EQ(ppsd_.GetSortedThreadSampleData().size(), 2);
+  ASSERT_NE(ppsd_.GetSummary(), nullptr);
+  ASSERT_NE(ppsd_.GetThreadSampleDataByThreadId(kThreadId1), nullptr);
+
+  VerifyThreadSampleDataForCallstackEventsAllInTheSameThread(*ppsd_.GetSummary(),
+                                                             orbit_base::kAllProcessThreadsTid);
+  VerifyThreadSampleDataForCallstackEventsAllInTheSameThread(
+      *ppsd_.GetThreadSampleDataByThreadId(kThreadId1), kThreadId1);
+
+  VerifyGetCountOfFunction();
+
+  VerifySortedCallstackReportForCallstackEventsAllInTheSameThread(
+      orbit_base::kAllProcessThreadsTid);
+  VerifySortedCallstackReportForCallstackEventsAllInTheSameThread(kThreadId1);
+  VerifyEmptySortedCallstackReport(kThreadIdNotSampled);
+}
+
+TEST_F(SamplingDataPostProcessorTest, TwoThreadsWithMixedCallstackTypesProcessedIncrementally) {
+  AddAllCallstackInfosWithMixedCallstackTypes();
+  AddAllAddressInfos();
+
+  ModuleManager module_manager{};
+  SamplingDataPostProcessor processor{/*generate_summary=*/true};
+
+  // Same CallstackEvents as AddCallstackEventsInThreadId1And2, one thread at a time.
+  AddCallstackEvent(kCallstack1Id, kThreadId1);
+  AddCallstackEvent(kCallstack2Id, kThreadId1);
+  processor.ProcessNewSamples(capture_data_.GetCallstackData(), capture_data_, module_manager);
+  EXPECT_EQ(processor.GetPostProcessedSamplingData().GetThreadSampleDataByThreadId(kThreadId2),
+            nullptr);
+
+  AddCallstackEvent(kCallstack1Id, kThreadId2);
+  AddCallstackEvent(kCallstack3Id, kThreadId2);
+  AddCallstackEvent(kCallstack4Id, kThreadId2);
+  ppsd_ = processor.ProcessNewSamples(capture_data_.GetCallstackData(), capture_data_,
+                                      module_manager);
+
+  VerifyAllCallstackInfosWithMixedCallstackTypes();
+
+  EXPECT_EQ(ppsd_.GetSortedThreadSampleData().size(), 3);
+  ASSERT_NE(ppsd_.GetSummary(), nullptr);
+  ASSERT_NE(ppsd_.GetThreadSampleDataByThreadId(kThreadId1), nullptr);
+  ASSERT_NE(ppsd_.GetThreadSampleDataByThreadId(kThreadId2), nullptr);
+
+  VerifyThreadSampleDataForCallstackEventsInThreadId1And2WithMixedCallstackTypes(
+      *ppsd_.GetSummary(), orbit_base::kAllProcessThreadsTid);
+  VerifyThreadSampleDataForCallstackEventsInThreadId1WithMixedCallstackTypes(
+      *ppsd_.GetThreadSampleDataByThreadId(kThreadId1));
+  VerifyThreadSampleDataForCallstackEventsInThreadId2WithMixedCallstackTypes(
+      *ppsd_.GetThreadSampleDataByThreadId(kThreadId2));
+
+  VerifyGetCountOfFunctionWithMixedCallstackTypes();
+
+  VerifySortedCallstackReportForCallstackEventsAllInTheSameThreadWithMixedCallstackTypes(
+      orbit_base::kAllProcessThreadsTid);
+  VerifySortedCallstackReportForCallstackEventsInThreadId1WithMixedCallstackTypes();
+  VerifySortedCallstackReportForCallstackEventsInThreadId2WithMixedCallstackTypes();
+}
+
+namespace {
+
+// Deterministic pseudo-random capture. Each function has several instructions, some of the
+// callstacks are unwinding errors, and the samples are spread over `thread_count` threads.
+class SyntheticCapture {
+ public:
+  static constexpr uint64_t kFunctionCount = 1000;
+  static constexpr uint64_t kInstructionCountPerFunction = 4;
+  static constexpr uint64_t kCallstackDepth = 20;
+
+  SyntheticCapture(uint32_t thread_count, uint64_t callstack_count)
+      : thread_count_{thread_count}, callstack_count_{callstack_count} {
+    for (uint64_t function = 0; function < kFunctionCount; ++function) {
+      for (uint64_t offset = 0; offset < kInstructionCountPerFunction; ++offset) {
+        capture_data_.InsertAddressInfo(
+            LinuxAddressInfo{GetFunctionAddress(function) + offset, offset, "/path/to/module",
+                             absl::StrFormat("function%d", function)});
+      }
+    }
+    for (uint64_t callstack_id = 0; callstack_id < callstack_count_; ++callstack_id) {
+      std::vector<uint64_t> frames(kCallstackDepth);
+      for (uint64_t depth = 0; depth < kCallstackDepth; ++depth) {
+        // Outermost frames are shared more often than innermost ones, as in real callstacks.
+        const uint64_t function_range = 1 + kFunctionCount * depth / kCallstackDepth;
+        frames[kCallstackDepth - 1 - depth] = GetFunctionAddress(NextRandom() % function_range) +
+                                              NextRandom() % kInstructionCountPerFunction;
+      }
+      const CallstackType type = callstack_id % 10 == 0 ? CallstackType::kDwarfUnwindingError
+                                                        : CallstackType::kComplete;
+      capture_data_.AddUniqueCallstack(callstack_id, CallstackInfo{std::move(frames), type});
+    }
+  }
+
+  void AddSamples(uint64_t sample_count) {
+    for (uint64_t sample = 0; sample < sample_count; ++sample) {
+      capture_data_.AddCallstackEvent({next_timestamp_ns_++, NextRandom() % callstack_count_,
+                                       static_cast<uint32_t>(NextRandom() % thread_count_ + 1)});
+    }
+  }
+
+  [[nodiscard]] const CaptureData& capture_data() const { return capture_data_; }
+
+  [[nodiscard]] static uint64_t GetFunctionAddress(uint64_t function) {
+    return 0x1000 * (function + 1);
+  }
+
+ private:
+  uint64_t NextRandom() {
+    random_state_ = random_state_ * 6364136223846793005 + 1442695040888963407;
+    return random_state_ >> 33;
+  }
+
+  const uint32_t thread_count_;
+  const uint64_t callstack_count_;
+  CaptureData capture_data_{CaptureStarted{}, std::filesystem::path{},
+                            absl::flat_hash_set<uint64_t>{}, CaptureData::DataSource::kLiveCapture};
+  uint64_t next_timestamp_ns_ = 0;
+  uint64_t random_state_ = 1;
+};
+
+void ExpectSameThreadSampleData(const ThreadSampleData& actual, const ThreadSampleData& expected) {
+  EXPECT_EQ(actual.thread_id, expected.thread_id);
+  EXPECT_EQ(actual.samples_count, expected.samples_count);
+  EXPECT_EQ(actual.unwinding_errors_count, expected.unwinding_errors_count);
+  EXPECT_TRUE(actual.sampled_callstack_id_to_events == expected.sampled_callstack_id_to_events);
+  EXPECT_EQ(actual.sampled_address_to_count, expected.sampled_address_to_count);
+  EXPECT_EQ(actual.resolved_address_to_count, expected.resolved_address_to_count);
+  EXPECT_EQ(actual.resolved_address_to_exclusive_count,
+            expected.resolved_address_to_exclusive_count);
+  EXPECT_EQ(actual.resolved_address_to_error_count, expected.resolved_address_to_error_count);
+
+  // Functions with the same count are in no particular order.
+  auto sorted_counts = [](const ThreadSampleData& thread_sample_data) {
+    std::vector<std::pair<uint32_t, uint64_t>> counts_and_addresses(
+        thread_sample_data.sorted_count_to_resolved_address.begin(),
+        thread_sample_data.sorted_count_to_resolved_address.end());
+    std::sort(counts_and_addresses.begin(), counts_and_addresses.end());
+    return counts_and_addresses;
+  };
+  EXPECT_EQ(sorted_counts(actual), sorted_counts(expected));
+
+  auto sorted_functions = [](const ThreadSampleData& thread_sample_data) {
+    std::vector<SampledFunction> sampled_functions = thread_sample_data.sampled_functions;
+    orbit_base::sort(sampled_functions.begin(), sampled_functions.end(),
+                     [](const SampledFunction& function) {
+                       return std::make_tuple(function.inclusive, function.absolute_address);
+                     });
+    return sampled_functions;
+  };
+  const std::vector<SampledFunction> actual_functions = sorted_functions(actual);
+  const std::vector<SampledFunction> expected_functions = sorted_functions(expected);
+  ASSERT_EQ(actual_functions.size(), expected_functions.size());
+  for (size_t i = 0; i < actual_functions.size(); ++i) {
+    EXPECT_THAT(actual_functions[i], SampledFunctionEq(expected_functions[i]));
+  }
+}
+
+void ExpectSamePostProcessedSamplingData(const PostProcessedSamplingData& actual,
+                                         const PostProcessedSamplingData& expected,
+                                         const CaptureData& capture_data) {
+  const std::vector<const ThreadSampleData*> expected_thread_sample_data =
+      expected.GetSortedThreadSampleData();
+  ASSERT_EQ(actual.GetSortedThreadSampleData().size(), expected_thread_sample_data.size());
+  EXPECT_EQ(actual.GetSummary() == nullptr, expected.GetSummary() == nullptr);
+  for (const ThreadSampleData* expected_thread : expected_thread_sample_data) {
+    const ThreadSampleData* actual_thread =
+        actual.GetThreadSampleDataByThreadId(expected_thread->thread_id);
+    ASSERT_NE(actual_thread, nullptr);
+    ExpectSameThreadSampleData(*actual_thread, *expected_thread);
+  }
+
+  capture_data.GetCallstackData().ForEachUniqueCallstack(
+      [&actual, &expected](uint64_t callstack_id, const CallstackInfo& /*callstack*/) {
+        EXPECT_EQ(actual.GetResolvedCallstack(callstack_id),
+                  expected.GetResolvedCallstack(callstack_id));
+      });
+
+  for (uint64_t function = 0; function < SyntheticCapture::kFunctionCount; ++function) {
+    const uint64_t function_address = SyntheticCapture::GetFunctionAddress(function);
+    EXPECT_EQ(actual.GetCountOfFunction(function_address),
+              expected.GetCountOfFunction(function_address));
+    for (const ThreadSampleData* expected_thread : expected_thread_sample_data) {
+      EXPECT_THAT(*actual.GetSortedCallstackReportFromFunctionAddresses(
+                      {function_address}, expected_thread->thread_id),
+                  SortedCallstackReportEq(*expected.GetSortedCallstackReportFromFunctionAddresses(
+                      {function_address}, expected_thread->thread_id)));
+    }
+  }
+}
+
+}  // namespace
+
+TEST(SamplingDataPostProcessor, ProcessingInParallelGivesSameResultAsSerially) {
+  std::shared_ptr<orbit_base::ThreadPool> thread_pool =
+      orbit_base::ThreadPool::Create(4, 4, absl::Seconds(1));
+
+  for (bool generate_summary : {false, true}) {
+    SyntheticCapture capture{/*thread_count=*/8, /*callstack_count=*/300};
+    const CaptureData& capture_data = capture.capture_data();
+    ModuleManager module_manager;
+
+    // When processed in two steps, the CallstackEvents of the summary are in a different order
+    // than when processed at once, so each is compared to the serial processor of the same kind.
+    SamplingDataPostProcessor incremental_serial_processor{generate_summary};
+    SamplingDataPostProcessor incremental_parallel_processor{generate_summary, thread_pool.get()};
+    for (int step = 0; step < 2; ++step) {
+      capture.AddSamples(10'000);
+      incremental_serial_processor.ProcessNewSamples(capture_data.GetCallstackData(),
+                                                     capture_data, module_manager);
+      incremental_parallel_processor.ProcessNewSamples(capture_data.GetCallstackData(),
+                                                       capture_data, module_manager);
+      ExpectSamePostProcessedSamplingData(
+          incremental_parallel_processor.GetPostProcessedSamplingData(),
+          incremental_serial_processor.GetPostProcessedSamplingData(), capture_data);
+    }
+
+    SamplingDataPostProcessor serial_processor{generate_summary};
+    serial_processor.ProcessNewSamples(capture_data.GetCallstackData(), capture_data,
+                                       module_manager);
+    SamplingDataPostProcessor parallel_processor{generate_summary, thread_pool.get()};
+    parallel_processor.ProcessNewSamples(capture_data.GetCallstackData(), capture_data,
+                                         module_manager);
+
+    EXPECT_EQ(serial_processor.GetPostProcessedSamplingData().GetSortedThreadSampleData().size(),
+              generate_summary ? 9 : 8);
+    ExpectSamePostProcessedSamplingData(parallel_processor.GetPostProcessedSamplingData(),
+                                        serial_processor.GetPostProcessedSamplingData(),
+                                        capture_data);
+  }
+
+  thread_pool->ShutdownAndWait();
+}
+
+// Logs how long processing a large synthetic capture takes, serially and on a ThreadPool. Disabled
+// as it takes long, run it with --gtest_also_run_disabled_tests.
+TEST(SamplingDataPostProcessor, DISABLED_BenchmarkProcessSamples) {
+  // A capture of 50M samples takes more memory than is available on test machines, but the time
+  // grows linearly with the number of samples.
+  constexpr uint32_t kThreadCount = 32;
+  constexpr uint64_t kCallstackCount = 5000;
+  constexpr uint64_t kSampleCount = 5'000'000;
+  SyntheticCapture capture{kThreadCount, kCallstackCount};
+  capture.AddSamples(kSampleCount);
+  const CaptureData& capture_data = capture.capture_data();
+  ModuleManager module_manager;
+
+  absl::Time start = absl::Now();
+  uint32_t serial_samples_count =
+      SamplingDataPostProcessor{}
+          .ProcessNewSamples(capture_data.GetCallstackData(), capture_data, module_manager)
+          .GetSummary()
+          ->samples_count;
+  const absl::Duration serial_duration = absl::Now() - start;
+  EXPECT_EQ(serial_samples_count, kSampleCount);
+
+  const size_t thread_count = std::max<size_t>(1, std::thread::hardware_concurrency());
+  std::shared_ptr<orbit_base::ThreadPool> thread_pool =
+      orbit_base::ThreadPool::Create(thread_count, thread_count, absl::Seconds(1));
+  start = absl::Now();
+  uint32_t parallel_samples_count =
+      SamplingDataPostProcessor{/*generate_summary=*/true, thread_pool.get()}
+          .ProcessNewSamples(capture_data.GetCallstackData(), capture_data, module_manager)
+          .GetSummary()
+          ->samples_count;
+  const absl::Duration parallel_duration = absl::Now() - start;
+  thread_pool->ShutdownAndWait();
+  EXPECT_EQ(parallel_samples_count, kSampleCount);
+
+  ORBIT_LOG("Processed %u samples in %u threads: serially in %.1f ms, in parallel with %u threads "
+            "in %.1f ms",
+            kSampleCount, kThreadCount, absl::ToDoubleMilliseconds(serial_duration), thread_count,
+            absl::ToDoubleMilliseconds(parallel_duration));
+}
+
 }  // namespace orbit_client_model
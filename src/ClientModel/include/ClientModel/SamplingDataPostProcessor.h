@@ -5,16 +5,138 @@
 #ifndef CLIENT_MODEL_SAMPLING_DATA_POST_PROCESSOR_H_
 #define CLIENT_MODEL_SAMPLING_DATA_POST_PROCESSOR_H_
 
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
+#include <absl/hash/hash.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include "ClientData/CallstackData.h"
+#include "ClientData/CallstackInfo.h"
+#include "ClientData/CallstackType.h"
 #include "ClientData/CaptureData.h"
 #include "ClientData/ModuleManager.h"
 #include "ClientData/PostProcessedSamplingData.h"
+#include "OrbitBase/ThreadPool.h"
+
+namespace orbit_client_model_internal {
+
+using CallstackInfoAsPairWithLvalueRefToFrames =
+    std::pair<const std::vector<uint64_t>&, orbit_client_data::CallstackType>;
+
+// CallstackInfoHash and CallstackInfoEq allow heterogeneous lookup in
+// SamplingDataPostProcessor::resolved_callstack_to_id_;
+struct CallstackInfoHash {
+  using is_transparent = void;  // Makes this functor transparent, enabling heterogeneous lookup.
+
+  size_t operator()(const orbit_client_data::CallstackInfo& o) const {
+    return absl::Hash<orbit_client_data::CallstackInfo>{}(o);
+  }
+
+  size_t operator()(const CallstackInfoAsPairWithLvalueRefToFrames& p) const {
+    return absl::Hash<CallstackInfoAsPairWithLvalueRefToFrames>{}(p);
+  }
+};
+
+struct CallstackInfoEq {
+  using is_transparent = void;  // Makes this functor transparent, enabling heterogeneous lookup.
+
+  bool operator()(const orbit_client_data::CallstackInfo& lhs,
+                  const orbit_client_data::CallstackInfo& rhs) const {
+    return std::equal(lhs.frames().begin(), lhs.frames().end(), rhs.frames().begin(),
+                      rhs.frames().end()) &&
+           lhs.type() == rhs.type();
+  }
+
+  bool operator()(const orbit_client_data::CallstackInfo& lhs,
+                  const CallstackInfoAsPairWithLvalueRefToFrames& rhs) const {
+    return std::equal(lhs.frames().begin(), lhs.frames().end(), rhs.first.begin(),
+                      rhs.first.end()) &&
+           lhs.type() == rhs.second;
+  }
+};
+
+}  // namespace orbit_client_model_internal
 
 namespace orbit_client_model {
+
+// Computes PostProcessedSamplingData from the CallstackEvents of a CallstackData, and keeps it up
+// to date as more CallstackEvents are added to the CallstackData. Each call to ProcessNewSamples
+// only processes the CallstackEvents of each thread that are newer than the newest one processed
+// by the previous call, and reuses the callstacks and the addresses already resolved. Updating the
+// result then takes time proportional to the new samples, rather than to the whole capture.
+//
+// This relies on the CallstackEvents of each thread being added in increasing order of timestamp,
+// and on the callstacks and symbols that have already been processed not changing. In particular,
+// after UpdateCallstackTypeBasedOnMajorityStart or after loading symbols, a new
+// SamplingDataPostProcessor needs to be used. The same CallstackData, CaptureData and
+// ModuleManager must be passed to every call.
+//
+// If a ThreadPool is passed, the CallstackEvents of different threads, and the new callstacks, are
+// processed in parallel on it. Only the summary of all threads, and the deduplication of resolved
+// callstacks, are done serially, in the same order as without ThreadPool, so that the result is
+// the same.
+class SamplingDataPostProcessor {
+ public:
+  explicit SamplingDataPostProcessor(bool generate_summary = true,
+                                     orbit_base::ThreadPool* thread_pool = nullptr)
+      : generate_summary_{generate_summary}, thread_pool_{thread_pool} {}
+
+  const orbit_client_data::PostProcessedSamplingData& ProcessNewSamples(
+      const orbit_client_data::CallstackData& callstack_data,
+      const orbit_client_data::CaptureData& capture_data,
+      const orbit_client_data::ModuleManager& module_manager);
+
+  [[nodiscard]] const orbit_client_data::PostProcessedSamplingData& GetPostProcessedSamplingData()
+      const {
+    return post_processed_sampling_data_;
+  }
+
+  [[nodiscard]] orbit_client_data::PostProcessedSamplingData TakePostProcessedSamplingData() && {
+    return std::move(post_processed_sampling_data_);
+  }
+
+ private:
+  void ResolveNewCallstacks(const orbit_client_data::CallstackData& callstack_data,
+                            const orbit_client_data::CaptureData& capture_data,
+                            const orbit_client_data::ModuleManager& module_manager);
+
+  void AddResolvedCallstack(uint64_t callstack_id,
+                            const orbit_client_data::CallstackInfo& callstack,
+                            std::vector<uint64_t> resolved_callstack_frames);
+
+  void AddCallstackCountToStatistics(orbit_client_data::ThreadSampleData* thread_sample_data,
+                                     uint64_t sampled_callstack_id, uint32_t callstack_count,
+                                     const orbit_client_data::CallstackData& callstack_data) const;
+
+  static void FillThreadSampleDataSampleReport(
+      orbit_client_data::ThreadSampleData* thread_sample_data,
+      const orbit_client_data::CaptureData& capture_data,
+      const orbit_client_data::ModuleManager& module_manager);
+
+  bool generate_summary_;
+  orbit_base::ThreadPool* thread_pool_;
+  orbit_client_data::PostProcessedSamplingData post_processed_sampling_data_;
+
+  absl::flat_hash_map<orbit_client_data::CallstackInfo, uint64_t,
+                      orbit_client_model_internal::CallstackInfoHash,
+                      orbit_client_model_internal::CallstackInfoEq>
+      resolved_callstack_to_id_;
+  absl::flat_hash_map<uint64_t, uint64_t> exact_address_to_function_address_;
+  // For each thread, the CallstackEvents with a timestamp lower than this have been processed.
+  absl::flat_hash_map<uint32_t, uint64_t> thread_id_to_min_unprocessed_timestamp_;
+};
+
+// Processes all the CallstackEvents of `callstack_data` at once, in parallel on `thread_pool` unless
+// it is nullptr.
 orbit_client_data::PostProcessedSamplingData CreatePostProcessedSamplingData(
     const orbit_client_data::CallstackData& callstack_data,
     const orbit_client_data::CaptureData& capture_data,
-    const orbit_client_data::ModuleManager& module_manager, bool generate_summary = true);
+    const orbit_client_data::ModuleManager& module_manager, bool generate_summary = true,
+    orbit_base::ThreadPool* thread_pool = nullptr);
 }  // namespace orbit_client_model
 
 #endif  // CLIENT_MODEL_SAMPLING_DATA_POST_PROCESSOR_H_
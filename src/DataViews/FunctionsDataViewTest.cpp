@@ -19,6 +19,7 @@
 #include "GrpcProtos/process.pb.h"
 #include "MetricsUploader/MetricsUploaderStub.h"
 #include "MockAppInterface.h"
+#include "OrbitBase/SimpleExecutor.h"
 
 using orbit_client_data::CaptureData;
 using orbit_client_data::FunctionInfo;
@@ -712,4 +713,55 @@ TEST_F(FunctionsDataViewTest, FilteringByFunctionAndModuleName) {
   // No results when joining the tokens
   view_.OnFilter("ffindfoomodule");
   EXPECT_EQ(view_.GetNumElements(), 0);
-}
\ No newline at end of file
+}
+TEST_F(FunctionsDataViewTest, FilteringGivesTheSameResultsBeforeAndAfterTheSearchIndexIsBuilt) {
+  // This functionality is not tested in this test case.
+  EXPECT_CALL(app_, IsFunctionSelected(testing::A<const FunctionInfo&>()))
+      .Times(testing::AnyNumber())
+      .WillRepeatedly(testing::Return(false));
+
+  // This functionality is not tested in this test case.
+  EXPECT_CALL(app_, IsFrameTrackEnabled)
+      .Times(testing::AnyNumber())
+      .WillRepeatedly(testing::Return(false));
+
+  // This functionality is not tested in this test case.
+  EXPECT_CALL(app_, HasCaptureData)
+      .Times(testing::AnyNumber())
+      .WillRepeatedly(testing::Return(false));
+
+  std::shared_ptr<orbit_base::SimpleExecutor> executor = orbit_base::SimpleExecutor::Create();
+  orbit_data_views::FunctionsDataView view{&app_, &metrics_uploader_, executor.get()};
+  view.Init();
+  view.AddFunctions(
+      {&functions_[0], &functions_[1], &functions_[2], &functions_[3], &functions_[4]});
+
+  const auto get_filter_result = [&view](const std::string& filter) {
+    view.OnFilter(filter);
+    std::vector<std::string> names;
+    for (size_t row = 0; row < view.GetNumElements(); ++row) {
+      names.push_back(view.GetValue(row, 1));
+    }
+    return names;
+  };
+
+  // The search index has not been built yet, so the functions are scanned.
+  EXPECT_THAT(get_filter_result("FOOMODULE"), testing::ElementsAre(functions_[3].pretty_name()));
+  EXPECT_THAT(get_filter_result("in ff"), testing::ElementsAre(functions_[3].pretty_name()));
+  EXPECT_THAT(get_filter_result("f"), testing::UnorderedElementsAre(functions_[0].pretty_name(),
+                                                                     functions_[3].pretty_name()));
+
+  executor->ExecuteScheduledTasks();
+  EXPECT_THAT(get_filter_result("FOOMODULE"), testing::ElementsAre(functions_[3].pretty_name()));
+  EXPECT_THAT(get_filter_result("in ff"), testing::ElementsAre(functions_[3].pretty_name()));
+  EXPECT_THAT(get_filter_result("f"), testing::UnorderedElementsAre(functions_[0].pretty_name(),
+                                                                     functions_[3].pretty_name()));
+
+  // A search index that is built after the functions were cleared is dropped.
+  view.AddFunctions({&functions_[0]});
+  view.ClearFunctions();
+  view.AddFunctions({&functions_[1]});
+  executor->ExecuteScheduledTasks();
+  EXPECT_THAT(get_filter_result("main"), testing::ElementsAre(functions_[1].pretty_name()));
+  EXPECT_THAT(get_filter_result("foo"), testing::IsEmpty());
+}
@@ -33,6 +33,7 @@
 #include "ClientData/ScopeId.h"
 #include "ClientData/ScopeInfo.h"
 #include "ClientData/ScopeStats.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "DataViews/CompareAscendingOrDescending.h"
 #include "DataViews/DataView.h"
@@ -47,6 +48,7 @@
 #include "OrbitBase/Result.h"
 #include "OrbitBase/ThreadUtils.h"
 #include "Statistics/Histogram.h"
+#include "Statistics/QuantileSketch.h"
 
 using orbit_client_data::CaptureData;
 using orbit_client_data::FunctionInfo;
@@ -54,8 +56,7 @@ using orbit_client_data::ModuleData;
 using orbit_client_data::ModuleManager;
 using orbit_client_data::ScopeId;
 using orbit_client_data::ScopeStats;
-
-using orbit_client_protos::TimerInfo;
+using orbit_client_data::TimerInfo;
 
 using orbit_grpc_protos::InstrumentedFunction;
 
@@ -180,19 +181,19 @@ void LiveFunctionsDataView::UpdateHistogramWithIndices(
 }
 
 void LiveFunctionsDataView::UpdateHistogramWithScopeIds(const std::vector<ScopeId>& scope_ids) {
-  const std::vector<uint64_t>* timer_durations =
+  const std::optional<orbit_statistics::QuantileSketch> timer_durations =
       (app_->HasCaptureData() && !scope_ids.empty())
-          ? app_->GetCaptureData().GetSortedTimerDurationsForScopeId(scope_ids[0])
-          : nullptr;
+          ? app_->GetCaptureData().GetDurationSketchForScopeId(scope_ids[0])
+          : std::nullopt;
 
-  if (timer_durations == nullptr) {
+  if (!timer_durations.has_value()) {
     app_->ShowHistogram(nullptr, "", std::nullopt);
     return;
   }
 
   const ScopeId scope_id = scope_ids[0];
   const std::string& scope_name = GetScopeInfo(scope_id).GetName();
-  app_->ShowHistogram(timer_durations, scope_name, scope_id);
+  app_->ShowHistogram(&timer_durations.value(), scope_name, scope_id);
 }
 
 void LiveFunctionsDataView::OnSelect(const std::vector<int>& rows) {
@@ -19,6 +19,7 @@
 #include "ClientData/ScopeId.h"
 #include "ClientData/ScopeStats.h"
 #include "ClientData/TimerChain.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "DataViewTestUtils.h"
 #include "DataViews/AppInterface.h"
@@ -31,6 +32,7 @@
 #include "GrpcProtos/capture.pb.h"
 #include "MetricsUploader/MetricsUploaderStub.h"
 #include "MockAppInterface.h"
+#include "Statistics/QuantileSketch.h"
 
 using JumpToTimerMode = orbit_data_views::AppInterface::JumpToTimerMode;
 
@@ -39,8 +41,7 @@ using orbit_client_data::FunctionInfo;
 using orbit_client_data::ModuleData;
 using orbit_client_data::ScopeId;
 using orbit_client_data::ScopeStats;
-
-using orbit_client_protos::TimerInfo;
+using orbit_client_data::TimerInfo;
 
 using orbit_data_views::CheckCopySelectionIsInvoked;
 using orbit_data_views::CheckExportToCsvIsInvoked;
@@ -125,10 +126,12 @@ constexpr std::array<uint64_t, kNumTimers> kThreadIndices = {
 const std::array<TimerInfo, kNumTimers> kTimers = []() {
   std::array<TimerInfo, kNumTimers> timers;
   for (size_t i = 0; i < kNumTimers; i++) {
-    timers[i].set_start(kStarts[i]);
-    timers[i].set_end(kEnds[i]);
-    timers[i].set_thread_id(kThreadIds[kThreadIndices[i]]);
-    timers[i].set_function_id(kFunctionIds[0]);
+    orbit_client_protos::TimerInfo timer;
+    timer.set_start(kStarts[i]);
+    timer.set_end(kEnds[i]);
+    timer.set_thread_id(kThreadIds[kThreadIndices[i]]);
+    timer.set_function_id(kFunctionIds[0]);
+    timers[i] = timer;
   }
   return timers;
 }();
@@ -140,8 +143,9 @@ const std::vector<const TimerInfo*> kTimerPointers = []() {
   return pointers;
 }();
 
-const orbit_client_data::TimerChain kTimerChain = []() {
-  orbit_client_data::TimerChain result;
+// TimerChain is not copyable, hence the reference to a static local.
+const orbit_client_data::TimerChain& kTimerChain = []() -> const orbit_client_data::TimerChain& {
+  static orbit_client_data::TimerChain result;
   for (const auto& timer : kTimers) {
     result.emplace_back(timer);
   }
@@ -204,6 +208,12 @@ std::unique_ptr<CaptureData> GenerateTestCaptureData(
       std::make_unique<CaptureData>(capture_started, std::nullopt, absl::flat_hash_set<uint64_t>{},
                                     CaptureData::DataSource::kLiveCapture);
 
+  for (const TimerInfo* timer_info : kTimerPointers) {
+    capture_data->GetThreadTrackDataProvider()->AddTimer(*timer_info);
+    capture_data->UpdateScopeStats(*timer_info);
+  }
+
+  // Overrides the stats computed from the timers above.
   for (size_t i = 0; i < kNumFunctions; i++) {
     ScopeStats stats;
     stats.set_count(kCounts[i]);
@@ -214,10 +224,6 @@ std::unique_ptr<CaptureData> GenerateTestCaptureData(
     capture_data->AddScopeStats(kScopeIds[i], std::move(stats));
   }
 
-  for (const TimerInfo* timer_info : kTimerPointers) {
-    capture_data->GetThreadTrackDataProvider()->AddTimer(*timer_info);
-  }
-
   capture_data->OnCaptureComplete();
 
   return capture_data;
@@ -877,7 +883,10 @@ TEST_F(LiveFunctionsDataViewTest, HistogramIsProperlyUpdated) {
   view_.OnDataChanged();
   AddFunctionsByIndices({0});
 
-  EXPECT_CALL(app_, ShowHistogram(testing::Pointee(kDurations), kPrettyNames[0],
+  EXPECT_CALL(app_, ShowHistogram(Pointee(testing::Property(
+                                      &orbit_statistics::QuantileSketch::GetExactValues,
+                                      testing::ElementsAreArray(kDurations))),
+                                  kPrettyNames[0],
                                   std::optional<ScopeId>(kScopeIds[0])))
       .Times(3);
 
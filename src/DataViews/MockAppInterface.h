@@ -16,6 +16,7 @@
 #include "ClientData/ModuleData.h"
 #include "ClientData/ProcessData.h"
 #include "ClientData/ScopeId.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "DataViews/AppInterface.h"
 #include "DataViews/PresetLoadState.h"
@@ -104,12 +105,11 @@ class MockAppInterface : public AppInterface {
               GetConfidenceIntervalEstimator, (), (const, override));
 
   MOCK_METHOD(void, ShowHistogram,
-              (const std::vector<uint64_t>* data, const std::string& function_name,
+              (const orbit_statistics::QuantileSketch* data, const std::string& function_name,
                std::optional<ScopeId> scope_id),
               (override));
 
-  MOCK_METHOD(uint64_t, ProvideScopeId, (const orbit_client_protos::TimerInfo& timer_info),
-              (const));
+  MOCK_METHOD(uint64_t, ProvideScopeId, (const orbit_client_data::TimerInfo& timer_info), (const));
 
   MOCK_METHOD(bool, IsModuleDownloading, (const orbit_client_data::ModuleData* module),
               (const, override));
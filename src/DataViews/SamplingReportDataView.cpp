@@ -323,6 +323,7 @@ void SamplingReportDataView::LinkDataView(DataView* data_view) {
 
 void SamplingReportDataView::SetSampledFunctions(const std::vector<SampledFunction>& functions) {
   functions_ = functions;
+  search_index_.reset();
   RestoreSelectedIndicesAfterFunctionsChanged();
 
   size_t num_functions = functions_.size();
@@ -419,32 +420,27 @@ std::string SamplingReportDataView::GetToolTip(int row, int column) {
 }
 
 void SamplingReportDataView::DoFilter() {
-  std::vector<uint64_t> indices;
-
-  std::vector<std::string> tokens = absl::StrSplit(absl::AsciiStrToLower(filter_), ' ');
-
-  for (size_t i = 0; i < functions_.size(); ++i) {
-    SampledFunction& func = functions_[i];
-    std::string name = absl::AsciiStrToLower(func.name);
-    std::string module_name =
-        absl::AsciiStrToLower(std::filesystem::path(func.module_path).filename().string());
-
-    bool match = true;
-
-    for (std::string& filter_token : tokens) {
-      if (!(name.find(filter_token) != std::string::npos ||
-            module_name.find(filter_token) != std::string::npos)) {
-        match = false;
-        break;
-      }
+  if (filter_.empty()) {
+    indices_.resize(functions_.size());
+    for (size_t i = 0; i < functions_.size(); ++i) {
+      indices_[i] = i;
     }
+    return;
+  }
 
-    if (match) {
-      indices.push_back(i);
+  // The report is updated periodically during a capture, while filtering is comparatively rare. So
+  // the index is only built when the functions are first filtered after they changed.
+  if (!search_index_.has_value()) {
+    search_index_.emplace();
+    for (const SampledFunction& function : functions_) {
+      search_index_->AddItem(
+          {function.name, std::filesystem::path(function.module_path).filename().string()});
     }
   }
 
-  indices_ = std::move(indices);
+  std::vector<std::string> tokens = absl::StrSplit(filter_, ' ');
+  std::vector<size_t> indices = search_index_->FindItemsContainingAll(tokens);
+  indices_.assign(indices.begin(), indices.end());
 }
 
 const SampledFunction& SamplingReportDataView::GetSampledFunction(unsigned int row) const {
@@ -0,0 +1,123 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "DataViews/SubstringSearchIndex.h"
+
+#include <absl/strings/ascii.h>
+
+#include <algorithm>
+
+#include "OrbitBase/Logging.h"
+
+namespace orbit_data_views {
+
+namespace {
+
+[[nodiscard]] uint32_t GetTrigram(std::string_view text, size_t pos) {
+  return static_cast<uint32_t>(static_cast<unsigned char>(text[pos])) << 16 |
+         static_cast<uint32_t>(static_cast<unsigned char>(text[pos + 1])) << 8 |
+         static_cast<uint32_t>(static_cast<unsigned char>(text[pos + 2]));
+}
+
+}  // namespace
+
+void SubstringSearchIndex::AddItem(std::initializer_list<std::string_view> fields) {
+  const size_t item_index = item_offsets_.size();
+  ORBIT_CHECK(item_index <= UINT32_MAX);
+  item_offsets_.push_back(text_.size());
+
+  for (std::string_view field : fields) {
+    const size_t field_offset = text_.size();
+    for (char c : field) {
+      text_.push_back(absl::ascii_tolower(static_cast<unsigned char>(c)));
+    }
+    std::string_view lowercase_field{text_.data() + field_offset, field.size()};
+    for (size_t pos = 0; pos + 3 <= lowercase_field.size(); ++pos) {
+      posting_lists_[GetTrigram(lowercase_field, pos)].Append(static_cast<uint32_t>(item_index));
+    }
+    text_.push_back('\0');
+  }
+}
+
+void SubstringSearchIndex::PostingList::Append(uint32_t item_index) {
+  // Items are added in increasing order, so a duplicate can only be the last item.
+  if (last_item_index_plus_one == item_index + 1) return;
+  uint32_t delta = item_index + 1 - last_item_index_plus_one;
+  while (delta >= 0x80) {
+    encoded_deltas.push_back(static_cast<uint8_t>(delta | 0x80));
+    delta >>= 7;
+  }
+  encoded_deltas.push_back(static_cast<uint8_t>(delta));
+  last_item_index_plus_one = item_index + 1;
+  ++item_count;
+}
+
+std::vector<uint32_t> SubstringSearchIndex::PostingList::Decode() const {
+  std::vector<uint32_t> item_indices;
+  item_indices.reserve(item_count);
+  uint32_t item_index_plus_one = 0;
+  uint32_t delta = 0;
+  int shift = 0;
+  for (uint8_t byte : encoded_deltas) {
+    delta |= static_cast<uint32_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) != 0) {
+      shift += 7;
+      continue;
+    }
+    item_index_plus_one += delta;
+    item_indices.push_back(item_index_plus_one - 1);
+    delta = 0;
+    shift = 0;
+  }
+  return item_indices;
+}
+
+std::string_view SubstringSearchIndex::GetItemText(size_t item_index) const {
+  const size_t begin = item_offsets_[item_index];
+  const size_t end =
+      item_index + 1 < item_offsets_.size() ? item_offsets_[item_index + 1] : text_.size();
+  return std::string_view{text_}.substr(begin, end - begin);
+}
+
+std::vector<size_t> SubstringSearchIndex::FindItemsContainingAll(
+    absl::Span<const std::string> tokens) const {
+  std::vector<std::string> lowercase_tokens;
+  for (const std::string& token : tokens) {
+    if (!token.empty()) lowercase_tokens.push_back(absl::AsciiStrToLower(token));
+  }
+
+  // Only the items containing the rarest trigram of all tokens need to be checked.
+  const PostingList* candidates = nullptr;
+  for (const std::string& token : lowercase_tokens) {
+    for (size_t pos = 0; pos + 3 <= token.size(); ++pos) {
+      auto it = posting_lists_.find(GetTrigram(token, pos));
+      if (it == posting_lists_.end()) return {};
+      if (candidates == nullptr || it->second.item_count < candidates->item_count) {
+        candidates = &it->second;
+      }
+    }
+  }
+
+  auto contains_all_tokens = [this, &lowercase_tokens](size_t item_index) {
+    std::string_view item_text = GetItemText(item_index);
+    return std::all_of(lowercase_tokens.begin(), lowercase_tokens.end(),
+                       [item_text](const std::string& token) {
+                         return item_text.find(token) != std::string_view::npos;
+                       });
+  };
+
+  std::vector<size_t> result;
+  if (candidates != nullptr) {
+    for (uint32_t item_index : candidates->Decode()) {
+      if (contains_all_tokens(item_index)) result.push_back(item_index);
+    }
+  } else {
+    for (size_t item_index = 0; item_index < item_offsets_.size(); ++item_index) {
+      if (contains_all_tokens(item_index)) result.push_back(item_index);
+    }
+  }
+  return result;
+}
+
+}  // namespace orbit_data_views
@@ -0,0 +1,84 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <absl/strings/str_format.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+#include "DataViews/SubstringSearchIndex.h"
+
+namespace orbit_data_views {
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+namespace {
+
+SubstringSearchIndex CreateIndex() {
+  SubstringSearchIndex index;
+  index.AddItem({"foo()", "libFooModule.so"});
+  index.AddItem({"main", "MainModule"});
+  index.AddItem({"Bar::Baz(int)", "libfoomodule.so"});
+  index.AddItem({"ffind", "libc.so.6"});
+  return index;
+}
+
+}  // namespace
+
+TEST(SubstringSearchIndex, EmptyTokensMatchAllItems) {
+  SubstringSearchIndex index = CreateIndex();
+  EXPECT_EQ(index.GetItemCount(), 4);
+  EXPECT_THAT(index.FindItemsContainingAll({}), ElementsAre(0, 1, 2, 3));
+  EXPECT_THAT(index.FindItemsContainingAll({""}), ElementsAre(0, 1, 2, 3));
+  EXPECT_THAT(index.FindItemsContainingAll({"", ""}), ElementsAre(0, 1, 2, 3));
+}
+
+TEST(SubstringSearchIndex, IgnoresCase) {
+  SubstringSearchIndex index = CreateIndex();
+  EXPECT_THAT(index.FindItemsContainingAll({"baz"}), ElementsAre(2));
+  EXPECT_THAT(index.FindItemsContainingAll({"BAZ"}), ElementsAre(2));
+  EXPECT_THAT(index.FindItemsContainingAll({"FooModule"}), ElementsAre(0, 2));
+}
+
+TEST(SubstringSearchIndex, MatchesShortTokens) {
+  SubstringSearchIndex index = CreateIndex();
+  EXPECT_THAT(index.FindItemsContainingAll({"f"}), ElementsAre(0, 2, 3));
+  EXPECT_THAT(index.FindItemsContainingAll({"ff"}), ElementsAre(3));
+  EXPECT_THAT(index.FindItemsContainingAll({"::"}), ElementsAre(2));
+  EXPECT_THAT(index.FindItemsContainingAll({"x"}), IsEmpty());
+}
+
+TEST(SubstringSearchIndex, RequiresAllTokens) {
+  SubstringSearchIndex index = CreateIndex();
+  EXPECT_THAT(index.FindItemsContainingAll({"ain", "module"}), ElementsAre(1));
+  EXPECT_THAT(index.FindItemsContainingAll({"module", "ain"}), ElementsAre(1));
+  EXPECT_THAT(index.FindItemsContainingAll({"ff", "libc"}), ElementsAre(3));
+  EXPECT_THAT(index.FindItemsContainingAll({"ffind", "main"}), IsEmpty());
+}
+
+TEST(SubstringSearchIndex, DoesNotMatchAcrossFields) {
+  SubstringSearchIndex index = CreateIndex();
+  EXPECT_THAT(index.FindItemsContainingAll({"mainmain"}), IsEmpty());
+  EXPECT_THAT(index.FindItemsContainingAll({"()lib"}), IsEmpty());
+  EXPECT_THAT(index.FindItemsContainingAll({"so.6"}), ElementsAre(3));
+}
+
+TEST(SubstringSearchIndex, FindsItemsAmongManyItems) {
+  constexpr size_t kItemCount = 10'000;
+  SubstringSearchIndex index;
+  for (size_t i = 0; i < kItemCount; ++i) {
+    index.AddItem({absl::StrFormat("Function%05d", i), "module"});
+  }
+
+  EXPECT_THAT(index.FindItemsContainingAll({"function01234"}), ElementsAre(1234));
+  EXPECT_THAT(index.FindItemsContainingAll({"999", "function09"}),
+              ElementsAre(9990, 9991, 9992, 9993, 9994, 9995, 9996, 9997, 9998, 9999));
+  EXPECT_EQ(index.FindItemsContainingAll({"module"}).size(), kItemCount);
+}
+
+}  // namespace orbit_data_views
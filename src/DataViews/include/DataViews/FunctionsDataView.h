@@ -5,18 +5,29 @@
 #ifndef DATA_VIEWS_FUNCTIONS_DATA_VIEW_H_
 #define DATA_VIEWS_FUNCTIONS_DATA_VIEW_H_
 
+#include <absl/base/thread_annotations.h>
+#include <absl/synchronization/mutex.h>
+#include <stddef.h>
+
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "ClientData/FunctionInfo.h"
 #include "DataViews/AppInterface.h"
 #include "DataViews/DataView.h"
+#include "DataViews/SubstringSearchIndex.h"
+#include "OrbitBase/Executor.h"
+#include "OrbitBase/ThreadPool.h"
 
 namespace orbit_data_views {
 class FunctionsDataView : public DataView {
  public:
+  // The search indices used for filtering are built on `search_index_executor`.
   explicit FunctionsDataView(AppInterface* app,
-                             orbit_metrics_uploader::MetricsUploader* metrics_uploader);
+                             orbit_metrics_uploader::MetricsUploader* metrics_uploader,
+                             orbit_base::Executor* search_index_executor =
+                                 orbit_base::ThreadPool::GetDefaultThreadPool());
 
   static const std::string kUnselectedFunctionString;
   static const std::string kSelectedFunctionString;
@@ -34,6 +45,8 @@ class FunctionsDataView : public DataView {
   std::string GetValue(int row, int column) override;
   std::string GetLabel() override { return "Functions"; }
 
+  // Returns without waiting for the search indices of the new functions to be built. Until they
+  // are, filtering scans these functions.
   void AddFunctions(std::vector<const orbit_client_data::FunctionInfo*> functions);
   void ClearFunctions();
 
@@ -61,7 +74,28 @@ class FunctionsDataView : public DataView {
     return functions_[indices_[row]];
   }
 
+  // Filled in by search_index_executor_ once the index is built.
+  struct SearchIndexSlot {
+    absl::Mutex mutex;
+    std::shared_ptr<const SubstringSearchIndex> index ABSL_GUARDED_BY(mutex);
+  };
+
+  // Indexes `function_count` functions starting at `first_function_index`.
+  struct FunctionSearchIndex {
+    size_t first_function_index = 0;
+    size_t function_count = 0;
+    // Null if these functions are not indexed because of kMaxIndexedFunctionCount.
+    std::shared_ptr<SearchIndexSlot> slot;
+  };
+
+  // An index takes about 170 bytes per function, including the lowercase names it keeps. Functions
+  // beyond this are filtered by scanning them, so that the indices take at most about 180 MB.
+  static constexpr size_t kMaxIndexedFunctionCount = 1024 * 1024;
+
+  orbit_base::Executor* search_index_executor_;
   std::vector<const orbit_client_data::FunctionInfo*> functions_;
+  std::vector<FunctionSearchIndex> search_indices_;
+  size_t indexed_function_count_ = 0;
 };
 
 }  // namespace orbit_data_views
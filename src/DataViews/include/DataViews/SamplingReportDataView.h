@@ -18,6 +18,7 @@
 #include "DataViews/CallstackDataView.h"
 #include "DataViews/DataView.h"
 #include "DataViews/SamplingReportInterface.h"
+#include "DataViews/SubstringSearchIndex.h"
 #include "OrbitBase/Result.h"
 #include "absl/container/flat_hash_set.h"
 
@@ -83,6 +84,9 @@ class SamplingReportDataView : public DataView {
   ErrorMessageOr<void> WriteStackEventsToCsv(const std::string& file_path);
 
   std::vector<orbit_client_data::SampledFunction> functions_;
+  // Indexes the name and module filename of each of `functions_`, for filtering. Built by the first
+  // DoFilter with a non-empty filter after `functions_` changed.
+  std::optional<SubstringSearchIndex> search_index_;
   // We need to keep user's selected function ids such that if functions_ changes, the
   // selected_indices_ can be updated according to the selected function ids.
   absl::flat_hash_set<uint64_t> selected_function_ids_;
@@ -0,0 +1,60 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef DATA_VIEWS_SUBSTRING_SEARCH_INDEX_H_
+#define DATA_VIEWS_SUBSTRING_SEARCH_INDEX_H_
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/types/span.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace orbit_data_views {
+
+// Finds the items whose text fields contain each of a list of tokens, ignoring ASCII case, as done
+// by the filters of the data views. The fields are lowercased once, when the item is added, and
+// every trigram (three consecutive characters) of them is mapped to the items it appears in. A
+// search then only needs to look at the items that contain the rarest trigram of the tokens, rather
+// than at all of them. Tokens shorter than three characters still require checking all items.
+class SubstringSearchIndex {
+ public:
+  // The item gets the index `GetItemCount()`. A token never matches across two fields.
+  void AddItem(std::initializer_list<std::string_view> fields);
+
+  [[nodiscard]] size_t GetItemCount() const { return item_offsets_.size(); }
+
+  // Returns the indices of the items in which every token is contained in one of the fields, in
+  // increasing order. Empty tokens are contained in every item.
+  [[nodiscard]] std::vector<size_t> FindItemsContainingAll(
+      absl::Span<const std::string> tokens) const;
+
+ private:
+  // The indices of the items a trigram appears in, in increasing order. They are stored as
+  // variable-length encoded differences, which mostly take one byte each.
+  struct PostingList {
+    void Append(uint32_t item_index);
+    [[nodiscard]] std::vector<uint32_t> Decode() const;
+
+    std::vector<uint8_t> encoded_deltas;
+    uint32_t item_count = 0;
+    // 0 while the list is empty.
+    uint32_t last_item_index_plus_one = 0;
+  };
+
+  [[nodiscard]] std::string_view GetItemText(size_t item_index) const;
+
+  // Lowercase fields of all items, each field followed by a '\0'.
+  std::string text_;
+  std::vector<size_t> item_offsets_;
+  absl::flat_hash_map<uint32_t, PostingList> posting_lists_;
+};
+
+}  // namespace orbit_data_views
+
+#endif  // DATA_VIEWS_SUBSTRING_SEARCH_INDEX_H_
@@ -0,0 +1,288 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "GrpcProtos/ColumnarCaptureEvents.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace orbit_grpc_protos {
+
+namespace {
+
+// Deltas are computed with wrapping arithmetic so that they round-trip even if timestamps are not
+// increasing.
+[[nodiscard]] int64_t EncodeTimestamp(uint64_t timestamp_ns, uint64_t* previous_timestamp_ns) {
+  const auto delta = static_cast<int64_t>(timestamp_ns - *previous_timestamp_ns);
+  *previous_timestamp_ns = timestamp_ns;
+  return delta;
+}
+
+[[nodiscard]] uint64_t DecodeTimestamp(int64_t delta, uint64_t* previous_timestamp_ns) {
+  *previous_timestamp_ns += static_cast<uint64_t>(delta);
+  return *previous_timestamp_ns;
+}
+
+template <typename Column>
+[[nodiscard]] bool AllThreadIndicesAreValid(const Column& thread_indices, int thread_count) {
+  return std::all_of(thread_indices.begin(), thread_indices.end(), [thread_count](uint32_t index) {
+    return index < static_cast<uint32_t>(thread_count);
+  });
+}
+
+[[nodiscard]] bool IsConsistent(const ColumnarCaptureEvents& columnar_events) {
+  const int thread_count = columnar_events.thread_pids_size();
+  if (columnar_events.thread_tids_size() != thread_count) return false;
+
+  const ColumnarFunctionCalls& function_calls = columnar_events.function_calls();
+  const int function_call_count = function_calls.thread_indices_size();
+  if (function_calls.function_ids_size() != function_call_count ||
+      function_calls.durations_ns_size() != function_call_count ||
+      function_calls.end_timestamp_ns_deltas_size() != function_call_count ||
+      function_calls.depths_size() != function_call_count ||
+      (function_calls.return_values_size() != 0 &&
+       function_calls.return_values_size() != function_call_count) ||
+      !AllThreadIndicesAreValid(function_calls.thread_indices(), thread_count)) {
+    return false;
+  }
+
+  const ColumnarSchedulingSlices& scheduling_slices = columnar_events.scheduling_slices();
+  const int scheduling_slice_count = scheduling_slices.thread_indices_size();
+  if (scheduling_slices.cores_size() != scheduling_slice_count ||
+      scheduling_slices.durations_ns_size() != scheduling_slice_count ||
+      scheduling_slices.out_timestamp_ns_deltas_size() != scheduling_slice_count ||
+      !AllThreadIndicesAreValid(scheduling_slices.thread_indices(), thread_count)) {
+    return false;
+  }
+
+  const ColumnarCallstackSamples& callstack_samples = columnar_events.callstack_samples();
+  const int callstack_sample_count = callstack_samples.thread_indices_size();
+  if (callstack_samples.callstack_ids_size() != callstack_sample_count ||
+      callstack_samples.timestamp_ns_deltas_size() != callstack_sample_count ||
+      !AllThreadIndicesAreValid(callstack_samples.thread_indices(), thread_count)) {
+    return false;
+  }
+
+  const ColumnarThreadStateSlices& thread_state_slices = columnar_events.thread_state_slices();
+  const int thread_state_slice_count = thread_state_slices.thread_indices_size();
+  const auto wakeup_count = std::count_if(
+      thread_state_slices.wakeup_reasons().begin(), thread_state_slices.wakeup_reasons().end(),
+      [](int wakeup_reason) { return wakeup_reason != ThreadStateSlice::kNotApplicable; });
+  return thread_state_slices.thread_states_size() == thread_state_slice_count &&
+         thread_state_slices.durations_ns_size() == thread_state_slice_count &&
+         thread_state_slices.end_timestamp_ns_deltas_size() == thread_state_slice_count &&
+         thread_state_slices.wakeup_reasons_size() == thread_state_slice_count &&
+         thread_state_slices.wakeup_thread_indices_size() == wakeup_count &&
+         AllThreadIndicesAreValid(thread_state_slices.thread_indices(), thread_count) &&
+         AllThreadIndicesAreValid(thread_state_slices.wakeup_thread_indices(), thread_count);
+}
+
+}  // namespace
+
+bool IsColumnarCaptureEvent(const ClientCaptureEvent& event) {
+  switch (event.event_case()) {
+    case ClientCaptureEvent::kFunctionCall:
+      return event.function_call().registers_size() == 0;
+    case ClientCaptureEvent::kSchedulingSlice:
+    case ClientCaptureEvent::kCallstackSample:
+    case ClientCaptureEvent::kThreadStateSlice:
+      return true;
+    default:
+      return false;
+  }
+}
+
+uint32_t ColumnarCaptureEventsBuilder::GetThreadIndex(uint32_t pid, uint32_t tid) {
+  auto [it, inserted] =
+      thread_indices_.try_emplace(std::make_pair(pid, tid), columnar_events_->thread_pids_size());
+  if (inserted) {
+    columnar_events_->add_thread_pids(pid);
+    columnar_events_->add_thread_tids(tid);
+  }
+  return it->second;
+}
+
+bool ColumnarCaptureEventsBuilder::AddEvent(const ClientCaptureEvent& event) {
+  if (!IsColumnarCaptureEvent(event)) return false;
+
+  switch (event.event_case()) {
+    case ClientCaptureEvent::kFunctionCall: {
+      const FunctionCall& function_call = event.function_call();
+      ColumnarFunctionCalls* function_calls = columnar_events_->mutable_function_calls();
+      function_calls->add_thread_indices(GetThreadIndex(function_call.pid(), function_call.tid()));
+      function_calls->add_function_ids(function_call.function_id());
+      function_calls->add_durations_ns(function_call.duration_ns());
+      function_calls->add_end_timestamp_ns_deltas(EncodeTimestamp(
+          function_call.end_timestamp_ns(), &previous_function_call_end_timestamp_ns_));
+      function_calls->add_depths(function_call.depth());
+      // The return values column is only filled once there is a non-zero return value.
+      if (function_call.return_value() != 0 && function_calls->return_values_size() == 0) {
+        function_calls->mutable_return_values()->Resize(function_calls->thread_indices_size() - 1,
+                                                        0);
+      }
+      if (function_calls->return_values_size() != 0) {
+        function_calls->add_return_values(function_call.return_value());
+      }
+      return true;
+    }
+
+    case ClientCaptureEvent::kSchedulingSlice: {
+      const SchedulingSlice& scheduling_slice = event.scheduling_slice();
+      ColumnarSchedulingSlices* scheduling_slices = columnar_events_->mutable_scheduling_slices();
+      scheduling_slices->add_thread_indices(
+          GetThreadIndex(scheduling_slice.pid(), scheduling_slice.tid()));
+      scheduling_slices->add_cores(scheduling_slice.core());
+      scheduling_slices->add_durations_ns(scheduling_slice.duration_ns());
+      scheduling_slices->add_out_timestamp_ns_deltas(EncodeTimestamp(
+          scheduling_slice.out_timestamp_ns(), &previous_scheduling_slice_out_timestamp_ns_));
+      return true;
+    }
+
+    case ClientCaptureEvent::kCallstackSample: {
+      const CallstackSample& callstack_sample = event.callstack_sample();
+      ColumnarCallstackSamples* callstack_samples = columnar_events_->mutable_callstack_samples();
+      callstack_samples->add_thread_indices(
+          GetThreadIndex(callstack_sample.pid(), callstack_sample.tid()));
+      callstack_samples->add_callstack_ids(callstack_sample.callstack_id());
+      callstack_samples->add_timestamp_ns_deltas(EncodeTimestamp(
+          callstack_sample.timestamp_ns(), &previous_callstack_sample_timestamp_ns_));
+      return true;
+    }
+
+    case ClientCaptureEvent::kThreadStateSlice: {
+      const ThreadStateSlice& thread_state_slice = event.thread_state_slice();
+      ColumnarThreadStateSlices* thread_state_slices =
+          columnar_events_->mutable_thread_state_slices();
+      thread_state_slices->add_thread_indices(
+          GetThreadIndex(thread_state_slice.pid(), thread_state_slice.tid()));
+      thread_state_slices->add_thread_states(thread_state_slice.thread_state());
+      thread_state_slices->add_durations_ns(thread_state_slice.duration_ns());
+      thread_state_slices->add_end_timestamp_ns_deltas(EncodeTimestamp(
+          thread_state_slice.end_timestamp_ns(), &previous_thread_state_slice_end_timestamp_ns_));
+      thread_state_slices->add_wakeup_reasons(thread_state_slice.wakeup_reason());
+      if (thread_state_slice.wakeup_reason() != ThreadStateSlice::kNotApplicable) {
+        thread_state_slices->add_wakeup_thread_indices(
+            GetThreadIndex(thread_state_slice.wakeup_pid(), thread_state_slice.wakeup_tid()));
+      }
+      return true;
+    }
+
+    default:
+      return false;
+  }
+}
+
+size_t GetColumnarCaptureEventCount(const ColumnarCaptureEvents& columnar_events) {
+  return columnar_events.function_calls().thread_indices_size() +
+         columnar_events.scheduling_slices().thread_indices_size() +
+         columnar_events.callstack_samples().thread_indices_size() +
+         columnar_events.thread_state_slices().thread_indices_size();
+}
+
+bool ExpandColumnarCaptureEvents(const ColumnarCaptureEvents& columnar_events,
+                                 const std::function<void(const ClientCaptureEvent&)>& consumer) {
+  if (!IsConsistent(columnar_events)) return false;
+
+  const auto& thread_pids = columnar_events.thread_pids();
+  const auto& thread_tids = columnar_events.thread_tids();
+
+  // Every field of the reused events is set for each event.
+  ClientCaptureEvent event;
+
+  const ColumnarFunctionCalls& function_calls = columnar_events.function_calls();
+  FunctionCall* function_call = event.mutable_function_call();
+  uint64_t function_call_end_timestamp_ns = 0;
+  for (int i = 0; i < function_calls.thread_indices_size(); ++i) {
+    const uint32_t thread_index = function_calls.thread_indices(i);
+    function_call->set_pid(thread_pids[thread_index]);
+    function_call->set_tid(thread_tids[thread_index]);
+    function_call->set_function_id(function_calls.function_ids(i));
+    function_call->set_duration_ns(function_calls.durations_ns(i));
+    function_call->set_end_timestamp_ns(DecodeTimestamp(function_calls.end_timestamp_ns_deltas(i),
+                                                        &function_call_end_timestamp_ns));
+    function_call->set_depth(function_calls.depths(i));
+    function_call->set_return_value(
+        function_calls.return_values_size() != 0 ? function_calls.return_values(i) : 0);
+    consumer(event);
+  }
+
+  const ColumnarSchedulingSlices& scheduling_slices = columnar_events.scheduling_slices();
+  SchedulingSlice* scheduling_slice = event.mutable_scheduling_slice();
+  uint64_t scheduling_slice_out_timestamp_ns = 0;
+  for (int i = 0; i < scheduling_slices.thread_indices_size(); ++i) {
+    const uint32_t thread_index = scheduling_slices.thread_indices(i);
+    scheduling_slice->set_pid(thread_pids[thread_index]);
+    scheduling_slice->set_tid(thread_tids[thread_index]);
+    scheduling_slice->set_core(scheduling_slices.cores(i));
+    scheduling_slice->set_duration_ns(scheduling_slices.durations_ns(i));
+    scheduling_slice->set_out_timestamp_ns(DecodeTimestamp(
+        scheduling_slices.out_timestamp_ns_deltas(i), &scheduling_slice_out_timestamp_ns));
+    consumer(event);
+  }
+
+  const ColumnarCallstackSamples& callstack_samples = columnar_events.callstack_samples();
+  CallstackSample* callstack_sample = event.mutable_callstack_sample();
+  uint64_t callstack_sample_timestamp_ns = 0;
+  for (int i = 0; i < callstack_samples.thread_indices_size(); ++i) {
+    const uint32_t thread_index = callstack_samples.thread_indices(i);
+    callstack_sample->set_pid(thread_pids[thread_index]);
+    callstack_sample->set_tid(thread_tids[thread_index]);
+    callstack_sample->set_callstack_id(callstack_samples.callstack_ids(i));
+    callstack_sample->set_timestamp_ns(DecodeTimestamp(callstack_samples.timestamp_ns_deltas(i),
+                                                       &callstack_sample_timestamp_ns));
+    consumer(event);
+  }
+
+  const ColumnarThreadStateSlices& thread_state_slices = columnar_events.thread_state_slices();
+  ThreadStateSlice* thread_state_slice = event.mutable_thread_state_slice();
+  uint64_t thread_state_slice_end_timestamp_ns = 0;
+  int next_wakeup_index = 0;
+  for (int i = 0; i < thread_state_slices.thread_indices_size(); ++i) {
+    const uint32_t thread_index = thread_state_slices.thread_indices(i);
+    thread_state_slice->set_pid(thread_pids[thread_index]);
+    thread_state_slice->set_tid(thread_tids[thread_index]);
+    thread_state_slice->set_thread_state(thread_state_slices.thread_states(i));
+    thread_state_slice->set_duration_ns(thread_state_slices.durations_ns(i));
+    thread_state_slice->set_end_timestamp_ns(DecodeTimestamp(
+        thread_state_slices.end_timestamp_ns_deltas(i), &thread_state_slice_end_timestamp_ns));
+    thread_state_slice->set_wakeup_reason(thread_state_slices.wakeup_reasons(i));
+    if (thread_state_slices.wakeup_reasons(i) != ThreadStateSlice::kNotApplicable) {
+      const uint32_t wakeup_thread_index =
+          thread_state_slices.wakeup_thread_indices(next_wakeup_index++);
+      thread_state_slice->set_wakeup_pid(thread_pids[wakeup_thread_index]);
+      thread_state_slice->set_wakeup_tid(thread_tids[wakeup_thread_index]);
+    } else {
+      thread_state_slice->set_wakeup_pid(0);
+      thread_state_slice->set_wakeup_tid(0);
+    }
+    consumer(event);
+  }
+
+  return true;
+}
+
+bool ForEachClientCaptureEvent(const CaptureResponse& capture_response,
+                               const std::function<void(const ClientCaptureEvent&)>& consumer) {
+  bool all_consistent = true;
+  int next_columnar_events_index = 0;
+  // Expands the ColumnarCaptureEvents that come before capture_events[position].
+  auto expand_columnar_events_before = [&](uint32_t position) {
+    while (next_columnar_events_index < capture_response.columnar_capture_events_size() &&
+           capture_response.columnar_capture_events(next_columnar_events_index).position() <=
+               position) {
+      all_consistent &= ExpandColumnarCaptureEvents(
+          capture_response.columnar_capture_events(next_columnar_events_index), consumer);
+      ++next_columnar_events_index;
+    }
+  };
+
+  for (int i = 0; i < capture_response.capture_events_size(); ++i) {
+    expand_columnar_events_before(i);
+    consumer(capture_response.capture_events(i));
+  }
+  expand_columnar_events_before(std::numeric_limits<uint32_t>::max());
+  return all_consistent;
+}
+
+}  // namespace orbit_grpc_protos
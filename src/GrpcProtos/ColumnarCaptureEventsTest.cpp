@@ -0,0 +1,196 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "GrpcProtos/ColumnarCaptureEvents.h"
+#include "GrpcProtos/capture.pb.h"
+#include "GrpcProtos/services.pb.h"
+
+namespace orbit_grpc_protos {
+
+namespace {
+
+ClientCaptureEvent CreateFunctionCall(uint32_t tid, uint64_t end_timestamp_ns,
+                                      uint64_t return_value = 0) {
+  ClientCaptureEvent event;
+  FunctionCall* function_call = event.mutable_function_call();
+  function_call->set_pid(42);
+  function_call->set_tid(tid);
+  function_call->set_function_id(tid % 7 + 1);
+  function_call->set_duration_ns(1234);
+  function_call->set_end_timestamp_ns(end_timestamp_ns);
+  function_call->set_depth(static_cast<int32_t>(tid % 3));
+  function_call->set_return_value(return_value);
+  return event;
+}
+
+ClientCaptureEvent CreateSchedulingSlice(uint32_t tid, uint64_t out_timestamp_ns) {
+  ClientCaptureEvent event;
+  SchedulingSlice* scheduling_slice = event.mutable_scheduling_slice();
+  scheduling_slice->set_pid(42);
+  scheduling_slice->set_tid(tid);
+  scheduling_slice->set_core(static_cast<int32_t>(tid % 4));
+  scheduling_slice->set_duration_ns(5678);
+  scheduling_slice->set_out_timestamp_ns(out_timestamp_ns);
+  return event;
+}
+
+ClientCaptureEvent CreateCallstackSample(uint32_t tid, uint64_t timestamp_ns) {
+  ClientCaptureEvent event;
+  CallstackSample* callstack_sample = event.mutable_callstack_sample();
+  callstack_sample->set_pid(42);
+  callstack_sample->set_tid(tid);
+  callstack_sample->set_callstack_id(tid * 10);
+  callstack_sample->set_timestamp_ns(timestamp_ns);
+  return event;
+}
+
+ClientCaptureEvent CreateThreadStateSlice(uint32_t tid, uint64_t end_timestamp_ns,
+                                          uint32_t wakeup_tid = 0) {
+  ClientCaptureEvent event;
+  ThreadStateSlice* thread_state_slice = event.mutable_thread_state_slice();
+  thread_state_slice->set_tid(tid);
+  thread_state_slice->set_thread_state(ThreadStateSlice::kInterruptibleSleep);
+  thread_state_slice->set_duration_ns(91011);
+  thread_state_slice->set_end_timestamp_ns(end_timestamp_ns);
+  if (wakeup_tid != 0) {
+    thread_state_slice->set_wakeup_reason(ThreadStateSlice::kUnblocked);
+    thread_state_slice->set_wakeup_pid(42);
+    thread_state_slice->set_wakeup_tid(wakeup_tid);
+  }
+  return event;
+}
+
+ClientCaptureEvent CreateInternedString(uint64_t key) {
+  ClientCaptureEvent event;
+  event.mutable_interned_string()->set_key(key);
+  event.mutable_interned_string()->set_intern("string");
+  return event;
+}
+
+std::vector<std::string> ExpandToSerializedEvents(const ColumnarCaptureEvents& columnar_events) {
+  std::vector<std::string> serialized_events;
+  EXPECT_TRUE(ExpandColumnarCaptureEvents(
+      columnar_events, [&serialized_events](const ClientCaptureEvent& event) {
+        serialized_events.push_back(event.SerializeAsString());
+      }));
+  return serialized_events;
+}
+
+}  // namespace
+
+TEST(ColumnarCaptureEvents, ExpandedEventsAreEqualToAddedEvents) {
+  // Events of the same kind are expanded in order, kinds one after the other.
+  const std::vector<ClientCaptureEvent> events{
+      CreateFunctionCall(100, 1'000'000'000),
+      CreateFunctionCall(101, 1'000'000'500, 7),
+      // Timestamps are not always increasing.
+      CreateFunctionCall(100, 999'999'000),
+      CreateSchedulingSlice(100, 1'000'000'100),
+      CreateSchedulingSlice(102, 1'000'001'000),
+      CreateCallstackSample(101, 1'000'000'200),
+      CreateCallstackSample(101, 1'000'000'300),
+      CreateThreadStateSlice(100, 1'000'000'400),
+      CreateThreadStateSlice(101, 1'000'000'450, 103),
+      CreateThreadStateSlice(102, 1'000'000'460),
+  };
+
+  ColumnarCaptureEvents columnar_events;
+  ColumnarCaptureEventsBuilder builder{&columnar_events};
+  std::vector<std::string> expected_serialized_events;
+  for (const ClientCaptureEvent& event : events) {
+    EXPECT_TRUE(builder.AddEvent(event));
+    expected_serialized_events.push_back(event.SerializeAsString());
+  }
+
+  EXPECT_EQ(GetColumnarCaptureEventCount(columnar_events), events.size());
+  EXPECT_EQ(ExpandToSerializedEvents(columnar_events), expected_serialized_events);
+}
+
+TEST(ColumnarCaptureEvents, UnsupportedEventsAreNotAdded) {
+  ColumnarCaptureEvents columnar_events;
+  ColumnarCaptureEventsBuilder builder{&columnar_events};
+
+  EXPECT_FALSE(builder.AddEvent(CreateInternedString(1)));
+  ClientCaptureEvent function_call_with_registers = CreateFunctionCall(100, 1000);
+  function_call_with_registers.mutable_function_call()->add_registers(1);
+  EXPECT_FALSE(builder.AddEvent(function_call_with_registers));
+
+  EXPECT_EQ(columnar_events.ByteSizeLong(), 0);
+}
+
+TEST(ColumnarCaptureEvents, InconsistentColumnsAreNotExpanded) {
+  ColumnarCaptureEvents columnar_events;
+  ColumnarCaptureEventsBuilder builder{&columnar_events};
+  ASSERT_TRUE(builder.AddEvent(CreateCallstackSample(100, 1000)));
+  ASSERT_TRUE(builder.AddEvent(CreateCallstackSample(101, 2000)));
+  columnar_events.mutable_callstack_samples()->set_thread_indices(1, 2);
+
+  bool consumer_called = false;
+  EXPECT_FALSE(ExpandColumnarCaptureEvents(
+      columnar_events, [&consumer_called](const ClientCaptureEvent& /*event*/) {
+        consumer_called = true;
+      }));
+  EXPECT_FALSE(consumer_called);
+}
+
+TEST(ColumnarCaptureEvents, ForEachClientCaptureEventKeepsTheOrderOfTheResponse) {
+  CaptureResponse capture_response;
+  auto add_columnar_event = [&capture_response](const ClientCaptureEvent& event) {
+    ColumnarCaptureEvents* columnar_events = capture_response.add_columnar_capture_events();
+    columnar_events->set_position(capture_response.capture_events_size());
+    ColumnarCaptureEventsBuilder builder{columnar_events};
+    EXPECT_TRUE(builder.AddEvent(event));
+  };
+  add_columnar_event(CreateCallstackSample(100, 1000));
+  *capture_response.add_capture_events() = CreateInternedString(1);
+  add_columnar_event(CreateCallstackSample(100, 2000));
+  *capture_response.add_capture_events() = CreateInternedString(2);
+  *capture_response.add_capture_events() = CreateInternedString(3);
+  add_columnar_event(CreateCallstackSample(100, 3000));
+
+  std::vector<uint64_t> keys_and_timestamps;
+  EXPECT_TRUE(ForEachClientCaptureEvent(
+      capture_response, [&keys_and_timestamps](const ClientCaptureEvent& event) {
+        keys_and_timestamps.push_back(event.has_interned_string()
+                                          ? event.interned_string().key()
+                                          : event.callstack_sample().timestamp_ns());
+      }));
+  EXPECT_EQ(keys_and_timestamps, (std::vector<uint64_t>{1000, 1, 2000, 2, 3, 3000}));
+}
+
+TEST(ColumnarCaptureEvents, AreSmallerThanIndividualEvents) {
+  constexpr uint64_t kEventCount = 3000;
+  CaptureResponse individual_events_response;
+  CaptureResponse columnar_events_response;
+  ColumnarCaptureEventsBuilder builder{columnar_events_response.add_columnar_capture_events()};
+  uint64_t timestamp_ns = 1'650'000'000'000'000'000;
+  for (uint64_t i = 0; i < kEventCount; ++i) {
+    const auto tid = static_cast<uint32_t>(10'000 + i % 16);
+    timestamp_ns += 2'000 + i % 100;
+    ClientCaptureEvent event;
+    switch (i % 3) {
+      case 0:
+        event = CreateFunctionCall(tid, timestamp_ns);
+        break;
+      case 1:
+        event = CreateSchedulingSlice(tid, timestamp_ns);
+        break;
+      default:
+        event = CreateCallstackSample(tid, timestamp_ns);
+        break;
+    }
+    *individual_events_response.add_capture_events() = event;
+    EXPECT_TRUE(builder.AddEvent(event));
+  }
+
+  EXPECT_LT(columnar_events_response.ByteSizeLong() * 2, individual_events_response.ByteSizeLong());
+}
+
+}  // namespace orbit_grpc_protos
@@ -0,0 +1,64 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef GRPC_PROTOS_COLUMNAR_CAPTURE_EVENTS_H_
+#define GRPC_PROTOS_COLUMNAR_CAPTURE_EVENTS_H_
+
+#include <absl/container/flat_hash_map.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+#include <utility>
+
+#include "GrpcProtos/capture.pb.h"
+#include "GrpcProtos/services.pb.h"
+
+namespace orbit_grpc_protos {
+
+// Returns whether `event` can be part of a ColumnarCaptureEvents.
+[[nodiscard]] bool IsColumnarCaptureEvent(const ClientCaptureEvent& event);
+
+// Appends events to a ColumnarCaptureEvents (see capture.proto). The builder holds the state of the
+// delta and dictionary encodings, so all the events of a batch need to be added with the same
+// builder.
+class ColumnarCaptureEventsBuilder {
+ public:
+  explicit ColumnarCaptureEventsBuilder(ColumnarCaptureEvents* columnar_events)
+      : columnar_events_{columnar_events} {}
+
+  // Returns false, and leaves the batch unchanged, if `event` doesn't satisfy
+  // IsColumnarCaptureEvent.
+  [[nodiscard]] bool AddEvent(const ClientCaptureEvent& event);
+
+  [[nodiscard]] ColumnarCaptureEvents* GetColumnarEvents() const { return columnar_events_; }
+
+ private:
+  [[nodiscard]] uint32_t GetThreadIndex(uint32_t pid, uint32_t tid);
+
+  ColumnarCaptureEvents* columnar_events_;
+  absl::flat_hash_map<std::pair<uint32_t, uint32_t>, uint32_t> thread_indices_;
+  uint64_t previous_function_call_end_timestamp_ns_ = 0;
+  uint64_t previous_scheduling_slice_out_timestamp_ns_ = 0;
+  uint64_t previous_callstack_sample_timestamp_ns_ = 0;
+  uint64_t previous_thread_state_slice_end_timestamp_ns_ = 0;
+};
+
+[[nodiscard]] size_t GetColumnarCaptureEventCount(const ColumnarCaptureEvents& columnar_events);
+
+// Calls `consumer` with each of the events of `columnar_events`. Returns false, without calling
+// `consumer`, if the columns are inconsistent with each other.
+[[nodiscard]] bool ExpandColumnarCaptureEvents(
+    const ColumnarCaptureEvents& columnar_events,
+    const std::function<void(const ClientCaptureEvent&)>& consumer);
+
+// Calls `consumer` with each of the events of `capture_response`, in order, expanding its
+// ColumnarCaptureEvents. Returns false if some of them were inconsistent and had to be skipped.
+[[nodiscard]] bool ForEachClientCaptureEvent(
+    const CaptureResponse& capture_response,
+    const std::function<void(const ClientCaptureEvent&)>& consumer);
+
+}  // namespace orbit_grpc_protos
+
+#endif  // GRPC_PROTOS_COLUMNAR_CAPTURE_EVENTS_H_
@@ -7,16 +7,20 @@
 #include <absl/base/attributes.h>
 #include <absl/base/const_init.h>
 #include <absl/synchronization/mutex.h>
+#include <absl/time/time.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <ctime>
-#include <memory>
+#include <type_traits>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include "OrbitBase/Logging.h"
+#include "OrbitBase/PerThreadSpscQueues.h"
 #include "OrbitBase/Profiling.h"
-#include "OrbitBase/ThreadPool.h"
 #include "OrbitBase/ThreadUtils.h"
 
 using orbit_api::ApiEventVariant;
@@ -24,82 +28,200 @@ using orbit_introspection::IntrospectionEventCallback;
 using orbit_introspection::IntrospectionListener;
 
 ABSL_CONST_INIT static absl::Mutex global_introspection_mutex(absl::kConstInit);
-ABSL_CONST_INIT static IntrospectionListener* global_introspection_listener
-    ABSL_GUARDED_BY(global_introspection_mutex) = nullptr;
+ABSL_CONST_INIT static uint64_t global_next_listener_id ABSL_GUARDED_BY(global_introspection_mutex) =
+    1;
+// The id of the listener that events are currently buffered for, or 0 if there is none. Read
+// without locking by instrumented threads.
+static std::atomic<uint64_t> global_accepting_listener_id = 0;
 
 // Introspection uses the same function table used by the Orbit API, but specifies its own
 // functions.
 orbit_api_v2 g_orbit_api;
 
+namespace {
+
+// Events are tagged with the listener they were produced for: an instrumented thread that read the
+// id just before the listener shut down can still buffer its event afterwards, and such an event
+// must not reach the next listener.
+struct IntrospectionEvent {
+  uint64_t listener_id = 0;
+  // The timestamp of `api_event`, by which the drain thread orders the events.
+  uint64_t timestamp_ns = 0;
+  ApiEventVariant api_event;
+};
+
+[[nodiscard]] orbit_base::PerThreadSpscQueues<IntrospectionEvent>& GetIntrospectionEventQueues() {
+  // Never destroyed, as instrumented threads could still be running during static destruction.
+  // Many threads of the process are instrumented but produce few events, so start small.
+  constexpr size_t kInitialCapacityPerThread = 16;
+  static auto* queues =
+      new orbit_base::PerThreadSpscQueues<IntrospectionEvent>(kInitialCapacityPerThread);
+  return *queues;
+}
+
+[[nodiscard]] uint64_t GetTimestampNs(const ApiEventVariant& api_event) {
+  return std::visit(
+      [](const auto& event) -> uint64_t {
+        if constexpr (std::is_same_v<std::decay_t<decltype(event)>, std::monostate>) {
+          return 0;
+        } else {
+          return event.meta_data.timestamp_ns;
+        }
+      },
+      api_event);
+}
+
+[[nodiscard]] bool HasEarlierTimestamp(const IntrospectionEvent& lhs,
+                                       const IntrospectionEvent& rhs) {
+  return lhs.timestamp_ns < rhs.timestamp_ns;
+}
+
+// Prevents reentry, which would cause a feedback loop, for events produced by the user callback.
+thread_local bool is_introspection_drain_thread = false;
+
+// Checked before even building an event, so that ORBIT_* calls are cheap while no listener is
+// active.
+[[nodiscard]] bool IsEventDiscarded() {
+  return is_introspection_drain_thread ||
+         global_accepting_listener_id.load(std::memory_order_relaxed) == 0;
+}
+
+}  // namespace
+
 namespace orbit_introspection {
 
 void InitializeIntrospection();
 
 IntrospectionListener::IntrospectionListener(IntrospectionEventCallback callback)
     : user_callback_{std::move(callback)} {
-  constexpr size_t kMinNumThreads = 1;
-  constexpr size_t kMaxNumThreads = 1;
-  thread_pool_ =
-      orbit_base::ThreadPool::Create(kMinNumThreads, kMaxNumThreads, absl::Milliseconds(500));
-
   // Activate listener (only one listener instance is supported).
   absl::MutexLock lock(&global_introspection_mutex);
   ORBIT_CHECK(!IsActive());
   InitializeIntrospection();
-  global_introspection_listener = this;
+  id_ = global_next_listener_id++;
+  drain_thread_ = std::thread{[this] { DrainEvents(); }};
   active_ = true;
-  shutdown_initiated_ = false;
+  global_accepting_listener_id.store(id_, std::memory_order_release);
 }
 
 IntrospectionListener::~IntrospectionListener() {
-  // Communicate that the thread pool will be shut down before shutting down
-  // the thread pool itself.
-  // Note that this is required, as otherwise, we might allow scheduling
-  // new events on the already shut down thread pool.
+  // Stop buffering new events, then let the drain thread pass the remaining ones to the callback.
   {
     absl::MutexLock lock(&global_introspection_mutex);
     ORBIT_CHECK(IsActive());
-    shutdown_initiated_ = true;
+    global_accepting_listener_id.store(0, std::memory_order_release);
   }
-  // Purge deferred scopes.
-  thread_pool_->Shutdown();
-  thread_pool_->Wait();
+  {
+    absl::MutexLock lock(&drain_mutex_);
+    drain_stop_requested_ = true;
+  }
+  drain_thread_.join();
 
-  // Deactivate and destroy the listener.
+  // Deactivate the listener.
   absl::MutexLock lock(&global_introspection_mutex);
   active_ = false;
-  global_introspection_listener = nullptr;
 }
 
-}  // namespace orbit_introspection
+bool IntrospectionListener::IsShutdownInitiated() {
+  return global_accepting_listener_id.load(std::memory_order_relaxed) == 0;
+}
 
-namespace {
-struct ScopeToggle {
-  ScopeToggle() = delete;
-  ScopeToggle(bool* value, bool initial_value) : toggle(value) { *toggle = initial_value; }
-  ~ScopeToggle() { *toggle = !*toggle; }
-  bool* toggle = nullptr;
-};
-}  // namespace
+void IntrospectionListener::DrainEvents() {
+  orbit_base::SetCurrentThreadName("Introspection");
+  is_introspection_drain_thread = true;
 
-void IntrospectionListener::DeferApiEventProcessing(const orbit_api::ApiEventVariant& api_event) {
-  // Prevent reentry to avoid feedback loop.
-  thread_local bool is_internal_update = false;
-  if (is_internal_update) return;
+  constexpr size_t kMaxBatchSize = 1024;
+  constexpr absl::Duration kDrainInterval = absl::Milliseconds(5);
+  orbit_base::PerThreadSpscQueues<IntrospectionEvent>& queues = GetIntrospectionEventQueues();
+  // Holding events back until a pass completes needs the buffers to get empty. When threads keep
+  // producing events as fast as they are drained, the oldest events are passed to the callback
+  // once there are more than this many, even though an event with an earlier timestamp might still
+  // be buffered, to bound memory and latency.
+  constexpr size_t kMaxPendingEventCount = 4 * 1024;
+  // Events are dequeued directly to the end of this vector. The ones from first_pending_index on
+  // were not yet passed to the callback and are sorted by timestamp. The ones before are removed
+  // once they make up half of the vector, so that each event is moved at most about once more.
+  std::vector<IntrospectionEvent> events;
+  size_t first_pending_index = 0;
+  // A pass dequeues until all buffers are empty. By its end, it has dequeued every event that was
+  // buffered before it started, hence every event with an earlier timestamp, as threads take the
+  // timestamp right before buffering the event.
+  uint64_t pass_start_timestamp_ns = orbit_base::CaptureTimestampNs();
+  uint64_t release_before_timestamp_ns = 0;
+  bool stop_requested = false;
+  while (true) {
+    const size_t previous_event_count = events.size();
+    events.resize(previous_event_count + kMaxBatchSize);
+    const size_t count = queues.DequeueBulk(&events[previous_event_count], kMaxBatchSize);
+    const auto new_events_begin = events.begin() + static_cast<ptrdiff_t>(previous_event_count);
+    // Skip the events left over from a previous listener.
+    events.erase(std::remove_if(new_events_begin, new_events_begin + static_cast<ptrdiff_t>(count),
+                                [this](const IntrospectionEvent& event) {
+                                  return event.listener_id != id_;
+                                }),
+                 events.end());
 
-  // User callback is called from a worker thread to minimize contention on instrumented threads.
-  absl::MutexLock lock(&global_introspection_mutex);
-  if (IsShutdownInitiated()) return;
-  global_introspection_listener->thread_pool_->Schedule([api_event]() {
-    ScopeToggle scope_toggle(&is_internal_update, true);
-    absl::MutexLock lock(&global_introspection_mutex);
-    if (!IsActive()) return;
-    global_introspection_listener->user_callback_(api_event);
-  });
+    // Events of one thread are already in order, so this is often already sorted.
+    const auto pending_events_begin = events.begin() + static_cast<ptrdiff_t>(first_pending_index);
+    if (!std::is_sorted(new_events_begin, events.end(), HasEarlierTimestamp)) {
+      std::stable_sort(new_events_begin, events.end(), HasEarlierTimestamp);
+    }
+    if (new_events_begin != pending_events_begin && new_events_begin != events.end() &&
+        HasEarlierTimestamp(*new_events_begin, *(new_events_begin - 1))) {
+      std::inplace_merge(pending_events_begin, new_events_begin, events.end(),
+                         HasEarlierTimestamp);
+    }
+
+    const bool pass_completed = count < kMaxBatchSize;
+    if (pass_completed) release_before_timestamp_ns = pass_start_timestamp_ns;
+    // Once shutting down, no more events can arrive for this listener after the last pass.
+    auto release_end =
+        stop_requested && pass_completed
+            ? events.end()
+            : std::partition_point(pending_events_begin, events.end(),
+                                   [release_before_timestamp_ns](const IntrospectionEvent& event) {
+                                     return event.timestamp_ns < release_before_timestamp_ns;
+                                   });
+    if (events.end() - release_end > static_cast<ptrdiff_t>(kMaxPendingEventCount)) {
+      release_end = events.end() - static_cast<ptrdiff_t>(kMaxPendingEventCount);
+    }
+    for (auto it = pending_events_begin; it != release_end; ++it) {
+      user_callback_(it->api_event);
+    }
+    first_pending_index = release_end - events.begin();
+    if (2 * first_pending_index >= events.size()) {
+      events.erase(events.begin(), release_end);
+      first_pending_index = 0;
+    }
+    if (!pass_completed) continue;
+
+    if (stop_requested) {
+      queues.ReleaseUnusedMemory();
+      break;
+    }
+    {
+      absl::MutexLock lock(&drain_mutex_);
+      stop_requested =
+          drain_mutex_.AwaitWithTimeout(absl::Condition(&drain_stop_requested_), kDrainInterval);
+    }
+    pass_start_timestamp_ns = orbit_base::CaptureTimestampNs();
+  }
+}
+
+}  // namespace orbit_introspection
+
+void IntrospectionListener::DeferApiEventProcessing(orbit_api::ApiEventVariant api_event) {
+  if (is_introspection_drain_thread) return;
+  const uint64_t listener_id = global_accepting_listener_id.load(std::memory_order_acquire);
+  if (listener_id == 0) return;
+  const uint64_t timestamp_ns = GetTimestampNs(api_event);
+  GetIntrospectionEventQueues().Enqueue(
+      IntrospectionEvent{listener_id, timestamp_ns, std::move(api_event)});
 }
 
 void orbit_api_start_v1(const char* name, orbit_api_color color, uint64_t group_id,
                         uint64_t caller_address) {
+  if (IsEventDiscarded()) return;
   uint32_t process_id = orbit_base::GetCurrentProcessId();
   uint32_t thread_id = orbit_base::GetCurrentThreadId();
   uint64_t timestamp_ns = orbit_base::CaptureTimestampNs();
@@ -108,19 +230,21 @@ void orbit_api_start_v1(const char* name, orbit_api_color color, uint64_t group_
   }
   orbit_api::ApiScopeStart api_scope_start{process_id, thread_id, timestamp_ns,  name,
                                            color,      group_id,  caller_address};
-  IntrospectionListener::DeferApiEventProcessing(api_scope_start);
+  IntrospectionListener::DeferApiEventProcessing(std::move(api_scope_start));
 }
 
 void orbit_api_stop() {
+  if (IsEventDiscarded()) return;
   uint32_t process_id = orbit_base::GetCurrentProcessId();
   uint32_t thread_id = orbit_base::GetCurrentThreadId();
   uint64_t timestamp_ns = orbit_base::CaptureTimestampNs();
   orbit_api::ApiScopeStop api_scope_stop{process_id, thread_id, timestamp_ns};
-  IntrospectionListener::DeferApiEventProcessing(api_scope_stop);
+  IntrospectionListener::DeferApiEventProcessing(std::move(api_scope_stop));
 }
 
 void orbit_api_start_async_v1(const char* name, uint64_t id, orbit_api_color color,
                               uint64_t caller_address) {
+  if (IsEventDiscarded()) return;
   uint32_t process_id = orbit_base::GetCurrentProcessId();
   uint32_t thread_id = orbit_base::GetCurrentThreadId();
   uint64_t timestamp_ns = orbit_base::CaptureTimestampNs();
@@ -129,71 +253,79 @@ void orbit_api_start_async_v1(const char* name, uint64_t id, orbit_api_color col
   }
   orbit_api::ApiScopeStartAsync api_scope_start_async{process_id, thread_id, timestamp_ns,  name,
                                                       id,         color,     caller_address};
-  IntrospectionListener::DeferApiEventProcessing(api_scope_start_async);
+  IntrospectionListener::DeferApiEventProcessing(std::move(api_scope_start_async));
 }
 
 void orbit_api_stop_async(uint64_t id) {
+  if (IsEventDiscarded()) return;
   uint32_t process_id = orbit_base::GetCurrentProcessId();
   uint32_t thread_id = orbit_base::GetCurrentThreadId();
   uint64_t timestamp_ns = orbit_base::CaptureTimestampNs();
   orbit_api::ApiScopeStopAsync api_scope_stop_async{process_id, thread_id, timestamp_ns, id};
-  IntrospectionListener::DeferApiEventProcessing(api_scope_stop_async);
+  IntrospectionListener::DeferApiEventProcessing(std::move(api_scope_stop_async));
 }
 
 void orbit_api_async_string(const char* str, uint64_t id, orbit_api_color color) {
+  if (IsEventDiscarded()) return;
   uint32_t process_id = orbit_base::GetCurrentProcessId();
   uint32_t thread_id = orbit_base::GetCurrentThreadId();
   uint64_t timestamp_ns = orbit_base::CaptureTimestampNs();
   orbit_api::ApiStringEvent api_string_event{process_id, thread_id, timestamp_ns, str, id, color};
-  IntrospectionListener::DeferApiEventProcessing(api_string_event);
+  IntrospectionListener::DeferApiEventProcessing(std::move(api_string_event));
 }
 
 void orbit_api_track_int(const char* name, int value, orbit_api_color color) {
+  if (IsEventDiscarded()) return;
   uint32_t process_id = orbit_base::GetCurrentProcessId();
   uint32_t thread_id = orbit_base::GetCurrentThreadId();
   uint64_t timestamp_ns = orbit_base::CaptureTimestampNs();
   orbit_api::ApiTrackInt api_track{process_id, thread_id, timestamp_ns, name, value, color};
-  IntrospectionListener::DeferApiEventProcessing(api_track);
+  IntrospectionListener::DeferApiEventProcessing(std::move(api_track));
 }
 
 void orbit_api_track_int64(const char* name, int64_t value, orbit_api_color color) {
+  if (IsEventDiscarded()) return;
   uint32_t process_id = orbit_base::GetCurrentProcessId();
   uint32_t thread_id = orbit_base::GetCurrentThreadId();
   uint64_t timestamp_ns = orbit_base::CaptureTimestampNs();
   orbit_api::ApiTrackInt64 api_track{process_id, thread_id, timestamp_ns, name, value, color};
-  IntrospectionListener::DeferApiEventProcessing(api_track);
+  IntrospectionListener::DeferApiEventProcessing(std::move(api_track));
 }
 
 void orbit_api_track_uint(const char* name, uint32_t value, orbit_api_color color) {
+  if (IsEventDiscarded()) return;
   uint32_t process_id = orbit_base::GetCurrentProcessId();
   uint32_t thread_id = orbit_base::GetCurrentThreadId();
   uint64_t timestamp_ns = orbit_base::CaptureTimestampNs();
   orbit_api::ApiTrackUint api_track{process_id, thread_id, timestamp_ns, name, value, color};
-  IntrospectionListener::DeferApiEventProcessing(api_track);
+  IntrospectionListener::DeferApiEventProcessing(std::move(api_track));
 }
 
 void orbit_api_track_uint64(const char* name, uint64_t value, orbit_api_color color) {
+  if (IsEventDiscarded()) return;
   uint32_t process_id = orbit_base::GetCurrentProcessId();
   uint32_t thread_id = orbit_base::GetCurrentThreadId();
   uint64_t timestamp_ns = orbit_base::CaptureTimestampNs();
   orbit_api::ApiTrackUint64 api_track{process_id, thread_id, timestamp_ns, name, value, color};
-  IntrospectionListener::DeferApiEventProcessing(api_track);
+  IntrospectionListener::DeferApiEventProcessing(std::move(api_track));
 }
 
 void orbit_api_track_float(const char* name, float value, orbit_api_color color) {
+  if (IsEventDiscarded()) return;
   uint32_t process_id = orbit_base::GetCurrentProcessId();
   uint32_t thread_id = orbit_base::GetCurrentThreadId();
   uint64_t timestamp_ns = orbit_base::CaptureTimestampNs();
   orbit_api::ApiTrackFloat api_track{process_id, thread_id, timestamp_ns, name, value, color};
-  IntrospectionListener::DeferApiEventProcessing(api_track);
+  IntrospectionListener::DeferApiEventProcessing(std::move(api_track));
 }
 
 void orbit_api_track_double(const char* name, double value, orbit_api_color color) {
+  if (IsEventDiscarded()) return;
   uint32_t process_id = orbit_base::GetCurrentProcessId();
   uint32_t thread_id = orbit_base::GetCurrentThreadId();
   uint64_t timestamp_ns = orbit_base::CaptureTimestampNs();
   orbit_api::ApiTrackDouble api_track{process_id, thread_id, timestamp_ns, name, value, color};
-  IntrospectionListener::DeferApiEventProcessing(api_track);
+  IntrospectionListener::DeferApiEventProcessing(std::move(api_track));
 }
 
 namespace orbit_introspection {
@@ -3,16 +3,21 @@
 // found in the LICENSE file.
 
 #include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
 #include <gtest/gtest.h>
 #include <stddef.h>
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <thread>
+#include <variant>
 #include <vector>
 
 #include "ApiUtils/Event.h"
 #include "Introspection/Introspection.h"
+#include "OrbitBase/Logging.h"
+#include "OrbitBase/Profiling.h"
 #include "OrbitBase/ThreadUtils.h"
 
 static void TestScopes() {
@@ -105,4 +110,77 @@ TEST(Tracing, Scopes) {
   }
 }
 
+TEST(Tracing, AsyncScopeStartedAndStoppedOnDifferentThreadsArrivesInOrder) {
+  constexpr uint64_t kNumAsyncScopes = 100'000;
+
+  absl::flat_hash_set<uint64_t> started_ids;
+  uint64_t stopped_before_started_count = 0;
+  uint64_t stopped_count = 0;
+  {
+    IntrospectionListener tracing_listener([&](const orbit_api::ApiEventVariant& api_event) {
+      if (const auto* start = std::get_if<orbit_api::ApiScopeStartAsync>(&api_event)) {
+        started_ids.insert(start->id);
+      } else if (const auto* stop = std::get_if<orbit_api::ApiScopeStopAsync>(&api_event)) {
+        if (!started_ids.contains(stop->id)) ++stopped_before_started_count;
+        ++stopped_count;
+      }
+    });
+
+    // Each scope is started on one thread and stopped on the other right after.
+    std::atomic<uint64_t> last_started_id = 0;
+    std::thread starting_thread{[&last_started_id] {
+      for (uint64_t id = 1; id <= kNumAsyncScopes; ++id) {
+        ORBIT_START_ASYNC("TEST_ORBIT_START_ASYNC", id);
+        last_started_id.store(id, std::memory_order_release);
+      }
+    }};
+    std::thread stopping_thread{[&last_started_id] {
+      uint64_t last_stopped_id = 0;
+      while (last_stopped_id < kNumAsyncScopes) {
+        const uint64_t last_started = last_started_id.load(std::memory_order_acquire);
+        for (uint64_t id = last_stopped_id + 1; id <= last_started; ++id) {
+          ORBIT_STOP_ASYNC(id);
+        }
+        last_stopped_id = last_started;
+      }
+    }};
+    starting_thread.join();
+    stopping_thread.join();
+  }
+
+  EXPECT_EQ(stopped_count, kNumAsyncScopes);
+  EXPECT_EQ(stopped_before_started_count, 0);
+}
+
+namespace {
+
+constexpr uint64_t kBenchmarkScopeCount = 200'000;
+
+[[nodiscard]] double MeasureOrbitScopeNs() {
+  const uint64_t start_ns = orbit_base::CaptureTimestampNs();
+  for (uint64_t i = 0; i < kBenchmarkScopeCount; ++i) {
+    ORBIT_SCOPE("BENCHMARK_ORBIT_SCOPE");
+  }
+  return static_cast<double>(orbit_base::CaptureTimestampNs() - start_ns) / kBenchmarkScopeCount;
+}
+
+}  // namespace
+
+// Logs the cost of ORBIT_SCOPE with and without an IntrospectionListener. Disabled by default, run
+// it with --gtest_also_run_disabled_tests.
+TEST(Tracing, DISABLED_BenchmarkOrbitScope) {
+  ORBIT_LOG("ORBIT_SCOPE without IntrospectionListener: %.1f ns", MeasureOrbitScopeNs());
+
+  std::atomic<uint64_t> event_count = 0;
+  {
+    IntrospectionListener tracing_listener(
+        [&event_count](const orbit_api::ApiEventVariant& /*api_event*/) {
+          event_count.fetch_add(1, std::memory_order_relaxed);
+        });
+    ORBIT_LOG("ORBIT_SCOPE with IntrospectionListener: %.1f ns", MeasureOrbitScopeNs());
+  }
+  // One start and one stop event per scope.
+  EXPECT_EQ(event_count, 2 * kBenchmarkScopeCount);
+}
+
 }  // namespace orbit_introspection
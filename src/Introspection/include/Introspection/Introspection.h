@@ -5,14 +5,15 @@
 #ifndef INTROSPECTION_INTROSPECTION_H_
 #define INTROSPECTION_INTROSPECTION_H_
 
+#include <absl/base/thread_annotations.h>
+#include <absl/synchronization/mutex.h>
 #include <stdint.h>
 
 #include <functional>
-#include <memory>
+#include <thread>
 
 #include "ApiInterface/Orbit.h"
 #include "ApiUtils/Event.h"
-#include "OrbitBase/ThreadPool.h"
 #include "OrbitBase/ThreadUtils.h"
 
 #define ORBIT_SCOPE_FUNCTION ORBIT_SCOPE(__FUNCTION__)
@@ -21,6 +22,16 @@ namespace orbit_introspection {
 
 using IntrospectionEventCallback = std::function<void(const orbit_api::ApiEventVariant& api_event)>;
 
+// While an IntrospectionListener exists, the events of the ORBIT_* macros used in this process are
+// passed to its callback. Instrumented threads only append their events to a buffer of their own,
+// and a single thread of the listener periodically drains all buffers and calls the callback.
+// The buffers don't preserve the order between threads, so the drain thread sorts the events by
+// timestamp and holds each one back until all events with an earlier timestamp were drained. This
+// way, the callback gets an ORBIT_START_ASYNC before the matching ORBIT_STOP_ASYNC from another
+// thread, which ApiEventProcessor relies on. An event can still arrive after later ones if its
+// thread was preempted between taking the timestamp and buffering the event, or if events are
+// produced as fast as they are drained for long enough that the drain thread holds back 4096 of
+// them.
 class IntrospectionListener {
  public:
   explicit IntrospectionListener(IntrospectionEventCallback callback);
@@ -31,15 +42,19 @@ class IntrospectionListener {
   IntrospectionListener(IntrospectionListener&& other) = delete;
   IntrospectionListener& operator=(IntrospectionListener&& other) = delete;
 
-  static void DeferApiEventProcessing(const orbit_api::ApiEventVariant& api_event);
+  static void DeferApiEventProcessing(orbit_api::ApiEventVariant api_event);
   [[nodiscard]] static bool IsActive() { return active_; }
-  [[nodiscard]] static bool IsShutdownInitiated() { return shutdown_initiated_; }
+  [[nodiscard]] static bool IsShutdownInitiated();
 
  private:
+  void DrainEvents();
+
   IntrospectionEventCallback user_callback_ = nullptr;
-  std::shared_ptr<orbit_base::ThreadPool> thread_pool_ = {};
+  uint64_t id_ = 0;
+  absl::Mutex drain_mutex_;
+  bool drain_stop_requested_ ABSL_GUARDED_BY(drain_mutex_) = false;
+  std::thread drain_thread_;
   inline static bool active_ = false;
-  inline static bool shutdown_initiated_ = true;
 };
 
 }  // namespace orbit_introspection
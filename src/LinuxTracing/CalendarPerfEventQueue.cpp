@@ -0,0 +1,244 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "CalendarPerfEventQueue.h"
+
+#include <algorithm>
+#include <new>
+#include <utility>
+
+#include "OrbitBase/Logging.h"
+
+namespace orbit_linux_tracing {
+
+namespace {
+// Needs to be a power of two.
+constexpr size_t kBucketCount = 16384;
+}  // namespace
+
+CalendarPerfEventQueue::CalendarPerfEventQueue(uint64_t reordering_window_ns)
+    : buckets_(kBucketCount) {
+  // Let the buckets cover at least twice the reordering window, so that most of the events fit.
+  bucket_width_log2_ = 0;
+  while ((uint64_t{1} << bucket_width_log2_) * kBucketCount < 2 * reordering_window_ns) {
+    ++bucket_width_log2_;
+  }
+}
+
+CalendarPerfEventQueue::~CalendarPerfEventQueue() {
+  for (Stream& stream : streams_) {
+    while (!stream.IsEmpty()) {
+      PopFrontOfStream(&stream);
+    }
+  }
+}
+
+void CalendarPerfEventQueue::PushEvent(PerfEvent&& event) {
+  const PerfEventOrderedStream ordered_stream = event.ordered_stream;
+  if (ordered_stream != PerfEventOrderedStream::kNone) {
+    if (auto stream_index_it = ordered_stream_to_stream_index_.find(ordered_stream);
+        stream_index_it != ordered_stream_to_stream_index_.end()) {
+      Stream& stream = streams_[stream_index_it->second];
+      ORBIT_CHECK(!stream.IsEmpty());
+      // Fundamental assumption: events from the same ordered stream come already in order.
+      ORBIT_CHECK(event.timestamp >= stream.Back().timestamp);
+      PushBackToStream(&stream, std::move(event));
+      ++event_count_;
+      return;
+    }
+  }
+
+  const uint64_t timestamp = event.timestamp;
+  const uint32_t stream_index = AcquireStream(ordered_stream);
+  PushBackToStream(&streams_[stream_index], std::move(event));
+  ++event_count_;
+  InsertHead(Head{
+      .timestamp = timestamp,
+      .stream_index = stream_index,
+      .is_ordered_in_stream = ordered_stream != PerfEventOrderedStream::kNone,
+  });
+}
+
+const PerfEvent& CalendarPerfEventQueue::TopEvent() {
+  ORBIT_CHECK(HasEvent());
+  MoveToOldestHead();
+  return streams_[CurrentBucket().front().stream_index].Front();
+}
+
+void CalendarPerfEventQueue::PopEvent() {
+  ORBIT_CHECK(HasEvent());
+  MoveToOldestHead();
+  std::vector<Head>& current_bucket = CurrentBucket();
+  const uint32_t stream_index = current_bucket.front().stream_index;
+  Stream& stream = streams_[stream_index];
+  PopFrontOfStream(&stream);
+  --event_count_;
+
+  if (!stream.IsEmpty() && BucketOf(stream.Front().timestamp) <= current_bucket_) {
+    // The most common case: the next event of the same stream also belongs to the current bucket,
+    // so the head can simply be updated and moved down the heap.
+    current_bucket.front().timestamp = stream.Front().timestamp;
+    MoveDownFrontOfCurrentBucket();
+    return;
+  }
+
+  std::pop_heap(current_bucket.begin(), current_bucket.end(), HeadIsNewer{});
+  current_bucket.pop_back();
+  --heads_in_buckets_count_;
+  if (stream.IsEmpty()) {
+    ReleaseStream(stream_index);
+    return;
+  }
+  InsertHead(Head{
+      .timestamp = stream.Front().timestamp,
+      .stream_index = stream_index,
+      .is_ordered_in_stream = true,
+  });
+}
+
+void CalendarPerfEventQueue::MoveDownFrontOfCurrentBucket() {
+  std::vector<Head>& current_bucket = CurrentBucket();
+  const size_t size = current_bucket.size();
+  size_t current_index = 0;
+  while (true) {
+    size_t new_index = current_index;
+    const size_t left_index = current_index * 2 + 1;
+    const size_t right_index = current_index * 2 + 2;
+    if (left_index < size &&
+        HeadIsNewer{}(current_bucket[new_index], current_bucket[left_index])) {
+      new_index = left_index;
+    }
+    if (right_index < size &&
+        HeadIsNewer{}(current_bucket[new_index], current_bucket[right_index])) {
+      new_index = right_index;
+    }
+    if (new_index == current_index) {
+      break;
+    }
+    std::swap(current_bucket[new_index], current_bucket[current_index]);
+    current_index = new_index;
+  }
+}
+
+void CalendarPerfEventQueue::PushBackToStream(Stream* stream, PerfEvent&& event) {
+  if (stream->IsEmpty()) {
+    stream->front_chunk = AcquireChunk();
+    stream->front_index = 0;
+    stream->back_chunk = stream->front_chunk;
+    stream->back_size = 0;
+  } else if (stream->back_size == EventChunk::kCapacity) {
+    EventChunk* new_back_chunk = AcquireChunk();
+    stream->back_chunk->next = new_back_chunk;
+    stream->back_chunk = new_back_chunk;
+    stream->back_size = 0;
+  }
+  new (&stream->back_chunk->slots[stream->back_size]) PerfEvent{std::move(event)};
+  ++stream->back_size;
+}
+
+void CalendarPerfEventQueue::PopFrontOfStream(Stream* stream) {
+  ORBIT_CHECK(!stream->IsEmpty());
+  stream->Front().~PerfEvent();
+  ++stream->front_index;
+  if (stream->front_chunk == stream->back_chunk && stream->front_index == stream->back_size) {
+    ReleaseChunk(stream->front_chunk);
+    stream->front_chunk = nullptr;
+    stream->back_chunk = nullptr;
+  } else if (stream->front_index == EventChunk::kCapacity) {
+    EventChunk* old_front_chunk = stream->front_chunk;
+    stream->front_chunk = old_front_chunk->next;
+    stream->front_index = 0;
+    ReleaseChunk(old_front_chunk);
+  }
+}
+
+CalendarPerfEventQueue::EventChunk* CalendarPerfEventQueue::AcquireChunk() {
+  if (free_chunks_ == nullptr) {
+    return chunks_.emplace_back(std::make_unique<EventChunk>()).get();
+  }
+  EventChunk* chunk = free_chunks_;
+  free_chunks_ = chunk->next;
+  chunk->next = nullptr;
+  return chunk;
+}
+
+void CalendarPerfEventQueue::ReleaseChunk(EventChunk* chunk) {
+  chunk->next = free_chunks_;
+  free_chunks_ = chunk;
+}
+
+uint32_t CalendarPerfEventQueue::AcquireStream(PerfEventOrderedStream ordered_stream) {
+  uint32_t stream_index;
+  if (!free_stream_indices_.empty()) {
+    stream_index = free_stream_indices_.back();
+    free_stream_indices_.pop_back();
+  } else {
+    stream_index = streams_.size();
+    streams_.emplace_back();
+  }
+  streams_[stream_index].ordered_stream = ordered_stream;
+  if (ordered_stream != PerfEventOrderedStream::kNone) {
+    ordered_stream_to_stream_index_.emplace(ordered_stream, stream_index);
+  }
+  return stream_index;
+}
+
+void CalendarPerfEventQueue::ReleaseStream(uint32_t stream_index) {
+  Stream& stream = streams_[stream_index];
+  ORBIT_CHECK(stream.IsEmpty());
+  if (stream.ordered_stream != PerfEventOrderedStream::kNone) {
+    ordered_stream_to_stream_index_.erase(stream.ordered_stream);
+    stream.ordered_stream = PerfEventOrderedStream::kNone;
+  }
+  free_stream_indices_.push_back(stream_index);
+}
+
+void CalendarPerfEventQueue::InsertHead(const Head& head) {
+  const uint64_t bucket = BucketOf(head.timestamp);
+  if (bucket <= current_bucket_) {
+    std::vector<Head>& current_bucket = CurrentBucket();
+    current_bucket.push_back(head);
+    std::push_heap(current_bucket.begin(), current_bucket.end(), HeadIsNewer{});
+    ++heads_in_buckets_count_;
+  } else if (bucket - current_bucket_ < buckets_.size()) {
+    buckets_[bucket & (buckets_.size() - 1)].push_back(head);
+    ++heads_in_buckets_count_;
+  } else {
+    far_future_heads_.push_back(head);
+    std::push_heap(far_future_heads_.begin(), far_future_heads_.end(), HeadIsNewer{});
+  }
+}
+
+void CalendarPerfEventQueue::MoveToOldestHead() {
+  while (CurrentBucket().empty()) {
+    if (heads_in_buckets_count_ > 0) {
+      AdvanceCurrentBucket(current_bucket_ + 1);
+    } else {
+      // Jump directly to the oldest head instead of iterating over empty buckets.
+      ORBIT_CHECK(!far_future_heads_.empty());
+      AdvanceCurrentBucket(BucketOf(far_future_heads_.front().timestamp));
+    }
+  }
+}
+
+void CalendarPerfEventQueue::AdvanceCurrentBucket(uint64_t new_current_bucket) {
+  ORBIT_CHECK(CurrentBucket().empty());
+  ORBIT_CHECK(new_current_bucket > current_bucket_);
+  current_bucket_ = new_current_bucket;
+
+  while (!far_future_heads_.empty() &&
+         BucketOf(far_future_heads_.front().timestamp) - current_bucket_ < buckets_.size()) {
+    std::pop_heap(far_future_heads_.begin(), far_future_heads_.end(), HeadIsNewer{});
+    const Head head = far_future_heads_.back();
+    far_future_heads_.pop_back();
+    buckets_[BucketOf(head.timestamp) & (buckets_.size() - 1)].push_back(head);
+    ++heads_in_buckets_count_;
+  }
+
+  // Only the current bucket is kept as a heap.
+  std::vector<Head>& current_bucket = CurrentBucket();
+  std::make_heap(current_bucket.begin(), current_bucket.end(), HeadIsNewer{});
+}
+
+}  // namespace orbit_linux_tracing
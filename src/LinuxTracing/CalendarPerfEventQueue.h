@@ -0,0 +1,137 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef LINUX_TRACING_CALENDAR_PERF_EVENT_QUEUE_H_
+#define LINUX_TRACING_CALENDAR_PERF_EVENT_QUEUE_H_
+
+#include <absl/container/flat_hash_map.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "PerfEvent.h"
+#include "PerfEventOrderedStream.h"
+
+namespace orbit_linux_tracing {
+
+// This class has the same interface and the same semantics as PerfEventQueue, but exploits the fact
+// that PerfEventProcessor only keeps events in the queue for a bounded amount of time (the
+// reordering window), and is designed to avoid memory allocations in the steady state.
+//
+// As in PerfEventQueue, events that come from the same ordered stream are kept in a queue per
+// stream, and only the oldest event of each stream (its "head") needs to be ordered with respect to
+// the other streams. Events that are not ordered in any stream are simply treated as streams of a
+// single event. The memory for the events is retained and reused rather than freed.
+//
+// The heads are ordered using a calendar queue: the time is divided into many small buckets of
+// fixed width and a circular array of buckets covers the reordering window. A head is appended to
+// the bucket its timestamp falls into, and only the current bucket, i.e., the one containing the
+// oldest events, is kept as a binary heap. Heads further in the future than the buckets cover are
+// kept in a separate heap and moved to their bucket as the current bucket advances, and heads older
+// than the current bucket are simply added to the current bucket. As the buckets are small, the
+// heap in which most heads are inserted and removed stays small even with thousands of streams.
+class CalendarPerfEventQueue {
+ public:
+  explicit CalendarPerfEventQueue(uint64_t reordering_window_ns);
+  CalendarPerfEventQueue(const CalendarPerfEventQueue&) = delete;
+  CalendarPerfEventQueue& operator=(const CalendarPerfEventQueue&) = delete;
+  CalendarPerfEventQueue(CalendarPerfEventQueue&&) = delete;
+  CalendarPerfEventQueue& operator=(CalendarPerfEventQueue&&) = delete;
+  ~CalendarPerfEventQueue();
+
+  void PushEvent(PerfEvent&& event);
+  [[nodiscard]] bool HasEvent() const { return event_count_ > 0; }
+  [[nodiscard]] const PerfEvent& TopEvent();
+  void PopEvent();
+
+ private:
+  // Events are stored in chunks of fixed size, which are recycled through a free list shared by all
+  // streams instead of being freed. As the chunks that were freed last are reused first, events
+  // that are added at around the same time are close in memory, also across streams, which is good
+  // for locality as events are removed in order of timestamp.
+  struct EventChunk {
+    static constexpr size_t kCapacity = 8;
+    std::aligned_storage_t<sizeof(PerfEvent), alignof(PerfEvent)> slots[kCapacity];
+    EventChunk* next = nullptr;
+
+    [[nodiscard]] PerfEvent* EventAt(size_t index) {
+      return std::launder(reinterpret_cast<PerfEvent*>(&slots[index]));
+    }
+  };
+
+  // A FIFO queue of events, as a linked list of EventChunks.
+  struct Stream {
+    EventChunk* front_chunk = nullptr;
+    size_t front_index = 0;
+    EventChunk* back_chunk = nullptr;
+    size_t back_size = 0;
+    // PerfEventOrderedStream::kNone for streams that hold a single event not ordered in any stream.
+    PerfEventOrderedStream ordered_stream = PerfEventOrderedStream::kNone;
+
+    [[nodiscard]] bool IsEmpty() const { return front_chunk == nullptr; }
+    [[nodiscard]] PerfEvent& Front() const { return *front_chunk->EventAt(front_index); }
+    [[nodiscard]] PerfEvent& Back() const { return *back_chunk->EventAt(back_size - 1); }
+  };
+
+  struct Head {
+    uint64_t timestamp;
+    uint32_t stream_index;
+    // Events not ordered in any stream come first among events with the same timestamp, like in
+    // PerfEventQueue.
+    bool is_ordered_in_stream;
+  };
+  // Comparison for the heaps of heads, which have the oldest head at the front.
+  struct HeadIsNewer {
+    bool operator()(const Head& lhs, const Head& rhs) const {
+      if (lhs.timestamp != rhs.timestamp) return lhs.timestamp > rhs.timestamp;
+      return lhs.is_ordered_in_stream && !rhs.is_ordered_in_stream;
+    }
+  };
+
+  [[nodiscard]] uint64_t BucketOf(uint64_t timestamp) const {
+    return timestamp >> bucket_width_log2_;
+  }
+  [[nodiscard]] std::vector<Head>& CurrentBucket() {
+    return buckets_[current_bucket_ & (buckets_.size() - 1)];
+  }
+
+  void PushBackToStream(Stream* stream, PerfEvent&& event);
+  void PopFrontOfStream(Stream* stream);
+  [[nodiscard]] EventChunk* AcquireChunk();
+  void ReleaseChunk(EventChunk* chunk);
+
+  [[nodiscard]] uint32_t AcquireStream(PerfEventOrderedStream ordered_stream);
+  void ReleaseStream(uint32_t stream_index);
+  void InsertHead(const Head& head);
+  // Floats down the head at the front of the current bucket to its correct place in the heap. Used
+  // when the timestamp of that head has increased.
+  void MoveDownFrontOfCurrentBucket();
+  // Advances the current bucket until it contains the oldest head.
+  void MoveToOldestHead();
+  void AdvanceCurrentBucket(uint64_t new_current_bucket);
+
+  std::vector<std::unique_ptr<EventChunk>> chunks_;
+  EventChunk* free_chunks_ = nullptr;
+  std::vector<Stream> streams_;
+  std::vector<uint32_t> free_stream_indices_;
+  absl::flat_hash_map<PerfEventOrderedStream, uint32_t> ordered_stream_to_stream_index_;
+
+  uint32_t bucket_width_log2_;
+  std::vector<std::vector<Head>> buckets_;
+  uint64_t current_bucket_ = 0;
+  // The number of heads in buckets_, i.e., excluding the ones in far_future_heads_.
+  size_t heads_in_buckets_count_ = 0;
+  // Heap of the heads that don't fit into buckets_ yet.
+  std::vector<Head> far_future_heads_;
+
+  size_t event_count_ = 0;
+};
+
+}  // namespace orbit_linux_tracing
+
+#endif  // LINUX_TRACING_CALENDAR_PERF_EVENT_QUEUE_H_
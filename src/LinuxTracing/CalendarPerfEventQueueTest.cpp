@@ -0,0 +1,225 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "CalendarPerfEventQueue.h"
+#include "OrbitBase/Logging.h"
+#include "PerfEvent.h"
+#include "PerfEventOrderedStream.h"
+#include "PerfEventQueue.h"
+
+namespace orbit_linux_tracing {
+
+namespace {
+
+constexpr uint64_t kReorderingWindowNs = 333'000'000;
+
+PerfEvent MakeTestEvent(PerfEventOrderedStream ordered_stream, uint64_t timestamp) {
+  return ForkPerfEvent{
+      .timestamp = timestamp,
+      .ordered_stream = ordered_stream,
+  };
+}
+
+// Produces events similarly to how they are read from many perf_event_open ring buffers: the events
+// of each stream are in order and are added in batches, and events not ordered in any stream are
+// added at most half of the reordering window late.
+class TestEventGenerator {
+ public:
+  TestEventGenerator(int stream_count, int not_ordered_event_permille)
+      : stream_count_{stream_count},
+        not_ordered_event_permille_{not_ordered_event_permille},
+        pending_events_(stream_count) {}
+
+  // Appends the events that are added to the queue next to `events`.
+  void GenerateNextEvents(std::vector<PerfEvent>* events) {
+    current_timestamp_ns_ += std::uniform_int_distribution<uint64_t>{0, 2 * kMeanStepNs}(random_);
+    if (std::uniform_int_distribution<int>{0, 999}(random_) < not_ordered_event_permille_) {
+      const uint64_t delay_ns =
+          std::uniform_int_distribution<uint64_t>{0, kReorderingWindowNs / 2}(random_);
+      const uint64_t timestamp_ns =
+          current_timestamp_ns_ - std::min(delay_ns, current_timestamp_ns_);
+      events->push_back(MakeTestEvent(PerfEventOrderedStream::kNone, timestamp_ns));
+      return;
+    }
+
+    const int stream = std::uniform_int_distribution<int>{0, stream_count_ - 1}(random_);
+    std::vector<uint64_t>& pending_timestamps = pending_events_[stream];
+    pending_timestamps.push_back(current_timestamp_ns_);
+    if (pending_timestamps.size() < kBatchSize) return;
+    const PerfEventOrderedStream ordered_stream =
+        stream % 2 == 0 ? PerfEventOrderedStream::ThreadId(stream)
+                        : PerfEventOrderedStream::FileDescriptor(stream);
+    for (uint64_t timestamp : pending_timestamps) {
+      events->push_back(MakeTestEvent(ordered_stream, timestamp));
+    }
+    pending_timestamps.clear();
+  }
+
+  [[nodiscard]] uint64_t GetCurrentTimestampNs() const { return current_timestamp_ns_; }
+
+ private:
+  static constexpr uint64_t kMeanStepNs = 1'000;
+  static constexpr size_t kBatchSize = 8;
+
+  int stream_count_;
+  int not_ordered_event_permille_;
+  std::mt19937 random_{42};
+  uint64_t current_timestamp_ns_ = 1'000'000'000;
+  std::vector<std::vector<uint64_t>> pending_events_;
+};
+
+// Adds `event_count` generated events to `event_queue` and removes the events older than the
+// reordering window like PerfEventProcessor does. Returns the timestamps of the removed events.
+template <typename EventQueue>
+std::vector<uint64_t> PushAndPopGeneratedEvents(EventQueue* event_queue, int stream_count,
+                                                int not_ordered_event_permille,
+                                                size_t event_count) {
+  TestEventGenerator generator{stream_count, not_ordered_event_permille};
+  std::vector<uint64_t> popped_timestamps;
+  std::vector<PerfEvent> events;
+  size_t pushed_event_count = 0;
+  while (pushed_event_count < event_count) {
+    generator.GenerateNextEvents(&events);
+    for (PerfEvent& event : events) {
+      event_queue->PushEvent(std::move(event));
+    }
+    pushed_event_count += events.size();
+    events.clear();
+
+    while (event_queue->HasEvent() &&
+           event_queue->TopEvent().timestamp + kReorderingWindowNs <
+               generator.GetCurrentTimestampNs()) {
+      popped_timestamps.push_back(event_queue->TopEvent().timestamp);
+      event_queue->PopEvent();
+    }
+  }
+  while (event_queue->HasEvent()) {
+    popped_timestamps.push_back(event_queue->TopEvent().timestamp);
+    event_queue->PopEvent();
+  }
+  return popped_timestamps;
+}
+
+}  // namespace
+
+TEST(CalendarPerfEventQueue, OrderedAndNotOrderedEvents) {
+  CalendarPerfEventQueue event_queue{kReorderingWindowNs};
+  EXPECT_FALSE(event_queue.HasEvent());
+
+  event_queue.PushEvent(MakeTestEvent(PerfEventOrderedStream::FileDescriptor(11), 103));
+  event_queue.PushEvent(MakeTestEvent(PerfEventOrderedStream::FileDescriptor(11), 105));
+  event_queue.PushEvent(MakeTestEvent(PerfEventOrderedStream::ThreadId(11), 102));
+  event_queue.PushEvent(MakeTestEvent(PerfEventOrderedStream::kNone, 108));
+  event_queue.PushEvent(MakeTestEvent(PerfEventOrderedStream::FileDescriptor(11), 107));
+  event_queue.PushEvent(MakeTestEvent(PerfEventOrderedStream::ThreadId(11), 106));
+  event_queue.PushEvent(MakeTestEvent(PerfEventOrderedStream::kNone, 101));
+  event_queue.PushEvent(MakeTestEvent(PerfEventOrderedStream::kNone, 104));
+  event_queue.PushEvent(MakeTestEvent(PerfEventOrderedStream::ThreadId(11), 109));
+
+  for (uint64_t expected_timestamp = 101; expected_timestamp <= 109; ++expected_timestamp) {
+    ASSERT_TRUE(event_queue.HasEvent());
+    EXPECT_EQ(event_queue.TopEvent().timestamp, expected_timestamp);
+    event_queue.PopEvent();
+  }
+  EXPECT_FALSE(event_queue.HasEvent());
+  EXPECT_DEATH(event_queue.PopEvent(), "");
+}
+
+TEST(CalendarPerfEventQueue, StreamWithDecreasingTimestamps) {
+  CalendarPerfEventQueue event_queue{kReorderingWindowNs};
+
+  event_queue.PushEvent(MakeTestEvent(PerfEventOrderedStream::ThreadId(11), 101));
+  event_queue.PushEvent(MakeTestEvent(PerfEventOrderedStream::ThreadId(11), 103));
+  EXPECT_DEATH(event_queue.PushEvent(MakeTestEvent(PerfEventOrderedStream::ThreadId(11), 102)),
+               "");
+}
+
+TEST(CalendarPerfEventQueue, NotOrderedEventComesFirstAmongEventsWithTheSameTimestamp) {
+  CalendarPerfEventQueue event_queue{kReorderingWindowNs};
+  constexpr uint64_t kCommonTimestamp = 100;
+
+  event_queue.PushEvent(
+      MakeTestEvent(PerfEventOrderedStream::FileDescriptor(11), kCommonTimestamp));
+  event_queue.PushEvent(MakeTestEvent(PerfEventOrderedStream::kNone, kCommonTimestamp));
+
+  EXPECT_EQ(event_queue.TopEvent().ordered_stream, PerfEventOrderedStream::kNone);
+  event_queue.PopEvent();
+  EXPECT_EQ(event_queue.TopEvent().ordered_stream, PerfEventOrderedStream::FileDescriptor(11));
+  event_queue.PopEvent();
+  EXPECT_FALSE(event_queue.HasEvent());
+}
+
+TEST(CalendarPerfEventQueue, EventsFartherApartThanTheReorderingWindow) {
+  CalendarPerfEventQueue event_queue{kReorderingWindowNs};
+  constexpr uint64_t kFarFuture = 100 * kReorderingWindowNs;
+
+  event_queue.PushEvent(MakeTestEvent(PerfEventOrderedStream::ThreadId(1), kFarFuture + 1));
+  event_queue.PushEvent(MakeTestEvent(PerfEventOrderedStream::ThreadId(2), 2 * kFarFuture));
+  event_queue.PushEvent(MakeTestEvent(PerfEventOrderedStream::ThreadId(3), 1));
+  event_queue.PushEvent(MakeTestEvent(PerfEventOrderedStream::ThreadId(1), 3 * kFarFuture));
+
+  EXPECT_EQ(event_queue.TopEvent().timestamp, 1);
+  event_queue.PopEvent();
+  EXPECT_EQ(event_queue.TopEvent().timestamp, kFarFuture + 1);
+  event_queue.PopEvent();
+  // Older than the current position in the queue.
+  event_queue.PushEvent(MakeTestEvent(PerfEventOrderedStream::kNone, 2));
+  EXPECT_EQ(event_queue.TopEvent().timestamp, 2);
+  event_queue.PopEvent();
+  EXPECT_EQ(event_queue.TopEvent().timestamp, 2 * kFarFuture);
+  event_queue.PopEvent();
+  EXPECT_EQ(event_queue.TopEvent().timestamp, 3 * kFarFuture);
+  event_queue.PopEvent();
+  EXPECT_FALSE(event_queue.HasEvent());
+}
+
+TEST(CalendarPerfEventQueue, ReturnsTheSameEventsInTheSameOrderAsPerfEventQueue) {
+  constexpr int kStreamCount = 1000;
+  constexpr int kNotOrderedEventPermille = 50;
+  constexpr size_t kEventCount = 200'000;
+
+  PerfEventQueue perf_event_queue;
+  std::vector<uint64_t> expected_timestamps = PushAndPopGeneratedEvents(
+      &perf_event_queue, kStreamCount, kNotOrderedEventPermille, kEventCount);
+  CalendarPerfEventQueue calendar_perf_event_queue{kReorderingWindowNs};
+  std::vector<uint64_t> actual_timestamps = PushAndPopGeneratedEvents(
+      &calendar_perf_event_queue, kStreamCount, kNotOrderedEventPermille, kEventCount);
+
+  EXPECT_GE(expected_timestamps.size(), kEventCount);
+  EXPECT_TRUE(std::is_sorted(expected_timestamps.begin(), expected_timestamps.end()));
+  EXPECT_EQ(actual_timestamps, expected_timestamps);
+}
+
+// Throughput of PerfEventQueue and CalendarPerfEventQueue with up to thousands of streams. Disabled
+// by default, as it only logs the results.
+TEST(CalendarPerfEventQueue, DISABLED_BenchmarkAgainstPerfEventQueue) {
+  constexpr size_t kEventCount = 500'000;
+  for (int stream_count : {100, 1'000, 10'000}) {
+    const auto perf_event_queue_start = std::chrono::steady_clock::now();
+    PerfEventQueue perf_event_queue;
+    PushAndPopGeneratedEvents(&perf_event_queue, stream_count, 1, kEventCount);
+    const std::chrono::duration<double> perf_event_queue_duration =
+        std::chrono::steady_clock::now() - perf_event_queue_start;
+
+    const auto calendar_perf_event_queue_start = std::chrono::steady_clock::now();
+    CalendarPerfEventQueue calendar_perf_event_queue{kReorderingWindowNs};
+    PushAndPopGeneratedEvents(&calendar_perf_event_queue, stream_count, 1, kEventCount);
+    const std::chrono::duration<double> calendar_perf_event_queue_duration =
+        std::chrono::steady_clock::now() - calendar_perf_event_queue_start;
+
+    ORBIT_LOG("%d streams: PerfEventQueue %.2f M events/s, CalendarPerfEventQueue %.2f M events/s",
+              stream_count, kEventCount / perf_event_queue_duration.count() / 1e6,
+              kEventCount / calendar_perf_event_queue_duration.count() / 1e6);
+  }
+}
+
+}  // namespace orbit_linux_tracing
@@ -24,8 +24,8 @@
 #include "LeafFunctionCallManager.h"
 #include "LibunwindstackMaps.h"
 #include "LibunwindstackUnwinder.h"
-#include "OrbitBase/MakeUniqueForOverwrite.h"
 #include "PerfEvent.h"
+#include "PerfEventBufferPool.h"
 #include "PerfEventRecords.h"
 
 using ::testing::_;
@@ -63,6 +63,8 @@ class MockLibunwindstackUnwinder : public LibunwindstackUnwinder {
               (override));
   MOCK_METHOD(std::optional<bool>, HasFramePointerSet, (uint64_t, pid_t, unwindstack::Maps*),
               (override));
+  MOCK_METHOD(void, ClearCache, (), (override));
+  MOCK_METHOD(Stats, GetAndResetStats, (), (override));
 };
 
 class LeafFunctionCallManagerTest : public ::testing::Test {
@@ -152,8 +154,8 @@ CallchainSamplePerfEventData BuildFakeCallchainSamplePerfEventData(
   CallchainSamplePerfEventData event_data{
       .pid = 10,
       .tid = 11,
-      .regs = make_unique_for_overwrite<perf_event_sample_regs_user_all>(),
-      .data = make_unique_for_overwrite<char[]>(13)};
+      .regs = MakeUniqueForOverwriteFromPool<perf_event_sample_regs_user_all>(nullptr),
+      .data = MakeUniqueForOverwriteFromPool<char[]>(nullptr, 13)};
   event_data.SetIps(callchain);
   if (callchain.size() > 1) {
     // Set the first non-kernel address as IP.
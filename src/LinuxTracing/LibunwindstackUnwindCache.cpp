@@ -0,0 +1,104 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "LibunwindstackUnwindCache.h"
+
+#include <unwindstack/MachineX86_64.h>
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace orbit_linux_tracing {
+
+size_t LibunwindstackUnwindCache::RecordingMemory::Read(uint64_t addr, void* dst, size_t size) {
+  const size_t read_size = memory_->Read(addr, dst, size);
+  recorded_bytes_ += size;
+  if (recorded_bytes_ <= kMaxRecordedBytes) {
+    memory_reads_.push_back(
+        MemoryRead{addr, size, std::string(static_cast<const char*>(dst), read_size)});
+  }
+  return read_size;
+}
+
+std::optional<std::vector<LibunwindstackUnwindCache::MemoryRead>>
+LibunwindstackUnwindCache::RecordingMemory::ConsumeMemoryReads() {
+  std::vector<MemoryRead> memory_reads = std::move(memory_reads_);
+  memory_reads_.clear();
+  const size_t recorded_bytes = std::exchange(recorded_bytes_, 0);
+  if (recorded_bytes > kMaxRecordedBytes) return std::nullopt;
+  return memory_reads;
+}
+
+LibunwindstackUnwindCache::Key LibunwindstackUnwindCache::ComputeKey(
+    pid_t pid, unwindstack::RegsX86_64 regs, bool offline_memory_only, size_t max_frames) {
+  return Key{
+      .pid = pid,
+      .pc = regs.pc(),
+      .sp = regs.sp(),
+      .callee_saved_registers = {regs[unwindstack::X86_64_REG_RBX],
+                                 regs[unwindstack::X86_64_REG_RBP],
+                                 regs[unwindstack::X86_64_REG_R12],
+                                 regs[unwindstack::X86_64_REG_R13],
+                                 regs[unwindstack::X86_64_REG_R14],
+                                 regs[unwindstack::X86_64_REG_R15]},
+      .offline_memory_only = offline_memory_only,
+      .max_frames = max_frames,
+  };
+}
+
+static bool MemoryMatchesReads(unwindstack::Memory* memory,
+                               const std::vector<LibunwindstackUnwindCache::MemoryRead>& reads) {
+  std::string buffer;
+  for (const LibunwindstackUnwindCache::MemoryRead& read : reads) {
+    buffer.resize(read.size);
+    const size_t read_size = memory->Read(read.address, buffer.data(), read.size);
+    if (std::string_view{buffer.data(), read_size} != read.data) return false;
+  }
+  return true;
+}
+
+std::shared_ptr<const LibunwindstackUnwindCache::OuterFrames> LibunwindstackUnwindCache::Find(
+    const Key& key, unwindstack::Memory* memory) {
+  std::shared_ptr<const OuterFrames> outer_frames;
+  {
+    absl::MutexLock lock{&mutex_};
+    ++stats_.lookup_count;
+    auto it = key_to_outer_frames_.find(key);
+    if (it == key_to_outer_frames_.end()) {
+      return nullptr;
+    }
+    outer_frames = it->second;
+  }
+  // The memory is compared without holding the lock, as it can involve reading process memory.
+  if (!MemoryMatchesReads(memory, outer_frames->memory_reads)) {
+    return nullptr;
+  }
+  absl::MutexLock lock{&mutex_};
+  ++stats_.hit_count;
+  return outer_frames;
+}
+
+void LibunwindstackUnwindCache::Insert(const Key& key, OuterFrames outer_frames) {
+  auto shared_outer_frames = std::make_shared<const OuterFrames>(std::move(outer_frames));
+  absl::MutexLock lock{&mutex_};
+  if (key_to_outer_frames_.size() >= kMaxEntryCount) {
+    key_to_outer_frames_.clear();
+  }
+  key_to_outer_frames_.insert_or_assign(key, std::move(shared_outer_frames));
+}
+
+void LibunwindstackUnwindCache::Clear() {
+  absl::MutexLock lock{&mutex_};
+  key_to_outer_frames_.clear();
+}
+
+LibunwindstackUnwindCache::Stats LibunwindstackUnwindCache::GetAndResetStats() {
+  absl::MutexLock lock{&mutex_};
+  Stats stats = stats_;
+  stats_ = Stats{};
+  return stats;
+}
+
+}  // namespace orbit_linux_tracing
@@ -0,0 +1,127 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef LINUX_TRACING_LIBUNWINDSTACK_UNWIND_CACHE_H_
+#define LINUX_TRACING_LIBUNWINDSTACK_UNWIND_CACHE_H_
+
+#include <absl/base/thread_annotations.h>
+#include <absl/container/flat_hash_map.h>
+#include <absl/synchronization/mutex.h>
+#include <sys/types.h>
+#include <unwindstack/Error.h>
+#include <unwindstack/Memory.h>
+#include <unwindstack/RegsX86_64.h>
+#include <unwindstack/Unwinder.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace orbit_linux_tracing {
+
+// Memoizes the outer frames of unwound callstacks. Samples taken in a hot loop usually only differ
+// in their innermost frames, so after unwinding those, the unwinding of the remaining frames can
+// often be skipped. The state from which the outer frames are unwound is identified by the
+// registers that unwinding information can refer to (the program counter, the stack pointer, which
+// is the CFA of the previous frame, and the callee-saved registers). As the outer frames also
+// depend on the return addresses and saved registers on the stack, an entry also holds the memory
+// reads performed while unwinding them, and it is only returned if the memory still has the same
+// content at those addresses. The cache needs to be cleared when the memory maps of the process
+// change. All methods are thread-safe.
+class LibunwindstackUnwindCache {
+ public:
+  struct Key {
+    pid_t pid;
+    uint64_t pc;
+    uint64_t sp;
+    std::array<uint64_t, 6> callee_saved_registers;
+    bool offline_memory_only;
+    size_t max_frames;
+
+    friend bool operator==(const Key& lhs, const Key& rhs) {
+      return lhs.pid == rhs.pid && lhs.pc == rhs.pc && lhs.sp == rhs.sp &&
+             lhs.callee_saved_registers == rhs.callee_saved_registers &&
+             lhs.offline_memory_only == rhs.offline_memory_only &&
+             lhs.max_frames == rhs.max_frames;
+    }
+    friend bool operator!=(const Key& lhs, const Key& rhs) { return !(lhs == rhs); }
+
+    template <typename H>
+    friend H AbslHashValue(H h, const Key& key) {
+      return H::combine(std::move(h), key.pid, key.pc, key.sp, key.callee_saved_registers,
+                        key.offline_memory_only, key.max_frames);
+    }
+  };
+
+  // A read of `size` bytes at `address`, of which `data` were returned.
+  struct MemoryRead {
+    uint64_t address;
+    size_t size;
+    std::string data;
+  };
+
+  // The result of unwinding from the state identified by a Key.
+  struct OuterFrames {
+    std::vector<unwindstack::FrameData> frames;
+    unwindstack::RegsX86_64 regs;
+    unwindstack::ErrorCode error_code;
+    std::vector<MemoryRead> memory_reads;
+  };
+
+  // Forwards reads to another unwindstack::Memory and records them, to populate
+  // OuterFrames::memory_reads.
+  class RecordingMemory : public unwindstack::Memory {
+   public:
+    explicit RecordingMemory(std::shared_ptr<unwindstack::Memory> memory)
+        : memory_{std::move(memory)} {}
+
+    size_t Read(uint64_t addr, void* dst, size_t size) override;
+    void Clear() override { memory_->Clear(); }
+
+    // Returns nullopt if more memory was read than can reasonably be stored and verified on every
+    // lookup, e.g., when an object file was read from process memory.
+    [[nodiscard]] std::optional<std::vector<MemoryRead>> ConsumeMemoryReads();
+
+   private:
+    static constexpr size_t kMaxRecordedBytes = 4096;
+
+    std::shared_ptr<unwindstack::Memory> memory_;
+    std::vector<MemoryRead> memory_reads_;
+    size_t recorded_bytes_ = 0;
+  };
+
+  [[nodiscard]] static Key ComputeKey(pid_t pid, unwindstack::RegsX86_64 regs,
+                                      bool offline_memory_only, size_t max_frames);
+
+  // Returns the OuterFrames inserted for `key` only if `memory` matches all their `memory_reads`.
+  [[nodiscard]] std::shared_ptr<const OuterFrames> Find(const Key& key,
+                                                        unwindstack::Memory* memory);
+  void Insert(const Key& key, OuterFrames outer_frames);
+  void Clear();
+
+  struct Stats {
+    uint64_t lookup_count = 0;
+    uint64_t hit_count = 0;
+  };
+  // Returns the statistics accumulated since the last call to this method.
+  [[nodiscard]] Stats GetAndResetStats();
+
+ private:
+  // The cache is simply cleared when it reaches this size.
+  static constexpr size_t kMaxEntryCount = 16 * 1024;
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<Key, std::shared_ptr<const OuterFrames>> key_to_outer_frames_
+      ABSL_GUARDED_BY(mutex_);
+  Stats stats_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace orbit_linux_tracing
+
+#endif  // LINUX_TRACING_LIBUNWINDSTACK_UNWIND_CACHE_H_
@@ -0,0 +1,162 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <gtest/gtest.h>
+#include <unwindstack/MachineX86_64.h>
+#include <unwindstack/RegsX86_64.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "LibunwindstackMultipleOfflineAndProcessMemory.h"
+#include "LibunwindstackUnwindCache.h"
+
+namespace orbit_linux_tracing {
+
+namespace {
+
+constexpr pid_t kPid = 42;
+constexpr uint64_t kPc = 0x1000;
+constexpr uint64_t kStackStartAddress = 0x7000;
+constexpr uint64_t kSpOffset = 4;
+constexpr size_t kMaxFrames = 16;
+
+[[nodiscard]] unwindstack::RegsX86_64 MakeRegs(uint64_t sp) {
+  unwindstack::RegsX86_64 regs;
+  regs.set_pc(kPc);
+  regs.set_sp(sp);
+  regs[unwindstack::X86_64_REG_RBP] = sp + 2;
+  return regs;
+}
+
+[[nodiscard]] LibunwindstackUnwindCache::Key ComputeKey(uint64_t sp) {
+  return LibunwindstackUnwindCache::ComputeKey(kPid, MakeRegs(sp), /*offline_memory_only=*/false,
+                                               kMaxFrames);
+}
+
+// The returned Memory refers to `stack`, which needs to outlive it.
+[[nodiscard]] std::shared_ptr<unwindstack::Memory> CreateStackMemory(const std::string& stack) {
+  return LibunwindstackMultipleOfflineAndProcessMemory::CreateWithoutProcessMemory(
+      {StackSliceView{kStackStartAddress, stack.size(), stack.data()}});
+}
+
+}  // namespace
+
+TEST(LibunwindstackUnwindCache, ComputeKeyDependsOnRegisters) {
+  constexpr uint64_t kSp = kStackStartAddress + kSpOffset;
+  unwindstack::RegsX86_64 regs = MakeRegs(kSp);
+  const LibunwindstackUnwindCache::Key key = LibunwindstackUnwindCache::ComputeKey(
+      kPid, regs, /*offline_memory_only=*/false, kMaxFrames);
+  EXPECT_EQ(key, ComputeKey(kSp));
+  EXPECT_NE(key, ComputeKey(kSp + 8));
+
+  regs[unwindstack::X86_64_REG_RBX] = 1;
+  EXPECT_NE(key, LibunwindstackUnwindCache::ComputeKey(kPid, regs, /*offline_memory_only=*/false,
+                                                       kMaxFrames));
+}
+
+TEST(LibunwindstackUnwindCache, RecordingMemoryRecordsReads) {
+  const std::string stack = "01234567";
+  LibunwindstackUnwindCache::RecordingMemory recording_memory{CreateStackMemory(stack)};
+
+  std::string buffer(4, '\0');
+  EXPECT_EQ(recording_memory.Read(kStackStartAddress + kSpOffset, buffer.data(), 4), 4);
+  EXPECT_EQ(buffer, "4567");
+  EXPECT_EQ(recording_memory.Read(kStackStartAddress + stack.size(), buffer.data(), 4), 0);
+
+  std::optional<std::vector<LibunwindstackUnwindCache::MemoryRead>> memory_reads =
+      recording_memory.ConsumeMemoryReads();
+  ASSERT_TRUE(memory_reads.has_value());
+  ASSERT_EQ(memory_reads->size(), 2);
+  EXPECT_EQ((*memory_reads)[0].address, kStackStartAddress + kSpOffset);
+  EXPECT_EQ((*memory_reads)[0].size, 4);
+  EXPECT_EQ((*memory_reads)[0].data, "4567");
+  EXPECT_EQ((*memory_reads)[1].address, kStackStartAddress + stack.size());
+  EXPECT_EQ((*memory_reads)[1].size, 4);
+  EXPECT_EQ((*memory_reads)[1].data, "");
+
+  memory_reads = recording_memory.ConsumeMemoryReads();
+  ASSERT_TRUE(memory_reads.has_value());
+  EXPECT_TRUE(memory_reads->empty());
+}
+
+TEST(LibunwindstackUnwindCache, RecordingMemoryGivesUpOnLargeReads) {
+  const std::string stack(64 * 1024, 'a');
+  LibunwindstackUnwindCache::RecordingMemory recording_memory{CreateStackMemory(stack)};
+
+  std::string buffer(stack.size(), '\0');
+  EXPECT_EQ(recording_memory.Read(kStackStartAddress, buffer.data(), buffer.size()),
+            buffer.size());
+  EXPECT_EQ(buffer, stack);
+  EXPECT_FALSE(recording_memory.ConsumeMemoryReads().has_value());
+}
+
+TEST(LibunwindstackUnwindCache, FindOnlyReturnsOuterFramesWhoseMemoryReadsMatch) {
+  const LibunwindstackUnwindCache::Key key = ComputeKey(kStackStartAddress + kSpOffset);
+
+  const std::string stack = "01234567";
+  const std::string stack_differing_elsewhere = "ABCD45EF";
+  const std::string stack_with_other_content = "01234A67";
+  const std::string larger_stack = "0123456789ABCDEFGHIJKLMN";
+
+  LibunwindstackUnwindCache cache;
+  std::shared_ptr<unwindstack::Memory> memory = CreateStackMemory(stack);
+  EXPECT_EQ(cache.Find(key, memory.get()), nullptr);
+
+  unwindstack::FrameData frame{};
+  frame.pc = kPc;
+  cache.Insert(key, LibunwindstackUnwindCache::OuterFrames{
+                        .frames = {frame},
+                        .regs = MakeRegs(kStackStartAddress),
+                        .error_code = unwindstack::ERROR_NONE,
+                        .memory_reads = {{kStackStartAddress + kSpOffset, 2, "45"},
+                                         {kStackStartAddress + 16, 8, ""}},
+                    });
+  std::shared_ptr<const LibunwindstackUnwindCache::OuterFrames> outer_frames =
+      cache.Find(key, memory.get());
+  ASSERT_NE(outer_frames, nullptr);
+  ASSERT_EQ(outer_frames->frames.size(), 1);
+  EXPECT_EQ(outer_frames->frames[0].pc, kPc);
+  EXPECT_EQ(outer_frames->error_code, unwindstack::ERROR_NONE);
+
+  // Memory that was not read while unwinding the outer frames doesn't matter.
+  std::shared_ptr<unwindstack::Memory> memory_differing_elsewhere =
+      CreateStackMemory(stack_differing_elsewhere);
+  EXPECT_NE(cache.Find(key, memory_differing_elsewhere.get()), nullptr);
+  std::shared_ptr<unwindstack::Memory> memory_with_other_content =
+      CreateStackMemory(stack_with_other_content);
+  EXPECT_EQ(cache.Find(key, memory_with_other_content.get()), nullptr);
+  // The read that failed now succeeds.
+  std::shared_ptr<unwindstack::Memory> larger_memory = CreateStackMemory(larger_stack);
+  EXPECT_EQ(cache.Find(key, larger_memory.get()), nullptr);
+
+  LibunwindstackUnwindCache::Stats stats = cache.GetAndResetStats();
+  EXPECT_EQ(stats.lookup_count, 5);
+  EXPECT_EQ(stats.hit_count, 2);
+  stats = cache.GetAndResetStats();
+  EXPECT_EQ(stats.lookup_count, 0);
+  EXPECT_EQ(stats.hit_count, 0);
+}
+
+TEST(LibunwindstackUnwindCache, ClearRemovesAllEntries) {
+  const LibunwindstackUnwindCache::Key key = ComputeKey(kStackStartAddress + kSpOffset);
+  const std::string stack = "01234567";
+  std::shared_ptr<unwindstack::Memory> memory = CreateStackMemory(stack);
+
+  LibunwindstackUnwindCache cache;
+  cache.Insert(key, LibunwindstackUnwindCache::OuterFrames{
+                        .frames = {},
+                        .regs = MakeRegs(kStackStartAddress),
+                        .error_code = unwindstack::ERROR_NONE,
+                        .memory_reads = {},
+                    });
+  EXPECT_NE(cache.Find(key, memory.get()), nullptr);
+  cache.Clear();
+  EXPECT_EQ(cache.Find(key, memory.get()), nullptr);
+}
+
+}  // namespace orbit_linux_tracing
@@ -10,9 +10,11 @@
 #include <unwindstack/RegsX86_64.h>
 
 #include <array>
+#include <atomic>
 #include <map>
 
 #include "LibunwindstackMultipleOfflineAndProcessMemory.h"
+#include "LibunwindstackUnwindCache.h"
 #include "OrbitBase/Logging.h"  // IWYU pragma: keep
 
 namespace orbit_linux_tracing {
@@ -34,9 +36,22 @@ class LibunwindstackUnwinderImpl : public LibunwindstackUnwinder {
   std::optional<bool> HasFramePointerSet(uint64_t instruction_pointer, pid_t pid,
                                          unwindstack::Maps* maps) override;
 
+  void ClearCache() override { unwind_cache_.Clear(); }
+
+  Stats GetAndResetStats() override;
+
  private:
   static const std::array<size_t, unwindstack::X86_64_REG_LAST> kUnwindstackRegsToPerfRegs;
 
+  // The number of innermost frames that are always unwound. The state reached after unwinding them
+  // is used to look up the remaining frames in unwind_cache_. These frames are the ones that differ
+  // the most between samples, but the more there are, the more work is needed even on a hit.
+  static constexpr size_t kInnermostFrameCount = 4;
+
+  LibunwindstackUnwindCache unwind_cache_;
+  std::atomic<uint64_t> frame_count_ = 0;
+  std::atomic<uint64_t> unwound_frame_count_ = 0;
+
   std::map<uint64_t, unwindstack::DwarfLocations>
       debug_frame_loc_regs_cache_;  // Single row indexed by pc_end.
   std::map<uint64_t, unwindstack::DwarfLocations>
@@ -45,6 +60,16 @@ class LibunwindstackUnwinderImpl : public LibunwindstackUnwinder {
   const std::map<uint64_t, uint64_t>* absolute_address_to_size_of_functions_to_stop_at_;
 };
 
+// Appends the frames unwound from the state reached after `frames`, fixing their numbering.
+static void AppendOuterFrames(std::vector<unwindstack::FrameData>* frames,
+                              const std::vector<unwindstack::FrameData>& outer_frames) {
+  const size_t first_outer_frame_index = frames->size();
+  frames->insert(frames->end(), outer_frames.begin(), outer_frames.end());
+  for (size_t i = first_outer_frame_index; i < frames->size(); ++i) {
+    (*frames)[i].num = i;
+  }
+}
+
 const std::array<size_t, unwindstack::X86_64_REG_LAST>
     LibunwindstackUnwinderImpl::kUnwindstackRegsToPerfRegs{
         PERF_REG_X86_AX,  PERF_REG_X86_DX,  PERF_REG_X86_CX,  PERF_REG_X86_BX,  PERF_REG_X86_SI,
@@ -70,6 +95,67 @@ LibunwindstackResult LibunwindstackUnwinderImpl::Unwind(
         LibunwindstackMultipleOfflineAndProcessMemory::CreateWithProcessMemory(pid, stack_slices);
   }
 
+  if (max_frames > kInnermostFrameCount) {
+    unwindstack::RegsX86_64 innermost_regs = regs;
+    unwindstack::Unwinder innermost_unwinder{kInnermostFrameCount, maps, &innermost_regs, memory};
+    innermost_unwinder.Unwind(/*initial_map_names_to_skip=*/nullptr,
+                              /*map_suffixes_to_ignore=*/nullptr,
+                              absolute_address_to_size_of_functions_to_stop_at_);
+    std::vector<unwindstack::FrameData> frames = innermost_unwinder.ConsumeFrames();
+    unwound_frame_count_ += frames.size();
+
+    if (frames.size() < kInnermostFrameCount) {
+      // The whole callstack has already been unwound.
+      frame_count_ += frames.size();
+      return LibunwindstackResult{std::move(frames), std::move(innermost_regs),
+                                  innermost_unwinder.LastErrorCode()};
+    }
+
+    // Only in this case the unwinding stopped after successfully stepping out of the last frame,
+    // and innermost_regs contain the state from which the remaining frames are unwound. Otherwise,
+    // fall back to unwinding the whole callstack below, as it might recover from the error.
+    if (innermost_unwinder.LastErrorCode() == unwindstack::ERROR_MAX_FRAMES_EXCEEDED) {
+      const LibunwindstackUnwindCache::Key cache_key = LibunwindstackUnwindCache::ComputeKey(
+          pid, innermost_regs, offline_memory_only, max_frames);
+      std::shared_ptr<const LibunwindstackUnwindCache::OuterFrames> cached_outer_frames =
+          unwind_cache_.Find(cache_key, memory.get());
+      if (cached_outer_frames != nullptr) {
+        AppendOuterFrames(&frames, cached_outer_frames->frames);
+        frame_count_ += frames.size();
+        // Note that the registers that were not restored are the ones of the unwinding that
+        // populated the cache.
+        return LibunwindstackResult{std::move(frames), cached_outer_frames->regs,
+                                    cached_outer_frames->error_code};
+      }
+
+      // On a miss, continue from innermost_regs, recording the memory that the outer frames read.
+      auto recording_memory = std::make_shared<LibunwindstackUnwindCache::RecordingMemory>(memory);
+      unwindstack::Unwinder outer_unwinder{max_frames - kInnermostFrameCount, maps,
+                                           &innermost_regs, recording_memory};
+      outer_unwinder.SetInitialPcIsReturnAddress(true);
+      outer_unwinder.Unwind(/*initial_map_names_to_skip=*/nullptr,
+                            /*map_suffixes_to_ignore=*/nullptr,
+                            absolute_address_to_size_of_functions_to_stop_at_);
+      std::vector<unwindstack::FrameData> outer_frames = outer_unwinder.ConsumeFrames();
+      unwound_frame_count_ += outer_frames.size();
+      AppendOuterFrames(&frames, outer_frames);
+      frame_count_ += frames.size();
+
+      std::optional<std::vector<LibunwindstackUnwindCache::MemoryRead>> memory_reads =
+          recording_memory->ConsumeMemoryReads();
+      if (memory_reads.has_value()) {
+        unwind_cache_.Insert(cache_key, LibunwindstackUnwindCache::OuterFrames{
+                                            .frames = std::move(outer_frames),
+                                            .regs = innermost_regs,
+                                            .error_code = outer_unwinder.LastErrorCode(),
+                                            .memory_reads = std::move(memory_reads.value()),
+                                        });
+      }
+      return LibunwindstackResult{std::move(frames), std::move(innermost_regs),
+                                  outer_unwinder.LastErrorCode()};
+    }
+  }
+
   unwindstack::Unwinder unwinder{max_frames, maps, &regs, memory};
   // Careful: regs are modified. Use regs.Clone() if you need to reuse regs later.
   unwinder.Unwind(/*initial_map_names_to_skip=*/nullptr, /*map_suffixes_to_ignore=*/nullptr,
@@ -81,7 +167,20 @@ LibunwindstackResult LibunwindstackUnwinderImpl::Unwind(
                 unwinder.LastErrorAddress());
   }
 #endif
-  return LibunwindstackResult{unwinder.ConsumeFrames(), std::move(regs), unwinder.LastErrorCode()};
+  std::vector<unwindstack::FrameData> frames = unwinder.ConsumeFrames();
+  unwound_frame_count_ += frames.size();
+  frame_count_ += frames.size();
+  return LibunwindstackResult{std::move(frames), std::move(regs), unwinder.LastErrorCode()};
+}
+
+LibunwindstackUnwinder::Stats LibunwindstackUnwinderImpl::GetAndResetStats() {
+  LibunwindstackUnwindCache::Stats cache_stats = unwind_cache_.GetAndResetStats();
+  return Stats{
+      .cache_lookup_count = cache_stats.lookup_count,
+      .cache_hit_count = cache_stats.hit_count,
+      .frame_count = frame_count_.exchange(0),
+      .unwound_frame_count = unwound_frame_count_.exchange(0),
+  };
 }
 
 // This functions detects if a frame pointer register was set in the given program counter using
@@ -62,6 +62,24 @@ class LibunwindstackUnwinder {
   virtual std::optional<bool> HasFramePointerSet(uint64_t instruction_pointer, pid_t pid,
                                                  unwindstack::Maps* maps) = 0;
 
+  // Unwind memoizes the outer frames of the callstacks it unwinds, together with the stack memory
+  // that unwinding them read, which is compared on reuse. The results are only valid as long as
+  // the maps don't change, so this needs to be called whenever they do.
+  // Note that when the outer frames are taken from the cache, the registers in the result that
+  // were not restored during unwinding are the ones of the unwinding that populated the cache.
+  virtual void ClearCache() = 0;
+
+  struct Stats {
+    uint64_t cache_lookup_count = 0;
+    uint64_t cache_hit_count = 0;
+    // Frames returned by Unwind, including the ones taken from the cache.
+    uint64_t frame_count = 0;
+    // Frames actually unwound by libunwindstack.
+    uint64_t unwound_frame_count = 0;
+  };
+  // Returns the statistics accumulated since the last call to this method.
+  [[nodiscard]] virtual Stats GetAndResetStats() = 0;
+
   static std::unique_ptr<LibunwindstackUnwinder> Create(
       const std::map<uint64_t, uint64_t>* absolute_address_to_size_of_functions_to_stop_at =
           nullptr);
@@ -2,12 +2,38 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <absl/base/casts.h>
 #include <absl/strings/str_format.h>
+#include <asm/perf_regs.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <sys/ucontext.h>
+#include <unistd.h>
+#include <unwindstack/MachineX86_64.h>
+#include <unwindstack/Regs.h>
+#include <unwindstack/RegsGetLocal.h>
+#include <unwindstack/RegsX86_64.h>
+#include <unwindstack/Unwinder.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "LibunwindstackMaps.h"
+#include "LibunwindstackMultipleOfflineAndProcessMemory.h"
 #include "LibunwindstackUnwinder.h"
+#include "OrbitBase/Logging.h"
+#include "OrbitBase/ReadFileToString.h"
+#include "OrbitBase/ThreadUtils.h"
 #include "Test/Path.h"
 
 namespace orbit_linux_tracing {
@@ -206,4 +232,335 @@ TEST(LibunwindstackUnwinder, FramePointerDetectionWorksWithCaching) {
   }
 }
 
-}  // namespace orbit_linux_tracing
\ No newline at end of file
+namespace {
+
+constexpr size_t kMaxFrames = 1024;
+
+// The registers and the stack of a thread of this process, like a stack sample from
+// perf_event_open.
+struct LocalStackSample {
+  std::array<uint64_t, PERF_REG_X86_64_MAX> perf_regs{};
+  uint64_t stack_start_address = 0;
+  std::string stack;
+
+  [[nodiscard]] std::vector<StackSliceView> GetStackSlices() const {
+    return {StackSliceView{stack_start_address, stack.size(), stack.data()}};
+  }
+};
+
+[[nodiscard]] uint64_t GetStackEndAddressOfCurrentThread() {
+  pthread_attr_t attributes;
+  ORBIT_CHECK(pthread_getattr_np(pthread_self(), &attributes) == 0);
+  void* stack_address = nullptr;
+  size_t stack_size = 0;
+  ORBIT_CHECK(pthread_attr_getstack(&attributes, &stack_address, &stack_size) == 0);
+  pthread_attr_destroy(&attributes);
+  return absl::bit_cast<uint64_t>(stack_address) + stack_size;
+}
+
+constexpr std::array<std::pair<size_t, size_t>, unwindstack::X86_64_REG_LAST>
+    kPerfRegsAndUnwindstackRegs{{
+        {PERF_REG_X86_AX, unwindstack::X86_64_REG_RAX},
+        {PERF_REG_X86_BX, unwindstack::X86_64_REG_RBX},
+        {PERF_REG_X86_CX, unwindstack::X86_64_REG_RCX},
+        {PERF_REG_X86_DX, unwindstack::X86_64_REG_RDX},
+        {PERF_REG_X86_SI, unwindstack::X86_64_REG_RSI},
+        {PERF_REG_X86_DI, unwindstack::X86_64_REG_RDI},
+        {PERF_REG_X86_BP, unwindstack::X86_64_REG_RBP},
+        {PERF_REG_X86_SP, unwindstack::X86_64_REG_RSP},
+        {PERF_REG_X86_IP, unwindstack::X86_64_REG_RIP},
+        {PERF_REG_X86_R8, unwindstack::X86_64_REG_R8},
+        {PERF_REG_X86_R9, unwindstack::X86_64_REG_R9},
+        {PERF_REG_X86_R10, unwindstack::X86_64_REG_R10},
+        {PERF_REG_X86_R11, unwindstack::X86_64_REG_R11},
+        {PERF_REG_X86_R12, unwindstack::X86_64_REG_R12},
+        {PERF_REG_X86_R13, unwindstack::X86_64_REG_R13},
+        {PERF_REG_X86_R14, unwindstack::X86_64_REG_R14},
+        {PERF_REG_X86_R15, unwindstack::X86_64_REG_R15},
+    }};
+
+[[gnu::noinline]] LocalStackSample TakeLocalStackSample() {
+  unwindstack::RegsX86_64 regs;
+  unwindstack::RegsGetLocal(&regs);
+  LocalStackSample sample;
+  for (const auto& [perf_reg, unwindstack_reg] : kPerfRegsAndUnwindstackRegs) {
+    sample.perf_regs[perf_reg] = regs[unwindstack_reg];
+  }
+  sample.stack_start_address = regs.sp();
+  // The frames of the callers, above the stack pointer, don't change until this function returns.
+  sample.stack.assign(absl::bit_cast<const char*>(regs.sp()),
+                      GetStackEndAddressOfCurrentThread() - regs.sp());
+  return sample;
+}
+
+// The empty asm statements prevent tail calls, so that each of these functions has a frame.
+[[gnu::noinline]] LocalStackSample TakeLocalStackSampleInSecondFrame() {
+  LocalStackSample sample = TakeLocalStackSample();
+  asm volatile("" ::: "memory");
+  return sample;
+}
+
+[[gnu::noinline]] LocalStackSample TakeLocalStackSampleInThirdFrame() {
+  LocalStackSample sample = TakeLocalStackSampleInSecondFrame();
+  asm volatile("" ::: "memory");
+  return sample;
+}
+
+// Takes samples that only differ in the four innermost frames, which includes this one.
+[[gnu::noinline]] void TakeLocalStackSamplesInFourthFrame(size_t count,
+                                                          std::vector<LocalStackSample>* samples) {
+  for (size_t i = 0; i < count; ++i) {
+    samples->push_back(TakeLocalStackSampleInThirdFrame());
+  }
+  asm volatile("" ::: "memory");
+}
+
+[[gnu::noinline]] void TakeLocalStackSamplesAtDepth(int depth, size_t count,
+                                                    std::vector<LocalStackSample>* samples) {
+  if (depth == 0) {
+    TakeLocalStackSamplesInFourthFrame(count, samples);
+  } else {
+    TakeLocalStackSamplesAtDepth(depth - 1, count, samples);
+  }
+  asm volatile("" ::: "memory");
+}
+
+[[nodiscard]] std::unique_ptr<LibunwindstackMaps> ParseMapsOfThisProcess() {
+  ErrorMessageOr<std::string> maps_buffer = orbit_base::ReadFileToString("/proc/self/maps");
+  ORBIT_CHECK(maps_buffer.has_value());
+  return LibunwindstackMaps::ParseMaps(maps_buffer.value());
+}
+
+[[nodiscard]] std::pair<std::vector<unwindstack::FrameData>, unwindstack::ErrorCode>
+UnwindWithLibunwindstack(unwindstack::Maps* maps, const LocalStackSample& sample) {
+  unwindstack::RegsX86_64 regs;
+  for (const auto& [perf_reg, unwindstack_reg] : kPerfRegsAndUnwindstackRegs) {
+    regs[unwindstack_reg] = sample.perf_regs[perf_reg];
+  }
+  unwindstack::Unwinder unwinder{
+      kMaxFrames, maps, &regs,
+      LibunwindstackMultipleOfflineAndProcessMemory::CreateWithoutProcessMemory(
+          sample.GetStackSlices())};
+  unwinder.Unwind();
+  return {unwinder.ConsumeFrames(), unwinder.LastErrorCode()};
+}
+
+void ExpectSameFrames(const std::vector<unwindstack::FrameData>& actual,
+                      const std::vector<unwindstack::FrameData>& expected) {
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t i = 0; i < actual.size(); ++i) {
+    EXPECT_EQ(actual[i].num, expected[i].num);
+    EXPECT_EQ(actual[i].pc, expected[i].pc);
+    EXPECT_EQ(actual[i].rel_pc, expected[i].rel_pc);
+    EXPECT_EQ(actual[i].sp, expected[i].sp);
+  }
+}
+
+
+// Collects samples of a thread of this process from a SIGPROF handler, so that samples are taken at
+// arbitrary instructions like with perf_event_open. All buffers are allocated upfront, as the
+// signal handler must not allocate.
+class SigprofSampler {
+ public:
+  static constexpr size_t kMaxStackSize = 64 * 1024;
+
+  explicit SigprofSampler(size_t max_sample_count)
+      : samples_(max_sample_count), stack_sizes_(max_sample_count) {
+    for (LocalStackSample& sample : samples_) sample.stack.resize(kMaxStackSize);
+  }
+
+  // Only samples the calling thread.
+  void Start() {
+    ORBIT_CHECK(instance_ == nullptr);
+    sampled_tid_ = orbit_base::GetCurrentThreadId();
+    stack_end_address_ = GetStackEndAddressOfCurrentThread();
+    instance_ = this;
+    struct sigaction action {};
+    action.sa_sigaction = &SigprofSampler::HandleSigprof;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    ORBIT_CHECK(sigaction(SIGPROF, &action, &previous_action_) == 0);
+    itimerval timer{};
+    timer.it_interval.tv_usec = 100;
+    timer.it_value.tv_usec = 100;
+    ORBIT_CHECK(setitimer(ITIMER_PROF, &timer, nullptr) == 0);
+  }
+
+  [[nodiscard]] bool IsFull() const { return sample_count_ >= samples_.size(); }
+
+  std::vector<LocalStackSample> Stop() {
+    itimerval timer{};
+    ORBIT_CHECK(setitimer(ITIMER_PROF, &timer, nullptr) == 0);
+    ORBIT_CHECK(sigaction(SIGPROF, &previous_action_, nullptr) == 0);
+    instance_ = nullptr;
+    samples_.resize(std::min<size_t>(sample_count_, samples_.size()));
+    for (size_t i = 0; i < samples_.size(); ++i) samples_[i].stack.resize(stack_sizes_[i]);
+    return std::move(samples_);
+  }
+
+ private:
+  static void HandleSigprof(int /*signal*/, siginfo_t* /*info*/, void* context) {
+    SigprofSampler* sampler = instance_;
+    if (sampler == nullptr || orbit_base::GetCurrentThreadId() != sampler->sampled_tid_) return;
+    const size_t index = sampler->sample_count_;
+    if (index >= sampler->samples_.size()) return;
+
+    const mcontext_t& mcontext = static_cast<const ucontext_t*>(context)->uc_mcontext;
+    LocalStackSample& sample = sampler->samples_[index];
+    for (const auto& [perf_reg, ucontext_reg] : kPerfRegsAndUcontextRegs) {
+      sample.perf_regs[perf_reg] = mcontext.gregs[ucontext_reg];
+    }
+    const uint64_t sp = sample.perf_regs[PERF_REG_X86_SP];
+    sample.stack_start_address = sp;
+    const size_t stack_size = std::min<size_t>(sampler->stack_end_address_ - sp, kMaxStackSize);
+    std::memcpy(sample.stack.data(), absl::bit_cast<const void*>(sp), stack_size);
+    sampler->stack_sizes_[index] = stack_size;
+    sampler->sample_count_ = index + 1;
+  }
+
+  static constexpr std::array<std::pair<size_t, int>, unwindstack::X86_64_REG_LAST>
+      kPerfRegsAndUcontextRegs{{
+          {PERF_REG_X86_AX, REG_RAX}, {PERF_REG_X86_BX, REG_RBX}, {PERF_REG_X86_CX, REG_RCX},
+          {PERF_REG_X86_DX, REG_RDX}, {PERF_REG_X86_SI, REG_RSI}, {PERF_REG_X86_DI, REG_RDI},
+          {PERF_REG_X86_BP, REG_RBP}, {PERF_REG_X86_SP, REG_RSP}, {PERF_REG_X86_IP, REG_RIP},
+          {PERF_REG_X86_R8, REG_R8},  {PERF_REG_X86_R9, REG_R9},  {PERF_REG_X86_R10, REG_R10},
+          {PERF_REG_X86_R11, REG_R11}, {PERF_REG_X86_R12, REG_R12}, {PERF_REG_X86_R13, REG_R13},
+          {PERF_REG_X86_R14, REG_R14}, {PERF_REG_X86_R15, REG_R15},
+      }};
+
+  static inline SigprofSampler* instance_ = nullptr;
+  std::vector<LocalStackSample> samples_;
+  std::vector<size_t> stack_sizes_;
+  std::atomic<size_t> sample_count_ = 0;
+  pid_t sampled_tid_ = 0;
+  uint64_t stack_end_address_ = 0;
+  struct sigaction previous_action_ {};
+};
+
+// A hot loop a few calls deep, below a fixed chain of outer frames, as typical for a profiled
+// thread.
+[[gnu::noinline]] uint64_t HotLoopLeaf(uint64_t value) {
+  for (int i = 0; i < 64; ++i) value = value * 6364136223846793005ULL + 1442695040888963407ULL;
+  asm volatile("" ::: "memory");
+  return value;
+}
+
+[[gnu::noinline]] uint64_t HotLoopMiddle(uint64_t value) {
+  uint64_t result = HotLoopLeaf(value) ^ HotLoopLeaf(value + 1);
+  asm volatile("" ::: "memory");
+  return result;
+}
+
+[[gnu::noinline]] void RunHotLoopAtDepth(int depth, SigprofSampler* sampler) {
+  if (depth == 0) {
+    uint64_t value = 0;
+    while (!sampler->IsFull()) value = HotLoopMiddle(value);
+    asm volatile("" : : "r"(value) : "memory");
+  } else {
+    RunHotLoopAtDepth(depth - 1, sampler);
+  }
+  asm volatile("" ::: "memory");
+}
+}  // namespace
+
+TEST(LibunwindstackUnwinder, UnwindReusesOuterFramesOnlyIfTheStackTheyReadIsTheSame) {
+  constexpr int kDepth = 8;
+  std::vector<LocalStackSample> samples;
+  TakeLocalStackSamplesAtDepth(kDepth, 2, &samples);
+  ASSERT_EQ(samples.size(), 2);
+
+  std::unique_ptr<LibunwindstackMaps> maps = ParseMapsOfThisProcess();
+  std::unique_ptr<LibunwindstackUnwinder> unwinder = LibunwindstackUnwinder::Create();
+
+  auto [expected_frames, expected_error_code] = UnwindWithLibunwindstack(maps->Get(), samples[0]);
+  // The four innermost frames and at least kDepth + 1 frames of TakeLocalStackSamplesAtDepth.
+  ASSERT_GT(expected_frames.size(), 4 + kDepth);
+  LibunwindstackResult result =
+      unwinder->Unwind(getpid(), maps->Get(), samples[0].perf_regs, samples[0].GetStackSlices(),
+                       /*offline_memory_only=*/true, kMaxFrames);
+  ExpectSameFrames(result.frames(), expected_frames);
+  EXPECT_EQ(result.error_code(), expected_error_code);
+
+  // The second sample was taken in the same outer frames, so these are reused.
+  std::tie(expected_frames, expected_error_code) =
+      UnwindWithLibunwindstack(maps->Get(), samples[1]);
+  result = unwinder->Unwind(getpid(), maps->Get(), samples[1].perf_regs,
+                            samples[1].GetStackSlices(), /*offline_memory_only=*/true, kMaxFrames);
+  ExpectSameFrames(result.frames(), expected_frames);
+  EXPECT_EQ(result.error_code(), expected_error_code);
+
+  LibunwindstackUnwinder::Stats stats = unwinder->GetAndResetStats();
+  EXPECT_EQ(stats.cache_lookup_count, 2);
+  EXPECT_EQ(stats.cache_hit_count, 1);
+  EXPECT_EQ(stats.frame_count, 2 * expected_frames.size());
+  EXPECT_EQ(stats.unwound_frame_count, expected_frames.size() + 4);
+
+  // Change the return address from the seventh to the eighth frame, which is read when unwinding
+  // the outer frames. The sp of a frame is the CFA of the previous one.
+  LocalStackSample& modified_sample = samples[1];
+  const uint64_t return_address_address = expected_frames[7].sp - sizeof(uint64_t);
+  const uint64_t modified_return_address = expected_frames[1].pc;
+  std::memcpy(modified_sample.stack.data() +
+                  (return_address_address - modified_sample.stack_start_address),
+              &modified_return_address, sizeof(modified_return_address));
+  std::tie(expected_frames, expected_error_code) =
+      UnwindWithLibunwindstack(maps->Get(), modified_sample);
+  result = unwinder->Unwind(getpid(), maps->Get(), modified_sample.perf_regs,
+                            modified_sample.GetStackSlices(), /*offline_memory_only=*/true,
+                            kMaxFrames);
+  ExpectSameFrames(result.frames(), expected_frames);
+  EXPECT_EQ(result.error_code(), expected_error_code);
+
+  stats = unwinder->GetAndResetStats();
+  EXPECT_EQ(stats.cache_lookup_count, 1);
+  EXPECT_EQ(stats.cache_hit_count, 0);
+}
+
+
+TEST(LibunwindstackUnwinder, DISABLED_BenchmarkUnwindSamplesOfHotLoop) {
+  constexpr size_t kSampleCount = 1000;
+  constexpr int kDepth = 32;
+  SigprofSampler sampler{kSampleCount};
+  std::vector<LocalStackSample> samples;
+  std::thread sampled_thread{[&sampler, &samples] {
+    sampler.Start();
+    RunHotLoopAtDepth(kDepth, &sampler);
+    samples = sampler.Stop();
+  }};
+  sampled_thread.join();
+  ASSERT_EQ(samples.size(), kSampleCount);
+
+  std::unique_ptr<LibunwindstackMaps> maps = ParseMapsOfThisProcess();
+  std::vector<std::vector<unwindstack::FrameData>> expected_frames;
+  expected_frames.reserve(samples.size());
+  const auto start_without_cache = std::chrono::steady_clock::now();
+  for (const LocalStackSample& sample : samples) {
+    expected_frames.push_back(UnwindWithLibunwindstack(maps->Get(), sample).first);
+  }
+  const auto duration_without_cache = std::chrono::steady_clock::now() - start_without_cache;
+
+  std::unique_ptr<LibunwindstackUnwinder> unwinder = LibunwindstackUnwinder::Create();
+  std::vector<LibunwindstackResult> results;
+  results.reserve(samples.size());
+  const auto start_with_cache = std::chrono::steady_clock::now();
+  for (const LocalStackSample& sample : samples) {
+    results.push_back(unwinder->Unwind(getpid(), maps->Get(), sample.perf_regs,
+                                       sample.GetStackSlices(), /*offline_memory_only=*/true,
+                                       kMaxFrames));
+  }
+  const auto duration_with_cache = std::chrono::steady_clock::now() - start_with_cache;
+
+  for (size_t i = 0; i < samples.size(); ++i) {
+    ExpectSameFrames(results[i].frames(), expected_frames[i]);
+  }
+  const LibunwindstackUnwinder::Stats stats = unwinder->GetAndResetStats();
+  ORBIT_LOG("Unwound %u samples with %u frames on average", samples.size(),
+            stats.frame_count / samples.size());
+  ORBIT_LOG("Cache hits: %u of %u lookups; frames actually unwound: %u of %u",
+            stats.cache_hit_count, stats.cache_lookup_count, stats.unwound_frame_count,
+            stats.frame_count);
+  ORBIT_LOG("Without cache: %.3f ms; with cache: %.3f ms",
+            std::chrono::duration<double, std::milli>(duration_without_cache).count(),
+            std::chrono::duration<double, std::milli>(duration_with_cache).count());
+}
+
+}  // namespace orbit_linux_tracing
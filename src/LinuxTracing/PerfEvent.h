@@ -17,7 +17,7 @@
 #include <vector>
 
 #include "GrpcProtos/Constants.h"
-#include "OrbitBase/MakeUniqueForOverwrite.h"
+#include "PerfEventBufferPool.h"
 #include "PerfEventOrderedStream.h"
 #include "PerfEventRecords.h"
 
@@ -75,9 +75,11 @@ struct StackSamplePerfEventData {
 
   pid_t pid;
   pid_t tid;
-  std::unique_ptr<perf_event_sample_regs_user_all> regs;
+  // The buffers of stack samples and callchain samples are recycled through a PerfEventBufferPool,
+  // to which they are returned when the event is destroyed after having been processed.
+  PooledUniquePtr<perf_event_sample_regs_user_all> regs;
   uint64_t dyn_size;
-  std::unique_ptr<char[]> data;
+  PooledUniquePtr<char[]> data;
 };
 using StackSamplePerfEvent = TypedPerfEvent<StackSamplePerfEventData>;
 
@@ -90,7 +92,7 @@ struct CallchainSamplePerfEventData {
   [[nodiscard]] const char* GetStackData() const { return data.get(); }
   void SetIps(const std::vector<uint64_t>& new_ips) const {
     ips_size = new_ips.size();
-    ips = make_unique_for_overwrite<uint64_t[]>(ips_size);
+    ips = MakeUniqueForOverwriteFromPool<uint64_t[]>(ips.get_deleter().GetPool(), ips_size);
     memcpy(ips.get(), new_ips.data(), ips_size * sizeof(uint64_t));
   }
   [[nodiscard]] std::vector<uint64_t> CopyOfIpsAsVector() const {
@@ -102,9 +104,9 @@ struct CallchainSamplePerfEventData {
   // Mutability is needed in SetIps which in turn is needed by
   // LeafFunctionCallManager::PatchCallerOfLeafFunction.
   mutable uint64_t ips_size;
-  mutable std::unique_ptr<uint64_t[]> ips;
-  std::unique_ptr<perf_event_sample_regs_user_all> regs;
-  std::unique_ptr<char[]> data;
+  mutable PooledUniquePtr<uint64_t[]> ips;
+  PooledUniquePtr<perf_event_sample_regs_user_all> regs;
+  PooledUniquePtr<char[]> data;
 };
 using CallchainSamplePerfEvent = TypedPerfEvent<CallchainSamplePerfEventData>;
 
@@ -0,0 +1,74 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "PerfEventBufferPool.h"
+
+#include "OrbitBase/Profiling.h"
+
+namespace orbit_linux_tracing {
+
+PerfEventBufferPool::~PerfEventBufferPool() {
+  absl::MutexLock lock{&mutex_};
+  for (auto& [unused_size_class, buffers] : released_buffers_by_size_class_) {
+    for (char* buffer : buffers) {
+      delete[] buffer;
+    }
+  }
+}
+
+size_t PerfEventBufferPool::ComputeSizeClass(size_t size) {
+  constexpr size_t kMinSizeClass = 64;
+  size_t size_class = kMinSizeClass;
+  while (size_class < size) {
+    size_class <<= 1;
+  }
+  return size_class;
+}
+
+char* PerfEventBufferPool::Allocate(size_t size) {
+  const size_t size_class = ComputeSizeClass(size);
+  {
+    absl::MutexLock lock{&mutex_};
+    ++stats_.allocation_count;
+    auto it = released_buffers_by_size_class_.find(size_class);
+    if (it != released_buffers_by_size_class_.end() && !it->second.empty()) {
+      char* buffer = it->second.back();
+      it->second.pop_back();
+      retained_bytes_ -= size_class;
+      ++stats_.hit_count;
+      return buffer;
+    }
+  }
+
+  const uint64_t new_begin_ns = orbit_base::CaptureTimestampNs();
+  char* buffer = new char[size_class];
+  const uint64_t new_duration_ns = orbit_base::CaptureTimestampNs() - new_begin_ns;
+
+  absl::MutexLock lock{&mutex_};
+  stats_.miss_duration_ns += new_duration_ns;
+  return buffer;
+}
+
+void PerfEventBufferPool::Release(char* buffer, size_t size) {
+  const size_t size_class = ComputeSizeClass(size);
+  {
+    absl::MutexLock lock{&mutex_};
+    if (retained_bytes_ + size_class <= kMaxRetainedBytes) {
+      released_buffers_by_size_class_[size_class].push_back(buffer);
+      retained_bytes_ += size_class;
+      return;
+    }
+  }
+  delete[] buffer;
+}
+
+PerfEventBufferPool::Stats PerfEventBufferPool::GetAndResetStats() {
+  absl::MutexLock lock{&mutex_};
+  Stats stats = stats_;
+  stats.retained_bytes = retained_bytes_;
+  stats_ = Stats{};
+  return stats;
+}
+
+}  // namespace orbit_linux_tracing
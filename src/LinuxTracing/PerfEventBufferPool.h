@@ -0,0 +1,117 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef LINUX_TRACING_PERF_EVENT_BUFFER_POOL_H_
+#define LINUX_TRACING_PERF_EVENT_BUFFER_POOL_H_
+
+#include <absl/base/thread_annotations.h>
+#include <absl/container/flat_hash_map.h>
+#include <absl/synchronization/mutex.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace orbit_linux_tracing {
+
+// Recycles the heap buffers that hold the variable-size payloads of PerfEvents, i.e., the copies of
+// the registers, of the callchain and of the stack of stack samples and callchain samples. These
+// events are produced at a rate of thousands per second per CPU, and each of them would otherwise
+// require multiple malloc/free pairs. In addition, the buffers are allocated by the threads reading
+// the ring buffers and freed by the thread processing the events, which is a bad case for malloc.
+// Buffers are grouped by size, rounded up to the next power of two. Allocate and Release are
+// thread-safe.
+class PerfEventBufferPool {
+ public:
+  PerfEventBufferPool() = default;
+  ~PerfEventBufferPool();
+
+  PerfEventBufferPool(const PerfEventBufferPool&) = delete;
+  PerfEventBufferPool& operator=(const PerfEventBufferPool&) = delete;
+  PerfEventBufferPool(PerfEventBufferPool&&) = delete;
+  PerfEventBufferPool& operator=(PerfEventBufferPool&&) = delete;
+
+  // Returns an uninitialized buffer of at least `size` bytes. Reuses a released buffer if possible.
+  [[nodiscard]] char* Allocate(size_t size);
+  // `size` needs to be the same that was passed to Allocate.
+  void Release(char* buffer, size_t size);
+
+  struct Stats {
+    uint64_t allocation_count = 0;
+    // Allocations served with a released buffer.
+    uint64_t hit_count = 0;
+    // Time spent in operator new for the allocations that were not served from the pool.
+    uint64_t miss_duration_ns = 0;
+    uint64_t retained_bytes = 0;
+  };
+  // Returns the statistics accumulated since the last call to this method.
+  [[nodiscard]] Stats GetAndResetStats();
+
+ private:
+  [[nodiscard]] static size_t ComputeSizeClass(size_t size);
+
+  // Released buffers are deleted instead of being retained once the pool holds this much memory.
+  static constexpr uint64_t kMaxRetainedBytes = 256 * 1024 * 1024;
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<size_t, std::vector<char*>> released_buffers_by_size_class_
+      ABSL_GUARDED_BY(mutex_);
+  uint64_t retained_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+  Stats stats_ ABSL_GUARDED_BY(mutex_);
+};
+
+// Deleter for the std::unique_ptrs returned by MakeUniqueForOverwriteFromPool. When `pool` is
+// nullptr, the memory was allocated with plain operator new[] and is deleted.
+class PerfEventBufferDeleter {
+ public:
+  PerfEventBufferDeleter() = default;
+  PerfEventBufferDeleter(PerfEventBufferPool* pool, size_t size) : pool_{pool}, size_{size} {}
+
+  template <typename T>
+  void operator()(T* ptr) const {
+    static_assert(std::is_trivially_destructible_v<T>);
+    char* buffer = reinterpret_cast<char*>(ptr);
+    if (pool_ != nullptr) {
+      pool_->Release(buffer, size_);
+    } else {
+      delete[] buffer;
+    }
+  }
+
+  [[nodiscard]] PerfEventBufferPool* GetPool() const { return pool_; }
+
+ private:
+  PerfEventBufferPool* pool_ = nullptr;
+  size_t size_ = 0;
+};
+
+template <typename T>
+using PooledUniquePtr = std::unique_ptr<T, PerfEventBufferDeleter>;
+
+// Like make_unique_for_overwrite, but takes the memory from `pool`, or from operator new[] if
+// `pool` is nullptr. Only supports trivial types, as no constructor or destructor is called.
+template <typename T>
+[[nodiscard]] std::enable_if_t<!std::is_array_v<T>, PooledUniquePtr<T>>
+MakeUniqueForOverwriteFromPool(PerfEventBufferPool* pool) {
+  static_assert(std::is_trivial_v<T>);
+  char* buffer = (pool != nullptr) ? pool->Allocate(sizeof(T)) : new char[sizeof(T)];
+  return PooledUniquePtr<T>{reinterpret_cast<T*>(buffer), PerfEventBufferDeleter{pool, sizeof(T)}};
+}
+
+template <typename T>
+[[nodiscard]] std::enable_if_t<std::is_array_v<T> && std::extent_v<T> == 0, PooledUniquePtr<T>>
+MakeUniqueForOverwriteFromPool(PerfEventBufferPool* pool, size_t count) {
+  using ElementT = std::remove_extent_t<T>;
+  static_assert(std::is_trivial_v<ElementT>);
+  const size_t size = count * sizeof(ElementT);
+  char* buffer = (pool != nullptr) ? pool->Allocate(size) : new char[size];
+  return PooledUniquePtr<T>{reinterpret_cast<ElementT*>(buffer),
+                            PerfEventBufferDeleter{pool, size}};
+}
+
+}  // namespace orbit_linux_tracing
+
+#endif  // LINUX_TRACING_PERF_EVENT_BUFFER_POOL_H_
@@ -0,0 +1,105 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+
+#include <thread>
+#include <vector>
+
+#include "PerfEventBufferPool.h"
+#include "PerfEventRecords.h"
+
+namespace orbit_linux_tracing {
+
+TEST(PerfEventBufferPool, ReleasedBufferIsReused) {
+  PerfEventBufferPool pool;
+  char* buffer = pool.Allocate(1000);
+  pool.Release(buffer, 1000);
+  // Same size class.
+  EXPECT_EQ(pool.Allocate(1010), buffer);
+
+  PerfEventBufferPool::Stats stats = pool.GetAndResetStats();
+  EXPECT_EQ(stats.allocation_count, 2);
+  EXPECT_EQ(stats.hit_count, 1);
+  EXPECT_EQ(stats.retained_bytes, 0);
+  pool.Release(buffer, 1010);
+}
+
+TEST(PerfEventBufferPool, BuffersOfDifferentSizeClassesAreNotMixed) {
+  PerfEventBufferPool pool;
+  char* small_buffer = pool.Allocate(100);
+  pool.Release(small_buffer, 100);
+  char* large_buffer = pool.Allocate(10000);
+  EXPECT_NE(large_buffer, small_buffer);
+
+  PerfEventBufferPool::Stats stats = pool.GetAndResetStats();
+  EXPECT_EQ(stats.allocation_count, 2);
+  EXPECT_EQ(stats.hit_count, 0);
+  EXPECT_EQ(stats.retained_bytes, 128);
+  pool.Release(large_buffer, 10000);
+}
+
+TEST(PerfEventBufferPool, GetAndResetStatsResetsStats) {
+  PerfEventBufferPool pool;
+  pool.Release(pool.Allocate(64), 64);
+  EXPECT_EQ(pool.GetAndResetStats().allocation_count, 1);
+
+  PerfEventBufferPool::Stats stats = pool.GetAndResetStats();
+  EXPECT_EQ(stats.allocation_count, 0);
+  EXPECT_EQ(stats.hit_count, 0);
+  EXPECT_EQ(stats.miss_duration_ns, 0);
+  EXPECT_EQ(stats.retained_bytes, 64);
+}
+
+TEST(PerfEventBufferPool, PooledUniquePtrReturnsBufferToPool) {
+  PerfEventBufferPool pool;
+  char* data_ptr = nullptr;
+  {
+    PooledUniquePtr<char[]> data = MakeUniqueForOverwriteFromPool<char[]>(&pool, 512);
+    data_ptr = data.get();
+    PooledUniquePtr<perf_event_sample_regs_user_all> regs =
+        MakeUniqueForOverwriteFromPool<perf_event_sample_regs_user_all>(&pool);
+    regs->sp = 42;
+  }
+
+  PooledUniquePtr<char[]> data = MakeUniqueForOverwriteFromPool<char[]>(&pool, 512);
+  EXPECT_EQ(data.get(), data_ptr);
+  EXPECT_EQ(data.get_deleter().GetPool(), &pool);
+  EXPECT_EQ(pool.GetAndResetStats().hit_count, 1);
+}
+
+TEST(PerfEventBufferPool, PooledUniquePtrWithoutPool) {
+  PooledUniquePtr<uint64_t[]> ips = MakeUniqueForOverwriteFromPool<uint64_t[]>(nullptr, 3);
+  ips[2] = 42;
+  EXPECT_EQ(ips[2], 42);
+  EXPECT_EQ(ips.get_deleter().GetPool(), nullptr);
+}
+
+TEST(PerfEventBufferPool, AllocateAndReleaseFromDifferentThreads) {
+  PerfEventBufferPool pool;
+  constexpr size_t kBufferCount = 1000;
+  constexpr size_t kBufferSize = 4096;
+
+  std::vector<char*> buffers;
+  std::thread allocating_thread{[&pool, &buffers] {
+    for (size_t i = 0; i < kBufferCount; ++i) {
+      buffers.push_back(pool.Allocate(kBufferSize));
+    }
+  }};
+  allocating_thread.join();
+
+  std::thread releasing_thread{[&pool, &buffers] {
+    for (char* buffer : buffers) {
+      pool.Release(buffer, kBufferSize);
+    }
+  }};
+  releasing_thread.join();
+
+  PerfEventBufferPool::Stats stats = pool.GetAndResetStats();
+  EXPECT_EQ(stats.allocation_count, kBufferCount);
+  EXPECT_EQ(stats.retained_bytes, kBufferCount * kBufferSize);
+}
+
+}  // namespace orbit_linux_tracing
@@ -31,7 +31,12 @@ perf_event_attr generic_event_attr() {
   return pe;
 }
 
-int generic_event_open(perf_event_attr* attr, pid_t pid, int32_t cpu) {
+int generic_event_open(perf_event_attr* attr, pid_t pid, int32_t cpu,
+                       uint32_t wakeup_watermark) {
+  if (wakeup_watermark > 0) {
+    attr->watermark = 1;
+    attr->wakeup_watermark = wakeup_watermark;
+  }
   int fd = perf_event_open(attr, pid, cpu, -1, PERF_FLAG_FD_CLOEXEC);
   if (fd == -1) {
     ORBIT_ERROR("perf_event_open: %s", SafeStrerror(errno));
@@ -51,16 +56,16 @@ perf_event_attr uprobe_event_attr(const char* module, uint64_t function_offset)
 }
 }  // namespace
 
-int context_switch_event_open(pid_t pid, int32_t cpu) {
+int context_switch_event_open(pid_t pid, int32_t cpu, uint32_t wakeup_watermark) {
   perf_event_attr pe = generic_event_attr();
   pe.type = PERF_TYPE_SOFTWARE;
   pe.config = PERF_COUNT_SW_DUMMY;
   pe.context_switch = 1;
 
-  return generic_event_open(&pe, pid, cpu);
+  return generic_event_open(&pe, pid, cpu, wakeup_watermark);
 }
 
-int mmap_task_event_open(pid_t pid, int32_t cpu) {
+int mmap_task_event_open(pid_t pid, int32_t cpu, uint32_t wakeup_watermark) {
   perf_event_attr pe = generic_event_attr();
   pe.type = PERF_TYPE_SOFTWARE;
   pe.config = PERF_COUNT_SW_DUMMY;
@@ -70,10 +75,11 @@ int mmap_task_event_open(pid_t pid, int32_t cpu) {
   pe.mmap_data = 1;
   pe.task = 1;
 
-  return generic_event_open(&pe, pid, cpu);
+  return generic_event_open(&pe, pid, cpu, wakeup_watermark);
 }
 
-int stack_sample_event_open(uint64_t period_ns, pid_t pid, int32_t cpu, uint16_t stack_dump_size) {
+int stack_sample_event_open(uint64_t period_ns, pid_t pid, int32_t cpu, uint16_t stack_dump_size,
+                            uint32_t wakeup_watermark) {
   perf_event_attr pe = generic_event_attr();
   pe.type = PERF_TYPE_SOFTWARE;
   pe.config = PERF_COUNT_SW_CPU_CLOCK;
@@ -83,11 +89,11 @@ int stack_sample_event_open(uint64_t period_ns, pid_t pid, int32_t cpu, uint16_t
 
   pe.sample_stack_user = stack_dump_size;
 
-  return generic_event_open(&pe, pid, cpu);
+  return generic_event_open(&pe, pid, cpu, wakeup_watermark);
 }
 
 int callchain_sample_event_open(uint64_t period_ns, pid_t pid, int32_t cpu,
-                                uint16_t stack_dump_size) {
+                                uint16_t stack_dump_size, uint32_t wakeup_watermark) {
   perf_event_attr pe = generic_event_attr();
   pe.type = PERF_TYPE_SOFTWARE;
   pe.config = PERF_COUNT_SW_CPU_CLOCK;
@@ -103,11 +109,11 @@ int callchain_sample_event_open(uint64_t period_ns, pid_t pid, int32_t cpu,
   pe.sample_regs_user = SAMPLE_REGS_USER_ALL;
   pe.sample_stack_user = stack_dump_size;
 
-  return generic_event_open(&pe, pid, cpu);
+  return generic_event_open(&pe, pid, cpu, wakeup_watermark);
 }
 
 int uprobes_retaddr_event_open(const char* module, uint64_t function_offset, pid_t pid,
-                               int32_t cpu) {
+                               int32_t cpu, uint32_t wakeup_watermark) {
   perf_event_attr pe = uprobe_event_attr(module, function_offset);
   pe.config &= ~1ULL;
   pe.sample_type |= PERF_SAMPLE_REGS_USER | PERF_SAMPLE_STACK_USER;
@@ -117,11 +123,12 @@ int uprobes_retaddr_event_open(const char* module, uint64_t function_offset, pid
   // We record it as it is about to be hijacked by the installation of the uretprobe.
   pe.sample_stack_user = SAMPLE_STACK_USER_SIZE_8BYTES;
 
-  return generic_event_open(&pe, pid, cpu);
+  return generic_event_open(&pe, pid, cpu, wakeup_watermark);
 }
 
 int uprobes_with_stack_and_sp_event_open(const char* module, uint64_t function_offset, pid_t pid,
-                                         int32_t cpu, uint16_t stack_dump_size) {
+                                         int32_t cpu, uint16_t stack_dump_size,
+                                         uint32_t wakeup_watermark) {
   perf_event_attr pe = uprobe_event_attr(module, function_offset);
   pe.config &= ~1ULL;
   pe.sample_type |= PERF_SAMPLE_REGS_USER | PERF_SAMPLE_STACK_USER;
@@ -129,36 +136,37 @@ int uprobes_with_stack_and_sp_event_open(const char* module, uint64_t function_o
 
   pe.sample_stack_user = stack_dump_size;
 
-  return generic_event_open(&pe, pid, cpu);
+  return generic_event_open(&pe, pid, cpu, wakeup_watermark);
 }
 
 int uprobes_retaddr_args_event_open(const char* module, uint64_t function_offset, pid_t pid,
-                                    int32_t cpu) {
+                                    int32_t cpu, uint32_t wakeup_watermark) {
   perf_event_attr pe = uprobe_event_attr(module, function_offset);
   pe.config &= ~1ULL;
   pe.sample_type |= PERF_SAMPLE_REGS_USER | PERF_SAMPLE_STACK_USER;
   pe.sample_regs_user = SAMPLE_REGS_USER_SP_IP_ARGUMENTS;
   pe.sample_stack_user = SAMPLE_STACK_USER_SIZE_8BYTES;
 
-  return generic_event_open(&pe, pid, cpu);
+  return generic_event_open(&pe, pid, cpu, wakeup_watermark);
 }
 
-int uretprobes_event_open(const char* module, uint64_t function_offset, pid_t pid, int32_t cpu) {
+int uretprobes_event_open(const char* module, uint64_t function_offset, pid_t pid, int32_t cpu,
+                          uint32_t wakeup_watermark) {
   perf_event_attr pe = uprobe_event_attr(module, function_offset);
   pe.config |= 1;  // Set bit 0 of config for uretprobe.
 
-  return generic_event_open(&pe, pid, cpu);
+  return generic_event_open(&pe, pid, cpu, wakeup_watermark);
 }
 
 int uretprobes_retval_event_open(const char* module, uint64_t function_offset, pid_t pid,
-                                 int32_t cpu) {
+                                 int32_t cpu, uint32_t wakeup_watermark) {
   perf_event_attr pe = uprobe_event_attr(module, function_offset);
   pe.config |= 1;  // Set bit 0 of config for uretprobe.
 
   pe.sample_type |= PERF_SAMPLE_REGS_USER;
   pe.sample_regs_user = SAMPLE_REGS_USER_AX;
 
-  return generic_event_open(&pe, pid, cpu);
+  return generic_event_open(&pe, pid, cpu, wakeup_watermark);
 }
 
 void* perf_event_open_mmap_ring_buffer(int fd, uint64_t mmap_length) {
@@ -180,7 +188,7 @@ void* perf_event_open_mmap_ring_buffer(int fd, uint64_t mmap_length) {
 }
 
 int tracepoint_event_open(const char* tracepoint_category, const char* tracepoint_name, pid_t pid,
-                          int32_t cpu) {
+                          int32_t cpu, uint32_t wakeup_watermark) {
   int tp_id = GetTracepointId(tracepoint_category, tracepoint_name);
   if (tp_id == -1) {
     return -1;
@@ -190,7 +198,7 @@ int tracepoint_event_open(const char* tracepoint_category, const char* tracepoin
   pe.config = tp_id;
   pe.sample_type |= PERF_SAMPLE_RAW;
 
-  return generic_event_open(&pe, pid, cpu);
+  return generic_event_open(&pe, pid, cpu, wakeup_watermark);
 }
 
 }  // namespace orbit_linux_tracing
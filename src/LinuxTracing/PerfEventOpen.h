@@ -113,33 +113,42 @@ static constexpr uint16_t SAMPLE_STACK_USER_SIZE_8BYTES = 8;
 // See also `ClientFlags.cpp`.
 static constexpr uint16_t kMaxStackSampleUserSize = 65000;
 
+// All the functions below that open a perf_event_open file descriptor take a `wakeup_watermark`.
+// If it is greater than zero, readers waiting on the file descriptor with poll/epoll are woken up
+// once the associated ring buffer contains at least that many bytes. If it is zero, the kernel
+// default is used. This only has an effect on the file descriptor that owns the ring buffer, as
+// opposed to one redirected to an existing ring buffer.
+
 // perf_event_open for context switches.
-int context_switch_event_open(pid_t pid, int32_t cpu);
+int context_switch_event_open(pid_t pid, int32_t cpu, uint32_t wakeup_watermark);
 
 // perf_event_open for task (fork and exit) and mmap records in the same buffer.
-int mmap_task_event_open(pid_t pid, int32_t cpu);
+int mmap_task_event_open(pid_t pid, int32_t cpu, uint32_t wakeup_watermark);
 
 // perf_event_open for stack sampling.
-int stack_sample_event_open(uint64_t period_ns, pid_t pid, int32_t cpu, uint16_t stack_dump_size);
+int stack_sample_event_open(uint64_t period_ns, pid_t pid, int32_t cpu, uint16_t stack_dump_size,
+                            uint32_t wakeup_watermark);
 
 // perf_event_open for stack sampling using frame pointers.
 int callchain_sample_event_open(uint64_t period_ns, pid_t pid, int32_t cpu,
-                                uint16_t stack_dump_size);
+                                uint16_t stack_dump_size, uint32_t wakeup_watermark);
 
 // perf_event_open for uprobes and uretprobes.
 int uprobes_retaddr_event_open(const char* module, uint64_t function_offset, pid_t pid,
-                               int32_t cpu);
+                               int32_t cpu, uint32_t wakeup_watermark);
 
 int uprobes_with_stack_and_sp_event_open(const char* module, uint64_t function_offset, pid_t pid,
-                                         int32_t cpu, uint16_t stack_dump_size);
+                                         int32_t cpu, uint16_t stack_dump_size,
+                                         uint32_t wakeup_watermark);
 
 int uprobes_retaddr_args_event_open(const char* module, uint64_t function_offset, pid_t pid,
-                                    int32_t cpu);
+                                    int32_t cpu, uint32_t wakeup_watermark);
 
-int uretprobes_event_open(const char* module, uint64_t function_offset, pid_t pid, int32_t cpu);
+int uretprobes_event_open(const char* module, uint64_t function_offset, pid_t pid, int32_t cpu,
+                          uint32_t wakeup_watermark);
 
 int uretprobes_retval_event_open(const char* module, uint64_t function_offset, pid_t pid,
-                                 int32_t cpu);
+                                 int32_t cpu, uint32_t wakeup_watermark);
 
 // Create the ring buffer to use perf_event_open in sampled mode.
 void* perf_event_open_mmap_ring_buffer(int fd, uint64_t mmap_length);
@@ -149,7 +158,7 @@ void* perf_event_open_mmap_ring_buffer(int fd, uint64_t mmap_length);
 // (for example, "sched_waking"). Returns the file descriptor for the
 // perf event or -1 in case of any errors.
 int tracepoint_event_open(const char* tracepoint_category, const char* tracepoint_name, pid_t pid,
-                          int32_t cpu);
+                          int32_t cpu, uint32_t wakeup_watermark);
 
 }  // namespace orbit_linux_tracing
 
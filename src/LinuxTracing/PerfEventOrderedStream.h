@@ -10,7 +10,7 @@
 
 namespace orbit_linux_tracing {
 
-// This class holds information on streams on which `PerfEvent`s can be assumed in relative order of
+// timestamp. The information is used by `CalendarPerfEventQueue` and `PerfEventQueue`.
 // timestamp. The information is used by `PerfEventQueue`.
 // In addition to the lack of order, the supported ordered streams are perf_event_open ring buffers
 // (identified by file descriptor) and threads (identified by thread id).
@@ -4,16 +4,25 @@
 
 #include "PerfEventProcessor.h"
 
+#include <algorithm>
 #include <utility>
 #include <variant>
 
 #include "OrbitBase/Logging.h"
-#include "OrbitBase/Profiling.h"
 #include "PerfEvent.h"
 
 namespace orbit_linux_tracing {
 
+void PerfEventProcessor::EnableAdaptiveProcessingDelay() {
+  adaptive_processing_delay_enabled_ = true;
+  lateness_window_begin_ns_ = get_current_timestamp_ns_();
+}
+
 void PerfEventProcessor::AddEvent(PerfEvent&& event) {
+  if (adaptive_processing_delay_enabled_) {
+    UpdateLateness(event);
+  }
+
   const uint64_t timestamp = event.timestamp;
   if (last_processed_timestamp_ns_ > 0 && timestamp < last_processed_timestamp_ns_) {
     if (discarded_out_of_order_counter_ != nullptr) {
@@ -84,6 +93,59 @@ std::optional<DiscardedPerfEvent> PerfEventProcessor::HandleOutOfOrderEvent(
   return optional_discarded_event;
 }
 
+void PerfEventProcessor::UpdateLateness(const PerfEvent& event) {
+  const uint64_t current_timestamp_ns = get_current_timestamp_ns_();
+  if (event.timestamp >= current_timestamp_ns) return;
+  const uint64_t lateness_ns = current_timestamp_ns - event.timestamp;
+
+  StreamLateness& stream_lateness = lateness_by_ordered_stream_[event.ordered_stream];
+  stream_lateness.current_window_max_lateness_ns =
+      std::max(stream_lateness.current_window_max_lateness_ns, lateness_ns);
+
+  // Grow the delay immediately, so that events that are added with similar lateness in the near
+  // future don't get discarded.
+  const uint64_t required_processing_delay_ns =
+      std::min(lateness_ns * kAdaptiveProcessingDelayToLatenessRatio,
+               kMaxAdaptiveProcessingDelayMs * 1'000'000);
+  if (required_processing_delay_ns > processing_delay_ns_.load(std::memory_order_relaxed)) {
+    processing_delay_ns_.store(required_processing_delay_ns, std::memory_order_relaxed);
+  }
+}
+
+void PerfEventProcessor::UpdateAdaptiveProcessingDelay(uint64_t current_timestamp_ns) {
+  if (current_timestamp_ns < lateness_window_begin_ns_ + kLatenessWindowMs * 1'000'000) return;
+  lateness_window_begin_ns_ = current_timestamp_ns;
+
+  uint64_t max_lateness_ns = 0;
+  for (auto it = lateness_by_ordered_stream_.begin(); it != lateness_by_ordered_stream_.end();) {
+    StreamLateness& stream_lateness = it->second;
+    max_lateness_ns =
+        std::max({max_lateness_ns, stream_lateness.previous_window_max_lateness_ns,
+                  stream_lateness.current_window_max_lateness_ns});
+    if (stream_lateness.current_window_max_lateness_ns == 0) {
+      // No events were added in the last window, e.g., because the thread exited.
+      lateness_by_ordered_stream_.erase(it++);
+      continue;
+    }
+    stream_lateness.previous_window_max_lateness_ns =
+        stream_lateness.current_window_max_lateness_ns;
+    stream_lateness.current_window_max_lateness_ns = 0;
+    ++it;
+  }
+
+  // Shrink the delay gradually, by at most a quarter per window, to avoid that the delay
+  // oscillates when the lateness is irregular.
+  const uint64_t processing_delay_ns = processing_delay_ns_.load(std::memory_order_relaxed);
+  const uint64_t target_processing_delay_ns =
+      std::clamp(max_lateness_ns * kAdaptiveProcessingDelayToLatenessRatio,
+                 kMinAdaptiveProcessingDelayMs * 1'000'000,
+                 kMaxAdaptiveProcessingDelayMs * 1'000'000);
+  if (target_processing_delay_ns < processing_delay_ns) {
+    processing_delay_ns_.store(std::max(target_processing_delay_ns, processing_delay_ns / 4 * 3),
+                               std::memory_order_relaxed);
+  }
+}
+
 void PerfEventProcessor::ProcessAllEvents() {
   ORBIT_CHECK(!visitors_.empty());
   while (event_queue_.HasEvent()) {
@@ -101,14 +163,18 @@ void PerfEventProcessor::ProcessAllEvents() {
 
 void PerfEventProcessor::ProcessOldEvents() {
   ORBIT_CHECK(!visitors_.empty());
-  const uint64_t current_timestamp_ns = orbit_base::CaptureTimestampNs();
+  const uint64_t current_timestamp_ns = get_current_timestamp_ns_();
+  if (adaptive_processing_delay_enabled_) {
+    UpdateAdaptiveProcessingDelay(current_timestamp_ns);
+  }
+  const uint64_t processing_delay_ns = processing_delay_ns_.load(std::memory_order_relaxed);
 
   while (event_queue_.HasEvent()) {
     const PerfEvent& event = event_queue_.TopEvent();
     const uint64_t timestamp = event.timestamp;
 
     // Do not read the most recent events as out-of-order events could (and will) arrive.
-    if (timestamp + kProcessingDelayMs * 1'000'000 >= current_timestamp_ns) {
+    if (timestamp + processing_delay_ns >= current_timestamp_ns) {
       break;
     }
     // Events are guaranteed to be processed in order of timestamp
@@ -5,15 +5,20 @@
 #ifndef LINUX_TRACING_PERF_EVENT_PROCESSOR_H_
 #define LINUX_TRACING_PERF_EVENT_PROCESSOR_H_
 
+#include <absl/container/flat_hash_map.h>
 #include <stdint.h>
 
 #include <algorithm>
 #include <atomic>
+#include <functional>
 #include <optional>
+#include <utility>
 #include <vector>
 
+#include "CalendarPerfEventQueue.h"
+#include "OrbitBase/Profiling.h"
 #include "PerfEvent.h"
-#include "PerfEventQueue.h"
+#include "PerfEventOrderedStream.h"
 #include "PerfEventVisitor.h"
 
 namespace orbit_linux_tracing {
@@ -25,8 +30,17 @@ namespace orbit_linux_tracing {
 // we will never process events out of order.
 // If events older than kProcessingDelayMs are encountered anyway, these are discarded, and
 // DiscardedPerfEvents are generated and processed in their place.
+// Optionally, the processing delay can adapt to how late events are actually added (see
+// EnableAdaptiveProcessingDelay), in which case the same applies to the adaptive delay.
 class PerfEventProcessor {
  public:
+  // `get_current_timestamp_ns` is the clock against which the timestamps of the events are compared
+  // to decide which events are old enough to be processed and how late events are added. Tests can
+  // replace it to control time.
+  explicit PerfEventProcessor(
+      std::function<uint64_t()> get_current_timestamp_ns = orbit_base::CaptureTimestampNs)
+      : get_current_timestamp_ns_{std::move(get_current_timestamp_ns)} {}
+
   void AddEvent(PerfEvent&& event);
 
   void ProcessAllEvents();
@@ -41,23 +55,62 @@ class PerfEventProcessor {
     discarded_out_of_order_counter_ = discarded_out_of_order_counter;
   }
 
+  // Instead of always delaying the processing of events by kProcessingDelayMs, track the maximum
+  // lateness of the events of each ordered stream, i.e., how long after their timestamp they are
+  // added, and delay the processing by a multiple of the maximum lateness observed recently. The
+  // delay grows as soon as a later event is added, and shrinks gradually when events have been
+  // added with less lateness for a while. It always stays between kMinAdaptiveProcessingDelayMs
+  // and kMaxAdaptiveProcessingDelayMs, starting from kProcessingDelayMs. This reduces the latency
+  // and the number of events kept in memory, while events that are added even later than the
+  // delay are still discarded like with the fixed delay.
+  void EnableAdaptiveProcessingDelay();
+
+  // Can be called from any thread.
+  [[nodiscard]] uint64_t GetProcessingDelayNs() const {
+    return processing_delay_ns_.load(std::memory_order_relaxed);
+  }
+
   // Do not process events that are more recent than kProcessingDelayMs. Events
   // come out of order as they are read from different perf_event_open ring
   // buffers and this ensures that all events are processed in the correct
   // order.
   static constexpr uint64_t kProcessingDelayMs = 333;
 
+  static constexpr uint64_t kMinAdaptiveProcessingDelayMs = 20;
+  static constexpr uint64_t kMaxAdaptiveProcessingDelayMs = 1000;
+
  private:
+  // The processing delay is this many times the maximum lateness.
+  static constexpr uint64_t kAdaptiveProcessingDelayToLatenessRatio = 2;
+  // The maximum lateness of each ordered stream is tracked over windows of this duration. A stream
+  // keeps contributing to the processing delay with its maximum lateness of the previous window,
+  // so it takes between one and two windows for a late event to stop affecting the delay.
+  static constexpr uint64_t kLatenessWindowMs = 1000;
+
+  void UpdateLateness(const PerfEvent& event);
+  void UpdateAdaptiveProcessingDelay(uint64_t current_timestamp_ns);
+
+  std::function<uint64_t()> get_current_timestamp_ns_;
+
   uint64_t last_processed_timestamp_ns_ = 0;
   std::atomic<uint64_t>* discarded_out_of_order_counter_ = nullptr;
 
-  PerfEventQueue event_queue_;
+  CalendarPerfEventQueue event_queue_{kProcessingDelayMs * 1'000'000};
   std::vector<PerfEventVisitor*> visitors_;
 
   [[nodiscard]] std::optional<DiscardedPerfEvent> HandleOutOfOrderEvent(
       uint64_t event_timestamp_ns);
   uint64_t last_discarded_begin_ = 0;
   uint64_t last_discarded_end_ = 0;
+
+  std::atomic<uint64_t> processing_delay_ns_ = kProcessingDelayMs * 1'000'000;
+  bool adaptive_processing_delay_enabled_ = false;
+  struct StreamLateness {
+    uint64_t current_window_max_lateness_ns = 0;
+    uint64_t previous_window_max_lateness_ns = 0;
+  };
+  absl::flat_hash_map<PerfEventOrderedStream, StreamLateness> lateness_by_ordered_stream_;
+  uint64_t lateness_window_begin_ns_ = 0;
 };
 
 }  // namespace orbit_linux_tracing
@@ -208,6 +208,77 @@ TEST_F(PerfEventProcessorTest, DiscardedPerfEvents) {
   EXPECT_EQ(discarded_out_of_order_counter_, 5);
 }
 
+TEST_F(PerfEventProcessorTest, AdaptiveProcessingDelayShrinksWhenEventsAreNotLate) {
+  uint64_t current_timestamp_ns = 1'000'000'000;
+  PerfEventProcessor processor{[&current_timestamp_ns] { return current_timestamp_ns; }};
+  processor.AddVisitor(&mock_visitor_);
+  processor.SetDiscardedOutOfOrderCounter(&discarded_out_of_order_counter_);
+  processor.EnableAdaptiveProcessingDelay();
+  EXPECT_EQ(processor.GetProcessingDelayNs(), PerfEventProcessor::kProcessingDelayMs * 1'000'000);
+
+  // Add an event every 10 ms, 1 ms after its timestamp, for `window_count` lateness windows.
+  auto add_events_for_windows = [&](uint64_t window_count) {
+    constexpr uint64_t kEventIntervalNs = 10'000'000;
+    constexpr uint64_t kLatenessNs = 1'000'000;
+    constexpr uint64_t kEventsPerWindow = 1'000'000'000 / kEventIntervalNs;
+    for (uint64_t i = 0; i < window_count * kEventsPerWindow; ++i) {
+      current_timestamp_ns += kEventIntervalNs;
+      processor.AddEvent(MakeFakePerfEventOrderedInFd(11, current_timestamp_ns - kLatenessNs));
+      processor.ProcessOldEvents();
+    }
+  };
+
+  EXPECT_CALL(mock_visitor_, Visit(_, A<const ForkPerfEventData&>())).Times(::testing::AtLeast(1));
+  // The delay shrinks by a quarter per window...
+  add_events_for_windows(1);
+  EXPECT_EQ(processor.GetProcessingDelayNs(),
+            PerfEventProcessor::kProcessingDelayMs * 1'000'000 / 4 * 3);
+
+  // ...until it reaches the minimum, as twice the lateness is below it.
+  add_events_for_windows(10);
+  EXPECT_EQ(processor.GetProcessingDelayNs(),
+            PerfEventProcessor::kMinAdaptiveProcessingDelayMs * 1'000'000);
+  EXPECT_EQ(discarded_out_of_order_counter_, 0);
+}
+
+TEST_F(PerfEventProcessorTest, AdaptiveProcessingDelayGrowsWithLateEvents) {
+  processor_.EnableAdaptiveProcessingDelay();
+
+  constexpr uint64_t kLatenessNs = 400'000'000;
+  processor_.AddEvent(
+      MakeFakePerfEventOrderedInFd(11, orbit_base::CaptureTimestampNs() - kLatenessNs));
+  EXPECT_GE(processor_.GetProcessingDelayNs(), 2 * kLatenessNs);
+
+  // The event is older than kProcessingDelayMs, but not older than the new delay.
+  EXPECT_CALL(mock_visitor_, Visit(_, A<const ForkPerfEventData&>())).Times(0);
+  processor_.ProcessOldEvents();
+
+  Mock::VerifyAndClearExpectations(&mock_visitor_);
+
+  processor_.AddEvent(
+      MakeFakePerfEventOrderedInFd(22, orbit_base::CaptureTimestampNs() - 10 * kLatenessNs));
+  EXPECT_EQ(processor_.GetProcessingDelayNs(),
+            PerfEventProcessor::kMaxAdaptiveProcessingDelayMs * 1'000'000);
+}
+
+TEST_F(PerfEventProcessorTest, AdaptiveProcessingDelayStillDiscardsOutOfOrderEvents) {
+  processor_.EnableAdaptiveProcessingDelay();
+
+  const uint64_t timestamp_ns = orbit_base::CaptureTimestampNs();
+  EXPECT_CALL(mock_visitor_, Visit(_, A<const ForkPerfEventData&>())).Times(1);
+  processor_.AddEvent(MakeFakePerfEventOrderedInFd(11, timestamp_ns));
+  processor_.ProcessAllEvents();
+
+  Mock::VerifyAndClearExpectations(&mock_visitor_);
+
+  EXPECT_CALL(mock_visitor_, Visit(_, A<const ForkPerfEventData&>())).Times(0);
+  EXPECT_CALL(mock_visitor_, Visit(timestamp_ns, DiscardedPerfEventDataEq(timestamp_ns - 10)))
+      .Times(1);
+  processor_.AddEvent(MakeFakePerfEventOrderedInFd(22, timestamp_ns - 10));
+  processor_.ProcessAllEvents();
+  EXPECT_EQ(discarded_out_of_order_counter_, 1);
+}
+
 TEST_F(PerfEventProcessorTest, ProcessOldEventsNeedsVisitor) {
   processor_.ClearVisitors();
   processor_.AddEvent(MakeFakePerfEventOrderedInFd(11, orbit_base::CaptureTimestampNs()));
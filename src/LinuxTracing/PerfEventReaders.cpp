@@ -18,67 +18,58 @@
 #include "OrbitBase/Logging.h"
 #include "OrbitBase/MakeUniqueForOverwrite.h"
 #include "OrbitBase/ThreadUtils.h"
+#include "PerfEventBufferPool.h"
 #include "PerfEventOrderedStream.h"
 #include "PerfEventRecords.h"
 #include "PerfEventRingBuffer.h"
 
 namespace orbit_linux_tracing {
 
-void ReadPerfSampleIdAll(PerfEventRingBuffer* ring_buffer, const perf_event_header& header,
+void ReadPerfSampleIdAll(const PerfEventRecordView& record,
                          perf_event_sample_id_tid_time_streamid_cpu* sample_id) {
   ORBIT_CHECK(sample_id != nullptr);
-  ORBIT_CHECK(header.size >
+  ORBIT_CHECK(record.GetSize() >
               sizeof(perf_event_header) + sizeof(perf_event_sample_id_tid_time_streamid_cpu));
   // sample_id_all is always the last field in the event
-  uint64_t offset = header.size - sizeof(perf_event_sample_id_tid_time_streamid_cpu);
-  ring_buffer->ReadValueAtOffset(sample_id, offset);
+  uint64_t offset = record.GetSize() - sizeof(perf_event_sample_id_tid_time_streamid_cpu);
+  record.ReadRawAtOffset(sample_id, offset, sizeof(perf_event_sample_id_tid_time_streamid_cpu));
 }
 
-uint64_t ReadSampleRecordTime(PerfEventRingBuffer* ring_buffer) {
-  uint64_t time;
+uint64_t ReadSampleRecordTime(const PerfEventRecordView& record) {
   // All PERF_RECORD_SAMPLEs start with
   //   perf_event_header header;
   //   perf_event_sample_id_tid_time_streamid_cpu sample_id;
-  ring_buffer->ReadValueAtOffset(
-      &time,
+  return record.ReadValueAtOffset<uint64_t>(
       sizeof(perf_event_header) + offsetof(perf_event_sample_id_tid_time_streamid_cpu, time));
-  return time;
 }
 
-uint64_t ReadSampleRecordStreamId(PerfEventRingBuffer* ring_buffer) {
-  uint64_t stream_id;
+uint64_t ReadSampleRecordStreamId(const PerfEventRecordView& record) {
   // All PERF_RECORD_SAMPLEs start with
   //   perf_event_header header;
   //   perf_event_sample_id_tid_time_streamid_cpu sample_id;
-  ring_buffer->ReadValueAtOffset(
-      &stream_id,
+  return record.ReadValueAtOffset<uint64_t>(
       sizeof(perf_event_header) + offsetof(perf_event_sample_id_tid_time_streamid_cpu, stream_id));
-  return stream_id;
 }
 
-pid_t ReadSampleRecordPid(PerfEventRingBuffer* ring_buffer) {
-  pid_t pid;
+pid_t ReadSampleRecordPid(const PerfEventRecordView& record) {
   // All PERF_RECORD_SAMPLEs start with
   //   perf_event_header header;
   //   perf_event_sample_id_tid_time_streamid_cpu sample_id;
-  ring_buffer->ReadValueAtOffset(
-      &pid, sizeof(perf_event_header) + offsetof(perf_event_sample_id_tid_time_streamid_cpu, pid));
-  return pid;
+  return record.ReadValueAtOffset<pid_t>(
+      sizeof(perf_event_header) + offsetof(perf_event_sample_id_tid_time_streamid_cpu, pid));
 }
 
-uint64_t ReadThrottleUnthrottleRecordTime(PerfEventRingBuffer* ring_buffer) {
+uint64_t ReadThrottleUnthrottleRecordTime(const PerfEventRecordView& record) {
   // Note that perf_event_throttle_unthrottle::time and
   // perf_event_sample_id_tid_time_streamid_cpu::time differ a bit. Use the latter as we use that
   // for all other events.
-  uint64_t time;
-  ring_buffer->ReadValueAtOffset(&time,
-                                 offsetof(perf_event_throttle_unthrottle, sample_id) +
-                                     offsetof(perf_event_sample_id_tid_time_streamid_cpu, time));
-  return time;
+  return record.ReadValueAtOffset<uint64_t>(
+      offsetof(perf_event_throttle_unthrottle, sample_id) +
+      offsetof(perf_event_sample_id_tid_time_streamid_cpu, time));
 }
 
 MmapPerfEvent ConsumeMmapPerfEvent(PerfEventRingBuffer* ring_buffer,
-                                   const perf_event_header& header) {
+                                   const PerfEventRecordView& record) {
   // Mmap records have the following layout:
   // struct {
   //   struct perf_event_header header;
@@ -91,11 +82,12 @@ MmapPerfEvent ConsumeMmapPerfEvent(PerfEventRingBuffer* ring_buffer,
   // };
   // Because of filename, the layout is not fixed.
 
+  const perf_event_header& header = record.GetHeader();
+
   perf_event_sample_id_tid_time_streamid_cpu sample_id;
-  ReadPerfSampleIdAll(ring_buffer, header, &sample_id);
+  ReadPerfSampleIdAll(record, &sample_id);
 
-  perf_event_mmap_up_to_pgoff mmap_event;
-  ring_buffer->ReadValueAtOffset(&mmap_event, 0);
+  const auto mmap_event = record.ReadValueAtOffset<perf_event_mmap_up_to_pgoff>(0);
 
   // read filename
   size_t filename_offset = sizeof(perf_event_mmap_up_to_pgoff);
@@ -104,7 +96,7 @@ MmapPerfEvent ConsumeMmapPerfEvent(PerfEventRingBuffer* ring_buffer,
   size_t filename_size =
       header.size - filename_offset - sizeof(perf_event_sample_id_tid_time_streamid_cpu);
   std::vector<char> filename_vector(filename_size);
-  ring_buffer->ReadRawAtOffset(&filename_vector[0], filename_offset, filename_size);
+  record.ReadRawAtOffset(&filename_vector[0], filename_offset, filename_size);
   // This is a bit paranoid but you never know
   filename_vector.back() = '\0';
   std::string filename(filename_vector.data());
@@ -144,7 +136,8 @@ MmapPerfEvent ConsumeMmapPerfEvent(PerfEventRingBuffer* ring_buffer,
 }
 
 StackSamplePerfEvent ConsumeStackSamplePerfEvent(PerfEventRingBuffer* ring_buffer,
-                                                 const perf_event_header& header) {
+                                                 const PerfEventRecordView& record,
+                                                 PerfEventBufferPool* buffer_pool) {
   // We expect the following layout of the perf event:
   //  struct {
   //    struct perf_event_header header;
@@ -166,16 +159,14 @@ StackSamplePerfEvent ConsumeStackSamplePerfEvent(PerfEventRingBuffer* ring_buffe
       offsetof(perf_event_stack_sample_fixed, regs) + sizeof(perf_event_sample_regs_user_all);
   size_t offset_of_data = offset_of_size + sizeof(uint64_t);
 
-  uint64_t size = 0;
-  ring_buffer->ReadValueAtOffset(&size, offset_of_size);
+  const auto size = record.ReadValueAtOffset<uint64_t>(offset_of_size);
 
   size_t offset_of_dyn_size = offset_of_data + (size * sizeof(char));
 
-  uint64_t dyn_size = 0;
-  ring_buffer->ReadValueAtOffset(&dyn_size, offset_of_dyn_size);
+  const auto dyn_size = record.ReadValueAtOffset<uint64_t>(offset_of_dyn_size);
 
-  perf_event_sample_id_tid_time_streamid_cpu sample_id;
-  ring_buffer->ReadValueAtOffset(&sample_id, offsetof(perf_event_stack_sample_fixed, sample_id));
+  const auto sample_id = record.ReadValueAtOffset<perf_event_sample_id_tid_time_streamid_cpu>(
+      offsetof(perf_event_stack_sample_fixed, sample_id));
 
   StackSamplePerfEvent event{
       .timestamp = sample_id.time,
@@ -184,21 +175,22 @@ StackSamplePerfEvent ConsumeStackSamplePerfEvent(PerfEventRingBuffer* ring_buffe
           {
               .pid = static_cast<pid_t>(sample_id.pid),
               .tid = static_cast<pid_t>(sample_id.tid),
-              .regs = make_unique_for_overwrite<perf_event_sample_regs_user_all>(),
+              .regs = MakeUniqueForOverwriteFromPool<perf_event_sample_regs_user_all>(buffer_pool),
               .dyn_size = dyn_size,
-              .data = make_unique_for_overwrite<char[]>(dyn_size),
+              .data = MakeUniqueForOverwriteFromPool<char[]>(buffer_pool, dyn_size),
           },
   };
 
-  ring_buffer->ReadValueAtOffset(event.data.regs.get(),
-                                 offsetof(perf_event_stack_sample_fixed, regs));
-  ring_buffer->ReadRawAtOffset(event.data.data.get(), offset_of_data, dyn_size);
-  ring_buffer->SkipRecord(header);
+  record.ReadRawAtOffset(event.data.regs.get(), offsetof(perf_event_stack_sample_fixed, regs),
+                         sizeof(perf_event_sample_regs_user_all));
+  record.ReadRawAtOffset(event.data.data.get(), offset_of_data, dyn_size);
+  ring_buffer->SkipRecord(record.GetHeader());
   return event;
 }
 
 CallchainSamplePerfEvent ConsumeCallchainSamplePerfEvent(PerfEventRingBuffer* ring_buffer,
-                                                         const perf_event_header& header) {
+                                                         const PerfEventRecordView& record,
+                                                         PerfEventBufferPool* buffer_pool) {
   // We expect the following layout of the perf event:
   //  struct {
   //    struct perf_event_header header;
@@ -217,8 +209,8 @@ CallchainSamplePerfEvent ConsumeCallchainSamplePerfEvent(PerfEventRingBuffer* ri
   //  };
   // Unfortunately, the number of `ips` is dynamic, so we need to compute the offsets by hand,
   // rather than relying on a struct.
-  uint64_t nr = 0;
-  ring_buffer->ReadValueAtOffset(&nr, offsetof(perf_event_callchain_sample_fixed, nr));
+  const auto nr =
+      record.ReadValueAtOffset<uint64_t>(offsetof(perf_event_callchain_sample_fixed, nr));
 
   const uint64_t size_of_ips_in_bytes = nr * sizeof(uint64_t);
 
@@ -230,15 +222,12 @@ CallchainSamplePerfEvent ConsumeCallchainSamplePerfEvent(PerfEventRingBuffer* ri
       offset_of_regs_user_struct + sizeof(perf_event_sample_regs_user_all);
   const size_t offset_of_data = offset_of_size + sizeof(uint64_t);
 
-  uint64_t size = 0;
-  ring_buffer->ReadRawAtOffset(&size, offset_of_size, sizeof(uint64_t));
+  const auto size = record.ReadValueAtOffset<uint64_t>(offset_of_size);
 
   const size_t offset_of_dyn_size = offset_of_data + size;
-  uint64_t dyn_size = 0;
-  ring_buffer->ReadRawAtOffset(&dyn_size, offset_of_dyn_size, sizeof(uint64_t));
-  perf_event_sample_id_tid_time_streamid_cpu sample_id;
-  ring_buffer->ReadValueAtOffset(&sample_id,
-                                 offsetof(perf_event_callchain_sample_fixed, sample_id));
+  const auto dyn_size = record.ReadValueAtOffset<uint64_t>(offset_of_dyn_size);
+  const auto sample_id = record.ReadValueAtOffset<perf_event_sample_id_tid_time_streamid_cpu>(
+      offsetof(perf_event_callchain_sample_fixed, sample_id));
 
   CallchainSamplePerfEvent event{
       .timestamp = sample_id.time,
@@ -248,23 +237,23 @@ CallchainSamplePerfEvent ConsumeCallchainSamplePerfEvent(PerfEventRingBuffer* ri
               .pid = static_cast<pid_t>(sample_id.pid),
               .tid = static_cast<pid_t>(sample_id.tid),
               .ips_size = nr,
-              .ips = make_unique_for_overwrite<uint64_t[]>(nr),
-              .regs = make_unique_for_overwrite<perf_event_sample_regs_user_all>(),
-              .data = make_unique_for_overwrite<char[]>(dyn_size),
+              .ips = MakeUniqueForOverwriteFromPool<uint64_t[]>(buffer_pool, nr),
+              .regs = MakeUniqueForOverwriteFromPool<perf_event_sample_regs_user_all>(buffer_pool),
+              .data = MakeUniqueForOverwriteFromPool<char[]>(buffer_pool, dyn_size),
           },
   };
 
-  ring_buffer->ReadRawAtOffset(event.data.ips.get(), offset_of_ips, size_of_ips_in_bytes);
-  ring_buffer->ReadRawAtOffset(event.data.regs.get(), offset_of_regs_user_struct,
-                               sizeof(perf_event_sample_regs_user_all));
-  ring_buffer->ReadRawAtOffset(event.data.data.get(), offset_of_data, dyn_size);
+  record.ReadRawAtOffset(event.data.ips.get(), offset_of_ips, size_of_ips_in_bytes);
+  record.ReadRawAtOffset(event.data.regs.get(), offset_of_regs_user_struct,
+                         sizeof(perf_event_sample_regs_user_all));
+  record.ReadRawAtOffset(event.data.data.get(), offset_of_data, dyn_size);
 
-  ring_buffer->SkipRecord(header);
+  ring_buffer->SkipRecord(record.GetHeader());
   return event;
 }
 
 UprobesWithStackPerfEvent ConsumeUprobeWithStackPerfEvent(PerfEventRingBuffer* ring_buffer,
-                                                          const perf_event_header& header) {
+                                                          const PerfEventRecordView& record) {
   // We expect the following layout of the perf event:
   //  struct {
   //    struct perf_event_header header;
@@ -286,20 +275,17 @@ UprobesWithStackPerfEvent ConsumeUprobeWithStackPerfEvent(PerfEventRingBuffer* r
                           sizeof(perf_event_sample_regs_user_sp);
   size_t offset_of_data = offset_of_size + sizeof(uint64_t);
 
-  uint64_t size = 0;
-  ring_buffer->ReadValueAtOffset(&size, offset_of_size);
+  const auto size = record.ReadValueAtOffset<uint64_t>(offset_of_size);
 
   size_t offset_of_dyn_size = offset_of_data + (size * sizeof(char));
 
-  uint64_t dyn_size = 0;
-  ring_buffer->ReadValueAtOffset(&dyn_size, offset_of_dyn_size);
+  const auto dyn_size = record.ReadValueAtOffset<uint64_t>(offset_of_dyn_size);
 
-  perf_event_sample_id_tid_time_streamid_cpu sample_id;
-  ring_buffer->ReadValueAtOffset(&sample_id,
-                                 offsetof(perf_event_sp_stack_user_sample_fixed, sample_id));
+  const auto sample_id = record.ReadValueAtOffset<perf_event_sample_id_tid_time_streamid_cpu>(
+      offsetof(perf_event_sp_stack_user_sample_fixed, sample_id));
 
-  perf_event_sample_regs_user_sp regs;
-  ring_buffer->ReadValueAtOffset(&regs, offsetof(perf_event_sp_stack_user_sample_fixed, regs));
+  const auto regs = record.ReadValueAtOffset<perf_event_sample_regs_user_sp>(
+      offsetof(perf_event_sp_stack_user_sample_fixed, regs));
 
   UprobesWithStackPerfEvent event{
       .timestamp = sample_id.time,
@@ -314,15 +300,14 @@ UprobesWithStackPerfEvent ConsumeUprobeWithStackPerfEvent(PerfEventRingBuffer* r
               .data = make_unique_for_overwrite<char[]>(dyn_size),
           },
   };
-  ring_buffer->ReadRawAtOffset(event.data.data.get(), offset_of_data, dyn_size);
-  ring_buffer->SkipRecord(header);
+  record.ReadRawAtOffset(event.data.data.get(), offset_of_data, dyn_size);
+  ring_buffer->SkipRecord(record.GetHeader());
   return event;
 }
 
 GenericTracepointPerfEvent ConsumeGenericTracepointPerfEvent(PerfEventRingBuffer* ring_buffer,
-                                                             const perf_event_header& header) {
-  perf_event_raw_sample_fixed ring_buffer_record;
-  ring_buffer->ReadRawAtOffset(&ring_buffer_record, 0, sizeof(perf_event_raw_sample_fixed));
+                                                             const PerfEventRecordView& record) {
+  const auto ring_buffer_record = record.ReadValueAtOffset<perf_event_raw_sample_fixed>(0);
   GenericTracepointPerfEvent event{
       .timestamp = ring_buffer_record.sample_id.time,
       .ordered_stream = PerfEventOrderedStream::FileDescriptor(ring_buffer->GetFileDescriptor()),
@@ -334,27 +319,23 @@ GenericTracepointPerfEvent ConsumeGenericTracepointPerfEvent(PerfEventRingBuffer
           },
   };
 
-  ring_buffer->SkipRecord(header);
+  ring_buffer->SkipRecord(record.GetHeader());
   return event;
 }
 
 SchedWakeupPerfEvent ConsumeSchedWakeupPerfEvent(PerfEventRingBuffer* ring_buffer,
-                                                 const perf_event_header& header) {
-  ORBIT_CHECK(header.size >= sizeof(perf_event_raw_sample_fixed));
-  perf_event_raw_sample_fixed ring_buffer_record;
-  ring_buffer->ReadRawAtOffset(&ring_buffer_record, 0, sizeof(perf_event_raw_sample_fixed));
+                                                 const PerfEventRecordView& record) {
+  ORBIT_CHECK(record.GetSize() >= sizeof(perf_event_raw_sample_fixed));
+  const auto ring_buffer_record = record.ReadValueAtOffset<perf_event_raw_sample_fixed>(0);
 
   // The last fields of the sched:sched_wakeup tracepoint aren't always the same, depending on the
   // kernel version. Fortunately we only need the first fields, which are always the same, so only
   // read those. See `sched_wakeup_tracepoint_fixed`.
   ORBIT_CHECK(ring_buffer_record.size >= sizeof(sched_wakeup_tracepoint_fixed));
-  sched_wakeup_tracepoint_fixed sched_wakeup;
-  ring_buffer->ReadRawAtOffset(
-      &sched_wakeup,
-      offsetof(perf_event_raw_sample_fixed, size) + sizeof(perf_event_raw_sample_fixed::size),
-      sizeof(sched_wakeup_tracepoint_fixed));
+  const auto sched_wakeup = record.ReadValueAtOffset<sched_wakeup_tracepoint_fixed>(
+      offsetof(perf_event_raw_sample_fixed, size) + sizeof(perf_event_raw_sample_fixed::size));
 
-  ring_buffer->SkipRecord(header);
+  ring_buffer->SkipRecord(record.GetHeader());
   return SchedWakeupPerfEvent{
       .timestamp = ring_buffer_record.sample_id.time,
       .ordered_stream = PerfEventOrderedStream::FileDescriptor(ring_buffer->GetFileDescriptor()),
@@ -370,16 +351,13 @@ SchedWakeupPerfEvent ConsumeSchedWakeupPerfEvent(PerfEventRingBuffer* ring_buffe
 }
 
 template <typename EventType, typename StructType>
-EventType ConsumeGpuEvent(PerfEventRingBuffer* ring_buffer, const perf_event_header& header) {
-  uint32_t tracepoint_size;
-  ring_buffer->ReadValueAtOffset(&tracepoint_size, offsetof(perf_event_raw_sample_fixed, size));
-
-  perf_event_raw_sample_fixed ring_buffer_record;
-  ring_buffer->ReadRawAtOffset(&ring_buffer_record, 0, sizeof(perf_event_raw_sample_fixed));
+EventType ConsumeGpuEvent(PerfEventRingBuffer* ring_buffer, const PerfEventRecordView& record) {
+  const auto ring_buffer_record = record.ReadValueAtOffset<perf_event_raw_sample_fixed>(0);
+  const uint32_t tracepoint_size = ring_buffer_record.size;
 
   std::unique_ptr<uint8_t[]> tracepoint_data =
       make_unique_for_overwrite<uint8_t[]>(tracepoint_size);
-  ring_buffer->ReadRawAtOffset(
+  record.ReadRawAtOffset(
       tracepoint_data.get(),
       offsetof(perf_event_raw_sample_fixed, size) + sizeof(perf_event_raw_sample_fixed::size),
       tracepoint_size);
@@ -408,25 +386,25 @@ EventType ConsumeGpuEvent(PerfEventRingBuffer* ring_buffer, const perf_event_hea
           },
   };
 
-  ring_buffer->SkipRecord(header);
+  ring_buffer->SkipRecord(record.GetHeader());
   return event;
 }
 
 AmdgpuCsIoctlPerfEvent ConsumeAmdgpuCsIoctlPerfEvent(PerfEventRingBuffer* ring_buffer,
-                                                     const perf_event_header& header) {
-  return ConsumeGpuEvent<AmdgpuCsIoctlPerfEvent, amdgpu_cs_ioctl_tracepoint>(ring_buffer, header);
+                                                     const PerfEventRecordView& record) {
+  return ConsumeGpuEvent<AmdgpuCsIoctlPerfEvent, amdgpu_cs_ioctl_tracepoint>(ring_buffer, record);
 }
 
 AmdgpuSchedRunJobPerfEvent ConsumeAmdgpuSchedRunJobPerfEvent(PerfEventRingBuffer* ring_buffer,
-                                                             const perf_event_header& header) {
+                                                             const PerfEventRecordView& record) {
   return ConsumeGpuEvent<AmdgpuSchedRunJobPerfEvent, amdgpu_sched_run_job_tracepoint>(ring_buffer,
-                                                                                      header);
+                                                                                      record);
 }
 
 DmaFenceSignaledPerfEvent ConsumeDmaFenceSignaledPerfEvent(PerfEventRingBuffer* ring_buffer,
-                                                           const perf_event_header& header) {
+                                                           const PerfEventRecordView& record) {
   return ConsumeGpuEvent<DmaFenceSignaledPerfEvent, dma_fence_signaled_tracepoint>(ring_buffer,
-                                                                                   header);
+                                                                                   record);
 }
 
 }  // namespace orbit_linux_tracing
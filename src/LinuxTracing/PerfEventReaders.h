@@ -10,6 +10,7 @@
 #include <sys/types.h>
 
 #include "PerfEvent.h"
+#include "PerfEventBufferPool.h"
 #include "PerfEventRecords.h"
 #include "PerfEventRingBuffer.h"
 
@@ -17,46 +18,51 @@ namespace orbit_linux_tracing {
 
 // Helper functions for reads from a perf_event_open ring buffer that require
 // more complex operations than simply copying an entire perf_event_open record.
+// They all parse the record through a PerfEventRecordView obtained with
+// PerfEventRingBuffer::ReadRecordAtTail, and the Consume* functions then skip the record.
 
 // This function reads sample_id, which is always the last field
 // in the perf event record unless it is PERF_RECORD_SAMPLE.
-void ReadPerfSampleIdAll(PerfEventRingBuffer* ring_buffer, const perf_event_header& header,
+void ReadPerfSampleIdAll(const PerfEventRecordView& record,
                          perf_event_sample_id_tid_time_streamid_cpu* sample_id);
 
-uint64_t ReadSampleRecordTime(PerfEventRingBuffer* ring_buffer);
+uint64_t ReadSampleRecordTime(const PerfEventRecordView& record);
 
-uint64_t ReadSampleRecordStreamId(PerfEventRingBuffer* ring_buffer);
+uint64_t ReadSampleRecordStreamId(const PerfEventRecordView& record);
 
-pid_t ReadSampleRecordPid(PerfEventRingBuffer* ring_buffer);
+pid_t ReadSampleRecordPid(const PerfEventRecordView& record);
 
-uint64_t ReadThrottleUnthrottleRecordTime(PerfEventRingBuffer* ring_buffer);
+uint64_t ReadThrottleUnthrottleRecordTime(const PerfEventRecordView& record);
 
 MmapPerfEvent ConsumeMmapPerfEvent(PerfEventRingBuffer* ring_buffer,
-                                   const perf_event_header& header);
+                                   const PerfEventRecordView& record);
 
 UprobesWithStackPerfEvent ConsumeUprobeWithStackPerfEvent(PerfEventRingBuffer* ring_buffer,
-                                                          const perf_event_header& header);
+                                                          const PerfEventRecordView& record);
 
+// The payloads of stack samples and callchain samples are allocated from `buffer_pool`.
 StackSamplePerfEvent ConsumeStackSamplePerfEvent(PerfEventRingBuffer* ring_buffer,
-                                                 const perf_event_header& header);
+                                                 const PerfEventRecordView& record,
+                                                 PerfEventBufferPool* buffer_pool);
 
 CallchainSamplePerfEvent ConsumeCallchainSamplePerfEvent(PerfEventRingBuffer* ring_buffer,
-                                                         const perf_event_header& header);
+                                                         const PerfEventRecordView& record,
+                                                         PerfEventBufferPool* buffer_pool);
 
 GenericTracepointPerfEvent ConsumeGenericTracepointPerfEvent(PerfEventRingBuffer* ring_buffer,
-                                                             const perf_event_header& header);
+                                                             const PerfEventRecordView& record);
 
 SchedWakeupPerfEvent ConsumeSchedWakeupPerfEvent(PerfEventRingBuffer* ring_buffer,
-                                                 const perf_event_header& header);
+                                                 const PerfEventRecordView& record);
 
 AmdgpuCsIoctlPerfEvent ConsumeAmdgpuCsIoctlPerfEvent(PerfEventRingBuffer* ring_buffer,
-                                                     const perf_event_header& header);
+                                                     const PerfEventRecordView& record);
 
 AmdgpuSchedRunJobPerfEvent ConsumeAmdgpuSchedRunJobPerfEvent(PerfEventRingBuffer* ring_buffer,
-                                                             const perf_event_header& header);
+                                                             const PerfEventRecordView& record);
 
 DmaFenceSignaledPerfEvent ConsumeDmaFenceSignaledPerfEvent(PerfEventRingBuffer* ring_buffer,
-                                                           const perf_event_header& header);
+                                                           const PerfEventRecordView& record);
 }  // namespace orbit_linux_tracing
 
 #endif  // LINUX_TRACING_PERF_EVENT_READERS_H_
@@ -0,0 +1,187 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <gtest/gtest.h>
+#include <linux/perf_event.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "LinuxTracingUtils.h"
+#include "OrbitBase/Logging.h"
+#include "PerfEventReaders.h"
+#include "PerfEventRecords.h"
+#include "PerfEventRingBuffer.h"
+
+namespace orbit_linux_tracing {
+
+namespace {
+
+constexpr pid_t kPid = 42;
+constexpr pid_t kTid = 43;
+constexpr uint64_t kTimestampNs = 123456789;
+constexpr uint64_t kStreamId = 1234;
+constexpr uint32_t kCpu = 3;
+
+perf_event_sp_ip_8bytes_sample MakeUprobeRecord() {
+  perf_event_sp_ip_8bytes_sample record{};
+  record.header.type = PERF_RECORD_SAMPLE;
+  record.header.size = sizeof(perf_event_sp_ip_8bytes_sample);
+  record.sample_id.pid = kPid;
+  record.sample_id.tid = kTid;
+  record.sample_id.time = kTimestampNs;
+  record.sample_id.stream_id = kStreamId;
+  record.sample_id.cpu = kCpu;
+  record.regs.sp = 0x1000;
+  record.regs.ip = 0x2000;
+  record.stack.top8bytes = 0x3000;
+  return record;
+}
+
+// Reads a uprobe record at the tail of `ring_buffer` the way TracerImpl does: timestamp, stream id
+// and pid through the view of the record, then the whole record. Returns a checksum of the fields.
+uint64_t ReadUprobeRecordThroughView(PerfEventRingBuffer* ring_buffer) {
+  perf_event_header header;
+  ring_buffer->ReadHeader(&header);
+  const PerfEventRecordView record = ring_buffer->ReadRecordAtTail(header);
+  uint64_t checksum = ReadSampleRecordTime(record);
+  checksum += ReadSampleRecordStreamId(record) + ReadSampleRecordPid(record);
+  perf_event_sp_ip_8bytes_sample consumed_record;
+  ring_buffer->ConsumeRecord(header, &consumed_record);
+  return checksum + consumed_record.regs.ip;
+}
+
+// Reads the same fields as ReadUprobeRecordThroughView the way TracerImpl did before
+// PerfEventRecordView: one copy out of the ring buffer for the header and for each field, each
+// reloading data_head, then a copy of the whole record.
+uint64_t ReadUprobeRecordByCopies(PerfEventRingBuffer* ring_buffer) {
+  perf_event_header header;
+  ring_buffer->ReadValueAtOffset(&header, 0);
+  uint64_t time = 0;
+  ring_buffer->ReadValueAtOffset(&time, offsetof(perf_event_sp_ip_8bytes_sample, sample_id.time));
+  uint64_t stream_id = 0;
+  ring_buffer->ReadValueAtOffset(&stream_id,
+                                 offsetof(perf_event_sp_ip_8bytes_sample, sample_id.stream_id));
+  pid_t pid = 0;
+  ring_buffer->ReadValueAtOffset(&pid, offsetof(perf_event_sp_ip_8bytes_sample, sample_id.pid));
+  perf_event_sp_ip_8bytes_sample consumed_record;
+  ring_buffer->ReadRawAtOffset(&consumed_record, 0, header.size);
+  ring_buffer->SkipRecord(header);
+  return time + stream_id + pid + consumed_record.regs.ip;
+}
+
+}  // namespace
+
+TEST(PerfEventReaders, ReadSampleRecordFieldsFromView) {
+  perf_event_sp_ip_8bytes_sample uprobe_record = MakeUprobeRecord();
+  PerfEventRecordView record{uprobe_record.header, reinterpret_cast<const char*>(&uprobe_record)};
+
+  EXPECT_EQ(record.GetSize(), sizeof(perf_event_sp_ip_8bytes_sample));
+  EXPECT_EQ(record.GetHeader().type, PERF_RECORD_SAMPLE);
+  EXPECT_EQ(ReadSampleRecordTime(record), kTimestampNs);
+  EXPECT_EQ(ReadSampleRecordStreamId(record), kStreamId);
+  EXPECT_EQ(ReadSampleRecordPid(record), kPid);
+}
+
+TEST(PerfEventReaders, ReadWholeRecordFromView) {
+  perf_event_sp_ip_8bytes_sample uprobe_record = MakeUprobeRecord();
+  PerfEventRecordView record{uprobe_record.header, reinterpret_cast<const char*>(&uprobe_record)};
+
+  const auto copy = record.ReadValueAtOffset<perf_event_sp_ip_8bytes_sample>(0);
+  EXPECT_EQ(std::memcmp(&copy, &uprobe_record, sizeof(perf_event_sp_ip_8bytes_sample)), 0);
+
+  uint64_t ip = 0;
+  record.ReadRawAtOffset(&ip, offsetof(perf_event_sp_ip_8bytes_sample, regs.ip), sizeof(ip));
+  EXPECT_EQ(ip, 0x2000);
+}
+
+TEST(PerfEventReaders, ReadPerfSampleIdAllFromView) {
+  perf_event_fork_exit fork_record{};
+  fork_record.header.type = PERF_RECORD_FORK;
+  fork_record.header.size = sizeof(perf_event_fork_exit);
+  fork_record.sample_id.pid = kPid;
+  fork_record.sample_id.tid = kTid;
+  fork_record.sample_id.time = kTimestampNs;
+  fork_record.sample_id.cpu = kCpu;
+  PerfEventRecordView record{fork_record.header, reinterpret_cast<const char*>(&fork_record)};
+
+  perf_event_sample_id_tid_time_streamid_cpu sample_id;
+  ReadPerfSampleIdAll(record, &sample_id);
+  EXPECT_EQ(sample_id.pid, kPid);
+  EXPECT_EQ(sample_id.tid, kTid);
+  EXPECT_EQ(sample_id.time, kTimestampNs);
+  EXPECT_EQ(sample_id.cpu, kCpu);
+}
+
+// Records per second read from a PerfEventRingBuffer the way TracerImpl reads uprobes, both with a
+// copy out of the ring buffer per field, as before PerfEventRecordView, and through the view of the
+// record. The ring buffer is backed by a memfd instead of perf_event_open, so this runs without
+// special permissions. Disabled by default, as it only logs the results.
+TEST(PerfEventReaders, DISABLED_BenchmarkReadUprobeRecordsFromRingBuffer) {
+  constexpr uint64_t kRingBufferSizeKb = 1024;
+  constexpr uint64_t kRingBufferSize = kRingBufferSizeKb * 1024;
+  constexpr uint64_t kRecordSize = sizeof(perf_event_sp_ip_8bytes_sample);
+  constexpr uint64_t kRecordsPerRound = kRingBufferSize / kRecordSize;
+  constexpr int kRoundCount = 200;
+
+  const int fd = memfd_create("PerfEventReadersBenchmark", 0);
+  ASSERT_NE(fd, -1);
+  const uint64_t mmap_length = GetPageSize() + kRingBufferSize;
+  ASSERT_EQ(ftruncate(fd, mmap_length), 0);
+  // This second mapping plays the role of the kernel: it writes the records and data_head.
+  void* producer_mapping = mmap(nullptr, mmap_length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ASSERT_NE(producer_mapping, MAP_FAILED);
+  auto* metadata_page = static_cast<perf_event_mmap_page*>(producer_mapping);
+  metadata_page->data_offset = GetPageSize();
+  metadata_page->data_size = kRingBufferSize;
+  char* producer_data = static_cast<char*>(producer_mapping) + GetPageSize();
+
+  const perf_event_sp_ip_8bytes_sample uprobe_record = MakeUprobeRecord();
+  using ReadUprobeRecordFunction = uint64_t (*)(PerfEventRingBuffer*);
+  const auto measure_records_per_second = [&](ReadUprobeRecordFunction read_uprobe_record) {
+    metadata_page->data_head = 0;
+    metadata_page->data_tail = 0;
+    PerfEventRingBuffer ring_buffer{fd, kRingBufferSizeKb, "benchmark", 0};
+    ORBIT_CHECK(ring_buffer.IsOpen());
+
+    uint64_t head = 0;
+    uint64_t checksum = 0;
+    std::chrono::duration<double> duration{0};
+    for (int round = 0; round < kRoundCount; ++round) {
+      // Records wrap around the end of the ring buffer as they would with the kernel.
+      for (uint64_t i = 0; i < kRecordsPerRound; ++i, head += kRecordSize) {
+        const uint64_t offset = head % kRingBufferSize;
+        const uint64_t size_before_end = std::min(kRecordSize, kRingBufferSize - offset);
+        std::memcpy(producer_data + offset, &uprobe_record, size_before_end);
+        std::memcpy(producer_data, reinterpret_cast<const char*>(&uprobe_record) + size_before_end,
+                    kRecordSize - size_before_end);
+      }
+      metadata_page->data_head = head;
+
+      const auto start = std::chrono::steady_clock::now();
+      while (ring_buffer.HasNewData()) {
+        checksum += read_uprobe_record(&ring_buffer);
+      }
+      duration += std::chrono::steady_clock::now() - start;
+    }
+
+    EXPECT_NE(checksum, 0);
+    return kRecordsPerRound * kRoundCount / duration.count();
+  };
+
+  const double copies_records_per_second = measure_records_per_second(&ReadUprobeRecordByCopies);
+  const double view_records_per_second = measure_records_per_second(&ReadUprobeRecordThroughView);
+  ORBIT_LOG("Copies: %.2f M records/s, view: %.2f M records/s (%.2fx)",
+            copies_records_per_second / 1e6, view_records_per_second / 1e6,
+            view_records_per_second / copies_records_per_second);
+
+  munmap(producer_mapping, mmap_length);
+  close(fd);
+}
+
+}  // namespace orbit_linux_tracing
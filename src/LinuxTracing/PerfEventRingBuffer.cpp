@@ -37,13 +37,15 @@ static inline void WriteRingBufferTail(perf_event_mmap_page* base, uint64_t tail
   smp_store_release(&base->data_tail, tail);
 }
 
-PerfEventRingBuffer::PerfEventRingBuffer(int perf_event_fd, uint64_t size_kb, std::string name) {
+PerfEventRingBuffer::PerfEventRingBuffer(int perf_event_fd, uint64_t size_kb, std::string name,
+                                         int32_t cpu) {
   if (perf_event_fd < 0) {
     return;
   }
 
   file_descriptor_ = perf_event_fd;
   name_ = std::move(name);
+  cpu_ = cpu;
 
   // The size of a perf_event_open ring buffer is required to be a power of two
   // memory pages (from perf_event_open's manpage: "The mmap size should be
@@ -77,6 +79,8 @@ PerfEventRingBuffer::PerfEventRingBuffer(PerfEventRingBuffer&& o) {
   std::swap(ring_buffer_size_log2_, o.ring_buffer_size_log2_);
   std::swap(file_descriptor_, o.file_descriptor_);
   std::swap(name_, o.name_);
+  std::swap(cpu_, o.cpu_);
+  std::swap(wrapped_record_buffer_, o.wrapped_record_buffer_);
 }
 
 PerfEventRingBuffer& PerfEventRingBuffer::operator=(PerfEventRingBuffer&& o) {
@@ -88,6 +92,8 @@ PerfEventRingBuffer& PerfEventRingBuffer::operator=(PerfEventRingBuffer&& o) {
     std::swap(ring_buffer_size_log2_, o.ring_buffer_size_log2_);
     std::swap(file_descriptor_, o.file_descriptor_);
     std::swap(name_, o.name_);
+    std::swap(cpu_, o.cpu_);
+    std::swap(wrapped_record_buffer_, o.wrapped_record_buffer_);
   }
   return *this;
 }
@@ -110,7 +116,14 @@ bool PerfEventRingBuffer::HasNewData() {
 }
 
 void PerfEventRingBuffer::ReadHeader(perf_event_header* header) {
-  ReadAtTail(header, sizeof(perf_event_header));
+  ORBIT_DCHECK(IsOpen());
+  const uint64_t tail_mod_size = metadata_page_->data_tail & (ring_buffer_size_ - 1);
+  if (tail_mod_size + sizeof(perf_event_header) <= ring_buffer_size_) {
+    // The head was already loaded by HasNewData, no need to reload it and validate it again.
+    memcpy(header, ring_buffer_ + tail_mod_size, sizeof(perf_event_header));
+  } else {
+    ReadAtTail(header, sizeof(perf_event_header));
+  }
   ORBIT_DCHECK(header->type != 0);
   ORBIT_DCHECK(metadata_page_->data_tail + header->size <= ReadRingBufferHead(metadata_page_));
 }
@@ -121,9 +134,20 @@ void PerfEventRingBuffer::SkipRecord(const perf_event_header& header) {
   WriteRingBufferTail(metadata_page_, new_tail);
 }
 
-void PerfEventRingBuffer::ConsumeRawRecord(const perf_event_header& header, void* record) {
-  ReadAtTail(static_cast<uint8_t*>(record), header.size);
-  SkipRecord(header);
+PerfEventRecordView PerfEventRingBuffer::ReadRecordAtTail(const perf_event_header& header) {
+  ORBIT_DCHECK(IsOpen());
+  ORBIT_DCHECK(metadata_page_->data_tail + header.size <= ReadRingBufferHead(metadata_page_));
+  const uint64_t tail_mod_size = metadata_page_->data_tail & (ring_buffer_size_ - 1);
+  if (tail_mod_size + header.size <= ring_buffer_size_) {
+    return PerfEventRecordView{header, ring_buffer_ + tail_mod_size};
+  }
+
+  // The record wraps around the end of the ring buffer: copy it so that it becomes contiguous.
+  if (wrapped_record_buffer_.size() < header.size) {
+    wrapped_record_buffer_.resize(header.size);
+  }
+  ReadAtTail(wrapped_record_buffer_.data(), header.size);
+  return PerfEventRecordView{header, wrapped_record_buffer_.data()};
 }
 
 void PerfEventRingBuffer::ReadAtOffsetFromTail(void* dest, uint64_t offset_from_tail,
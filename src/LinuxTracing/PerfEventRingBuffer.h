@@ -8,15 +8,48 @@
 #include <linux/perf_event.h>
 #include <stdint.h>
 
+#include <cstring>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include "OrbitBase/Logging.h"
 
 namespace orbit_linux_tracing {
 
+// A read-only view of an entire perf_event_open record, including its perf_event_header, laid out
+// contiguously in memory. Offsets are relative to the beginning of the record. Obtained from
+// PerfEventRingBuffer::ReadRecordAtTail and only valid until the record is skipped.
+class PerfEventRecordView {
+ public:
+  PerfEventRecordView(const perf_event_header& header, const char* data)
+      : header_{header}, data_{data} {}
+
+  [[nodiscard]] const perf_event_header& GetHeader() const { return header_; }
+  [[nodiscard]] uint16_t GetSize() const { return header_.size; }
+
+  template <typename T>
+  [[nodiscard]] T ReadValueAtOffset(uint64_t offset) const {
+    static_assert(std::is_trivially_copyable_v<T>);
+    T value;
+    ReadRawAtOffset(&value, offset, sizeof(T));
+    return value;
+  }
+
+  void ReadRawAtOffset(void* dest, uint64_t offset, uint64_t count) const {
+    ORBIT_DCHECK(offset + count <= header_.size);
+    std::memcpy(dest, data_ + offset, count);
+  }
+
+ private:
+  perf_event_header header_;
+  const char* data_;
+};
+
 class PerfEventRingBuffer {
  public:
-  explicit PerfEventRingBuffer(int perf_event_fd, uint64_t size_kb, std::string name);
+  explicit PerfEventRingBuffer(int perf_event_fd, uint64_t size_kb, std::string name,
+                               int32_t cpu);
   ~PerfEventRingBuffer();
 
   PerfEventRingBuffer(PerfEventRingBuffer&&);
@@ -28,17 +61,28 @@ class PerfEventRingBuffer {
   bool IsOpen() const { return ring_buffer_ != nullptr; }
   int GetFileDescriptor() const { return file_descriptor_; }
   const std::string& GetName() const { return name_; }
+  // The cpu whose events are recorded in this ring buffer.
+  int32_t GetCpu() const { return cpu_; }
 
   bool HasNewData();
   void ReadHeader(perf_event_header* header);
   void SkipRecord(const perf_event_header& header);
 
+  // Returns a view of the whole record at the tail of the ring buffer, whose header is `header`.
+  // The view points directly into the ring buffer unless the record wraps around its end, in which
+  // case the record is first copied into a scratch buffer owned by this object. Either way, the
+  // view is invalidated by SkipRecord and by the next call to ReadRecordAtTail.
+  [[nodiscard]] PerfEventRecordView ReadRecordAtTail(const perf_event_header& header);
+
   template <typename T>
   void ConsumeRecord(const perf_event_header& header, T* record) {
     ORBIT_CHECK(header.size == sizeof(T));
-    ConsumeRawRecord(header, record);
+    ReadRecordAtTail(header).ReadRawAtOffset(record, 0, sizeof(T));
+    SkipRecord(header);
   }
 
+  // Copy data at `offset` from the tail of the ring buffer. Each call reloads data_head and
+  // validates the read, so ReadRecordAtTail is cheaper for reading several fields of a record.
   template <typename T>
   void ReadValueAtOffset(T* value, uint64_t offset) {
     ReadAtOffsetFromTail(value, offset, sizeof(T));
@@ -58,9 +102,10 @@ class PerfEventRingBuffer {
   uint32_t ring_buffer_size_log2_ = 0;
   int file_descriptor_ = -1;
   std::string name_;
+  int32_t cpu_ = -1;
+  // Only used for the records that wrap around the end of the ring buffer.
+  std::vector<char> wrapped_record_buffer_;
 
-  // ConsumeRawRecord reads header.size bytes into record buffer and then skips the record.
-  void ConsumeRawRecord(const perf_event_header& header, void* record);
   void ReadAtTail(void* dest, uint64_t count) { return ReadAtOffsetFromTail(dest, 0, count); }
   void ReadAtOffsetFromTail(void* dest, uint64_t offset_from_tail, uint64_t count);
 };
@@ -0,0 +1,42 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ResequencingTracerListener.h"
+
+namespace orbit_linux_tracing {
+
+void ResequencingTracerListener::SendReadyEvents() {
+  while (!pending_events_.empty()) {
+    const PendingEvents& front = pending_events_.front();
+    if (front.is_ready != nullptr && !front.is_ready()) {
+      return;
+    }
+    PopAndSendFrontEvents();
+  }
+}
+
+void ResequencingTracerListener::WaitForAndSendAllEvents() {
+  while (!pending_events_.empty()) {
+    PopAndSendFrontEvents();
+  }
+}
+
+void ResequencingTracerListener::WaitForAndSendEventsUntilAtMostReservations(
+    size_t max_reservation_count) {
+  while (reservation_count_ > max_reservation_count) {
+    PopAndSendFrontEvents();
+  }
+}
+
+void ResequencingTracerListener::PopAndSendFrontEvents() {
+  PendingEvents events = std::move(pending_events_.front());
+  pending_events_.pop_front();
+  if (events.is_ready != nullptr) {
+    --reservation_count_;
+  }
+  // This blocks until the events are ready.
+  events.send(listener_);
+}
+
+}  // namespace orbit_linux_tracing
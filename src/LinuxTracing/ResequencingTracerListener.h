@@ -0,0 +1,146 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef LINUX_TRACING_RESEQUENCING_TRACER_LISTENER_H_
+#define LINUX_TRACING_RESEQUENCING_TRACER_LISTENER_H_
+
+#include <deque>
+#include <functional>
+#include <utility>
+
+#include "GrpcProtos/capture.pb.h"
+#include "LinuxTracing/TracerListener.h"
+#include "OrbitBase/Future.h"
+#include "OrbitBase/Logging.h"
+
+namespace orbit_linux_tracing {
+
+// This TracerListener forwards the events it receives to another TracerListener, but also allows to
+// reserve the place of events that are still being computed, e.g., on a thread pool. Events
+// received after such a reservation are held back until the reserved events have been sent, so
+// that the wrapped listener receives the events in the same order as if all events had been
+// computed synchronously.
+// This class is not thread-safe: all methods need to be called from the same thread, which is also
+// the thread from which the wrapped listener is called.
+class ResequencingTracerListener : public TracerListener {
+ public:
+  explicit ResequencingTracerListener(TracerListener* listener) : listener_{listener} {
+    ORBIT_CHECK(listener_ != nullptr);
+  }
+
+  // Reserves the place of the events that `send_events` will send to the wrapped listener, which
+  // is passed to it, once `future` has completed. `send_events` receives the result of `future`.
+  template <typename T>
+  void SendWhenReady(orbit_base::Future<T> future,
+                     std::function<void(const T&, TracerListener*)> send_events) {
+    ++reservation_count_;
+    pending_events_.push_back(PendingEvents{
+        .is_ready = [future] { return future.IsFinished(); },
+        .send =
+            [future, send_events = std::move(send_events)](TracerListener* listener) {
+              send_events(future.Get(), listener);
+            },
+    });
+  }
+
+  // Sends the held back events up to the first reservation whose events are not ready yet.
+  void SendReadyEvents();
+  // Blocks until all reserved events are ready, and sends all held back events.
+  void WaitForAndSendAllEvents();
+  // Sends the held back events in order, blocking on the reservations that are not ready yet, until
+  // at most `max_reservation_count` reservations remain. This bounds the memory used by the events
+  // that are held back and by the computations that are still pending.
+  void WaitForAndSendEventsUntilAtMostReservations(size_t max_reservation_count);
+
+  [[nodiscard]] size_t GetPendingEventCount() const { return pending_events_.size(); }
+  [[nodiscard]] size_t GetReservationCount() const { return reservation_count_; }
+
+  void OnSchedulingSlice(orbit_grpc_protos::SchedulingSlice scheduling_slice) override {
+    SendOrHoldBack(&TracerListener::OnSchedulingSlice, std::move(scheduling_slice));
+  }
+  void OnCallstackSample(orbit_grpc_protos::FullCallstackSample callstack_sample) override {
+    SendOrHoldBack(&TracerListener::OnCallstackSample, std::move(callstack_sample));
+  }
+  void OnFunctionCall(orbit_grpc_protos::FunctionCall function_call) override {
+    SendOrHoldBack(&TracerListener::OnFunctionCall, std::move(function_call));
+  }
+  void OnGpuJob(orbit_grpc_protos::FullGpuJob gpu_job) override {
+    SendOrHoldBack(&TracerListener::OnGpuJob, std::move(gpu_job));
+  }
+  void OnThreadName(orbit_grpc_protos::ThreadName thread_name) override {
+    SendOrHoldBack(&TracerListener::OnThreadName, std::move(thread_name));
+  }
+  void OnThreadNamesSnapshot(
+      orbit_grpc_protos::ThreadNamesSnapshot thread_names_snapshot) override {
+    SendOrHoldBack(&TracerListener::OnThreadNamesSnapshot, std::move(thread_names_snapshot));
+  }
+  void OnThreadStateSlice(orbit_grpc_protos::ThreadStateSlice thread_state_slice) override {
+    SendOrHoldBack(&TracerListener::OnThreadStateSlice, std::move(thread_state_slice));
+  }
+  void OnAddressInfo(orbit_grpc_protos::FullAddressInfo full_address_info) override {
+    SendOrHoldBack(&TracerListener::OnAddressInfo, std::move(full_address_info));
+  }
+  void OnTracepointEvent(orbit_grpc_protos::FullTracepointEvent tracepoint_event) override {
+    SendOrHoldBack(&TracerListener::OnTracepointEvent, std::move(tracepoint_event));
+  }
+  void OnModulesSnapshot(orbit_grpc_protos::ModulesSnapshot modules_snapshot) override {
+    SendOrHoldBack(&TracerListener::OnModulesSnapshot, std::move(modules_snapshot));
+  }
+  void OnModuleUpdate(orbit_grpc_protos::ModuleUpdateEvent module_update_event) override {
+    SendOrHoldBack(&TracerListener::OnModuleUpdate, std::move(module_update_event));
+  }
+  void OnErrorsWithPerfEventOpenEvent(
+      orbit_grpc_protos::ErrorsWithPerfEventOpenEvent errors_with_perf_event_open_event) override {
+    SendOrHoldBack(&TracerListener::OnErrorsWithPerfEventOpenEvent,
+                   std::move(errors_with_perf_event_open_event));
+  }
+  void OnLostPerfRecordsEvent(
+      orbit_grpc_protos::LostPerfRecordsEvent lost_perf_records_event) override {
+    SendOrHoldBack(&TracerListener::OnLostPerfRecordsEvent, std::move(lost_perf_records_event));
+  }
+  void OnOutOfOrderEventsDiscardedEvent(orbit_grpc_protos::OutOfOrderEventsDiscardedEvent
+                                            out_of_order_events_discarded_event) override {
+    SendOrHoldBack(&TracerListener::OnOutOfOrderEventsDiscardedEvent,
+                   std::move(out_of_order_events_discarded_event));
+  }
+  void OnWarningInstrumentingWithUprobesEvent(
+      orbit_grpc_protos::WarningInstrumentingWithUprobesEvent
+          warning_instrumenting_with_uprobes_event) override {
+    SendOrHoldBack(&TracerListener::OnWarningInstrumentingWithUprobesEvent,
+                   std::move(warning_instrumenting_with_uprobes_event));
+  }
+
+ private:
+  struct PendingEvents {
+    // Empty for events that have been held back, as they are always ready.
+    std::function<bool()> is_ready;
+    std::function<void(TracerListener*)> send;
+  };
+
+  template <typename Event>
+  void SendOrHoldBack(void (TracerListener::*on_event)(Event), Event event) {
+    if (pending_events_.empty()) {
+      (listener_->*on_event)(std::move(event));
+      return;
+    }
+    pending_events_.push_back(PendingEvents{
+        .is_ready = nullptr,
+        .send =
+            [on_event, event = std::move(event)](TracerListener* listener) mutable {
+              (listener->*on_event)(std::move(event));
+            },
+    });
+  }
+
+  void PopAndSendFrontEvents();
+
+  TracerListener* listener_;
+  std::deque<PendingEvents> pending_events_;
+  // The number of elements of pending_events_ that are reservations, i.e., with is_ready set.
+  size_t reservation_count_ = 0;
+};
+
+}  // namespace orbit_linux_tracing
+
+#endif  // LINUX_TRACING_RESEQUENCING_TRACER_LISTENER_H_
@@ -0,0 +1,150 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <stdint.h>
+
+#include <utility>
+
+#include "GrpcProtos/capture.pb.h"
+#include "MockTracerListener.h"
+#include "OrbitBase/Future.h"
+#include "OrbitBase/Promise.h"
+#include "ResequencingTracerListener.h"
+
+using ::testing::InSequence;
+using ::testing::Property;
+
+namespace orbit_linux_tracing {
+
+namespace {
+
+[[nodiscard]] orbit_grpc_protos::FunctionCall MakeFunctionCall(uint64_t end_timestamp_ns) {
+  orbit_grpc_protos::FunctionCall function_call;
+  function_call.set_end_timestamp_ns(end_timestamp_ns);
+  return function_call;
+}
+
+[[nodiscard]] orbit_grpc_protos::FullCallstackSample MakeCallstackSample(uint64_t timestamp_ns) {
+  orbit_grpc_protos::FullCallstackSample callstack_sample;
+  callstack_sample.set_timestamp_ns(timestamp_ns);
+  return callstack_sample;
+}
+
+void SendCallstackSampleWhenReady(ResequencingTracerListener* resequencing_listener,
+                                  orbit_base::Future<uint64_t> timestamp_ns) {
+  resequencing_listener->SendWhenReady<uint64_t>(
+      std::move(timestamp_ns), [](const uint64_t& timestamp_ns, TracerListener* listener) {
+        listener->OnCallstackSample(MakeCallstackSample(timestamp_ns));
+      });
+}
+
+class ResequencingTracerListenerTest : public ::testing::Test {
+ protected:
+  MockTracerListener mock_listener_;
+  ResequencingTracerListener resequencing_listener_{&mock_listener_};
+};
+
+}  // namespace
+
+TEST_F(ResequencingTracerListenerTest, EventsAreForwardedWhenNothingIsPending) {
+  EXPECT_CALL(mock_listener_, OnFunctionCall(Property(
+                                  &orbit_grpc_protos::FunctionCall::end_timestamp_ns, 1)))
+      .Times(1);
+  resequencing_listener_.OnFunctionCall(MakeFunctionCall(1));
+  EXPECT_EQ(resequencing_listener_.GetPendingEventCount(), 0);
+}
+
+TEST_F(ResequencingTracerListenerTest, EventsAreHeldBackUntilPendingEventsAreReady) {
+  orbit_base::Promise<uint64_t> promise1;
+  orbit_base::Promise<uint64_t> promise2;
+  SendCallstackSampleWhenReady(&resequencing_listener_, promise1.GetFuture());
+  resequencing_listener_.OnFunctionCall(MakeFunctionCall(2));
+  SendCallstackSampleWhenReady(&resequencing_listener_, promise2.GetFuture());
+  resequencing_listener_.OnFunctionCall(MakeFunctionCall(4));
+  EXPECT_EQ(resequencing_listener_.GetPendingEventCount(), 4);
+
+  {
+    InSequence sequence;
+    EXPECT_CALL(mock_listener_,
+                OnCallstackSample(
+                    Property(&orbit_grpc_protos::FullCallstackSample::timestamp_ns, 1)))
+        .Times(1);
+    EXPECT_CALL(mock_listener_, OnFunctionCall(Property(
+                                    &orbit_grpc_protos::FunctionCall::end_timestamp_ns, 2)))
+        .Times(1);
+    EXPECT_CALL(mock_listener_,
+                OnCallstackSample(
+                    Property(&orbit_grpc_protos::FullCallstackSample::timestamp_ns, 3)))
+        .Times(1);
+    EXPECT_CALL(mock_listener_, OnFunctionCall(Property(
+                                    &orbit_grpc_protos::FunctionCall::end_timestamp_ns, 4)))
+        .Times(1);
+  }
+
+  // The second reservation being ready doesn't allow anything to be sent.
+  promise2.SetResult(3);
+  resequencing_listener_.SendReadyEvents();
+  EXPECT_EQ(resequencing_listener_.GetPendingEventCount(), 4);
+
+  promise1.SetResult(1);
+  resequencing_listener_.SendReadyEvents();
+  EXPECT_EQ(resequencing_listener_.GetPendingEventCount(), 0);
+}
+
+TEST_F(ResequencingTracerListenerTest, SendReadyEventsStopsAtFirstPendingEvent) {
+  orbit_base::Promise<uint64_t> promise1;
+  orbit_base::Promise<uint64_t> promise2;
+  SendCallstackSampleWhenReady(&resequencing_listener_, promise1.GetFuture());
+  resequencing_listener_.OnFunctionCall(MakeFunctionCall(2));
+  SendCallstackSampleWhenReady(&resequencing_listener_, promise2.GetFuture());
+
+  EXPECT_CALL(mock_listener_, OnCallstackSample).Times(1);
+  EXPECT_CALL(mock_listener_, OnFunctionCall).Times(1);
+  promise1.SetResult(1);
+  resequencing_listener_.SendReadyEvents();
+  EXPECT_EQ(resequencing_listener_.GetPendingEventCount(), 1);
+
+  EXPECT_CALL(mock_listener_, OnCallstackSample).Times(1);
+  promise2.SetResult(3);
+  resequencing_listener_.WaitForAndSendAllEvents();
+  EXPECT_EQ(resequencing_listener_.GetPendingEventCount(), 0);
+}
+
+TEST_F(ResequencingTracerListenerTest, WaitForAndSendEventsUntilAtMostReservationsKeepsTheNewest) {
+  orbit_base::Promise<uint64_t> promise1;
+  orbit_base::Promise<uint64_t> promise2;
+  orbit_base::Promise<uint64_t> promise3;
+  SendCallstackSampleWhenReady(&resequencing_listener_, promise1.GetFuture());
+  resequencing_listener_.OnFunctionCall(MakeFunctionCall(2));
+  SendCallstackSampleWhenReady(&resequencing_listener_, promise2.GetFuture());
+  SendCallstackSampleWhenReady(&resequencing_listener_, promise3.GetFuture());
+  EXPECT_EQ(resequencing_listener_.GetReservationCount(), 3);
+
+  promise1.SetResult(1);
+  promise2.SetResult(3);
+  {
+    InSequence sequence;
+    EXPECT_CALL(mock_listener_,
+                OnCallstackSample(
+                    Property(&orbit_grpc_protos::FullCallstackSample::timestamp_ns, 1)))
+        .Times(1);
+    EXPECT_CALL(mock_listener_, OnFunctionCall).Times(1);
+    EXPECT_CALL(mock_listener_,
+                OnCallstackSample(
+                    Property(&orbit_grpc_protos::FullCallstackSample::timestamp_ns, 3)))
+        .Times(1);
+  }
+  resequencing_listener_.WaitForAndSendEventsUntilAtMostReservations(1);
+  EXPECT_EQ(resequencing_listener_.GetReservationCount(), 1);
+  EXPECT_EQ(resequencing_listener_.GetPendingEventCount(), 1);
+
+  EXPECT_CALL(mock_listener_, OnCallstackSample).Times(1);
+  promise3.SetResult(4);
+  resequencing_listener_.WaitForAndSendAllEvents();
+  EXPECT_EQ(resequencing_listener_.GetReservationCount(), 0);
+}
+
+}  // namespace orbit_linux_tracing
@@ -10,11 +10,17 @@
 #include <absl/strings/str_format.h>
 #include <absl/strings/str_join.h>
 #include <absl/synchronization/mutex.h>
+#include <absl/time/time.h>
 #include <stddef.h>
+#include <pthread.h>
+#include <sched.h>
 #include <string.h>
+#include <sys/epoll.h>
 #include <unistd.h>
 
 #include <algorithm>
+#include <cerrno>
+#include <iterator>
 #include <string>
 #include <string_view>
 #include <thread>
@@ -35,6 +41,7 @@
 #include "ModuleUtils/ReadLinuxModules.h"
 #include "OrbitBase/GetProcessIds.h"
 #include "OrbitBase/Logging.h"
+#include "OrbitBase/SafeStrerror.h"
 #include "OrbitBase/ThreadUtils.h"
 #include "PerfEventOpen.h"
 #include "PerfEventReaders.h"
@@ -71,6 +78,10 @@ TracerImpl::TracerImpl(
       unwinding_method_{capture_options.unwinding_method()},
       trace_thread_state_{capture_options.trace_thread_state()},
       trace_gpu_driver_{capture_options.trace_gpu_driver()},
+      ring_buffer_wait_method_{capture_options.ring_buffer_wait_method()},
+      ring_buffer_reader_thread_count_{capture_options.ring_buffer_reader_thread_count()},
+      stack_unwinding_thread_count_{capture_options.stack_unwinding_thread_count()},
+      adaptive_processing_delay_{capture_options.adaptive_processing_delay()},
       user_space_instrumentation_addresses_{std::move(user_space_instrumentation_addresses)},
       listener_{listener} {
   ORBIT_CHECK(listener_ != nullptr);
@@ -193,7 +204,7 @@ static void OpenRingBuffersOrRedirectOnExisting(
       // Create a ring buffer for this cpu.
       int ring_buffer_fd = fd;
       std::string buffer_name = absl::StrFormat("%s_%d", buffer_name_prefix, cpu);
-      ring_buffers->emplace_back(ring_buffer_fd, ring_buffer_size_kb, buffer_name);
+      ring_buffers->emplace_back(ring_buffer_fd, ring_buffer_size_kb, buffer_name, cpu);
       ring_buffer_fds_per_cpu->emplace(cpu, ring_buffer_fd);
     }
   }
@@ -211,13 +222,23 @@ void TracerImpl::InitUprobesEventVisitor() {
       LibunwindstackUnwinder::Create(&absolute_address_to_size_of_functions_to_stop_unwinding_at_);
   return_address_manager_.emplace(user_space_instrumentation_addresses_.get());
   leaf_function_call_manager_ = std::make_unique<LeafFunctionCallManager>(stack_dump_size_);
+  if (stack_unwinding_thread_count_ > 0) {
+    unwinding_thread_pool_ =
+        orbit_base::ThreadPool::Create(stack_unwinding_thread_count_, stack_unwinding_thread_count_,
+                                       absl::Seconds(1));
+    resequencing_listener_ = std::make_unique<ResequencingTracerListener>(listener_);
+  }
   uprobes_unwinding_visitor_ = std::make_unique<UprobesUnwindingVisitor>(
-      listener_, &function_call_manager_, &return_address_manager_.value(), maps_.get(),
+      GetVisitorListener(), &function_call_manager_, &return_address_manager_.value(), maps_.get(),
       unwinder_.get(), leaf_function_call_manager_.get(),
       user_space_instrumentation_addresses_.get(),
       &absolute_address_to_size_of_functions_to_stop_unwinding_at_);
   uprobes_unwinding_visitor_->SetUnwindErrorsAndDiscardedSamplesCounters(
       &stats_.unwind_error_count, &stats_.samples_in_uretprobes_count);
+  if (unwinding_thread_pool_ != nullptr) {
+    uprobes_unwinding_visitor_->SetUnwindingThreadPool(unwinding_thread_pool_.get(),
+                                                       resequencing_listener_.get());
+  }
   event_processor_.AddVisitor(uprobes_unwinding_visitor_.get());
 }
 
@@ -230,9 +251,11 @@ bool TracerImpl::OpenUprobes(const orbit_grpc_protos::InstrumentedFunction& func
   for (int32_t cpu : cpus) {
     int fd;
     if (function.record_arguments()) {
-      fd = uprobes_retaddr_args_event_open(module, offset, /*pid=*/-1, cpu);
+      fd = uprobes_retaddr_args_event_open(module, offset, /*pid=*/-1, cpu,
+                                           ComputeWakeupWatermark(UPROBES_RING_BUFFER_SIZE_KB));
     } else {
-      fd = uprobes_retaddr_event_open(module, offset, /*pid=*/-1, cpu);
+      fd = uprobes_retaddr_event_open(module, offset, /*pid=*/-1, cpu,
+                                      ComputeWakeupWatermark(UPROBES_RING_BUFFER_SIZE_KB));
     }
     if (fd < 0) {
       ORBIT_ERROR("Opening uprobe %s+%#x on cpu %d", function.file_path(), function.file_offset(),
@@ -253,9 +276,11 @@ bool TracerImpl::OpenUretprobes(const orbit_grpc_protos::InstrumentedFunction& f
   for (int32_t cpu : cpus) {
     int fd;
     if (function.record_return_value()) {
-      fd = uretprobes_retval_event_open(module, offset, /*pid=*/-1, cpu);
+      fd = uretprobes_retval_event_open(module, offset, /*pid=*/-1, cpu,
+                                        ComputeWakeupWatermark(UPROBES_RING_BUFFER_SIZE_KB));
     } else {
-      fd = uretprobes_event_open(module, offset, /*pid=*/-1, cpu);
+      fd = uretprobes_event_open(module, offset, /*pid=*/-1, cpu,
+                                 ComputeWakeupWatermark(UPROBES_RING_BUFFER_SIZE_KB));
     }
     if (fd < 0) {
       ORBIT_ERROR("Opening uretprobe %s+%#x on cpu %d", function.file_path(),
@@ -340,8 +365,9 @@ bool TracerImpl::OpenUprobesWithStack(
   const char* module = function.file_path().c_str();
   const uint64_t offset = function.file_offset();
   for (int32_t cpu : cpus) {
-    int fd =
-        uprobes_with_stack_and_sp_event_open(module, offset, /*pid=*/-1, cpu, stack_dump_size_);
+    int fd = uprobes_with_stack_and_sp_event_open(
+        module, offset, /*pid=*/-1, cpu, stack_dump_size_,
+        ComputeWakeupWatermark(UPROBES_WITH_STACK_RING_BUFFER_SIZE_KB));
     if (fd < 0) {
       ORBIT_ERROR("Opening uprobe %s+%#x with stack on cpu %d", function.file_path(),
                   function.file_offset(), cpu);
@@ -384,10 +410,11 @@ bool TracerImpl::OpenMmapTask(const std::vector<int32_t>& cpus) {
   std::vector<int> mmap_task_tracing_fds;
   std::vector<PerfEventRingBuffer> mmap_task_ring_buffers;
   for (int32_t cpu : cpus) {
-    int mmap_task_fd = mmap_task_event_open(-1, cpu);
+    int mmap_task_fd =
+        mmap_task_event_open(-1, cpu, ComputeWakeupWatermark(MMAP_TASK_RING_BUFFER_SIZE_KB));
     std::string buffer_name = absl::StrFormat("mmap_task_%d", cpu);
     PerfEventRingBuffer mmap_task_ring_buffer{mmap_task_fd, MMAP_TASK_RING_BUFFER_SIZE_KB,
-                                              buffer_name};
+                                              buffer_name, cpu};
     if (mmap_task_ring_buffer.IsOpen()) {
       mmap_task_tracing_fds.push_back(mmap_task_fd);
       mmap_task_ring_buffers.push_back(std::move(mmap_task_ring_buffer));
@@ -420,11 +447,13 @@ bool TracerImpl::OpenSampling(const std::vector<int32_t>& cpus) {
     switch (unwinding_method_) {
       case CaptureOptions::kFramePointers:
         sampling_fd =
-            callchain_sample_event_open(sampling_period_ns_.value(), -1, cpu, stack_dump_size_);
+            callchain_sample_event_open(sampling_period_ns_.value(), -1, cpu, stack_dump_size_,
+                                        ComputeWakeupWatermark(SAMPLING_RING_BUFFER_SIZE_KB));
         break;
       case CaptureOptions::kDwarf:
         sampling_fd =
-            stack_sample_event_open(sampling_period_ns_.value(), -1, cpu, stack_dump_size_);
+            stack_sample_event_open(sampling_period_ns_.value(), -1, cpu, stack_dump_size_,
+                                    ComputeWakeupWatermark(SAMPLING_RING_BUFFER_SIZE_KB));
         break;
       case CaptureOptions::kUndefined:
       default:
@@ -435,7 +464,7 @@ bool TracerImpl::OpenSampling(const std::vector<int32_t>& cpus) {
 
     std::string buffer_name = absl::StrFormat("sampling_%d", cpu);
     PerfEventRingBuffer sampling_ring_buffer{sampling_fd, SAMPLING_RING_BUFFER_SIZE_KB,
-                                             buffer_name};
+                                             buffer_name, cpu};
     if (sampling_ring_buffer.IsOpen()) {
       sampling_tracing_fds.push_back(sampling_fd);
       sampling_ring_buffers.push_back(std::move(sampling_ring_buffer));
@@ -479,7 +508,7 @@ struct TracepointToOpen {
 
 static bool OpenFileDescriptorsAndRingBuffersForAllTracepoints(
     const std::vector<TracepointToOpen>& tracepoints_to_open, const std::vector<int32_t>& cpus,
-    std::vector<int>* tracing_fds, uint64_t ring_buffer_size_kb,
+    std::vector<int>* tracing_fds, uint64_t ring_buffer_size_kb, uint32_t wakeup_watermark,
     absl::flat_hash_map<int32_t, int>* tracepoint_ring_buffer_fds_per_cpu_for_redirection,
     std::vector<PerfEventRingBuffer>* ring_buffers) {
   ORBIT_SCOPE_FUNCTION;
@@ -491,7 +520,8 @@ static bool OpenFileDescriptorsAndRingBuffersForAllTracepoints(
     const char* tracepoint_category = tracepoints_to_open[tracepoint_index].tracepoint_category;
     const char* tracepoint_name = tracepoints_to_open[tracepoint_index].tracepoint_name;
     for (int32_t cpu : cpus) {
-      int tracepoint_fd = tracepoint_event_open(tracepoint_category, tracepoint_name, -1, cpu);
+      int tracepoint_fd =
+          tracepoint_event_open(tracepoint_category, tracepoint_name, -1, cpu, wakeup_watermark);
       if (tracepoint_fd == -1) {
         ORBIT_ERROR("Opening %s:%s tracepoint for cpu %d", tracepoint_category, tracepoint_name,
                     cpu);
@@ -545,12 +575,14 @@ bool TracerImpl::OpenThreadNameTracepoints(const std::vector<int32_t>& cpus) {
   return OpenFileDescriptorsAndRingBuffersForAllTracepoints(
       {{"task", "task_newtask", &task_newtask_ids_}, {"task", "task_rename", &task_rename_ids_}},
       cpus, &tracing_fds_, THREAD_NAMES_RING_BUFFER_SIZE_KB,
+      ComputeWakeupWatermark(THREAD_NAMES_RING_BUFFER_SIZE_KB),
       &thread_name_tracepoint_ring_buffer_fds_per_cpu, &ring_buffers_);
 }
 
 void TracerImpl::InitSwitchesStatesNamesVisitor() {
   ORBIT_SCOPE_FUNCTION;
-  switches_states_names_visitor_ = std::make_unique<SwitchesStatesNamesVisitor>(listener_);
+  switches_states_names_visitor_ =
+      std::make_unique<SwitchesStatesNamesVisitor>(GetVisitorListener());
   switches_states_names_visitor_->SetProduceSchedulingSlices(trace_context_switches_);
   if (trace_thread_state_) {
     // Filter thread states using target process id. We also send OrbitService's thread states when
@@ -583,12 +615,13 @@ bool TracerImpl::OpenContextSwitchAndThreadStateTracepoints(const std::vector<in
   return OpenFileDescriptorsAndRingBuffersForAllTracepoints(
       tracepoints_to_open, cpus, &tracing_fds_,
       CONTEXT_SWITCHES_AND_THREAD_STATE_RING_BUFFER_SIZE_KB,
+      ComputeWakeupWatermark(CONTEXT_SWITCHES_AND_THREAD_STATE_RING_BUFFER_SIZE_KB),
       &thread_state_tracepoint_ring_buffer_fds_per_cpu, &ring_buffers_);
 }
 
 void TracerImpl::InitGpuTracepointEventVisitor() {
   ORBIT_SCOPE_FUNCTION;
-  gpu_event_visitor_ = std::make_unique<GpuTracepointVisitor>(listener_);
+  gpu_event_visitor_ = std::make_unique<GpuTracepointVisitor>(GetVisitorListener());
   event_processor_.AddVisitor(gpu_event_visitor_.get());
 }
 
@@ -611,8 +644,9 @@ bool TracerImpl::OpenGpuTracepoints(const std::vector<int32_t>& cpus) {
       {{"amdgpu", "amdgpu_cs_ioctl", &amdgpu_cs_ioctl_ids_},
        {"amdgpu", "amdgpu_sched_run_job", &amdgpu_sched_run_job_ids_},
        {"dma_fence", "dma_fence_signaled", &dma_fence_signaled_ids_}},
-      cpus, &tracing_fds_, GPU_TRACING_RING_BUFFER_SIZE_KB, &gpu_tracepoint_ring_buffer_fds_per_cpu,
-      &ring_buffers_);
+      cpus, &tracing_fds_, GPU_TRACING_RING_BUFFER_SIZE_KB,
+      ComputeWakeupWatermark(GPU_TRACING_RING_BUFFER_SIZE_KB),
+      &gpu_tracepoint_ring_buffer_fds_per_cpu, &ring_buffers_);
 }
 
 bool TracerImpl::OpenInstrumentedTracepoints(const std::vector<int32_t>& cpus) {
@@ -625,6 +659,7 @@ bool TracerImpl::OpenInstrumentedTracepoints(const std::vector<int32_t>& cpus) {
     tracepoint_event_open_errors |= !OpenFileDescriptorsAndRingBuffersForAllTracepoints(
         {{selected_tracepoint.category().c_str(), selected_tracepoint.name().c_str(), &stream_ids}},
         cpus, &tracing_fds_, INSTRUMENTED_TRACEPOINTS_RING_BUFFER_SIZE_KB,
+        ComputeWakeupWatermark(INSTRUMENTED_TRACEPOINTS_RING_BUFFER_SIZE_KB),
         &tracepoint_ring_buffer_fds_per_cpu, &ring_buffers_);
 
     for (const auto& stream_id : stream_ids) {
@@ -637,7 +672,8 @@ bool TracerImpl::OpenInstrumentedTracepoints(const std::vector<int32_t>& cpus) {
 
 void TracerImpl::InitLostAndDiscardedEventVisitor() {
   ORBIT_SCOPE_FUNCTION;
-  lost_and_discarded_event_visitor_ = std::make_unique<LostAndDiscardedEventVisitor>(listener_);
+  lost_and_discarded_event_visitor_ =
+      std::make_unique<LostAndDiscardedEventVisitor>(GetVisitorListener());
   event_processor_.AddVisitor(lost_and_discarded_event_visitor_.get());
 }
 
@@ -704,6 +740,9 @@ void TracerImpl::Startup() {
   SetMaxOpenFilesSoftLimit(GetMaxOpenFilesHardLimit());
 
   event_processor_.SetDiscardedOutOfOrderCounter(&stats_.discarded_out_of_order_count);
+  if (adaptive_processing_delay_) {
+    event_processor_.EnableAdaptiveProcessingDelay();
+  }
 
   InitLostAndDiscardedEventVisitor();
 
@@ -918,25 +957,57 @@ void TracerImpl::ProcessOneRecord(PerfEventRingBuffer* ring_buffer) {
   }
 
   if (event_timestamp_ns != 0) {
-    fds_to_last_timestamp_ns_.insert_or_assign(ring_buffer->GetFileDescriptor(),
-                                               event_timestamp_ns);
+    // The map already contains an entry for every ring buffer (see Run), so that this doesn't
+    // modify the map itself when ring buffers are read concurrently by multiple threads.
+    auto fd_and_last_timestamp_ns_it =
+        fds_to_last_timestamp_ns_.find(ring_buffer->GetFileDescriptor());
+    ORBIT_CHECK(fd_and_last_timestamp_ns_it != fds_to_last_timestamp_ns_.end());
+    fd_and_last_timestamp_ns_it->second = event_timestamp_ns;
   }
 }
 
-void TracerImpl::Run() {
-  orbit_base::SetCurrentThreadName("Tracer::Run");
+uint32_t TracerImpl::ComputeWakeupWatermark(uint64_t ring_buffer_size_kb) const {
+  if (ring_buffer_wait_method_ != CaptureOptions::kEpollWithWakeupWatermark) {
+    // Keep the kernel default, as we don't wait on the file descriptors.
+    return 0;
+  }
+  return static_cast<uint32_t>(1024 * ring_buffer_size_kb / RING_BUFFER_WAKEUP_WATERMARK_DIVISOR);
+}
 
-  Startup();
+int32_t TracerImpl::ProcessRecordBatch(PerfEventRingBuffer* ring_buffer) {
+  // Read up to ROUND_ROBIN_POLLING_BATCH_SIZE (5) new events.
+  // TODO: Some event types (e.g., stack samples) have a much longer
+  //  processing time but are less frequent than others (e.g., context
+  //  switches). Take this into account in our scheduling algorithm.
+  int32_t read_from_this_buffer = 0;
+  while (read_from_this_buffer < ROUND_ROBIN_POLLING_BATCH_SIZE) {
+    if (stop_run_thread_) {
+      break;
+    }
+    ++stats_.ring_buffer_head_read_count;
+    if (!ring_buffer->HasNewData()) {
+      break;
+    }
 
+    ProcessOneRecord(ring_buffer);
+    ++read_from_this_buffer;
+  }
+  return read_from_this_buffer;
+}
+
+void TracerImpl::ReadRingBuffersWithSleepAndPoll(
+    const std::vector<PerfEventRingBuffer*>& ring_buffers, bool print_stats_when_idle) {
   bool last_iteration_saw_events = false;
-  std::thread deferred_events_thread(&TracerImpl::ProcessDeferredEvents, this);
 
   while (!stop_run_thread_) {
     ORBIT_SCOPE("TracerThread::Run iteration");
+    ++stats_.read_iteration_count;
 
     if (!last_iteration_saw_events) {
       // Periodically print event statistics.
-      PrintStatsIfTimerElapsed();
+      if (print_stats_when_idle) {
+        PrintStatsIfTimerElapsed();
+      }
 
       // Sleep if there was no new event in the last iteration so that we are
       // not constantly polling. Don't sleep so long that ring buffers overflow.
@@ -951,34 +1022,227 @@ void TracerImpl::Run() {
     // Read and process events from all ring buffers. In order to ensure that no
     // buffer is read constantly while others overflow, we schedule the reading
     // using round-robin like scheduling.
-    for (PerfEventRingBuffer& ring_buffer : ring_buffers_) {
+    for (PerfEventRingBuffer* ring_buffer : ring_buffers) {
       if (stop_run_thread_) {
         break;
       }
+      if (ProcessRecordBatch(ring_buffer) > 0) {
+        last_iteration_saw_events = true;
+      }
+    }
+  }
+}
 
-      // Read up to ROUND_ROBIN_POLLING_BATCH_SIZE (5) new events.
-      // TODO: Some event types (e.g., stack samples) have a much longer
-      //  processing time but are less frequent than others (e.g., context
-      //  switches). Take this into account in our scheduling algorithm.
-      for (int32_t read_from_this_buffer = 0;
-           read_from_this_buffer < ROUND_ROBIN_POLLING_BATCH_SIZE; ++read_from_this_buffer) {
-        if (stop_run_thread_) {
-          break;
-        }
-        if (!ring_buffer.HasNewData()) {
-          break;
+void TracerImpl::ReadRingBuffersWithEpoll(const std::vector<PerfEventRingBuffer*>& ring_buffers,
+                                          bool print_stats_when_idle) {
+  int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd == -1) {
+    ORBIT_ERROR("epoll_create1: %s; falling back to polling the ring buffers", SafeStrerror(errno));
+    ReadRingBuffersWithSleepAndPoll(ring_buffers, print_stats_when_idle);
+    return;
+  }
+
+  for (size_t ring_buffer_index = 0; ring_buffer_index < ring_buffers.size();
+       ++ring_buffer_index) {
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = ring_buffer_index;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, ring_buffers[ring_buffer_index]->GetFileDescriptor(),
+                  &event) != 0) {
+      ORBIT_ERROR("epoll_ctl on ring buffer '%s': %s; falling back to polling the ring buffers",
+                  ring_buffers[ring_buffer_index]->GetName(), SafeStrerror(errno));
+      close(epoll_fd);
+      ReadRingBuffersWithSleepAndPoll(ring_buffers, print_stats_when_idle);
+      return;
+    }
+  }
+
+  // Indices of the ring buffers that were reported as ready, or that still had data after we read
+  // the last batch from them. We keep reading them in a round-robin fashion, so that no buffer is
+  // read constantly while the others overflow.
+  std::vector<size_t> pending_ring_buffer_indices;
+  std::vector<bool> is_ring_buffer_pending(ring_buffers.size(), false);
+  std::vector<size_t> still_pending_ring_buffer_indices;
+  std::vector<epoll_event> ready_events(std::max<size_t>(ring_buffers.size(), 1));
+  uint64_t last_full_read_timestamp_ns = orbit_base::CaptureTimestampNs();
+
+  while (!stop_run_thread_) {
+    ORBIT_SCOPE("TracerThread::Run iteration");
+    ++stats_.read_iteration_count;
+
+    // Don't block if we know that some ring buffers still have data to read.
+    const int timeout_ms =
+        pending_ring_buffer_indices.empty() ? EPOLL_MAX_TIME_BETWEEN_FULL_READS_MS : 0;
+    int ready_count;
+    {
+      ORBIT_SCOPE("epoll_wait");
+      ready_count = epoll_wait(epoll_fd, ready_events.data(),
+                               static_cast<int>(ready_events.size()), timeout_ms);
+    }
+    if (ready_count == -1) {
+      if (errno != EINTR) {
+        ORBIT_ERROR("epoll_wait: %s", SafeStrerror(errno));
+      }
+      ready_count = 0;
+    }
+    if (ready_count > 0) {
+      ++stats_.epoll_wakeup_count;
+    }
+
+    for (int i = 0; i < ready_count; ++i) {
+      const size_t ring_buffer_index = ready_events[i].data.u64;
+      if (!is_ring_buffer_pending[ring_buffer_index]) {
+        is_ring_buffer_pending[ring_buffer_index] = true;
+        pending_ring_buffer_indices.push_back(ring_buffer_index);
+      }
+    }
+
+    // Ring buffers that don't reach the watermark don't wake us up, so also read all of them
+    // periodically.
+    const uint64_t current_timestamp_ns = orbit_base::CaptureTimestampNs();
+    if (current_timestamp_ns - last_full_read_timestamp_ns >=
+        EPOLL_MAX_TIME_BETWEEN_FULL_READS_MS * 1'000'000ULL) {
+      last_full_read_timestamp_ns = current_timestamp_ns;
+      for (size_t ring_buffer_index = 0; ring_buffer_index < ring_buffers.size();
+           ++ring_buffer_index) {
+        if (!is_ring_buffer_pending[ring_buffer_index]) {
+          is_ring_buffer_pending[ring_buffer_index] = true;
+          pending_ring_buffer_indices.push_back(ring_buffer_index);
         }
+      }
 
-        last_iteration_saw_events = true;
-        ProcessOneRecord(&ring_buffer);
+      // Periodically print event statistics.
+      if (print_stats_when_idle) {
+        PrintStatsIfTimerElapsed();
+      }
+    }
+
+    still_pending_ring_buffer_indices.clear();
+    for (size_t ring_buffer_index : pending_ring_buffer_indices) {
+      if (stop_run_thread_) {
+        break;
+      }
+      // If we read a full batch, the ring buffer might contain more data.
+      if (ProcessRecordBatch(ring_buffers[ring_buffer_index]) == ROUND_ROBIN_POLLING_BATCH_SIZE) {
+        still_pending_ring_buffer_indices.push_back(ring_buffer_index);
+      } else {
+        is_ring_buffer_pending[ring_buffer_index] = false;
       }
     }
+    pending_ring_buffer_indices.swap(still_pending_ring_buffer_indices);
+  }
+
+  close(epoll_fd);
+}
+
+void TracerImpl::ReadRingBuffers(const std::vector<PerfEventRingBuffer*>& ring_buffers,
+                                 bool print_stats_when_idle) {
+  switch (ring_buffer_wait_method_) {
+    case CaptureOptions::kEpollWithWakeupWatermark:
+      ReadRingBuffersWithEpoll(ring_buffers, print_stats_when_idle);
+      break;
+    case CaptureOptions::kSleepAndPoll:
+    default:
+      ReadRingBuffersWithSleepAndPoll(ring_buffers, print_stats_when_idle);
+      break;
+  }
+}
+
+std::vector<std::vector<PerfEventRingBuffer*>> TracerImpl::PartitionRingBuffersByCpu(
+    uint32_t partition_count) {
+  ORBIT_CHECK(partition_count > 0);
+  const int32_t number_of_cores = GetNumCores();
+  std::vector<std::vector<PerfEventRingBuffer*>> partitions(partition_count);
+  for (PerfEventRingBuffer& ring_buffer : ring_buffers_) {
+    // Assign contiguous groups of cpus to the same partition, so that each reader thread can be
+    // pinned to the cpus whose ring buffers it reads.
+    const int32_t cpu = std::clamp(ring_buffer.GetCpu(), 0, number_of_cores - 1);
+    const size_t partition_index = static_cast<size_t>(cpu) * partition_count / number_of_cores;
+    partitions[partition_index].push_back(&ring_buffer);
+  }
+  return partitions;
+}
+
+static void PinCurrentThreadToCpusOfRingBuffers(
+    const std::vector<PerfEventRingBuffer*>& ring_buffers) {
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (const PerfEventRingBuffer* ring_buffer : ring_buffers) {
+    if (ring_buffer->GetCpu() >= 0 && ring_buffer->GetCpu() < CPU_SETSIZE) {
+      CPU_SET(ring_buffer->GetCpu(), &cpu_set);
+    }
+  }
+  if (CPU_COUNT(&cpu_set) == 0) {
+    return;
+  }
+  int result = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+  if (result != 0) {
+    ORBIT_ERROR("pthread_setaffinity_np: %s", SafeStrerror(result));
+  }
+}
+
+void TracerImpl::RunRingBufferReader(uint32_t reader_index,
+                                     const std::vector<PerfEventRingBuffer*>& ring_buffers) {
+  orbit_base::SetCurrentThreadName(absl::StrFormat("TracerReader#%u", reader_index).c_str());
+  PinCurrentThreadToCpusOfRingBuffers(ring_buffers);
+  ReadRingBuffers(ring_buffers, /*print_stats_when_idle=*/false);
+}
+
+void TracerImpl::Run() {
+  orbit_base::SetCurrentThreadName("Tracer::Run");
+
+  Startup();
+
+  // Insert an entry for every ring buffer in advance, so that ProcessOneRecord only needs to update
+  // existing entries. This allows reading different ring buffers from different threads.
+  for (const PerfEventRingBuffer& ring_buffer : ring_buffers_) {
+    fds_to_last_timestamp_ns_.try_emplace(ring_buffer.GetFileDescriptor(), 0);
+  }
+
+  std::thread deferred_events_thread(&TracerImpl::ProcessDeferredEvents, this);
+
+  const uint32_t reader_thread_count =
+      std::min<uint32_t>(ring_buffer_reader_thread_count_, static_cast<uint32_t>(GetNumCores()));
+  if (reader_thread_count <= 1) {
+    std::vector<PerfEventRingBuffer*> all_ring_buffers;
+    all_ring_buffers.reserve(ring_buffers_.size());
+    for (PerfEventRingBuffer& ring_buffer : ring_buffers_) {
+      all_ring_buffers.push_back(&ring_buffer);
+    }
+    ReadRingBuffers(all_ring_buffers, /*print_stats_when_idle=*/true);
+  } else {
+    // Each ring buffer is only ever read by one thread, hence the events from the same ring buffer
+    // still reach PerfEventProcessor in order. Ordering across ring buffers is then restored by
+    // PerfEventProcessor exactly as when all ring buffers are read by one thread.
+    std::vector<std::vector<PerfEventRingBuffer*>> partitions =
+        PartitionRingBuffersByCpu(reader_thread_count);
+    std::vector<std::thread> reader_threads;
+    for (uint32_t reader_index = 0; reader_index < partitions.size(); ++reader_index) {
+      if (partitions[reader_index].empty()) {
+        continue;
+      }
+      reader_threads.emplace_back(&TracerImpl::RunRingBufferReader, this, reader_index,
+                                  std::cref(partitions[reader_index]));
+    }
+
+    while (!stop_run_thread_) {
+      // Periodically print event statistics.
+      PrintStatsIfTimerElapsed();
+      usleep(IDLE_TIME_ON_EMPTY_RING_BUFFERS_US);
+    }
+
+    for (std::thread& reader_thread : reader_threads) {
+      reader_thread.join();
+    }
   }
 
   // Finish processing all deferred events.
   stop_deferred_thread_ = true;
   deferred_events_thread.join();
   event_processor_.ProcessAllEvents();
+  if (resequencing_listener_ != nullptr) {
+    resequencing_listener_->WaitForAndSendAllEvents();
+  }
 
   Shutdown();
 }
@@ -1029,7 +1293,7 @@ uint64_t TracerImpl::ProcessExitEventAndReturnTimestamp(const perf_event_header&
 
 uint64_t TracerImpl::ProcessMmapEventAndReturnTimestamp(const perf_event_header& header,
                                                         PerfEventRingBuffer* ring_buffer) {
-  MmapPerfEvent event = ConsumeMmapPerfEvent(ring_buffer, header);
+  MmapPerfEvent event = ConsumeMmapPerfEvent(ring_buffer, ring_buffer->ReadRecordAtTail(header));
   const uint64_t timestamp_ns = event.timestamp;
 
   if (event.data.pid != target_pid_) {
@@ -1048,7 +1312,10 @@ uint64_t TracerImpl::ProcessMmapEventAndReturnTimestamp(const perf_event_header&
 
 uint64_t TracerImpl::ProcessSampleEventAndReturnTimestamp(const perf_event_header& header,
                                                           PerfEventRingBuffer* ring_buffer) {
-  uint64_t timestamp_ns = ReadSampleRecordTime(ring_buffer);
+  // The fields of the record are read directly from the ring buffer through this view, as long as
+  // the record doesn't wrap around the end of the ring buffer.
+  const PerfEventRecordView record = ring_buffer->ReadRecordAtTail(header);
+  uint64_t timestamp_ns = ReadSampleRecordTime(record);
 
   if (timestamp_ns < effective_capture_start_timestamp_ns_) {
     // Don't consider events that came before all file descriptors had been enabled.
@@ -1056,7 +1323,7 @@ uint64_t TracerImpl::ProcessSampleEventAndReturnTimestamp(const perf_event_heade
     return timestamp_ns;
   }
 
-  uint64_t stream_id = ReadSampleRecordStreamId(ring_buffer);
+  uint64_t stream_id = ReadSampleRecordStreamId(record);
   bool is_uprobe = uprobes_ids_.contains(stream_id);
   bool is_uprobe_with_args = uprobes_with_args_ids_.contains(stream_id);
   bool is_uprobe_with_stack = uprobes_with_stack_ids_.contains(stream_id);
@@ -1111,7 +1378,7 @@ uint64_t TracerImpl::ProcessSampleEventAndReturnTimestamp(const perf_event_heade
     ++stats_.uprobes_count;
 
   } else if (is_uprobe_with_stack) {
-    pid_t pid = ReadSampleRecordPid(ring_buffer);
+    pid_t pid = ReadSampleRecordPid(record);
     const size_t size_of_uprobe_sample = sizeof(perf_event_sp_stack_user_sample_fixed) +
                                          2 * sizeof(uint64_t) /*size and dyn_size*/ +
                                          stack_dump_size_ /*data*/;
@@ -1124,7 +1391,7 @@ uint64_t TracerImpl::ProcessSampleEventAndReturnTimestamp(const perf_event_heade
       return timestamp_ns;
     }
 
-    UprobesWithStackPerfEvent event = ConsumeUprobeWithStackPerfEvent(ring_buffer, header);
+    UprobesWithStackPerfEvent event = ConsumeUprobeWithStackPerfEvent(ring_buffer, record);
     DeferEvent(std::move(event));
     ++stats_.uprobes_with_stack_count;
   } else if (is_uprobe_with_args) {
@@ -1199,7 +1466,7 @@ uint64_t TracerImpl::ProcessSampleEventAndReturnTimestamp(const perf_event_heade
     ++stats_.uprobes_count;
 
   } else if (is_stack_sample) {
-    pid_t pid = ReadSampleRecordPid(ring_buffer);
+    pid_t pid = ReadSampleRecordPid(record);
 
     const size_t size_of_stack_sample = sizeof(perf_event_stack_sample_fixed) +
                                         2 * sizeof(uint64_t) /*size and dyn_size*/ +
@@ -1223,19 +1490,21 @@ uint64_t TracerImpl::ProcessSampleEventAndReturnTimestamp(const perf_event_heade
     // e.g., with header.misc == PERF_RECORD_MISC_KERNEL,
     // in general they seem to produce valid callstacks.
 
-    StackSamplePerfEvent event = ConsumeStackSamplePerfEvent(ring_buffer, header);
+    StackSamplePerfEvent event =
+        ConsumeStackSamplePerfEvent(ring_buffer, record, &sample_buffer_pool_);
     DeferEvent(std::move(event));
     ++stats_.sample_count;
 
   } else if (is_callchain_sample) {
-    pid_t pid = ReadSampleRecordPid(ring_buffer);
+    pid_t pid = ReadSampleRecordPid(record);
 
     if (pid != target_pid_) {
       ring_buffer->SkipRecord(header);
       return timestamp_ns;
     }
 
-    PerfEvent event = ConsumeCallchainSamplePerfEvent(ring_buffer, header);
+    PerfEvent event =
+        ConsumeCallchainSamplePerfEvent(ring_buffer, record, &sample_buffer_pool_);
     DeferEvent(std::move(event));
     ++stats_.sample_count;
 
@@ -1307,21 +1576,21 @@ uint64_t TracerImpl::ProcessSampleEventAndReturnTimestamp(const perf_event_heade
     ++stats_.sched_switch_count;
 
   } else if (is_sched_wakeup) {
-    SchedWakeupPerfEvent event = ConsumeSchedWakeupPerfEvent(ring_buffer, header);
+    SchedWakeupPerfEvent event = ConsumeSchedWakeupPerfEvent(ring_buffer, record);
     DeferEvent(event);
 
   } else if (is_amdgpu_cs_ioctl_event) {
-    AmdgpuCsIoctlPerfEvent event = ConsumeAmdgpuCsIoctlPerfEvent(ring_buffer, header);
+    AmdgpuCsIoctlPerfEvent event = ConsumeAmdgpuCsIoctlPerfEvent(ring_buffer, record);
     DeferEvent(std::move(event));
     ++stats_.gpu_events_count;
 
   } else if (is_amdgpu_sched_run_job_event) {
-    AmdgpuSchedRunJobPerfEvent event = ConsumeAmdgpuSchedRunJobPerfEvent(ring_buffer, header);
+    AmdgpuSchedRunJobPerfEvent event = ConsumeAmdgpuSchedRunJobPerfEvent(ring_buffer, record);
     DeferEvent(std::move(event));
     ++stats_.gpu_events_count;
 
   } else if (is_dma_fence_signaled_event) {
-    DmaFenceSignaledPerfEvent event = ConsumeDmaFenceSignaledPerfEvent(ring_buffer, header);
+    DmaFenceSignaledPerfEvent event = ConsumeDmaFenceSignaledPerfEvent(ring_buffer, record);
     DeferEvent(std::move(event));
     ++stats_.gpu_events_count;
 
@@ -1331,7 +1600,7 @@ uint64_t TracerImpl::ProcessSampleEventAndReturnTimestamp(const perf_event_heade
       return timestamp_ns;
     }
 
-    GenericTracepointPerfEvent event = ConsumeGenericTracepointPerfEvent(ring_buffer, header);
+    GenericTracepointPerfEvent event = ConsumeGenericTracepointPerfEvent(ring_buffer, record);
 
     orbit_grpc_protos::FullTracepointEvent tracepoint_event;
     tracepoint_event.set_pid(event.data.pid);
@@ -1358,7 +1627,10 @@ uint64_t TracerImpl::ProcessLostEventAndReturnTimestamp(const perf_event_header&
   uint64_t timestamp = ring_buffer_record.sample_id.time;
 
   stats_.lost_count += ring_buffer_record.lost;
-  stats_.lost_count_per_buffer[ring_buffer] += ring_buffer_record.lost;
+  {
+    absl::MutexLock lock{&stats_.lost_count_per_buffer_mutex};
+    stats_.lost_count_per_buffer[ring_buffer] += ring_buffer_record.lost;
+  }
 
   // Fetch the timestamp of the last event that preceded this PERF_RECORD_LOST in this same ring
   // buffer.
@@ -1391,7 +1663,8 @@ uint64_t TracerImpl::ProcessThrottleUnthrottleEventAndReturnTimestamp(
     const perf_event_header& header, PerfEventRingBuffer* ring_buffer) {
   // Throttle/unthrottle events are reported when sampling causes too much throttling on the CPU.
   // They are usually caused by/reproducible with a very high sampling frequency.
-  uint64_t timestamp_ns = ReadThrottleUnthrottleRecordTime(ring_buffer);
+  uint64_t timestamp_ns =
+      ReadThrottleUnthrottleRecordTime(ring_buffer->ReadRecordAtTail(header));
 
   ring_buffer->SkipRecord(header);
 
@@ -1413,27 +1686,56 @@ uint64_t TracerImpl::ProcessThrottleUnthrottleEventAndReturnTimestamp(
 }
 
 void TracerImpl::DeferEvent(PerfEvent&& event) {
-  absl::MutexLock lock{&deferred_events_being_buffered_mutex_};
-  deferred_events_being_buffered_.emplace_back(std::move(event));
+  deferred_events_.enqueue(std::move(event));
+  if (deferred_events_consumer_is_waiting_) {
+    absl::MutexLock lock{&deferred_events_wakeup_mutex_};
+    deferred_events_wakeup_cond_var_.Signal();
+  }
+}
+
+void TracerImpl::WaitForDeferredEvents() {
+  ORBIT_SCOPE("Wait");
+  absl::MutexLock lock{&deferred_events_wakeup_mutex_};
+  deferred_events_consumer_is_waiting_ = true;
+  // An event enqueued concurrently with setting the flag could miss waking us up, in which case it
+  // will only be picked up after the timeout, exactly as if we had slept unconditionally.
+  if (deferred_events_.size_approx() == 0) {
+    deferred_events_wakeup_cond_var_.WaitWithTimeout(
+        &deferred_events_wakeup_mutex_, absl::Microseconds(IDLE_TIME_ON_EMPTY_DEFERRED_EVENTS_US));
+  }
+  deferred_events_consumer_is_waiting_ = false;
 }
 
 void TracerImpl::ProcessDeferredEvents() {
   orbit_base::SetCurrentThreadName("Proc.Def.Events");
-  bool should_exit = false;
-  while (!should_exit) {
+  while (true) {
     ORBIT_SCOPE("ProcessDeferredEvents iteration");
     // When "should_exit" becomes true, we know that we have stopped generating
-    // deferred events. The last iteration will consume all remaining events.
-    should_exit = stop_deferred_thread_;
+    // deferred events. The remaining iterations will consume all remaining events.
+    const bool should_exit = stop_deferred_thread_;
 
-    {
-      absl::MutexLock lock{&deferred_events_being_buffered_mutex_};
-      deferred_events_being_buffered_.swap(deferred_events_to_process_);
+    // Note (https://en.cppreference.com/w/cpp/container/vector/clear): std::vector::clear() "Leaves
+    // the capacity() of the vector unchanged", so deferred_events_to_process_ doesn't have to be
+    // grown again in every iteration.
+    deferred_events_to_process_.clear();
+    const size_t dequeued_count = deferred_events_.try_dequeue_bulk(
+        std::back_inserter(deferred_events_to_process_), MAX_DEFERRED_EVENTS_PER_ITERATION);
+    if (dequeued_count > 0) {
+      const uint64_t queue_depth = dequeued_count + deferred_events_.size_approx();
+      if (queue_depth > stats_.deferred_events_queue_depth_high_water_mark) {
+        stats_.deferred_events_queue_depth_high_water_mark = queue_depth;
+      }
+    }
+
+    if (resequencing_listener_ != nullptr) {
+      // Otherwise, the events following the last stack samples being unwound would be held back
+      // until more events are processed.
+      resequencing_listener_->SendReadyEvents();
     }
 
     if (deferred_events_to_process_.empty()) {
-      ORBIT_SCOPE("Sleep");
-      usleep(IDLE_TIME_ON_EMPTY_DEFERRED_EVENTS_US);
+      if (should_exit) break;
+      WaitForDeferredEvents();
       continue;
     }
 
@@ -1443,10 +1745,6 @@ void TracerImpl::ProcessDeferredEvents() {
         event_processor_.AddEvent(std::move(event));
       }
     }
-    // Note (https://en.cppreference.com/w/cpp/container/vector/clear): std::vector::clear() "Leaves
-    // the capacity() of the vector unchanged", which is desired as deferred_events_being_buffered_
-    // won't have to be grown again after the swap.
-    deferred_events_to_process_.clear();
     {
       ORBIT_SCOPE("ProcessOldEvents");
       event_processor_.ProcessOldEvents();
@@ -1498,12 +1796,17 @@ void TracerImpl::Reset() {
   effective_capture_start_timestamp_ns_ = 0;
 
   stop_deferred_thread_ = false;
-  {
-    absl::MutexLock lock{&deferred_events_being_buffered_mutex_};
-    deferred_events_being_buffered_.clear();
-  }
   deferred_events_to_process_.clear();
+  while (deferred_events_.try_dequeue_bulk(std::back_inserter(deferred_events_to_process_),
+                                           MAX_DEFERRED_EVENTS_PER_ITERATION) > 0) {
+    deferred_events_to_process_.clear();
+  }
+  if (unwinding_thread_pool_ != nullptr) {
+    unwinding_thread_pool_->ShutdownAndWait();
+    unwinding_thread_pool_.reset();
+  }
   uprobes_unwinding_visitor_.reset();
+  resequencing_listener_.reset();
   leaf_function_call_manager_.reset();
   return_address_manager_.reset();
   switches_states_names_visitor_.reset();
@@ -1523,25 +1826,32 @@ void TracerImpl::PrintStatsIfTimerElapsed() {
   ORBIT_CHECK(actual_window_s > 0.0);
 
   ORBIT_LOG("Events per second (and total) last %.3f s:", actual_window_s);
-  ORBIT_LOG("  sched switches: %.0f/s (%lu)", stats_.sched_switch_count / actual_window_s,
-            stats_.sched_switch_count);
-  ORBIT_LOG("  samples: %.0f/s (%lu)", stats_.sample_count / actual_window_s, stats_.sample_count);
-  ORBIT_LOG("  u(ret)probes: %.0f/s (%lu)", stats_.uprobes_count / actual_window_s,
-            stats_.uprobes_count);
-  ORBIT_LOG("  uprobes with stack: %.0f/s (%lu)", stats_.uprobes_with_stack_count / actual_window_s,
-            stats_.uprobes_with_stack_count);
-  ORBIT_LOG("  gpu events: %.0f/s (%lu)", stats_.gpu_events_count / actual_window_s,
-            stats_.gpu_events_count);
-  ORBIT_LOG("  mmap events: %.0f/s (%lu)", stats_.mmap_count / actual_window_s, stats_.mmap_count);
-
-  if (stats_.lost_count_per_buffer.empty()) {
-    ORBIT_LOG("  lost: %.0f/s (%lu)", stats_.lost_count / actual_window_s, stats_.lost_count);
-  } else {
-    ORBIT_LOG("  LOST: %.0f/s (%lu), of which:", stats_.lost_count / actual_window_s,
-              stats_.lost_count);
-    for (const auto& buffer_and_lost_count : stats_.lost_count_per_buffer) {
-      ORBIT_LOG("    from %s: %.0f/s (%lu)", buffer_and_lost_count.first->GetName().c_str(),
-                buffer_and_lost_count.second / actual_window_s, buffer_and_lost_count.second);
+  uint64_t sched_switch_count = stats_.sched_switch_count;
+  ORBIT_LOG("  sched switches: %.0f/s (%lu)", sched_switch_count / actual_window_s,
+            sched_switch_count);
+  uint64_t sample_count = stats_.sample_count;
+  ORBIT_LOG("  samples: %.0f/s (%lu)", sample_count / actual_window_s, sample_count);
+  uint64_t uprobes_count = stats_.uprobes_count;
+  ORBIT_LOG("  u(ret)probes: %.0f/s (%lu)", uprobes_count / actual_window_s, uprobes_count);
+  uint64_t uprobes_with_stack_count = stats_.uprobes_with_stack_count;
+  ORBIT_LOG("  uprobes with stack: %.0f/s (%lu)", uprobes_with_stack_count / actual_window_s,
+            uprobes_with_stack_count);
+  uint64_t gpu_events_count = stats_.gpu_events_count;
+  ORBIT_LOG("  gpu events: %.0f/s (%lu)", gpu_events_count / actual_window_s, gpu_events_count);
+  uint64_t mmap_count = stats_.mmap_count;
+  ORBIT_LOG("  mmap events: %.0f/s (%lu)", mmap_count / actual_window_s, mmap_count);
+
+  uint64_t lost_count = stats_.lost_count;
+  {
+    absl::MutexLock lock{&stats_.lost_count_per_buffer_mutex};
+    if (stats_.lost_count_per_buffer.empty()) {
+      ORBIT_LOG("  lost: %.0f/s (%lu)", lost_count / actual_window_s, lost_count);
+    } else {
+      ORBIT_LOG("  LOST: %.0f/s (%lu), of which:", lost_count / actual_window_s, lost_count);
+      for (const auto& buffer_and_lost_count : stats_.lost_count_per_buffer) {
+        ORBIT_LOG("    from %s: %.0f/s (%lu)", buffer_and_lost_count.first->GetName().c_str(),
+                  buffer_and_lost_count.second / actual_window_s, buffer_and_lost_count.second);
+      }
     }
   }
 
@@ -1550,22 +1860,64 @@ void TracerImpl::PrintStatsIfTimerElapsed() {
       "  %s: %.0f/s (%lu)",
       discarded_out_of_order_count == 0 ? "discarded as out of order" : "DISCARDED AS OUT OF ORDER",
       discarded_out_of_order_count / actual_window_s, discarded_out_of_order_count);
+  if (adaptive_processing_delay_) {
+    ORBIT_LOG("  adaptive processing delay: %.0f ms",
+              event_processor_.GetProcessingDelayNs() / 1'000'000.0);
+  }
 
-  // Ensure we can divide by 0.0 safely in case stats_.sample_count is zero.
+  // Ensure we can divide by 0.0 safely in case sample_count is zero.
   static_assert(std::numeric_limits<double>::is_iec559);
 
   uint64_t unwind_error_count = stats_.unwind_error_count;
   ORBIT_LOG("  unwind errors: %.0f/s (%lu) [%.1f%%]", unwind_error_count / actual_window_s,
-            unwind_error_count, 100.0 * unwind_error_count / stats_.sample_count);
+            unwind_error_count, 100.0 * unwind_error_count / sample_count);
   uint64_t discarded_samples_in_uretprobes_count = stats_.samples_in_uretprobes_count;
   ORBIT_LOG("  samples in u(ret)probes: %.0f/s (%lu) [%.1f%%]",
             discarded_samples_in_uretprobes_count / actual_window_s,
             discarded_samples_in_uretprobes_count,
-            100.0 * discarded_samples_in_uretprobes_count / stats_.sample_count);
+            100.0 * discarded_samples_in_uretprobes_count / sample_count);
+  if (unwinder_ != nullptr) {
+    const LibunwindstackUnwinder::Stats unwinder_stats = unwinder_->GetAndResetStats();
+    ORBIT_LOG("  unwound frames: %.0f/s (%lu), of which %.0f/s actually unwound",
+              unwinder_stats.frame_count / actual_window_s, unwinder_stats.frame_count,
+              unwinder_stats.unwound_frame_count / actual_window_s);
+    ORBIT_LOG("  unwind cache: %.0f lookups/s (%lu) [%.1f%% hits]",
+              unwinder_stats.cache_lookup_count / actual_window_s,
+              unwinder_stats.cache_lookup_count,
+              100.0 * unwinder_stats.cache_hit_count / unwinder_stats.cache_lookup_count);
+  }
 
   uint64_t thread_state_count = stats_.thread_state_count;
   ORBIT_LOG("  target's thread states: %.0f/s (%lu)", thread_state_count / actual_window_s,
             thread_state_count);
+
+  uint64_t read_iteration_count = stats_.read_iteration_count;
+  ORBIT_LOG("  ring buffer read iterations: %.0f/s (%lu)", read_iteration_count / actual_window_s,
+            read_iteration_count);
+  if (ring_buffer_wait_method_ == CaptureOptions::kEpollWithWakeupWatermark) {
+    uint64_t epoll_wakeup_count = stats_.epoll_wakeup_count;
+    ORBIT_LOG("  epoll wakeups: %.0f/s (%lu)", epoll_wakeup_count / actual_window_s,
+              epoll_wakeup_count);
+  }
+  uint64_t ring_buffer_head_read_count = stats_.ring_buffer_head_read_count;
+  ORBIT_LOG("  ring buffer head reads: %.0f/s (%lu)",
+            ring_buffer_head_read_count / actual_window_s, ring_buffer_head_read_count);
+  ORBIT_LOG("  deferred events queue high-water mark: %lu",
+            stats_.deferred_events_queue_depth_high_water_mark.load());
+
+  const PerfEventBufferPool::Stats pool_stats = sample_buffer_pool_.GetAndResetStats();
+  const uint64_t pool_miss_count = pool_stats.allocation_count - pool_stats.hit_count;
+  // Estimate the time saved by assuming that each hit would have cost as much as an average miss.
+  const double average_miss_duration_ns =
+      pool_miss_count > 0 ? static_cast<double>(pool_stats.miss_duration_ns) / pool_miss_count
+                          : 0.0;
+  ORBIT_LOG("  sample buffer pool: %.0f allocations/s (%lu) [%.1f%% hits], %.1f KB retained",
+            pool_stats.allocation_count / actual_window_s, pool_stats.allocation_count,
+            100.0 * pool_stats.hit_count / pool_stats.allocation_count,
+            pool_stats.retained_bytes / 1024.0);
+  ORBIT_LOG("  sample buffer pool: ~%.3f ms of allocations saved (%.0f ns per miss)",
+            pool_stats.hit_count * average_miss_duration_ns / 1'000'000.0,
+            average_miss_duration_ns);
   stats_.Reset();
 }
 
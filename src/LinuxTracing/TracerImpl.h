@@ -14,6 +14,7 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <memory>
@@ -31,14 +32,18 @@
 #include "LinuxTracing/UserSpaceInstrumentationAddresses.h"
 #include "LostAndDiscardedEventVisitor.h"
 #include "OrbitBase/Profiling.h"
+#include "OrbitBase/ThreadPool.h"
 #include "OrbitBase/ThreadUtils.h"
 #include "PerfEvent.h"
+#include "PerfEventBufferPool.h"
 #include "PerfEventProcessor.h"
 #include "PerfEventRingBuffer.h"
+#include "ResequencingTracerListener.h"
 #include "SwitchesStatesNamesVisitor.h"
 #include "UprobesFunctionCallManager.h"
 #include "UprobesReturnAddressManager.h"
 #include "UprobesUnwindingVisitor.h"
+#include "concurrentqueue.h"
 
 namespace orbit_linux_tracing {
 
@@ -64,8 +69,23 @@ class TracerImpl : public Tracer {
   void Run();
   void Startup();
   void Shutdown();
+  void ReadRingBuffersWithSleepAndPoll(const std::vector<PerfEventRingBuffer*>& ring_buffers,
+                                       bool print_stats_when_idle);
+  void ReadRingBuffersWithEpoll(const std::vector<PerfEventRingBuffer*>& ring_buffers,
+                                bool print_stats_when_idle);
+  void ReadRingBuffers(const std::vector<PerfEventRingBuffer*>& ring_buffers,
+                       bool print_stats_when_idle);
+  [[nodiscard]] std::vector<std::vector<PerfEventRingBuffer*>> PartitionRingBuffersByCpu(
+      uint32_t partition_count);
+  void RunRingBufferReader(uint32_t reader_index,
+                           const std::vector<PerfEventRingBuffer*>& ring_buffers);
+  [[nodiscard]] int32_t ProcessRecordBatch(PerfEventRingBuffer* ring_buffer);
   void ProcessOneRecord(PerfEventRingBuffer* ring_buffer);
+  [[nodiscard]] uint32_t ComputeWakeupWatermark(uint64_t ring_buffer_size_kb) const;
   void InitUprobesEventVisitor();
+  [[nodiscard]] TracerListener* GetVisitorListener() const {
+    return (resequencing_listener_ != nullptr) ? resequencing_listener_.get() : listener_;
+  }
   bool OpenUserSpaceProbes(const std::vector<int32_t>& cpus);
   bool OpenUprobesToRecordAdditionalStackOn(const std::vector<int32_t>& cpus);
   bool OpenUprobes(const orbit_grpc_protos::InstrumentedFunction& function,
@@ -111,6 +131,7 @@ class TracerImpl : public Tracer {
       const perf_event_header& header, PerfEventRingBuffer* ring_buffer);
 
   void DeferEvent(PerfEvent&& event);
+  void WaitForDeferredEvents();
   void ProcessDeferredEvents();
 
   void RetrieveInitialTidToPidAssociationSystemWide();
@@ -137,7 +158,15 @@ class TracerImpl : public Tracer {
   static constexpr uint64_t UPROBES_WITH_STACK_RING_BUFFER_SIZE_KB = 64 * 1024;
 
   static constexpr uint32_t IDLE_TIME_ON_EMPTY_RING_BUFFERS_US = 5000;
+
+  // With CaptureOptions::kEpollWithWakeupWatermark, a ring buffer wakes up the reading thread
+  // when it is filled to 1/RING_BUFFER_WAKEUP_WATERMARK_DIVISOR of its size. Ring buffers that stay
+  // below the watermark are still read at least every EPOLL_MAX_TIME_BETWEEN_FULL_READS_MS, so that
+  // their events are not delayed past PerfEventProcessor's processing delay.
+  static constexpr uint64_t RING_BUFFER_WAKEUP_WATERMARK_DIVISOR = 8;
+  static constexpr int EPOLL_MAX_TIME_BETWEEN_FULL_READS_MS = 50;
   static constexpr uint32_t IDLE_TIME_ON_EMPTY_DEFERRED_EVENTS_US = 5000;
+  static constexpr size_t MAX_DEFERRED_EVENTS_PER_ITERATION = 16 * 1024;
 
   bool trace_context_switches_;
   bool introspection_enabled_;
@@ -152,6 +181,10 @@ class TracerImpl : public Tracer {
   bool trace_thread_state_;
   bool trace_gpu_driver_;
   std::vector<orbit_grpc_protos::TracepointInfo> instrumented_tracepoints_;
+  orbit_grpc_protos::CaptureOptions::RingBufferWaitMethod ring_buffer_wait_method_;
+  uint32_t ring_buffer_reader_thread_count_;
+  uint32_t stack_unwinding_thread_count_;
+  bool adaptive_processing_delay_;
 
   std::unique_ptr<UserSpaceInstrumentationAddresses> user_space_instrumentation_addresses_;
 
@@ -162,6 +195,7 @@ class TracerImpl : public Tracer {
 
   std::vector<int> tracing_fds_;
   std::vector<PerfEventRingBuffer> ring_buffers_;
+  // Populated with all the ring buffers' file descriptors before the ring buffers start being read.
   absl::flat_hash_map<int, uint64_t> fds_to_last_timestamp_ns_;
 
   absl::flat_hash_map<uint64_t, uint64_t> uprobes_uretprobes_ids_to_function_id_;
@@ -183,11 +217,19 @@ class TracerImpl : public Tracer {
 
   uint64_t effective_capture_start_timestamp_ns_ = 0;
 
+  // Declared before all the members that hold PerfEvents, as it needs to outlive those events.
+  PerfEventBufferPool sample_buffer_pool_;
+
   std::atomic<bool> stop_deferred_thread_ = false;
-  std::vector<PerfEvent> deferred_events_being_buffered_
-      ABSL_GUARDED_BY(deferred_events_being_buffered_mutex_);
-  absl::Mutex deferred_events_being_buffered_mutex_;
+  // Events are deferred by the threads reading the ring buffers and by the thread reporting
+  // user space instrumentation events. The queue keeps the events enqueued by each thread in order.
+  moodycamel::ConcurrentQueue<PerfEvent> deferred_events_;
   std::vector<PerfEvent> deferred_events_to_process_;
+  // Lets the thread processing the deferred events sleep while the queue is empty. The producers
+  // only take the mutex to wake it up when it is waiting.
+  std::atomic<bool> deferred_events_consumer_is_waiting_ = false;
+  absl::Mutex deferred_events_wakeup_mutex_;
+  absl::CondVar deferred_events_wakeup_cond_var_;
 
   UprobesFunctionCallManager function_call_manager_;
   std::optional<UprobesReturnAddressManager> return_address_manager_;
@@ -195,6 +237,10 @@ class TracerImpl : public Tracer {
   std::unique_ptr<LibunwindstackUnwinder> unwinder_;
   std::unique_ptr<LeafFunctionCallManager> leaf_function_call_manager_;
   std::unique_ptr<UprobesUnwindingVisitor> uprobes_unwinding_visitor_;
+  // Only created when stack_unwinding_thread_count_ > 0. The tasks it runs use maps_ and unwinder_.
+  std::shared_ptr<orbit_base::ThreadPool> unwinding_thread_pool_;
+  // Also only created when stack_unwinding_thread_count_ > 0, wraps listener_ for all visitors.
+  std::unique_ptr<ResequencingTracerListener> resequencing_listener_;
   std::unique_ptr<SwitchesStatesNamesVisitor> switches_states_names_visitor_;
   std::unique_ptr<GpuTracepointVisitor> gpu_event_visitor_;
   std::unique_ptr<LostAndDiscardedEventVisitor> lost_and_discarded_event_visitor_;
@@ -210,26 +256,42 @@ class TracerImpl : public Tracer {
       gpu_events_count = 0;
       mmap_count = 0;
       lost_count = 0;
-      lost_count_per_buffer.clear();
+      {
+        absl::MutexLock lock{&lost_count_per_buffer_mutex};
+        lost_count_per_buffer.clear();
+      }
       discarded_out_of_order_count = 0;
       unwind_error_count = 0;
       samples_in_uretprobes_count = 0;
       thread_state_count = 0;
+      read_iteration_count = 0;
+      epoll_wakeup_count = 0;
+      ring_buffer_head_read_count = 0;
+      deferred_events_queue_depth_high_water_mark = 0;
     }
 
+    // The counters are atomic as ring buffers can be read by multiple threads, see
+    // CaptureOptions::ring_buffer_reader_thread_count.
     uint64_t event_count_begin_ns = 0;
-    uint64_t sched_switch_count = 0;
-    uint64_t sample_count = 0;
-    uint64_t uprobes_count = 0;
-    uint64_t uprobes_with_stack_count = 0;
-    uint64_t gpu_events_count = 0;
-    uint64_t mmap_count = 0;
-    uint64_t lost_count = 0;
-    absl::flat_hash_map<PerfEventRingBuffer*, uint64_t> lost_count_per_buffer{};
+    std::atomic<uint64_t> sched_switch_count = 0;
+    std::atomic<uint64_t> sample_count = 0;
+    std::atomic<uint64_t> uprobes_count = 0;
+    std::atomic<uint64_t> uprobes_with_stack_count = 0;
+    std::atomic<uint64_t> gpu_events_count = 0;
+    std::atomic<uint64_t> mmap_count = 0;
+    std::atomic<uint64_t> lost_count = 0;
+    absl::Mutex lost_count_per_buffer_mutex;
+    absl::flat_hash_map<PerfEventRingBuffer*, uint64_t> lost_count_per_buffer
+        ABSL_GUARDED_BY(lost_count_per_buffer_mutex){};
     std::atomic<uint64_t> discarded_out_of_order_count = 0;
     std::atomic<uint64_t> unwind_error_count = 0;
     std::atomic<uint64_t> samples_in_uretprobes_count = 0;
     std::atomic<uint64_t> thread_state_count = 0;
+    std::atomic<uint64_t> read_iteration_count = 0;
+    std::atomic<uint64_t> epoll_wakeup_count = 0;
+    std::atomic<uint64_t> ring_buffer_head_read_count = 0;
+    // Only updated by the thread processing the deferred events.
+    std::atomic<uint64_t> deferred_events_queue_depth_high_water_mark = 0;
   };
 
   static constexpr uint64_t EVENT_STATS_WINDOW_S = 5;
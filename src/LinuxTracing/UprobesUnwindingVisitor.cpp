@@ -14,6 +14,7 @@
 
 #include <algorithm>
 #include <array>
+#include <cstring>
 #include <memory>
 #include <optional>
 #include <string>
@@ -97,7 +98,7 @@ static bool CallchainIsInUserSpaceInstrumentation(
 }
 
 void UprobesUnwindingVisitor::SendFullAddressInfoToListener(
-    const unwindstack::FrameData& libunwindstack_frame) {
+    const unwindstack::FrameData& libunwindstack_frame, TracerListener* listener) {
   auto [unused_it, inserted] = known_linux_address_infos_.insert(libunwindstack_frame.pc);
   if (!inserted) {
     return;
@@ -128,7 +129,7 @@ void UprobesUnwindingVisitor::SendFullAddressInfoToListener(
   }
 
   ORBIT_CHECK(listener_ != nullptr);
-  listener_->OnAddressInfo(std::move(address_info));
+  listener->OnAddressInfo(std::move(address_info));
 }
 
 static inline bool IsPcInFunctionsToStopAt(
@@ -222,21 +223,74 @@ void UprobesUnwindingVisitor::Visit(uint64_t event_timestamp,
   return_address_manager_->PatchSample(event_data.tid, event_data.GetRegisters()[PERF_REG_X86_SP],
                                        event_data.GetMutableStackData(), event_data.GetStackSize());
 
-  StackSliceView event_stack_slice{event_data.regs->sp, event_data.GetStackSize(),
-                                   event_data.data.get()};
-  std::vector<StackSliceView> stack_slices{event_stack_slice};
+  if (unwinding_thread_pool_ == nullptr) {
+    StackSliceView event_stack_slice{event_data.regs->sp, event_data.GetStackSize(),
+                                     event_data.data.get()};
+    std::vector<StackSliceView> stack_slices{event_stack_slice};
+
+    const auto& stream_id_to_user_stack =
+        thread_id_stream_id_to_stack_slices_.find(event_data.tid);
+    if (stream_id_to_user_stack != thread_id_stream_id_to_stack_slices_.end()) {
+      for (const auto& [unused_stream_id, user_stack_slice] : stream_id_to_user_stack->second) {
+        stack_slices.emplace_back(user_stack_slice.start_address, user_stack_slice.size,
+                                  user_stack_slice.data.get());
+      }
+    }
+
+    LibunwindstackResult libunwindstack_result = unwinder_->Unwind(
+        event_data.pid, current_maps_->Get(), event_data.GetRegisters(), stack_slices);
+    SendStackSample(event_timestamp, event_data.pid, event_data.tid, libunwindstack_result,
+                    listener_);
+    return;
+  }
 
+  // Bound the memory taken by the samples waiting to be unwound and by the events held back.
+  resequencing_listener_->WaitForAndSendEventsUntilAtMostReservations(
+      kMaxStackSamplesBeingUnwound - 1);
+
+  // The task owns a copy of the stack data of the sample, as the event remains owned by the caller,
+  // and shares the ownership of the additional stack slices of this thread, which can be replaced
+  // in the meantime.
+  PooledUniquePtr<char[]> stack_data = MakeUniqueForOverwriteFromPool<char[]>(
+      event_data.data.get_deleter().GetPool(), event_data.GetStackSize());
+  std::memcpy(stack_data.get(), event_data.GetStackData(), event_data.GetStackSize());
+  std::vector<StackSlice> user_stack_slices;
   const auto& stream_id_to_user_stack = thread_id_stream_id_to_stack_slices_.find(event_data.tid);
   if (stream_id_to_user_stack != thread_id_stream_id_to_stack_slices_.end()) {
     for (const auto& [unused_stream_id, user_stack_slice] : stream_id_to_user_stack->second) {
-      stack_slices.emplace_back(user_stack_slice.start_address, user_stack_slice.size,
-                                user_stack_slice.data.get());
+      user_stack_slices.push_back(user_stack_slice);
     }
   }
 
-  LibunwindstackResult libunwindstack_result = unwinder_->Unwind(
-      event_data.pid, current_maps_->Get(), event_data.GetRegisters(), stack_slices);
+  orbit_base::Future<LibunwindstackResult> libunwindstack_result =
+      unwinding_thread_pool_->Schedule(
+          [unwinder = unwinder_, current_maps = current_maps_,
+           current_maps_mutex = &current_maps_mutex_, pid = event_data.pid,
+           registers = event_data.GetRegisters(), stack_size = event_data.GetStackSize(),
+           stack_data = std::move(stack_data),
+           user_stack_slices = std::move(user_stack_slices)]() {
+            std::vector<StackSliceView> stack_slices;
+            stack_slices.reserve(1 + user_stack_slices.size());
+            stack_slices.emplace_back(registers[PERF_REG_X86_SP], stack_size, stack_data.get());
+            for (const StackSlice& user_stack_slice : user_stack_slices) {
+              stack_slices.emplace_back(user_stack_slice.start_address, user_stack_slice.size,
+                                        user_stack_slice.data.get());
+            }
+            absl::ReaderMutexLock lock{current_maps_mutex};
+            return unwinder->Unwind(pid, current_maps->Get(), registers, stack_slices);
+          });
+  resequencing_listener_->SendWhenReady<LibunwindstackResult>(
+      std::move(libunwindstack_result),
+      [this, timestamp_ns = event_timestamp, pid = event_data.pid, tid = event_data.tid](
+          const LibunwindstackResult& libunwindstack_result, TracerListener* listener) {
+        SendStackSample(timestamp_ns, pid, tid, libunwindstack_result, listener);
+      });
+  resequencing_listener_->SendReadyEvents();
+}
 
+void UprobesUnwindingVisitor::SendStackSample(uint64_t timestamp_ns, pid_t pid, pid_t tid,
+                                              const LibunwindstackResult& libunwindstack_result,
+                                              TracerListener* listener) {
   if (libunwindstack_result.frames().empty()) {
     // Even with unwinding errors this is not expected because we should at least get the program
     // counter. Do nothing in case this doesn't hold for a reason we don't know.
@@ -245,19 +299,19 @@ void UprobesUnwindingVisitor::Visit(uint64_t event_timestamp,
   }
 
   FullCallstackSample sample;
-  sample.set_pid(event_data.pid);
-  sample.set_tid(event_data.tid);
-  sample.set_timestamp_ns(event_timestamp);
+  sample.set_pid(pid);
+  sample.set_tid(tid);
+  sample.set_timestamp_ns(timestamp_ns);
 
   Callstack* callstack = sample.mutable_callstack();
   callstack->set_type(ComputeCallstackTypeFromStackSample(libunwindstack_result));
   for (const unwindstack::FrameData& libunwindstack_frame : libunwindstack_result.frames()) {
-    SendFullAddressInfoToListener(libunwindstack_frame);
+    SendFullAddressInfoToListener(libunwindstack_frame, listener);
     callstack->add_pcs(libunwindstack_frame.pc);
   }
 
   ORBIT_CHECK(!callstack->pcs().empty());
-  listener_->OnCallstackSample(std::move(sample));
+  listener->OnCallstackSample(std::move(sample));
 }
 
 [[nodiscard]] orbit_grpc_protos::Callstack::CallstackType
@@ -580,6 +634,20 @@ FindExecutableAddressRangeForSameFileFromFirstMapInfo(
   return {min_exec_map_start, max_exec_map_end};
 }
 
+static bool RangeOverlapsOrTouchesExecutableMap(const unwindstack::Maps& maps, uint64_t start,
+                                                uint64_t end) {
+  // The maps are sorted and don't overlap, so their ends are sorted too.
+  auto map_info_it =
+      std::lower_bound(maps.begin(), maps.end(), start,
+                       [](const std::shared_ptr<unwindstack::MapInfo>& map_info, uint64_t address) {
+                         return map_info->end() < address;
+                       });
+  for (; map_info_it != maps.end() && (*map_info_it)->start() <= end; ++map_info_it) {
+    if (((*map_info_it)->flags() & PROT_EXEC) != 0) return true;
+  }
+  return false;
+}
+
 // We use PERF_RECORD_MMAP events to keep current_maps_ up to date, which is necessary for
 // unwinding.
 //
@@ -618,6 +686,27 @@ void UprobesUnwindingVisitor::Visit(uint64_t event_timestamp, const MmapPerfEven
   ORBIT_CHECK(listener_ != nullptr);
   ORBIT_CHECK(current_maps_ != nullptr);
 
+  // Non-executable mappings, which are much more frequent (e.g., allocations), can't change the
+  // result of unwinding a program counter that was already mapped, unless they replace or are next
+  // to an executable mapping, which can change how the module of an executable mapping is found.
+  const bool can_affect_unwinding =
+      event_data.executable ||
+      RangeOverlapsOrTouchesExecutableMap(*current_maps_->Get(), event_data.address,
+                                          event_data.address + event_data.length);
+  std::optional<absl::WriterMutexLock> current_maps_lock;
+  if (resequencing_listener_ != nullptr) {
+    if (can_affect_unwinding) {
+      // Stack samples being unwound on the thread pool need to see the maps without this mapping.
+      resequencing_listener_->WaitForAndSendAllEvents();
+    } else {
+      // Only wait for the stack samples that are using current_maps_ right now.
+      current_maps_lock.emplace(&current_maps_mutex_);
+    }
+  }
+  if (can_affect_unwinding) {
+    unwinder_->ClearCache();
+  }
+
   // PERF_RECORD_MMAP events do not contain the flags, but only distinguish between executable and
   // non-executable. This is all we need, so simply assume PROT_READ | PROT_EXEC for executable
   // mappings and PROT_READ for non-executable mappings. If we wanted the exact flags, we could
@@ -7,10 +7,12 @@
 
 #include <absl/container/flat_hash_map.h>
 #include <absl/container/flat_hash_set.h>
+#include <absl/synchronization/mutex.h>
 #include <sys/types.h>
 
 #include <atomic>
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <tuple>
 #include <utility>
@@ -23,9 +25,11 @@
 #include "LinuxTracing/TracerListener.h"
 #include "LinuxTracing/UserSpaceInstrumentationAddresses.h"
 #include "OrbitBase/Logging.h"
+#include "OrbitBase/ThreadPool.h"
 #include "PerfEvent.h"
 #include "PerfEventRecords.h"
 #include "PerfEventVisitor.h"
+#include "ResequencingTracerListener.h"
 #include "UprobesFunctionCallManager.h"
 #include "UprobesReturnAddressManager.h"
 
@@ -43,6 +47,7 @@ namespace orbit_linux_tracing {
 // addresses before they are hijacked, and patches them into the time-based stack samples. Such
 // return addresses can be retrieved by getting the eight bytes at the top of the stack when
 // entering a dynamically instrumented function (e.g., when hitting uprobes).
+// Stack samples can optionally be unwound on a thread pool, see SetUnwindingThreadPool.
 class UprobesUnwindingVisitor : public PerfEventVisitor {
  public:
   explicit UprobesUnwindingVisitor(
@@ -81,6 +86,23 @@ class UprobesUnwindingVisitor : public PerfEventVisitor {
     samples_in_uretprobes_counter_ = samples_in_uretprobes_counter;
   }
 
+  // When a thread pool is set, the DWARF unwinding of stack samples happens on that thread pool
+  // instead of inline in Visit. Everything else, including patching the return addresses, still
+  // happens in Visit. The resulting FullCallstackSamples are sent through `resequencing_listener`,
+  // which needs to be the listener passed to the constructor, and should also be the listener of
+  // all other visitors, so that the order of the events is the same as with inline unwinding.
+  // Executable mappings are only added when all pending unwinding has completed, so that every
+  // sample is unwound with the executable mappings as they were at the time of the sample. Other
+  // mappings, which can't affect unwinding, are added while samples are being unwound. At most
+  // kMaxStackSamplesBeingUnwound samples are pending at any time: when unwinding falls behind,
+  // Visit blocks until the oldest samples have been sent.
+  void SetUnwindingThreadPool(orbit_base::ThreadPool* unwinding_thread_pool,
+                              ResequencingTracerListener* resequencing_listener) {
+    ORBIT_CHECK(resequencing_listener == listener_);
+    unwinding_thread_pool_ = unwinding_thread_pool;
+    resequencing_listener_ = resequencing_listener;
+  }
+
   void Visit(uint64_t event_timestamp, const StackSamplePerfEventData& event_data) override;
   void Visit(uint64_t event_timestamp, const CallchainSamplePerfEventData& event_data) override;
   void Visit(uint64_t event_timestamp, const UprobesPerfEventData& event_data) override;
@@ -97,11 +119,12 @@ class UprobesUnwindingVisitor : public PerfEventVisitor {
   void Visit(uint64_t event_timestamp, const MmapPerfEventData& event_data) override;
 
  private:
-  // This struct holds a copy of some stack data collected from the target process.
+  // This struct holds a copy of some stack data collected from the target process. The data is
+  // shared with the stack samples being unwound on the thread pool.
   struct StackSlice {
     uint64_t start_address;
     uint64_t size;
-    std::unique_ptr<char[]> data;
+    std::shared_ptr<char[]> data;
   };
 
   void OnUprobes(uint64_t timestamp_ns, pid_t tid, uint32_t cpu, uint64_t sp, uint64_t ip,
@@ -110,12 +133,16 @@ class UprobesUnwindingVisitor : public PerfEventVisitor {
                  uint64_t function_id);
   void OnUretprobes(uint64_t timestamp_ns, pid_t pid, pid_t tid, std::optional<uint64_t> ax);
 
+  void SendStackSample(uint64_t timestamp_ns, pid_t pid, pid_t tid,
+                       const LibunwindstackResult& libunwindstack_result, TracerListener* listener);
+
   [[nodiscard]] orbit_grpc_protos::Callstack::CallstackType ComputeCallstackTypeFromStackSample(
       const LibunwindstackResult& libunwindstack_result);
   [[nodiscard]] orbit_grpc_protos::Callstack::CallstackType
   ComputeCallstackTypeFromCallchainAndPatch(const CallchainSamplePerfEventData& event_data);
 
-  void SendFullAddressInfoToListener(const unwindstack::FrameData& libunwindstack_frame);
+  void SendFullAddressInfoToListener(const unwindstack::FrameData& libunwindstack_frame,
+                                     TracerListener* listener);
 
   TracerListener* listener_;
 
@@ -138,6 +165,14 @@ class UprobesUnwindingVisitor : public PerfEventVisitor {
 
   absl::flat_hash_map<pid_t, absl::flat_hash_map<uint64_t, StackSlice>>
       thread_id_stream_id_to_stack_slices_{};
+
+  // Each pending stack sample holds a copy of the stack of up to 64 KB.
+  static constexpr size_t kMaxStackSamplesBeingUnwound = 512;
+  orbit_base::ThreadPool* unwinding_thread_pool_ = nullptr;
+  ResequencingTracerListener* resequencing_listener_ = nullptr;
+  // Held in reader mode by the tasks unwinding on unwinding_thread_pool_ while they use
+  // current_maps_, and in writer mode while non-executable mappings are added to current_maps_.
+  absl::Mutex current_maps_mutex_;
 };
 
 }  // namespace orbit_linux_tracing
@@ -42,6 +42,7 @@ class UprobesUnwindingVisitorMmapTest : public ::testing::Test {
 
   MockTracerListener listener_;
   MockLibunwindstackMaps maps_;
+  MockLibunwindstackUnwinder unwinder_;
   UprobesUnwindingVisitor visitor_{&listener_,
                                    &function_call_manager_,
                                    &return_address_manager_,
@@ -56,7 +57,6 @@ class UprobesUnwindingVisitorMmapTest : public ::testing::Test {
   MockUprobesReturnAddressManager return_address_manager_{
       /*user_space_instrumentation_addresses=*/nullptr};
   std::unique_ptr<LibunwindstackMaps> real_maps_ = LibunwindstackMaps::ParseMaps("");
-  MockLibunwindstackUnwinder unwinder_;
   MockLeafFunctionCallManager leaf_function_call_manager_{128};
 };
 
@@ -212,6 +212,41 @@ TEST_F(UprobesUnwindingVisitorMmapTest,
   PerfEvent(std::move(bad_file_mmap_event)).Accept(&visitor_);
 }
 
+TEST_F(UprobesUnwindingVisitorMmapTest, VisitMmapPerfEventClearsUnwindCacheForExecutableMappings) {
+  MmapPerfEvent anon_mmap_data_event{
+      .timestamp = 1,
+      .data =
+          {
+              .address = 0x7f4b0c7ab000,
+              .length = 0x1000,
+              .page_offset = 0,
+              .filename = "",
+              .executable = false,
+              .pid = kPid,
+          },
+  };
+  EXPECT_CALL(maps_, AddAndSort).Times(1);
+  EXPECT_CALL(unwinder_, ClearCache).Times(0);
+  PerfEvent(std::move(anon_mmap_data_event)).Accept(&visitor_);
+  ::testing::Mock::VerifyAndClearExpectations(&unwinder_);
+
+  MmapPerfEvent special_mmap_event{
+      .timestamp = 2,
+      .data =
+          {
+              .address = 0x7fffffffe000,
+              .length = 0x1000,
+              .page_offset = 0,
+              .filename = "[uprobes]",
+              .executable = true,
+              .pid = kPid,
+          },
+  };
+  EXPECT_CALL(maps_, AddAndSort).Times(1);
+  EXPECT_CALL(unwinder_, ClearCache).Times(1);
+  PerfEvent(std::move(special_mmap_event)).Accept(&visitor_);
+}
+
 TEST_F(UprobesUnwindingVisitorMmapTest,
        VisitMmapPerfEventSendsModuleUpdatesForElfWithTextSplitAcrossTwoMaps) {
   const std::string test_binary_path = (orbit_test::GetTestdataDir() / "target_fp").string();
@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <absl/time/time.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <sys/mman.h>
@@ -11,8 +12,10 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -21,8 +24,11 @@
 #include "LibunwindstackUnwinder.h"
 #include "MockTracerListener.h"
 #include "OrbitBase/Logging.h"
+#include "OrbitBase/ThreadPool.h"
 #include "PerfEvent.h"
+#include "PerfEventBufferPool.h"
 #include "PerfEventRecords.h"
+#include "ResequencingTracerListener.h"
 #include "Test/Path.h"
 #include "UprobesFunctionCallManager.h"
 #include "UprobesReturnAddressManager.h"
@@ -206,17 +212,20 @@ class UprobesUnwindingVisitorSampleTest : public ::testing::Test {
 
 StackSamplePerfEvent BuildFakeStackSamplePerfEvent() {
   constexpr uint64_t kStackSize = 13;
-  return StackSamplePerfEvent{
+  StackSamplePerfEvent event{
       .timestamp = 15,
       .data =
           {
               .pid = 10,
               .tid = 11,
-              .regs = std::make_unique<perf_event_sample_regs_user_all>(),
+              .regs = MakeUniqueForOverwriteFromPool<perf_event_sample_regs_user_all>(nullptr),
               .dyn_size = kStackSize,
-              .data = std::make_unique<char[]>(kStackSize),
+              .data = MakeUniqueForOverwriteFromPool<char[]>(nullptr, kStackSize),
           },
   };
+  *event.data.regs = {};
+  std::fill_n(event.data.data.get(), kStackSize, 0);
+  return event;
 }
 
 CallchainSamplePerfEvent BuildFakeCallchainSamplePerfEvent(const std::vector<uint64_t>& callchain) {
@@ -227,10 +236,12 @@ CallchainSamplePerfEvent BuildFakeCallchainSamplePerfEvent(const std::vector<uin
           {
               .pid = 10,
               .tid = 11,
-              .regs = std::make_unique<perf_event_sample_regs_user_all>(),
-              .data = std::make_unique<char[]>(kStackSize),
+              .regs = MakeUniqueForOverwriteFromPool<perf_event_sample_regs_user_all>(nullptr),
+              .data = MakeUniqueForOverwriteFromPool<char[]>(nullptr, kStackSize),
           },
   };
+  *event.data.regs = {};
+  std::fill_n(event.data.data.get(), kStackSize, 0);
   event.data.SetIps(callchain);
   return event;
 }
@@ -1393,6 +1404,227 @@ TEST_F(UprobesUnwindingVisitorSampleTest, VisitStackSampleUsesUserStackMemoryFro
   EXPECT_EQ(discarded_samples_in_uretprobes_counter, 0);
 }
 
+TEST_F(UprobesUnwindingVisitorSampleTest,
+       VisitStackSamplesWithThreadPoolSendsCallstacksInOrderOfSamples) {
+  std::shared_ptr<orbit_base::ThreadPool> thread_pool =
+      orbit_base::ThreadPool::Create(4, 4, absl::Seconds(1));
+  ResequencingTracerListener resequencing_listener{&listener_};
+  UprobesUnwindingVisitor visitor{&resequencing_listener,
+                                  &function_call_manager_,
+                                  &return_address_manager_,
+                                  &maps_,
+                                  &unwinder_,
+                                  &leaf_function_call_manager_,
+                                  &user_space_instrumentation_addresses_,
+                                  &absolute_address_to_size_of_functions_to_stop_at_};
+  visitor.SetUnwindingThreadPool(thread_pool.get(), &resequencing_listener);
+
+  constexpr int kSampleCount = 4;
+  std::vector<StackSamplePerfEvent> events;
+  for (int i = 0; i < kSampleCount; ++i) {
+    StackSamplePerfEvent event = BuildFakeStackSamplePerfEvent();
+    event.timestamp = 100 + i;
+    event.data.pid = 10 + i;
+    events.push_back(std::move(event));
+  }
+
+  EXPECT_CALL(return_address_manager_, PatchSample).Times(kSampleCount).WillRepeatedly(Return());
+  EXPECT_CALL(maps_, Get).Times(kSampleCount).WillRepeatedly(Return(nullptr));
+
+  // The first sample takes the longest to unwind, so that the later ones finish first.
+  EXPECT_CALL(unwinder_, Unwind(events[0].data.pid, nullptr, _, _, _, _))
+      .Times(1)
+      .WillOnce([](auto&&...) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        return LibunwindstackResult{{kFrame1, kFrame3}, {}, unwindstack::ErrorCode::ERROR_NONE};
+      });
+  EXPECT_CALL(unwinder_, Unwind(events[1].data.pid, nullptr, _, _, _, _))
+      .Times(1)
+      .WillOnce(Return(LibunwindstackResult{{kFrame1, kFrame2}, {}, unwindstack::ERROR_NONE}));
+  EXPECT_CALL(unwinder_, Unwind(events[2].data.pid, nullptr, _, _, _, _))
+      .Times(1)
+      .WillOnce(Return(LibunwindstackResult{{kFrame2, kFrame3}, {}, unwindstack::ERROR_NONE}));
+  EXPECT_CALL(unwinder_, Unwind(events[3].data.pid, nullptr, _, _, _, _))
+      .Times(1)
+      .WillOnce(Return(LibunwindstackResult{{kFrame3, kFrame1}, {}, unwindstack::ERROR_NONE}));
+
+  std::vector<orbit_grpc_protos::FullCallstackSample> actual_callstack_samples;
+  auto save_callstack =
+      [&actual_callstack_samples](orbit_grpc_protos::FullCallstackSample actual_callstack_sample) {
+        actual_callstack_samples.push_back(std::move(actual_callstack_sample));
+      };
+  EXPECT_CALL(listener_, OnCallstackSample)
+      .Times(kSampleCount)
+      .WillRepeatedly(Invoke(save_callstack));
+  EXPECT_CALL(listener_, OnAddressInfo).Times(3);
+
+  std::atomic<uint64_t> unwinding_errors = 0;
+  std::atomic<uint64_t> discarded_samples_in_uretprobes_counter = 0;
+  visitor.SetUnwindErrorsAndDiscardedSamplesCounters(&unwinding_errors,
+                                                     &discarded_samples_in_uretprobes_counter);
+
+  for (StackSamplePerfEvent& event : events) {
+    PerfEvent{std::move(event)}.Accept(&visitor);
+  }
+  resequencing_listener.WaitForAndSendAllEvents();
+  thread_pool->ShutdownAndWait();
+
+  ASSERT_EQ(actual_callstack_samples.size(), kSampleCount);
+  for (int i = 0; i < kSampleCount; ++i) {
+    EXPECT_EQ(actual_callstack_samples[i].timestamp_ns(), 100 + i);
+    EXPECT_EQ(actual_callstack_samples[i].pid(), 10 + i);
+    EXPECT_EQ(actual_callstack_samples[i].callstack().type(),
+              orbit_grpc_protos::Callstack::kComplete);
+  }
+  EXPECT_THAT(actual_callstack_samples[0].callstack().pcs(),
+              ElementsAre(kTargetAddress1, kTargetAddress3));
+  EXPECT_THAT(actual_callstack_samples[1].callstack().pcs(),
+              ElementsAre(kTargetAddress1, kTargetAddress2));
+  EXPECT_THAT(actual_callstack_samples[2].callstack().pcs(),
+              ElementsAre(kTargetAddress2, kTargetAddress3));
+  EXPECT_THAT(actual_callstack_samples[3].callstack().pcs(),
+              ElementsAre(kTargetAddress3, kTargetAddress1));
+
+  EXPECT_EQ(unwinding_errors, 0);
+  EXPECT_EQ(discarded_samples_in_uretprobes_counter, 0);
+}
+
+TEST_F(UprobesUnwindingVisitorSampleTest,
+       VisitMmapWithThreadPoolOnlyWaitsForPendingSamplesForExecutableMappings) {
+  std::shared_ptr<orbit_base::ThreadPool> thread_pool =
+      orbit_base::ThreadPool::Create(1, 1, absl::Seconds(1));
+  ResequencingTracerListener resequencing_listener{&listener_};
+  UprobesUnwindingVisitor visitor{&resequencing_listener,
+                                  &function_call_manager_,
+                                  &return_address_manager_,
+                                  &maps_,
+                                  &unwinder_,
+                                  &leaf_function_call_manager_,
+                                  &user_space_instrumentation_addresses_,
+                                  &absolute_address_to_size_of_functions_to_stop_at_};
+  visitor.SetUnwindingThreadPool(thread_pool.get(), &resequencing_listener);
+
+  std::unique_ptr<LibunwindstackMaps> real_maps = LibunwindstackMaps::ParseMaps("");
+  EXPECT_CALL(maps_, Get).WillRepeatedly(Return(real_maps->Get()));
+  EXPECT_CALL(maps_, AddAndSort)
+      .Times(2)
+      .WillRepeatedly([&real_maps](uint64_t start, uint64_t end, uint64_t offset, uint64_t flags,
+                                   const std::string& name) {
+        real_maps->AddAndSort(start, end, offset, flags, name);
+      });
+  EXPECT_CALL(return_address_manager_, PatchSample).Times(1).WillOnce(Return());
+  EXPECT_CALL(unwinder_, Unwind).Times(1).WillOnce([](auto&&...) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    return LibunwindstackResult{{kFrame1, kFrame2}, {}, unwindstack::ErrorCode::ERROR_NONE};
+  });
+  // Only for the executable mapping.
+  EXPECT_CALL(unwinder_, ClearCache).Times(1);
+
+  StackSamplePerfEvent sample_event = BuildFakeStackSamplePerfEvent();
+  sample_event.timestamp = 100;
+  PerfEvent{std::move(sample_event)}.Accept(&visitor);
+  EXPECT_EQ(resequencing_listener.GetReservationCount(), 1);
+
+  MmapPerfEvent data_mmap_event{
+      .timestamp = 101,
+      .data =
+          {
+              .address = 0x7f4b0c7ab000,
+              .length = 0x1000,
+              .page_offset = 0,
+              .filename = "",
+              .executable = false,
+              .pid = 10,
+          },
+  };
+  EXPECT_CALL(listener_, OnCallstackSample).Times(0);
+  EXPECT_CALL(listener_, OnAddressInfo).Times(0);
+  PerfEvent{std::move(data_mmap_event)}.Accept(&visitor);
+  EXPECT_EQ(resequencing_listener.GetReservationCount(), 1);
+  ::testing::Mock::VerifyAndClearExpectations(&listener_);
+
+  MmapPerfEvent uprobes_mmap_event{
+      .timestamp = 102,
+      .data =
+          {
+              .address = 0x7fffffffe000,
+              .length = 0x1000,
+              .page_offset = 0,
+              .filename = "[uprobes]",
+              .executable = true,
+              .pid = 10,
+          },
+  };
+  EXPECT_CALL(listener_, OnCallstackSample).Times(1);
+  EXPECT_CALL(listener_, OnAddressInfo).Times(2);
+  PerfEvent{std::move(uprobes_mmap_event)}.Accept(&visitor);
+  EXPECT_EQ(resequencing_listener.GetReservationCount(), 0);
+
+  thread_pool->ShutdownAndWait();
+}
+
+// Stack samples per second for several sizes of the unwinding thread pool, 0 meaning that the
+// samples are unwound inline. The unwinder is replaced by a busy wait of fixed length, so this
+// measures how the pipeline scales rather than how fast libunwindstack is. Disabled by default,
+// as it only logs the results.
+TEST_F(UprobesUnwindingVisitorSampleTest, DISABLED_BenchmarkVisitStackSamplesWithThreadPoolSizes) {
+  constexpr int kSampleCount = 20'000;
+  constexpr std::chrono::microseconds kUnwindingDuration{50};
+
+  EXPECT_CALL(return_address_manager_, PatchSample).WillRepeatedly(Return());
+  EXPECT_CALL(maps_, Get).WillRepeatedly(Return(nullptr));
+  EXPECT_CALL(unwinder_, Unwind).WillRepeatedly([&](auto&&...) {
+    const auto end = std::chrono::steady_clock::now() + kUnwindingDuration;
+    while (std::chrono::steady_clock::now() < end) {
+    }
+    return LibunwindstackResult{{kFrame1, kFrame2, kFrame3}, {}, unwindstack::ERROR_NONE};
+  });
+  EXPECT_CALL(listener_, OnCallstackSample).WillRepeatedly(Return());
+  EXPECT_CALL(listener_, OnAddressInfo).WillRepeatedly(Return());
+
+  for (size_t thread_count : {0, 1, 2, 4, 8}) {
+    std::vector<StackSamplePerfEvent> events;
+    for (int i = 0; i < kSampleCount; ++i) {
+      StackSamplePerfEvent event = BuildFakeStackSamplePerfEvent();
+      event.timestamp = 100 + i;
+      events.push_back(std::move(event));
+    }
+
+    std::shared_ptr<orbit_base::ThreadPool> thread_pool =
+        thread_count > 0 ? orbit_base::ThreadPool::Create(thread_count, thread_count,
+                                                          absl::Seconds(1))
+                         : nullptr;
+    ResequencingTracerListener resequencing_listener{&listener_};
+    UprobesUnwindingVisitor visitor{&resequencing_listener,
+                                    &function_call_manager_,
+                                    &return_address_manager_,
+                                    &maps_,
+                                    &unwinder_,
+                                    &leaf_function_call_manager_,
+                                    &user_space_instrumentation_addresses_,
+                                    &absolute_address_to_size_of_functions_to_stop_at_};
+    if (thread_pool != nullptr) {
+      visitor.SetUnwindingThreadPool(thread_pool.get(), &resequencing_listener);
+    }
+    std::atomic<uint64_t> unwinding_errors = 0;
+    std::atomic<uint64_t> discarded_samples_in_uretprobes_counter = 0;
+    visitor.SetUnwindErrorsAndDiscardedSamplesCounters(&unwinding_errors,
+                                                       &discarded_samples_in_uretprobes_counter);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (StackSamplePerfEvent& event : events) {
+      PerfEvent{std::move(event)}.Accept(&visitor);
+    }
+    resequencing_listener.WaitForAndSendAllEvents();
+    const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+    if (thread_pool != nullptr) thread_pool->ShutdownAndWait();
+
+    EXPECT_EQ(unwinding_errors, 0);
+    ORBIT_LOG("%zu unwinding threads: %.0f samples/s", thread_count,
+              kSampleCount / duration.count());
+  }
+}
+
 //------------------------------------//
 // Visit CallchainSamplePerfEventData //
 //------------------------------------//
@@ -36,6 +36,8 @@ class MockLibunwindstackUnwinder : public LibunwindstackUnwinder {
               (override));
   MOCK_METHOD(std::optional<bool>, HasFramePointerSet, (uint64_t, pid_t, unwindstack::Maps*),
               (override));
+  MOCK_METHOD(void, ClearCache, (), (override));
+  MOCK_METHOD(Stats, GetAndResetStats, (), (override));
 };
 
 class MockUprobesReturnAddressManager : public UprobesReturnAddressManager {
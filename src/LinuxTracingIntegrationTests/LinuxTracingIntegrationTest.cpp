@@ -786,10 +786,9 @@ TEST(LinuxTracingIntegrationTest, CallstackSamplesAndAddressInfos) {
       inner_function_virtual_address_range, samples_per_second, &address_infos_received);
 }
 
-TEST(LinuxTracingIntegrationTest, CallstackSamplesTogetherWithFunctionCalls) {
-  if (!CheckIsRunningAsRoot()) {
-    GTEST_SKIP();
-  }
+void TraceAndVerifyCallstackSamplesTogetherWithFunctionCalls(
+    orbit_grpc_protos::CaptureOptions::RingBufferWaitMethod ring_buffer_wait_method,
+    uint32_t ring_buffer_reader_thread_count, uint32_t stack_unwinding_thread_count) {
   LinuxTracingIntegrationTestFixture fixture;
 
   const auto& [outer_function_virtual_address_range, inner_function_virtual_address_range] =
@@ -798,6 +797,9 @@ TEST(LinuxTracingIntegrationTest, CallstackSamplesTogetherWithFunctionCalls) {
       GetExecutableBinaryPath(fixture.GetPuppetPidNative());
 
   orbit_grpc_protos::CaptureOptions capture_options = fixture.BuildDefaultCaptureOptions();
+  capture_options.set_ring_buffer_wait_method(ring_buffer_wait_method);
+  capture_options.set_ring_buffer_reader_thread_count(ring_buffer_reader_thread_count);
+  capture_options.set_stack_unwinding_thread_count(stack_unwinding_thread_count);
   constexpr uint64_t kOuterFunctionId = 1;
   constexpr uint64_t kInnerFunctionId = 2;
   AddPuppetOuterAndInnerFunctionToCaptureOptions(&capture_options, fixture.GetPuppetPidNative(),
@@ -826,6 +828,46 @@ TEST(LinuxTracingIntegrationTest, CallstackSamplesTogetherWithFunctionCalls) {
       inner_function_virtual_address_range, sampling_rate, &address_infos_received);
 }
 
+TEST(LinuxTracingIntegrationTest, CallstackSamplesTogetherWithFunctionCalls) {
+  if (!CheckIsRunningAsRoot()) {
+    GTEST_SKIP();
+  }
+  TraceAndVerifyCallstackSamplesTogetherWithFunctionCalls(
+      orbit_grpc_protos::CaptureOptions::kSleepAndPoll, /*ring_buffer_reader_thread_count=*/1,
+      /*stack_unwinding_thread_count=*/0);
+}
+
+TEST(LinuxTracingIntegrationTest, CallstackSamplesTogetherWithFunctionCallsWithEpollWakeups) {
+  if (!CheckIsRunningAsRoot()) {
+    GTEST_SKIP();
+  }
+  TraceAndVerifyCallstackSamplesTogetherWithFunctionCalls(
+      orbit_grpc_protos::CaptureOptions::kEpollWithWakeupWatermark,
+      /*ring_buffer_reader_thread_count=*/1, /*stack_unwinding_thread_count=*/0);
+}
+
+TEST(LinuxTracingIntegrationTest,
+     CallstackSamplesTogetherWithFunctionCallsWithMultipleRingBufferReaders) {
+  if (!CheckIsRunningAsRoot()) {
+    GTEST_SKIP();
+  }
+  TraceAndVerifyCallstackSamplesTogetherWithFunctionCalls(
+      orbit_grpc_protos::CaptureOptions::kSleepAndPoll, /*ring_buffer_reader_thread_count=*/4,
+      /*stack_unwinding_thread_count=*/0);
+  TraceAndVerifyCallstackSamplesTogetherWithFunctionCalls(
+      orbit_grpc_protos::CaptureOptions::kEpollWithWakeupWatermark,
+      /*ring_buffer_reader_thread_count=*/4, /*stack_unwinding_thread_count=*/0);
+}
+
+TEST(LinuxTracingIntegrationTest, CallstackSamplesTogetherWithFunctionCallsWithUnwindingThreads) {
+  if (!CheckIsRunningAsRoot()) {
+    GTEST_SKIP();
+  }
+  TraceAndVerifyCallstackSamplesTogetherWithFunctionCalls(
+      orbit_grpc_protos::CaptureOptions::kSleepAndPoll, /*ring_buffer_reader_thread_count=*/1,
+      /*stack_unwinding_thread_count=*/4);
+}
+
 void VerifyNoAddressInfos(const std::vector<orbit_grpc_protos::ProducerCaptureEvent>& events) {
   for (const auto& event : events) {
     EXPECT_NE(event.event_case(), orbit_grpc_protos::ProducerCaptureEvent::kFullAddressInfo);
@@ -8,6 +8,7 @@
 
 #include "ClientData/ScopeId.h"
 #include "ClientData/ScopeInfo.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "GrpcProtos/capture.pb.h"
 #include "MizarData/FrameTrack.h"
@@ -16,7 +17,7 @@
 
 using ::orbit_client_data::ScopeId;
 using ::orbit_client_data::ScopeInfo;
-using ::orbit_client_protos::TimerInfo;
+using ::orbit_client_data::TimerInfo;
 using ::orbit_grpc_protos::PresentEvent;
 using ::orbit_test_utils::MakeMap;
 using ::testing::ElementsAreArray;
@@ -65,9 +66,9 @@ static std::vector<TimerInfo> ToTimerInfos(const std::vector<FrameStartNs>& star
   std::vector<TimerInfo> result;
   std::transform(std::begin(starts), std::end(starts), std::back_inserter(result),
                  [](FrameStartNs start) {
-                   TimerInfo timer;
+                   orbit_client_protos::TimerInfo timer;
                    timer.set_start(*start);
-                   return timer;
+                   return TimerInfo{timer};
                  });
   return result;
 }
@@ -18,6 +18,7 @@
 #include "ClientData/ScopeId.h"
 #include "ClientData/ScopeInfo.h"
 #include "ClientData/ThreadTrackDataProvider.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientSymbols/QSettingsBasedStorageManager.h"
 #include "GrpcProtos/symbol.pb.h"
 #include "OrbitBase/Result.h"
@@ -49,7 +50,8 @@ void MizarData::OnCaptureStarted(const orbit_grpc_protos::CaptureStarted& captur
   module_manager_ = std::make_unique<orbit_client_data::ModuleManager>();
 }
 
-void MizarData::OnTimer(const orbit_client_protos::TimerInfo& timer_info) {
+void MizarData::OnTimer(const orbit_client_protos::TimerInfo& timer_info_proto) {
+  const orbit_client_data::TimerInfo timer_info{timer_info_proto};
   const std::optional<ScopeId> scope_id = GetCaptureData().ProvideScopeId(timer_info);
   if (!scope_id.has_value()) return;
 
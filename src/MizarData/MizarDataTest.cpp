@@ -19,6 +19,7 @@
 #include "ClientData/CallstackInfo.h"
 #include "ClientData/LinuxAddressInfo.h"
 #include "ClientData/ScopeInfo.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "GrpcProtos/capture.pb.h"
 #include "MizarData/MizarData.h"
@@ -37,6 +38,7 @@ class MockMizarData : public orbit_mizar_data::MizarData {
 namespace orbit_mizar_data {
 
 using google::protobuf::util::MessageDifferencer;
+using orbit_client_protos::TimerInfo;
 
 constexpr size_t kTimersNum = 5;
 constexpr std::array<uint64_t, kTimersNum> kStarts{10, 20, 30, 40, 50};
@@ -120,11 +122,12 @@ TEST(MizarDataTest, OnTimerAddsDAndMSAndOnlyThem) {
   }
   data.OnCaptureFinished({});
 
-  std::vector<const TimerInfo*> stored_timers_ptrs =
+  std::vector<const orbit_client_data::TimerInfo*> stored_timers_ptrs =
       data.GetCaptureData().GetAllScopeTimers(kStoredScopeTypes);
   std::vector<TimerInfo> stored_timers;
   std::transform(std::begin(stored_timers_ptrs), std::end(stored_timers_ptrs),
-                 std::back_inserter(stored_timers), [](const TimerInfo* ptr) { return (*ptr); });
+                 std::back_inserter(stored_timers),
+                 [](const orbit_client_data::TimerInfo* ptr) { return ptr->ToProto(); });
 
   EXPECT_THAT(stored_timers, UnorderedPointwise(TimerInfosEq(), kTimersToStore));
 }
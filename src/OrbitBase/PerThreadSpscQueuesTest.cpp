@@ -0,0 +1,153 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "OrbitBase/PerThreadSpscQueues.h"
+
+namespace orbit_base {
+
+namespace {
+
+// Dequeues until `expected_count` events were received, or until nothing more is coming.
+template <typename T>
+std::vector<T> DequeueAll(PerThreadSpscQueues<T>* queues, size_t expected_count,
+                          size_t max_event_count_per_call = 7) {
+  std::vector<T> events;
+  std::vector<T> buffer(max_event_count_per_call);
+  size_t calls_without_events = 0;
+  while (events.size() < expected_count && calls_without_events < 1000) {
+    const size_t count = queues->DequeueBulk(buffer.data(), buffer.size());
+    if (count == 0) {
+      ++calls_without_events;
+      std::this_thread::yield();
+    } else {
+      calls_without_events = 0;
+    }
+    std::move(buffer.begin(), buffer.begin() + count, std::back_inserter(events));
+  }
+  return events;
+}
+
+}  // namespace
+
+TEST(PerThreadSpscQueues, DequeuesEventsOfOneThreadInOrder) {
+  // A small capacity makes the queue chain several rings.
+  PerThreadSpscQueues<int> queues{4};
+  std::vector<int> expected_events;
+  for (int i = 0; i < 100; ++i) {
+    queues.Enqueue(i);
+    expected_events.push_back(i);
+  }
+  EXPECT_EQ(DequeueAll(&queues, expected_events.size()), expected_events);
+
+  int event = 0;
+  EXPECT_EQ(queues.DequeueBulk(&event, 1), 0);
+  queues.Enqueue(100);
+  EXPECT_EQ(queues.DequeueBulk(&event, 1), 1);
+  EXPECT_EQ(event, 100);
+}
+
+TEST(PerThreadSpscQueues, KeepsWorkingAfterReleasingUnusedMemory) {
+  PerThreadSpscQueues<int> queues{4};
+  std::vector<int> expected_events;
+  for (int i = 0; i < 100; ++i) {
+    queues.Enqueue(i);
+    expected_events.push_back(i);
+  }
+  EXPECT_EQ(DequeueAll(&queues, expected_events.size()), expected_events);
+  queues.ReleaseUnusedMemory();
+
+  expected_events.clear();
+  for (int i = 100; i < 200; ++i) {
+    queues.Enqueue(i);
+    expected_events.push_back(i);
+  }
+  EXPECT_EQ(DequeueAll(&queues, expected_events.size()), expected_events);
+  queues.ReleaseUnusedMemory();
+}
+
+TEST(PerThreadSpscQueues, MovesEvents) {
+  PerThreadSpscQueues<std::unique_ptr<int>> queues{2};
+  for (int i = 0; i < 5; ++i) {
+    queues.Enqueue(std::make_unique<int>(i));
+  }
+  std::vector<std::unique_ptr<int>> events = DequeueAll(&queues, 5);
+  ASSERT_EQ(events.size(), 5);
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(*events[i], i);
+  }
+}
+
+TEST(PerThreadSpscQueues, InstancesAreIndependent) {
+  PerThreadSpscQueues<std::string> queues1;
+  auto queues2 = std::make_unique<PerThreadSpscQueues<std::string>>();
+  queues1.Enqueue("a");
+  queues2->Enqueue("b");
+  queues1.Enqueue("c");
+  EXPECT_THAT(DequeueAll(queues2.get(), 1), testing::ElementsAre("b"));
+  queues2.reset();
+
+  PerThreadSpscQueues<std::string> queues3;
+  queues3.Enqueue("d");
+  EXPECT_THAT(DequeueAll(&queues1, 2), testing::ElementsAre("a", "c"));
+  EXPECT_THAT(DequeueAll(&queues3, 1), testing::ElementsAre("d"));
+}
+
+TEST(PerThreadSpscQueues, DequeuesEventsOfEachThreadInOrder) {
+  constexpr uint64_t kThreadCount = 8;
+  constexpr uint64_t kEventsPerThread = 100'000;
+  PerThreadSpscQueues<std::pair<uint64_t, uint64_t>> queues{16};
+
+  std::vector<std::thread> producers;
+  for (uint64_t thread_index = 0; thread_index < kThreadCount; ++thread_index) {
+    producers.emplace_back([&queues, thread_index] {
+      for (uint64_t i = 0; i < kEventsPerThread; ++i) {
+        queues.Enqueue(std::make_pair(thread_index, i));
+      }
+    });
+  }
+
+  // Dequeue while the producers are still running, and after some of them have exited.
+  std::vector<std::pair<uint64_t, uint64_t>> events =
+      DequeueAll(&queues, kThreadCount * kEventsPerThread, 1000);
+  for (std::thread& producer : producers) {
+    producer.join();
+  }
+
+  ASSERT_EQ(events.size(), kThreadCount * kEventsPerThread);
+  std::vector<uint64_t> next_event_per_thread(kThreadCount, 0);
+  for (const auto& [thread_index, i] : events) {
+    EXPECT_EQ(i, next_event_per_thread[thread_index]);
+    next_event_per_thread[thread_index] = i + 1;
+  }
+
+  std::pair<uint64_t, uint64_t> event;
+  EXPECT_EQ(queues.DequeueBulk(&event, 1), 0);
+}
+
+TEST(PerThreadSpscQueues, KeepsEventsOfExitedThreads) {
+  PerThreadSpscQueues<int> queues{2};
+  std::thread producer{[&queues] {
+    for (int i = 0; i < 10; ++i) {
+      queues.Enqueue(i);
+    }
+  }};
+  producer.join();
+
+  EXPECT_THAT(DequeueAll(&queues, 10), testing::ElementsAre(0, 1, 2, 3, 4, 5, 6, 7, 8, 9));
+  int event = 0;
+  EXPECT_EQ(queues.DequeueBulk(&event, 1), 0);
+}
+
+}  // namespace orbit_base
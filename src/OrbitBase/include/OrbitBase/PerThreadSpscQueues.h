@@ -0,0 +1,312 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ORBIT_BASE_PER_THREAD_SPSC_QUEUES_H_
+#define ORBIT_BASE_PER_THREAD_SPSC_QUEUES_H_
+
+#include <absl/base/thread_annotations.h>
+#include <absl/synchronization/mutex.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "OrbitBase/Logging.h"
+#include "OrbitBase/MakeUniqueForOverwrite.h"
+
+namespace orbit_base_internal {
+
+// Fixed-capacity ring buffer with a single producer and a single consumer. `capacity` must be a
+// power of two. Slots are default-initialized upfront, and events are moved in and out of them.
+template <typename T>
+class SpscRing {
+ public:
+  explicit SpscRing(size_t capacity)
+      : mask_{capacity - 1}, slots_{make_unique_for_overwrite<T[]>(capacity)} {
+    ORBIT_CHECK(capacity > 0 && (capacity & mask_) == 0);
+  }
+
+  [[nodiscard]] size_t GetCapacity() const { return mask_ + 1; }
+
+  // Makes an empty ring out of a drained one. Neither the producer nor the consumer must be using
+  // it.
+  void Reset() {
+    next.store(nullptr, std::memory_order_relaxed);
+    head_.store(0, std::memory_order_relaxed);
+    cached_tail_ = 0;
+    tail_.store(0, std::memory_order_relaxed);
+    cached_head_ = 0;
+  }
+
+  // Producer only.
+  template <typename U>
+  [[nodiscard]] bool TryPush(U&& event) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - cached_head_ > mask_) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (tail - cached_head_ > mask_) return false;
+    }
+    slots_[tail & mask_] = std::forward<U>(event);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer only.
+  [[nodiscard]] size_t PopBulk(T* events, size_t max_event_count) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (cached_tail_ - head < max_event_count) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+    }
+    const size_t count = std::min(cached_tail_ - head, max_event_count);
+    for (size_t i = 0; i < count; ++i) {
+      events[i] = std::move(slots_[(head + i) & mask_]);
+    }
+    head_.store(head + count, std::memory_order_release);
+    return count;
+  }
+
+  // Set by the producer once this ring is full and it moved on to `next`.
+  std::atomic<SpscRing*> next = nullptr;
+
+ private:
+  const size_t mask_;
+  const std::unique_ptr<T[]> slots_;
+
+  alignas(64) std::atomic<size_t> head_ = 0;
+  size_t cached_tail_ = 0;
+
+  alignas(64) std::atomic<size_t> tail_ = 0;
+  size_t cached_head_ = 0;
+};
+
+// Unbounded single-producer single-consumer queue. Events go to a fixed-capacity ring, and only
+// when that is full does the producer chain another one after it, so that the consumer still gets
+// the events in order. Producers must neither block nor drop events, hence a full ring can't just
+// reject them. The new ring is twice as large, up to kMaxRingCapacity, so that a thread that
+// produces a lot of events soon stops needing new rings. Rings beyond the one being produced into
+// only exist while the consumer falls behind. The consumer hands the last ring it drained back to
+// the producer, to avoid allocating and faulting in new memory at a steady rate, until
+// ReleaseSpareRing is called.
+template <typename T>
+class SpscQueue {
+ public:
+  static constexpr size_t kMaxRingCapacity = 4096;
+
+  explicit SpscQueue(size_t initial_capacity)
+      : head_ring_{new SpscRing<T>(initial_capacity)}, tail_ring_{head_ring_} {}
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  ~SpscQueue() {
+    while (head_ring_ != nullptr) {
+      delete std::exchange(head_ring_, head_ring_->next.load(std::memory_order_acquire));
+    }
+    delete spare_ring_.load(std::memory_order_acquire);
+  }
+
+  // Producer only.
+  template <typename U>
+  void Push(U&& event) {
+    if (tail_ring_->TryPush(std::forward<U>(event))) return;
+
+    const size_t new_capacity = std::min(2 * tail_ring_->GetCapacity(), kMaxRingCapacity);
+    SpscRing<T>* new_ring = spare_ring_.exchange(nullptr, std::memory_order_acquire);
+    if (new_ring != nullptr && new_ring->GetCapacity() < new_capacity) {
+      delete std::exchange(new_ring, nullptr);
+    }
+    if (new_ring == nullptr) new_ring = new SpscRing<T>(new_capacity);
+
+    ORBIT_CHECK(new_ring->TryPush(std::forward<U>(event)));
+    tail_ring_->next.store(new_ring, std::memory_order_release);
+    tail_ring_ = new_ring;
+  }
+
+  // Consumer only.
+  [[nodiscard]] size_t PopBulk(T* events, size_t max_event_count) {
+    size_t count = head_ring_->PopBulk(events, max_event_count);
+    while (count < max_event_count) {
+      SpscRing<T>* next_ring = head_ring_->next.load(std::memory_order_acquire);
+      if (next_ring == nullptr) break;
+      // The producer no longer pushes to head_ring_, but could have pushed more events to it after
+      // the previous PopBulk.
+      count += head_ring_->PopBulk(events + count, max_event_count - count);
+      if (count == max_event_count) break;
+      RecycleRing(std::exchange(head_ring_, next_ring));
+      count += head_ring_->PopBulk(events + count, max_event_count - count);
+    }
+    return count;
+  }
+
+  // Consumer only.
+  void ReleaseSpareRing() { delete spare_ring_.exchange(nullptr, std::memory_order_acq_rel); }
+
+ private:
+  void RecycleRing(SpscRing<T>* drained_ring) {
+    drained_ring->Reset();
+    delete spare_ring_.exchange(drained_ring, std::memory_order_acq_rel);
+  }
+
+  alignas(64) SpscRing<T>* head_ring_;
+  alignas(64) SpscRing<T>* tail_ring_;
+  alignas(64) std::atomic<SpscRing<T>*> spare_ring_ = nullptr;
+};
+
+inline std::atomic<uint64_t> next_per_thread_spsc_queues_id = 1;
+
+}  // namespace orbit_base_internal
+
+namespace orbit_base {
+
+// Multi-producer single-consumer buffer made of one single-producer single-consumer queue per
+// producing thread. Compared to a queue shared by all threads, producers never contend with each
+// other: enqueuing an event is a thread-local lookup, a store to a ring buffer, and only rarely an
+// allocation. Events enqueued by the same thread are dequeued in the same order, but there is no
+// order between events of different threads.
+//
+// T needs to be default-constructible and move-assignable.
+template <typename T>
+class PerThreadSpscQueues {
+ public:
+  static constexpr size_t kDefaultInitialCapacityPerThread = 64;
+
+  explicit PerThreadSpscQueues(
+      size_t initial_capacity_per_thread = kDefaultInitialCapacityPerThread)
+      : initial_capacity_per_thread_{initial_capacity_per_thread} {}
+
+  PerThreadSpscQueues(const PerThreadSpscQueues&) = delete;
+  PerThreadSpscQueues& operator=(const PerThreadSpscQueues&) = delete;
+
+  // Can be called from any thread.
+  void Enqueue(const T& event) { GetQueueOfCurrentThread()->Push(event); }
+  void Enqueue(T&& event) { GetQueueOfCurrentThread()->Push(std::move(event)); }
+
+  // Must only be called from one thread at a time. Moves up to `max_event_count` events to
+  // `events` and returns their number. Takes events from all threads' queues in turn, so that a
+  // thread producing a lot of events doesn't starve the others.
+  [[nodiscard]] size_t DequeueBulk(T* events, size_t max_event_count) {
+    UpdateConsumerQueues();
+
+    size_t count = 0;
+    bool has_exited_thread = false;
+    for (size_t i = 0; i < consumer_queues_.size() && count < max_event_count; ++i) {
+      ThreadQueue& thread_queue = *consumer_queues_[(next_queue_index_ + i) %
+                                                    consumer_queues_.size()];
+      // Load this before popping: if the thread had exited, the pop is guaranteed to see all of
+      // its events.
+      const bool thread_exited = thread_queue.thread_exited.load(std::memory_order_acquire);
+      count += thread_queue.queue.PopBulk(events + count, max_event_count - count);
+      if (thread_exited && count < max_event_count) {
+        thread_queue.drained_after_thread_exit = true;
+        has_exited_thread = true;
+      }
+    }
+    if (!consumer_queues_.empty()) {
+      next_queue_index_ = (next_queue_index_ + 1) % consumer_queues_.size();
+    }
+
+    if (has_exited_thread) RemoveDrainedQueues();
+    return count;
+  }
+
+  // Must only be called from the thread that calls DequeueBulk, e.g. once a capture is over. Frees
+  // the rings that were kept for reuse. Each thread still keeps the ring it currently enqueues to.
+  void ReleaseUnusedMemory() {
+    UpdateConsumerQueues();
+    for (const std::shared_ptr<ThreadQueue>& thread_queue : consumer_queues_) {
+      thread_queue->queue.ReleaseSpareRing();
+    }
+  }
+
+ private:
+  struct ThreadQueue {
+    explicit ThreadQueue(size_t initial_capacity) : queue{initial_capacity} {}
+    orbit_base_internal::SpscQueue<T> queue;
+    std::atomic<bool> thread_exited = false;
+    // Only accessed by the consumer.
+    bool drained_after_thread_exit = false;
+  };
+
+  // The queues of all instances of PerThreadSpscQueues<T> that the current thread enqueued to.
+  // When the thread exits, the queues are handed over to their consumers, which release them once
+  // they have dequeued the remaining events.
+  struct ThreadLocalQueues {
+    ~ThreadLocalQueues() {
+      for (const auto& [unused_id, thread_queue] : queues) {
+        thread_queue->thread_exited.store(true, std::memory_order_release);
+      }
+    }
+
+    uint64_t last_used_id = 0;
+    ThreadQueue* last_used_queue = nullptr;
+    std::vector<std::pair<uint64_t, std::shared_ptr<ThreadQueue>>> queues;
+  };
+
+  [[nodiscard]] orbit_base_internal::SpscQueue<T>* GetQueueOfCurrentThread() {
+    thread_local ThreadLocalQueues thread_local_queues;
+    if (thread_local_queues.last_used_id != id_) {
+      thread_local_queues.last_used_queue = GetOrCreateThreadQueue(&thread_local_queues);
+      thread_local_queues.last_used_id = id_;
+    }
+    return &thread_local_queues.last_used_queue->queue;
+  }
+
+  [[nodiscard]] ThreadQueue* GetOrCreateThreadQueue(ThreadLocalQueues* thread_local_queues) {
+    std::vector<std::pair<uint64_t, std::shared_ptr<ThreadQueue>>>& queues =
+        thread_local_queues->queues;
+    auto it = std::find_if(queues.begin(), queues.end(),
+                           [this](const auto& id_and_queue) { return id_and_queue.first == id_; });
+    if (it != queues.end()) return it->second.get();
+
+    // Forget the queues of instances that were destroyed in the meantime.
+    queues.erase(std::remove_if(queues.begin(), queues.end(),
+                                [](const auto& id_and_queue) {
+                                  return id_and_queue.second.use_count() == 1;
+                                }),
+                 queues.end());
+
+    auto thread_queue = std::make_shared<ThreadQueue>(initial_capacity_per_thread_);
+    queues.emplace_back(id_, thread_queue);
+    absl::MutexLock lock{&mutex_};
+    queues_.push_back(std::move(thread_queue));
+    registered_queue_count_.fetch_add(1, std::memory_order_release);
+    return queues_.back().get();
+  }
+
+  void UpdateConsumerQueues() {
+    if (registered_queue_count_.load(std::memory_order_acquire) != consumer_queues_.size()) {
+      absl::MutexLock lock{&mutex_};
+      consumer_queues_ = queues_;
+    }
+  }
+
+  void RemoveDrainedQueues() {
+    auto is_drained = [](const std::shared_ptr<ThreadQueue>& thread_queue) {
+      return thread_queue->drained_after_thread_exit;
+    };
+    absl::MutexLock lock{&mutex_};
+    queues_.erase(std::remove_if(queues_.begin(), queues_.end(), is_drained), queues_.end());
+    registered_queue_count_.store(queues_.size(), std::memory_order_release);
+    consumer_queues_ = queues_;
+  }
+
+  const uint64_t id_ = orbit_base_internal::next_per_thread_spsc_queues_id.fetch_add(1);
+  const size_t initial_capacity_per_thread_;
+
+  absl::Mutex mutex_;
+  std::vector<std::shared_ptr<ThreadQueue>> queues_ ABSL_GUARDED_BY(mutex_);
+  std::atomic<size_t> registered_queue_count_ = 0;
+
+  // Only accessed by the consumer.
+  std::vector<std::shared_ptr<ThreadQueue>> consumer_queues_;
+  size_t next_queue_index_ = 0;
+};
+
+}  // namespace orbit_base
+
+#endif  // ORBIT_BASE_PER_THREAD_SPSC_QUEUES_H_
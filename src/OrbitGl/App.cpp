@@ -47,6 +47,7 @@
 #include "ClientData/ScopeId.h"
 #include "ClientData/ScopeStats.h"
 #include "ClientData/TimerChain.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientData/UserDefinedCaptureData.h"
 #include "ClientFlags/ClientFlags.h"
 #include "ClientModel/CaptureSerializer.h"
@@ -91,6 +92,7 @@
 #include "OrbitBase/StopSource.h"
 #include "OrbitBase/StopToken.h"
 #include "OrbitBase/ThreadConstants.h"
+#include "OrbitBase/ThreadPool.h"
 #include "OrbitBase/UniqueResource.h"
 #include "OrbitBase/WhenAll.h"
 #include "OrbitPaths/Paths.h"
@@ -125,12 +127,12 @@ using orbit_client_data::ThreadID;
 using orbit_client_data::ThreadStateSliceInfo;
 using orbit_client_data::TimerBlock;
 using orbit_client_data::TimerChain;
+using orbit_client_data::TimerInfo;
 using orbit_client_data::TracepointInfoSet;
 using orbit_client_data::UserDefinedCaptureData;
 
 using orbit_client_protos::PresetInfo;
 using orbit_client_protos::PresetModule;
-using orbit_client_protos::TimerInfo;
 
 using orbit_client_services::CrashManager;
 using orbit_client_services::TracepointServiceClient;
@@ -491,8 +493,9 @@ Future<void> OrbitApp::OnCaptureComplete() {
 
   GetMutableCaptureData().FilterBrokenCallstacks();
   PostProcessedSamplingData post_processed_sampling_data =
-      orbit_client_model::CreatePostProcessedSamplingData(GetCaptureData().GetCallstackData(),
-                                                          GetCaptureData(), *module_manager_);
+      orbit_client_model::CreatePostProcessedSamplingData(
+          GetCaptureData().GetCallstackData(), GetCaptureData(), *module_manager_,
+          /*generate_summary=*/true, orbit_base::ThreadPool::GetDefaultThreadPool());
 
   ORBIT_LOG("The capture contains %u intervals with incomplete data",
             GetCaptureData().incomplete_data_intervals().size());
@@ -559,7 +562,10 @@ Future<void> OrbitApp::OnCaptureFailed(ErrorMessage error_message) {
       });
 }
 
-void OrbitApp::OnTimer(const TimerInfo& timer_info) {
+void OrbitApp::OnTimer(const orbit_client_protos::TimerInfo& timer_info_proto) {
+  // Timers are kept for the whole capture, so they are converted to their compact representation
+  // once, here.
+  const TimerInfo timer_info{timer_info_proto};
   CaptureMetricProcessTimer(timer_info);
 
   CaptureData& capture_data = GetMutableCaptureData();
@@ -1446,7 +1452,8 @@ static std::unique_ptr<CaptureEventProcessor> CreateCaptureEventProcessor(
   }
 
   auto save_to_file_processor_or_error =
-      CaptureEventProcessor::CreateSaveToFileProcessor(file_path, error_handler);
+      CaptureEventProcessor::CreateSaveToFileProcessor(file_path, error_handler,
+                                                       absl::GetFlag(FLAGS_compress_capture_files));
 
   if (save_to_file_processor_or_error.has_error()) {
     error_handler(ErrorMessage{
@@ -2800,11 +2807,11 @@ void OrbitApp::set_hovered_thread_state_slice(
   data_manager_->set_hovered_thread_state_slice(thread_state_slice);
 }
 
-const orbit_client_protos::TimerInfo* OrbitApp::selected_timer() const {
+const orbit_client_data::TimerInfo* OrbitApp::selected_timer() const {
   return data_manager_->selected_timer();
 }
 
-void OrbitApp::SelectTimer(const orbit_client_protos::TimerInfo* timer_info) {
+void OrbitApp::SelectTimer(const orbit_client_data::TimerInfo* timer_info) {
   data_manager_->set_selected_timer(timer_info);
   const std::optional<ScopeId> scope_id =
       timer_info != nullptr ? GetCaptureData().ProvideScopeId(*timer_info) : std::nullopt;
@@ -2824,14 +2831,14 @@ void OrbitApp::DeselectTimer() {
 }
 
 std::optional<ScopeId> OrbitApp::GetScopeIdToHighlight() const {
-  const orbit_client_protos::TimerInfo* timer_info = selected_timer();
+  const orbit_client_data::TimerInfo* timer_info = selected_timer();
 
   if (timer_info == nullptr) return GetHighlightedScopeId();
   return GetCaptureData().ProvideScopeId(*timer_info);
 }
 
 uint64_t OrbitApp::GetGroupIdToHighlight() const {
-  const orbit_client_protos::TimerInfo* timer_info = selected_timer();
+  const orbit_client_data::TimerInfo* timer_info = selected_timer();
 
   uint64_t selected_group_id =
       timer_info != nullptr ? timer_info->group_id() : data_manager_->highlighted_group_id();
@@ -2839,6 +2846,10 @@ uint64_t OrbitApp::GetGroupIdToHighlight() const {
   return selected_group_id;
 }
 
+uint64_t OrbitApp::GetSelectionGeneration() const {
+  return data_manager_->selection_generation() + selection_generation_;
+}
+
 void OrbitApp::SetCaptureDataSelectionFields(
     const std::vector<CallstackEvent>& selected_callstack_events, bool origin_is_multiple_threads) {
   const CallstackData& callstack_data = GetCaptureData().GetCallstackData();
@@ -2847,12 +2858,14 @@ void OrbitApp::SetCaptureDataSelectionFields(
     selection_callstack_data->AddCallstackFromKnownCallstackData(event, callstack_data);
   }
   GetMutableCaptureData().set_selection_callstack_data(std::move(selection_callstack_data));
+  ++selection_generation_;
 
   // Generate selection report.
   PostProcessedSamplingData selection_post_processed_sampling_data =
       orbit_client_model::CreatePostProcessedSamplingData(
           GetCaptureData().selection_callstack_data(), GetCaptureData(), *module_manager_,
-          /*generate_summary*/ origin_is_multiple_threads);
+          /*generate_summary*/ origin_is_multiple_threads,
+          orbit_base::ThreadPool::GetDefaultThreadPool());
   GetMutableCaptureData().set_selection_post_processed_sampling_data(
       std::move(selection_post_processed_sampling_data));
 }
@@ -2898,8 +2911,9 @@ void OrbitApp::UpdateAfterSymbolLoading() {
 
   if (sampling_report_ != nullptr) {
     PostProcessedSamplingData post_processed_sampling_data =
-        orbit_client_model::CreatePostProcessedSamplingData(capture_data.GetCallstackData(),
-                                                            capture_data, *module_manager_);
+        orbit_client_model::CreatePostProcessedSamplingData(
+            capture_data.GetCallstackData(), capture_data, *module_manager_,
+            /*generate_summary=*/true, orbit_base::ThreadPool::GetDefaultThreadPool());
     GetMutableCaptureData().set_post_processed_sampling_data(post_processed_sampling_data);
     sampling_report_->UpdateReport(&capture_data.GetCallstackData(),
                                    &capture_data.post_processed_sampling_data());
@@ -2912,9 +2926,9 @@ void OrbitApp::UpdateAfterSymbolLoading() {
   }
 
   PostProcessedSamplingData selection_post_processed_sampling_data =
-      orbit_client_model::CreatePostProcessedSamplingData(capture_data.selection_callstack_data(),
-                                                          capture_data, *module_manager_,
-                                                          selection_report_->has_summary());
+      orbit_client_model::CreatePostProcessedSamplingData(
+          capture_data.selection_callstack_data(), capture_data, *module_manager_,
+          selection_report_->has_summary(), orbit_base::ThreadPool::GetDefaultThreadPool());
   GetMutableCaptureData().set_selection_post_processed_sampling_data(
       std::move(selection_post_processed_sampling_data));
 
@@ -3215,7 +3229,7 @@ void OrbitApp::AddFrameTrackTimers(uint64_t instrumented_function_id) {
   ORBIT_CHECK(function != nullptr);
 
   for (size_t k = 0; k < all_start_times.size() - 1; ++k) {
-    TimerInfo frame_timer;
+    orbit_client_protos::TimerInfo frame_timer;
     orbit_gl::CreateFrameTrackTimer(instrumented_function_id, all_start_times[k],
                                     all_start_times[k + 1], k, &frame_timer);
     GetMutableTimeGraph()->ProcessTimer(frame_timer, function);
@@ -3300,7 +3314,7 @@ ErrorMessageOr<void> OrbitApp::ConvertPresetToNewFormatIfNecessary(const PresetF
   return outcome::success();
 }
 
-void OrbitApp::CaptureMetricProcessTimer(const orbit_client_protos::TimerInfo& timer) {
+void OrbitApp::CaptureMetricProcessTimer(const orbit_client_data::TimerInfo& timer) {
   if (timer.function_id() != 0) {
     metrics_capture_complete_data_.number_of_instrumented_function_timers++;
     return;
@@ -3362,8 +3376,8 @@ OrbitApp::GetConfidenceIntervalEstimator() const {
   return confidence_interval_estimator_;
 }
 
-void OrbitApp::ShowHistogram(const std::vector<uint64_t>* data, const std::string& scope_name,
-                             std::optional<ScopeId> scope_id) {
+void OrbitApp::ShowHistogram(const orbit_statistics::QuantileSketch* data,
+                             const std::string& scope_name, std::optional<ScopeId> scope_id) {
   main_window_->ShowHistogram(data, scope_name, scope_id);
 }
 
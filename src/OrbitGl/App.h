@@ -43,6 +43,7 @@
 #include "ClientData/PostProcessedSamplingData.h"
 #include "ClientData/ProcessData.h"
 #include "ClientData/ThreadStateSliceInfo.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientData/TracepointCustom.h"
 #include "ClientData/UserDefinedCaptureData.h"
 #include "ClientData/WineSyscallHandlingMethod.h"
@@ -89,6 +90,7 @@
 #include "SamplingReport.h"
 #include "ScopedStatus.h"
 #include "Statistics/BinomialConfidenceInterval.h"
+#include "Statistics/QuantileSketch.h"
 #include "StatusListener.h"
 #include "StringManager/StringManager.h"
 #include "Symbols/SymbolHelper.h"
@@ -305,7 +307,7 @@ class OrbitApp final : public DataViewFactory,
   void SetSelectionBottomUpViewCallback(CallTreeViewCallback callback) {
     selection_bottom_up_view_callback_ = std::move(callback);
   }
-  using TimerSelectedCallback = std::function<void(const orbit_client_protos::TimerInfo*)>;
+  using TimerSelectedCallback = std::function<void(const orbit_client_data::TimerInfo*)>;
   void SetTimerSelectedCallback(TimerSelectedCallback callback) {
     timer_selected_callback_ = std::move(callback);
   }
@@ -491,12 +493,15 @@ class OrbitApp final : public DataViewFactory,
   void set_hovered_thread_state_slice(
       std::optional<orbit_client_data::ThreadStateSliceInfo> thread_state_slice);
 
-  [[nodiscard]] const orbit_client_protos::TimerInfo* selected_timer() const;
-  void SelectTimer(const orbit_client_protos::TimerInfo* timer_info);
+  [[nodiscard]] const orbit_client_data::TimerInfo* selected_timer() const;
+  void SelectTimer(const orbit_client_data::TimerInfo* timer_info);
   void DeselectTimer() override;
 
   [[nodiscard]] std::optional<ScopeId> GetScopeIdToHighlight() const;
   [[nodiscard]] uint64_t GetGroupIdToHighlight() const;
+  // Changes whenever DataManager::selection_generation changes, or the selected callstacks or the
+  // histogram selection range change.
+  [[nodiscard]] uint64_t GetSelectionGeneration() const;
 
   // origin_is_multiple_threads defines if the selection is specific to a single thread,
   // or spans across multiple threads.
@@ -543,6 +548,7 @@ class OrbitApp final : public DataViewFactory,
 
   void SetHistogramSelectionRange(std::optional<orbit_statistics::HistogramSelectionRange> range) {
     histogram_selection_range_ = range;
+    ++selection_generation_;
     RequestUpdatePrimitives();
   }
 
@@ -618,10 +624,10 @@ class OrbitApp final : public DataViewFactory,
   void RequestUpdatePrimitives();
 
   // Only call from the capture thread
-  void CaptureMetricProcessTimer(const orbit_client_protos::TimerInfo& timer);
+  void CaptureMetricProcessTimer(const orbit_client_data::TimerInfo& timer);
 
-  void ShowHistogram(const std::vector<uint64_t>* data, const std::string& scope_name,
-                     std::optional<ScopeId> scope_id) override;
+  void ShowHistogram(const orbit_statistics::QuantileSketch* data,
+                     const std::string& scope_name, std::optional<ScopeId> scope_id) override;
 
   void RequestSymbolDownloadStop(absl::Span<const orbit_client_data::ModuleData* const> modules,
                                  bool show_dialog);
@@ -752,6 +758,7 @@ class OrbitApp final : public DataViewFactory,
   const orbit_statistics::WilsonBinomialConfidenceIntervalEstimator confidence_interval_estimator_;
 
   std::optional<orbit_statistics::HistogramSelectionRange> histogram_selection_range_;
+  uint64_t selection_generation_ = 0;
 
   static constexpr std::chrono::milliseconds kMaxPostProcessingInterval{1000};
   orbit_qt_utils::Throttle update_after_symbol_loading_throttle_{kMaxPostProcessingInterval};
@@ -12,6 +12,7 @@
 
 #include "CallstackThreadBar.h"
 #include "ClientData/TimerChain.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "CoreMath.h"
 #include "PickingManager.h"
@@ -35,7 +36,7 @@ class AsyncTrack final : public TimerTrack {
   [[nodiscard]] Type GetType() const override { return Type::kAsyncTrack; };
   [[nodiscard]] std::string GetBoxTooltip(const orbit_gl::PrimitiveAssembler& primitive_assembler,
                                           PickingId id) const override;
-  void OnTimer(const orbit_client_protos::TimerInfo& timer_info) override;
+  void OnTimer(const orbit_client_data::TimerInfo& timer_info) override;
   [[nodiscard]] float GetHeight() const override;
 
  protected:
@@ -44,8 +45,8 @@ class AsyncTrack final : public TimerTrack {
                           uint64_t max_tick, PickingMode picking_mode) override;
   [[nodiscard]] float GetDefaultBoxHeight() const override;
   [[nodiscard]] std::string GetTimesliceText(
-      const orbit_client_protos::TimerInfo& timer) const override;
-  [[nodiscard]] Color GetTimerColor(const orbit_client_protos::TimerInfo& timer_info,
+      const orbit_client_data::TimerInfo& timer) const override;
+  [[nodiscard]] Color GetTimerColor(const orbit_client_data::TimerInfo& timer_info,
                                     bool is_selected, bool is_highlighted,
                                     const internal::DrawData& draw_data) const override;
 
@@ -5,6 +5,8 @@
 #ifndef ORBIT_GL_BATCHER_H_
 #define ORBIT_GL_BATCHER_H_
 
+#include <memory>
+
 #include "BatcherInterface.h"
 #include "TranslationStack.h"
 
@@ -22,6 +24,18 @@ class Batcher : public BatcherInterface {
 
   void PushTranslation(float x, float y, float z = 0.f) { translations_.PushTranslation(x, y, z); }
   void PopTranslation() { translations_.PopTranslation(); }
+  [[nodiscard]] const LayeredVec2& GetCurrentTranslation() const {
+    return translations_.GetCurrentTranslation();
+  }
+
+  // A segment is an empty batcher of the same type and id that primitives can be added to from
+  // another thread. AppendSegment copies the elements of a segment to the end of this batcher and
+  // fixes up their picking ids, so that building several segments in parallel and appending them
+  // in a fixed order yields the same result as adding all primitives to this batcher directly. The
+  // segment itself is left unchanged, so it can be appended again in later frames.
+  // Returns nullptr if the batcher doesn't support segments.
+  [[nodiscard]] virtual std::unique_ptr<Batcher> CreateSegment() const { return nullptr; }
+  virtual void AppendSegment(const Batcher* /*segment*/) {}
 
  protected:
   orbit_gl::TranslationStack translations_;
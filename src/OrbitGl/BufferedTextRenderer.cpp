@@ -0,0 +1,57 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "BufferedTextRenderer.h"
+
+#include "OrbitBase/Logging.h"
+
+namespace orbit_gl {
+
+void BufferedTextRenderer::AddText(const char* text, float x, float y, float z,
+                                   TextFormatting formatting) {
+  texts_.push_back(BufferedText{text, x, y, z, formatting, std::nullopt,
+                                translations_.GetCurrentTranslation()});
+}
+
+void BufferedTextRenderer::AddText(const char* text, float x, float y, float z,
+                                   TextFormatting formatting, Vec2* out_text_pos,
+                                   Vec2* out_text_size) {
+  ORBIT_CHECK(out_text_pos == nullptr);
+  ORBIT_CHECK(out_text_size == nullptr);
+  AddText(text, x, y, z, formatting);
+}
+
+float BufferedTextRenderer::AddTextTrailingCharsPrioritized(const char* text, float x, float y,
+                                                            float z, TextFormatting formatting,
+                                                            size_t trailing_chars_length) {
+  texts_.push_back(BufferedText{text, x, y, z, formatting, trailing_chars_length,
+                                translations_.GetCurrentTranslation()});
+  return 0.f;
+}
+
+float BufferedTextRenderer::GetStringWidth(const char* text, uint32_t font_size) {
+  absl::MutexLock lock(target_mutex_);
+  return target_->GetStringWidth(text, font_size);
+}
+
+float BufferedTextRenderer::GetStringHeight(const char* text, uint32_t font_size) {
+  absl::MutexLock lock(target_mutex_);
+  return target_->GetStringHeight(text, font_size);
+}
+
+void BufferedTextRenderer::ReplayIntoTarget() const {
+  for (const BufferedText& text : texts_) {
+    target_->PushTranslation(text.translation.xy[0], text.translation.xy[1], text.translation.z);
+    if (text.trailing_chars_length.has_value()) {
+      target_->AddTextTrailingCharsPrioritized(text.text.c_str(), text.x, text.y, text.z,
+                                               text.formatting,
+                                               text.trailing_chars_length.value());
+    } else {
+      target_->AddText(text.text.c_str(), text.x, text.y, text.z, text.formatting);
+    }
+    target_->PopTranslation();
+  }
+}
+
+}  // namespace orbit_gl
@@ -0,0 +1,78 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ORBIT_GL_BUFFERED_TEXT_RENDERER_H_
+#define ORBIT_GL_BUFFERED_TEXT_RENDERER_H_
+
+#include <absl/synchronization/mutex.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "TextRenderer.h"
+#include "TranslationStack.h"
+
+namespace orbit_gl {
+
+// TextRenderer that records the texts added to it, so that they can be added to another
+// TextRenderer later, from another thread. This allows CaptureViewElements to update their
+// primitives in parallel while the texts still end up in the target TextRenderer in a deterministic
+// order.
+//
+// String measurements are forwarded to the target TextRenderer, as they depend on its fonts, while
+// holding `target_mutex`, which all BufferedTextRenderers with the same target need to share.
+//
+// As texts are only laid out when they are replayed, the return value of
+// AddTextTrailingCharsPrioritized is always 0 and the out parameters of AddText are not supported.
+class BufferedTextRenderer : public TextRenderer {
+ public:
+  explicit BufferedTextRenderer(TextRenderer* target, absl::Mutex* target_mutex)
+      : target_(target), target_mutex_(target_mutex) {}
+
+  void Init() override {}
+  void Clear() override { texts_.clear(); }
+
+  void RenderLayer(float /*layer*/) override {}
+  void RenderDebug(PrimitiveAssembler* /*primitive_assembler*/) override {}
+  [[nodiscard]] std::vector<float> GetLayers() const override { return {}; }
+
+  void AddText(const char* text, float x, float y, float z, TextFormatting formatting) override;
+  void AddText(const char* text, float x, float y, float z, TextFormatting formatting,
+               Vec2* out_text_pos, Vec2* out_text_size) override;
+
+  float AddTextTrailingCharsPrioritized(const char* text, float x, float y, float z,
+                                        TextFormatting formatting,
+                                        size_t trailing_chars_length) override;
+
+  [[nodiscard]] float GetStringWidth(const char* text, uint32_t font_size) override;
+  [[nodiscard]] float GetStringHeight(const char* text, uint32_t font_size) override;
+
+  // Adds the recorded texts to the target TextRenderer, relative to its current translation. The
+  // texts are kept, so they can be replayed again in later frames until Clear is called.
+  void ReplayIntoTarget() const;
+
+  [[nodiscard]] TextRenderer* GetTarget() const { return target_; }
+
+ private:
+  struct BufferedText {
+    std::string text;
+    float x;
+    float y;
+    float z;
+    TextFormatting formatting;
+    std::optional<size_t> trailing_chars_length;
+    LayeredVec2 translation;
+  };
+
+  TextRenderer* target_;
+  absl::Mutex* target_mutex_;
+  std::vector<BufferedText> texts_;
+};
+
+}  // namespace orbit_gl
+
+#endif  // ORBIT_GL_BUFFERED_TEXT_RENDERER_H_
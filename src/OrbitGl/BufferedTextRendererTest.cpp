@@ -0,0 +1,58 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <absl/synchronization/mutex.h>
+#include <gtest/gtest.h>
+
+#include "BufferedTextRenderer.h"
+#include "MockTextRenderer.h"
+
+namespace orbit_gl {
+
+TEST(BufferedTextRenderer, ForwardsStringMeasurementsToTarget) {
+  MockTextRenderer target;
+  absl::Mutex mutex;
+  BufferedTextRenderer text_renderer(&target, &mutex);
+
+  EXPECT_EQ(text_renderer.GetStringWidth("text", 10), target.GetStringWidth("text", 10));
+  EXPECT_EQ(text_renderer.GetStringHeight("text", 10), target.GetStringHeight("text", 10));
+  EXPECT_EQ(text_renderer.GetTarget(), &target);
+}
+
+TEST(BufferedTextRenderer, OnlyAddsTextsToTargetWhenReplaying) {
+  MockTextRenderer target;
+  absl::Mutex mutex;
+  BufferedTextRenderer text_renderer(&target, &mutex);
+
+  TextRenderer::TextFormatting formatting{10, Color(255, 255, 255, 255), -1.f};
+  text_renderer.AddText("text", 0, 0, 0.5f, formatting);
+  text_renderer.AddTextTrailingCharsPrioritized("longer text", 0, 20, 0.5f, formatting, 4);
+  EXPECT_EQ(target.GetNumAddTextCalls(), 0);
+
+  text_renderer.ReplayIntoTarget();
+  EXPECT_EQ(target.GetNumAddTextCalls(), 2);
+  EXPECT_FALSE(target.HasAddTextsSameLength());
+  EXPECT_TRUE(target.IsTextBetweenZLayers(0.5f, 0.5f));
+
+  // Texts are kept until the BufferedTextRenderer is cleared.
+  text_renderer.ReplayIntoTarget();
+  EXPECT_EQ(target.GetNumAddTextCalls(), 4);
+
+  text_renderer.Clear();
+  text_renderer.ReplayIntoTarget();
+  EXPECT_EQ(target.GetNumAddTextCalls(), 4);
+}
+
+TEST(BufferedTextRenderer, OutParametersAreNotSupported) {
+  MockTextRenderer target;
+  absl::Mutex mutex;
+  BufferedTextRenderer text_renderer(&target, &mutex);
+
+  TextRenderer::TextFormatting formatting{10, Color(255, 255, 255, 255), -1.f};
+  Vec2 text_pos;
+  EXPECT_DEATH(text_renderer.AddText("text", 0, 0, 0, formatting, &text_pos, nullptr),
+               "Check failed");
+}
+
+}  // namespace orbit_gl
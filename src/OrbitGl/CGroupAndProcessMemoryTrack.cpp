@@ -9,6 +9,7 @@
 
 #include "ApiUtils/EncodedEvent.h"
 #include "CaptureClient/CaptureEventProcessor.h"
+#include "ClientData/TimerInfo.h"
 #include "DisplayFormats/DisplayFormats.h"
 #include "GrpcProtos/Constants.h"
 
@@ -125,7 +126,7 @@ std::string CGroupAndProcessMemoryTrack::GetValueUpperBoundTooltip() const {
       kGameCGroupName, kGameCGroupLimitGB);
 }
 
-void CGroupAndProcessMemoryTrack::OnTimer(const orbit_client_protos::TimerInfo& timer_info) {
+void CGroupAndProcessMemoryTrack::OnTimer(const orbit_client_data::TimerInfo& timer_info) {
   int64_t cgroup_limit_bytes = orbit_api::Decode<int64_t>(timer_info.registers(static_cast<size_t>(
       CaptureEventProcessor::CGroupAndProcessMemoryUsageEncodingIndex::kCGroupLimitBytes)));
   int64_t cgroup_rss_bytes = orbit_api::Decode<int64_t>(timer_info.registers(static_cast<size_t>(
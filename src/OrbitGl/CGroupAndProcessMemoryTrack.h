@@ -8,6 +8,7 @@
 #include <string>
 #include <utility>
 
+#include "ClientData/TimerInfo.h"
 #include "MemoryTrack.h"
 
 namespace orbit_gl {
@@ -29,7 +30,7 @@ class CGroupAndProcessMemoryTrack final
 
   void TrySetValueUpperBound(double cgroup_limit_mb);
 
-  void OnTimer(const orbit_client_protos::TimerInfo& timer_info) override;
+  void OnTimer(const orbit_client_data::TimerInfo& timer_info) override;
 
   enum class SeriesIndex {
     kProcessRssAnonMb = 0,
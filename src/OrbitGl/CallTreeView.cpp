@@ -5,17 +5,22 @@
 #include "CallTreeView.h"
 
 #include <absl/container/flat_hash_map.h>
-#include <absl/container/node_hash_map.h>
-#include <absl/meta/type_traits.h>
+#include <absl/hash/hash.h>
 #include <absl/strings/str_format.h>
+#include <absl/types/span.h>
 
 #include <algorithm>
+#include <array>
+#include <tuple>
+#include <utility>
 
 #include "ClientData/ModuleAndFunctionLookup.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "Introspection/Introspection.h"
+#include "OrbitBase/TaskGroup.h"
 #include "OrbitBase/ThreadConstants.h"
 
+using orbit_client_data::CallstackEvent;
 using orbit_client_data::CallstackInfo;
 using orbit_client_data::CallstackType;
 using orbit_client_data::CaptureData;
@@ -23,276 +28,353 @@ using orbit_client_data::ModuleManager;
 using orbit_client_data::PostProcessedSamplingData;
 using orbit_client_data::ThreadSampleData;
 
-const std::vector<const CallTreeNode*>& CallTreeNode::children() const {
-  if (children_cache_.has_value()) {
-    return *children_cache_;
+// Tree in which the samples are aggregated before creating the CallTreeNodes. Its nodes are only
+// identified by their type and key, and refer to the CallstackEvents of the
+// PostProcessedSamplingData instead of copying them, which makes it cheap to build one for each
+// thread and merge them.
+class CallTreeBuilder {
+ public:
+  // The order in which children of different types are listed by CallTreeNode::children().
+  enum class NodeType : uint8_t { kThread, kFunction, kUnwindErrors, kUnwindErrorType };
+  static constexpr size_t kNodeTypeCount = 4;
+
+  struct Node {
+    NodeType type = NodeType::kThread;
+    // The thread id, the function address, the CallstackType, or 0 for the unwind errors node.
+    uint64_t key = 0;
+    uint64_t sample_count = 0;
+    // Children are linked through their siblings rather than stored in a vector, to avoid one
+    // allocation per node.
+    uint32_t first_child_index = kNoNodeIndex;
+    uint32_t next_sibling_index = kNoNodeIndex;
+    std::vector<const std::vector<CallstackEvent>*> exclusive_callstack_events;
+  };
+
+  static constexpr uint32_t kRootIndex = 0;
+  static constexpr uint32_t kNoNodeIndex = UINT32_MAX;
+
+  CallTreeBuilder() : nodes_(1) {}
+
+  [[nodiscard]] const std::vector<Node>& nodes() const { return nodes_; }
+
+  [[nodiscard]] uint32_t GetOrAddChild(uint32_t parent_index, NodeType type, uint64_t key) {
+    const auto [it, inserted] = child_indices_.try_emplace(std::make_tuple(parent_index, type, key),
+                                                           static_cast<uint32_t>(nodes_.size()));
+    if (inserted) {
+      ORBIT_CHECK(nodes_.size() < kNoNodeIndex);
+      Node& child = nodes_.emplace_back();
+      child.type = type;
+      child.key = key;
+      child.next_sibling_index = std::exchange(nodes_[parent_index].first_child_index, it->second);
+    }
+    return it->second;
   }
 
-  children_cache_.emplace();
-  for (const auto& tid_and_thread : thread_children_) {
-    children_cache_->push_back(&tid_and_thread.second);
-  }
-  for (const auto& address_and_functions : function_children_) {
-    children_cache_->push_back(&address_and_functions.second);
-  }
-  if (unwind_errors_child_ != nullptr) {
-    children_cache_->push_back(unwind_errors_child_.get());
+  void IncreaseSampleCount(uint32_t node_index, uint64_t sample_count_increase) {
+    nodes_[node_index].sample_count += sample_count_increase;
   }
 
-  for (const auto& error_type_and_unwind_error : unwind_error_type_children_) {
-    children_cache_->push_back(&error_type_and_unwind_error.second);
+  void AddExclusiveCallstackEvents(uint32_t node_index,
+                                   const std::vector<CallstackEvent>& callstack_events) {
+    nodes_[node_index].exclusive_callstack_events.push_back(&callstack_events);
   }
 
-  return *children_cache_;
-}
-
-CallTreeThread* CallTreeNode::GetThreadOrNull(uint32_t thread_id) {
-  auto thread_it = thread_children_.find(thread_id);
-  if (thread_it == thread_children_.end()) {
-    return nullptr;
+  // Merges the subtrees of the children of the root of `other` for which `filter(child)` returns
+  // true. Their samples are added to the root, so every sample must be counted by exactly one child
+  // of the root, as is the case in the bottom-up tree.
+  template <typename Filter>
+  void MergeChildrenOfRoot(const CallTreeBuilder& other, Filter filter) {
+    for (uint32_t other_child_index = other.nodes_[kRootIndex].first_child_index;
+         other_child_index != kNoNodeIndex;
+         other_child_index = other.nodes_[other_child_index].next_sibling_index) {
+      const Node& other_child = other.nodes_[other_child_index];
+      if (!filter(other_child)) continue;
+      nodes_[kRootIndex].sample_count += other_child.sample_count;
+      MergeSubtree(other, other_child_index,
+                   GetOrAddChild(kRootIndex, other_child.type, other_child.key));
+    }
   }
-  return &thread_it->second;
-}
-
-CallTreeThread* CallTreeNode::AddAndGetThread(uint32_t thread_id, std::string thread_name) {
-  const auto& [it, inserted] = thread_children_.try_emplace(
-      thread_id, CallTreeThread{thread_id, std::move(thread_name), this});
-  ORBIT_CHECK(inserted);
-  children_cache_.reset();
-  return &it->second;
-}
 
-CallTreeFunction* CallTreeNode::GetFunctionOrNull(uint64_t function_absolute_address) {
-  auto function_it = function_children_.find(function_absolute_address);
-  if (function_it == function_children_.end()) {
-    return nullptr;
+ private:
+  void MergeSubtree(const CallTreeBuilder& other, uint32_t other_node_index, uint32_t node_index) {
+    const Node& other_node = other.nodes_[other_node_index];
+    nodes_[node_index].sample_count += other_node.sample_count;
+    nodes_[node_index].exclusive_callstack_events.insert(
+        nodes_[node_index].exclusive_callstack_events.end(),
+        other_node.exclusive_callstack_events.begin(), other_node.exclusive_callstack_events.end());
+    for (uint32_t other_child_index = other_node.first_child_index;
+         other_child_index != kNoNodeIndex;
+         other_child_index = other.nodes_[other_child_index].next_sibling_index) {
+      const Node& other_child = other.nodes_[other_child_index];
+      MergeSubtree(other, other_child_index,
+                   GetOrAddChild(node_index, other_child.type, other_child.key));
+    }
   }
-  return &function_it->second;
-}
-
-CallTreeFunction* CallTreeNode::AddAndGetFunction(uint64_t function_absolute_address,
-                                                  std::string function_name,
-                                                  std::string module_path,
-                                                  std::string module_build_id) {
-  const auto& [it, inserted] = function_children_.try_emplace(
-      function_absolute_address,
-      CallTreeFunction{function_absolute_address, std::move(function_name), std::move(module_path),
-                       std::move(module_build_id), this});
-  ORBIT_CHECK(inserted);
-  children_cache_.reset();
-  return &it->second;
-}
 
-CallTreeUnwindErrorType* CallTreeNode::GetUnwindErrorTypeOrNull(CallstackType type) {
-  auto unwind_error_it = unwind_error_type_children_.find(type);
-  if (unwind_error_it == unwind_error_type_children_.end()) {
-    return nullptr;
-  }
-  return &unwind_error_it->second;
-}
+  std::vector<Node> nodes_;
+  absl::flat_hash_map<std::tuple<uint32_t, NodeType, uint64_t>, uint32_t> child_indices_;
+};
 
-CallTreeUnwindErrorType* CallTreeNode::AddAndGetUnwindErrorType(CallstackType type) {
-  const auto& [it, inserted] =
-      unwind_error_type_children_.try_emplace(type, CallTreeUnwindErrorType{this, type});
-  ORBIT_CHECK(inserted);
-  children_cache_.reset();
-  return &it->second;
-}
+using NodeType = CallTreeBuilder::NodeType;
 
-CallTreeUnwindErrors* CallTreeNode::GetUnwindErrorsOrNull() { return unwind_errors_child_.get(); }
+[[nodiscard]] static CallTreeBuilder BuildTopDownTreeOfThread(
+    const ThreadSampleData& thread_sample_data,
+    const PostProcessedSamplingData& post_processed_sampling_data) {
+  CallTreeBuilder tree;
+  const uint32_t tid = thread_sample_data.thread_id;
+  const uint32_t thread_index =
+      tree.GetOrAddChild(CallTreeBuilder::kRootIndex, NodeType::kThread, tid);
 
-CallTreeUnwindErrors* CallTreeNode::AddAndGetUnwindErrors() {
-  ORBIT_CHECK(unwind_errors_child_ == nullptr);
-  unwind_errors_child_ = std::make_unique<CallTreeUnwindErrors>(this);
-  children_cache_.reset();
-  return unwind_errors_child_.get();
-}
+  for (const auto& [callstack_id, callstack_events] :
+       thread_sample_data.sampled_callstack_id_to_events) {
+    const uint64_t sample_count = callstack_events.size();
 
-[[nodiscard]] static CallTreeFunction* GetOrCreateFunctionNode(CallTreeNode* current_node,
-                                                               uint64_t frame,
-                                                               const std::string& function_name,
-                                                               const std::string& module_path,
-                                                               const std::string& module_build_id) {
-  CallTreeFunction* function_node = current_node->GetFunctionOrNull(frame);
-  if (function_node == nullptr) {
-    std::string formatted_function_name;
-    if (function_name != orbit_client_data::kUnknownFunctionOrModuleName) {
-      formatted_function_name = function_name;
+    // Don't count samples from the all-thread case again.
+    if (tid != orbit_base::kAllProcessThreadsTid) {
+      tree.IncreaseSampleCount(CallTreeBuilder::kRootIndex, sample_count);
+    }
+    tree.IncreaseSampleCount(thread_index, sample_count);
+
+    const CallstackInfo& resolved_callstack =
+        post_processed_sampling_data.GetResolvedCallstack(callstack_id);
+    uint32_t current_index = thread_index;
+    if (resolved_callstack.type() == CallstackType::kComplete) {
+      for (auto frame_it = resolved_callstack.frames().rbegin();
+           frame_it != resolved_callstack.frames().rend(); ++frame_it) {
+        current_index = tree.GetOrAddChild(current_index, NodeType::kFunction, *frame_it);
+        tree.IncreaseSampleCount(current_index, sample_count);
+      }
     } else {
-      formatted_function_name = absl::StrFormat("[unknown@%#llx]", frame);
+      current_index = tree.GetOrAddChild(current_index, NodeType::kUnwindErrors, 0);
+      tree.IncreaseSampleCount(current_index, sample_count);
+      current_index =
+          tree.GetOrAddChild(current_index, NodeType::kUnwindErrorType,
+                             static_cast<uint64_t>(resolved_callstack.type()));
+      tree.IncreaseSampleCount(current_index, sample_count);
+
+      ORBIT_CHECK(!resolved_callstack.frames().empty());
+      // Only use the innermost frame for unwind errors.
+      current_index =
+          tree.GetOrAddChild(current_index, NodeType::kFunction, resolved_callstack.frames()[0]);
+      tree.IncreaseSampleCount(current_index, sample_count);
     }
-    function_node = current_node->AddAndGetFunction(frame, std::move(formatted_function_name),
-                                                    module_path, module_build_id);
+    tree.AddExclusiveCallstackEvents(current_index, callstack_events);
   }
-  return function_node;
+  return tree;
 }
 
-[[nodiscard]] static CallTreeUnwindErrorType* GetOrCreateUnwindErrorTypeNode(
-    CallTreeNode* current_node, CallstackType error_type) {
-  CallTreeUnwindErrorType* unwind_error = current_node->GetUnwindErrorTypeOrNull(error_type);
-  if (unwind_error == nullptr) {
-    unwind_error = current_node->AddAndGetUnwindErrorType(error_type);
+[[nodiscard]] static CallTreeBuilder BuildBottomUpTreeOfThread(
+    const ThreadSampleData& thread_sample_data,
+    const PostProcessedSamplingData& post_processed_sampling_data) {
+  CallTreeBuilder tree;
+  const uint32_t tid = thread_sample_data.thread_id;
+  if (tid == orbit_base::kAllProcessThreadsTid) {
+    return tree;
   }
-  return unwind_error;
-}
 
-static void AddCallstackToTopDownThread(
-    CallTreeThread* thread_node, const CallstackInfo& resolved_callstack,
-    const std::vector<orbit_client_data::CallstackEvent>& callstack_events,
-    const ModuleManager& module_manager, const CaptureData& capture_data) {
-  uint64_t callstack_sample_count = callstack_events.size();
-
-  CallTreeNode* current_thread_or_function = thread_node;
-  for (auto frame_it = resolved_callstack.frames().rbegin();
-       frame_it != resolved_callstack.frames().rend(); ++frame_it) {
-    uint64_t frame = *frame_it;
-    const std::string& function_name =
-        orbit_client_data::GetFunctionNameByAddress(module_manager, capture_data, frame);
-    const auto& [module_path, module_build_id] =
-        orbit_client_data::FindModulePathAndBuildIdByAddress(module_manager, capture_data, frame);
-
-    CallTreeFunction* function_node =
-        GetOrCreateFunctionNode(current_thread_or_function, frame, function_name, module_path,
-                                module_build_id.value_or(""));
-    function_node->IncreaseSampleCount(callstack_sample_count);
-    current_thread_or_function = function_node;
+  for (const auto& [callstack_id, callstack_events] :
+       thread_sample_data.sampled_callstack_id_to_events) {
+    const uint64_t sample_count = callstack_events.size();
+    tree.IncreaseSampleCount(CallTreeBuilder::kRootIndex, sample_count);
+
+    const CallstackInfo& resolved_callstack =
+        post_processed_sampling_data.GetResolvedCallstack(callstack_id);
+    uint32_t current_index = CallTreeBuilder::kRootIndex;
+    if (resolved_callstack.type() == CallstackType::kComplete) {
+      for (uint64_t frame : resolved_callstack.frames()) {
+        current_index = tree.GetOrAddChild(current_index, NodeType::kFunction, frame);
+        tree.IncreaseSampleCount(current_index, sample_count);
+      }
+    } else {
+      ORBIT_CHECK(!resolved_callstack.frames().empty());
+      // Only use the innermost frame for unwind errors.
+      current_index =
+          tree.GetOrAddChild(current_index, NodeType::kFunction, resolved_callstack.frames()[0]);
+      tree.IncreaseSampleCount(current_index, sample_count);
+      current_index = tree.GetOrAddChild(current_index, NodeType::kUnwindErrors, 0);
+      tree.IncreaseSampleCount(current_index, sample_count);
+      current_index =
+          tree.GetOrAddChild(current_index, NodeType::kUnwindErrorType,
+                             static_cast<uint64_t>(resolved_callstack.type()));
+      tree.IncreaseSampleCount(current_index, sample_count);
+    }
+
+    current_index = tree.GetOrAddChild(current_index, NodeType::kThread, tid);
+    tree.IncreaseSampleCount(current_index, sample_count);
+    tree.AddExclusiveCallstackEvents(current_index, callstack_events);
   }
-  current_thread_or_function->AddExclusiveCallstackEvents(callstack_events);
+  return tree;
 }
 
-static void AddUnwindErrorToTopDownThread(
-    CallTreeThread* thread_node, const CallstackInfo& resolved_callstack,
-    const std::vector<orbit_client_data::CallstackEvent>& callstack_events,
-    const ModuleManager& module_manager, const CaptureData& capture_data) {
-  CallTreeUnwindErrors* unwind_errors_node = thread_node->GetUnwindErrorsOrNull();
-  if (unwind_errors_node == nullptr) {
-    unwind_errors_node = thread_node->AddAndGetUnwindErrors();
+// Builds the tree of each thread on the default thread pool.
+template <typename BuildTreeOfThread>
+[[nodiscard]] static std::vector<CallTreeBuilder> BuildTreesOfThreadsInParallel(
+    const PostProcessedSamplingData& post_processed_sampling_data,
+    BuildTreeOfThread build_tree_of_thread) {
+  const std::vector<const ThreadSampleData*> sorted_thread_sample_data =
+      post_processed_sampling_data.GetSortedThreadSampleData();
+  std::vector<CallTreeBuilder> trees(sorted_thread_sample_data.size());
+  orbit_base::TaskGroup task_group;
+  for (size_t i = 0; i < sorted_thread_sample_data.size(); ++i) {
+    task_group.AddTask([&, i] {
+      trees[i] = build_tree_of_thread(*sorted_thread_sample_data[i], post_processed_sampling_data);
+    });
   }
-  uint64_t callstack_sample_count = callstack_events.size();
-  unwind_errors_node->IncreaseSampleCount(callstack_sample_count);
-
-  CallTreeUnwindErrorType* unwind_error_type_node =
-      GetOrCreateUnwindErrorTypeNode(unwind_errors_node, resolved_callstack.type());
-  unwind_error_type_node->IncreaseSampleCount(callstack_sample_count);
-
-  ORBIT_CHECK(!resolved_callstack.frames().empty());
-  // Only use the innermost frame for unwind errors.
-  uint64_t frame = resolved_callstack.frames()[0];
-  const std::string& function_name =
-      orbit_client_data::GetFunctionNameByAddress(module_manager, capture_data, frame);
-  const auto& [module_path, module_build_id] =
-      orbit_client_data::FindModulePathAndBuildIdByAddress(module_manager, capture_data, frame);
-
-  CallTreeFunction* function_node = GetOrCreateFunctionNode(
-      unwind_error_type_node, frame, function_name, module_path, module_build_id.value_or(""));
-  function_node->IncreaseSampleCount(callstack_sample_count);
-  function_node->AddExclusiveCallstackEvents(callstack_events);
+  task_group.Wait();
+  return trees;
 }
 
-[[nodiscard]] static CallTreeThread* GetOrCreateThreadNode(
-    CallTreeNode* current_node, uint32_t tid, const std::string& process_name,
-    const absl::flat_hash_map<uint32_t, std::string>& thread_names) {
-  CallTreeThread* thread_node = current_node->GetThreadOrNull(tid);
-  if (thread_node == nullptr) {
-    std::string thread_name;
-    if (tid == orbit_base::kAllProcessThreadsTid) {
-      thread_name = process_name;
-    } else if (auto thread_name_it = thread_names.find(tid); thread_name_it != thread_names.end()) {
-      thread_name = thread_name_it->second;
+namespace {
+struct FunctionNodeNames {
+  std::string function_name;
+  std::string module_path;
+  std::string module_build_id;
+};
+}  // namespace
+
+void CallTreeView::CreateNodes(absl::Span<const CallTreeBuilder> trees,
+                               const ModuleManager& module_manager,
+                               const CaptureData& capture_data) {
+  // Reserve all the memory upfront: nodes point to each other and into the array of
+  // CallstackEvents, so none of these vectors can be reallocated.
+  std::array<size_t, CallTreeBuilder::kNodeTypeCount> node_count_by_type{};
+  size_t callstack_event_count = 0;
+  for (const CallTreeBuilder& tree : trees) {
+    const CallTreeBuilder::Node& tree_root = tree.nodes()[CallTreeBuilder::kRootIndex];
+    ORBIT_CHECK(tree_root.exclusive_callstack_events.empty());
+    sample_count_ += tree_root.sample_count;
+    for (size_t i = CallTreeBuilder::kRootIndex + 1; i < tree.nodes().size(); ++i) {
+      const CallTreeBuilder::Node& tree_node = tree.nodes()[i];
+      ++node_count_by_type[static_cast<size_t>(tree_node.type)];
+      for (const std::vector<CallstackEvent>* callstack_events :
+           tree_node.exclusive_callstack_events) {
+        callstack_event_count += callstack_events->size();
+      }
     }
-    thread_node = current_node->AddAndGetThread(tid, std::move(thread_name));
   }
-  return thread_node;
-}
+  thread_nodes_.reserve(node_count_by_type[static_cast<size_t>(NodeType::kThread)]);
+  function_nodes_.reserve(node_count_by_type[static_cast<size_t>(NodeType::kFunction)]);
+  unwind_errors_nodes_.reserve(node_count_by_type[static_cast<size_t>(NodeType::kUnwindErrors)]);
+  unwind_error_type_nodes_.reserve(
+      node_count_by_type[static_cast<size_t>(NodeType::kUnwindErrorType)]);
+  exclusive_callstack_events_of_all_nodes_.reserve(callstack_event_count);
 
-std::unique_ptr<CallTreeView> CallTreeView::CreateTopDownViewFromPostProcessedSamplingData(
-    const PostProcessedSamplingData& post_processed_sampling_data,
-    const ModuleManager& module_manager, const CaptureData& capture_data) {
-  ORBIT_SCOPE_FUNCTION;
-  ORBIT_SCOPED_TIMED_LOG("CreateTopDownViewFromPostProcessedSamplingData");
-
-  auto top_down_view = std::make_unique<CallTreeView>();
   const std::string& process_name = capture_data.process_name();
   const absl::flat_hash_map<uint32_t, std::string>& thread_names = capture_data.thread_names();
-
-  for (const ThreadSampleData* thread_sample_data :
-       post_processed_sampling_data.GetSortedThreadSampleData()) {
-    const uint32_t tid = thread_sample_data->thread_id;
-
-    for (const auto& [callstack_id, callstack_events] :
-         thread_sample_data->sampled_callstack_id_to_events) {
-      uint64_t sample_count = callstack_events.size();
-
-      // Don't count samples from the all-thread case again.
-      if (tid != orbit_base::kAllProcessThreadsTid) {
-        top_down_view->IncreaseSampleCount(sample_count);
+  // The same function appears in many nodes, so only look up its names once.
+  absl::flat_hash_map<uint64_t, FunctionNodeNames> function_names_by_address;
+
+  auto create_node = [&](const CallTreeBuilder::Node& tree_node,
+                         CallTreeNode* parent) -> CallTreeNode* {
+    switch (tree_node.type) {
+      case NodeType::kThread: {
+        const auto tid = static_cast<uint32_t>(tree_node.key);
+        std::string thread_name;
+        if (tid == orbit_base::kAllProcessThreadsTid) {
+          thread_name = process_name;
+        } else if (auto thread_name_it = thread_names.find(tid);
+                   thread_name_it != thread_names.end()) {
+          thread_name = thread_name_it->second;
+        }
+        ++parent->thread_count_;
+        return &thread_nodes_.emplace_back(tid, std::move(thread_name), parent);
       }
-
-      CallTreeThread* thread_node =
-          GetOrCreateThreadNode(top_down_view.get(), tid, process_name, thread_names);
-      thread_node->IncreaseSampleCount(sample_count);
-
-      const CallstackInfo& resolved_callstack =
-          post_processed_sampling_data.GetResolvedCallstack(callstack_id);
-      if (resolved_callstack.type() == CallstackType::kComplete) {
-        AddCallstackToTopDownThread(thread_node, resolved_callstack, callstack_events,
-                                    module_manager, capture_data);
-      } else {
-        AddUnwindErrorToTopDownThread(thread_node, resolved_callstack, callstack_events,
-                                      module_manager, capture_data);
+      case NodeType::kFunction: {
+        const uint64_t frame = tree_node.key;
+        auto [names_it, inserted] = function_names_by_address.try_emplace(frame);
+        FunctionNodeNames& names = names_it->second;
+        if (inserted) {
+          const std::string& function_name =
+              orbit_client_data::GetFunctionNameByAddress(module_manager, capture_data, frame);
+          if (function_name != orbit_client_data::kUnknownFunctionOrModuleName) {
+            names.function_name = function_name;
+          } else {
+            names.function_name = absl::StrFormat("[unknown@%#llx]", frame);
+          }
+          const auto& [module_path, module_build_id] =
+              orbit_client_data::FindModulePathAndBuildIdByAddress(module_manager, capture_data,
+                                                                   frame);
+          names.module_path = module_path;
+          names.module_build_id = module_build_id.value_or("");
+        }
+        return &function_nodes_.emplace_back(frame, names.function_name, names.module_path,
+                                              names.module_build_id, parent);
       }
+      case NodeType::kUnwindErrors:
+        return &unwind_errors_nodes_.emplace_back(parent);
+      case NodeType::kUnwindErrorType:
+        return &unwind_error_type_nodes_.emplace_back(
+            parent, static_cast<CallstackType>(tree_node.key));
     }
-  }
-  return top_down_view;
-}
+    ORBIT_UNREACHABLE();
+  };
+
+  struct NodeToVisit {
+    const CallTreeBuilder* tree;
+    uint32_t tree_node_index;
+    CallTreeNode* node;
+  };
+  std::vector<NodeToVisit> nodes_to_visit;
+  std::vector<uint32_t> sorted_tree_children;
+
+  auto create_children = [&](const CallTreeBuilder& tree, uint32_t tree_node_index,
+                             CallTreeNode* node) {
+    const std::vector<CallTreeBuilder::Node>& tree_nodes = tree.nodes();
+    sorted_tree_children.clear();
+    for (uint32_t tree_child_index = tree_nodes[tree_node_index].first_child_index;
+         tree_child_index != CallTreeBuilder::kNoNodeIndex;
+         tree_child_index = tree_nodes[tree_child_index].next_sibling_index) {
+      sorted_tree_children.push_back(tree_child_index);
+    }
+    std::sort(sorted_tree_children.begin(), sorted_tree_children.end(),
+              [&tree_nodes](uint32_t lhs, uint32_t rhs) {
+                return std::tie(tree_nodes[lhs].type, tree_nodes[lhs].key) <
+                       std::tie(tree_nodes[rhs].type, tree_nodes[rhs].key);
+              });
+    node->children_.reserve(node->children_.size() + sorted_tree_children.size());
+    for (uint32_t tree_child_index : sorted_tree_children) {
+      const CallTreeBuilder::Node& tree_child = tree_nodes[tree_child_index];
+      CallTreeNode* child = create_node(tree_child, node);
+      child->sample_count_ = tree_child.sample_count;
+
+      const size_t events_begin = exclusive_callstack_events_of_all_nodes_.size();
+      for (const std::vector<CallstackEvent>* callstack_events :
+           tree_child.exclusive_callstack_events) {
+        exclusive_callstack_events_of_all_nodes_.insert(
+            exclusive_callstack_events_of_all_nodes_.end(), callstack_events->begin(),
+            callstack_events->end());
+      }
+      child->exclusive_callstack_events_ = absl::MakeConstSpan(
+          exclusive_callstack_events_of_all_nodes_.data() + events_begin,
+          exclusive_callstack_events_of_all_nodes_.size() - events_begin);
 
-[[nodiscard]] static CallTreeNode* AddReversedCallstackToBottomUpViewAndReturnLastFunction(
-    CallTreeView* bottom_up_view, const CallstackInfo& resolved_callstack,
-    uint64_t callstack_sample_count, const ModuleManager& module_manager,
-    const CaptureData& capture_data) {
-  CallTreeNode* current_node = bottom_up_view;
-  for (uint64_t frame : resolved_callstack.frames()) {
-    const std::string& function_name =
-        orbit_client_data::GetFunctionNameByAddress(module_manager, capture_data, frame);
-    const auto& [module_path, module_build_id] =
-        orbit_client_data::FindModulePathAndBuildIdByAddress(module_manager, capture_data, frame);
-
-    CallTreeFunction* function_node = GetOrCreateFunctionNode(
-        current_node, frame, function_name, module_path, module_build_id.value_or(""));
-    function_node->IncreaseSampleCount(callstack_sample_count);
-    current_node = function_node;
-  }
-  return current_node;
-}
+      node->children_.push_back(child);
+      nodes_to_visit.push_back({&tree, tree_child_index, child});
+    }
+  };
 
-[[nodiscard]] static CallTreeUnwindErrorType*
-AddUnwindErrorToBottomUpViewAndReturnUnwindErrorTypeNode(CallTreeView* bottom_up_view,
-                                                         const CallstackInfo& resolved_callstack,
-                                                         uint64_t callstack_sample_count,
-                                                         const ModuleManager& module_manager,
-                                                         const CaptureData& capture_data) {
-  ORBIT_CHECK(!resolved_callstack.frames().empty());
-  // Only use the innermost frame for unwind errors.
-  uint64_t frame = resolved_callstack.frames()[0];
-  const std::string& function_name =
-      orbit_client_data::GetFunctionNameByAddress(module_manager, capture_data, frame);
-  const auto& [module_path, module_build_id] =
-      orbit_client_data::FindModulePathAndBuildIdByAddress(module_manager, capture_data, frame);
-  CallTreeFunction* function_node = GetOrCreateFunctionNode(
-      bottom_up_view, frame, function_name, module_path, module_build_id.value_or(""));
-  function_node->IncreaseSampleCount(callstack_sample_count);
-
-  CallTreeUnwindErrors* unwind_errors_node = function_node->GetUnwindErrorsOrNull();
-  if (unwind_errors_node == nullptr) {
-    unwind_errors_node = function_node->AddAndGetUnwindErrors();
+  for (const CallTreeBuilder& tree : trees) {
+    create_children(tree, CallTreeBuilder::kRootIndex, this);
+  }
+  while (!nodes_to_visit.empty()) {
+    const NodeToVisit node_to_visit = nodes_to_visit.back();
+    nodes_to_visit.pop_back();
+    create_children(*node_to_visit.tree, node_to_visit.tree_node_index, node_to_visit.node);
   }
-  unwind_errors_node->IncreaseSampleCount(callstack_sample_count);
+}
 
-  CallTreeUnwindErrorType* unwind_error_type_node =
-      GetOrCreateUnwindErrorTypeNode(unwind_errors_node, resolved_callstack.type());
-  unwind_error_type_node->IncreaseSampleCount(callstack_sample_count);
+std::unique_ptr<CallTreeView> CallTreeView::CreateTopDownViewFromPostProcessedSamplingData(
+    const PostProcessedSamplingData& post_processed_sampling_data,
+    const ModuleManager& module_manager, const CaptureData& capture_data) {
+  ORBIT_SCOPE_FUNCTION;
+  ORBIT_SCOPED_TIMED_LOG("CreateTopDownViewFromPostProcessedSamplingData");
 
-  return unwind_error_type_node;
+  // The trees of different threads only share the root, so they don't need to be merged.
+  const std::vector<CallTreeBuilder> trees =
+      BuildTreesOfThreadsInParallel(post_processed_sampling_data, &BuildTopDownTreeOfThread);
+  auto top_down_view = std::make_unique<CallTreeView>();
+  top_down_view->CreateNodes(trees, module_manager, capture_data);
+  return top_down_view;
 }
 
 std::unique_ptr<CallTreeView> CallTreeView::CreateBottomUpViewFromPostProcessedSamplingData(
@@ -301,38 +383,26 @@ std::unique_ptr<CallTreeView> CallTreeView::CreateBottomUpViewFromPostProcessedS
   ORBIT_SCOPE_FUNCTION;
   ORBIT_SCOPED_TIMED_LOG("CreateBottomUpViewFromPostProcessedSamplingData");
 
-  auto bottom_up_view = std::make_unique<CallTreeView>();
-  const std::string& process_name = capture_data.process_name();
-  const absl::flat_hash_map<uint32_t, std::string>& thread_names = capture_data.thread_names();
-
-  for (const ThreadSampleData* thread_sample_data :
-       post_processed_sampling_data.GetSortedThreadSampleData()) {
-    const uint32_t tid = thread_sample_data->thread_id;
-    if (tid == orbit_base::kAllProcessThreadsTid) {
-      continue;
-    }
-
-    for (const auto& [callstack_id, callstack_events] :
-         thread_sample_data->sampled_callstack_id_to_events) {
-      uint64_t sample_count = callstack_events.size();
-      bottom_up_view->IncreaseSampleCount(sample_count);
-
-      const CallstackInfo& resolved_callstack =
-          post_processed_sampling_data.GetResolvedCallstack(callstack_id);
-      CallTreeNode* last_node;
-      if (resolved_callstack.type() == CallstackType::kComplete) {
-        last_node = AddReversedCallstackToBottomUpViewAndReturnLastFunction(
-            bottom_up_view.get(), resolved_callstack, sample_count, module_manager, capture_data);
-      } else {
-        last_node = AddUnwindErrorToBottomUpViewAndReturnUnwindErrorTypeNode(
-            bottom_up_view.get(), resolved_callstack, sample_count, module_manager, capture_data);
+  const std::vector<CallTreeBuilder> trees =
+      BuildTreesOfThreadsInParallel(post_processed_sampling_data, &BuildBottomUpTreeOfThread);
+
+  // The trees of the threads are merged in parallel too: the subtrees of different innermost
+  // functions are disjoint, so each task merges the subtrees of a subset of these functions.
+  constexpr size_t kMergedTreeCount = 32;
+  std::vector<CallTreeBuilder> merged_trees(kMergedTreeCount);
+  orbit_base::TaskGroup task_group;
+  for (size_t i = 0; i < kMergedTreeCount; ++i) {
+    task_group.AddTask([&trees, &merged_tree = merged_trees[i], i] {
+      for (const CallTreeBuilder& tree : trees) {
+        merged_tree.MergeChildrenOfRoot(tree, [i](const CallTreeBuilder::Node& innermost_function) {
+          return absl::Hash<uint64_t>{}(innermost_function.key) % kMergedTreeCount == i;
+        });
       }
-      CallTreeThread* thread_node =
-          GetOrCreateThreadNode(last_node, tid, process_name, thread_names);
-      thread_node->IncreaseSampleCount(sample_count);
-      thread_node->AddExclusiveCallstackEvents(callstack_events);
-    }
+    });
   }
+  task_group.Wait();
 
+  auto bottom_up_view = std::make_unique<CallTreeView>();
+  bottom_up_view->CreateNodes(merged_trees, module_manager, capture_data);
   return bottom_up_view;
 }
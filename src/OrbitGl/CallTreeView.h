@@ -5,7 +5,7 @@
 #ifndef ORBIT_GL_CALL_TREE_VIEW_H_
 #define ORBIT_GL_CALL_TREE_VIEW_H_
 
-#include <absl/container/node_hash_map.h>
+#include <absl/types/span.h>
 
 #include <cstdint>
 #include <filesystem>
@@ -14,10 +14,14 @@
 #include <utility>
 #include <vector>
 
+#include "ClientData/CallstackEvent.h"
 #include "ClientData/CallstackType.h"
 #include "ClientData/CaptureData.h"
+#include "ClientData/ModuleManager.h"
 #include "ClientData/PostProcessedSamplingData.h"
+#include "OrbitBase/Logging.h"
 
+class CallTreeBuilder;
 class CallTreeThread;
 class CallTreeFunction;
 class CallTreeUnwindErrors;
@@ -31,42 +35,15 @@ class CallTreeNode {
   // parent(), child_count(), children() are needed by CallTreeViewItemModel.
   [[nodiscard]] const CallTreeNode* parent() const { return parent_; }
 
-  [[nodiscard]] uint64_t child_count() const {
-    return thread_children_.size() + function_children_.size() +
-           unwind_error_type_children_.size() + (unwind_errors_child_ != nullptr ? 1 : 0);
-  }
-
-  [[nodiscard]] uint64_t thread_count() const { return thread_children_.size(); }
-
-  [[nodiscard]] const std::vector<const CallTreeNode*>& children() const;
-
-  [[nodiscard]] CallTreeThread* GetThreadOrNull(uint32_t thread_id);
-
-  [[nodiscard]] CallTreeThread* AddAndGetThread(uint32_t thread_id, std::string thread_name);
-
-  [[nodiscard]] CallTreeFunction* GetFunctionOrNull(uint64_t function_absolute_address);
-
-  [[nodiscard]] CallTreeFunction* AddAndGetFunction(uint64_t function_absolute_address,
-                                                    std::string function_name,
-                                                    std::string module_path,
-                                                    std::string module_build_id);
-
-  [[nodiscard]] CallTreeUnwindErrorType* GetUnwindErrorTypeOrNull(
-      orbit_client_data::CallstackType type);
-
-  [[nodiscard]] CallTreeUnwindErrorType* AddAndGetUnwindErrorType(
-      orbit_client_data::CallstackType type);
+  [[nodiscard]] uint64_t child_count() const { return children_.size(); }
 
-  [[nodiscard]] CallTreeUnwindErrors* GetUnwindErrorsOrNull();
+  [[nodiscard]] uint64_t thread_count() const { return thread_count_; }
 
-  [[nodiscard]] CallTreeUnwindErrors* AddAndGetUnwindErrors();
+  // Threads come first, then functions, then the unwind errors node, then unwind error types.
+  [[nodiscard]] const std::vector<const CallTreeNode*>& children() const { return children_; }
 
   [[nodiscard]] uint64_t sample_count() const { return sample_count_; }
 
-  void IncreaseSampleCount(uint64_t sample_count_increase) {
-    sample_count_ += sample_count_increase;
-  }
-
   [[nodiscard]] float GetInclusivePercent(uint64_t total_sample_count) const {
     return 100.0f * sample_count() / total_sample_count;
   }
@@ -86,35 +63,21 @@ class CallTreeNode {
     return 100.0f * GetExclusiveSampleCount() / total_sample_count;
   }
 
-  void AddExclusiveCallstackEvents(
-      const std::vector<orbit_client_data::CallstackEvent>& callstack_events) {
-    exclusive_callstack_events_.insert(exclusive_callstack_events_.end(), callstack_events.begin(),
-                                       callstack_events.end());
-  }
-
-  [[nodiscard]] const std::vector<orbit_client_data::CallstackEvent>& exclusive_callstack_events()
+  // Points into the CallTreeView this node belongs to.
+  [[nodiscard]] absl::Span<const orbit_client_data::CallstackEvent> exclusive_callstack_events()
       const {
     return exclusive_callstack_events_;
   }
 
  private:
-  // absl::node_hash_map instead of absl::flat_hash_map as pointer stability is
-  // needed for the CallTreeNode::parent_ field.
-  absl::node_hash_map<uint32_t, CallTreeThread> thread_children_;
-  absl::node_hash_map<uint64_t, CallTreeFunction> function_children_;
-  absl::node_hash_map<orbit_client_data::CallstackType, CallTreeUnwindErrorType>
-      unwind_error_type_children_;
-  // std::shared_ptr instead of std::unique_ptr because absl::node_hash_map
-  // needs the copy constructor (even for try_emplace).
-  std::shared_ptr<CallTreeUnwindErrors> unwind_errors_child_;
+  // Nodes are only ever created and linked together by CallTreeView.
+  friend class CallTreeView;
 
   CallTreeNode* parent_;
+  std::vector<const CallTreeNode*> children_;
+  uint64_t thread_count_ = 0;
   uint64_t sample_count_ = 0;
-  // Note that we are copying the CallstackEvents into the tree.
-  std::vector<orbit_client_data::CallstackEvent> exclusive_callstack_events_;
-
-  // Filled lazily when children() is called, invalidated when children are invalidated.
-  mutable std::optional<std::vector<const CallTreeNode*>> children_cache_;
+  absl::Span<const orbit_client_data::CallstackEvent> exclusive_callstack_events_;
 };
 
 class CallTreeFunction : public CallTreeNode {
@@ -180,6 +143,12 @@ class CallTreeUnwindErrorType : public CallTreeNode {
   orbit_client_data::CallstackType error_type_;
 };
 
+// The root of a top-down or bottom-up tree. The samples of each thread are first aggregated into an
+// intermediate tree, in parallel, and these trees are then turned into the final nodes. For the
+// bottom-up view, where the threads share subtrees, they are merged in between, also in parallel.
+// The final nodes are stored in one array per node type, allocated upfront to their final size,
+// and the exclusive CallstackEvents of all nodes are copied once into a single array, in which each
+// node refers to its range.
 class CallTreeView : public CallTreeNode {
  public:
   [[nodiscard]] static std::unique_ptr<CallTreeView> CreateTopDownViewFromPostProcessedSamplingData(
@@ -194,6 +163,22 @@ class CallTreeView : public CallTreeNode {
       const orbit_client_data::CaptureData& capture_data);
 
   CallTreeView() : CallTreeNode{nullptr} {}
+
+  // The nodes point into the arrays of this object, and to it as their root.
+  CallTreeView(const CallTreeView&) = delete;
+  CallTreeView& operator=(const CallTreeView&) = delete;
+
+ private:
+  // The children of the roots of different trees must be distinct.
+  void CreateNodes(absl::Span<const CallTreeBuilder> trees,
+                   const orbit_client_data::ModuleManager& module_manager,
+                   const orbit_client_data::CaptureData& capture_data);
+
+  std::vector<CallTreeThread> thread_nodes_;
+  std::vector<CallTreeFunction> function_nodes_;
+  std::vector<CallTreeUnwindErrors> unwind_errors_nodes_;
+  std::vector<CallTreeUnwindErrorType> unwind_error_type_nodes_;
+  std::vector<orbit_client_data::CallstackEvent> exclusive_callstack_events_of_all_nodes_;
 };
 
 #endif  // ORBIT_GL_CALL_TREE_VIEW_H_
@@ -0,0 +1,312 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <absl/container/flat_hash_set.h>
+#include <absl/strings/str_format.h>
+#include <absl/time/clock.h>
+#include <absl/time/time.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <stdint.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "CallTreeView.h"
+#include "ClientData/CallstackEvent.h"
+#include "ClientData/CallstackInfo.h"
+#include "ClientData/CallstackType.h"
+#include "ClientData/CaptureData.h"
+#include "ClientData/LinuxAddressInfo.h"
+#include "ClientData/ModuleManager.h"
+#include "ClientData/PostProcessedSamplingData.h"
+#include "ClientModel/SamplingDataPostProcessor.h"
+#include "ClientProtos/capture_data.pb.h"
+#include "GrpcProtos/capture.pb.h"
+#include "OrbitBase/Logging.h"
+#include "OrbitBase/ThreadConstants.h"
+
+using orbit_client_data::CallstackEvent;
+using orbit_client_data::CallstackInfo;
+using orbit_client_data::CallstackType;
+using orbit_client_data::CaptureData;
+using orbit_client_data::ModuleManager;
+using orbit_client_data::PostProcessedSamplingData;
+
+namespace {
+
+constexpr uint64_t kCallstackId1 = 1;
+constexpr uint64_t kCallstackId2 = 2;
+constexpr uint64_t kUnwindErrorCallstackId = 3;
+
+constexpr uint64_t kOuterFunctionAddress = 0x10;
+constexpr uint64_t kOuterInstructionAddress = 0x11;
+constexpr uint64_t kInnerFunctionAddress = 0x20;
+constexpr uint64_t kInnerInstructionAddress = 0x21;
+constexpr const char* kOuterFunctionName = "outer";
+constexpr const char* kInnerFunctionName = "inner";
+constexpr const char* kModuleName = "example module";
+
+constexpr uint32_t kThreadId1 = 42;
+constexpr uint32_t kThreadId2 = 43;
+constexpr const char* kProcessName = "example process";
+constexpr const char* kThreadName1 = "thread 1";
+constexpr const char* kThreadName2 = "thread 2";
+
+std::unique_ptr<CaptureData> GenerateTestCaptureData() {
+  orbit_grpc_protos::CaptureStarted capture_started;
+  capture_started.set_executable_path(absl::StrFormat("/path/to/%s", kProcessName));
+  auto capture_data = std::make_unique<CaptureData>(capture_started, std::nullopt,
+                                                    absl::flat_hash_set<uint64_t>{},
+                                                    CaptureData::DataSource::kLiveCapture);
+
+  capture_data->InsertAddressInfo(orbit_client_data::LinuxAddressInfo{
+      kOuterInstructionAddress, kOuterInstructionAddress - kOuterFunctionAddress, kModuleName,
+      kOuterFunctionName});
+  capture_data->InsertAddressInfo(orbit_client_data::LinuxAddressInfo{
+      kInnerInstructionAddress, kInnerInstructionAddress - kInnerFunctionAddress, kModuleName,
+      kInnerFunctionName});
+
+  // Frames are listed from the innermost to the outermost.
+  capture_data->AddUniqueCallstack(
+      kCallstackId1, CallstackInfo{{kInnerInstructionAddress, kOuterInstructionAddress},
+                                   CallstackType::kComplete});
+  capture_data->AddUniqueCallstack(
+      kCallstackId2, CallstackInfo{{kOuterInstructionAddress}, CallstackType::kComplete});
+  capture_data->AddUniqueCallstack(
+      kUnwindErrorCallstackId,
+      CallstackInfo{{kInnerInstructionAddress}, CallstackType::kFramePointerUnwindingError});
+
+  capture_data->AddCallstackEvent({1000, kCallstackId1, kThreadId1});
+  capture_data->AddCallstackEvent({1001, kCallstackId1, kThreadId1});
+  capture_data->AddCallstackEvent({1002, kCallstackId2, kThreadId1});
+  capture_data->AddCallstackEvent({1003, kCallstackId1, kThreadId2});
+  capture_data->AddCallstackEvent({1004, kUnwindErrorCallstackId, kThreadId2});
+
+  capture_data->AddOrAssignThreadName(kThreadId1, kThreadName1);
+  capture_data->AddOrAssignThreadName(kThreadId2, kThreadName2);
+  return capture_data;
+}
+
+[[nodiscard]] std::vector<uint64_t> GetTimestamps(const CallTreeNode& node) {
+  std::vector<uint64_t> timestamps;
+  for (const CallstackEvent& event : node.exclusive_callstack_events()) {
+    timestamps.push_back(event.timestamp_ns());
+  }
+  return timestamps;
+}
+
+[[nodiscard]] const CallTreeThread* GetThreadChild(const CallTreeNode& node, uint32_t tid) {
+  for (const CallTreeNode* child : node.children()) {
+    const auto* thread = dynamic_cast<const CallTreeThread*>(child);
+    if (thread != nullptr && thread->thread_id() == tid) return thread;
+  }
+  return nullptr;
+}
+
+[[nodiscard]] const CallTreeFunction* GetFunctionChild(const CallTreeNode& node,
+                                                       uint64_t function_address) {
+  for (const CallTreeNode* child : node.children()) {
+    const auto* function = dynamic_cast<const CallTreeFunction*>(child);
+    if (function != nullptr && function->function_absolute_address() == function_address) {
+      return function;
+    }
+  }
+  return nullptr;
+}
+
+void ExpectParentsAreConsistent(const CallTreeNode& node) {
+  for (const CallTreeNode* child : node.children()) {
+    EXPECT_EQ(child->parent(), &node);
+    ExpectParentsAreConsistent(*child);
+  }
+}
+
+class CallTreeViewTest : public testing::Test {
+ protected:
+  CallTreeViewTest()
+      : capture_data_{GenerateTestCaptureData()},
+        sampling_data_{orbit_client_model::CreatePostProcessedSamplingData(
+            capture_data_->GetCallstackData(), *capture_data_, module_manager_)} {}
+
+  std::unique_ptr<CaptureData> capture_data_;
+  ModuleManager module_manager_;
+  PostProcessedSamplingData sampling_data_;
+};
+
+}  // namespace
+
+TEST(CallTreeView, EmptyView) {
+  CallTreeView view;
+  EXPECT_EQ(view.parent(), nullptr);
+  EXPECT_EQ(view.child_count(), 0);
+  EXPECT_EQ(view.sample_count(), 0);
+  EXPECT_EQ(view.GetExclusiveSampleCount(), 0);
+}
+
+TEST_F(CallTreeViewTest, TopDownView) {
+  std::unique_ptr<CallTreeView> view = CallTreeView::CreateTopDownViewFromPostProcessedSamplingData(
+      sampling_data_, module_manager_, *capture_data_);
+  ExpectParentsAreConsistent(*view);
+
+  // The samples of the "all threads" summary are not counted again.
+  EXPECT_EQ(view->sample_count(), 5);
+  EXPECT_EQ(view->child_count(), 3);
+  EXPECT_EQ(view->thread_count(), 3);
+
+  const CallTreeThread* all_threads = GetThreadChild(*view, orbit_base::kAllProcessThreadsTid);
+  ASSERT_NE(all_threads, nullptr);
+  EXPECT_EQ(all_threads->thread_name(), kProcessName);
+  EXPECT_EQ(all_threads->sample_count(), 5);
+
+  const CallTreeThread* thread1 = GetThreadChild(*view, kThreadId1);
+  ASSERT_NE(thread1, nullptr);
+  EXPECT_EQ(thread1->thread_name(), kThreadName1);
+  EXPECT_EQ(thread1->sample_count(), 3);
+  EXPECT_EQ(thread1->child_count(), 1);
+
+  const CallTreeFunction* outer = GetFunctionChild(*thread1, kOuterFunctionAddress);
+  ASSERT_NE(outer, nullptr);
+  EXPECT_EQ(outer->function_name(), kOuterFunctionName);
+  EXPECT_EQ(outer->module_path(), kModuleName);
+  EXPECT_EQ(outer->sample_count(), 3);
+  EXPECT_THAT(GetTimestamps(*outer), testing::ElementsAre(1002));
+
+  const CallTreeFunction* inner = GetFunctionChild(*outer, kInnerFunctionAddress);
+  ASSERT_NE(inner, nullptr);
+  EXPECT_EQ(inner->function_name(), kInnerFunctionName);
+  EXPECT_EQ(inner->sample_count(), 2);
+  EXPECT_EQ(inner->child_count(), 0);
+  EXPECT_THAT(GetTimestamps(*inner), testing::UnorderedElementsAre(1000, 1001));
+
+  const CallTreeThread* thread2 = GetThreadChild(*view, kThreadId2);
+  ASSERT_NE(thread2, nullptr);
+  EXPECT_EQ(thread2->sample_count(), 2);
+  ASSERT_EQ(thread2->child_count(), 2);
+  // Functions come before unwind errors.
+  EXPECT_NE(dynamic_cast<const CallTreeFunction*>(thread2->children()[0]), nullptr);
+  const auto* unwind_errors = dynamic_cast<const CallTreeUnwindErrors*>(thread2->children()[1]);
+  ASSERT_NE(unwind_errors, nullptr);
+  EXPECT_EQ(unwind_errors->sample_count(), 1);
+  ASSERT_EQ(unwind_errors->child_count(), 1);
+  const auto* unwind_error_type =
+      dynamic_cast<const CallTreeUnwindErrorType*>(unwind_errors->children()[0]);
+  ASSERT_NE(unwind_error_type, nullptr);
+  EXPECT_EQ(unwind_error_type->error_type(), CallstackType::kFramePointerUnwindingError);
+  const CallTreeFunction* unwind_error_function =
+      GetFunctionChild(*unwind_error_type, kInnerFunctionAddress);
+  ASSERT_NE(unwind_error_function, nullptr);
+  EXPECT_EQ(unwind_error_function->sample_count(), 1);
+  EXPECT_THAT(GetTimestamps(*unwind_error_function), testing::ElementsAre(1004));
+}
+
+TEST_F(CallTreeViewTest, BottomUpView) {
+  std::unique_ptr<CallTreeView> view =
+      CallTreeView::CreateBottomUpViewFromPostProcessedSamplingData(sampling_data_, module_manager_,
+                                                                    *capture_data_);
+  ExpectParentsAreConsistent(*view);
+
+  EXPECT_EQ(view->sample_count(), 5);
+  EXPECT_EQ(view->child_count(), 2);
+  EXPECT_EQ(view->thread_count(), 0);
+
+  const CallTreeFunction* inner = GetFunctionChild(*view, kInnerFunctionAddress);
+  ASSERT_NE(inner, nullptr);
+  EXPECT_EQ(inner->sample_count(), 4);
+  // Callstack 1 continues with the outer function, while the unwind error stops here.
+  ASSERT_EQ(inner->child_count(), 2);
+
+  const CallTreeFunction* inner_outer = GetFunctionChild(*inner, kOuterFunctionAddress);
+  ASSERT_NE(inner_outer, nullptr);
+  EXPECT_EQ(inner_outer->sample_count(), 3);
+  EXPECT_EQ(inner_outer->thread_count(), 2);
+  const CallTreeThread* inner_outer_thread1 = GetThreadChild(*inner_outer, kThreadId1);
+  ASSERT_NE(inner_outer_thread1, nullptr);
+  EXPECT_EQ(inner_outer_thread1->sample_count(), 2);
+  EXPECT_THAT(GetTimestamps(*inner_outer_thread1), testing::UnorderedElementsAre(1000, 1001));
+  const CallTreeThread* inner_outer_thread2 = GetThreadChild(*inner_outer, kThreadId2);
+  ASSERT_NE(inner_outer_thread2, nullptr);
+  EXPECT_THAT(GetTimestamps(*inner_outer_thread2), testing::ElementsAre(1003));
+
+  const auto* unwind_errors = dynamic_cast<const CallTreeUnwindErrors*>(inner->children()[1]);
+  ASSERT_NE(unwind_errors, nullptr);
+  EXPECT_EQ(unwind_errors->sample_count(), 1);
+  ASSERT_EQ(unwind_errors->child_count(), 1);
+  const CallTreeNode* unwind_error_type = unwind_errors->children()[0];
+  const CallTreeThread* unwind_error_thread = GetThreadChild(*unwind_error_type, kThreadId2);
+  ASSERT_NE(unwind_error_thread, nullptr);
+  EXPECT_THAT(GetTimestamps(*unwind_error_thread), testing::ElementsAre(1004));
+
+  const CallTreeFunction* outer = GetFunctionChild(*view, kOuterFunctionAddress);
+  ASSERT_NE(outer, nullptr);
+  EXPECT_EQ(outer->sample_count(), 1);
+  const CallTreeThread* outer_thread1 = GetThreadChild(*outer, kThreadId1);
+  ASSERT_NE(outer_thread1, nullptr);
+  EXPECT_THAT(GetTimestamps(*outer_thread1), testing::ElementsAre(1002));
+}
+
+// Logs how long creating the call tree views of a large synthetic capture takes. Disabled by
+// default.
+TEST(CallTreeView, DISABLED_BenchmarkCreateViews) {
+  constexpr uint32_t kThreadCount = 32;
+  constexpr uint64_t kFunctionCount = 1000;
+  constexpr uint64_t kCallstackCount = 5000;
+  constexpr uint64_t kCallstackDepth = 20;
+  constexpr uint64_t kSampleCount = 2'000'000;
+
+  CaptureData capture_data{orbit_grpc_protos::CaptureStarted{}, std::nullopt,
+                           absl::flat_hash_set<uint64_t>{},
+                           CaptureData::DataSource::kLiveCapture};
+  for (uint64_t function = 0; function < kFunctionCount; ++function) {
+    const uint64_t function_address = 0x1000 * (function + 1);
+    capture_data.InsertAddressInfo(orbit_client_data::LinuxAddressInfo{
+        function_address + 1, 1, kModuleName, absl::StrFormat("function%d", function)});
+  }
+  // Deterministic pseudo-random callstacks, which share their outermost frames more often than
+  // their innermost ones, as real callstacks do.
+  uint64_t random_state = 1;
+  auto next_random = [&random_state] {
+    random_state = random_state * 6364136223846793005 + 1442695040888963407;
+    return random_state >> 33;
+  };
+  for (uint64_t callstack_id = 0; callstack_id < kCallstackCount; ++callstack_id) {
+    std::vector<uint64_t> frames(kCallstackDepth);
+    for (uint64_t depth = 0; depth < kCallstackDepth; ++depth) {
+      const uint64_t function_range = 1 + kFunctionCount * depth / kCallstackDepth;
+      frames[kCallstackDepth - 1 - depth] = 0x1000 * (next_random() % function_range + 1) + 1;
+    }
+    capture_data.AddUniqueCallstack(callstack_id,
+                                    CallstackInfo{std::move(frames), CallstackType::kComplete});
+  }
+  for (uint64_t sample = 0; sample < kSampleCount; ++sample) {
+    capture_data.AddCallstackEvent({sample, next_random() % kCallstackCount,
+                                    static_cast<uint32_t>(next_random() % kThreadCount + 1)});
+  }
+
+  ModuleManager module_manager;
+  const PostProcessedSamplingData sampling_data =
+      orbit_client_model::CreatePostProcessedSamplingData(capture_data.GetCallstackData(),
+                                                          capture_data, module_manager);
+
+  absl::Time start = absl::Now();
+  std::unique_ptr<CallTreeView> top_down_view =
+      CallTreeView::CreateTopDownViewFromPostProcessedSamplingData(sampling_data, module_manager,
+                                                                   capture_data);
+  const absl::Duration top_down_duration = absl::Now() - start;
+  EXPECT_EQ(top_down_view->sample_count(), kSampleCount);
+
+  start = absl::Now();
+  std::unique_ptr<CallTreeView> bottom_up_view =
+      CallTreeView::CreateBottomUpViewFromPostProcessedSamplingData(sampling_data, module_manager,
+                                                                    capture_data);
+  const absl::Duration bottom_up_duration = absl::Now() - start;
+  EXPECT_EQ(bottom_up_view->sample_count(), kSampleCount);
+
+  ORBIT_LOG("Created the call tree views of %u samples in %u threads: top-down in %.1f ms, "
+            "bottom-up in %.1f ms",
+            kSampleCount, kThreadCount, absl::ToDoubleMilliseconds(top_down_duration),
+            absl::ToDoubleMilliseconds(bottom_up_duration));
+}
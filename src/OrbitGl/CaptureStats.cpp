@@ -7,6 +7,7 @@
 #include <absl/strings/str_format.h>
 
 #include "CaptureWindow.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "Introspection/Introspection.h"
 #include "SchedulingStats.h"
@@ -23,7 +24,7 @@ ErrorMessageOr<void> CaptureStats::Generate(CaptureWindow* capture_window, uint6
   const orbit_client_data::CaptureData* capture_data = time_graph->GetCaptureData();
   if (capture_data == nullptr) return ErrorMessage("No capture data found");
 
-  std::vector<const orbit_client_protos::TimerInfo*> sched_scopes =
+  std::vector<const orbit_client_data::TimerInfo*> sched_scopes =
       scheduler_track->GetScopesInRange(start_ns, end_ns);
   SchedulingStats::ThreadNameProvider thread_name_provider = [capture_data](uint32_t thread_id) {
     return capture_data->GetThreadName(thread_id);
@@ -7,6 +7,7 @@
 #include <list>
 
 #include "CaptureStats.h"
+#include "ClientData/TimerInfo.h"
 #include "SchedulerTrack.h"
 #include "SchedulingStats.h"
 
@@ -17,7 +18,7 @@ TEST(CaptureStats, NullCaptureWindow) {
 }
 
 TEST(SchedulingStats, ZeroSchedulingScopes) {
-  std::vector<const orbit_client_protos::TimerInfo*> scheduling_scopes;
+  std::vector<const orbit_client_data::TimerInfo*> scheduling_scopes;
   SchedulingStats::ThreadNameProvider thread_name_provider = [](uint32_t thread_id) {
     return std::to_string(thread_id);
   };
@@ -32,7 +33,7 @@ TEST(SchedulingStats, ZeroSchedulingScopes) {
 }
 
 TEST(SchedulingStats, SchedulingStats) {
-  std::list<orbit_client_protos::TimerInfo>
+  std::list<orbit_client_data::TimerInfo>
       scope_buffer;  // Use a list as we need pointer stability.
   auto create_scope = [&scope_buffer](uint32_t pid, uint32_t tid, int32_t cpu, uint64_t start_ns,
                                       uint64_t end_ns) {
@@ -45,7 +46,7 @@ TEST(SchedulingStats, SchedulingStats) {
     return &scope_buffer.emplace_back(std::move(timer_info));
   };
 
-  std::vector<const orbit_client_protos::TimerInfo*> scopes;
+  std::vector<const orbit_client_data::TimerInfo*> scopes;
   SchedulingStats::ThreadNameProvider thread_name_provider = [](uint32_t thread_id) {
     return std::to_string(thread_id);
   };
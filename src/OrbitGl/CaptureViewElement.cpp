@@ -44,15 +44,27 @@ void CaptureViewElement::UpdatePrimitives(PrimitiveAssembler& primitive_assemble
   text_renderer.PushTranslation(0, 0, DetermineZOffset());
 
   DoUpdatePrimitives(primitive_assembler, text_renderer, min_tick, max_tick, picking_mode);
+  UpdateChildrenPrimitives(primitive_assembler, text_renderer, min_tick, max_tick, picking_mode);
 
+  text_renderer.PopTranslation();
+  primitive_assembler.PopTranslation();
+}
+
+void CaptureViewElement::UpdateChildrenPrimitives(PrimitiveAssembler& primitive_assembler,
+                                                  TextRenderer& text_renderer, uint64_t min_tick,
+                                                  uint64_t max_tick, PickingMode picking_mode) {
   for (CaptureViewElement* child : GetChildrenVisibleInViewport()) {
     if (child->ShouldBeRendered()) {
       child->UpdatePrimitives(primitive_assembler, text_renderer, min_tick, max_tick, picking_mode);
     }
   }
+}
 
-  text_renderer.PopTranslation();
-  primitive_assembler.PopTranslation();
+void CaptureViewElement::UpdateChildPrimitives(CaptureViewElement* child,
+                                               PrimitiveAssembler& primitive_assembler,
+                                               TextRenderer& text_renderer, uint64_t min_tick,
+                                               uint64_t max_tick, PickingMode picking_mode) {
+  child->UpdatePrimitives(primitive_assembler, text_renderer, min_tick, max_tick, picking_mode);
 }
 
 CaptureViewElement::EventResult CaptureViewElement::OnMouseWheel(
@@ -231,6 +243,7 @@ void CaptureViewElement::RequestUpdate(RequestUpdateScope scope) {
     case orbit_gl::CaptureViewElement::RequestUpdateScope::kDrawAndUpdatePrimitives:
       draw_requested_ = true;
       update_primitives_requested_ = true;
+      ++update_primitives_request_count_;
       break;
     default:
       ORBIT_UNREACHABLE();
@@ -111,6 +111,10 @@ class CaptureViewElement : public Pickable, public AccessibleInterfaceProvider {
   //   the newly set value differs from the previous one before calling this to avoid unneeded
   //   redraws.
   void RequestUpdate(RequestUpdateScope scope = RequestUpdateScope::kDrawAndUpdatePrimitives);
+  // Number of times an update of the primitives was requested by this element or its descendants.
+  [[nodiscard]] uint64_t GetUpdatePrimitivesRequestCount() const {
+    return update_primitives_request_count_;
+  }
 
   enum LayoutFlags : uint32_t { kNone = 0, kScaleHorizontallyWithParent = 1 << 0 };
 
@@ -137,6 +141,7 @@ class CaptureViewElement : public Pickable, public AccessibleInterfaceProvider {
 
   bool draw_requested_ = false;
   bool update_primitives_requested_ = false;
+  uint64_t update_primitives_request_count_ = 0;
   bool has_layout_changed_ = false;
 
   void Draw(PrimitiveAssembler& primitive_assembler, TextRenderer& text_renderer,
@@ -150,6 +155,16 @@ class CaptureViewElement : public Pickable, public AccessibleInterfaceProvider {
   virtual void DoUpdatePrimitives(PrimitiveAssembler& /*primitive_assembler*/,
                                   TextRenderer& /*text_renderer*/, uint64_t /*min_tick*/,
                                   uint64_t /*max_tick*/, PickingMode /*picking_mode*/) {}
+  // Calls UpdatePrimitives on all children that are visible in the viewport, in order. Override
+  // this to update the children differently, e.g. in parallel.
+  virtual void UpdateChildrenPrimitives(PrimitiveAssembler& primitive_assembler,
+                                        TextRenderer& text_renderer, uint64_t min_tick,
+                                        uint64_t max_tick, PickingMode picking_mode);
+  // Allows subclasses to call UpdatePrimitives on their children from UpdateChildrenPrimitives.
+  static void UpdateChildPrimitives(CaptureViewElement* child,
+                                    PrimitiveAssembler& primitive_assembler,
+                                    TextRenderer& text_renderer, uint64_t min_tick,
+                                    uint64_t max_tick, PickingMode picking_mode);
 
   virtual void DoUpdateLayout() {}
 
@@ -56,6 +56,14 @@ void orbit_gl::CaptureViewElementTester::SimulateDrawLoopAndCheckFlags(CaptureVi
   CheckDrawFlags(element, false, false);
 }
 
+void orbit_gl::CaptureViewElementTester::UpdatePrimitives(CaptureViewElement* element,
+                                                          PrimitiveAssembler& primitive_assembler,
+                                                          TextRenderer& text_renderer,
+                                                          uint64_t min_tick, uint64_t max_tick,
+                                                          PickingMode picking_mode) {
+  element->UpdatePrimitives(primitive_assembler, text_renderer, min_tick, max_tick, picking_mode);
+}
+
 void orbit_gl::CaptureViewElementTester::TestWidthPropagationToChildren(
     CaptureViewElement* element) {
   const float kWidth = 100, kUpdatedWidth = 50;
@@ -57,6 +57,12 @@ class CaptureViewElementTester {
   void SimulateDrawLoopAndCheckFlags(CaptureViewElement* element, bool draw,
                                      bool update_primitives);
 
+  // Calls `UpdatePrimitives` on `element` with the given PrimitiveAssembler and TextRenderer, e.g.
+  // to compare the primitives of different ways to update the same element.
+  static void UpdatePrimitives(CaptureViewElement* element,
+                               PrimitiveAssembler& primitive_assembler, TextRenderer& text_renderer,
+                               uint64_t min_tick, uint64_t max_tick, PickingMode picking_mode);
+
   const MockBatcher& GetBatcher() const { return batcher_; }
   const MockTextRenderer& GetTextRenderer() const { return text_renderer_; }
 
@@ -23,6 +23,7 @@
 #include "CaptureViewElement.h"
 #include "ClientData/CallstackData.h"
 #include "ClientData/CaptureData.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "CoreMath.h"
 #include "DisplayFormats/DisplayFormats.h"
@@ -76,7 +77,7 @@ class AccessibleCaptureWindow : public AccessibleWidgetBridge {
   CaptureWindow* window_;
 };
 
-using orbit_client_protos::TimerInfo;
+using orbit_client_data::TimerInfo;
 
 CaptureWindow::CaptureWindow(OrbitApp* app) : GlCanvas(), app_{app}, capture_client_app_{app} {
   draw_help_ = true;
@@ -190,7 +191,7 @@ void CaptureWindow::HandlePickedElement(PickingMode picking_mode, PickingId pick
   if (picking_mode == PickingMode::kClick) {
     background_clicked_ = false;
     const orbit_gl::PickingUserData* user_data = batcher.GetUserData(picking_id);
-    const orbit_client_protos::TimerInfo* timer_info =
+    const orbit_client_data::TimerInfo* timer_info =
         (user_data == nullptr ? nullptr : user_data->timer_info_);
     if (timer_info != nullptr) {
       SelectTimer(timer_info);
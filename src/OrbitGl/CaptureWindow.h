@@ -14,6 +14,7 @@
 #include "Batcher.h"
 #include "CaptureClient/AppInterface.h"
 #include "CaptureStats.h"
+#include "ClientData/TimerInfo.h"
 #include "GlCanvas.h"
 #include "OrbitAccessibility/AccessibleWidgetBridge.h"
 #include "PickingManager.h"
@@ -71,7 +72,7 @@ class CaptureWindow : public GlCanvas {
 
   void RenderHelpUi();
   void RenderSelectionOverlay();
-  void SelectTimer(const orbit_client_protos::TimerInfo* timer_info);
+  void SelectTimer(const orbit_client_data::TimerInfo* timer_info);
 
   void UpdateHorizontalScroll(float ratio);
   void UpdateVerticalScroll(float ratio);
@@ -12,6 +12,7 @@
 #include <limits>
 #include <utility>
 
+#include "ClientData/TimerInfo.h"
 #include "DisplayFormats/DisplayFormats.h"
 #include "GlCanvas.h"
 #include "GlUtils.h"
@@ -21,7 +22,7 @@
 #include "TriangleToggle.h"
 
 using orbit_client_data::CaptureData;
-using orbit_client_protos::TimerInfo;
+using orbit_client_data::TimerInfo;
 
 using orbit_gl::PrimitiveAssembler;
 using orbit_gl::TextRenderer;
@@ -97,7 +98,7 @@ float FrameTrack::GetDynamicBoxHeight(const TimerInfo& timer_info) const {
   return static_cast<float>(ratio) * GetAverageBoxHeight();
 }
 
-Color FrameTrack::GetTimerColor(const orbit_client_protos::TimerInfo& timer_info,
+Color FrameTrack::GetTimerColor(const orbit_client_data::TimerInfo& timer_info,
                                 bool /*is_selected*/, bool /*is_highlighted*/,
                                 const internal::DrawData& /*draw_data*/) const {
   Vec4 min_color(76.f, 175.f, 80.f, 255.f);
@@ -178,7 +179,7 @@ std::string FrameTrack::GetTooltip() const {
 
 std::string FrameTrack::GetBoxTooltip(const PrimitiveAssembler& primitive_assembler,
                                       PickingId id) const {
-  const orbit_client_protos::TimerInfo* timer_info = primitive_assembler.GetTimerInfo(id);
+  const orbit_client_data::TimerInfo* timer_info = primitive_assembler.GetTimerInfo(id);
   if (timer_info == nullptr) {
     return "";
   }
@@ -14,6 +14,7 @@
 #include "CallstackThreadBar.h"
 #include "ClientData/ScopeStats.h"
 #include "ClientData/TimerChain.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "CoreMath.h"
 #include "PickingManager.h"
@@ -43,15 +44,15 @@ class FrameTrack : public TimerTrack {
   }
 
   [[nodiscard]] float GetYFromTimer(
-      const orbit_client_protos::TimerInfo& timer_info) const override;
-  void OnTimer(const orbit_client_protos::TimerInfo& timer_info) override;
+      const orbit_client_data::TimerInfo& timer_info) const override;
+  void OnTimer(const orbit_client_data::TimerInfo& timer_info) override;
 
   [[nodiscard]] float GetDefaultBoxHeight() const override;
   [[nodiscard]] float GetDynamicBoxHeight(
-      const orbit_client_protos::TimerInfo& timer_info) const override;
+      const orbit_client_data::TimerInfo& timer_info) const override;
 
   [[nodiscard]] std::string GetTimesliceText(
-      const orbit_client_protos::TimerInfo& timer) const override;
+      const orbit_client_data::TimerInfo& timer) const override;
   [[nodiscard]] std::string GetTooltip() const override;
   [[nodiscard]] std::string GetBoxTooltip(const orbit_gl::PrimitiveAssembler& primitive_assembler,
                                           PickingId id) const override;
@@ -64,10 +65,12 @@ class FrameTrack : public TimerTrack {
   void DoDraw(orbit_gl::PrimitiveAssembler& primitive_assembler,
               orbit_gl::TextRenderer& text_renderer, const DrawContext& draw_context) override;
 
-  [[nodiscard]] Color GetTimerColor(const orbit_client_protos::TimerInfo& timer_info,
+  [[nodiscard]] Color GetTimerColor(const orbit_client_data::TimerInfo& timer_info,
                                     bool is_selected, bool is_highlighted,
                                     const internal::DrawData& draw_data) const override;
   [[nodiscard]] float GetHeight() const override;
+  // The height of each box depends on the duration of the frame.
+  [[nodiscard]] bool CanDrawTimerSpans() const override { return false; }
 
  private:
   [[nodiscard]] float GetCappedMaximumToAverageRatio() const;
@@ -9,6 +9,7 @@
 
 #include "ClientData/CaptureData.h"
 #include "ClientData/FunctionInfo.h"
+#include "ClientData/TimerInfo.h"
 #include "TimeGraph.h"
 
 namespace orbit_gl {
@@ -38,7 +39,7 @@ FrameTrackOnlineProcessor::FrameTrackOnlineProcessor(
 }
 
 void FrameTrackOnlineProcessor::ProcessTimer(
-    const orbit_client_protos::TimerInfo& timer_info,
+    const orbit_client_data::TimerInfo& timer_info,
     const orbit_grpc_protos::InstrumentedFunction& function) {
   uint64_t function_id = timer_info.function_id();
   if (!current_frame_track_function_ids_.contains(function_id)) {
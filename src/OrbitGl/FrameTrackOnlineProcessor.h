@@ -8,6 +8,7 @@
 #include <cstdint>
 
 #include "ClientData/CaptureData.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "GrpcProtos/capture.pb.h"
 #include "TimeGraph.h"
@@ -25,7 +26,7 @@ class FrameTrackOnlineProcessor {
   FrameTrackOnlineProcessor() = default;
   FrameTrackOnlineProcessor(const orbit_client_data::CaptureData& capture_data,
                             TimeGraph* time_graph);
-  void ProcessTimer(const orbit_client_protos::TimerInfo& timer_info,
+  void ProcessTimer(const orbit_client_data::TimerInfo& timer_info,
                     const orbit_grpc_protos::InstrumentedFunction& function);
 
   void AddFrameTrack(uint64_t function_id);
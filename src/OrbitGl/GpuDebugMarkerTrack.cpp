@@ -11,6 +11,7 @@
 
 #include "App.h"
 #include "ClientData/TimerChain.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "DisplayFormats/DisplayFormats.h"
 #include "GlUtils.h"
@@ -22,7 +23,7 @@
 #include "TriangleToggle.h"
 #include "absl/strings/str_format.h"
 
-using orbit_client_protos::TimerInfo;
+using orbit_client_data::TimerInfo;
 using orbit_gl::PrimitiveAssembler;
 
 GpuDebugMarkerTrack::GpuDebugMarkerTrack(CaptureViewElement* parent,
@@ -12,6 +12,7 @@
 #include <string_view>
 
 #include "CallstackThreadBar.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "CoreMath.h"
 #include "PickingManager.h"
@@ -48,13 +49,13 @@ class GpuDebugMarkerTrack final : public TimerTrack {
   [[nodiscard]] bool IsCollapsible() const override { return GetDepth() > 1; }
 
   [[nodiscard]] float GetYFromTimer(
-      const orbit_client_protos::TimerInfo& timer_info) const override;
-  [[nodiscard]] bool TimerFilter(const orbit_client_protos::TimerInfo& timer) const override;
-  [[nodiscard]] Color GetTimerColor(const orbit_client_protos::TimerInfo& timer, bool is_selected,
+      const orbit_client_data::TimerInfo& timer_info) const override;
+  [[nodiscard]] bool TimerFilter(const orbit_client_data::TimerInfo& timer) const override;
+  [[nodiscard]] Color GetTimerColor(const orbit_client_data::TimerInfo& timer, bool is_selected,
                                     bool is_highlighted,
                                     const internal::DrawData& draw_data) const override;
   [[nodiscard]] std::string GetTimesliceText(
-      const orbit_client_protos::TimerInfo& timer) const override;
+      const orbit_client_data::TimerInfo& timer) const override;
 
   [[nodiscard]] std::string GetBoxTooltip(const orbit_gl::PrimitiveAssembler& primitive_assembler,
                                           PickingId id) const override;
@@ -10,6 +10,7 @@
 
 #include "App.h"
 #include "ClientData/TimerChain.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "DisplayFormats/DisplayFormats.h"
 #include "GlUtils.h"
@@ -22,7 +23,7 @@
 #include "absl/strings/str_format.h"
 
 using orbit_client_data::TimerChain;
-using orbit_client_protos::TimerInfo;
+using orbit_client_data::TimerInfo;
 using orbit_gl::PrimitiveAssembler;
 
 constexpr const char* kSwQueueString = "sw queue";
@@ -54,7 +55,7 @@ std::string GpuSubmissionTrack::GetTooltip() const {
          "submissions";
 }
 
-void GpuSubmissionTrack::OnTimer(const orbit_client_protos::TimerInfo& timer_info) {
+void GpuSubmissionTrack::OnTimer(const orbit_client_data::TimerInfo& timer_info) {
   // In case of having command buffer timers, we need to double the depth of the GPU timers (as we
   // are drawing the corresponding command buffer timers below them). Therefore, we watch out for
   // those timers.
@@ -278,7 +279,7 @@ std::string GpuSubmissionTrack::GetHwExecutionTooltip(const TimerInfo& timer_inf
 }
 
 std::string GpuSubmissionTrack::GetCommandBufferTooltip(
-    const orbit_client_protos::TimerInfo& timer_info) const {
+    const orbit_client_data::TimerInfo& timer_info) const {
   return absl::StrFormat(
       "<b>Command Buffer Execution</b><br/>"
       "<i>At `vkBeginCommandBuffer` and `vkEndCommandBuffer` `vkCmdWriteTimestamp`s have been "
@@ -12,6 +12,7 @@
 #include <string_view>
 
 #include "CallstackThreadBar.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "CoreMath.h"
 #include "GpuDebugMarkerTrack.h"
@@ -48,15 +49,15 @@ class GpuSubmissionTrack : public TimerTrack {
   [[nodiscard]] std::string GetTooltip() const override;
   [[nodiscard]] float GetHeight() const override;
 
-  [[nodiscard]] const orbit_client_protos::TimerInfo* GetLeft(
-      const orbit_client_protos::TimerInfo& timer_info) const override;
-  [[nodiscard]] const orbit_client_protos::TimerInfo* GetRight(
-      const orbit_client_protos::TimerInfo& timer_info) const override;
+  [[nodiscard]] const orbit_client_data::TimerInfo* GetLeft(
+      const orbit_client_data::TimerInfo& timer_info) const override;
+  [[nodiscard]] const orbit_client_data::TimerInfo* GetRight(
+      const orbit_client_data::TimerInfo& timer_info) const override;
 
   [[nodiscard]] float GetYFromTimer(
-      const orbit_client_protos::TimerInfo& timer_info) const override;
+      const orbit_client_data::TimerInfo& timer_info) const override;
 
-  void OnTimer(const orbit_client_protos::TimerInfo& timer_info) override;
+  void OnTimer(const orbit_client_data::TimerInfo& timer_info) override;
 
   [[nodiscard]] bool IsCollapsible() const override {
     return GetDepth() > 1 || has_vulkan_layer_command_buffer_timers_;
@@ -66,14 +67,16 @@ class GpuSubmissionTrack : public TimerTrack {
   }
 
  protected:
-  [[nodiscard]] bool IsTimerActive(const orbit_client_protos::TimerInfo& timer) const override;
-  [[nodiscard]] Color GetTimerColor(const orbit_client_protos::TimerInfo& timer, bool is_selected,
+  [[nodiscard]] bool IsTimerActive(const orbit_client_data::TimerInfo& timer) const override;
+  [[nodiscard]] Color GetTimerColor(const orbit_client_data::TimerInfo& timer, bool is_selected,
                                     bool is_highlighted,
                                     const internal::DrawData& draw_data) const override;
-  [[nodiscard]] bool TimerFilter(const orbit_client_protos::TimerInfo& timer) const override;
+  [[nodiscard]] bool TimerFilter(const orbit_client_data::TimerInfo& timer) const override;
+  // Timers of different types share a chain but are drawn on different rows.
+  [[nodiscard]] bool CanDrawTimerSpans() const override { return false; }
 
   [[nodiscard]] std::string GetTimesliceText(
-      const orbit_client_protos::TimerInfo& timer) const override;
+      const orbit_client_data::TimerInfo& timer) const override;
   [[nodiscard]] std::string GetBoxTooltip(const orbit_gl::PrimitiveAssembler& primitive_assembler,
                                           PickingId id) const override;
 
@@ -84,13 +87,13 @@ class GpuSubmissionTrack : public TimerTrack {
 
   bool has_vulkan_layer_command_buffer_timers_ = false;
   [[nodiscard]] std::string GetSwQueueTooltip(
-      const orbit_client_protos::TimerInfo& timer_info) const;
+      const orbit_client_data::TimerInfo& timer_info) const;
   [[nodiscard]] std::string GetHwQueueTooltip(
-      const orbit_client_protos::TimerInfo& timer_info) const;
+      const orbit_client_data::TimerInfo& timer_info) const;
   [[nodiscard]] std::string GetHwExecutionTooltip(
-      const orbit_client_protos::TimerInfo& timer_info) const;
+      const orbit_client_data::TimerInfo& timer_info) const;
   [[nodiscard]] std::string GetCommandBufferTooltip(
-      const orbit_client_protos::TimerInfo& timer_info) const;
+      const orbit_client_data::TimerInfo& timer_info) const;
 };
 
 #endif  // ORBIT_GL_GPU_SUBMISSION_TRACK_H_
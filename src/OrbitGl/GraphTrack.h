@@ -10,6 +10,7 @@
 #include <optional>
 #include <string>
 
+#include "ClientData/TimerInfo.h"
 #include "CoreMath.h"
 #include "MultivariateTimeSeries.h"
 #include "PickingManager.h"
@@ -49,20 +50,20 @@ class GraphTrack : public Track {
   }
 
   // These are not supported in GraphTracks
-  const orbit_client_protos::TimerInfo* GetLeft(
-      const orbit_client_protos::TimerInfo& /*info*/) const override {
+  const orbit_client_data::TimerInfo* GetLeft(
+      const orbit_client_data::TimerInfo& /*info*/) const override {
     return nullptr;
   }
-  const orbit_client_protos::TimerInfo* GetRight(
-      const orbit_client_protos::TimerInfo& /*info*/) const override {
+  const orbit_client_data::TimerInfo* GetRight(
+      const orbit_client_data::TimerInfo& /*info*/) const override {
     return nullptr;
   }
-  const orbit_client_protos::TimerInfo* GetUp(
-      const orbit_client_protos::TimerInfo& /*info*/) const override {
+  const orbit_client_data::TimerInfo* GetUp(
+      const orbit_client_data::TimerInfo& /*info*/) const override {
     return nullptr;
   }
-  const orbit_client_protos::TimerInfo* GetDown(
-      const orbit_client_protos::TimerInfo& /*info*/) const override {
+  const orbit_client_data::TimerInfo* GetDown(
+      const orbit_client_data::TimerInfo& /*info*/) const override {
     return nullptr;
   }
 
@@ -6,11 +6,12 @@
 
 #include "App.h"
 #include "ClientData/CallstackEvent.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "OrbitBase/Logging.h"
 
 using orbit_client_data::CaptureData;
-using orbit_client_protos::TimerInfo;
+using orbit_client_data::TimerInfo;
 using orbit_grpc_protos::CaptureStarted;
 
 namespace {
@@ -15,12 +15,13 @@
 #include "App.h"
 #include "ClientData/CaptureData.h"
 #include "ClientData/ScopeId.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "TimeGraph.h"
 
 using orbit_client_data::FunctionInfo;
 using orbit_client_data::ScopeId;
-using orbit_client_protos::TimerInfo;
+using orbit_client_data::TimerInfo;
 
 namespace {
 
@@ -42,9 +43,9 @@ uint64_t AbsDiff(uint64_t a, uint64_t b) {
   return b - a;
 }
 
-const orbit_client_protos::TimerInfo* ClosestTo(uint64_t point,
-                                                const orbit_client_protos::TimerInfo* timer_a,
-                                                const orbit_client_protos::TimerInfo* timer_b) {
+const orbit_client_data::TimerInfo* ClosestTo(uint64_t point,
+                                              const orbit_client_data::TimerInfo* timer_a,
+                                              const orbit_client_data::TimerInfo* timer_b) {
   uint64_t a_diff = AbsDiff(point, timer_a->start());
   uint64_t b_diff = AbsDiff(point, timer_b->start());
   if (a_diff <= b_diff) {
@@ -53,8 +54,8 @@ const orbit_client_protos::TimerInfo* ClosestTo(uint64_t point,
   return timer_b;
 }
 
-static const orbit_client_protos::TimerInfo* SnapToClosestStart(TimeGraph* time_graph,
-                                                                ScopeId scope_id) {
+static const orbit_client_data::TimerInfo* SnapToClosestStart(TimeGraph* time_graph,
+                                                              ScopeId scope_id) {
   double min_us = time_graph->GetMinTimeUs();
   double max_us = time_graph->GetMaxTimeUs();
   double center_us = 0.5 * max_us + 0.5 * min_us;
@@ -64,7 +65,7 @@ static const orbit_client_protos::TimerInfo* SnapToClosestStart(TimeGraph* time_
   // after center - 1 (we use center - 1 to make sure that center itself is
   // included in the timerange that we search). Note that FindNextFunctionCall
   // uses the end marker of the timer as a timestamp.
-  const orbit_client_protos::TimerInfo* timer_info =
+  const orbit_client_data::TimerInfo* timer_info =
       time_graph->FindNextScopeTimer(scope_id, center - 1);
 
   // If we cannot find a next function call, then the closest one is the first
@@ -78,7 +79,7 @@ static const orbit_client_protos::TimerInfo* SnapToClosestStart(TimeGraph* time_
   // 'box' or the next one. It cannot be any box before 'box' because we are
   // using the start marker to measure the distance.
   if (timer_info->start() <= center) {
-    const orbit_client_protos::TimerInfo* next_timer_info =
+    const orbit_client_data::TimerInfo* next_timer_info =
         time_graph->FindNextScopeTimer(scope_id, timer_info->end());
     if (!next_timer_info) {
       return timer_info;
@@ -89,7 +90,7 @@ static const orbit_client_protos::TimerInfo* SnapToClosestStart(TimeGraph* time_
 
   // The center is to the left of 'box', so the closest box is either 'box' or
   // the next box to the left of the center.
-  const orbit_client_protos::TimerInfo* previous_timer_info =
+  const orbit_client_data::TimerInfo* previous_timer_info =
       time_graph->FindPreviousScopeTimer(scope_id, timer_info->start());
 
   if (!previous_timer_info) {
@@ -120,14 +121,14 @@ void LiveFunctionsController::Move() {
 }
 
 bool LiveFunctionsController::OnAllNextButton() {
-  absl::flat_hash_map<uint64_t, const orbit_client_protos::TimerInfo*> next_timer_infos;
+  absl::flat_hash_map<uint64_t, const orbit_client_data::TimerInfo*> next_timer_infos;
   uint64_t id_with_min_timestamp = 0;
   uint64_t min_timestamp = std::numeric_limits<uint64_t>::max();
   for (auto it : iterator_id_to_scope_id_) {
     ScopeId scope_id = it.second;
-    const orbit_client_protos::TimerInfo* current_timer_info =
+    const orbit_client_data::TimerInfo* current_timer_info =
         current_timer_infos_.find(it.first)->second;
-    const orbit_client_protos::TimerInfo* timer_info =
+    const orbit_client_data::TimerInfo* timer_info =
         app_->GetMutableTimeGraph()->FindNextScopeTimer(scope_id, current_timer_info->end());
     if (timer_info == nullptr) {
       return false;
@@ -147,14 +148,14 @@ bool LiveFunctionsController::OnAllNextButton() {
 }
 
 bool LiveFunctionsController::OnAllPreviousButton() {
-  absl::flat_hash_map<uint64_t, const orbit_client_protos::TimerInfo*> next_timer_infos;
+  absl::flat_hash_map<uint64_t, const orbit_client_data::TimerInfo*> next_timer_infos;
   uint64_t id_with_min_timestamp = 0;
   uint64_t min_timestamp = std::numeric_limits<uint64_t>::max();
   for (auto it : iterator_id_to_scope_id_) {
     ScopeId function_scope_id = it.second;
-    const orbit_client_protos::TimerInfo* current_timer_info =
+    const orbit_client_data::TimerInfo* current_timer_info =
         current_timer_infos_.find(it.first)->second;
-    const orbit_client_protos::TimerInfo* timer_info =
+    const orbit_client_data::TimerInfo* timer_info =
         app_->GetMutableTimeGraph()->FindPreviousScopeTimer(function_scope_id,
                                                             current_timer_info->end());
     if (timer_info == nullptr) {
@@ -175,7 +176,7 @@ bool LiveFunctionsController::OnAllPreviousButton() {
 }
 
 void LiveFunctionsController::OnNextButton(uint64_t id) {
-  const orbit_client_protos::TimerInfo* timer_info =
+  const orbit_client_data::TimerInfo* timer_info =
       app_->GetMutableTimeGraph()->FindNextScopeTimer(iterator_id_to_scope_id_[id],
                                                       current_timer_infos_[id]->end());
   // If text_box is nullptr, then we have reached the right end of the timeline.
@@ -186,7 +187,7 @@ void LiveFunctionsController::OnNextButton(uint64_t id) {
   Move();
 }
 void LiveFunctionsController::OnPreviousButton(uint64_t id) {
-  const orbit_client_protos::TimerInfo* timer_info =
+  const orbit_client_data::TimerInfo* timer_info =
       app_->GetMutableTimeGraph()->FindPreviousScopeTimer(iterator_id_to_scope_id_[id],
                                                           current_timer_infos_[id]->end());
   // If text_box is nullptr, then we have reached the left end of the timeline.
@@ -215,7 +216,7 @@ void LiveFunctionsController::OnDeleteButton(uint64_t id) {
 void LiveFunctionsController::AddIterator(ScopeId instrumented_function_scope_id,
                                           const FunctionInfo* function) {
   uint64_t iterator_id = next_iterator_id_++;
-  const orbit_client_protos::TimerInfo* timer_info = app_->selected_timer();
+  const orbit_client_data::TimerInfo* timer_info = app_->selected_timer();
   // If no box is currently selected or the selected box is a different
   // function, we search for the closest box to the current center of the
   // screen.
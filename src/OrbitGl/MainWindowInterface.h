@@ -25,6 +25,7 @@
 #include "OrbitBase/StopToken.h"
 #include "SamplingReport.h"
 #include "Statistics/Histogram.h"
+#include "Statistics/QuantileSketch.h"
 
 namespace orbit_gl {
 
@@ -54,8 +55,8 @@ class MainWindowInterface {
   virtual void AppendToCaptureLog(CaptureLogSeverity severity, absl::Duration capture_time,
                                   std::string_view message) = 0;
 
-  virtual void ShowHistogram(const std::vector<uint64_t>* data, const std::string& scope_name,
-                             std::optional<ScopeId> scope_id) = 0;
+  virtual void ShowHistogram(const orbit_statistics::QuantileSketch* data,
+                             const std::string& scope_name, std::optional<ScopeId> scope_id) = 0;
 
   enum class SymbolErrorHandlingResult { kReloadRequired, kSymbolLoadingCancelled };
   virtual SymbolErrorHandlingResult HandleSymbolError(
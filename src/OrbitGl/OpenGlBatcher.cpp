@@ -176,6 +176,68 @@ void OpenGlBatcher::DrawTriangleBuffer(float layer, bool picking) const {
   }
 }
 
+namespace {
+
+// Picking colors of lines, boxes and triangles encode the index of the element in the batcher,
+// which changes when the element is moved to another batcher. Picking colors of Pickables encode
+// an id from the PickingManager, which stays valid.
+template <typename ColorChain, typename TargetColorChain>
+void AppendPickingColors(const ColorChain& picking_colors, uint32_t element_id_offset,
+                         TargetColorChain* target) {
+  for (const Color& picking_color : picking_colors) {
+    PickingId id = PickingId::FromColor(picking_color);
+    if (id.type == PickingType::kPickable) {
+      target->emplace_back(picking_color);
+    } else {
+      target->emplace_back(PickingId::ToColor(id.type, id.element_id + element_id_offset,
+                                              id.batcher_id));
+    }
+  }
+}
+
+template <typename Chain>
+void AppendAll(const Chain& source, Chain* target) {
+  for (const auto& element : source) {
+    target->emplace_back(element);
+  }
+}
+
+}  // namespace
+
+void OpenGlBatcher::AppendSegment(const Batcher* segment) {
+  ORBIT_SCOPE_FUNCTION;
+  ORBIT_CHECK(segment != nullptr);
+  ORBIT_CHECK(segment->GetBatcherId() == GetBatcherId());
+  // Segments are only created by CreateSegment, so they are OpenGlBatchers.
+  const auto* other = static_cast<const OpenGlBatcher*>(segment);
+
+  const auto element_id_offset = static_cast<uint32_t>(user_data_.size());
+  for (const auto& [layer, other_buffers] : other->primitive_buffers_by_layer_) {
+    orbit_gl_internal::PrimitiveBuffers& buffers = primitive_buffers_by_layer_[layer];
+
+    AppendAll(other_buffers.line_buffer.lines_, &buffers.line_buffer.lines_);
+    AppendAll(other_buffers.line_buffer.colors_, &buffers.line_buffer.colors_);
+    AppendPickingColors(other_buffers.line_buffer.picking_colors_, element_id_offset,
+                        &buffers.line_buffer.picking_colors_);
+
+    AppendAll(other_buffers.box_buffer.boxes_, &buffers.box_buffer.boxes_);
+    AppendAll(other_buffers.box_buffer.colors_, &buffers.box_buffer.colors_);
+    AppendPickingColors(other_buffers.box_buffer.picking_colors_, element_id_offset,
+                        &buffers.box_buffer.picking_colors_);
+
+    AppendAll(other_buffers.triangle_buffer.triangles_, &buffers.triangle_buffer.triangles_);
+    AppendAll(other_buffers.triangle_buffer.colors_, &buffers.triangle_buffer.colors_);
+    AppendPickingColors(other_buffers.triangle_buffer.picking_colors_, element_id_offset,
+                        &buffers.triangle_buffer.picking_colors_);
+  }
+
+  user_data_.reserve(user_data_.size() + other->user_data_.size());
+  for (const std::unique_ptr<PickingUserData>& user_data : other->user_data_) {
+    user_data_.push_back(user_data != nullptr ? std::make_unique<PickingUserData>(*user_data)
+                                              : nullptr);
+  }
+}
+
 const PickingUserData* OpenGlBatcher::GetUserData(PickingId id) const {
   ORBIT_CHECK(id.element_id >= 0);
   ORBIT_CHECK(id.batcher_id == GetBatcherId());
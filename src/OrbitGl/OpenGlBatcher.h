@@ -97,6 +97,13 @@ class OpenGlBatcher : public Batcher {
 
   [[nodiscard]] const PickingUserData* GetUserData(PickingId id) const override;
 
+  [[nodiscard]] std::unique_ptr<Batcher> CreateSegment() const override {
+    return std::make_unique<OpenGlBatcher>(GetBatcherId());
+  }
+  // `segment` needs to have been created by CreateSegment. Its elements are moved, so it needs to
+  // be reset before it is used again.
+  void AppendSegment(const Batcher* segment) override;
+
  protected:
   std::unordered_map<float, orbit_gl_internal::PrimitiveBuffers> primitive_buffers_by_layer_;
   std::vector<std::unique_ptr<PickingUserData>> user_data_;
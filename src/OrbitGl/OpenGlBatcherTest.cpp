@@ -271,4 +271,45 @@ TEST(OpenGlBatcher, TranslationsAreAutomaticallyAdded) {
   ASSERT_DEATH(batcher.PopTranslation(), "Check failed");
 }
 
+TEST(OpenGlBatcher, AppendSegment) {
+  FakeOpenGlBatcher batcher(BatcherId::kUi);
+  FakeOpenGlBatcher segment(BatcherId::kUi);
+
+  std::string line_custom_data = "line custom data";
+  auto line_user_data = std::make_unique<PickingUserData>();
+  line_user_data->custom_data_ = &line_custom_data;
+
+  std::string box_custom_data = "box custom data";
+  auto box_user_data = std::make_unique<PickingUserData>();
+  box_user_data->custom_data_ = &box_custom_data;
+
+  batcher.AddLineHelper(Vec2(0, 0), Vec2(1, 0), 0, Color(255, 255, 255, 255),
+                        std::move(line_user_data));
+  // The segment assigns element ids starting from 0, which clash with the ids of `batcher`.
+  segment.AddBoxHelper(MakeBox(Vec2(0, 0), Vec2(1, 1)), 0, Color(255, 0, 0, 255),
+                       std::move(box_user_data));
+  segment.AddTriangleHelper(Triangle(Vec2(0, 0), Vec2(0, 1), Vec2(1, 0)), 1,
+                            Color(0, 255, 0, 255));
+
+  batcher.AppendSegment(&segment);
+  EXPECT_EQ(batcher.GetNumElements(), 3);
+  EXPECT_EQ(segment.GetNumElements(), 2);
+  ExpectDraw(batcher, 1, 1, 1);
+  EXPECT_EQ(batcher.GetDrawnBoxColors()[0], Color(255, 0, 0, 255));
+
+  batcher.ResetMockDrawCounts();
+  for (auto layer : batcher.GetLayers()) {
+    batcher.DrawLayer(layer, true);
+  }
+  ExpectCustomDataEq(batcher, batcher.GetDrawnLineColors()[0], line_custom_data);
+  ExpectCustomDataEq(batcher, batcher.GetDrawnBoxColors()[0], box_custom_data);
+  EXPECT_EQ(MockRenderPickingColor(batcher.GetDrawnTriangleColors()[0]).element_id, 2);
+}
+
+TEST(OpenGlBatcher, AppendSegmentFromOtherBatcherFails) {
+  FakeOpenGlBatcher batcher(BatcherId::kUi);
+  FakeOpenGlBatcher segment(BatcherId::kTimeGraph);
+  EXPECT_DEATH(batcher.AppendSegment(&segment), "Check failed");
+}
+
 }  // namespace orbit_gl
@@ -6,6 +6,7 @@
 
 #include "ApiUtils/EncodedEvent.h"
 #include "CaptureClient/CaptureEventProcessor.h"
+#include "ClientData/TimerInfo.h"
 #include "Geometry.h"
 #include "GrpcProtos/Constants.h"
 #include "TextRenderer.h"
@@ -100,7 +101,7 @@ void PageFaultsTrack::UpdatePositionOfSubtracks() {
   minor_page_faults_track_->SetPos(pos[0], current_y);
 }
 
-void PageFaultsTrack::OnTimer(const orbit_client_protos::TimerInfo& timer_info) {
+void PageFaultsTrack::OnTimer(const orbit_client_data::TimerInfo& timer_info) {
   int64_t system_page_faults = orbit_api::Decode<int64_t>(timer_info.registers(
       static_cast<size_t>(CaptureEventProcessor::PageFaultsEncodingIndex::kSystemPageFaults)));
   int64_t system_major_page_faults = orbit_api::Decode<int64_t>(timer_info.registers(
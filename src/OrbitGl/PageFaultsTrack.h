@@ -5,6 +5,7 @@
 #ifndef ORBIT_GL_PAGE_FAULTS_TRACK_H_
 #define ORBIT_GL_PAGE_FAULTS_TRACK_H_
 
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "MajorPageFaultsTrack.h"
 #include "MinorPageFaultsTrack.h"
@@ -38,7 +39,7 @@ class PageFaultsTrack : public Track {
   [[nodiscard]] bool IsCollapsible() const override { return true; }
   [[nodiscard]] std::vector<CaptureViewElement*> GetAllChildren() const override;
 
-  void OnTimer(const orbit_client_protos::TimerInfo& timer_info) override;
+  void OnTimer(const orbit_client_data::TimerInfo& timer_info) override;
 
   void AddValuesAndUpdateAnnotationsForMajorPageFaultsSubtrack(
       uint64_t timestamp_ns, const std::array<double, kBasicPageFaultsTrackDimension>& values) {
@@ -50,20 +51,20 @@ class PageFaultsTrack : public Track {
     minor_page_faults_track_->AddValuesAndUpdateAnnotations(timestamp_ns, values);
   }
 
-  const orbit_client_protos::TimerInfo* GetLeft(
-      const orbit_client_protos::TimerInfo& /*info*/) const override {
+  const orbit_client_data::TimerInfo* GetLeft(
+      const orbit_client_data::TimerInfo& /*info*/) const override {
     return nullptr;
   }
-  const orbit_client_protos::TimerInfo* GetRight(
-      const orbit_client_protos::TimerInfo& /*info*/) const override {
+  const orbit_client_data::TimerInfo* GetRight(
+      const orbit_client_data::TimerInfo& /*info*/) const override {
     return nullptr;
   }
-  const orbit_client_protos::TimerInfo* GetUp(
-      const orbit_client_protos::TimerInfo& /*info*/) const override {
+  const orbit_client_data::TimerInfo* GetUp(
+      const orbit_client_data::TimerInfo& /*info*/) const override {
     return nullptr;
   }
-  const orbit_client_protos::TimerInfo* GetDown(
-      const orbit_client_protos::TimerInfo& /*info*/) const override {
+  const orbit_client_data::TimerInfo* GetDown(
+      const orbit_client_data::TimerInfo& /*info*/) const override {
     return nullptr;
   }
   [[nodiscard]] uint64_t GetMinTime() const override;
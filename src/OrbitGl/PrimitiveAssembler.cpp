@@ -10,6 +10,7 @@
 
 #include <array>
 
+#include "ClientData/TimerInfo.h"
 #include "CoreMath.h"
 #include "Geometry.h"
 
@@ -333,7 +334,7 @@ void PrimitiveAssembler::GetBoxGradientColors(const Color& color, std::array<Col
 
 void PrimitiveAssembler::StartNewFrame() { batcher_->ResetElements(); }
 
-const orbit_client_protos::TimerInfo* PrimitiveAssembler::GetTimerInfo(PickingId id) const {
+const orbit_client_data::TimerInfo* PrimitiveAssembler::GetTimerInfo(PickingId id) const {
   const PickingUserData* data = GetUserData(id);
 
   if (data && data->timer_info_) {
@@ -17,6 +17,7 @@
 #include <vector>
 
 #include "Batcher.h"
+#include "ClientData/TimerInfo.h"
 #include "CoreMath.h"
 #include "Geometry.h"
 #include "TranslationStack.h"
@@ -118,11 +119,20 @@ class PrimitiveAssembler {
 
   void StartNewFrame();
 
+  [[nodiscard]] Batcher* GetBatcher() const { return batcher_; }
+  // Redirects the primitives added from now on, as well as the lookups of user data, to `batcher`.
+  // This is used to build primitives into a batcher segment (see Batcher::CreateSegment) and to
+  // look up their user data in the batcher the segment was appended to.
+  void SetBatcher(Batcher* batcher) {
+    ORBIT_CHECK(batcher != nullptr);
+    batcher_ = batcher;
+  }
+
   [[nodiscard]] PickingManager* GetPickingManager() const { return picking_manager_; }
   [[nodiscard]] const PickingUserData* GetUserData(PickingId id) const {
     return batcher_->GetUserData(id);
   }
-  [[nodiscard]] const orbit_client_protos::TimerInfo* GetTimerInfo(PickingId id) const;
+  [[nodiscard]] const orbit_client_data::TimerInfo* GetTimerInfo(PickingId id) const;
 
   static constexpr uint32_t kNumArcSides = 16;
 
@@ -10,6 +10,7 @@
 
 #include "App.h"
 #include "ClientData/CaptureData.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "OrbitBase/Logging.h"
 #include "OrbitBase/ThreadConstants.h"
@@ -18,7 +19,7 @@
 #include "TimeGraphLayout.h"
 #include "Viewport.h"
 
-using orbit_client_protos::TimerInfo;
+using orbit_client_data::TimerInfo;
 using orbit_gl::PrimitiveAssembler;
 using orbit_gl::TextRenderer;
 
@@ -38,7 +39,7 @@ SchedulerTrack::SchedulerTrack(CaptureViewElement* parent,
   SetPinned(false);
 }
 
-void SchedulerTrack::OnTimer(const orbit_client_protos::TimerInfo& timer_info) {
+void SchedulerTrack::OnTimer(const orbit_client_data::TimerInfo& timer_info) {
   TimerTrack::OnTimer(timer_info);
   if (num_cores_ <= static_cast<uint32_t>(timer_info.processor())) {
     num_cores_ = timer_info.processor() + 1;
@@ -95,14 +96,14 @@ float SchedulerTrack::GetYFromTimer(const TimerInfo& timer_info) const {
          num_gaps * layout_->GetSpaceBetweenCores();
 }
 
-std::vector<const orbit_client_protos::TimerInfo*> SchedulerTrack::GetScopesInRange(
+std::vector<const orbit_client_data::TimerInfo*> SchedulerTrack::GetScopesInRange(
     uint64_t start_ns, uint64_t end_ns) const {
-  std::vector<const orbit_client_protos::TimerInfo*> result;
+  std::vector<const orbit_client_data::TimerInfo*> result;
   for (const orbit_client_data::TimerChain* chain : timer_data_->GetChains()) {
     for (const auto& block : *chain) {
       if (!block.Intersects(start_ns, end_ns)) continue;
       for (uint64_t i = 0; i < block.size(); ++i) {
-        const orbit_client_protos::TimerInfo& timer_info = block[i];
+        const orbit_client_data::TimerInfo& timer_info = block[i];
         if (timer_info.start() <= end_ns && timer_info.end() > start_ns) {
           result.push_back(&timer_info);
         }
@@ -118,7 +119,7 @@ std::string SchedulerTrack::GetTooltip() const {
 
 std::string SchedulerTrack::GetBoxTooltip(const PrimitiveAssembler& primitive_assembler,
                                           PickingId id) const {
-  const orbit_client_protos::TimerInfo* timer_info = primitive_assembler.GetTimerInfo(id);
+  const orbit_client_data::TimerInfo* timer_info = primitive_assembler.GetTimerInfo(id);
   if (!timer_info) {
     return "";
   }
@@ -8,6 +8,7 @@
 #include <string>
 
 #include "CallstackThreadBar.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "CoreMath.h"
 #include "PickingManager.h"
@@ -26,7 +27,7 @@ class SchedulerTrack final : public TimerTrack {
                           const orbit_client_data::CaptureData* capture_data,
                           orbit_client_data::TimerData* timer_data);
   ~SchedulerTrack() override = default;
-  void OnTimer(const orbit_client_protos::TimerInfo& timer_info) override;
+  void OnTimer(const orbit_client_data::TimerInfo& timer_info) override;
 
   [[nodiscard]] std::string GetName() const override { return "Scheduler"; }
   [[nodiscard]] std::string GetLabel() const override {
@@ -40,16 +41,16 @@ class SchedulerTrack final : public TimerTrack {
 
   [[nodiscard]] float GetDefaultBoxHeight() const override { return layout_->GetTextCoresHeight(); }
   [[nodiscard]] float GetYFromTimer(
-      const orbit_client_protos::TimerInfo& timer_info) const override;
-  [[nodiscard]] std::vector<const orbit_client_protos::TimerInfo*> GetScopesInRange(
+      const orbit_client_data::TimerInfo& timer_info) const override;
+  [[nodiscard]] std::vector<const orbit_client_data::TimerInfo*> GetScopesInRange(
       uint64_t start_ns, uint64_t end_ns) const;
 
  protected:
   void DoUpdatePrimitives(orbit_gl::PrimitiveAssembler& primitive_assembler,
                           orbit_gl::TextRenderer& text_renderer, uint64_t min_tick,
                           uint64_t max_tick, PickingMode picking_mode) override;
-  [[nodiscard]] bool IsTimerActive(const orbit_client_protos::TimerInfo& timer_info) const override;
-  [[nodiscard]] Color GetTimerColor(const orbit_client_protos::TimerInfo& timer_info,
+  [[nodiscard]] bool IsTimerActive(const orbit_client_data::TimerInfo& timer_info) const override;
+  [[nodiscard]] Color GetTimerColor(const orbit_client_data::TimerInfo& timer_info,
                                     bool is_selected, bool is_highlighted,
                                     const internal::DrawData& draw_data) const override;
   [[nodiscard]] std::string GetBoxTooltip(const orbit_gl::PrimitiveAssembler& primitive_assembler,
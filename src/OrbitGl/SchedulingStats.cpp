@@ -7,10 +7,11 @@
 #include <absl/strings/str_format.h>
 
 #include "CaptureWindow.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "OrbitBase/Sort.h"
 
-using orbit_client_protos::TimerInfo;
+using orbit_client_data::TimerInfo;
 
 static constexpr double kNsToMs = 1 / 1000000.0;
 
@@ -20,7 +21,7 @@ SchedulingStats::SchedulingStats(const std::vector<const TimerInfo*>& scheduling
   time_range_ms_ = static_cast<double>(end_ns - start_ns) * kNsToMs;
 
   // Iterate on every scope in the selected range to compute stats.
-  for (const orbit_client_protos::TimerInfo* timer_info : scheduling_scopes) {
+  for (const orbit_client_data::TimerInfo* timer_info : scheduling_scopes) {
     uint64_t clipped_start_ns = std::max(start_ns, timer_info->start());
     uint64_t clipped_end_ns = std::min(end_ns, timer_info->end());
     uint64_t timer_duration_ns = clipped_end_ns - clipped_start_ns;
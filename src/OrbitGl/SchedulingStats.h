@@ -10,6 +10,7 @@
 #include <string>
 #include <vector>
 
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "OrbitBase/ThreadUtils.h"
 
@@ -25,7 +26,7 @@ class SchedulingStats {
   using ThreadNameProvider = std::function<std::string(int32_t)>;
 
   SchedulingStats() = delete;
-  SchedulingStats(const std::vector<const orbit_client_protos::TimerInfo*>& scheduling_scopes,
+  SchedulingStats(const std::vector<const orbit_client_data::TimerInfo*>& scheduling_scopes,
                   const ThreadNameProvider& thread_name_provider, uint64_t start_ns,
                   uint64_t end_ns);
 
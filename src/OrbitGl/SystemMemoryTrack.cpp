@@ -8,6 +8,7 @@
 
 #include "ApiUtils/EncodedEvent.h"
 #include "CaptureClient/CaptureEventProcessor.h"
+#include "ClientData/TimerInfo.h"
 #include "DisplayFormats/DisplayFormats.h"
 #include "GrpcProtos/Constants.h"
 
@@ -91,7 +92,7 @@ std::string SystemMemoryTrack::GetLegendTooltips(size_t legend_index) const {
   }
 }
 
-void SystemMemoryTrack::OnTimer(const orbit_client_protos::TimerInfo& timer_info) {
+void SystemMemoryTrack::OnTimer(const orbit_client_data::TimerInfo& timer_info) {
   int64_t total_kb = orbit_api::Decode<int64_t>(timer_info.registers(
       static_cast<size_t>(CaptureEventProcessor::SystemMemoryUsageEncodingIndex::kTotalKb)));
   int64_t unused_kb = orbit_api::Decode<int64_t>(timer_info.registers(
@@ -8,6 +8,7 @@
 #include <string>
 #include <utility>
 
+#include "ClientData/TimerInfo.h"
 #include "MemoryTrack.h"
 
 namespace orbit_gl {
@@ -28,7 +29,7 @@ class SystemMemoryTrack final : public MemoryTrack<kSystemMemoryTrackDimension>
   void TrySetValueUpperBound(double total_mb);
   void SetWarningThreshold(double warning_threshold_mb);
 
-  void OnTimer(const orbit_client_protos::TimerInfo& timer_info) override;
+  void OnTimer(const orbit_client_data::TimerInfo& timer_info) override;
 
   enum class SeriesIndex { kUsedMb = 0, kBuffersOrCachedMb = 1, kUnusedMb = 2 };
 
@@ -20,6 +20,7 @@
 #include "ClientData/ModuleAndFunctionLookup.h"
 #include "ClientData/ScopeId.h"
 #include "ClientData/TimerChain.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "DisplayFormats/DisplayFormats.h"
 #include "GlUtils.h"
@@ -38,13 +39,12 @@
 using orbit_client_data::CaptureData;
 using orbit_client_data::ScopeId;
 using orbit_client_data::TimerChain;
+using orbit_client_data::TimerInfo;
 
 using orbit_gl::PickingUserData;
 using orbit_gl::PrimitiveAssembler;
 using orbit_gl::TextRenderer;
 
-using orbit_client_protos::TimerInfo;
-
 using orbit_grpc_protos::InstrumentedFunction;
 
 ThreadTrack::ThreadTrack(CaptureViewElement* parent,
@@ -258,6 +258,13 @@ Color ThreadTrack::GetTimerColor(const TimerInfo& timer_info, bool is_selected,
   return color;
 }
 
+std::optional<uint64_t> ThreadTrack::GetDataGeneration() const {
+  // Callstacks, thread states and tracepoints are added to the sub-tracks while capturing or
+  // loading a capture without being counted as timers.
+  if (app_ == nullptr || app_->IsCapturing() || app_->IsLoadingCapture()) return std::nullopt;
+  return TimerTrack::GetDataGeneration();
+}
+
 bool ThreadTrack::IsEmpty() const {
   return thread_state_bar_->IsEmpty() && event_bar_->IsEmpty() && tracepoint_bar_->IsEmpty() &&
          thread_track_data_provider_->IsEmpty(thread_id_);
@@ -20,6 +20,7 @@
 #include "CaptureClient/CaptureEventProcessor.h"
 #include "ClientData/CallstackEvent.h"
 #include "ClientData/ScopeInfo.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientFlags/ClientFlags.h"
 #include "FrameTrack.h"
 #include "GlCanvas.h"
@@ -42,7 +43,7 @@ using orbit_client_data::ApiTrackValue;
 using orbit_client_data::CallstackEvent;
 using orbit_client_data::CaptureData;
 using orbit_client_data::TimerChain;
-using orbit_client_protos::TimerInfo;
+using orbit_client_data::TimerInfo;
 
 using orbit_gl::Button;
 using orbit_gl::CGroupAndProcessMemoryTrack;
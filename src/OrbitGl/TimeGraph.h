@@ -15,6 +15,7 @@
 #include "ClientData/ApiTrackValue.h"
 #include "ClientData/CaptureData.h"
 #include "ClientData/ScopeId.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "CoreMath.h"
 #include "GlSlider.h"
@@ -46,7 +47,7 @@ class TimeGraph : public orbit_gl::CaptureViewElement, public orbit_gl::Timeline
   void DrawText(float layer);
 
   // TODO(b/214282122): Move Process Timers function outside the UI.
-  void ProcessTimer(const orbit_client_protos::TimerInfo& timer_info,
+  void ProcessTimer(const orbit_client_data::TimerInfo& timer_info,
                     const orbit_grpc_protos::InstrumentedFunction* function);
   void ProcessApiStringEvent(const orbit_client_data::ApiStringEvent& string_event);
   void ProcessApiTrackValueEvent(const orbit_client_data::ApiTrackValue& track_event);
@@ -81,7 +82,7 @@ class TimeGraph : public orbit_gl::CaptureViewElement, public orbit_gl::Timeline
   void UpdateCaptureMinMaxTimestamps();
 
   void ZoomAll();
-  void Zoom(const orbit_client_protos::TimerInfo& timer_info);
+  void Zoom(const orbit_client_data::TimerInfo& timer_info);
   void Zoom(uint64_t min, uint64_t max);
   void ZoomTime(int zoom_delta, double center_time_ratio) override;
   void SetMinMax(double min_time_us, double max_time_us);
@@ -95,28 +96,27 @@ class TimeGraph : public orbit_gl::CaptureViewElement, public orbit_gl::Timeline
   void HorizontallyMoveIntoView(VisibilityType vis_type, uint64_t min, uint64_t max,
                                 double distance = 0.3);
   void HorizontallyMoveIntoView(VisibilityType vis_type,
-                                const orbit_client_protos::TimerInfo& timer_info,
+                                const orbit_client_data::TimerInfo& timer_info,
                                 double distance = 0.3);
 
   [[nodiscard]] double GetTime(double ratio) const;
 
   enum class JumpScope { kSameDepth, kSameThread, kSameFunction, kSameThreadSameFunction };
   enum class JumpDirection { kPrevious, kNext, kTop, kDown };
-  void JumpToNeighborTimer(const orbit_client_protos::TimerInfo* from, JumpDirection jump_direction,
+  void JumpToNeighborTimer(const orbit_client_data::TimerInfo* from, JumpDirection jump_direction,
                            JumpScope jump_scope);
-  [[nodiscard]] const orbit_client_protos::TimerInfo* FindPreviousScopeTimer(
+  [[nodiscard]] const orbit_client_data::TimerInfo* FindPreviousScopeTimer(
       ScopeId scope_id, uint64_t current_time,
       std::optional<uint32_t> thread_id = std::nullopt) const;
-  [[nodiscard]] const orbit_client_protos::TimerInfo* FindNextScopeTimer(
+  [[nodiscard]] const orbit_client_data::TimerInfo* FindNextScopeTimer(
       ScopeId scope_id, uint64_t current_time,
       std::optional<uint32_t> thread_id = std::nullopt) const;
   [[nodiscard]] std::vector<const orbit_client_data::TimerChain*> GetAllThreadTrackTimerChains()
       const;
-  [[nodiscard]] std::pair<const orbit_client_protos::TimerInfo*,
-                          const orbit_client_protos::TimerInfo*>
+  [[nodiscard]] std::pair<const orbit_client_data::TimerInfo*, const orbit_client_data::TimerInfo*>
   GetMinMaxTimerForScope(ScopeId scope_id) const;
 
-  void SelectAndZoom(const orbit_client_protos::TimerInfo* timer_info);
+  void SelectAndZoom(const orbit_client_data::TimerInfo* timer_info);
   [[nodiscard]] double GetCaptureTimeSpanUs() const;
   [[nodiscard]] bool IsRedrawNeeded() const {
     return draw_requested_ || update_primitives_requested_;
@@ -168,10 +168,10 @@ class TimeGraph : public orbit_gl::CaptureViewElement, public orbit_gl::Timeline
 
   [[nodiscard]] std::unique_ptr<orbit_accessibility::AccessibleInterface>
   CreateAccessibleInterface() override;
-  void ProcessAsyncTimer(const orbit_client_protos::TimerInfo& timer_info);
-  void ProcessSystemMemoryTrackingTimer(const orbit_client_protos::TimerInfo& timer_info);
-  void ProcessCGroupAndProcessMemoryTrackingTimer(const orbit_client_protos::TimerInfo& timer_info);
-  void ProcessPageFaultsTrackingTimer(const orbit_client_protos::TimerInfo& timer_info);
+  void ProcessAsyncTimer(const orbit_client_data::TimerInfo& timer_info);
+  void ProcessSystemMemoryTrackingTimer(const orbit_client_data::TimerInfo& timer_info);
+  void ProcessCGroupAndProcessMemoryTrackingTimer(const orbit_client_data::TimerInfo& timer_info);
+  void ProcessPageFaultsTrackingTimer(const orbit_client_data::TimerInfo& timer_info);
 
   std::shared_ptr<orbit_gl::GlSlider> horizontal_slider_;
   std::shared_ptr<orbit_gl::GlSlider> vertical_slider_;
@@ -185,7 +185,7 @@ class TimeGraph : public orbit_gl::CaptureViewElement, public orbit_gl::Timeline
   void UpdateHorizontalScroll(float ratio);
   void UpdateHorizontalZoom(float normalized_start, float normalized_end);
 
-  void SelectAndMakeVisible(const orbit_client_protos::TimerInfo* timer_info);
+  void SelectAndMakeVisible(const orbit_client_data::TimerInfo* timer_info);
   [[nodiscard]] bool IsFullyVisible(uint64_t min, uint64_t max) const;
   [[nodiscard]] bool IsPartlyVisible(uint64_t min, uint64_t max) const;
   [[nodiscard]] bool IsVisible(VisibilityType vis_type, uint64_t min, uint64_t max) const;
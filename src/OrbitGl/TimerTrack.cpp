@@ -18,6 +18,8 @@
 #include "ApiInterface/Orbit.h"
 #include "App.h"
 #include "ClientData/ScopeId.h"
+#include "ClientData/TimerInfo.h"
+#include "ClientData/TimerPyramid.h"
 #include "ClientFlags/ClientFlags.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "DisplayFormats/DisplayFormats.h"
@@ -32,7 +34,7 @@
 using orbit_client_data::ScopeId;
 using orbit_client_data::TimerChain;
 using orbit_client_data::TimerData;
-using orbit_client_protos::TimerInfo;
+using orbit_client_data::TimerInfo;
 
 using orbit_gl::PickingUserData;
 using orbit_gl::PrimitiveAssembler;
@@ -93,7 +95,7 @@ std::string TimerTrack::GetDisplayTime(const TimerInfo& timer) const {
 }
 
 void TimerTrack::DrawTimesliceText(TextRenderer& text_renderer,
-                                   const orbit_client_protos::TimerInfo& timer, float min_x,
+                                   const orbit_client_data::TimerInfo& timer, float min_x,
                                    Vec2 box_pos, Vec2 box_size) {
   std::string timeslice_text = GetTimesliceText(timer);
 
@@ -299,6 +301,10 @@ void TimerTrack::DoUpdatePrimitives(PrimitiveAssembler& primitive_assembler,
   draw_data.min_timegraph_tick = timeline_info_->GetTickFromUs(timeline_info_->GetMinTimeUs());
   draw_data.histogram_selection_range = app_->GetHistogramSelectionRange();
 
+  // Any span could contain highlighted timers, which need to be drawn one by one to be highlighted.
+  const bool has_highlighted_timers = draw_data.highlighted_scope_id.has_value() ||
+                                      draw_data.highlighted_group_id != kOrbitDefaultGroupId;
+
   for (const TimerChain* chain : chains) {
     ORBIT_CHECK(chain != nullptr);
     // In order to draw overlaps correctly, we need for every text box to be drawn (current),
@@ -307,29 +313,83 @@ void TimerTrack::DoUpdatePrimitives(PrimitiveAssembler& primitive_assembler,
     // previous two timers, thus the currents iteration value being the "next" textbox.
     // Note: This will require us to draw the last timer after the traversal of the text boxes.
     // Also note: The draw method will take care of nullptr's being passed into (first iteration).
-    const orbit_client_protos::TimerInfo* prev_timer_info = nullptr;
-    const orbit_client_protos::TimerInfo* current_timer_info = nullptr;
-    const orbit_client_protos::TimerInfo* next_timer_info = nullptr;
+    const orbit_client_data::TimerInfo* prev_timer_info = nullptr;
+    const orbit_client_data::TimerInfo* current_timer_info = nullptr;
+    const orbit_client_data::TimerInfo* next_timer_info = nullptr;
+    // The number of timers represented by `current_timer_info`, which is larger than one if it is
+    // the first timer of a TimerSpan.
+    uint32_t current_timer_count = 0;
 
     // We have to reset this when we go to the next depth, as otherwise we
     // would miss drawing events that should be drawn.
     uint64_t min_ignore = std::numeric_limits<uint64_t>::max();
     uint64_t max_ignore = std::numeric_limits<uint64_t>::min();
-    for (const orbit_client_data::TimerBlock& block : *chain) {
-      if (!block.Intersects(min_tick, max_tick)) continue;
+    auto draw_next_timer = [&](const orbit_client_data::TimerInfo* timer_info,
+                               uint32_t timer_count = 1) {
+      // `timer_info` is the "next" text box and we want to draw the text box from the previous
+      // iteration ("current").
+      next_timer_info = timer_info;
+
+      if (DrawTimer(text_renderer, prev_timer_info, next_timer_info, draw_data, current_timer_info,
+                    &min_ignore, &max_ignore)) {
+        visible_timer_count_ += current_timer_count;
+      }
+
+      prev_timer_info = current_timer_info;
+      current_timer_info = next_timer_info;
+      current_timer_count = timer_count;
+    };
+
+    // When zoomed out, draw the spans of the TimerPyramid instead of visiting every timer. The
+    // timers merged into a span are all shorter than a pixel, so they would be drawn as a single
+    // line anyway, and the first timer of the span stands for all of them.
+    std::optional<std::vector<orbit_client_data::TimerSpan>> timer_spans;
+    const orbit_client_data::TimerPyramid* timer_pyramid = chain->GetTimerPyramid();
+    if (timer_pyramid != nullptr && CanDrawTimerSpans() && !has_highlighted_timers) {
+      timer_spans = timer_pyramid->GetSpans(min_tick, max_tick,
+                                            static_cast<uint64_t>(draw_data.ns_per_pixel));
+    }
 
-      for (size_t k = 0; k < block.size(); ++k) {
-        // The current index (k) points to the "next" text box and we want to draw the text box
-        // from the previous iteration ("current").
-        next_timer_info = &block[k];
+    if (timer_spans.has_value()) {
+      // The spans are in the order of the chain, so the block containing the first timer of a span
+      // is searched from the block of the previous span.
+      orbit_client_data::TimerChainIterator block_it = chain->begin();
+      for (const orbit_client_data::TimerSpan& timer_span : timer_spans.value()) {
+        const orbit_client_data::TimerInfo* selected_timer = draw_data.selected_timer;
+        const bool may_contain_selected_timer =
+            timer_span.timer_count > 1 && selected_timer != nullptr &&
+            selected_timer->depth() == timer_span.first_timer->depth() &&
+            selected_timer->start() >= timer_span.start &&
+            selected_timer->start() <= timer_span.end;
+        if (!may_contain_selected_timer) {
+          draw_next_timer(timer_span.first_timer, timer_span.timer_count);
+          continue;
+        }
 
-        if (DrawTimer(text_renderer, prev_timer_info, next_timer_info, draw_data,
-                      current_timer_info, &min_ignore, &max_ignore)) {
-          ++visible_timer_count_;
+        // Draw the timers of this span one by one, so that the selected timer keeps its color.
+        while (block_it != chain->end() &&
+               (block_it->size() == 0 || timer_span.first_timer < &(*block_it)[0] ||
+                timer_span.first_timer > &(*block_it)[block_it->size() - 1])) {
+          ++block_it;
+        }
+        ORBIT_CHECK(block_it != chain->end());
+        size_t index_in_block = timer_span.first_timer - &(*block_it)[0];
+        for (uint32_t i = 0; i < timer_span.timer_count; ++i) {
+          if (index_in_block == block_it->size()) {
+            ++block_it;
+            index_in_block = 0;
+          }
+          draw_next_timer(&(*block_it)[index_in_block]);
+          ++index_in_block;
         }
+      }
+    } else {
+      for (const orbit_client_data::TimerBlock& block : *chain) {
+        if (!block.Intersects(min_tick, max_tick)) continue;
 
-        prev_timer_info = current_timer_info;
-        current_timer_info = next_timer_info;
+        for (size_t k = 0; k < block.size(); ++k) {
+          draw_next_timer(&block[k]);
+        }
       }
     }
 
@@ -337,7 +397,7 @@ void TimerTrack::DoUpdatePrimitives(PrimitiveAssembler& primitive_assembler,
     next_timer_info = nullptr;
     if (DrawTimer(text_renderer, prev_timer_info, next_timer_info, draw_data, current_timer_info,
                   &min_ignore, &max_ignore)) {
-      ++visible_timer_count_;
+      visible_timer_count_ += current_timer_count;
     }
   }
 }
@@ -382,7 +442,7 @@ internal::DrawData TimerTrack::GetDrawData(
     uint64_t min_tick, uint64_t max_tick, float track_pos_x, float track_width,
     PrimitiveAssembler* primitive_assembler, const orbit_gl::TimelineInfoInterface* timeline_info,
     const orbit_gl::Viewport* viewport, bool is_collapsed,
-    const orbit_client_protos::TimerInfo* selected_timer,
+    const orbit_client_data::TimerInfo* selected_timer,
     std::optional<ScopeId> highlighted_scope_id, uint64_t highlighted_group_id,
     std::optional<orbit_statistics::HistogramSelectionRange> histogram_selection_range) {
   internal::DrawData draw_data{};
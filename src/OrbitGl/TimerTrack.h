@@ -10,6 +10,7 @@
 #include <atomic>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -18,6 +19,7 @@
 #include "ClientData/CallstackType.h"
 #include "ClientData/ScopeId.h"
 #include "ClientData/TimerChain.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "Containers/BlockChain.h"
 #include "CoreMath.h"
@@ -41,7 +43,7 @@ struct DrawData {
   uint64_t min_timegraph_tick;
   orbit_gl::PrimitiveAssembler* primitive_assembler;
   const orbit_gl::Viewport* viewport;
-  const orbit_client_protos::TimerInfo* selected_timer;
+  const orbit_client_data::TimerInfo* selected_timer;
   double inv_time_window;
   float track_start_x;
   float track_width;
@@ -64,33 +66,33 @@ class TimerTrack : public Track {
   ~TimerTrack() override = default;
 
   // Pickable
-  void OnTimer(const orbit_client_protos::TimerInfo& timer_info) override;
+  void OnTimer(const orbit_client_data::TimerInfo& timer_info) override;
   [[nodiscard]] std::string GetTooltip() const override;
 
   // Track
   [[nodiscard]] Type GetType() const override { return Type::kTimerTrack; }
 
   [[nodiscard]] uint32_t GetProcessId() const override { return timer_data_->GetProcessId(); }
-  [[nodiscard]] std::string GetExtraInfo(const orbit_client_protos::TimerInfo& timer) const;
+  [[nodiscard]] std::string GetExtraInfo(const orbit_client_data::TimerInfo& timer) const;
 
-  [[nodiscard]] const orbit_client_protos::TimerInfo* GetLeft(
-      const orbit_client_protos::TimerInfo& timer_info) const override;
-  [[nodiscard]] const orbit_client_protos::TimerInfo* GetRight(
-      const orbit_client_protos::TimerInfo& timer_info) const override;
-  [[nodiscard]] const orbit_client_protos::TimerInfo* GetUp(
-      const orbit_client_protos::TimerInfo& timer_info) const override;
-  [[nodiscard]] const orbit_client_protos::TimerInfo* GetDown(
-      const orbit_client_protos::TimerInfo& timer_info) const override;
+  [[nodiscard]] const orbit_client_data::TimerInfo* GetLeft(
+      const orbit_client_data::TimerInfo& timer_info) const override;
+  [[nodiscard]] const orbit_client_data::TimerInfo* GetRight(
+      const orbit_client_data::TimerInfo& timer_info) const override;
+  [[nodiscard]] const orbit_client_data::TimerInfo* GetUp(
+      const orbit_client_data::TimerInfo& timer_info) const override;
+  [[nodiscard]] const orbit_client_data::TimerInfo* GetDown(
+      const orbit_client_data::TimerInfo& timer_info) const override;
 
   [[nodiscard]] bool IsEmpty() const override;
 
   [[nodiscard]] virtual float GetDefaultBoxHeight() const { return layout_->GetTextBoxHeight(); }
   [[nodiscard]] virtual float GetDynamicBoxHeight(
-      const orbit_client_protos::TimerInfo& /*timer_info*/) const {
+      const orbit_client_data::TimerInfo& /*timer_info*/) const {
     return GetDefaultBoxHeight();
   }
 
-  [[nodiscard]] virtual float GetYFromTimer(const orbit_client_protos::TimerInfo& timer_info) const;
+  [[nodiscard]] virtual float GetYFromTimer(const orbit_client_data::TimerInfo& timer_info) const;
   [[nodiscard]] virtual float GetYFromDepth(uint32_t depth) const;
 
   [[nodiscard]] virtual float GetHeightAboveTimers() const;
@@ -100,6 +102,10 @@ class TimerTrack : public Track {
   [[nodiscard]] virtual uint32_t GetDepth() const { return timer_data_->GetDepth(); }
 
   [[nodiscard]] virtual size_t GetNumberOfTimers() const;
+  // Timers are only ever added, so their number changes whenever data is added.
+  [[nodiscard]] std::optional<uint64_t> GetDataGeneration() const override {
+    return GetNumberOfTimers();
+  }
   [[nodiscard]] uint64_t GetMinTime() const override;
   [[nodiscard]] uint64_t GetMaxTime() const override;
 
@@ -112,40 +118,45 @@ class TimerTrack : public Track {
   // corresponding to dynamically instrumented functions synchonous manual
   // instrumentation can be filtered.
   [[nodiscard]] virtual bool IsTimerActive(
-      const orbit_client_protos::TimerInfo& /*timer_info*/) const {
+      const orbit_client_data::TimerInfo& /*timer_info*/) const {
     return true;
   }
 
-  [[nodiscard]] virtual Color GetTimerColor(const orbit_client_protos::TimerInfo& timer_info,
+  [[nodiscard]] virtual Color GetTimerColor(const orbit_client_data::TimerInfo& timer_info,
                                             bool is_selected, bool is_highlighted,
                                             const internal::DrawData& draw_data) const = 0;
   [[nodiscard]] virtual bool TimerFilter(
-      const orbit_client_protos::TimerInfo& /*timer_info*/) const {
+      const orbit_client_data::TimerInfo& /*timer_info*/) const {
     return true;
   }
 
+  // Whether zoomed-out views can be drawn from the TimerPyramid of each chain, which merges
+  // consecutive timers of the same chain. Tracks that place timers of the same chain on different
+  // rows or filter individual timers need to visit every timer instead.
+  [[nodiscard]] virtual bool CanDrawTimerSpans() const { return true; }
+
   [[nodiscard]] bool DrawTimer(orbit_gl::TextRenderer& text_renderer,
-                               const orbit_client_protos::TimerInfo* prev_timer_info,
-                               const orbit_client_protos::TimerInfo* next_timer_info,
+                               const orbit_client_data::TimerInfo* prev_timer_info,
+                               const orbit_client_data::TimerInfo* next_timer_info,
                                const internal::DrawData& draw_data,
-                               const orbit_client_protos::TimerInfo* current_timer_info,
+                               const orbit_client_data::TimerInfo* current_timer_info,
                                uint64_t* min_ignore, uint64_t* max_ignore);
 
   [[nodiscard]] virtual std::string GetTimesliceText(
-      const orbit_client_protos::TimerInfo& /*timer*/) const {
+      const orbit_client_data::TimerInfo& /*timer*/) const {
     return "";
   }
-  [[nodiscard]] std::string GetDisplayTime(const orbit_client_protos::TimerInfo&) const;
+  [[nodiscard]] std::string GetDisplayTime(const orbit_client_data::TimerInfo&) const;
 
   void DrawTimesliceText(orbit_gl::TextRenderer& text_renderer,
-                         const orbit_client_protos::TimerInfo& timer, float min_x, Vec2 box_pos,
+                         const orbit_client_data::TimerInfo& timer, float min_x, Vec2 box_pos,
                          Vec2 box_size);
 
   [[nodiscard]] static internal::DrawData GetDrawData(
       uint64_t min_tick, uint64_t max_tick, float track_pos_x, float track_width,
       orbit_gl::PrimitiveAssembler* primitive_assembler,
       const orbit_gl::TimelineInfoInterface* timeline_info, const orbit_gl::Viewport* viewport,
-      bool is_collapsed, const orbit_client_protos::TimerInfo* selected_timer,
+      bool is_collapsed, const orbit_client_data::TimerInfo* selected_timer,
       std::optional<ScopeId> highlighted_scope_id, uint64_t highlighted_group_id,
       std::optional<orbit_statistics::HistogramSelectionRange> histogram_selection_range);
 
@@ -153,7 +164,7 @@ class TimerTrack : public Track {
       const orbit_gl::PrimitiveAssembler& primitive_assembler, PickingId id) const;
   [[nodiscard]] std::unique_ptr<orbit_gl::PickingUserData> CreatePickingUserData(
       const orbit_gl::PrimitiveAssembler& primitive_assembler,
-      const orbit_client_protos::TimerInfo& timer_info) {
+      const orbit_client_data::TimerInfo& timer_info) {
     return std::make_unique<orbit_gl::PickingUserData>(
         &timer_info, [this, &primitive_assembler](PickingId id) {
           return this->GetBoxTooltip(primitive_assembler, id);
@@ -166,7 +177,7 @@ class TimerTrack : public Track {
   }
 
   [[nodiscard]] bool ShouldHaveBorder(
-      const orbit_client_protos::TimerInfo* timer,
+      const orbit_client_data::TimerInfo* timer,
       const std::optional<orbit_statistics::HistogramSelectionRange>& range, float width) const;
 
   static const Color kHighlightColor;
@@ -10,6 +10,7 @@
 #include <algorithm>
 #include <atomic>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -18,6 +19,7 @@
 #include "ClientData/ModuleManager.h"
 #include "ClientData/TimerChain.h"
 #include "ClientData/TimerData.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "Containers/BlockChain.h"
 #include "CoreMath.h"
@@ -68,7 +70,11 @@ class Track : public orbit_gl::CaptureViewElement,
   [[nodiscard]] virtual uint64_t GetMinTime() const = 0;
   [[nodiscard]] virtual uint64_t GetMaxTime() const = 0;
 
-  virtual void OnTimer(const orbit_client_protos::TimerInfo& /*timer_info*/) {}
+  virtual void OnTimer(const orbit_client_data::TimerInfo& /*timer_info*/) {}
+
+  // Returns a value that changes whenever data shown by this track is added, or std::nullopt if the
+  // track can't tell. TrackContainer reuses the primitives of a track while this doesn't change.
+  [[nodiscard]] virtual std::optional<uint64_t> GetDataGeneration() const { return std::nullopt; }
 
   [[nodiscard]] bool IsPinned() const override { return pinned_; }
   void SetPinned(bool value) override;
@@ -111,17 +117,17 @@ class Track : public orbit_gl::CaptureViewElement,
   [[nodiscard]] virtual int GetVisiblePrimitiveCount() const { return 0; }
 
   // Must be overriden by child class for sensible behavior.
-  [[nodiscard]] virtual const orbit_client_protos::TimerInfo* GetLeft(
-      const orbit_client_protos::TimerInfo& /*timer_info*/) const = 0;
+  [[nodiscard]] virtual const orbit_client_data::TimerInfo* GetLeft(
+      const orbit_client_data::TimerInfo& /*timer_info*/) const = 0;
   // Must be overriden by child class for sensible behavior.
-  [[nodiscard]] virtual const orbit_client_protos::TimerInfo* GetRight(
-      const orbit_client_protos::TimerInfo& /*timer_info*/) const = 0;
+  [[nodiscard]] virtual const orbit_client_data::TimerInfo* GetRight(
+      const orbit_client_data::TimerInfo& /*timer_info*/) const = 0;
   // Must be overriden by child class for sensible behavior.
-  [[nodiscard]] virtual const orbit_client_protos::TimerInfo* GetUp(
-      const orbit_client_protos::TimerInfo& /*timer_info*/) const = 0;
+  [[nodiscard]] virtual const orbit_client_data::TimerInfo* GetUp(
+      const orbit_client_data::TimerInfo& /*timer_info*/) const = 0;
   // Must be overriden by child class for sensible behavior.
-  [[nodiscard]] virtual const orbit_client_protos::TimerInfo* GetDown(
-      const orbit_client_protos::TimerInfo& /*timer_info*/) const = 0;
+  [[nodiscard]] virtual const orbit_client_data::TimerInfo* GetDown(
+      const orbit_client_data::TimerInfo& /*timer_info*/) const = 0;
 
  protected:
   void DoDraw(orbit_gl::PrimitiveAssembler& primitive_assembler,
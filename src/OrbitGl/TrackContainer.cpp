@@ -6,6 +6,7 @@
 
 #include <GteVector.h>
 #include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
 #include <absl/flags/flag.h>
 #include <absl/strings/str_format.h>
 #include <absl/time/time.h>
@@ -18,15 +19,18 @@
 #include "AccessibleCaptureViewElement.h"
 #include "App.h"
 #include "ClientData/ScopeId.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientFlags/ClientFlags.h"
 #include "CoreMath.h"
 #include "DisplayFormats/DisplayFormats.h"
 #include "Geometry.h"
 #include "GlCanvas.h"
 #include "GlUtils.h"
+#include "Introspection/Introspection.h"
 #include "OrbitBase/Append.h"
 #include "OrbitBase/Logging.h"
 #include "OrbitBase/Sort.h"
+#include "OrbitBase/TaskGroup.h"
 #include "PickingManager.h"
 #include "ThreadColor.h"
 #include "TrackManager.h"
@@ -36,7 +40,7 @@ namespace orbit_gl {
 using orbit_client_data::CaptureData;
 using orbit_client_data::ModuleManager;
 using orbit_client_data::ScopeId;
-using orbit_client_protos::TimerInfo;
+using orbit_client_data::TimerInfo;
 using orbit_grpc_protos::InstrumentedFunction;
 
 TrackContainer::TrackContainer(CaptureViewElement* parent, TimelineInfoInterface* timeline_info,
@@ -368,7 +372,7 @@ const TimerInfo* TrackContainer::FindDown(const TimerInfo& from) {
 }
 
 void TrackContainer::SetIteratorOverlayData(
-    const absl::flat_hash_map<uint64_t, const orbit_client_protos::TimerInfo*>& iterator_timer_info,
+    const absl::flat_hash_map<uint64_t, const orbit_client_data::TimerInfo*>& iterator_timer_info,
     const absl::flat_hash_map<uint64_t, ScopeId>& iterator_id_to_function_scope_id) {
   iterator_timer_info_ = iterator_timer_info;
   iterator_id_to_function_scope_id_ = iterator_id_to_function_scope_id;
@@ -448,6 +452,145 @@ void TrackContainer::DoDraw(PrimitiveAssembler& primitive_assembler, TextRendere
   DrawOverlay(primitive_assembler, text_renderer, draw_context.picking_mode);
 }
 
+void TrackContainer::UpdateChildrenPrimitives(PrimitiveAssembler& primitive_assembler,
+                                              TextRenderer& text_renderer, uint64_t min_tick,
+                                              uint64_t max_tick, PickingMode picking_mode) {
+  const bool in_parallel = absl::GetFlag(FLAGS_parallel_update_primitives);
+  const bool use_cache = absl::GetFlag(FLAGS_cache_track_primitives);
+  if ((in_parallel || use_cache) &&
+      UpdateTracksPrimitivesInSegments(primitive_assembler, text_renderer, min_tick, max_tick,
+                                       picking_mode, in_parallel, use_cache)) {
+    return;
+  }
+  CaptureViewElement::UpdateChildrenPrimitives(primitive_assembler, text_renderer, min_tick,
+                                               max_tick, picking_mode);
+}
+
+bool TrackContainer::TrackPrimitivesCacheKey::operator==(
+    const TrackPrimitivesCacheKey& other) const {
+  return min_tick == other.min_tick && max_tick == other.max_tick && pos[0] == other.pos[0] &&
+         pos[1] == other.pos[1] && size[0] == other.size[0] && size[1] == other.size[1] &&
+         translation.xy[0] == other.translation.xy[0] &&
+         translation.xy[1] == other.translation.xy[1] && translation.z == other.translation.z &&
+         viewport_height == other.viewport_height && layout_version == other.layout_version &&
+         selection_generation == other.selection_generation &&
+         update_primitives_request_count == other.update_primitives_request_count &&
+         data_generation == other.data_generation;
+}
+
+std::optional<TrackContainer::TrackPrimitivesCacheKey> TrackContainer::GetTrackPrimitivesCacheKey(
+    const Track& track, uint64_t min_tick, uint64_t max_tick,
+    const LayeredVec2& translation) const {
+  const std::optional<uint64_t> data_generation = track.GetDataGeneration();
+  if (!data_generation.has_value()) return std::nullopt;
+
+  return TrackPrimitivesCacheKey{min_tick,
+                                 max_tick,
+                                 track.GetPos(),
+                                 track.GetSize(),
+                                 translation,
+                                 viewport_->GetWorldHeight(),
+                                 layout_->GetVersion(),
+                                 app_ != nullptr ? app_->GetSelectionGeneration() : 0,
+                                 track.GetUpdatePrimitivesRequestCount(),
+                                 data_generation.value()};
+}
+
+bool TrackContainer::UpdateTracksPrimitivesInSegments(PrimitiveAssembler& primitive_assembler,
+                                                      TextRenderer& text_renderer,
+                                                      uint64_t min_tick, uint64_t max_tick,
+                                                      PickingMode picking_mode, bool in_parallel,
+                                                      bool use_cache) {
+  ORBIT_SCOPE_FUNCTION;
+  Batcher* batcher = primitive_assembler.GetBatcher();
+  // Primitives are stored translated, so the segments start with the current translation. Texts
+  // are replayed relative to the current translation of `text_renderer`.
+  const LayeredVec2 translation = batcher->GetCurrentTranslation();
+
+  const std::vector<CaptureViewElement*> children_in_viewport = GetChildrenVisibleInViewport();
+  const absl::flat_hash_set<CaptureViewElement*> children_in_viewport_set(
+      children_in_viewport.begin(), children_in_viewport.end());
+
+  std::vector<UpdatePrimitivesSegment*> segments;
+  std::vector<std::pair<Track*, UpdatePrimitivesSegment*>> segments_to_update;
+  absl::flat_hash_set<const Track*> tracks_with_segment;
+  for (Track* track : track_manager_->GetVisibleTracks()) {
+    if (!children_in_viewport_set.contains(track) || !track->ShouldBeRendered()) continue;
+    tracks_with_segment.insert(track);
+
+    UpdatePrimitivesSegment& segment = update_primitives_segments_[{track, picking_mode}];
+    if (segment.batcher == nullptr) {
+      segment.batcher = batcher->CreateSegment();
+      if (segment.batcher == nullptr) {
+        update_primitives_segments_.erase({track, picking_mode});
+        return false;
+      }
+      segment.primitive_assembler = std::make_unique<PrimitiveAssembler>(
+          segment.batcher.get(), primitive_assembler.GetPickingManager());
+    }
+    if (segment.text_renderer == nullptr || segment.text_renderer->GetTarget() != &text_renderer) {
+      segment.text_renderer =
+          std::make_unique<BufferedTextRenderer>(&text_renderer, &text_renderer_mutex_);
+      segment.cache_key.reset();
+    }
+
+    // Picking colors of Pickables are only valid for one frame, so picking frames always update.
+    std::optional<TrackPrimitivesCacheKey> cache_key;
+    if (use_cache && picking_mode == PickingMode::kNone) {
+      cache_key = GetTrackPrimitivesCacheKey(*track, min_tick, max_tick, translation);
+    }
+    if (!cache_key.has_value() || segment.cache_key != cache_key) {
+      segment.cache_key = cache_key;
+      segments_to_update.emplace_back(track, &segment);
+    }
+    segments.push_back(&segment);
+  }
+
+  // Drop the segments of tracks that are no longer drawn, so that they don't accumulate and so that
+  // a later track allocated at the address of a deleted one doesn't reuse its segment.
+  for (auto it = update_primitives_segments_.begin(); it != update_primitives_segments_.end();) {
+    const auto& [track, segment_picking_mode] = it->first;
+    if (segment_picking_mode == picking_mode && !tracks_with_segment.contains(track)) {
+      update_primitives_segments_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+
+  auto update_segment = [&](Track* track, UpdatePrimitivesSegment* segment) {
+    const std::string track_name = track->GetName();
+    ORBIT_SCOPE(track_name.c_str());
+    segment->batcher->ResetElements();
+    segment->text_renderer->Clear();
+    segment->primitive_assembler->SetBatcher(segment->batcher.get());
+    segment->batcher->PushTranslation(translation.xy[0], translation.xy[1], translation.z);
+    UpdateChildPrimitives(track, *segment->primitive_assembler, *segment->text_renderer, min_tick,
+                          max_tick, picking_mode);
+    segment->batcher->PopTranslation();
+  };
+  if (in_parallel) {
+    orbit_base::TaskGroup task_group;
+    for (const auto& [track, segment] : segments_to_update) {
+      task_group.AddTask([&update_segment, track = track, segment = segment] {
+        update_segment(track, segment);
+      });
+    }
+  } else {
+    for (const auto& [track, segment] : segments_to_update) {
+      update_segment(track, segment);
+    }
+  }
+
+  ORBIT_SCOPE("Merge track segments");
+  for (UpdatePrimitivesSegment* segment : segments) {
+    batcher->AppendSegment(segment->batcher.get());
+    // The user data of the track's primitives is looked up in `batcher` from now on.
+    segment->primitive_assembler->SetBatcher(batcher);
+    segment->text_renderer->ReplayIntoTarget();
+  }
+  return true;
+}
+
 void TrackContainer::UpdateVerticalScrollUsingRatio(float ratio) {
   float range = std::max(0.f, GetVisibleTracksTotalHeight() - GetHeight());
   float new_scrolling_offset = ratio * range;
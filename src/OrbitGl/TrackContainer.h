@@ -6,18 +6,25 @@
 #define ORBIT_GL_TRACK_CONTAINER_H_
 
 #include <ClientData/CaptureData.h>
+#include <absl/synchronization/mutex.h>
 
+#include <memory>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "Batcher.h"
+#include "BufferedTextRenderer.h"
 #include "CaptureViewElement.h"
 #include "ClientData/ScopeId.h"
+#include "ClientData/TimerInfo.h"
 #include "TimeGraphLayout.h"
 #include "Track.h"
 #include "TrackManager.h"
 #include "Viewport.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/node_hash_map.h"
 
 namespace orbit_gl {
 
@@ -38,25 +45,24 @@ class TrackContainer final : public CaptureViewElement {
   [[nodiscard]] TrackManager* GetTrackManager() { return track_manager_.get(); }
 
   void VerticalZoom(float real_ratio, float mouse_screen_y_position);
-  void VerticallyMoveIntoView(const orbit_client_protos::TimerInfo& timer_info);
+  void VerticallyMoveIntoView(const orbit_client_data::TimerInfo& timer_info);
   void VerticallyMoveIntoView(const Track& track);
 
   void SetThreadFilter(const std::string& filter);
 
   [[nodiscard]] int GetNumVisiblePrimitives() const;
 
-  [[nodiscard]] const orbit_client_protos::TimerInfo* FindPrevious(
-      const orbit_client_protos::TimerInfo& from);
-  [[nodiscard]] const orbit_client_protos::TimerInfo* FindNext(
-      const orbit_client_protos::TimerInfo& from);
-  [[nodiscard]] const orbit_client_protos::TimerInfo* FindTop(
-      const orbit_client_protos::TimerInfo& from);
-  [[nodiscard]] const orbit_client_protos::TimerInfo* FindDown(
-      const orbit_client_protos::TimerInfo& from);
+  [[nodiscard]] const orbit_client_data::TimerInfo* FindPrevious(
+      const orbit_client_data::TimerInfo& from);
+  [[nodiscard]] const orbit_client_data::TimerInfo* FindNext(
+      const orbit_client_data::TimerInfo& from);
+  [[nodiscard]] const orbit_client_data::TimerInfo* FindTop(
+      const orbit_client_data::TimerInfo& from);
+  [[nodiscard]] const orbit_client_data::TimerInfo* FindDown(
+      const orbit_client_data::TimerInfo& from);
 
   void SetIteratorOverlayData(
-      const absl::flat_hash_map<uint64_t, const orbit_client_protos::TimerInfo*>&
-          iterator_timer_info,
+      const absl::flat_hash_map<uint64_t, const orbit_client_data::TimerInfo*>& iterator_timer_info,
       const absl::flat_hash_map<uint64_t, ScopeId>& iterator_id_to_scope_function_scope_id);
   void UpdateVerticalScrollUsingRatio(float ratio);
   [[nodiscard]] float GetVerticalScrollingOffset() const { return vertical_scrolling_offset_; }
@@ -73,6 +79,9 @@ class TrackContainer final : public CaptureViewElement {
   void DoUpdateLayout() override;
   void DoDraw(PrimitiveAssembler& primitive_assembler, TextRenderer& text_renderer,
               const DrawContext& draw_context) override;
+  void UpdateChildrenPrimitives(PrimitiveAssembler& primitive_assembler,
+                                TextRenderer& text_renderer, uint64_t min_tick, uint64_t max_tick,
+                                PickingMode picking_mode) override;
 
   void UpdateTracksPosition();
 
@@ -92,8 +101,64 @@ class TrackContainer final : public CaptureViewElement {
   void DrawIncompleteDataIntervals(PrimitiveAssembler& primitive_assembler,
                                    PickingMode picking_mode);
 
+  // Everything the primitives of a track depend on. As long as it doesn't change, the primitives of
+  // the previous frame can be reused.
+  struct TrackPrimitivesCacheKey {
+    uint64_t min_tick;
+    uint64_t max_tick;
+    Vec2 pos;
+    Vec2 size;
+    LayeredVec2 translation;
+    float viewport_height;
+    uint64_t layout_version;
+    uint64_t selection_generation;
+    uint64_t update_primitives_request_count;
+    uint64_t data_generation;
+
+    [[nodiscard]] bool operator==(const TrackPrimitivesCacheKey& other) const;
+    [[nodiscard]] bool operator!=(const TrackPrimitivesCacheKey& other) const {
+      return !(*this == other);
+    }
+  };
+  // Each visible track builds its primitives into its own segment, which is appended to the main
+  // batcher. The PrimitiveAssemblers are kept across frames, because the tooltip callbacks of the
+  // tracks' picking user data refer to them.
+  struct UpdatePrimitivesSegment {
+    std::unique_ptr<Batcher> batcher;
+    std::unique_ptr<PrimitiveAssembler> primitive_assembler;
+    std::unique_ptr<BufferedTextRenderer> text_renderer;
+    std::optional<TrackPrimitivesCacheKey> cache_key;
+  };
+  // Updates the primitives of each visible track into its own segment, and appends the segments to
+  // the batcher of `primitive_assembler` in track order. Returns false if that batcher doesn't
+  // support segments.
+  //
+  // With `in_parallel`, the tracks are updated on the default thread pool. Each task only writes to
+  // its own segment and its own track. The state the tasks share is:
+  //  - The PickingManager, which hands out the ids of Pickables under its mutex. The ids then
+  //    depend on the order of the tasks, but they are only ever resolved through the
+  //    PickingManager.
+  //  - `text_renderer`, of which only the string measurements are used, under
+  //    text_renderer_mutex_. Texts are buffered per segment and replayed in track order.
+  //  - The capture data, which is read as when updating serially. What the capture thread modifies
+  //    meanwhile is guarded by its own mutex (TimerData, ScopeTreeTimerData, TimerPyramid,
+  //    MultivariateTimeSeries). Scope ids of drawn timers are only looked up, as OrbitApp::OnTimer
+  //    assigns them before the timers are added to the tracks.
+  //  - The selection and highlighting of OrbitApp, the Viewport, the TimeGraphLayout and the
+  //    visible time range, which are only read, and only modified by the UI thread between frames.
+  //  - Function-local statics such as the unit arc triangles of PrimitiveAssembler, which are
+  //    initialized thread-safely and only read afterwards.
+  [[nodiscard]] bool UpdateTracksPrimitivesInSegments(PrimitiveAssembler& primitive_assembler,
+                                                      TextRenderer& text_renderer,
+                                                      uint64_t min_tick, uint64_t max_tick,
+                                                      PickingMode picking_mode, bool in_parallel,
+                                                      bool use_cache);
+  [[nodiscard]] std::optional<TrackPrimitivesCacheKey> GetTrackPrimitivesCacheKey(
+      const Track& track, uint64_t min_tick, uint64_t max_tick,
+      const LayeredVec2& translation) const;
+
   // First member is id.
-  absl::flat_hash_map<uint64_t, const orbit_client_protos::TimerInfo*> iterator_timer_info_;
+  absl::flat_hash_map<uint64_t, const orbit_client_data::TimerInfo*> iterator_timer_info_;
   absl::flat_hash_map<uint64_t, ScopeId> iterator_id_to_function_scope_id_;
 
   float vertical_scrolling_offset_ = 0;
@@ -106,6 +171,12 @@ class TrackContainer final : public CaptureViewElement {
   const TimelineInfoInterface* timeline_info_;
 
   OrbitApp* app_ = nullptr;
+
+  // A node_hash_map, as UpdateTracksPrimitivesInSegments holds pointers to the segments while
+  // inserting new ones. Only the segments of the tracks updated in the last frame are kept.
+  absl::node_hash_map<std::pair<const Track*, PickingMode>, UpdatePrimitivesSegment>
+      update_primitives_segments_;
+  absl::Mutex text_renderer_mutex_;
 };
 
 }  // namespace orbit_gl
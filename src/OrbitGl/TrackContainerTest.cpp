@@ -0,0 +1,197 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <absl/flags/flag.h>
+#include <absl/strings/str_format.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CaptureViewElementTester.h"
+#include "ClientFlags/ClientFlags.h"
+#include "Containers/BlockChain.h"
+#include "MockTextRenderer.h"
+#include "OpenGlBatcher.h"
+#include "PickingManager.h"
+#include "PrimitiveAssembler.h"
+#include "TimeGraph.h"
+#include "TrackContainer.h"
+#include "TrackManager.h"
+#include "TrackTestData.h"
+#include "VariableTrack.h"
+#include "Viewport.h"
+
+namespace orbit_gl {
+
+namespace {
+
+constexpr uint64_t kMinTimestampNs = 1'000;
+constexpr uint64_t kMaxTimestampNs = 100'000;
+
+[[nodiscard]] std::string DescribeVec2(const Vec2& vec) {
+  return absl::StrFormat("(%f, %f)", vec[0], vec[1]);
+}
+
+[[nodiscard]] std::string DescribeColor(const Color& color) {
+  return absl::StrFormat("(%u, %u, %u, %u)", color[0], color[1], color[2], color[3]);
+}
+
+// An OpenGlBatcher that describes all of its primitives, in the order in which they would be drawn,
+// together with what their picking colors resolve to.
+class DescribableOpenGlBatcher : public OpenGlBatcher {
+ public:
+  explicit DescribableOpenGlBatcher(BatcherId batcher_id) : OpenGlBatcher(batcher_id) {}
+
+  [[nodiscard]] std::string Describe(const PickingManager& picking_manager) const {
+    std::vector<float> layers = GetLayers();
+    std::sort(layers.begin(), layers.end());
+
+    std::string description;
+    for (float layer : layers) {
+      const orbit_gl_internal::PrimitiveBuffers& buffers = primitive_buffers_by_layer_.at(layer);
+      absl::StrAppendFormat(&description, "layer %f\n", layer);
+      for (const Line& line : buffers.line_buffer.lines_) {
+        absl::StrAppendFormat(&description, "line %s %s\n", DescribeVec2(line.start_point),
+                              DescribeVec2(line.end_point));
+      }
+      for (const Quad& box : buffers.box_buffer.boxes_) {
+        absl::StrAppendFormat(&description, "box %s %s %s %s\n", DescribeVec2(box.vertices[0]),
+                              DescribeVec2(box.vertices[1]), DescribeVec2(box.vertices[2]),
+                              DescribeVec2(box.vertices[3]));
+      }
+      for (const Triangle& triangle : buffers.triangle_buffer.triangles_) {
+        absl::StrAppendFormat(&description, "triangle %s %s %s\n",
+                              DescribeVec2(triangle.vertices[0]),
+                              DescribeVec2(triangle.vertices[1]),
+                              DescribeVec2(triangle.vertices[2]));
+      }
+      AppendColors(buffers.line_buffer.colors_, buffers.line_buffer.picking_colors_,
+                   picking_manager, &description);
+      AppendColors(buffers.box_buffer.colors_, buffers.box_buffer.picking_colors_,
+                   picking_manager, &description);
+      AppendColors(buffers.triangle_buffer.colors_, buffers.triangle_buffer.picking_colors_,
+                   picking_manager, &description);
+    }
+    return description;
+  }
+
+ private:
+  template <uint32_t BlockSize>
+  void AppendColors(const orbit_containers::BlockChain<Color, BlockSize>& colors,
+                    const orbit_containers::BlockChain<Color, BlockSize>& picking_colors,
+                    const PickingManager& picking_manager, std::string* description) const {
+    for (const Color& color : colors) {
+      absl::StrAppendFormat(description, "color %s\n", DescribeColor(color));
+    }
+    for (const Color& picking_color : picking_colors) {
+      absl::StrAppendFormat(description, "picking %s\n",
+                            DescribePickingColor(picking_color, picking_manager));
+    }
+  }
+
+  // Element ids need to match exactly, while the ids of Pickables are handed out in the order in
+  // which the tracks are updated, so those are described by the Pickable they resolve to.
+  [[nodiscard]] std::string DescribePickingColor(const Color& picking_color,
+                                                 const PickingManager& picking_manager) const {
+    const PickingId id = PickingId::FromColor(picking_color);
+    if (id.type == PickingType::kPickable) {
+      return absl::StrFormat("pickable %p", picking_manager.GetPickableFromId(id).get());
+    }
+
+    const PickingUserData* user_data = GetUserData(id);
+    if (user_data == nullptr) {
+      return absl::StrFormat("type %d, element %u", static_cast<int>(id.type), id.element_id);
+    }
+    return absl::StrFormat(
+        "type %d, element %u, timer %p, tooltip \"%s\"", static_cast<int>(id.type), id.element_id,
+        user_data->timer_info_,
+        user_data->generate_tooltip_ != nullptr ? user_data->generate_tooltip_(id) : "");
+  }
+};
+
+struct TrackContainerPrimitives {
+  std::string batcher_description;
+  int num_add_text_calls;
+  std::vector<float> text_layers;
+};
+
+class TrackContainerTest : public testing::Test {
+ public:
+  TrackContainerTest()
+      : capture_data_(TrackTestData::GenerateTestCaptureData()),
+        viewport_(1000, 2000),
+        time_graph_(nullptr, nullptr, &viewport_, capture_data_.get(), &picking_manager_) {
+    constexpr size_t kTrackCount = 8;
+    constexpr size_t kValueCount = 100;
+    for (size_t track_index = 0; track_index < kTrackCount; ++track_index) {
+      VariableTrack* track = time_graph_.GetTrackManager()->GetOrCreateVariableTrack(
+          absl::StrFormat("variable %u", track_index));
+      for (size_t value_index = 0; value_index < kValueCount; ++value_index) {
+        const uint64_t timestamp_ns =
+            kMinTimestampNs + value_index * (kMaxTimestampNs - kMinTimestampNs) / kValueCount;
+        track->AddValue(timestamp_ns, static_cast<double>((value_index * (track_index + 3)) % 17));
+      }
+    }
+
+    tester_.SimulatePreRender(&time_graph_);
+    time_graph_.Zoom(kMinTimestampNs, kMaxTimestampNs);
+    tester_.SimulatePreRender(&time_graph_);
+  }
+
+ protected:
+  [[nodiscard]] TrackContainerPrimitives UpdatePrimitives(bool in_parallel,
+                                                          PickingMode picking_mode) {
+    const bool was_in_parallel = absl::GetFlag(FLAGS_parallel_update_primitives);
+    absl::SetFlag(&FLAGS_parallel_update_primitives, in_parallel);
+
+    DescribableOpenGlBatcher batcher(BatcherId::kTimeGraph);
+    PrimitiveAssembler primitive_assembler(&batcher, &picking_manager_);
+    MockTextRenderer text_renderer;
+    CaptureViewElementTester::UpdatePrimitives(
+        time_graph_.GetTrackContainer(), primitive_assembler, text_renderer,
+        time_graph_.GetTickFromUs(time_graph_.GetMinTimeUs()),
+        time_graph_.GetTickFromUs(time_graph_.GetMaxTimeUs()), picking_mode);
+
+    absl::SetFlag(&FLAGS_parallel_update_primitives, was_in_parallel);
+    return {batcher.Describe(picking_manager_), text_renderer.GetNumAddTextCalls(),
+            text_renderer.GetLayers()};
+  }
+
+ private:
+  std::unique_ptr<orbit_client_data::CaptureData> capture_data_;
+  Viewport viewport_;
+  PickingManager picking_manager_;
+  TimeGraph time_graph_;
+  CaptureViewElementTester tester_;
+};
+
+}  // namespace
+
+TEST_F(TrackContainerTest, UpdatingPrimitivesInParallelGivesTheSameResultAsSerially) {
+  for (PickingMode picking_mode : {PickingMode::kNone, PickingMode::kClick}) {
+    const TrackContainerPrimitives serial_primitives =
+        UpdatePrimitives(/*in_parallel=*/false, picking_mode);
+    // Make sure the tracks are visible, so that there is something to compare: the background of a
+    // GraphTrack is a Pickable, and its series are only added when not picking.
+    ASSERT_NE(serial_primitives.batcher_description.find("pickable"), std::string::npos);
+    if (picking_mode == PickingMode::kNone) {
+      ASSERT_NE(serial_primitives.batcher_description.find("element"), std::string::npos);
+    }
+
+    // Update in parallel several times, as the order of the tasks varies.
+    for (int i = 0; i < 10; ++i) {
+      const TrackContainerPrimitives parallel_primitives =
+          UpdatePrimitives(/*in_parallel=*/true, picking_mode);
+      EXPECT_EQ(parallel_primitives.batcher_description, serial_primitives.batcher_description);
+      EXPECT_EQ(parallel_primitives.num_add_text_calls, serial_primitives.num_add_text_calls);
+      EXPECT_EQ(parallel_primitives.text_layers, serial_primitives.text_layers);
+    }
+  }
+}
+
+}  // namespace orbit_gl
@@ -24,6 +24,8 @@
 #include "App.h"
 #include "ClientData/CallstackData.h"
 #include "ClientData/CaptureData.h"
+#include "ClientData/TimerData.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientFlags/ClientFlags.h"
 #include "OrbitBase/Append.h"
 #include "OrbitBase/Logging.h"
@@ -34,7 +36,8 @@
 #include "Viewport.h"
 
 using orbit_client_data::CallstackData;
-using orbit_client_protos::TimerInfo;
+using orbit_client_data::TimerData;
+using orbit_client_data::TimerInfo;
 
 namespace orbit_gl {
 
@@ -480,7 +483,9 @@ GpuTrack* TrackManager::GetOrCreateGpuTrack(uint64_t timeline_hash) {
       app_->GetStringManager()->Get(timeline_hash).value_or(std::to_string(timeline_hash));
   std::shared_ptr<GpuTrack> track = gpu_tracks_[timeline];
   if (track == nullptr) {
-    auto [unused1, submission_timer_data] = capture_data_->CreateTimerData();
+    // GpuSubmissionTrack doesn't draw TimerPyramid spans, so don't build pyramids for it.
+    auto [unused1, submission_timer_data] =
+        capture_data_->CreateTimerData(TimerData::TimerPyramidUpdateType::kNever);
     auto [unused2, marker_timer_data] = capture_data_->CreateTimerData();
     track = std::make_shared<GpuTrack>(track_container_, timeline_info_, viewport_, layout_,
                                        timeline_hash, app_, module_manager_, capture_data_,
@@ -525,7 +530,9 @@ FrameTrack* TrackManager::GetOrCreateFrameTrack(
     return track_it->second.get();
   }
 
-  auto [unused, timer_data] = capture_data_->CreateTimerData();
+  // FrameTrack doesn't draw TimerPyramid spans, so don't build pyramids for it.
+  auto [unused, timer_data] =
+      capture_data_->CreateTimerData(TimerData::TimerPyramidUpdateType::kNever);
   auto track =
       std::make_shared<FrameTrack>(track_container_, timeline_info_, viewport_, layout_, function,
                                    app_, module_manager_, capture_data_, timer_data);
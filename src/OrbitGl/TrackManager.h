@@ -17,6 +17,7 @@
 
 #include "AsyncTrack.h"
 #include "CGroupAndProcessMemoryTrack.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "FrameTrack.h"
 #include "GpuTrack.h"
@@ -60,7 +61,7 @@ class TrackManager {
   [[nodiscard]] static bool IteratableType(orbit_client_protos::TimerInfo_Type type);
   [[nodiscard]] static bool FunctionIteratableType(orbit_client_protos::TimerInfo_Type type);
 
-  Track* GetOrCreateTrackFromTimerInfo(const orbit_client_protos::TimerInfo& timer_info);
+  Track* GetOrCreateTrackFromTimerInfo(const orbit_client_data::TimerInfo& timer_info);
   SchedulerTrack* GetOrCreateSchedulerTrack();
   ThreadTrack* GetOrCreateThreadTrack(uint32_t tid);
   [[nodiscard]] std::optional<ThreadTrack*> GetThreadTrack(uint32_t tid) const;
@@ -12,8 +12,6 @@
 #include "TrackManager.h"
 #include "TrackTestData.h"
 
-using orbit_client_protos::TimerInfo;
-
 namespace orbit_gl {
 
 const size_t kNumTracks = 3;
@@ -34,7 +32,7 @@ class TrackManagerTest : public ::testing::Test {
     auto* timer_only_thread_track =
         track_manager_.GetOrCreateThreadTrack(TrackTestData::kTimerOnlyThreadId);
 
-    TimerInfo timer;
+    orbit_client_protos::TimerInfo timer;
     timer.set_start(0);
     timer.set_end(100);
     timer.set_thread_id(TrackTestData::kThreadId);
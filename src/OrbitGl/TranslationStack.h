@@ -22,6 +22,7 @@ class TranslationStack {
   void PushTranslation(float x, float y, float z = 0.f);
   void PopTranslation();
   [[nodiscard]] bool IsEmpty() const { return translation_stack_.empty(); }
+  [[nodiscard]] const LayeredVec2& GetCurrentTranslation() const { return current_translation_; }
 
   // TODO(b/227341686) if we change the type of z-values to be non-float, the name should be made
   // less verbose, as it would be clear `z` is not floored.
@@ -275,7 +275,7 @@ QVariant CallTreeViewItemModel::GetCopyableValueRoleData(const QModelIndex& inde
 QVariant CallTreeViewItemModel::GetExclusiveCallstackEventsRoleData(const QModelIndex& index) {
   ORBIT_CHECK(index.isValid());
   auto* item = static_cast<CallTreeNode*>(index.internalPointer());
-  return QVariant::fromValue(&item->exclusive_callstack_events());
+  return QVariant::fromValue(item->exclusive_callstack_events());
 }
 
 QVariant CallTreeViewItemModel::data(const QModelIndex& index, int role) const {
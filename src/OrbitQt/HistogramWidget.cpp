@@ -401,8 +401,8 @@ constexpr uint32_t kSeed = 31;
   return result;
 }
 
-void HistogramWidget::UpdateData(const std::vector<uint64_t>* data, std::string scope_name,
-                                 std::optional<ScopeId> scope_id) {
+void HistogramWidget::UpdateData(const orbit_statistics::QuantileSketch* data,
+                                 std::string scope_name, std::optional<ScopeId> scope_id) {
   ORBIT_SCOPE_FUNCTION;
   if (scope_data_.has_value() && scope_data_->id == scope_id) return;
 
@@ -411,14 +411,15 @@ void HistogramWidget::UpdateData(const std::vector<uint64_t>* data, std::string
   EmitSignalSelectionRangeChange();
 
   if (scope_id.has_value()) {
-    scope_data_.emplace(data, std::move(scope_name), scope_id.value());
+    scope_data_.emplace(data != nullptr ? std::make_optional(*data) : std::nullopt,
+                        std::move(scope_name), scope_id.value());
   } else {
     scope_data_ = std::nullopt;
   }
 
-  if (scope_data_.has_value() && data != nullptr) {
+  if (scope_data_.has_value() && scope_data_->data.has_value()) {
     std::optional<orbit_statistics::Histogram> histogram =
-        orbit_statistics::BuildHistogram(*scope_data_.value().data);
+        orbit_statistics::BuildHistogram(scope_data_->data.value());
     if (histogram) {
       histogram_stack_.push(std::move(*histogram));
     }
@@ -512,25 +513,17 @@ void HistogramWidget::mouseReleaseEvent(QMouseEvent* /* event*/) {
       std::swap(min, max);
     }
 
-    const auto data_begin = scope_data_->data->begin();
-    const auto data_end = scope_data_->data->end();
-
-    const auto min_it = std::lower_bound(data_begin, data_end, min);
-    if (min_it != scope_data_->data->end()) {
-      const auto max_it = std::upper_bound(data_begin, data_end, max);
-      const auto selection = absl::Span<const uint64_t>(&*min_it, std::distance(min_it, max_it));
-
-      if (selection.front() == MinValue() && selection.back() == MaxValue()) {
+    std::optional<orbit_statistics::Histogram> histogram =
+        orbit_statistics::BuildHistogram(scope_data_->data.value(), min, max);
+    if (histogram.has_value()) {
+      if (histogram->min == MinValue() && histogram->max == MaxValue()) {
         selected_area_.reset();
         UpdateAndNotify();
         return;
       }
 
-      auto histogram = orbit_statistics::BuildHistogram(selection);
-      if (histogram) {
-        histogram_stack_.push(std::move(*histogram));
-        ranges_stack_.push({min, max});
-      }
+      histogram_stack_.push(std::move(*histogram));
+      ranges_stack_.push({min, max});
     }
     selected_area_.reset();
   }
@@ -606,7 +599,7 @@ constexpr size_t kMaxScopeNameLengthForTitle = 80;
 
   std::string title =
       absl::StrFormat("<b>%s</b> (%d of %d hits)", scope_name, histogram_stack_.top().data_set_size,
-                      scope_data_->data->size());
+                      scope_data_->data->GetCount());
 
   return QString::fromStdString(title);
 }
@@ -20,6 +20,7 @@
 #include "App.h"
 #include "ClientData/ScopeId.h"
 #include "Statistics/Histogram.h"
+#include "Statistics/QuantileSketch.h"
 
 namespace orbit_qt {
 
@@ -44,7 +45,7 @@ class HistogramWidget : public QWidget {
  public:
   using QWidget::QWidget;
 
-  void UpdateData(const std::vector<uint64_t>* data, std::string function_name,
+  void UpdateData(const orbit_statistics::QuantileSketch* data, std::string function_name,
                   std::optional<ScopeId> scope_id);
 
   [[nodiscard]] QString GetTitle() const;
@@ -78,10 +79,11 @@ class HistogramWidget : public QWidget {
   [[nodiscard]] bool IsOverHistogram(const QPoint& pos) const;
 
   struct ScopeData {
-    ScopeData(const std::vector<uint64_t>* data, std::string name, ScopeId id)
-        : data(data), name(std::move(name)), id(id) {}
+    ScopeData(std::optional<orbit_statistics::QuantileSketch> data, std::string name, ScopeId id)
+        : data(std::move(data)), name(std::move(name)), id(id) {}
 
-    const std::vector<uint64_t>* data;
+    // A copy, as the sketch in the CaptureData keeps changing while capturing.
+    std::optional<orbit_statistics::QuantileSketch> data;
     std::string name;
     ScopeId id;
   };
@@ -169,7 +169,7 @@ void OrbitLiveFunctions::OnRowSelected(std::optional<int> row) {
   ui->data_view_panel_->GetTreeView()->SetIsInternalRefresh(false);
 }
 
-void OrbitLiveFunctions::ShowHistogram(const std::vector<uint64_t>* data,
+void OrbitLiveFunctions::ShowHistogram(const orbit_statistics::QuantileSketch* data,
                                        const std::string& scope_name,
                                        std::optional<orbit_client_data::ScopeId> scope_id) {
   ui->histogram_widget_->UpdateData(data, scope_name, scope_id);
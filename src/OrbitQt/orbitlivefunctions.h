@@ -18,6 +18,7 @@
 #include "ClientData/ScopeId.h"
 #include "LiveFunctionsController.h"
 #include "Statistics/Histogram.h"
+#include "Statistics/QuantileSketch.h"
 #include "absl/container/flat_hash_map.h"
 #include "orbiteventiterator.h"
 #include "types.h"
@@ -48,7 +49,8 @@ class OrbitLiveFunctions : public QWidget {
   std::optional<LiveFunctionsController*> GetLiveFunctionsController() {
     return live_functions_ ? &live_functions_.value() : nullptr;
   }
-  void ShowHistogram(const std::vector<uint64_t>* data, const std::string& scope_name,
+  void ShowHistogram(const orbit_statistics::QuantileSketch* data,
+                     const std::string& scope_name,
                      std::optional<orbit_client_data::ScopeId> scope_id);
 
  signals:
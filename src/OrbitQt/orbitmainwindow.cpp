@@ -75,6 +75,7 @@
 #include "ClientData/CaptureData.h"
 #include "ClientData/ProcessData.h"
 #include "ClientData/ScopeId.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientFlags/ClientFlags.h"
 #include "ClientModel/CaptureSerializer.h"
 #include "ClientProtos/capture_data.pb.h"
@@ -381,7 +382,7 @@ void OrbitMainWindow::SetupMainWindow() {
 
   ui->CaptureGLWidget->Initialize(GlCanvas::CanvasType::kCaptureWindow, this, app_.get());
 
-  app_->SetTimerSelectedCallback([this](const orbit_client_protos::TimerInfo* timer_info) {
+  app_->SetTimerSelectedCallback([this](const orbit_client_data::TimerInfo* timer_info) {
     OnTimerSelectionChanged(timer_info);
   });
 
@@ -1368,7 +1369,7 @@ void OrbitMainWindow::RestoreDefaultTabLayout() {
   UpdateCaptureStateDependentWidgets();
 }
 
-void OrbitMainWindow::OnTimerSelectionChanged(const orbit_client_protos::TimerInfo* timer_info) {
+void OrbitMainWindow::OnTimerSelectionChanged(const orbit_client_data::TimerInfo* timer_info) {
   std::optional<int> selected_row(std::nullopt);
   const auto live_functions_controller = ui->liveFunctions->GetLiveFunctionsController();
   orbit_data_views::LiveFunctionsDataView* live_functions_data_view = nullptr;
@@ -1751,7 +1752,7 @@ void OrbitMainWindow::ShowWarningWithDontShowAgainCheckboxIfNeeded(
   message_box.exec();
 }
 
-void OrbitMainWindow::ShowHistogram(const std::vector<uint64_t>* data,
+void OrbitMainWindow::ShowHistogram(const orbit_statistics::QuantileSketch* data,
                                     const std::string& scope_name,
                                     std::optional<ScopeId> scope_id) {
   ui->liveFunctions->ShowHistogram(data, scope_name, scope_id);
@@ -35,6 +35,7 @@
 #include "ClientData/FunctionInfo.h"
 #include "ClientData/ModuleData.h"
 #include "ClientData/ScopeId.h"
+#include "ClientData/TimerInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "ClientServices/ProcessManager.h"
 #include "DataViews/DataView.h"
@@ -50,6 +51,7 @@
 #include "SessionSetup/ServiceDeployManager.h"
 #include "SessionSetup/TargetConfiguration.h"
 #include "SessionSetup/TargetLabel.h"
+#include "Statistics/QuantileSketch.h"
 #include "StatusListener.h"
 #include "orbitglwidget.h"
 
@@ -122,8 +124,8 @@ class OrbitMainWindow final : public QMainWindow, public orbit_gl::MainWindowInt
       std::string_view title, std::string_view text,
       std::string_view dont_show_again_setting_key) override;
 
-  void ShowHistogram(const std::vector<uint64_t>* data, const std::string& function_name,
-                     std::optional<ScopeId> function_id) override;
+  void ShowHistogram(const orbit_statistics::QuantileSketch* data,
+                     const std::string& function_name, std::optional<ScopeId> function_id) override;
 
   orbit_base::Future<ErrorMessageOr<orbit_base::CanceledOr<void>>> DownloadFileFromInstance(
       std::filesystem::path path_on_instance, std::filesystem::path local_path,
@@ -178,7 +180,7 @@ class OrbitMainWindow final : public QMainWindow, public orbit_gl::MainWindowInt
 
   void on_actionSymbolLocationsDialog_triggered();
 
-  void OnTimerSelectionChanged(const orbit_client_protos::TimerInfo* timer_info);
+  void OnTimerSelectionChanged(const orbit_client_data::TimerInfo* timer_info);
 
  private:
   void UpdateFilePath(const std::filesystem::path& file_path);
@@ -6,6 +6,7 @@
 
 #include <google/protobuf/arena.h>
 
+#include "GrpcProtos/ColumnarCaptureEvents.h"
 #include "GrpcProtos/capture.pb.h"
 #include "GrpcProtos/services.grpc.pb.h"
 #include "Introspection/Introspection.h"
@@ -15,6 +16,7 @@
 
 using orbit_grpc_protos::CaptureResponse;
 using orbit_grpc_protos::ClientCaptureEvent;
+using orbit_grpc_protos::ColumnarCaptureEvents;
 
 namespace orbit_producer_event_processor {
 
@@ -31,6 +33,15 @@ static void InitializeArenaOfCaptureResponses(
   *arena_of_capture_responses = std::make_unique<google::protobuf::Arena>(arena_options);
 }
 
+static int GetEventCount(const CaptureResponse& capture_response) {
+  int event_count = capture_response.capture_events_size();
+  for (const ColumnarCaptureEvents& columnar_events : capture_response.columnar_capture_events()) {
+    event_count +=
+        static_cast<int>(orbit_grpc_protos::GetColumnarCaptureEventCount(columnar_events));
+  }
+  return event_count;
+}
+
 GrpcClientCaptureEventCollector::GrpcClientCaptureEventCollector(
     grpc::ServerReaderWriterInterface<orbit_grpc_protos::CaptureResponse,
                                       orbit_grpc_protos::CaptureRequest>* reader_writer)
@@ -58,13 +69,39 @@ void GrpcClientCaptureEventCollector::AddEvent(ClientCaptureEvent&& event) {
   // - could exceed the maximum gRPC message size.
   static constexpr int kMaxEventsPerCaptureResponse = 10'000;
   if (capture_responses_being_built_.empty() ||
-      capture_responses_being_built_.back()->capture_events_size() ==
-          kMaxEventsPerCaptureResponse) {
+      event_count_of_last_capture_response_being_built_ == kMaxEventsPerCaptureResponse) {
     auto* capture_response = google::protobuf::Arena::CreateMessage<CaptureResponse>(
         arena_of_capture_responses_being_built_.get());
     capture_responses_being_built_.push_back(capture_response);
+    event_count_of_last_capture_response_being_built_ = 0;
+    columnar_events_builder_.reset();
+  }
+
+  CaptureResponse* capture_response = capture_responses_being_built_.back();
+  ++event_count_of_last_capture_response_being_built_;
+  if (columnar_capture_events_enabled_ && AddColumnarEvent(capture_response, event)) return;
+  capture_response->mutable_capture_events()->Add(std::move(event));
+}
+
+bool GrpcClientCaptureEventCollector::AddColumnarEvent(CaptureResponse* capture_response,
+                                                       const ClientCaptureEvent& event) {
+  if (!orbit_grpc_protos::IsColumnarCaptureEvent(event)) return false;
+
+  // The events of a ColumnarCaptureEvents all come before the same ClientCaptureEvent of the
+  // CaptureResponse, so a new batch is needed after each ClientCaptureEvent.
+  if (!columnar_events_builder_.has_value() ||
+      columnar_events_builder_->GetColumnarEvents()->position() !=
+          static_cast<uint32_t>(capture_response->capture_events_size())) {
+    ColumnarCaptureEvents* columnar_events = capture_response->add_columnar_capture_events();
+    columnar_events->set_position(capture_response->capture_events_size());
+    columnar_events_builder_.emplace(columnar_events);
   }
-  capture_responses_being_built_.back()->mutable_capture_events()->Add(std::move(event));
+  return columnar_events_builder_->AddEvent(event);
+}
+
+void GrpcClientCaptureEventCollector::SetColumnarCaptureEventsEnabled(bool enabled) {
+  absl::MutexLock lock{&mutex_};
+  columnar_capture_events_enabled_ = enabled;
 }
 
 void GrpcClientCaptureEventCollector::StopAndWait() {
@@ -108,7 +145,7 @@ void GrpcClientCaptureEventCollector::SenderThread() {
               constexpr int kSendEventCountInterval = 5000;
 
               return (self->capture_responses_being_built_.size() == 1 &&
-                      self->capture_responses_being_built_.back()->capture_events_size() >=
+                      self->event_count_of_last_capture_response_being_built_ >=
                           kSendEventCountInterval) ||
                      self->capture_responses_being_built_.size() > 1 || self->stop_requested_;
             },
@@ -137,7 +174,7 @@ void GrpcClientCaptureEventCollector::SenderThread() {
     // is a bit unresponsive.
     for (CaptureResponse* capture_response : capture_responses_to_send_) {
       // Record statistics on event count and byte size for this CaptureResponse.
-      int capture_response_event_count = capture_response->capture_events_size();
+      int capture_response_event_count = GetEventCount(*capture_response);
       ORBIT_CHECK(capture_response_event_count > 0);
       ORBIT_INT("Number of CaptureEvents in CaptureResponse", capture_response_event_count);
 
@@ -10,6 +10,7 @@
 #include <atomic>
 #include <thread>
 
+#include "GrpcProtos/ColumnarCaptureEvents.h"
 #include "GrpcProtos/capture.pb.h"
 #include "GrpcProtos/services.grpc.pb.h"
 #include "OrbitBase/Logging.h"
@@ -67,6 +68,10 @@ class GrpcClientCaptureEventCollectorTest : public testing::Test {
     }
   }
 
+  void AddEvent(ClientCaptureEvent event) { collector_.AddEvent(std::move(event)); }
+
+  void EnableColumnarCaptureEvents() { collector_.SetColumnarCaptureEventsEnabled(true); }
+
   void CallStopAndWaitEarly() {
     ORBIT_CHECK(!stop_and_wait_called_);
     collector_.StopAndWait();
@@ -155,4 +160,41 @@ TEST_F(GrpcClientCaptureEventCollectorTest, AllCaptureResponsesSentShortlyAfterS
   EXPECT_EQ(actual_event_count, kEventCount);
 }
 
+TEST_F(GrpcClientCaptureEventCollectorTest, ColumnarCaptureEventsKeepTheOrderOfOtherEvents) {
+  std::vector<uint64_t> keys_and_timestamps;
+  uint64_t columnar_capture_events_count = 0;
+  EXPECT_CALL(mock_reader_writer_, OnCaptureResponse)
+      .Times(testing::Between(1, 2))
+      .WillRepeatedly([&](const CaptureResponse& capture_response) {
+        columnar_capture_events_count += capture_response.columnar_capture_events_size();
+        EXPECT_TRUE(orbit_grpc_protos::ForEachClientCaptureEvent(
+            capture_response, [&keys_and_timestamps](const ClientCaptureEvent& event) {
+              keys_and_timestamps.push_back(event.has_interned_string()
+                                                ? event.interned_string().key()
+                                                : event.callstack_sample().timestamp_ns());
+            }));
+      });
+
+  EnableColumnarCaptureEvents();
+  auto add_callstack_sample = [this](uint64_t timestamp_ns) {
+    ClientCaptureEvent event;
+    event.mutable_callstack_sample()->set_tid(42);
+    event.mutable_callstack_sample()->set_timestamp_ns(timestamp_ns);
+    AddEvent(std::move(event));
+  };
+  auto add_interned_string = [this](uint64_t key) {
+    ClientCaptureEvent event;
+    event.mutable_interned_string()->set_key(key);
+    AddEvent(std::move(event));
+  };
+  add_callstack_sample(1000);
+  add_callstack_sample(2000);
+  add_interned_string(1);
+  add_callstack_sample(3000);
+
+  CallStopAndWaitEarly();
+  EXPECT_EQ(keys_and_timestamps, (std::vector<uint64_t>{1000, 2000, 1, 3000}));
+  EXPECT_GE(columnar_capture_events_count, 2);
+}
+
 }  // namespace orbit_producer_event_processor
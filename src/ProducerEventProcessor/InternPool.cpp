@@ -0,0 +1,45 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "InternPool.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace orbit_producer_event_processor_internal {
+
+void* InternPoolArena::Allocate(size_t size, size_t alignment) {
+  const size_t padding = (alignment - reinterpret_cast<uintptr_t>(current_) % alignment) % alignment;
+  if (padding + size > remaining_) {
+    // Large keys get a chunk of their own. Chunks from new[] are aligned for any fundamental type.
+    const size_t chunk_size = std::max(size, kChunkSize);
+    chunks_.push_back(std::make_unique<char[]>(chunk_size));
+    if (chunk_size > kChunkSize) return chunks_.back().get();
+    current_ = chunks_.back().get();
+    remaining_ = chunk_size;
+    return Allocate(size, alignment);
+  }
+
+  void* result = current_ + padding;
+  current_ += padding + size;
+  remaining_ -= padding + size;
+  return result;
+}
+
+std::string_view CopyToArena(std::string_view key, InternPoolArena* arena) {
+  if (key.empty()) return {};
+  char* data = static_cast<char*>(arena->Allocate(key.size(), alignof(char)));
+  std::memcpy(data, key.data(), key.size());
+  return {data, key.size()};
+}
+
+absl::Span<const uint64_t> CopyToArena(absl::Span<const uint64_t> key, InternPoolArena* arena) {
+  if (key.empty()) return {};
+  auto* data = static_cast<uint64_t*>(arena->Allocate(key.size() * sizeof(uint64_t),
+                                                      alignof(uint64_t)));
+  std::memcpy(data, key.data(), key.size() * sizeof(uint64_t));
+  return {data, key.size()};
+}
+
+}  // namespace orbit_producer_event_processor_internal
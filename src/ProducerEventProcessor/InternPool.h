@@ -0,0 +1,176 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PRODUCER_EVENT_PROCESSOR_INTERN_POOL_H_
+#define PRODUCER_EVENT_PROCESSOR_INTERN_POOL_H_
+
+#include <absl/base/thread_annotations.h>
+#include <absl/hash/hash.h>
+#include <absl/synchronization/mutex.h>
+#include <absl/types/span.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace orbit_producer_event_processor_internal {
+
+// Append-only storage for the keys of an InternPool. Memory is only released when the arena is
+// destroyed, so pointers into it stay valid for the lifetime of the pool.
+class InternPoolArena {
+ public:
+  [[nodiscard]] void* Allocate(size_t size, size_t alignment);
+
+ private:
+  static constexpr size_t kChunkSize = 64 * 1024;
+
+  std::vector<std::unique_ptr<char[]>> chunks_;
+  char* current_ = nullptr;
+  size_t remaining_ = 0;
+};
+
+// Copy the data a key refers to into `arena` and return a key referring to the copy. Keys of an
+// InternPool are views (std::string_view, absl::Span, ...), so that looking up an entry never
+// requires allocating.
+[[nodiscard]] std::string_view CopyToArena(std::string_view key, InternPoolArena* arena);
+[[nodiscard]] absl::Span<const uint64_t> CopyToArena(absl::Span<const uint64_t> key,
+                                                     InternPoolArena* arena);
+
+template <typename T, typename = std::enable_if_t<std::is_enum_v<T> || std::is_integral_v<T>>>
+[[nodiscard]] T CopyToArena(T key, InternPoolArena* /*arena*/) {
+  return key;
+}
+
+template <typename First, typename Second>
+[[nodiscard]] std::pair<First, Second> CopyToArena(const std::pair<First, Second>& key,
+                                                   InternPoolArena* arena) {
+  return {CopyToArena(key.first, arena), CopyToArena(key.second, arena)};
+}
+
+// Assigns unique ids, starting from 1, to entries of type Key. The pool is split into shards by
+// the hash of the entry, each with its own mutex, arena and open-addressing table. Entries that are
+// already in the pool (the common case) are found without taking any lock: tables are only ever
+// appended to, and a shard that outgrows its table publishes a larger copy while keeping the old
+// one alive for concurrent readers.
+template <typename Key>
+class InternPool final {
+  static_assert(std::is_trivially_destructible_v<Key>,
+                "InternPool keys must be views into the arena");
+
+ public:
+  InternPool() = default;
+  InternPool(const InternPool&) = delete;
+  InternPool& operator=(const InternPool&) = delete;
+
+  // Return pair of <id, assigned>, where assigned is true if the entry was assigned a new id
+  // and false if returning id for already existing entry.
+  std::pair<uint64_t, bool> GetOrAssignId(const Key& key) {
+    const size_t hash = absl::Hash<Key>{}(key);
+    Shard& shard = shards_[hash % kShardCount];
+
+    if (const Entry* entry = Find(*shard.table.load(std::memory_order_acquire), hash, key);
+        entry != nullptr) {
+      return std::make_pair(entry->id, false);
+    }
+
+    absl::MutexLock lock{&shard.mutex};
+    // Another thread could have added the entry, possibly to a new table, in the meantime.
+    Table* table = shard.tables.back().get();
+    if (const Entry* entry = Find(*table, hash, key); entry != nullptr) {
+      return std::make_pair(entry->id, false);
+    }
+
+    if (2 * (shard.size + 1) > table->slots.size()) {
+      table = Grow(&shard);
+    }
+
+    const uint64_t new_id = id_counter_.fetch_add(1, std::memory_order_relaxed);
+    const Entry* entry = new (shard.arena.Allocate(sizeof(Entry), alignof(Entry)))
+        Entry{hash, new_id, CopyToArena(key, &shard.arena)};
+    Insert(table, entry);
+    ++shard.size;
+    return std::make_pair(new_id, true);
+  }
+
+ private:
+  static constexpr size_t kShardCount = 64;
+  static constexpr size_t kInitialTableSize = 16;
+
+  struct Entry {
+    size_t hash;
+    uint64_t id;
+    Key key;
+  };
+
+  struct Table {
+    explicit Table(size_t size) : slots(size) {}
+    // The size is a power of two, and at most half of the slots are used.
+    std::vector<std::atomic<const Entry*>> slots;
+  };
+
+  struct alignas(64) Shard {
+    Shard() {
+      tables.push_back(std::make_unique<Table>(kInitialTableSize));
+      table.store(tables.back().get(), std::memory_order_relaxed);
+    }
+
+    absl::Mutex mutex;
+    // All the tables this shard ever used, the last one being the current. Readers can still be
+    // probing the older ones.
+    std::vector<std::unique_ptr<Table>> tables ABSL_GUARDED_BY(mutex);
+    std::atomic<const Table*> table = nullptr;
+    size_t size ABSL_GUARDED_BY(mutex) = 0;
+    InternPoolArena arena ABSL_GUARDED_BY(mutex);
+  };
+
+  [[nodiscard]] static size_t GetFirstSlot(const Table& table, size_t hash) {
+    // The low bits of the hash already selected the shard.
+    return (hash / kShardCount) & (table.slots.size() - 1);
+  }
+
+  [[nodiscard]] static const Entry* Find(const Table& table, size_t hash, const Key& key) {
+    const size_t mask = table.slots.size() - 1;
+    for (size_t slot = GetFirstSlot(table, hash);; slot = (slot + 1) & mask) {
+      const Entry* entry = table.slots[slot].load(std::memory_order_acquire);
+      if (entry == nullptr) return nullptr;
+      if (entry->hash == hash && entry->key == key) return entry;
+    }
+  }
+
+  static void Insert(Table* table, const Entry* entry) {
+    const size_t mask = table->slots.size() - 1;
+    size_t slot = GetFirstSlot(*table, entry->hash);
+    while (table->slots[slot].load(std::memory_order_relaxed) != nullptr) {
+      slot = (slot + 1) & mask;
+    }
+    // Pairs with the acquire load in Find, so that readers see the initialized entry.
+    table->slots[slot].store(entry, std::memory_order_release);
+  }
+
+  [[nodiscard]] static Table* Grow(Shard* shard) ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard->mutex) {
+    const Table& old_table = *shard->tables.back();
+    auto new_table = std::make_unique<Table>(2 * old_table.slots.size());
+    for (const std::atomic<const Entry*>& slot : old_table.slots) {
+      const Entry* entry = slot.load(std::memory_order_relaxed);
+      if (entry != nullptr) Insert(new_table.get(), entry);
+    }
+    shard->tables.push_back(std::move(new_table));
+    shard->table.store(shard->tables.back().get(), std::memory_order_release);
+    return shard->tables.back().get();
+  }
+
+  std::array<Shard, kShardCount> shards_;
+  std::atomic<uint64_t> id_counter_{1};  // 0 is reserved for invalid_id
+};
+
+}  // namespace orbit_producer_event_processor_internal
+
+#endif  // PRODUCER_EVENT_PROCESSOR_INTERN_POOL_H_
@@ -0,0 +1,85 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/strings/str_format.h>
+#include <absl/types/span.h>
+#include <gtest/gtest.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "InternPool.h"
+
+namespace orbit_producer_event_processor_internal {
+
+TEST(InternPool, AssignsConsecutiveIdsStartingFromOne) {
+  InternPool<std::string_view> pool;
+  EXPECT_EQ(pool.GetOrAssignId("first"), std::make_pair(uint64_t{1}, true));
+  EXPECT_EQ(pool.GetOrAssignId("second"), std::make_pair(uint64_t{2}, true));
+  EXPECT_EQ(pool.GetOrAssignId("first"), std::make_pair(uint64_t{1}, false));
+  EXPECT_EQ(pool.GetOrAssignId(""), std::make_pair(uint64_t{3}, true));
+  EXPECT_EQ(pool.GetOrAssignId(""), std::make_pair(uint64_t{3}, false));
+}
+
+TEST(InternPool, KeepsItsOwnCopyOfTheEntries) {
+  InternPool<std::pair<absl::Span<const uint64_t>, int>> pool;
+  std::vector<uint64_t> pcs{1, 2, 3};
+  EXPECT_EQ(pool.GetOrAssignId({pcs, 0}), std::make_pair(uint64_t{1}, true));
+
+  pcs[2] = 4;
+  EXPECT_EQ(pool.GetOrAssignId({pcs, 0}), std::make_pair(uint64_t{2}, true));
+  EXPECT_EQ(pool.GetOrAssignId({std::vector<uint64_t>{1, 2, 3}, 0}),
+            std::make_pair(uint64_t{1}, false));
+  EXPECT_EQ(pool.GetOrAssignId({pcs, 1}), std::make_pair(uint64_t{3}, true));
+}
+
+TEST(InternPool, FindsEntriesAfterGrowing) {
+  constexpr uint64_t kEntryCount = 100'000;
+  InternPool<std::string_view> pool;
+  for (uint64_t i = 0; i < kEntryCount; ++i) {
+    EXPECT_EQ(pool.GetOrAssignId(absl::StrFormat("entry %d", i)), std::make_pair(i + 1, true));
+  }
+  for (uint64_t i = 0; i < kEntryCount; ++i) {
+    EXPECT_EQ(pool.GetOrAssignId(absl::StrFormat("entry %d", i)), std::make_pair(i + 1, false));
+  }
+}
+
+TEST(InternPool, AssignsOneIdPerEntryFromMultipleThreads) {
+  constexpr size_t kThreadCount = 8;
+  constexpr uint64_t kEntryCount = 20'000;
+  InternPool<std::string_view> pool;
+
+  std::vector<std::vector<std::pair<uint64_t, bool>>> results_by_thread(kThreadCount);
+  std::vector<std::thread> threads;
+  for (size_t thread_index = 0; thread_index < kThreadCount; ++thread_index) {
+    threads.emplace_back([&pool, &results = results_by_thread[thread_index]] {
+      for (uint64_t i = 0; i < kEntryCount; ++i) {
+        results.push_back(pool.GetOrAssignId(absl::StrFormat("entry %d", i)));
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  absl::flat_hash_map<uint64_t, uint64_t> entry_to_id;
+  for (uint64_t i = 0; i < kEntryCount; ++i) {
+    size_t assigned_count = 0;
+    for (const std::vector<std::pair<uint64_t, bool>>& results : results_by_thread) {
+      EXPECT_EQ(results[i].first, results_by_thread[0][i].first);
+      if (results[i].second) ++assigned_count;
+    }
+    EXPECT_EQ(assigned_count, 1);
+    entry_to_id.emplace(results_by_thread[0][i].first, i);
+  }
+  // All the ids are different.
+  EXPECT_EQ(entry_to_id.size(), kEntryCount);
+}
+
+}  // namespace orbit_producer_event_processor_internal
@@ -5,8 +5,12 @@
 #include "ProducerEventProcessor/ProducerEventProcessor.h"
 
 #include <absl/container/flat_hash_map.h>
+#include <absl/types/span.h>
+
+#include <string_view>
 
 #include "GrpcProtos/capture.pb.h"
+#include "InternPool.h"
 #include "OrbitBase/Logging.h"
 
 using orbit_grpc_protos::AddressInfo;
@@ -57,37 +61,12 @@ using orbit_grpc_protos::TracepointEvent;
 using orbit_grpc_protos::WarningEvent;
 using orbit_grpc_protos::WarningInstrumentingWithUprobesEvent;
 using orbit_grpc_protos::WarningInstrumentingWithUserSpaceInstrumentationEvent;
+using orbit_producer_event_processor_internal::InternPool;
 
 namespace orbit_producer_event_processor {
 
 namespace {
 
-template <typename T>
-class InternPool final {
- public:
-  InternPool() = default;
-
-  // Return pair of <id, assigned>, where assigned is true if the entry was assigned a new id
-  // and false if returning id for already existing entry.
-  std::pair<uint64_t, bool> GetOrAssignId(const T& entry) {
-    absl::MutexLock lock(&entry_to_id_mutex_);
-    auto it = entry_to_id_.find(entry);
-    if (it != entry_to_id_.end()) {
-      return std::make_pair(it->second, false);
-    }
-
-    uint64_t new_id = id_counter_++;
-    auto [unused_it, inserted] = entry_to_id_.insert_or_assign(entry, new_id);
-    ORBIT_CHECK(inserted);
-    return std::make_pair(new_id, true);
-  }
-
- private:
-  uint64_t id_counter_ = 1;  // 0 is reserved for invalid_id
-  absl::flat_hash_map<T, uint64_t> entry_to_id_;
-  absl::Mutex entry_to_id_mutex_;
-};
-
 class ProducerEventProcessorImpl : public ProducerEventProcessor {
  public:
   ProducerEventProcessorImpl() = delete;
@@ -157,9 +136,9 @@ class ProducerEventProcessorImpl : public ProducerEventProcessor {
 
   ClientCaptureEventCollector* client_capture_event_collector_;
 
-  InternPool<std::pair<std::vector<uint64_t>, Callstack::CallstackType>> callstack_pool_;
-  InternPool<std::string> string_pool_;
-  InternPool<std::pair<std::string, std::string>> tracepoint_pool_;
+  InternPool<std::pair<absl::Span<const uint64_t>, Callstack::CallstackType>> callstack_pool_;
+  InternPool<std::string_view> string_pool_;
+  InternPool<std::pair<std::string_view, std::string_view>> tracepoint_pool_;
 
   // These are mapping InternStrings and InternedCallstacks from producer ids
   // to client ids:
@@ -314,9 +293,8 @@ void ProducerEventProcessorImpl::ProcessErrorsWithPerfEventOpenEventAndTransferO
 void ProducerEventProcessorImpl::ProcessFullCallstackSample(
     FullCallstackSample* full_callstack_sample) {
   const Callstack& callstack = full_callstack_sample->callstack();
-  std::pair<std::vector<uint64_t>, Callstack::CallstackType> callstack_data{
-      {callstack.pcs().begin(), callstack.pcs().end()}, callstack.type()};
-  auto [callstack_id, assigned] = callstack_pool_.GetOrAssignId(callstack_data);
+  auto [callstack_id, assigned] = callstack_pool_.GetOrAssignId(
+      {absl::MakeConstSpan(callstack.pcs().data(), callstack.pcs().size()), callstack.type()});
 
   if (assigned) {
     ClientCaptureEvent interned_callstack_event;
@@ -432,10 +410,9 @@ void ProducerEventProcessorImpl::ProcessInternedCallstack(uint64_t producer_id,
   ORBIT_CHECK(!producer_interned_callstack_id_to_client_callstack_id_.contains(
       {producer_id, interned_callstack->key()}));
 
-  std::pair<std::vector<uint64_t>, Callstack::CallstackType> callstack_data{
-      {interned_callstack->intern().pcs().begin(), interned_callstack->intern().pcs().end()},
-      interned_callstack->intern().type()};
-  auto [interned_callstack_id, assigned] = callstack_pool_.GetOrAssignId(callstack_data);
+  const Callstack& callstack = interned_callstack->intern();
+  auto [interned_callstack_id, assigned] = callstack_pool_.GetOrAssignId(
+      {absl::MakeConstSpan(callstack.pcs().data(), callstack.pcs().size()), callstack.type()});
 
   producer_interned_callstack_id_to_client_callstack_id_.insert_or_assign(
       {producer_id, interned_callstack->key()}, interned_callstack_id);
@@ -2,13 +2,20 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <absl/strings/str_format.h>
 #include <gmock/gmock.h>
 #include <google/protobuf/util/message_differencer.h>
 #include <gtest/gtest.h>
 #include <stdint.h>
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
 #include "GrpcProtos/Constants.h"
 #include "GrpcProtos/capture.pb.h"
+#include "OrbitBase/Logging.h"
 #include "ProducerEventProcessor/ProducerEventProcessor.h"
 
 using orbit_grpc_protos::AddressInfo;
@@ -80,6 +87,19 @@ class MockClientCaptureEventCollector : public ClientCaptureEventCollector {
   MOCK_METHOD(void, StopAndWait, (), (override));
 };
 
+class CountingClientCaptureEventCollector : public ClientCaptureEventCollector {
+ public:
+  void AddEvent(orbit_grpc_protos::ClientCaptureEvent&& /*event*/) override {
+    event_count_.fetch_add(1, std::memory_order_relaxed);
+  }
+  void StopAndWait() override {}
+
+  [[nodiscard]] uint64_t GetEventCount() const { return event_count_.load(); }
+
+ private:
+  std::atomic<uint64_t> event_count_ = 0;
+};
+
 constexpr uint64_t kDefaultProducerId = 31;
 
 constexpr int32_t kPid1 = 5;
@@ -2156,4 +2176,61 @@ TEST(ProducerEventProcessor, OutOfOrderEventsDiscardedEvent) {
   EXPECT_EQ(actual_out_of_order_events_discarded_event.end_timestamp_ns(), kTimestampNs1);
 }
 
-}  // namespace orbit_producer_event_processor
\ No newline at end of file
+// Logs the throughput of ProcessEvent with several producers. Disabled by default.
+TEST(ProducerEventProcessor, DISABLED_BenchmarkProcessEventFromMultipleProducers) {
+  constexpr uint64_t kCallstackSamplesPerProducer = 200'000;
+  constexpr uint64_t kCallstackSamplesPerAddressInfo = 8;
+  constexpr uint64_t kEventsPerProducer =
+      kCallstackSamplesPerProducer + kCallstackSamplesPerProducer / kCallstackSamplesPerAddressInfo;
+  constexpr uint64_t kDistinctCallstackCount = 1'000;
+  constexpr uint64_t kCallstackDepth = 24;
+  constexpr uint64_t kDistinctFunctionNameCount = 100;
+
+  for (uint64_t producer_count : {1, 2, 4, 8}) {
+    CountingClientCaptureEventCollector collector;
+    auto producer_event_processor = ProducerEventProcessor::Create(&collector);
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers;
+    for (uint64_t producer_id = 1; producer_id <= producer_count; ++producer_id) {
+      producers.emplace_back([&producer_event_processor, producer_id] {
+        for (uint64_t i = 0; i < kCallstackSamplesPerProducer; ++i) {
+          ProducerCaptureEvent event;
+          FullCallstackSample* full_callstack_sample = event.mutable_full_callstack_sample();
+          full_callstack_sample->set_pid(kPid1);
+          full_callstack_sample->set_tid(static_cast<int32_t>(producer_id));
+          full_callstack_sample->set_timestamp_ns(i);
+          Callstack* callstack = full_callstack_sample->mutable_callstack();
+          const uint64_t callstack_index = (i * 7919 + producer_id) % kDistinctCallstackCount;
+          for (uint64_t frame = 0; frame < kCallstackDepth; ++frame) {
+            callstack->add_pcs(0x7f0000000000 + callstack_index * 0x100 + frame);
+          }
+          callstack->set_type(Callstack::kComplete);
+          producer_event_processor->ProcessEvent(producer_id, std::move(event));
+
+          if (i % kCallstackSamplesPerAddressInfo != 0) continue;
+          ProducerCaptureEvent address_info_event;
+          FullAddressInfo* full_address_info = address_info_event.mutable_full_address_info();
+          full_address_info->set_absolute_address(i);
+          full_address_info->set_function_name(absl::StrFormat(
+              "function_%d", i / kCallstackSamplesPerAddressInfo % kDistinctFunctionNameCount));
+          full_address_info->set_module_name("/path/to/module");
+          producer_event_processor->ProcessEvent(producer_id, std::move(address_info_event));
+        }
+      });
+    }
+    for (std::thread& producer : producers) {
+      producer.join();
+    }
+    const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+    // Each callstack, function name and the module name are sent as interned events exactly once.
+    EXPECT_EQ(collector.GetEventCount(), producer_count * kEventsPerProducer +
+                                             kDistinctCallstackCount + kDistinctFunctionNameCount +
+                                             1);
+    ORBIT_LOG("%d producers: %.2f M events/s", producer_count,
+              producer_count * kEventsPerProducer / duration.count() / 1e6);
+  }
+}
+
+}  // namespace orbit_producer_event_processor
@@ -10,9 +10,11 @@
 #include <google/protobuf/arena.h>
 
 #include <memory>
+#include <optional>
 #include <thread>
 #include <vector>
 
+#include "GrpcProtos/ColumnarCaptureEvents.h"
 #include "GrpcProtos/capture.pb.h"
 #include "GrpcProtos/services.grpc.pb.h"
 #include "ProducerEventProcessor/ClientCaptureEventCollector.h"
@@ -31,9 +33,17 @@ class GrpcClientCaptureEventCollector final : public ClientCaptureEventCollector
 
   void StopAndWait() override;
 
+  // Only enable this if the client set CaptureOptions::enable_columnar_capture_events, as older
+  // clients ignore CaptureResponse::columnar_capture_events.
+  void SetColumnarCaptureEventsEnabled(bool enabled);
+
   ~GrpcClientCaptureEventCollector() override;
 
  private:
+  // Returns false if `event` can't be sent as part of a ColumnarCaptureEvents.
+  [[nodiscard]] bool AddColumnarEvent(orbit_grpc_protos::CaptureResponse* capture_response,
+                                      const orbit_grpc_protos::ClientCaptureEvent& event)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
   void SenderThread();
 
   grpc::ServerReaderWriterInterface<orbit_grpc_protos::CaptureResponse,
@@ -48,6 +58,12 @@ class GrpcClientCaptureEventCollector final : public ClientCaptureEventCollector
       ABSL_GUARDED_BY(mutex_);
   std::vector<orbit_grpc_protos::CaptureResponse*> capture_responses_being_built_
       ABSL_GUARDED_BY(mutex_);
+  // Counts the events in the ColumnarCaptureEvents of the last CaptureResponse being built too.
+  int event_count_of_last_capture_response_being_built_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool columnar_capture_events_enabled_ ABSL_GUARDED_BY(mutex_) = false;
+  // Builds the last ColumnarCaptureEvents of the last CaptureResponse being built.
+  std::optional<orbit_grpc_protos::ColumnarCaptureEventsBuilder> columnar_events_builder_
+      ABSL_GUARDED_BY(mutex_);
   std::unique_ptr<google::protobuf::Arena> arena_of_capture_responses_to_send_;
   std::vector<orbit_grpc_protos::CaptureResponse*> capture_responses_to_send_;
 
@@ -6,12 +6,16 @@
 
 #include <absl/types/span.h>
 
+#include <algorithm>
 #include <cstdint>
+#include <limits>
 #include <optional>
+#include <vector>
 
 #include "HistogramUtils.h"
 #include "OrbitBase/Logging.h"
 #include "Statistics/DataSet.h"
+#include "Statistics/QuantileSketch.h"
 
 namespace orbit_statistics {
 
@@ -26,6 +30,19 @@ static Histogram BuildHistogramWithNumberOfBins(const std::optional<DataSet>& da
   return BuildHistogram(data_set.value(), bin_width);
 }
 
+static Histogram BuildHistogramWithNumberOfBins(
+    absl::Span<const QuantileSketch::WeightedValue> weighted_values, uint64_t data_set_size,
+    size_t number_of_bins) {
+  const uint64_t min = weighted_values.front().value;
+  const uint64_t max = weighted_values.back().value;
+  const uint64_t bin_width = NumberOfBinsToBinWidth(min, max, number_of_bins);
+  std::vector<size_t> counts((max - min) / bin_width + 1, 0UL);
+  for (const QuantileSketch::WeightedValue& weighted_value : weighted_values) {
+    counts[(weighted_value.value - min) / bin_width] += weighted_value.count;
+  }
+  return {min, max, bin_width, data_set_size, std::move(counts)};
+}
+
 [[nodiscard]] std::optional<Histogram> BuildHistogram(absl::Span<const uint64_t> data) {
   std::optional<DataSet> data_set = DataSet::Create(data);
   if (!data_set.has_value()) return std::nullopt;
@@ -53,4 +70,48 @@ static Histogram BuildHistogramWithNumberOfBins(const std::optional<DataSet>& da
   return best_histogram;
 }
 
-}  // namespace orbit_statistics
\ No newline at end of file
+[[nodiscard]] std::optional<Histogram> BuildHistogram(const QuantileSketch& sketch, uint64_t min,
+                                                      uint64_t max) {
+  if (sketch.IsExact()) {
+    absl::Span<const uint64_t> values = sketch.GetExactValues();
+    auto first = std::lower_bound(values.begin(), values.end(), min);
+    auto last = std::upper_bound(first, values.end(), max);
+    return BuildHistogram(values.subspan(first - values.begin(), last - first));
+  }
+
+  const std::vector<QuantileSketch::WeightedValue> weighted_values =
+      sketch.GetWeightedValues(min, max);
+  if (weighted_values.empty()) return std::nullopt;
+
+  uint64_t data_set_size = 0;
+  for (const QuantileSketch::WeightedValue& weighted_value : weighted_values) {
+    data_set_size += weighted_value.count;
+  }
+
+  if (data_set_size > kVeryLargeDatasetThreshold) {
+    return BuildHistogramWithNumberOfBins(weighted_values, data_set_size, kLargeNumberOfBins);
+  }
+
+  size_t number_of_bins = 1;
+  double best_risk_score = std::numeric_limits<double>::max();
+  Histogram best_histogram;
+
+  for (uint32_t i = 0; i < kNumberOfBinsGridSize; ++i) {
+    Histogram histogram =
+        BuildHistogramWithNumberOfBins(weighted_values, data_set_size, number_of_bins);
+    double risk_score = HistogramRiskScore(histogram);
+    if (risk_score < best_risk_score) {
+      best_risk_score = risk_score;
+      best_histogram = std::move(histogram);
+    }
+    number_of_bins *= 2;
+  }
+
+  return best_histogram;
+}
+
+[[nodiscard]] std::optional<Histogram> BuildHistogram(const QuantileSketch& sketch) {
+  return BuildHistogram(sketch, 0, std::numeric_limits<uint64_t>::max());
+}
+
+}  // namespace orbit_statistics
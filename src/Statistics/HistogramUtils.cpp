@@ -34,11 +34,15 @@ namespace orbit_statistics {
   return (value - data_set.GetMin()) / bin_width;
 }
 
-[[nodiscard]] uint64_t NumberOfBinsToBinWidth(const DataSet& data_set, size_t bins_num) {
-  const uint64_t width = data_set.GetMax() - data_set.GetMin() + 1;
+[[nodiscard]] uint64_t NumberOfBinsToBinWidth(uint64_t min, uint64_t max, size_t bins_num) {
+  const uint64_t width = max - min + 1;
   return width / bins_num + ((width % bins_num != 0) ? 1 : 0);
 }
 
+[[nodiscard]] uint64_t NumberOfBinsToBinWidth(const DataSet& data_set, size_t bins_num) {
+  return NumberOfBinsToBinWidth(data_set.GetMin(), data_set.GetMax(), bins_num);
+}
+
 [[nodiscard]] Histogram BuildHistogram(const DataSet& data_set, uint64_t bin_width) {
   const size_t bin_num = ValueToHistogramBinIndex(data_set.GetMax(), data_set, bin_width) + 1;
   std::vector<size_t> counts(bin_num, 0UL);
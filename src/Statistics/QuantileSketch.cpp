@@ -0,0 +1,157 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "Statistics/QuantileSketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#include "OrbitBase/Logging.h"
+
+namespace orbit_statistics {
+
+namespace {
+
+const double kGamma =
+    (1.0 + QuantileSketch::kRelativeAccuracy) / (1.0 - QuantileSketch::kRelativeAccuracy);
+const double kLogGamma = std::log(kGamma);
+
+[[nodiscard]] int GetBucketIndex(uint64_t value) {
+  ORBIT_CHECK(value > 0);
+  return static_cast<int>(std::ceil(std::log(static_cast<double>(value)) / kLogGamma));
+}
+
+}  // namespace
+
+void QuantileSketch::Add(uint64_t value) {
+  min_ = IsEmpty() ? value : std::min(min_, value);
+  max_ = IsEmpty() ? value : std::max(max_, value);
+  ++count_;
+
+  if (!IsExact()) {
+    AddToBuckets(value, 1);
+    return;
+  }
+
+  exact_values_.insert(std::upper_bound(exact_values_.begin(), exact_values_.end(), value), value);
+  if (exact_values_.size() > kMaxExactValueCount) ConvertToBuckets();
+}
+
+void QuantileSketch::Merge(const QuantileSketch& other) {
+  if (other.IsEmpty()) return;
+  min_ = IsEmpty() ? other.min_ : std::min(min_, other.min_);
+  max_ = IsEmpty() ? other.max_ : std::max(max_, other.max_);
+  count_ += other.count_;
+
+  if (IsExact() && other.IsExact() &&
+      exact_values_.size() + other.exact_values_.size() <= kMaxExactValueCount) {
+    const size_t old_size = exact_values_.size();
+    exact_values_.insert(exact_values_.end(), other.exact_values_.begin(),
+                         other.exact_values_.end());
+    std::inplace_merge(exact_values_.begin(), exact_values_.begin() + old_size,
+                       exact_values_.end());
+    return;
+  }
+
+  if (IsExact()) ConvertToBuckets();
+  for (uint64_t value : other.exact_values_) {
+    AddToBuckets(value, 1);
+  }
+  zero_count_ += other.zero_count_;
+  for (size_t i = 0; i < other.bucket_counts_.size(); ++i) {
+    AddToBucket(other.first_bucket_index_ + static_cast<int>(i), other.bucket_counts_[i]);
+  }
+}
+
+absl::Span<const uint64_t> QuantileSketch::GetExactValues() const {
+  ORBIT_CHECK(IsExact());
+  return exact_values_;
+}
+
+uint64_t QuantileSketch::GetQuantile(double quantile) const {
+  ORBIT_CHECK(!IsEmpty());
+  ORBIT_CHECK(quantile >= 0.0 && quantile <= 1.0);
+  const auto rank = static_cast<uint64_t>(quantile * static_cast<double>(count_ - 1));
+  if (rank == 0) return min_;
+  if (rank == count_ - 1) return max_;
+  if (IsExact()) return exact_values_[rank];
+
+  uint64_t values_up_to_bucket = zero_count_;
+  if (rank < values_up_to_bucket) return 0;
+  for (size_t i = 0; i < bucket_counts_.size(); ++i) {
+    values_up_to_bucket += bucket_counts_[i];
+    if (rank < values_up_to_bucket) {
+      return GetBucketValue(first_bucket_index_ + static_cast<int>(i));
+    }
+  }
+  ORBIT_UNREACHABLE();
+}
+
+std::vector<QuantileSketch::WeightedValue> QuantileSketch::GetWeightedValues(uint64_t min,
+                                                                            uint64_t max) const {
+  std::vector<WeightedValue> result;
+  if (IsExact()) {
+    for (auto it = std::lower_bound(exact_values_.begin(), exact_values_.end(), min);
+         it != exact_values_.end() && *it <= max;) {
+      const auto next = std::upper_bound(it, exact_values_.end(), *it);
+      result.push_back({*it, static_cast<uint64_t>(std::distance(it, next))});
+      it = next;
+    }
+    return result;
+  }
+
+  if (zero_count_ > 0 && min == 0) result.push_back({0, zero_count_});
+  for (size_t i = 0; i < bucket_counts_.size(); ++i) {
+    if (bucket_counts_[i] == 0) continue;
+    const uint64_t value = GetBucketValue(first_bucket_index_ + static_cast<int>(i));
+    if (value < min || value > max) continue;
+    if (!result.empty() && result.back().value == value) {
+      result.back().count += bucket_counts_[i];
+    } else {
+      result.push_back({value, bucket_counts_[i]});
+    }
+  }
+  return result;
+}
+
+void QuantileSketch::ConvertToBuckets() {
+  for (uint64_t value : exact_values_) {
+    AddToBuckets(value, 1);
+  }
+  exact_values_.clear();
+  exact_values_.shrink_to_fit();
+}
+
+void QuantileSketch::AddToBuckets(uint64_t value, uint64_t count) {
+  if (count == 0) return;
+  if (value == 0) {
+    zero_count_ += count;
+    return;
+  }
+
+  AddToBucket(GetBucketIndex(value), count);
+}
+
+void QuantileSketch::AddToBucket(int index, uint64_t count) {
+  if (count == 0) return;
+  if (bucket_counts_.empty()) {
+    first_bucket_index_ = index;
+  } else if (index < first_bucket_index_) {
+    bucket_counts_.insert(bucket_counts_.begin(), first_bucket_index_ - index, 0);
+    first_bucket_index_ = index;
+  }
+  const auto offset = static_cast<size_t>(index - first_bucket_index_);
+  if (offset >= bucket_counts_.size()) bucket_counts_.resize(offset + 1, 0);
+  bucket_counts_[offset] += count;
+}
+
+uint64_t QuantileSketch::GetBucketValue(int index) const {
+  // The bucket (gamma^(index - 1), gamma^index] is represented by the value with the smallest
+  // maximal relative error to any value in it. Values outside [min, max] can't have been added.
+  const double value = 2.0 * std::pow(kGamma, index) / (kGamma + 1.0);
+  return std::clamp(static_cast<uint64_t>(std::llround(value)), min_, max_);
+}
+
+}  // namespace orbit_statistics
@@ -0,0 +1,180 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "Statistics/Histogram.h"
+#include "Statistics/QuantileSketch.h"
+
+namespace orbit_statistics {
+
+using testing::ElementsAre;
+using testing::ElementsAreArray;
+
+namespace {
+
+[[nodiscard]] std::vector<uint64_t> GenerateValues(size_t count) {
+  std::mt19937_64 generator(42);
+  std::lognormal_distribution<double> distribution(10.0, 2.0);
+  std::vector<uint64_t> values(count);
+  std::generate(values.begin(), values.end(),
+                [&] { return static_cast<uint64_t>(distribution(generator)); });
+  return values;
+}
+
+void ExpectWithinRelativeAccuracy(uint64_t actual, uint64_t expected) {
+  const double tolerance = QuantileSketch::kRelativeAccuracy * static_cast<double>(expected) + 1.0;
+  EXPECT_NEAR(static_cast<double>(actual), static_cast<double>(expected), tolerance);
+}
+
+}  // namespace
+
+TEST(QuantileSketch, EmptySketch) {
+  QuantileSketch sketch;
+  EXPECT_TRUE(sketch.IsEmpty());
+  EXPECT_TRUE(sketch.IsExact());
+  EXPECT_EQ(sketch.GetCount(), 0);
+  EXPECT_TRUE(sketch.GetExactValues().empty());
+  EXPECT_FALSE(BuildHistogram(sketch).has_value());
+}
+
+TEST(QuantileSketch, SmallSketchIsExact) {
+  QuantileSketch sketch;
+  for (uint64_t value : {300, 100, 200, 100}) {
+    sketch.Add(value);
+  }
+  EXPECT_TRUE(sketch.IsExact());
+  EXPECT_EQ(sketch.GetCount(), 4);
+  EXPECT_EQ(sketch.GetMin(), 100);
+  EXPECT_EQ(sketch.GetMax(), 300);
+  EXPECT_THAT(sketch.GetExactValues(), ElementsAre(100, 100, 200, 300));
+  EXPECT_EQ(sketch.GetQuantile(0.0), 100);
+  EXPECT_EQ(sketch.GetQuantile(0.5), 100);
+  EXPECT_EQ(sketch.GetQuantile(0.7), 200);
+  EXPECT_EQ(sketch.GetQuantile(1.0), 300);
+
+  const std::vector<QuantileSketch::WeightedValue> weighted_values =
+      sketch.GetWeightedValues(100, 200);
+  ASSERT_EQ(weighted_values.size(), 2);
+  EXPECT_EQ(weighted_values[0].value, 100);
+  EXPECT_EQ(weighted_values[0].count, 2);
+  EXPECT_EQ(weighted_values[1].value, 200);
+  EXPECT_EQ(weighted_values[1].count, 1);
+}
+
+TEST(QuantileSketch, LargeSketchIsWithinRelativeAccuracy) {
+  std::vector<uint64_t> values = GenerateValues(100'000);
+  values.push_back(0);
+
+  QuantileSketch sketch;
+  for (uint64_t value : values) {
+    sketch.Add(value);
+  }
+  std::sort(values.begin(), values.end());
+
+  EXPECT_FALSE(sketch.IsExact());
+  EXPECT_EQ(sketch.GetCount(), values.size());
+  EXPECT_EQ(sketch.GetMin(), values.front());
+  EXPECT_EQ(sketch.GetMax(), values.back());
+  for (double quantile : {0.0, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999, 1.0}) {
+    const auto rank = static_cast<size_t>(quantile * static_cast<double>(values.size() - 1));
+    ExpectWithinRelativeAccuracy(sketch.GetQuantile(quantile), values[rank]);
+  }
+
+  const std::vector<QuantileSketch::WeightedValue> weighted_values =
+      sketch.GetWeightedValues(0, std::numeric_limits<uint64_t>::max());
+  EXPECT_EQ(std::accumulate(weighted_values.begin(), weighted_values.end(), uint64_t{0},
+                            [](uint64_t sum, const QuantileSketch::WeightedValue& weighted_value) {
+                              return sum + weighted_value.count;
+                            }),
+            values.size());
+}
+
+TEST(QuantileSketch, MergeIsLikeAddingAllValues) {
+  const std::vector<uint64_t> values = GenerateValues(3 * QuantileSketch::kMaxExactValueCount);
+
+  QuantileSketch all;
+  QuantileSketch first_half;
+  QuantileSketch second_half;
+  for (size_t i = 0; i < values.size(); ++i) {
+    all.Add(values[i]);
+    (i < values.size() / 2 ? first_half : second_half).Add(values[i]);
+  }
+  first_half.Merge(second_half);
+
+  EXPECT_EQ(first_half.GetCount(), all.GetCount());
+  EXPECT_EQ(first_half.GetMin(), all.GetMin());
+  EXPECT_EQ(first_half.GetMax(), all.GetMax());
+  for (double quantile : {0.0, 0.1, 0.5, 0.9, 1.0}) {
+    EXPECT_EQ(first_half.GetQuantile(quantile), all.GetQuantile(quantile));
+  }
+}
+
+TEST(QuantileSketch, MergeOfSmallSketchesStaysExact) {
+  QuantileSketch first;
+  first.Add(3);
+  first.Add(1);
+  QuantileSketch second;
+  second.Add(2);
+  first.Merge(second);
+  first.Merge(QuantileSketch{});
+
+  EXPECT_TRUE(first.IsExact());
+  EXPECT_THAT(first.GetExactValues(), ElementsAre(1, 2, 3));
+}
+
+TEST(QuantileSketch, HistogramOfExactSketchMatchesHistogramOfValues) {
+  const std::vector<uint64_t> values = GenerateValues(QuantileSketch::kMaxExactValueCount);
+  QuantileSketch sketch;
+  for (uint64_t value : values) {
+    sketch.Add(value);
+  }
+  ASSERT_TRUE(sketch.IsExact());
+
+  const std::optional<Histogram> from_sketch = BuildHistogram(sketch);
+  const std::optional<Histogram> from_values = BuildHistogram(values);
+  ASSERT_TRUE(from_sketch.has_value());
+  ASSERT_TRUE(from_values.has_value());
+  EXPECT_EQ(from_sketch->min, from_values->min);
+  EXPECT_EQ(from_sketch->max, from_values->max);
+  EXPECT_EQ(from_sketch->bin_width, from_values->bin_width);
+  EXPECT_THAT(from_sketch->counts, ElementsAreArray(from_values->counts));
+}
+
+TEST(QuantileSketch, HistogramOfLargeSketchCountsAllValuesInRange) {
+  const std::vector<uint64_t> values = GenerateValues(100'000);
+  QuantileSketch sketch;
+  for (uint64_t value : values) {
+    sketch.Add(value);
+  }
+
+  const std::optional<Histogram> histogram = BuildHistogram(sketch);
+  ASSERT_TRUE(histogram.has_value());
+  ExpectWithinRelativeAccuracy(histogram->min, sketch.GetMin());
+  ExpectWithinRelativeAccuracy(histogram->max, sketch.GetMax());
+  EXPECT_EQ(histogram->data_set_size, values.size());
+  EXPECT_EQ(std::accumulate(histogram->counts.begin(), histogram->counts.end(), size_t{0}),
+            values.size());
+
+  const uint64_t median = sketch.GetQuantile(0.5);
+  const std::optional<Histogram> lower_half = BuildHistogram(sketch, 0, median);
+  ASSERT_TRUE(lower_half.has_value());
+  EXPECT_LE(lower_half->max, median);
+  EXPECT_NEAR(static_cast<double>(lower_half->data_set_size),
+              static_cast<double>(values.size()) / 2,
+              QuantileSketch::kRelativeAccuracy * static_cast<double>(values.size()));
+
+  EXPECT_FALSE(BuildHistogram(sketch, sketch.GetMax() + 1, sketch.GetMax() + 2).has_value());
+}
+
+}  // namespace orbit_statistics
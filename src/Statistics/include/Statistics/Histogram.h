@@ -11,6 +11,8 @@
 #include <optional>
 #include <vector>
 
+#include "Statistics/QuantileSketch.h"
+
 namespace orbit_statistics {
 
 // Represents the inclusive range the user has selected on the HistogramWidget.
@@ -37,6 +39,13 @@ struct Histogram {
 // which minimizes it. The histogram will not own the data.
 [[nodiscard]] std::optional<Histogram> BuildHistogram(absl::Span<const uint64_t> data);
 
+// Same as above for the values of `sketch` in the inclusive range [min, max]. While the sketch is
+// exact, this is the same histogram as for the values themselves. Otherwise, every value is
+// accounted for in the bin of the representative value of its sketch bucket.
+[[nodiscard]] std::optional<Histogram> BuildHistogram(const QuantileSketch& sketch, uint64_t min,
+                                                      uint64_t max);
+[[nodiscard]] std::optional<Histogram> BuildHistogram(const QuantileSketch& sketch);
+
 }  // namespace orbit_statistics
 
 #endif  // STATISTICS_HISTOGRAM_H_
\ No newline at end of file
@@ -0,0 +1,75 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef STATISTICS_QUANTILE_SKETCH_H_
+#define STATISTICS_QUANTILE_SKETCH_H_
+
+#include <absl/types/span.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace orbit_statistics {
+
+// Summarizes a stream of `uint64_t` values in bounded memory, similar to a DDSketch.
+//
+// As long as at most `kMaxExactValueCount` values were added, the values themselves are kept and
+// all queries are exact. After that, values are only counted in logarithmically sized buckets:
+// quantiles and histograms are then computed from a representative value per bucket, which is
+// within a relative error of `kRelativeAccuracy` of every value in the bucket. Minimum, maximum and
+// count are always exact. Sketches can be merged without losing accuracy.
+class QuantileSketch {
+ public:
+  static constexpr double kRelativeAccuracy = 0.01;
+  static constexpr size_t kMaxExactValueCount = 1024;
+
+  struct WeightedValue {
+    uint64_t value;
+    uint64_t count;
+  };
+
+  void Add(uint64_t value);
+  void Merge(const QuantileSketch& other);
+
+  [[nodiscard]] uint64_t GetCount() const { return count_; }
+  [[nodiscard]] bool IsEmpty() const { return count_ == 0; }
+  [[nodiscard]] bool IsExact() const { return bucket_counts_.empty() && zero_count_ == 0; }
+  [[nodiscard]] uint64_t GetMin() const { return min_; }
+  [[nodiscard]] uint64_t GetMax() const { return max_; }
+
+  // The sorted values, only available while the sketch is exact.
+  [[nodiscard]] absl::Span<const uint64_t> GetExactValues() const;
+
+  // Returns the value of rank `quantile * (GetCount() - 1)`. Requires a non-empty sketch and
+  // `quantile` in [0, 1].
+  [[nodiscard]] uint64_t GetQuantile(double quantile) const;
+
+  // Returns the (representative) values in [min, max] with their multiplicity, sorted by value.
+  [[nodiscard]] std::vector<WeightedValue> GetWeightedValues(uint64_t min, uint64_t max) const;
+
+ private:
+  void ConvertToBuckets();
+  void AddToBuckets(uint64_t value, uint64_t count);
+  void AddToBucket(int index, uint64_t count);
+  [[nodiscard]] uint64_t GetBucketValue(int index) const;
+
+  uint64_t count_ = 0;
+  uint64_t min_ = 0;
+  uint64_t max_ = 0;
+
+  // Sorted. Cleared when converting to buckets.
+  std::vector<uint64_t> exact_values_;
+
+  // The value 0 has no logarithm, so it is counted separately.
+  uint64_t zero_count_ = 0;
+  // bucket_counts_[i] counts the values in (gamma^(i + first_bucket_index_ - 1),
+  // gamma^(i + first_bucket_index_)].
+  std::vector<uint64_t> bucket_counts_;
+  int first_bucket_index_ = 0;
+};
+
+}  // namespace orbit_statistics
+
+#endif  // STATISTICS_QUANTILE_SKETCH_H_
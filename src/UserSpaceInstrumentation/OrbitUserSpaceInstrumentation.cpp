@@ -4,10 +4,11 @@
 
 #include "OrbitUserSpaceInstrumentation.h"
 
-#include <stack>
 #include <variant>
+#include <vector>
 
 #include "CaptureEventProducer/LockFreeBufferCaptureEventProducer.h"
+#include "OrbitBase/PerThreadSpscQueues.h"
 #include "OrbitBase/Profiling.h"
 #include "OrbitBase/ThreadUtils.h"
 #include "ProducerSideChannel/ProducerSideChannel.h"
@@ -27,8 +28,30 @@ struct OpenFunctionCall {
 // here for awareness and to avoid packing issues in the struct.
 static_assert(sizeof(OpenFunctionCall) == 16, "OpenFunctionCall should be 16 bytes.");
 
-std::stack<OpenFunctionCall>& GetOpenFunctionCallStack() {
-  thread_local std::stack<OpenFunctionCall> open_function_calls;
+// Shadow stack of the calls to instrumented functions that haven't returned yet. The storage is
+// contiguous and reserved upfront, so that pushing and popping normally doesn't allocate.
+class OpenFunctionCallStack {
+ public:
+  OpenFunctionCallStack() { open_function_calls_.reserve(kInitialCapacity); }
+
+  void Push(uint64_t return_address, uint64_t timestamp_on_entry_ns) {
+    open_function_calls_.emplace_back(return_address, timestamp_on_entry_ns);
+  }
+
+  [[nodiscard]] OpenFunctionCall Pop() {
+    OpenFunctionCall open_function_call = open_function_calls_.back();
+    open_function_calls_.pop_back();
+    return open_function_call;
+  }
+
+ private:
+  // 8 KB per thread, enough for all but deeply recursive instrumented functions.
+  static constexpr size_t kInitialCapacity = 512;
+  std::vector<OpenFunctionCall> open_function_calls_;
+};
+
+OpenFunctionCallStack& GetOpenFunctionCallStack() {
+  thread_local OpenFunctionCallStack open_function_calls;
   return open_function_calls;
 }
 
@@ -71,10 +94,11 @@ using FunctionEntryExitVariant = std::variant<FunctionEntry, FunctionExit>;
 
 // This class is used to enqueue FunctionEntry and FunctionExit events from multiple threads,
 // transform them into orbit_grpc_protos::FunctionEntry and orbit_grpc_protos::FunctionExit protos,
-// and relay them to OrbitService.
+// and relay them to OrbitService. Instrumented functions can be called millions of times per second
+// from many threads, so each thread enqueues to its own buffer instead of a shared queue.
 class LockFreeUserSpaceInstrumentationEventProducer
     : public orbit_capture_event_producer::LockFreeBufferCaptureEventProducer<
-          FunctionEntryExitVariant> {
+          FunctionEntryExitVariant, orbit_base::PerThreadSpscQueues<FunctionEntryExitVariant>> {
  public:
   LockFreeUserSpaceInstrumentationEventProducer() {
     BuildAndStart(orbit_producer_side_channel::CreateProducerSideChannel());
@@ -176,8 +200,7 @@ bool& GetIsInPayload() {
 
   const uint64_t timestamp_on_entry_ns = CaptureTimestampNs();
 
-  std::stack<OpenFunctionCall>& open_function_call_stack = GetOpenFunctionCallStack();
-  open_function_call_stack.emplace(return_address, timestamp_on_entry_ns);
+  GetOpenFunctionCallStack().Push(return_address, timestamp_on_entry_ns);
 
   if (GetCaptureEventProducer().IsCapturing()) {
     static const uint32_t pid = orbit_base::GetCurrentProcessId();
@@ -197,9 +220,7 @@ bool& GetIsInPayload() {
   is_in_payload = true;
 
   const uint64_t timestamp_on_exit_ns = CaptureTimestampNs();
-  std::stack<OpenFunctionCall>& open_function_call_stack = GetOpenFunctionCallStack();
-  OpenFunctionCall current_function_call = open_function_call_stack.top();
-  open_function_call_stack.pop();
+  const OpenFunctionCall current_function_call = GetOpenFunctionCallStack().Pop();
 
   // Skip emitting an event if we are not capturing or if the function call doesn't fully belong to
   // this capture.
@@ -44,6 +44,8 @@ grpc::Status WindowsCaptureService::Capture(
       grpc_start_stop_capture_request_waiter{reader_writer};
   const CaptureOptions& capture_options =
       grpc_start_stop_capture_request_waiter.WaitForStartCaptureRequest();
+  grpc_client_capture_event_collector.SetColumnarCaptureEventsEnabled(
+      capture_options.enable_columnar_capture_events());
 
   if (capture_options.enable_api()) {
     EnableApiInTracee(capture_options);
@@ -158,7 +158,7 @@ void Unwinder::Unwind(
   }
 
   bool return_address_attempt = false;
-  bool adjust_pc = false;
+  bool adjust_pc = initial_pc_is_return_address_;
   for (; frames_.size() < max_frames_;) {
     uint64_t cur_pc = regs_->pc();
     uint64_t cur_sp = regs_->sp();
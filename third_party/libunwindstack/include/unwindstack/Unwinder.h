@@ -102,6 +102,12 @@ class Unwinder {
   // set to an empty string and the function offset being set to zero.
   void SetResolveNames(bool resolve) { resolve_names_ = resolve; }
 
+  // Treats the pc of the initial registers as a return address, i.e., adjusts it like the pc of a
+  // non-leaf frame. This allows continuing an unwinding that stopped after some frames.
+  void SetInitialPcIsReturnAddress(bool initial_pc_is_return_address) {
+    initial_pc_is_return_address_ = initial_pc_is_return_address;
+  }
+
   void SetDisplayBuildID(bool display_build_id) { display_build_id_ = display_build_id; }
 
   void SetDexFiles(DexFiles* dex_files);
@@ -146,6 +152,7 @@ class Unwinder {
   JitDebug* jit_debug_ = nullptr;
   DexFiles* dex_files_ = nullptr;
   bool resolve_names_ = true;
+  bool initial_pc_is_return_address_ = false;
   bool display_build_id_ = false;
   ErrorData last_error_;
   uint64_t warnings_;